@@ -0,0 +1,31 @@
+#Linux Config
+cmake_minimum_required(VERSION 3.15)
+
+if(NOT TARGET_LINUX)
+    message(FATAL_ERROR "Platform Linux must be enabled for this config")
+endif()
+
+#Development
+set(CMAKE_CXX_FLAGS_DEVELOPMENT ${CMAKE_CXX_FLAGS_DEBUG})
+set(CMAKE_EXE_LINKER_FLAGS_DEVELOPMENT ${CMAKE_EXE_LINKER_FLAGS_DEBUG})
+set(CMAKE_CXX_FLAGS_DEVELOPMENT "${CMAKE_CXX_FLAGS_DEVELOPMENT} -O0 -g -std=c++20")
+set(CMAKE_DEVELOPMENT_POSTFIX "_d")
+
+#Debug
+set(CMAKE_CXX_FLAGS_DEBUG "${CMAKE_CXX_FLAGS_DEBUG} -O0 -g -std=c++20")
+set(CMAKE_DEBUG_POSTFIX "_d")
+
+#Profile
+set(CMAKE_CXX_FLAGS_PROFILE ${CMAKE_CXX_FLAGS_RELEASE})
+set(CMAKE_EXE_LINKER_FLAGS_PROFILE ${CMAKE_EXE_LINKER_FLAGS_RELEASE})
+set(CMAKE_CXX_FLAGS_PROFILE "${CMAKE_CXX_FLAGS_PROFILE} -O2 -g -std=c++20")
+
+#Release
+set(CMAKE_CXX_FLAGS_RELEASE "${CMAKE_CXX_FLAGS_RELEASE} -O2 -std=c++20")
+
+set(PROJECT_PLATFORM "linux64")
+add_definitions(-DUNICODE -D_UNICODE)
+
+message(STATUS "---------------------------")
+message(STATUS "Build Type      : ${CMAKE_BUILD_TYPE}")
+message(STATUS "---------------------------")
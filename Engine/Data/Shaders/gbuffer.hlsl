@@ -9,11 +9,47 @@
 #define SEPARATE_MATERIALS 0
 #endif
 
+//Textures are read from the descriptor heap by the indices of the push constant
+#ifndef BINDLESS
+#define BINDLESS 0
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 [[vk::binding(0, 0)]] ConstantBuffer<Viewport> cb_Viewport : register(b0, space0);
+#if BINDLESS
+//The sampler is bound once per pass, the models of the frame are read from the heap by the indices of the push constant
+[[vk::binding(1, 0)]] SamplerState s_SamplerState          : register(s0, space0);
+
+struct MaterialTextures
+{
+    uint modelBuffer;
+    uint model;
+    uint albedo;
+    uint normal;
+    uint material; //roughness for the separate materials
+    uint metalness;
+    uint height;
+    uint mask;
+};
+
+[[vk::push_constant]] MaterialTextures pc_MaterialTextures;
+[[vk::binding(0, 3)]] Texture2D t_Textures[]               : register(t0, space3);
+[[vk::binding(1, 3)]] StructuredBuffer<ModelBuffer> t_Buffers[] : register(t1, space3);
+
+#define cb_Model t_Buffers[pc_MaterialTextures.modelBuffer][pc_MaterialTextures.model]
+
+#define t_TextureAlbedo t_Textures[pc_MaterialTextures.albedo]
+#define t_TextureNormal t_Textures[pc_MaterialTextures.normal]
+#define t_TextureMaterial t_Textures[pc_MaterialTextures.material]
+#define t_TextureRoughness t_Textures[pc_MaterialTextures.material]
+#define t_TextureMetalness t_Textures[pc_MaterialTextures.metalness]
+#define t_TextureHeight t_Textures[pc_MaterialTextures.height]
+#define t_TextureMask t_Textures[pc_MaterialTextures.mask]
+#else
 [[vk::binding(1, 1)]] ConstantBuffer<ModelBuffer> cb_Model : register(b1, space1);
 [[vk::binding(2, 1)]] SamplerState s_SamplerState          : register(s0, space1);
+
 #if SEPARATE_MATERIALS
 [[vk::binding(3, 1)]] Texture2D t_TextureAlbedo            : register(t0, space1);
 [[vk::binding(4, 1)]] Texture2D t_TextureNormal            : register(t1, space1);
@@ -28,6 +64,7 @@
 [[vk::binding(6, 1)]] Texture2D t_TextureHeight            : register(t3, space1);
 [[vk::binding(7, 1)]] Texture2D t_TextureMask              : register(t4, space1);
 #endif
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -1,10 +1,33 @@
 #include "Application.h"
+#include "FrameProfiler.h"
 
 namespace v3d
 {
 
 Application::Application(s32& argc, c8** argv) noexcept
 {
+#if FRAME_PROFILER_ENABLE
+    //-traceFrames count [-traceFile name]: records the CPU zones of the first frames and writes them as a Chrome trace
+    u32 traceFrames = 0;
+    std::string traceFile = "trace.json";
+    for (s32 i = 1; i + 1 < argc; ++i)
+    {
+        const std::string option(argv[i]);
+        if (option == "-traceFrames")
+        {
+            traceFrames = static_cast<u32>(std::max(std::atoi(argv[++i]), 0));
+        }
+        else if (option == "-traceFile")
+        {
+            traceFile = argv[++i];
+        }
+    }
+
+    if (traceFrames > 0)
+    {
+        utils::TraceEventRecorder::getLazyInstance()->beginCapture(traceFrames, traceFile);
+    }
+#endif //FRAME_PROFILER_ENABLE
 }
 
 Application::~Application()
@@ -32,12 +32,14 @@
 #include <iomanip>
 
 #include <numeric>
+#include <bit>
 #include <random>
 
 #include <ctime>
 #include <chrono>
 #include <filesystem>
 
+#include <cstddef>
 #include <cstdarg>
 #include <cstring>
 #include <stdio.h>
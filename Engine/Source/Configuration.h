@@ -40,9 +40,8 @@
 #   endif
 #endif
 
-#if (defined(__LINUX__) || defined(LINUX))
+#if (defined(__linux__) || defined(__LINUX__) || defined(LINUX)) && !defined(PLATFORM_ANDROID)
 #   define PLATFORM_LINUX
-#   error Unsupported platform
 #endif
 
 #if defined(_GAMING_XBOX) && defined(_GAMING_XBOX_SCARLETT)
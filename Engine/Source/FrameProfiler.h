@@ -16,12 +16,29 @@ namespace v3d
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define TRACE_PROFILER_CONCAT_IMPL(a, b) a##b
+#define TRACE_PROFILER_CONCAT(a, b) TRACE_PROFILER_CONCAT_IMPL(a, b)
+
+#if FRAME_PROFILER_ENABLE //Builtin CPU zones, see utils::TraceEventRecorder
+#   include "Utils/TraceEventRecorder.h"
+#   define TRACE_PROFILER_CPU_SCOPE(name) v3d::utils::TraceEventScope TRACE_PROFILER_CONCAT(_traceEventScope, __LINE__)(name)
+#   define TRACE_PROFILER_CPU_FRAME if (v3d::utils::TraceEventRecorder::isCapturing()) v3d::utils::TraceEventRecorder::getInstance()->markFrame()
+#   define TRACE_PROFILER_THREAD_NAME(name) v3d::utils::TraceEventRecorder::getLazyInstance()->setThreadName(name)
+#else
+#   define TRACE_PROFILER_CPU_SCOPE(name)
+#   define TRACE_PROFILER_CPU_FRAME
+#   define TRACE_PROFILER_THREAD_NAME(name)
+#endif //FRAME_PROFILER_ENABLE
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
 #if FRAME_PROFILER_ENABLE && defined(TRACY_ENABLE)
 
-#define TRACE_PROFILER_FRAME FrameMark
+#define TRACE_PROFILER_FRAME FrameMark; TRACE_PROFILER_CPU_FRAME
 #define TRACE_PROFILER_FRAME_BEGIN FrameMarkStart("Frame")
 #define TRACE_PROFILER_FRAME_END FrameMarkEnd("Frame")
-#define TRACE_PROFILER_SCOPE(name, color) ZoneScopedNC(name, color.getBGRA())
+#define TRACE_PROFILER_SCOPE(name, color) ZoneScopedNC(name, color.getBGRA()); TRACE_PROFILER_CPU_SCOPE(name)
+#define TRACE_PROFILER_ZONE(name) ZoneTransientN(TRACE_PROFILER_CONCAT(_tracyZone, __LINE__), name, true); TRACE_PROFILER_CPU_SCOPE(name)
 
 #if 0 //Memory profile
 #    define TRACE_PROFILER_MEMORY_ALLOC(ptr, size, name) TracyAlloc(ptr, size)
@@ -52,10 +69,11 @@ namespace v3d
 
 #else //TRACY_ENABLE
 
-#define TRACE_PROFILER_FRAME
+#define TRACE_PROFILER_FRAME TRACE_PROFILER_CPU_FRAME
 #define TRACE_PROFILER_FRAME_BEGIN
 #define TRACE_PROFILER_FRAME_END
-#define TRACE_PROFILER_SCOPE(name, color)
+#define TRACE_PROFILER_SCOPE(name, color) TRACE_PROFILER_CPU_SCOPE(name)
+#define TRACE_PROFILER_ZONE(name) TRACE_PROFILER_CPU_SCOPE(name)
 
 #define TRACE_PROFILER_MEMORY_ALLOC(ptr, size, name)
 #define TRACE_PROFILER_MEMORY_FREE(ptr, name)
@@ -3,6 +3,7 @@
 #include "Math.h"
 #include "Vector3D.h"
 #include "VectorRegister.h"
+#include "MatrixRegister.h"
 
 namespace v3d
 {
@@ -23,7 +24,7 @@ namespace math
         TMinMaxAABB(const TVector3D<T>& min, const TVector3D<T>& max) noexcept;
         ~TMinMaxAABB() noexcept = default;
 
-        [[nodiscard]] TMinMaxAABB& operator=(const TMinMaxAABB& other) const;
+        TMinMaxAABB& operator=(const TMinMaxAABB& other);
 
         T* getPtr();
         const T* getPtr() const;
@@ -81,6 +82,27 @@ namespace math
         return true;
     }
 
+    /**
+    * @brief transformAABB. Returns the AABB of the transformed box, invalid box stays invalid
+    */
+    inline AABB transformAABB(const AABB& aabb, const Matrix4D& transform)
+    {
+        TVector3D<f32> vertices[8];
+        if (!calculateVerticesFromAABB(aabb, vertices))
+        {
+            return aabb;
+        }
+
+        AABB result;
+        for (u32 i = 0; i < 8; ++i)
+        {
+            Vector4D vertex = transform * Vector4D(vertices[i]._x, vertices[i]._y, vertices[i]._z, 1.0f);
+            result.expand({ vertex.getX(), vertex.getY(), vertex.getZ() });
+        }
+
+        return result;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } //namespace math
@@ -26,7 +26,7 @@ namespace math
     }
 
     template <class T>
-    inline TMinMaxAABB<T>& TMinMaxAABB<T>::operator=(const TMinMaxAABB<T>& other) const
+    inline TMinMaxAABB<T>& TMinMaxAABB<T>::operator=(const TMinMaxAABB<T>& other)
     {
         if (this == &other)
         {
@@ -84,7 +84,7 @@ namespace math
     template <class T>
     inline TVector3D<T> TMinMaxAABB<T>::getExtent() const
     {
-        return 0.5f * (_max - _min);
+        return (_max - _min) * 0.5f;
     }
 
     template <class T>
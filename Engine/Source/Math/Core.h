@@ -14,3 +14,4 @@
 #include "VectorRegister.h"
 #include "QuaternionRegister.h"
 #include "MatrixRegister.h"
+#include "Frustum.h"
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Math.h"
+#include "AABB.h"
+#include "VectorRegister.h"
+#include "MatrixRegister.h"
+
+namespace v3d
+{
+namespace math
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    constexpr u32 k_frustumBatchSize = 4;
+
+    /**
+    * @brief Frustum class. Convex volume, normals of the planes look inside
+    */
+    class Frustum final
+    {
+    public:
+
+        enum FrustumPlane
+        {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            NearZ, //Z = 0 in clip space, far plane with REVERSED_DEPTH
+            FarZ,  //Z = 1 in clip space, near plane with REVERSED_DEPTH
+
+            PlaneCount
+        };
+
+        Frustum() noexcept;
+        explicit Frustum(const Matrix4D& viewProjection) noexcept;
+        Frustum(const Frustum& other) noexcept;
+        ~Frustum() noexcept = default;
+
+        Frustum& operator=(const Frustum& other);
+
+        /**
+        * @brief extrude. Removes the planes which an object can cross moving along the direction.
+        * Keeps all objects that can cast a shadow into the frustum for a light with this direction
+        */
+        void extrude(const Vector3D& direction);
+
+        [[nodiscard]] bool isInside(const AABB& aabb) const;
+
+        /**
+        * @brief isInside. Tests up to k_frustumBatchSize boxes at once. Invalid boxes are always inside
+        * @return u32 mask of inside boxes
+        */
+        [[nodiscard]] u32 isInside(const AABB* const* aabbs, u32 count) const;
+
+        u32 getPlaneCount() const;
+        const Vector4D& getPlane(u32 index) const;
+
+    private:
+
+        Vector4D m_planes[PlaneCount];
+        u32      m_planeCount;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace math
+} //namespace v3d
+
+#include "Frustum.inl"
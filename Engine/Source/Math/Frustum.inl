@@ -0,0 +1,201 @@
+namespace v3d
+{
+namespace math
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    inline Frustum::Frustum() noexcept
+        : m_planeCount(0)
+    {
+    }
+
+    inline Frustum::Frustum(const Matrix4D& viewProjection) noexcept
+        : m_planeCount(PlaneCount)
+    {
+        //Corners of the clip space moved to world space, the planes are built by them.
+        //It doesn't depend on handedness and depth direction of the projection
+        const Vector4D clipCorners[8] =
+        {
+            { -1.0f, -1.0f, 0.0f, 1.0f },
+            {  1.0f, -1.0f, 0.0f, 1.0f },
+            {  1.0f,  1.0f, 0.0f, 1.0f },
+            { -1.0f,  1.0f, 0.0f, 1.0f },
+
+            { -1.0f, -1.0f, 1.0f, 1.0f },
+            {  1.0f, -1.0f, 1.0f, 1.0f },
+            {  1.0f,  1.0f, 1.0f, 1.0f },
+            { -1.0f,  1.0f, 1.0f, 1.0f },
+        };
+
+        Matrix4D invViewProjection = viewProjection.getInversed();
+
+        Vector3D corners[8];
+        Vector3D center(0.0f, 0.0f, 0.0f);
+        for (u32 i = 0; i < 8; ++i)
+        {
+            Vector4D corner = invViewProjection * clipCorners[i];
+            corner = corner / corner.getW();
+            corners[i].set(corner.getX(), corner.getY(), corner.getZ());
+            center += corners[i];
+        }
+        center /= 8.0f;
+
+        static const u32 k_planeCorners[PlaneCount][3] =
+        {
+            { 0, 3, 4 }, //Left
+            { 1, 2, 5 }, //Right
+            { 0, 1, 4 }, //Bottom
+            { 3, 2, 7 }, //Top
+            { 0, 1, 2 }, //NearZ
+            { 4, 5, 6 }, //FarZ
+        };
+
+        for (u32 i = 0; i < PlaneCount; ++i)
+        {
+            const Vector3D& a = corners[k_planeCorners[i][0]];
+            const Vector3D& b = corners[k_planeCorners[i][1]];
+            const Vector3D& c = corners[k_planeCorners[i][2]];
+
+            Vector3D normal = SVector::cross(b - a, c - a);
+            normal.normalize();
+            f32 distance = -SVector::dot(normal, a);
+
+            //Orient to the center
+            if (SVector::dot(normal, center) + distance < 0.0f)
+            {
+                normal = -normal;
+                distance = -distance;
+            }
+
+            m_planes[i].set(normal.getX(), normal.getY(), normal.getZ(), distance);
+        }
+    }
+
+    inline Frustum::Frustum(const Frustum& other) noexcept
+        : m_planeCount(other.m_planeCount)
+    {
+        for (u32 i = 0; i < m_planeCount; ++i)
+        {
+            m_planes[i] = other.m_planes[i];
+        }
+    }
+
+    inline Frustum& Frustum::operator=(const Frustum& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        m_planeCount = other.m_planeCount;
+        for (u32 i = 0; i < m_planeCount; ++i)
+        {
+            m_planes[i] = other.m_planes[i];
+        }
+
+        return *this;
+    }
+
+    inline void Frustum::extrude(const Vector3D& direction)
+    {
+        u32 planeCount = 0;
+        for (u32 i = 0; i < m_planeCount; ++i)
+        {
+            const Vector3D normal(m_planes[i].getX(), m_planes[i].getY(), m_planes[i].getZ());
+            if (SVector::dot(normal, direction) <= 0.0f)
+            {
+                m_planes[planeCount++] = m_planes[i];
+            }
+        }
+
+        m_planeCount = planeCount;
+    }
+
+    inline bool Frustum::isInside(const AABB& aabb) const
+    {
+        const AABB* aabbs[1] = { &aabb };
+        return isInside(aabbs, 1) != 0;
+    }
+
+    inline u32 Frustum::isInside(const AABB* const* aabbs, u32 count) const
+    {
+        static_assert(sizeof(TVector3D<f32>) == sizeof(DirectX::XMFLOAT3), "must be same layout");
+        static_assert(k_frustumBatchSize == 4, "one box per register lane");
+        count = std::min(count, k_frustumBatchSize);
+
+        //One box per row, the transpose gives one box per lane. Invalid boxes and empty lanes stay zero
+        DirectX::XMMATRIX boxMin;
+        DirectX::XMMATRIX boxMax;
+        u32 invalidMask = 0;
+        for (u32 i = 0; i < k_frustumBatchSize; ++i)
+        {
+            if (i >= count || !aabbs[i]->isValid())
+            {
+                invalidMask |= (i < count) ? 1 << i : 0;
+                boxMin.r[i] = DirectX::XMVectorZero();
+                boxMax.r[i] = DirectX::XMVectorZero();
+                continue;
+            }
+
+            boxMin.r[i] = DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(&aabbs[i]->getMin()));
+            boxMax.r[i] = DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(&aabbs[i]->getMax()));
+        }
+        boxMin = DirectX::XMMatrixTranspose(boxMin);
+        boxMax = DirectX::XMMatrixTranspose(boxMax);
+
+        const DirectX::XMVECTOR half = DirectX::XMVectorReplicate(0.5f);
+        const DirectX::XMVECTOR centerX = DirectX::XMVectorMultiply(DirectX::XMVectorAdd(boxMax.r[0], boxMin.r[0]), half);
+        const DirectX::XMVECTOR centerY = DirectX::XMVectorMultiply(DirectX::XMVectorAdd(boxMax.r[1], boxMin.r[1]), half);
+        const DirectX::XMVECTOR centerZ = DirectX::XMVectorMultiply(DirectX::XMVectorAdd(boxMax.r[2], boxMin.r[2]), half);
+        const DirectX::XMVECTOR extentX = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(boxMax.r[0], boxMin.r[0]), half);
+        const DirectX::XMVECTOR extentY = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(boxMax.r[1], boxMin.r[1]), half);
+        const DirectX::XMVECTOR extentZ = DirectX::XMVectorMultiply(DirectX::XMVectorSubtract(boxMax.r[2], boxMin.r[2]), half);
+
+        const DirectX::XMVECTOR allOutside = DirectX::XMVectorTrueInt();
+        DirectX::XMVECTOR outside = DirectX::XMVectorFalseInt();
+        for (u32 i = 0; i < m_planeCount; ++i)
+        {
+            const DirectX::XMVECTOR plane = m_planes[i]._v;
+            const DirectX::XMVECTOR absPlane = DirectX::XMVectorAbs(plane);
+
+            //Box is outside if the nearest to the plane corner is behind it: dot(n, center) + d + dot(|n|, extent) < 0
+            DirectX::XMVECTOR distance = DirectX::XMVectorMultiplyAdd(centerX, DirectX::XMVectorSplatX(plane), DirectX::XMVectorSplatW(plane));
+            distance = DirectX::XMVectorMultiplyAdd(centerY, DirectX::XMVectorSplatY(plane), distance);
+            distance = DirectX::XMVectorMultiplyAdd(centerZ, DirectX::XMVectorSplatZ(plane), distance);
+            distance = DirectX::XMVectorMultiplyAdd(extentX, DirectX::XMVectorSplatX(absPlane), distance);
+            distance = DirectX::XMVectorMultiplyAdd(extentY, DirectX::XMVectorSplatY(absPlane), distance);
+            distance = DirectX::XMVectorMultiplyAdd(extentZ, DirectX::XMVectorSplatZ(absPlane), distance);
+
+            outside = DirectX::XMVectorOrInt(outside, DirectX::XMVectorLess(distance, DirectX::XMVectorZero()));
+            if (DirectX::XMVector4EqualInt(outside, allOutside))
+            {
+                break;
+            }
+        }
+
+#if defined(_XM_SSE_INTRINSICS_)
+        const u32 outsideMask = static_cast<u32>(_mm_movemask_ps(outside));
+#else
+        alignas(k_registerAlignment) u32 lanes[k_frustumBatchSize];
+        DirectX::XMStoreInt4(lanes, outside);
+        const u32 outsideMask = (lanes[0] & 1) | ((lanes[1] & 1) << 1) | ((lanes[2] & 1) << 2) | ((lanes[3] & 1) << 3);
+#endif //_XM_SSE_INTRINSICS_
+
+        const u32 laneMask = (1 << count) - 1;
+        return ((~outsideMask & laneMask) | invalidMask);
+    }
+
+    inline u32 Frustum::getPlaneCount() const
+    {
+        return m_planeCount;
+    }
+
+    inline const Vector4D& Frustum::getPlane(u32 index) const
+    {
+        return m_planes[index];
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace math
+} //namespace v3d
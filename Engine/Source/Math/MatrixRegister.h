@@ -119,6 +119,18 @@ namespace math
 
         template <FloatType T>
         static [[nodiscard]] MatrixRegister4x4 lookAtMatrix(const TVectorRegister<T, 3>& position, const TVectorRegister<T, 3>& target, const TVectorRegister<T, 3>& upVector);
+
+        /**
+        * @brief transformMatrix. Builds scale * rotation * translation without any decomposition
+        */
+        template <FloatType T>
+        static [[nodiscard]] MatrixRegister4x4 transformMatrix(const TVectorRegister<T, 3>& translation, const TQuaternionRegister<T>& rotation, const TVectorRegister<T, 3>& scale);
+
+        /**
+        * @brief decompose. Splits an affine matrix into translation, rotation quaternion and scale. Returns false if the matrix is degenerate
+        */
+        template <FloatType T>
+        static bool decompose(const MatrixRegister4x4& matrix, TVectorRegister<T, 3>& translation, TQuaternionRegister<T>& rotation, TVectorRegister<T, 3>& scale);
     };
  
     /////////////////////////////////////////////////////////////////////////////////////////////////////
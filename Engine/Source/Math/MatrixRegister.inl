@@ -309,10 +309,22 @@ namespace math
         {
             DirectX::XMMATRIX rotMatrix = DirectX::XMMatrixRotationQuaternion(rotationQuat);
 
+            //m128_f32 is MSVC only, the rows are stored to memory
+            alignas(k_registerAlignment) f32 rows[3][4];
+#if defined(_XM_SSE_INTRINSICS_)
+            _mm_store_ps(rows[0], rotMatrix.r[0]);
+            _mm_store_ps(rows[1], rotMatrix.r[1]);
+            _mm_store_ps(rows[2], rotMatrix.r[2]);
+#else
+            DirectX::XMStoreFloat4A(reinterpret_cast<DirectX::XMFLOAT4A*>(rows[0]), rotMatrix.r[0]);
+            DirectX::XMStoreFloat4A(reinterpret_cast<DirectX::XMFLOAT4A*>(rows[1]), rotMatrix.r[1]);
+            DirectX::XMStoreFloat4A(reinterpret_cast<DirectX::XMFLOAT4A*>(rows[2]), rotMatrix.r[2]);
+#endif //_XM_SSE_INTRINSICS_
+
             // Extract Euler angles (pitch, yaw, roll) from rotation matrix
-            f32 pitch = std::asinf(-rotMatrix.r[2].m128_f32[1]); // Y-axis of forward
-            f32 yaw = std::atan2f(rotMatrix.r[2].m128_f32[0], rotMatrix.r[2].m128_f32[2]);
-            f32 roll = std::atan2f(rotMatrix.r[0].m128_f32[1], rotMatrix.r[1].m128_f32[1]);
+            f32 pitch = std::asin(-rows[2][1]); // Y-axis of forward
+            f32 yaw = std::atan2(rows[2][0], rows[2][2]);
+            f32 roll = std::atan2(rows[0][1], rows[1][1]);
 
             return TVectorRegister<T, 3>(pitch * k_radToDeg, yaw * k_radToDeg, roll * k_radToDeg);
         }
@@ -412,6 +424,20 @@ namespace math
         return m;
     }
 
+    template<FloatType T>
+    inline MatrixRegister4x4 SMatrix::transformMatrix(const TVectorRegister<T, 3>& translation, const TQuaternionRegister<T>& rotation, const TVectorRegister<T, 3>& scale)
+    {
+        MatrixRegister4x4 m;
+        m._m = DirectX::XMMatrixScalingFromVector(scale._v) * DirectX::XMMatrixRotationQuaternion(rotation._q) * DirectX::XMMatrixTranslationFromVector(translation._v);
+        return m;
+    }
+
+    template<FloatType T>
+    inline bool SMatrix::decompose(const MatrixRegister4x4& matrix, TVectorRegister<T, 3>& translation, TQuaternionRegister<T>& rotation, TVectorRegister<T, 3>& scale)
+    {
+        return DirectX::XMMatrixDecompose(&scale._v, &rotation._q, &translation._v, matrix._m);
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } //namespace math
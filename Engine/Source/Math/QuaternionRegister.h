@@ -25,7 +25,7 @@ namespace math
         TQuaternionRegister(T x, T y, T z, T w) noexcept;
         ~TQuaternionRegister() = default;
 
-        TQuaternionRegister<T>& operator=(const TQuaternionRegister<T>& other) const;
+        TQuaternionRegister<T>& operator=(const TQuaternionRegister<T>& other);
 
         [[nodiscard]] TQuaternionRegister<T> operator*(const TQuaternionRegister<T>& other) const;
         TQuaternionRegister<T>& operator*=(const TQuaternionRegister<T>& other);
@@ -59,6 +59,7 @@ namespace math
         template <RegisterType T, u32 Rows, u32 Cols> requires ValidMatrixDim<Rows, Cols>
         friend class TMatrixRegister;
         friend struct SQuaternion;
+        friend struct SMatrix;
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -81,6 +82,13 @@ namespace math
 
         template<RegisterType T>
         [[nodiscard]] TQuaternionRegister<T> static slerp(const TQuaternionRegister<T>& q1, const TQuaternionRegister<T>& q2, T d);
+
+        /**
+        * @brief fromEulerAngles. Same rotation order as TMatrixRegister::setRotation
+        * @param const TVectorRegister<T, 3>& rotation [in] pitch, yaw, roll in degrees
+        */
+        template<RegisterType T>
+        [[nodiscard]] TQuaternionRegister<T> static fromEulerAngles(const TVectorRegister<T, 3>& rotation);
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -44,7 +44,7 @@ namespace math
     }
 
     template<RegisterType T>
-    inline TQuaternionRegister<T>& TQuaternionRegister<T>::operator=(const TQuaternionRegister<T>& other) const
+    inline TQuaternionRegister<T>& TQuaternionRegister<T>::operator=(const TQuaternionRegister<T>& other)
     {
         if (this == &other)
         {
@@ -192,6 +192,14 @@ namespace math
         return q;
     }
 
+    template<RegisterType T>
+    inline TQuaternionRegister<T> SQuaternion::fromEulerAngles(const TVectorRegister<T, 3>& rotation)
+    {
+        TQuaternionRegister<T> q;
+        q._q = DirectX::XMQuaternionRotationRollPitchYawFromVector(DirectX::XMVectorScale(rotation._v, k_degToRad));
+        return q;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } //namespace math
@@ -15,6 +15,8 @@ namespace math
     template<u32 Dim>
     concept ValidVectorDim = (Dim >= 2 && Dim <= 4);
 
+    class Frustum;
+
     /**
     * @brief TVectorRegister struct
     */
@@ -92,6 +94,8 @@ namespace math
         friend class TMatrixRegister;
         friend struct SVector;
         friend struct SMatrix;
+        friend struct SQuaternion;
+        friend class Frustum;
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
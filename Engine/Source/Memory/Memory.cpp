@@ -78,6 +78,16 @@ void memory_test()
     ASSERT(g_allocr.empty(), "memory is not cleared");
 #endif //MEMORY_DEBUG
 }
+
+v3d::u64 memory_allocation_count()
+{
+#if MEMORY_DEBUG
+    std::lock_guard scope(g_mutex);
+    return std::accumulate(g_totalAllocCount.cbegin(), g_totalAllocCount.cend(), 0ULL);
+#else
+    return 0;
+#endif //MEMORY_DEBUG
+}
 } //namespace memory
 } //namespace v3d
 
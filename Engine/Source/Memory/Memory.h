@@ -38,6 +38,11 @@ namespace memory
 
     void memory_test();
 
+    /*
+    * @brief memory_allocation_count. Count of the engine allocations since start, all labels. 0 without MEMORY_DEBUG
+    */
+    v3d::u64 memory_allocation_count();
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     void* internal_malloc(v3d::u64 size, v3d::memory::MemoryLabel label, v3d::u64 align, const v3d::c8* file, v3d::u32 line);
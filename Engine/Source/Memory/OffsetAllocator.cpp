@@ -0,0 +1,330 @@
+#include "OffsetAllocator.h"
+
+#include <bit>
+
+namespace v3d
+{
+namespace memory
+{
+
+OffsetAllocator::OffsetAllocator(u64 size, u32 maxAllocations) noexcept
+    : m_size(size)
+    , m_maxAllocations(maxAllocations)
+    , m_freeStorage(0)
+    , m_freeRegionCount(0)
+    , m_allocationCount(0)
+    , m_usedBinsTop(0)
+{
+    //Every allocation splits a free region at most into two pieces
+    m_nodes.resize(static_cast<size_t>(maxAllocations) * 2 + 1);
+    m_freeNodes.reserve(m_nodes.size());
+
+    reset();
+}
+
+OffsetAllocator::~OffsetAllocator()
+{
+}
+
+void OffsetAllocator::reset()
+{
+    m_freeStorage = 0;
+    m_freeRegionCount = 0;
+    m_allocationCount = 0;
+    m_usedBinsTop = 0;
+    memset(m_usedBins, 0, sizeof(m_usedBins));
+    std::fill(std::begin(m_binHeads), std::end(m_binHeads), k_invalidNode);
+
+    m_freeNodes.clear();
+    for (u32 index = static_cast<u32>(m_nodes.size()); index > 0; --index)
+    {
+        m_freeNodes.push_back(index - 1);
+    }
+
+    if (m_size > 0)
+    {
+        insertFreeNode(0, m_size);
+    }
+}
+
+OffsetAllocator::Allocation OffsetAllocator::allocate(u64 size, u64 alignment)
+{
+    ASSERT(size > 0, "must be greater than 0");
+    ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "must be power of 2");
+
+    //A split needs up to two new nodes, for the alignment padding and for the tail
+    if (m_allocationCount >= m_maxAllocations || m_freeNodes.size() < 2)
+    {
+        return { 0, k_invalidNode };
+    }
+
+    //All nodes of a bin found by rounding the size up are big enough, only the alignment may not fit
+    u32 bin = findFreeBin(sizeToBinRoundUp(size));
+    u32 nodeIndex = (bin != k_invalidNode) ? m_binHeads[bin] : k_invalidNode;
+    if (nodeIndex == k_invalidNode || math::alignUp(m_nodes[nodeIndex]._offset, alignment) - m_nodes[nodeIndex]._offset + size > m_nodes[nodeIndex]._size)
+    {
+        if (alignment == 1)
+        {
+            return { 0, k_invalidNode };
+        }
+
+        bin = findFreeBin(sizeToBinRoundUp(size + alignment - 1));
+        if (bin == k_invalidNode)
+        {
+            return { 0, k_invalidNode };
+        }
+        nodeIndex = m_binHeads[bin];
+    }
+
+    removeFreeNode(nodeIndex);
+
+    Node& node = m_nodes[nodeIndex];
+    const u64 alignedOffset = math::alignUp(node._offset, alignment);
+    const u64 padding = alignedOffset - node._offset;
+    ASSERT(padding + size <= node._size, "must fit");
+    const u64 remainder = node._size - padding - size;
+
+    if (padding > 0)
+    {
+        const u32 paddingIndex = insertFreeNode(node._offset, padding);
+        Node& paddingNode = m_nodes[paddingIndex];
+        paddingNode._neighborPrev = node._neighborPrev;
+        paddingNode._neighborNext = nodeIndex;
+        if (node._neighborPrev != k_invalidNode)
+        {
+            m_nodes[node._neighborPrev]._neighborNext = paddingIndex;
+        }
+        node._neighborPrev = paddingIndex;
+    }
+
+    if (remainder > 0)
+    {
+        const u32 tailIndex = insertFreeNode(alignedOffset + size, remainder);
+        Node& tailNode = m_nodes[tailIndex];
+        tailNode._neighborPrev = nodeIndex;
+        tailNode._neighborNext = node._neighborNext;
+        if (node._neighborNext != k_invalidNode)
+        {
+            m_nodes[node._neighborNext]._neighborPrev = tailIndex;
+        }
+        node._neighborNext = tailIndex;
+    }
+
+    node._offset = alignedOffset;
+    node._size = size;
+    node._used = true;
+    ++m_allocationCount;
+
+    return { alignedOffset, nodeIndex };
+}
+
+void OffsetAllocator::free(const Allocation& allocation)
+{
+    ASSERT(allocation.isValid() && allocation._node < m_nodes.size(), "invalid allocation");
+    const u32 nodeIndex = allocation._node;
+    ASSERT(m_nodes[nodeIndex]._used, "double free");
+
+    u64 offset = m_nodes[nodeIndex]._offset;
+    u64 size = m_nodes[nodeIndex]._size;
+    u32 neighborPrev = m_nodes[nodeIndex]._neighborPrev;
+    u32 neighborNext = m_nodes[nodeIndex]._neighborNext;
+
+    //Merge with the free neighbors
+    if (neighborPrev != k_invalidNode && !m_nodes[neighborPrev]._used)
+    {
+        const Node& prevNode = m_nodes[neighborPrev];
+        offset = prevNode._offset;
+        size += prevNode._size;
+
+        removeFreeNode(neighborPrev);
+        m_freeNodes.push_back(neighborPrev);
+        neighborPrev = prevNode._neighborPrev;
+    }
+
+    if (neighborNext != k_invalidNode && !m_nodes[neighborNext]._used)
+    {
+        const Node& nextNode = m_nodes[neighborNext];
+        size += nextNode._size;
+
+        removeFreeNode(neighborNext);
+        m_freeNodes.push_back(neighborNext);
+        neighborNext = nextNode._neighborNext;
+    }
+
+    m_nodes[nodeIndex]._used = false;
+    m_freeNodes.push_back(nodeIndex);
+    --m_allocationCount;
+
+    const u32 freeIndex = insertFreeNode(offset, size);
+    m_nodes[freeIndex]._neighborPrev = neighborPrev;
+    m_nodes[freeIndex]._neighborNext = neighborNext;
+    if (neighborPrev != k_invalidNode)
+    {
+        m_nodes[neighborPrev]._neighborNext = freeIndex;
+    }
+    if (neighborNext != k_invalidNode)
+    {
+        m_nodes[neighborNext]._neighborPrev = freeIndex;
+    }
+}
+
+OffsetAllocator::StorageReport OffsetAllocator::getStorageReport() const
+{
+    StorageReport report = {};
+    report._totalFreeSpace = m_freeStorage;
+    report._freeRegionCount = m_freeRegionCount;
+    report._allocationCount = m_allocationCount;
+
+    //The largest region is in the highest used bin
+    if (m_usedBinsTop != 0)
+    {
+        const u32 top = 63 - std::countl_zero(m_usedBinsTop);
+        const u32 leaf = 31 - std::countl_zero<u32>(m_usedBins[top]);
+        for (u32 nodeIndex = m_binHeads[top * k_leafBinCount + leaf]; nodeIndex != k_invalidNode; nodeIndex = m_nodes[nodeIndex]._binNext)
+        {
+            report._largestFreeRegion = std::max(report._largestFreeRegion, m_nodes[nodeIndex]._size);
+        }
+    }
+
+    return report;
+}
+
+u32 OffsetAllocator::sizeToBinRoundUp(u64 size)
+{
+    //Small float: 3 bits of mantissa and the exponent, sizes below the mantissa range are stored as is
+    if (size < k_leafBinCount)
+    {
+        return static_cast<u32>(size);
+    }
+
+    const u32 highestBit = 63 - std::countl_zero(size);
+    const u32 mantissaStartBit = highestBit - k_mantissaBits;
+    const u32 exponent = mantissaStartBit + 1;
+    u32 mantissa = static_cast<u32>(size >> mantissaStartBit) & (k_leafBinCount - 1);
+
+    const u64 lowBitsMask = (1ULL << mantissaStartBit) - 1;
+    if (size & lowBitsMask)
+    {
+        ++mantissa; //carries into the exponent
+    }
+
+    return (exponent << k_mantissaBits) + mantissa;
+}
+
+u32 OffsetAllocator::sizeToBinRoundDown(u64 size)
+{
+    if (size < k_leafBinCount)
+    {
+        return static_cast<u32>(size);
+    }
+
+    const u32 highestBit = 63 - std::countl_zero(size);
+    const u32 mantissaStartBit = highestBit - k_mantissaBits;
+    const u32 exponent = mantissaStartBit + 1;
+    const u32 mantissa = static_cast<u32>(size >> mantissaStartBit) & (k_leafBinCount - 1);
+
+    return (exponent << k_mantissaBits) | mantissa;
+}
+
+u32 OffsetAllocator::findFreeBin(u32 minBin) const
+{
+    u32 top = minBin / k_leafBinCount;
+    const u32 leaf = minBin % k_leafBinCount;
+    if (top >= k_topBinCount)
+    {
+        return k_invalidNode;
+    }
+
+    const u32 leafMask = m_usedBins[top] & (0xFFu << leaf);
+    if (leafMask != 0)
+    {
+        return top * k_leafBinCount + std::countr_zero(leafMask);
+    }
+
+    if (top + 1 >= k_topBinCount)
+    {
+        return k_invalidNode;
+    }
+
+    const u64 topMask = m_usedBinsTop & (~0ULL << (top + 1));
+    if (topMask == 0)
+    {
+        return k_invalidNode;
+    }
+
+    top = std::countr_zero(topMask);
+    return top * k_leafBinCount + std::countr_zero<u32>(m_usedBins[top]);
+}
+
+u32 OffsetAllocator::insertFreeNode(u64 offset, u64 size)
+{
+    ASSERT(!m_freeNodes.empty(), "out of nodes");
+    const u32 nodeIndex = m_freeNodes.back();
+    m_freeNodes.pop_back();
+
+    const u32 bin = sizeToBinRoundDown(size);
+    const u32 top = bin / k_leafBinCount;
+    const u32 leaf = bin % k_leafBinCount;
+
+    Node& node = m_nodes[nodeIndex];
+    node._offset = offset;
+    node._size = size;
+    node._binPrev = k_invalidNode;
+    node._binNext = m_binHeads[bin];
+    node._neighborPrev = k_invalidNode;
+    node._neighborNext = k_invalidNode;
+    node._used = false;
+
+    if (node._binNext != k_invalidNode)
+    {
+        m_nodes[node._binNext]._binPrev = nodeIndex;
+    }
+    m_binHeads[bin] = nodeIndex;
+
+    m_usedBinsTop |= 1ULL << top;
+    m_usedBins[top] |= static_cast<u8>(1u << leaf);
+
+    m_freeStorage += size;
+    ++m_freeRegionCount;
+
+    return nodeIndex;
+}
+
+void OffsetAllocator::removeFreeNode(u32 nodeIndex)
+{
+    Node& node = m_nodes[nodeIndex];
+    ASSERT(!node._used, "must be free");
+
+    if (node._binPrev != k_invalidNode)
+    {
+        m_nodes[node._binPrev]._binNext = node._binNext;
+    }
+    else
+    {
+        const u32 bin = sizeToBinRoundDown(node._size);
+        ASSERT(m_binHeads[bin] == nodeIndex, "must be head");
+        m_binHeads[bin] = node._binNext;
+
+        if (node._binNext == k_invalidNode)
+        {
+            const u32 top = bin / k_leafBinCount;
+            const u32 leaf = bin % k_leafBinCount;
+            m_usedBins[top] &= static_cast<u8>(~(1u << leaf));
+            if (m_usedBins[top] == 0)
+            {
+                m_usedBinsTop &= ~(1ULL << top);
+            }
+        }
+    }
+
+    if (node._binNext != k_invalidNode)
+    {
+        m_nodes[node._binNext]._binPrev = node._binPrev;
+    }
+
+    m_freeStorage -= node._size;
+    --m_freeRegionCount;
+}
+
+} //namespace memory
+} //namespace v3d
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Common.h"
+
+namespace v3d
+{
+namespace memory
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief OffsetAllocator class. Two level segregated fit allocator of offsets inside a range.
+    * Doesn't touch the managed memory, so it can be used for GPU heaps.
+    * Allocate and free are O(1), nodes are preallocated. Free neighbors are merged on free.
+    * Not thread safe
+    */
+    class OffsetAllocator final
+    {
+    public:
+
+        static constexpr u32 k_invalidNode = ~0U;
+
+        struct Allocation
+        {
+            u64 _offset;
+            u32 _node;
+
+            bool isValid() const
+            {
+                return _node != k_invalidNode;
+            }
+        };
+
+        struct StorageReport
+        {
+            u64 _totalFreeSpace;
+            u64 _largestFreeRegion;
+            u32 _freeRegionCount;
+            u32 _allocationCount;
+
+            /**
+            * @brief getFragmentation. 0 if all free space is one region, close to 1 if it is split into small pieces
+            */
+            f32 getFragmentation() const
+            {
+                return (_totalFreeSpace == 0) ? 0.f : 1.f - static_cast<f32>(static_cast<f64>(_largestFreeRegion) / static_cast<f64>(_totalFreeSpace));
+            }
+        };
+
+        explicit OffsetAllocator(u64 size, u32 maxAllocations = 16 * 1024) noexcept;
+        ~OffsetAllocator();
+
+        OffsetAllocator(const OffsetAllocator&) = delete;
+        OffsetAllocator& operator=(const OffsetAllocator&) = delete;
+
+        [[nodiscard]] Allocation allocate(u64 size, u64 alignment = 1);
+        void free(const Allocation& allocation);
+        void reset();
+
+        u64 getSize() const;
+        u32 getAllocationCount() const;
+        u64 getAllocationSize(const Allocation& allocation) const;
+        StorageReport getStorageReport() const;
+
+    private:
+
+        static constexpr u32 k_mantissaBits = 3;
+        static constexpr u32 k_leafBinCount = 1 << k_mantissaBits;
+        static constexpr u32 k_topBinCount = 64;
+        static constexpr u32 k_binCount = k_topBinCount * k_leafBinCount;
+
+        struct Node
+        {
+            u64  _offset;
+            u64  _size;
+            u32  _binPrev;
+            u32  _binNext;
+            u32  _neighborPrev;
+            u32  _neighborNext;
+            bool _used;
+        };
+
+        static u32 sizeToBinRoundUp(u64 size);
+        static u32 sizeToBinRoundDown(u64 size);
+
+        u32 findFreeBin(u32 minBin) const;
+        u32 insertFreeNode(u64 offset, u64 size);
+        void removeFreeNode(u32 nodeIndex);
+
+        u64                 m_size;
+        u32                 m_maxAllocations;
+        u64                 m_freeStorage;
+        u32                 m_freeRegionCount;
+        u32                 m_allocationCount;
+
+        u64                 m_usedBinsTop;
+        u8                  m_usedBins[k_topBinCount];
+        u32                 m_binHeads[k_binCount];
+
+        std::vector<Node>   m_nodes;
+        std::vector<u32>    m_freeNodes;
+    };
+
+    inline u64 OffsetAllocator::getSize() const
+    {
+        return m_size;
+    }
+
+    inline u32 OffsetAllocator::getAllocationCount() const
+    {
+        return m_allocationCount;
+    }
+
+    inline u64 OffsetAllocator::getAllocationSize(const Allocation& allocation) const
+    {
+        ASSERT(allocation.isValid() && m_nodes[allocation._node]._used, "invalid allocation");
+        return m_nodes[allocation._node]._size;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace memory
+} //namespace v3d
@@ -0,0 +1,153 @@
+#include "WindowLinux.h"
+#include "Utils/Logger.h"
+
+#ifdef PLATFORM_LINUX
+#include <csignal>
+
+namespace v3d
+{
+namespace platform
+{
+
+static volatile std::sig_atomic_t s_terminateRequested = 0;
+
+static void terminateSignalHandler(s32 signal)
+{
+    s_terminateRequested = 1;
+}
+
+WindowLinux::WindowLinux(const WindowParams& params, event::InputEventReceiver* receiver, Window* parent) noexcept
+    : Window(params, receiver)
+    , m_parent(parent)
+    , m_initialized(false)
+{
+    LOG_DEBUG("WindowLinux::WindowLinux: Created headless window %llx", this);
+
+    //Nothing to show, it's always in front
+    m_params._isFullscreen = false;
+    m_params._isResizable = false;
+    m_params._isActive = true;
+    m_params._isFocused = true;
+}
+
+WindowLinux::~WindowLinux()
+{
+    LOG_DEBUG("WindowLinux::~WindowLinux");
+    ASSERT(!m_initialized, "Not destroyed");
+}
+
+bool WindowLinux::initialize()
+{
+    if (!m_parent)
+    {
+        std::signal(SIGINT, terminateSignalHandler);
+        std::signal(SIGTERM, terminateSignalHandler);
+    }
+
+    m_initialized = true;
+    LOG_DEBUG("WindowLinux::initialize: headless window %llx, size [%u, %u]", this, m_params._size._width, m_params._size._height);
+    return true;
+}
+
+bool WindowLinux::update()
+{
+    return s_terminateRequested == 0;
+}
+
+void WindowLinux::destroy()
+{
+    bool readyToDelete = true;
+    notify(readyToDelete);
+
+    m_initialized = false;
+}
+
+void WindowLinux::minimize()
+{
+    m_params._isMinimized = true;
+    m_params._isMaximized = false;
+}
+
+void WindowLinux::maximize()
+{
+    m_params._isMinimized = false;
+    m_params._isMaximized = true;
+}
+
+void WindowLinux::restore()
+{
+    m_params._isMinimized = false;
+    m_params._isMaximized = false;
+}
+
+void WindowLinux::show()
+{
+}
+
+void WindowLinux::focus()
+{
+}
+
+void WindowLinux::setFullScreen(bool value)
+{
+    m_params._isFullscreen = value;
+}
+
+void WindowLinux::setResizeble(bool value)
+{
+    m_params._isResizable = value;
+}
+
+void WindowLinux::setText(const std::string& text)
+{
+    m_params._text = text;
+}
+
+void WindowLinux::setSize(const math::Dimension2D& size)
+{
+    m_params._size = size;
+}
+
+void WindowLinux::setPosition(const math::Point2D& pos)
+{
+    m_params._position = pos;
+}
+
+bool WindowLinux::isMaximized() const
+{
+    return m_params._isMaximized;
+}
+
+bool WindowLinux::isMinimized() const
+{
+    return m_params._isMinimized;
+}
+
+bool WindowLinux::isActive() const
+{
+    return m_params._isActive;
+}
+
+bool WindowLinux::isFocused() const
+{
+    return m_params._isFocused;
+}
+
+NativeInstance WindowLinux::getInstance() const
+{
+    return nullptr;
+}
+
+NativeWindow WindowLinux::getWindowHandle() const
+{
+    return nullptr;
+}
+
+bool WindowLinux::isValid() const
+{
+    return m_initialized;
+}
+
+} //namespace platform
+} //namespace v3d
+#endif //PLATFORM_LINUX
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Common.h"
+#include "Window.h"
+#ifdef PLATFORM_LINUX
+
+namespace v3d
+{
+namespace platform
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief WindowLinux class. Linux platform.
+    * Headless window without a display connection, has no native handle. Swapchain renders to offscreen images.
+    * Stops the update loop on SIGINT/SIGTERM
+    */
+    class V3D_API WindowLinux : public Window
+    {
+    public:
+
+        explicit WindowLinux(const WindowParams& params, event::InputEventReceiver* receiver, Window* parent = nullptr) noexcept;
+        ~WindowLinux();
+
+        WindowLinux(const WindowLinux&) = delete;
+        WindowLinux& operator=(const WindowLinux&) = delete;
+
+        void minimize() override;
+        void maximize() override;
+        void restore() override;
+        void show() override;
+        void focus() override;
+
+        void setFullScreen(bool value = true) override;
+        void setResizeble(bool value = true) override;
+        void setText(const std::string& text) override;
+        void setSize(const math::Dimension2D& size) override;
+        void setPosition(const math::Point2D& pos) override;
+
+        bool isMaximized() const override;
+        bool isMinimized() const override;
+        bool isActive() const override;
+        bool isFocused() const override;
+
+        NativeInstance getInstance() const override;
+        NativeWindow getWindowHandle() const override;
+
+        bool isValid() const override;
+
+    private:
+
+        bool initialize() override;
+        bool update() override;
+        void destroy() override;
+
+        Window* m_parent;
+        bool    m_initialized;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace platform
+} //namespace v3d
+#endif //PLATFORM_LINUX
@@ -103,6 +103,11 @@ float GetDpiScaleForHwnd(void* hwnd)
 }
 #endif
 
+#ifdef PLATFORM_LINUX
+#   include <pthread.h>
+#   include <sched.h>
+#endif //PLATFORM_LINUX
+
 namespace v3d
 {
 namespace platform
@@ -163,19 +168,25 @@ void Platform::setCursorIcon(CursorIcon icon)
         win32_cursor = IDC_ARROW;
     }
     ::SetCursor(::LoadCursor(NULL, win32_cursor));
+#elif defined(PLATFORM_LINUX)
+    //Headless, there is no cursor
 #else
-    ASSERT("not impl");
+    ASSERT(false, "not impl");
 #endif //PLATFORM_WINDOWS
 }
 
 void Platform::hideCursor()
 {
+#ifdef PLATFORM_WINDOWS
     ::ShowCursor(FALSE);
+#endif //PLATFORM_WINDOWS
 }
 
 void Platform::showCursor()
 {
+#ifdef PLATFORM_WINDOWS
     ::ShowCursor(TRUE);
+#endif //PLATFORM_WINDOWS
 }
 
 math::Point2D Platform::getCursorPosition()
@@ -185,8 +196,10 @@ math::Point2D Platform::getCursorPosition()
     GetCursorPos(&mouse);
 
     return math::Point2D(static_cast<s32>(mouse.x), static_cast<s32>(mouse.y));
+#elif defined(PLATFORM_LINUX)
+    //Headless, there is no cursor
 #else
-    ASSERT("not impl");
+    ASSERT(false, "not impl");
 #endif //PLATFORM_WINDOWS
 
     return math::Point2D(0U, 0U);
@@ -196,8 +209,10 @@ void Platform::setCursorPostion(const math::Point2D& point)
 {
 #ifdef PLATFORM_WINDOWS
     SetCursorPos(point._x, point._y);
+#elif defined(PLATFORM_LINUX)
+    //Headless, there is no cursor
 #else
-    ASSERT("not impl");
+    ASSERT(false, "not impl");
 #endif //PLATFORM_WINDOWS
 }
 
@@ -271,6 +286,35 @@ bool Platform::setThreadPriority(std::thread& thread, s32 priority)
     return false;
 }
 
+#elif defined(PLATFORM_LINUX)
+bool Platform::setThreadName(std::thread& thread, const std::string& name)
+{
+    //The name is limited to 16 characters including the terminating null
+    const std::string shortName = name.substr(0, 15);
+    return pthread_setname_np(thread.native_handle(), shortName.c_str()) == 0;
+}
+
+bool Platform::setThreadAffinityMask(std::thread& thread, u64 mask)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (u32 cpu = 0; cpu < 64; ++cpu)
+    {
+        if (mask & (1ULL << cpu))
+        {
+            CPU_SET(cpu, &cpuSet);
+        }
+    }
+
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet) == 0;
+}
+
+bool Platform::setThreadPriority(std::thread& thread, s32 priority)
+{
+    //Priorities of SCHED_OTHER threads can't be changed per thread without privileges
+    return false;
+}
+
 #else
 bool Platform::setThreadName(std::thread& thread, const std::string& name)
 {
@@ -332,6 +376,85 @@ f32 Platform::getDpiScaleForWindow(const Window* window)
 {
     return GetDpiScaleForHwnd(window->getWindowHandle());
 }
+
+#elif defined(PLATFORM_LINUX)
+std::wstring Platform::utf8ToWide(const c8* in)
+{
+    //wchar_t is UTF-32 on Linux
+    std::wstring out;
+    const u8* str = reinterpret_cast<const u8*>(in);
+    while (*str)
+    {
+        u32 code = *str++;
+        u32 count = 0;
+        if (code >= 0xF0)
+        {
+            code &= 0x07;
+            count = 3;
+        }
+        else if (code >= 0xE0)
+        {
+            code &= 0x0F;
+            count = 2;
+        }
+        else if (code >= 0xC0)
+        {
+            code &= 0x1F;
+            count = 1;
+        }
+
+        for (; count > 0 && (*str & 0xC0) == 0x80; --count)
+        {
+            code = (code << 6) | (*str++ & 0x3F);
+        }
+        out.push_back(static_cast<w16>(code));
+    }
+
+    return out;
+}
+
+std::string Platform::wideToUtf8(const w16* in)
+{
+    std::string out;
+    for (; *in; ++in)
+    {
+        const u32 code = static_cast<u32>(*in);
+        if (code < 0x80)
+        {
+            out.push_back(static_cast<c8>(code));
+        }
+        else if (code < 0x800)
+        {
+            out.push_back(static_cast<c8>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<c8>(0x80 | (code & 0x3F)));
+        }
+        else if (code < 0x10000)
+        {
+            out.push_back(static_cast<c8>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<c8>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<c8>(0x80 | (code & 0x3F)));
+        }
+        else
+        {
+            out.push_back(static_cast<c8>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<c8>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<c8>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<c8>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    return out;
+}
+
+void Platform::enumDisplayMonitors(const DisplayMonitorsFunc& func)
+{
+    //Headless, there are no monitors
+}
+
+f32 Platform::getDpiScaleForWindow(const Window* window)
+{
+    return 1.0f;
+}
 #endif //PLATFORM_WINDOWS
 
 } //namespace platform
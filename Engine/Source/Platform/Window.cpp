@@ -9,6 +9,8 @@
 #   include "XBOX/WindowXBOX.h"
 #elif defined(PLATFORM_ANDROID)
 #   include "Android/WindowAndroid.h"
+#elif defined(PLATFORM_LINUX)
+#   include "Linux/WindowLinux.h"
 #endif //PLATFORM
 
 namespace v3d
@@ -44,6 +46,8 @@ Window* Window::createWindow(const math::Dimension2D& size, const math::Point2D&
     window = V3D_NEW(WindowXBOX, memory::MemoryLabel::MemorySystem)(params, receiver);
 #elif defined(PLATFORM_ANDROID)
     window = V3D_NEW(WindowAndroid, memory::MemoryLabel::MemorySystem)(params, receiver);
+#elif defined(PLATFORM_LINUX)
+    window = V3D_NEW(WindowLinux, memory::MemoryLabel::MemorySystem)(params, receiver);
 #endif //PLATFORM
 
     if (!window)
@@ -81,6 +85,8 @@ Window* Window::createWindow(const math::Dimension2D& size, const math::Point2D&
     window = V3D_NEW(WindowXBOX, memory::MemoryLabel::MemorySystem)(params, receiver);
 #elif defined(PLATFORM_ANDROID)
     window = V3D_NEW(WindowAndroid, memory::MemoryLabel::MemorySystem)(params, receiver);
+#elif defined(PLATFORM_LINUX)
+    window = V3D_NEW(WindowLinux, memory::MemoryLabel::MemorySystem)(params, receiver);
 #endif //PLATFORM
 
     if (!window)
@@ -119,6 +125,8 @@ Window* Window::createWindow(const math::Dimension2D& size, const math::Point2D&
     window = V3D_NEW(WindowXBOX, memory::MemoryLabel::MemorySystem)(params, parent->getInputEventReceiver());
 #elif defined(PLATFORM_ANDROID)
     window = V3D_NEW(WindowAndroid, memory::MemoryLabel::MemorySystem)(params, parent->getInputEventReceiver());
+#elif defined(PLATFORM_LINUX)
+    window = V3D_NEW(WindowLinux, memory::MemoryLabel::MemorySystem)(params, parent->getInputEventReceiver(), parent);
 #endif //PLATFORM
 
     if (!window)
@@ -36,6 +36,18 @@ RenderPipelineDebugStage::~RenderPipelineDebugStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineDebugStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "simple.hlsl", "simple_vs", renderer::ShaderType::Vertex },
+        { "simple.hlsl", "unlit_ps", renderer::ShaderType::Fragment },
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex },
+        { "debug.hlsl", "debug_visualizer_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineDebugStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     createRenderTarget(device, scene, frame);
@@ -65,6 +77,8 @@ void RenderPipelineDebugStage::create(renderer::Device* device, scene::SceneData
             pipeline->setDepthWrite(false);
             pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+            device->compilePipeline(*pipeline);
+
             MaterialParameters parameters;
             BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
             BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
@@ -90,6 +104,8 @@ void RenderPipelineDebugStage::create(renderer::Device* device, scene::SceneData
             pipeline->setDepthWrite(false);
             pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+            device->compilePipeline(*pipeline);
+
             MaterialParameters parameters;
             BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
             BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
@@ -116,6 +132,8 @@ void RenderPipelineDebugStage::create(renderer::Device* device, scene::SceneData
             pipeline->setDepthBias(2.0f, 0.0f, 2.0f);
             pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+            device->compilePipeline(*pipeline);
+
             MaterialParameters parameters;
             BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
             BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
@@ -143,6 +161,8 @@ void RenderPipelineDebugStage::create(renderer::Device* device, scene::SceneData
         m_debugVisualizerPipeline->setDepthTest(false);
         m_debugVisualizerPipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*m_debugVisualizerPipeline);
+
         BIND_SHADER_PARAMETER(m_debugVisualizerPipeline, m_debugVisualizerParameters, cb_Viewport);
         BIND_SHADER_PARAMETER(m_debugVisualizerPipeline, m_debugVisualizerParameters, cb_Visualizer);
         BIND_SHADER_PARAMETER(m_debugVisualizerPipeline, m_debugVisualizerParameters, s_SamplerState);
@@ -306,7 +326,7 @@ void RenderPipelineDebugStage::execute(renderer::Device* device, scene::SceneDat
                 constantBuffer.modelMatrix = itemMesh.object->getTransform().getMatrix();
                 constantBuffer.prevModelMatrix = itemMesh.object->getPrevTransform().getMatrix();
                 constantBuffer.normalMatrix = constantBuffer.modelMatrix.getTransposed();
-                constantBuffer.tintColour = material.getProperty<math::float4>("DiffuseColor");
+                constantBuffer.tintColour = material.getParameters()._colors[scene::MaterialParameters::DiffuseColor];
                 constantBuffer.objectID = 0;
 
                 cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
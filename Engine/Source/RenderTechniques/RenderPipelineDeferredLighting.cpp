@@ -31,6 +31,21 @@ RenderPipelineDeferredLightingStage::~RenderPipelineDeferredLightingStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineDeferredLightingStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    const renderer::Shader::DefineList defines =
+    {
+        { "DEBUG_SHADOWMAP_CASCADES", std::to_string(scene.m_settings._shadowsParams._debugShadowCascades) },
+    };
+
+    //Same variants as create loads
+    return
+    {
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex, defines },
+        { "deferred_lighting.hlsl", "deffered_lighting_ps", renderer::ShaderType::Fragment, defines },
+    };
+}
+
 void RenderPipelineDeferredLightingStage::create(renderer::Device* device, SceneData& scene, FrameData& frame)
 {
     if (m_created)
@@ -67,6 +82,8 @@ void RenderPipelineDeferredLightingStage::create(renderer::Device* device, Scene
     //m_pipeline->setStencilBackFaceCompareOp(renderer::CompareOperation::NotEqual, 0x0);
     //m_pipeline->setStencilBackFaceOp(renderer::StencilOperation::Keep, renderer::StencilOperation::Keep, renderer::StencilOperation::Keep);
 
+    device->compilePipeline(*m_pipeline);
+
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Viewport);
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Light);
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, s_SamplerState);
@@ -12,6 +12,10 @@ namespace renderer
     class RenderTargetState;
     class GraphicsPipelineState;
 } // namespace renderer
+namespace resource
+{
+    struct ShaderPermutation;
+} // namespace resource
 namespace scene
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -29,6 +33,8 @@ namespace scene
         void prepare(renderer::Device* device, SceneData& scene, scene::FrameData& frame) override;
         void execute(renderer::Device* device, SceneData& scene, scene::FrameData& frame) override;
 
+        static std::vector<resource::ShaderPermutation> getShaderPermutations(const scene::SceneData& scene);
+
     private:
 
         struct MaterialParameters
@@ -26,6 +26,16 @@ RenderPipelineFXAAStage::~RenderPipelineFXAAStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineFXAAStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex },
+        { "fxaa.hlsl", "fxaa_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineFXAAStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     if (m_created)
@@ -57,6 +67,8 @@ void RenderPipelineFXAAStage::create(renderer::Device* device, scene::SceneData&
         m_pipeline->setDepthTest(false);
         m_pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*m_pipeline);
+
         BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(m_pipeline, m_parameters, s_SamplerState);
         BIND_SHADER_PARAMETER(m_pipeline, m_parameters, t_TextureColor);
@@ -25,14 +25,31 @@ namespace scene
 RenderPipelineGBufferStage::RenderPipelineGBufferStage(RenderTechnique* technique, scene::ModelHandler* modelHandler) noexcept
     : RenderPipelineStage(technique, "GBuffer")
     , m_modelHandler(modelHandler)
-
-    , m_GBufferRenderTarget(nullptr)
+    , m_bindless(false)
+    , m_bindlessFrame(0)
 {
+    m_GBufferRenderTargets.fill(nullptr);
 }
 
 RenderPipelineGBufferStage::~RenderPipelineGBufferStage()
 {
-    ASSERT(m_GBufferRenderTarget == nullptr, "must be nullptr");
+    ASSERT(m_GBufferRenderTargets[toEnumType(RenderTargetPart::Whole)] == nullptr, "must be nullptr");
+}
+
+std::vector<resource::ShaderPermutation> RenderPipelineGBufferStage::getShaderPermutations(const scene::SceneData& scene, bool bindless)
+{
+    const renderer::Shader::DefineList separate = { { "SEPARATE_MATERIALS", "1" }, { "BINDLESS", bindless ? "1" : "0" } };
+    const renderer::Shader::DefineList combined = { { "SEPARATE_MATERIALS", "0" }, { "BINDLESS", bindless ? "1" : "0" } };
+
+    return
+    {
+        { "gbuffer.hlsl", "gbuffer_standard_vs", renderer::ShaderType::Vertex, separate },
+        { "gbuffer.hlsl", "gbuffer_standard_ps", renderer::ShaderType::Fragment, separate },
+        { "gbuffer.hlsl", "gbuffer_standard_vs", renderer::ShaderType::Vertex, combined },
+        { "gbuffer.hlsl", "gbuffer_standard_ps", renderer::ShaderType::Fragment, combined },
+        { "gbuffer.hlsl", "gbuffer_masked_ps", renderer::ShaderType::Fragment, separate },
+        { "gbuffer.hlsl", "gbuffer_masked_ps", renderer::ShaderType::Fragment, combined },
+    };
 }
 
 void RenderPipelineGBufferStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
@@ -44,181 +61,75 @@ void RenderPipelineGBufferStage::create(renderer::Device* device, scene::SceneDa
 
     createRenderTarget(device, scene, frame);
 
-    //PBR_MetallicRoughness
-    {
-        const renderer::Shader::DefineList defines =
-        { 
-            { "SEPARATE_MATERIALS", "1" },
-        };
+    m_bindless = device->getDeviceCaps()._supportBindless;
 
-        const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_standard_vs",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
-        const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_standard_ps",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
+    //Compiles all variants at once, loadShader below finds them registered
+    resource::ResourceManager::getInstance()->compileShaders(RenderPipelineGBufferStage::getShaderPermutations(scene, m_bindless), resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
 
-        renderer::GraphicsPipelineState* pipeline = V3D_NEW(renderer::GraphicsPipelineState, memory::MemoryLabel::MemoryGame)(device, VertexFormatStandardDesc, m_GBufferRenderTarget->getRenderPassDesc(),
-            V3D_NEW(renderer::ShaderProgram, memory::MemoryLabel::MemoryGame)(device, vertShader, fragShader), "gbuffer_pipeline");
+    //PBR_MetallicRoughness, the order matches DrawNodeEntry::pipelineID
+    RenderPipelineGBufferStage::createPipeline(device, true, false);
+    RenderPipelineGBufferStage::createPipeline(device, false, false);
 
-        pipeline->setPrimitiveTopology(renderer::PrimitiveTopology::PrimitiveTopology_TriangleList);
-        pipeline->setFrontFace(renderer::FrontFace::FrontFace_Clockwise);
-        pipeline->setCullMode(renderer::CullMode::CullMode_None);
-#if REVERSED_DEPTH
-        pipeline->setDepthCompareOp(renderer::CompareOperation::GreaterOrEqual);
-#else
-        pipeline->setDepthCompareOp(renderer::CompareOperation::LessOrEqual);
-#endif
-        pipeline->setDepthTest(true);
-        pipeline->setDepthWrite(false);
-        pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(1, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(2, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(3, renderer::ColorMask::ColorMask_All);
-
-        MaterialParameters parameters;
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
-        BIND_SHADER_PARAMETER(pipeline, parameters, s_SamplerState);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureAlbedo);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureNormal);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureMetalness);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureRoughness);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureHeight);
+    //PBR_MetallicRoughness alpha
+    RenderPipelineGBufferStage::createPipeline(device, true, true);
+    RenderPipelineGBufferStage::createPipeline(device, false, true);
 
-        m_pipelines.emplace_back(pipeline);
-        m_parameters.emplace_back(parameters);
-    }
+    m_created = true;
+}
 
-    //PBR_MetallicRoughness
+void RenderPipelineGBufferStage::createPipeline(renderer::Device* device, bool separateMaterials, bool masked)
+{
+    const renderer::Shader::DefineList defines =
     {
-        const renderer::Shader::DefineList defines =
-        {
-            { "SEPARATE_MATERIALS", "0" },
-        };
+        { "SEPARATE_MATERIALS", separateMaterials ? "1" : "0" },
+        { "BINDLESS", m_bindless ? "1" : "0" },
+    };
 
-        const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_standard_vs",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
-        const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_standard_ps",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
+    const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_standard_vs",
+        defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
+    const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", masked ? "gbuffer_masked_ps" : "gbuffer_standard_ps",
+        defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
 
-        renderer::GraphicsPipelineState* pipeline = V3D_NEW(renderer::GraphicsPipelineState, memory::MemoryLabel::MemoryGame)(device, VertexFormatStandardDesc, m_GBufferRenderTarget->getRenderPassDesc(),
-            V3D_NEW(renderer::ShaderProgram, memory::MemoryLabel::MemoryGame)(device, vertShader, fragShader), "gbuffer_pipeline");
+    renderer::GraphicsPipelineState* pipeline = V3D_NEW(renderer::GraphicsPipelineState, memory::MemoryLabel::MemoryGame)(device, VertexFormatStandardDesc, m_GBufferRenderTargets[toEnumType(RenderTargetPart::Whole)]->getRenderPassDesc(),
+        V3D_NEW(renderer::ShaderProgram, memory::MemoryLabel::MemoryGame)(device, vertShader, fragShader), masked ? "gbuffer_masked_pipeline" : "gbuffer_pipeline");
 
-        pipeline->setPrimitiveTopology(renderer::PrimitiveTopology::PrimitiveTopology_TriangleList);
-        pipeline->setFrontFace(renderer::FrontFace::FrontFace_Clockwise);
-        pipeline->setCullMode(renderer::CullMode::CullMode_None);
+    pipeline->setPrimitiveTopology(renderer::PrimitiveTopology::PrimitiveTopology_TriangleList);
+    pipeline->setFrontFace(renderer::FrontFace::FrontFace_Clockwise);
+    pipeline->setCullMode(renderer::CullMode::CullMode_None);
 #if REVERSED_DEPTH
-        pipeline->setDepthCompareOp(renderer::CompareOperation::GreaterOrEqual);
+    pipeline->setDepthCompareOp(renderer::CompareOperation::GreaterOrEqual);
 #else
-        pipeline->setDepthCompareOp(renderer::CompareOperation::LessOrEqual);
+    pipeline->setDepthCompareOp(renderer::CompareOperation::LessOrEqual);
 #endif
-        pipeline->setDepthTest(true);
-        pipeline->setDepthWrite(false);
-        pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(1, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(2, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(3, renderer::ColorMask::ColorMask_All);
-
-        MaterialParameters parameters;
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
-        BIND_SHADER_PARAMETER(pipeline, parameters, s_SamplerState);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureAlbedo);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureNormal);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureMaterial);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureHeight);
-
-        m_pipelines.emplace_back(pipeline);
-        m_parameters.emplace_back(parameters);
-    }
-
-    //PBR_MetallicRoughness alpha
+    pipeline->setDepthTest(true);
+    //The opaque depth is written by the z prepass, the masked objects aren't in it
+    pipeline->setDepthWrite(masked);
+    pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
+    pipeline->setColorMask(1, renderer::ColorMask::ColorMask_All);
+    pipeline->setColorMask(2, renderer::ColorMask::ColorMask_All);
+    pipeline->setColorMask(3, renderer::ColorMask::ColorMask_All);
+
+    device->compilePipeline(*pipeline);
+
+    MaterialParameters parameters;
+    BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
+    BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
+    BIND_SHADER_PARAMETER(pipeline, parameters, s_SamplerState);
+    BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureAlbedo);
+    BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureNormal);
+    if (separateMaterials)
     {
-        const renderer::Shader::DefineList defines =
-        {
-            { "SEPARATE_MATERIALS", "1" },
-        };
-
-        const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_standard_vs",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
-        const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_masked_ps",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
-
-        renderer::GraphicsPipelineState* pipeline = V3D_NEW(renderer::GraphicsPipelineState, memory::MemoryLabel::MemoryGame)(device, VertexFormatStandardDesc, m_GBufferRenderTarget->getRenderPassDesc(),
-            V3D_NEW(renderer::ShaderProgram, memory::MemoryLabel::MemoryGame)(device, vertShader, fragShader), "gbuffer_masked_pipeline");
-
-        pipeline->setPrimitiveTopology(renderer::PrimitiveTopology::PrimitiveTopology_TriangleList);
-        pipeline->setFrontFace(renderer::FrontFace::FrontFace_Clockwise);
-        pipeline->setCullMode(renderer::CullMode::CullMode_None);
-#if REVERSED_DEPTH
-        pipeline->setDepthCompareOp(renderer::CompareOperation::GreaterOrEqual);
-#else
-        pipeline->setDepthCompareOp(renderer::CompareOperation::LessOrEqual);
-#endif
-        pipeline->setDepthTest(true);
-        pipeline->setDepthWrite(true);
-        pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(1, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(2, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(3, renderer::ColorMask::ColorMask_All);
-
-        MaterialParameters parameters;
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
-        BIND_SHADER_PARAMETER(pipeline, parameters, s_SamplerState);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureAlbedo);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureNormal);
         BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureMetalness);
         BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureRoughness);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureHeight);
-
-        m_pipelines.emplace_back(pipeline);
-        m_parameters.emplace_back(parameters);
     }
-
-    //PBR_MetallicRoughness alpha
+    else
     {
-        const renderer::Shader::DefineList defines =
-        {
-            { "SEPARATE_MATERIALS", "0" },
-        };
-
-        const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_standard_vs",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
-        const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>("gbuffer.hlsl", "gbuffer_masked_ps",
-            defines, {}, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
-
-        renderer::GraphicsPipelineState* pipeline = V3D_NEW(renderer::GraphicsPipelineState, memory::MemoryLabel::MemoryGame)(device, VertexFormatStandardDesc, m_GBufferRenderTarget->getRenderPassDesc(),
-            V3D_NEW(renderer::ShaderProgram, memory::MemoryLabel::MemoryGame)(device, vertShader, fragShader), "gbuffer_masked_pipeline");
-
-        pipeline->setPrimitiveTopology(renderer::PrimitiveTopology::PrimitiveTopology_TriangleList);
-        pipeline->setFrontFace(renderer::FrontFace::FrontFace_Clockwise);
-        pipeline->setCullMode(renderer::CullMode::CullMode_None);
-#if REVERSED_DEPTH
-        pipeline->setDepthCompareOp(renderer::CompareOperation::GreaterOrEqual);
-#else
-        pipeline->setDepthCompareOp(renderer::CompareOperation::LessOrEqual);
-#endif
-        pipeline->setDepthTest(true);
-        pipeline->setDepthWrite(true);
-        pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(1, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(2, renderer::ColorMask::ColorMask_All);
-        pipeline->setColorMask(3, renderer::ColorMask::ColorMask_All);
-
-        MaterialParameters parameters;
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
-        BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
-        BIND_SHADER_PARAMETER(pipeline, parameters, s_SamplerState);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureAlbedo);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureNormal);
         BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureMaterial);
-        BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureHeight);
-
-        m_pipelines.emplace_back(pipeline);
-        m_parameters.emplace_back(parameters);
     }
+    BIND_SHADER_PARAMETER(pipeline, parameters, t_TextureHeight);
 
-    m_created = true;
+    m_pipelines.emplace_back(pipeline);
+    m_parameters.emplace_back(parameters);
 }
 
 void RenderPipelineGBufferStage::destroy(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
@@ -226,6 +137,11 @@ void RenderPipelineGBufferStage::destroy(renderer::Device* device, scene::SceneD
     if (m_created)
     {
         destroyRenderTarget(device, scene, frame);
+        for (BindlessModels& models : m_bindlessModels)
+        {
+            destroyBindlessModels(device, models);
+        }
+        m_bindlessModels.clear();
 
         for (auto& pipeline : m_pipelines)
         {
@@ -245,11 +161,26 @@ void RenderPipelineGBufferStage::prepare(renderer::Device* device, scene::SceneD
 {
     ASSERT(m_created, "must be created");
 
-    if (m_GBufferRenderTarget->getRenderArea() != scene.m_viewportSize)
+    if (m_GBufferRenderTargets[toEnumType(RenderTargetPart::Whole)]->getRenderArea() != scene.m_viewportSize)
     {
         destroyRenderTarget(device, scene, frame);
         createRenderTarget(device, scene, frame);
     }
+
+    if (m_bindless)
+    {
+        //Every draw of the pass writes its model to the buffer of the frame
+        const u32 count = static_cast<u32>(scene.m_renderLists[toEnumType(scene::ScenePass::Opaque)].size() + scene.m_renderLists[toEnumType(scene::ScenePass::MaskedOpaque)].size());
+        //The buffer of the frame is written while the GPU could read the buffers of the frames in flight
+        const u32 bindlessModelsCount = device->getFramesInFlight() + 1;
+        if (m_bindlessModels.size() < bindlessModelsCount)
+        {
+            m_bindlessModels.resize(bindlessModelsCount);
+        }
+
+        m_bindlessFrame = (m_bindlessFrame + 1) % static_cast<u32>(m_bindlessModels.size());
+        prepareBindlessModels(device, m_bindlessModels[m_bindlessFrame], count);
+    }
 }
 
 void RenderPipelineGBufferStage::execute(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
@@ -266,7 +197,11 @@ void RenderPipelineGBufferStage::execute(renderer::Device* device, scene::SceneD
         //TODO: record cbo to frame data
     }
 
-    auto renderJob = [this](renderer::Device* device, renderer::CmdListRender* cmdList, const scene::SceneData& scene, const scene::FrameData& frame) -> void
+    //The parts split the opaque list followed by the masked list by the same grain, the draw index is the model index in the buffer of the frame
+    const u32 opaqueCount = static_cast<u32>(scene.m_renderLists[toEnumType(scene::ScenePass::Opaque)].size());
+    const u32 maskedCount = static_cast<u32>(scene.m_renderLists[toEnumType(scene::ScenePass::MaskedOpaque)].size());
+    const BindlessModels bindlessModels = m_bindless ? m_bindlessModels[m_bindlessFrame] : BindlessModels();
+    auto renderJob = [this, bindlessModels](renderer::Device* device, renderer::CmdListRender* cmdList, const scene::SceneData& scene, const scene::FrameData& frame, const RenderJobRange& range) -> void
         {
             TRACE_PROFILER_SCOPE("GBuffer", color::rgba8::GREEN);
             DEBUG_MARKER_SCOPE(cmdList, "GBuffer", color::rgbaf::GREEN);
@@ -280,68 +215,118 @@ void RenderPipelineGBufferStage::execute(renderer::Device* device, scene::SceneD
             ASSERT(linearSamplerRepeat_handler.isValid(), "must be valid");
             renderer::SamplerState* sampler = linearSamplerRepeat_handler.as<renderer::SamplerState>();
 
-            cmdList->beginRenderTarget(*m_GBufferRenderTarget);
+            //The material textures which aren't in the descriptor heap are read as the default one
+            u32 defaultIndex = renderer::k_invalidBindlessIndex;
+            if (m_bindless)
+            {
+                ObjectHandle defaultTexture_handle = scene.m_globalResources.get("default_black");
+                ASSERT(defaultTexture_handle.isValid(), "must be valid");
+                defaultIndex = defaultTexture_handle.as<renderer::Texture2D>()->getBindlessIndex();
+                ASSERT(defaultIndex != renderer::k_invalidBindlessIndex, "the default texture must be registered");
+            }
+
+            const RenderTargetPart part = range.getPart();
+            cmdList->beginRenderTarget(*m_GBufferRenderTargets[toEnumType(part)]);
             cmdList->setViewport({ 0.f, 0.f, (f32)viewportState->viewportSize._x, (f32)viewportState->viewportSize._y });
             cmdList->setScissor({ 0.f, 0.f, (f32)viewportState->viewportSize._x, (f32)viewportState->viewportSize._y });
 
-            for (auto& entry : scene.m_renderLists[toEnumType(scene::ScenePass::Opaque)])
+            //The bindless pipelines share set 0, it is bound once for the pass and kept by the pipeline changes
+            bool bindlessPassBound = false;
+            auto bindBindlessPass = [&](const renderer::GraphicsPipelineState* pipeline, const MaterialParameters& parameters) -> void
+                {
+                    if (!bindlessPassBound)
+                    {
+                        cmdList->bindDescriptorSet(pipeline->getShaderProgram(), 0,
+                            {
+                                renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ viewportState, 0, sizeof(scene::ViewportState)}, parameters.cb_Viewport),
+                                renderer::Descriptor(sampler, parameters.s_SamplerState),
+                            });
+                        bindlessPassBound = true;
+                    }
+                };
+
+            const std::vector<NodeEntry*>& opaqueList = scene.m_renderLists[toEnumType(scene::ScenePass::Opaque)];
+            const u32 opaqueEnd = std::min<u32>(range._end, static_cast<u32>(opaqueList.size()));
+            for (u32 index = range._begin; index < opaqueEnd; ++index)
             {
-                const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(entry);
+                const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(opaqueList[index]);
                 const scene::Mesh& mesh = *static_cast<scene::Mesh*>(itemMesh.geometry);
                 const scene::Material& material = *static_cast<scene::Material*>(itemMesh.material);
 
                 cmdList->setPipelineState(*m_pipelines[itemMesh.pipelineID]);
-                cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 0,
-                    {
-                        renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ viewportState, 0, sizeof(scene::ViewportState)}, m_parameters[itemMesh.pipelineID].cb_Viewport)
-                    });
 
-                struct ModelBuffer
+                if (m_bindless)
                 {
-                    math::Matrix4D modelMatrix;
-                    math::Matrix4D prevModelMatrix;
-                    math::Matrix4D normalMatrix;
-                    math::float4   tintColour;
-                    u64            objectID;
-                    u64           _pad = 0;
-                };
+                    bindBindlessPass(m_pipelines[itemMesh.pipelineID], m_parameters[itemMesh.pipelineID]);
 
-                ModelBuffer constantBuffer;
-                constantBuffer.modelMatrix = itemMesh.object->getTransform().getMatrix();
-                constantBuffer.prevModelMatrix = itemMesh.object->getPrevTransform().getMatrix();
-                constantBuffer.normalMatrix = constantBuffer.modelMatrix.getInversed();
-                constantBuffer.normalMatrix.makeTransposed();
-                constantBuffer.tintColour = material.getProperty<math::float4>("DiffuseColor");
-                constantBuffer.objectID = itemMesh.object->ID();
+                    //The model is written to the storage buffer of the frame, only the indices are changed per draw
+                    ASSERT(index < bindlessModels._capacity, "range out");
+                    writeModelBuffer(bindlessModels._models[index], itemMesh, material);
 
-                if (material.getShadingModel() == scene::MaterialShadingModel::PBR_MetallicRoughness)
-                {
-                    cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
-                        {
-                            renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &constantBuffer, 0, sizeof(constantBuffer)}, m_parameters[itemMesh.pipelineID].cb_Model),
-                            renderer::Descriptor(sampler, m_parameters[itemMesh.pipelineID].s_SamplerState),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("BaseColor").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureAlbedo),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Normals").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureNormal),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Roughness").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureRoughness),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Metalness").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureMetalness),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Displacement").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureHeight),
-                        });
+                    BindlessMaterial indices;
+                    indices.modelBuffer = bindlessModels._index;
+                    indices.model = index;
+                    if (material.getShadingModel() == scene::MaterialShadingModel::PBR_MetallicRoughness)
+                    {
+                        indices.albedo = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::BaseColor].as<renderer::Texture2D>(), defaultIndex);
+                        indices.normal = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>(), defaultIndex);
+                        indices.material = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Roughness].as<renderer::Texture2D>(), defaultIndex);
+                        indices.metalness = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Metalness].as<renderer::Texture2D>(), defaultIndex);
+                        indices.height = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Displacement].as<renderer::Texture2D>(), defaultIndex);
+                    }
+                    else
+                    {
+                        ASSERT(material.getShadingModel() == scene::MaterialShadingModel::Custom, "unknown model");
+                        indices.albedo = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Diffuse].as<renderer::Texture2D>(), defaultIndex);
+                        indices.normal = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>(), defaultIndex);
+                        indices.material = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Specular].as<renderer::Texture2D>(), defaultIndex);
+                        indices.metalness = indices.albedo;
+                        indices.height = indices.albedo;
+                    }
+                    indices.mask = indices.albedo;
+
+                    cmdList->bindPushConstant(renderer::ShaderType::Vertex, sizeof(BindlessMaterial), &indices);
+                    cmdList->bindPushConstant(renderer::ShaderType::Fragment, sizeof(BindlessMaterial), &indices);
                 }
-                else if (material.getShadingModel() == scene::MaterialShadingModel::Custom)
+                else
                 {
-                    //TODO: Rework. Internal V3D material pipeline. Used packed materials (R: ? G: Roughness  B: Metalness)
-                    cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
+                    cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 0,
                         {
-                            renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &constantBuffer, 0, sizeof(constantBuffer)}, m_parameters[itemMesh.pipelineID].cb_Model),
-                            renderer::Descriptor(sampler, m_parameters[itemMesh.pipelineID].s_SamplerState),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Diffuse").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureAlbedo),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Normals").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureNormal),
-                            renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Specular").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureMaterial),
+                            renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ viewportState, 0, sizeof(scene::ViewportState)}, m_parameters[itemMesh.pipelineID].cb_Viewport)
                         });
-                }
-                else
-                {
-                    ASSERT(false, "");
+
+                    ModelBuffer constantBuffer;
+                    writeModelBuffer(constantBuffer, itemMesh, material);
+
+                    if (material.getShadingModel() == scene::MaterialShadingModel::PBR_MetallicRoughness)
+                    {
+                        cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
+                            {
+                                renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &constantBuffer, 0, sizeof(constantBuffer)}, m_parameters[itemMesh.pipelineID].cb_Model),
+                                renderer::Descriptor(sampler, m_parameters[itemMesh.pipelineID].s_SamplerState),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::BaseColor].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureAlbedo),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureNormal),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Roughness].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureRoughness),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Metalness].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureMetalness),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Displacement].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureHeight),
+                            });
+                    }
+                    else if (material.getShadingModel() == scene::MaterialShadingModel::Custom)
+                    {
+                        //TODO: Rework. Internal V3D material pipeline. Used packed materials (R: ? G: Roughness  B: Metalness)
+                        cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
+                            {
+                                renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &constantBuffer, 0, sizeof(constantBuffer)}, m_parameters[itemMesh.pipelineID].cb_Model),
+                                renderer::Descriptor(sampler, m_parameters[itemMesh.pipelineID].s_SamplerState),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Diffuse].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureAlbedo),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureNormal),
+                                renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Specular].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureMaterial),
+                            });
+                    }
+                    else
+                    {
+                        ASSERT(false, "");
+                    }
                 }
 
                 DEBUG_MARKER_SCOPE(cmdList, std::format("Object [{}], pipeline [{}]", itemMesh.object->m_name, m_pipelines[itemMesh.pipelineID]->getName()), color::rgbaf::LTGREY);
@@ -350,9 +335,12 @@ void RenderPipelineGBufferStage::execute(renderer::Device* device, scene::SceneD
                 cmdList->drawIndexed(desc, 0, mesh.getIndexBuffer()->getIndicesCount(), 0, 0, 1);
             }
 
-            for (auto& entry : scene.m_renderLists[toEnumType(scene::ScenePass::MaskedOpaque)])
+            const std::vector<NodeEntry*>& maskedList = scene.m_renderLists[toEnumType(scene::ScenePass::MaskedOpaque)];
+            const u32 maskedBegin = std::max<u32>(range._begin, static_cast<u32>(opaqueList.size()));
+            for (u32 model = maskedBegin; model < range._end; ++model)
             {
-                const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(entry);
+                const u32 index = model - static_cast<u32>(opaqueList.size());
+                const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(maskedList[index]);
                 const scene::Mesh& mesh = *static_cast<scene::Mesh*>(itemMesh.geometry);
                 const scene::Material& material = *static_cast<scene::Material*>(itemMesh.material);
 
@@ -362,39 +350,48 @@ void RenderPipelineGBufferStage::execute(renderer::Device* device, scene::SceneD
                 ASSERT(noise.isValid(), "must be valid");
                 renderer::Texture2D* noiseTexture = objectFromHandle<renderer::Texture2D>(noise);
 
-                cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 0,
-                    {
-                        renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ viewportState, 0, sizeof(scene::ViewportState)}, m_parameters[itemMesh.pipelineID].cb_Viewport)
-                    });
-
-                struct ModelBuffer
+                if (m_bindless)
                 {
-                    math::Matrix4D modelMatrix;
-                    math::Matrix4D prevModelMatrix;
-                    math::Matrix4D normalMatrix;
-                    math::float4   tintColour;
-                    u64            objectID;
-                    u64           _pad = 0;
-                };
+                    bindBindlessPass(m_pipelines[itemMesh.pipelineID], m_parameters[itemMesh.pipelineID]);
+
+                    //The masked models follow the opaque ones in the buffer of the frame
+                    ASSERT(model < bindlessModels._capacity, "range out");
+                    writeModelBuffer(bindlessModels._models[model], itemMesh, material);
+
+                    BindlessMaterial indices;
+                    indices.modelBuffer = bindlessModels._index;
+                    indices.model = model;
+                    indices.albedo = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::BaseColor].as<renderer::Texture2D>(), defaultIndex);
+                    indices.normal = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>(), defaultIndex);
+                    indices.material = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Roughness].as<renderer::Texture2D>(), defaultIndex);
+                    indices.metalness = getBindlessIndex(material.getParameters()._textures[scene::MaterialParameters::Metalness].as<renderer::Texture2D>(), defaultIndex);
+                    indices.height = indices.albedo;
+                    indices.mask = getBindlessIndex(noiseTexture, defaultIndex);
+
+                    cmdList->bindPushConstant(renderer::ShaderType::Vertex, sizeof(BindlessMaterial), &indices);
+                    cmdList->bindPushConstant(renderer::ShaderType::Fragment, sizeof(BindlessMaterial), &indices);
+                }
+                else
+                {
+                    cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 0,
+                        {
+                            renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ viewportState, 0, sizeof(scene::ViewportState)}, m_parameters[itemMesh.pipelineID].cb_Viewport)
+                        });
 
-                ModelBuffer constantBuffer;
-                constantBuffer.modelMatrix = itemMesh.object->getTransform().getMatrix();
-                constantBuffer.prevModelMatrix = itemMesh.object->getPrevTransform().getMatrix();
-                constantBuffer.normalMatrix = constantBuffer.modelMatrix.getInversed();
-                constantBuffer.normalMatrix.makeTransposed();
-                constantBuffer.tintColour = material.getProperty<math::float4>("DiffuseColor");
-                constantBuffer.objectID = itemMesh.object->ID();
+                    ModelBuffer constantBuffer;
+                    writeModelBuffer(constantBuffer, itemMesh, material);
 
-                cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
-                    {
-                        renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &constantBuffer, 0, sizeof(constantBuffer)}, m_parameters[itemMesh.pipelineID].cb_Model),
-                        renderer::Descriptor(sampler, m_parameters[itemMesh.pipelineID].s_SamplerState),
-                        renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("BaseColor").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureAlbedo),
-                        renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Normals").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureNormal),
-                        renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Roughness").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureRoughness),
-                        renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("Metalness").as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureMetalness),
-                        renderer::Descriptor(renderer::TextureView(noiseTexture, 0, 0), 6),
-                    });
+                    cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
+                        {
+                            renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &constantBuffer, 0, sizeof(constantBuffer)}, m_parameters[itemMesh.pipelineID].cb_Model),
+                            renderer::Descriptor(sampler, m_parameters[itemMesh.pipelineID].s_SamplerState),
+                            renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::BaseColor].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureAlbedo),
+                            renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureNormal),
+                            renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Roughness].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureRoughness),
+                            renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::Metalness].as<renderer::Texture2D>()), m_parameters[itemMesh.pipelineID].t_TextureMetalness),
+                            renderer::Descriptor(renderer::TextureView(noiseTexture, 0, 0), 6),
+                        });
+                }
 
                 DEBUG_MARKER_SCOPE(cmdList, std::format("Object [{}], pipeline [{}]", itemMesh.object->m_name, m_pipelines[itemMesh.pipelineID]->getName()), color::rgbaf::LTGREY);
                 ASSERT(mesh.getVertexAttribDesc()._inputBindings[0]._stride == sizeof(VertexFormatStandard), "must be same");
@@ -405,96 +402,142 @@ void RenderPipelineGBufferStage::execute(renderer::Device* device, scene::SceneD
             cmdList->endRenderTarget();
         };
 
-    addRenderJob("GBuffer Job", renderJob, device, scene);
+    addParallelRenderJob("GBuffer Job", opaqueCount + maskedCount, k_opaqueJobGrain, renderJob, device, scene);
 }
 
 void RenderPipelineGBufferStage::createRenderTarget(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
-    ASSERT(m_GBufferRenderTarget == nullptr, "must be nullptr");
-    m_GBufferRenderTarget = V3D_NEW(renderer::RenderTargetState, memory::MemoryLabel::MemoryGame)(device, scene.m_viewportSize, 4, 0);
+    ASSERT(m_GBufferRenderTargets[toEnumType(RenderTargetPart::Whole)] == nullptr, "must be nullptr");
 
     renderer::Texture2D* albedoAttachment = V3D_NEW(renderer::Texture2D, memory::MemoryLabel::MemoryGame)(device, renderer::TextureUsage::TextureUsage_Attachment | renderer::TextureUsage::TextureUsage_Sampled,
         renderer::Format::Format_R8G8B8A8_UNorm, scene.m_viewportSize, renderer::TextureSamples::TextureSamples_x1, "gbuffer_albedo");
-    m_GBufferRenderTarget->setColorTexture(0, albedoAttachment,
-        {
-            renderer::RenderTargetLoadOp::LoadOp_Clear, renderer::RenderTargetStoreOp::StoreOp_Store, color::Color(0.0f, 0.0f, 0.0f, 1.0f)
-        },
-        {
-            renderer::TransitionOp::TransitionOp_ColorAttachment, renderer::TransitionOp::TransitionOp_ShaderRead
-        }
-    );
-
     renderer::Texture2D* normalsAttachment = V3D_NEW(renderer::Texture2D, memory::MemoryLabel::MemoryGame)(device, renderer::TextureUsage::TextureUsage_Attachment | renderer::TextureUsage::TextureUsage_Sampled,
         renderer::Format::Format_R16G16B16A16_SFloat, scene.m_viewportSize, renderer::TextureSamples::TextureSamples_x1, "gbuffer_normals");
-    m_GBufferRenderTarget->setColorTexture(1, normalsAttachment,
-        {
-            renderer::RenderTargetLoadOp::LoadOp_Clear, renderer::RenderTargetStoreOp::StoreOp_Store, color::Color(0.0f, 0.0f, 0.0f, 1.0f)
-        },
-        {
-            renderer::TransitionOp::TransitionOp_ColorAttachment, renderer::TransitionOp::TransitionOp_ShaderRead
-        }
-    );
-
     renderer::Texture2D* materialAttachment = V3D_NEW(renderer::Texture2D, memory::MemoryLabel::MemoryGame)(device, renderer::TextureUsage::TextureUsage_Attachment | renderer::TextureUsage::TextureUsage_Sampled,
         renderer::Format::Format_R16G16B16A16_SFloat, scene.m_viewportSize, renderer::TextureSamples::TextureSamples_x1, "gbuffer_material");
-    m_GBufferRenderTarget->setColorTexture(2, materialAttachment,
-        {
-            renderer::RenderTargetLoadOp::LoadOp_Clear, renderer::RenderTargetStoreOp::StoreOp_Store, color::Color(0.0f, 0.0f, 0.0f, 1.0f)
-        },
-        {
-            renderer::TransitionOp::TransitionOp_ColorAttachment, renderer::TransitionOp::TransitionOp_ShaderRead
-        }
-    );
-
     renderer::Texture2D* velocityAttachment = V3D_NEW(renderer::Texture2D, memory::MemoryLabel::MemoryGame)(device, renderer::TextureUsage::TextureUsage_Attachment | renderer::TextureUsage::TextureUsage_Sampled,
         renderer::Format::Format_R16G16_SFloat, scene.m_viewportSize, renderer::TextureSamples::TextureSamples_x1, "gbuffer_velocity");
-    m_GBufferRenderTarget->setColorTexture(3, velocityAttachment,
-        {
-            renderer::RenderTargetLoadOp::LoadOp_Clear, renderer::RenderTargetStoreOp::StoreOp_Store, color::Color(0.0f, 0.0f, 0.0f, 1.0f)
-        },
+
+    ObjectHandle depthStencil_handle = scene.m_globalResources.get("depth_stencil");
+    ASSERT(depthStencil_handle.isValid(), "must be valid");
+    renderer::Texture2D* depthAttachment = depthStencil_handle.as<renderer::Texture2D>();
+
+    renderer::Texture2D* colorAttachments[] = { albedoAttachment, normalsAttachment, materialAttachment, velocityAttachment };
+
+    //The same attachments for every part. Only the first part clears them and only the last one transitions them to read
+    for (u32 part = 0; part < toEnumType(RenderTargetPart::Count); ++part)
+    {
+        const bool first = part == toEnumType(RenderTargetPart::Whole) || part == toEnumType(RenderTargetPart::First);
+        const bool last = part == toEnumType(RenderTargetPart::Whole) || part == toEnumType(RenderTargetPart::Last);
+
+        renderer::RenderTargetState* renderTarget = V3D_NEW(renderer::RenderTargetState, memory::MemoryLabel::MemoryGame)(device, scene.m_viewportSize, 4, 0);
+        for (u32 index = 0; index < std::size(colorAttachments); ++index)
         {
-            renderer::TransitionOp::TransitionOp_ColorAttachment, renderer::TransitionOp::TransitionOp_ShaderRead
+            renderTarget->setColorTexture(index, colorAttachments[index],
+                {
+                    first ? renderer::RenderTargetLoadOp::LoadOp_Clear : renderer::RenderTargetLoadOp::LoadOp_Load, renderer::RenderTargetStoreOp::StoreOp_Store, color::Color(0.0f, 0.0f, 0.0f, 1.0f)
+                },
+                {
+                    renderer::TransitionOp::TransitionOp_ColorAttachment, last ? renderer::TransitionOp::TransitionOp_ShaderRead : renderer::TransitionOp::TransitionOp_ColorAttachment
+                }
+            );
         }
-    );
+
+        renderTarget->setDepthStencilTexture(depthAttachment,
+            {
+                renderer::RenderTargetLoadOp::LoadOp_Load, renderer::RenderTargetStoreOp::StoreOp_Store, 0.0f
+            },
+            {
+                renderer::RenderTargetLoadOp::LoadOp_Load, renderer::RenderTargetStoreOp::StoreOp_Store, 0U
+            },
+            {
+                renderer::TransitionOp::TransitionOp_DepthStencilAttachment, renderer::TransitionOp::TransitionOp_DepthStencilAttachment
+            }
+        );
+
+        m_GBufferRenderTargets[part] = renderTarget;
+    }
 
     scene.m_globalResources.bind("gbuffer_albedo", albedoAttachment);
     scene.m_globalResources.bind("gbuffer_normals", normalsAttachment);
     scene.m_globalResources.bind("gbuffer_material", materialAttachment);
     scene.m_globalResources.bind("gbuffer_velocity", velocityAttachment);
-
-    ObjectHandle depthStencil_handle = scene.m_globalResources.get("depth_stencil");
-    ASSERT(depthStencil_handle.isValid(), "must be valid");
-    renderer::Texture2D* depthAttachment = depthStencil_handle.as<renderer::Texture2D>();
-    m_GBufferRenderTarget->setDepthStencilTexture(depthAttachment,
-        {
-            renderer::RenderTargetLoadOp::LoadOp_Load, renderer::RenderTargetStoreOp::StoreOp_Store, 0.0f
-        },
-        {
-            renderer::RenderTargetLoadOp::LoadOp_Load, renderer::RenderTargetStoreOp::StoreOp_Store, 0U
-        },
-        {
-            renderer::TransitionOp::TransitionOp_DepthStencilAttachment, renderer::TransitionOp::TransitionOp_DepthStencilAttachment
-        }
-    );
 }
 
 void RenderPipelineGBufferStage::destroyRenderTarget(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
-    ASSERT(m_GBufferRenderTarget, "must be valid");
-    renderer::Texture2D* albedoAttachment = m_GBufferRenderTarget->getColorTexture<renderer::Texture2D>(0);
+    renderer::RenderTargetState* renderTarget = m_GBufferRenderTargets[toEnumType(RenderTargetPart::Whole)];
+    ASSERT(renderTarget, "must be valid");
+    renderer::Texture2D* albedoAttachment = renderTarget->getColorTexture<renderer::Texture2D>(0);
     V3D_DELETE(albedoAttachment, memory::MemoryLabel::MemoryGame);
 
-    renderer::Texture2D* normalsAttachment = m_GBufferRenderTarget->getColorTexture<renderer::Texture2D>(1);
+    renderer::Texture2D* normalsAttachment = renderTarget->getColorTexture<renderer::Texture2D>(1);
     V3D_DELETE(normalsAttachment, memory::MemoryLabel::MemoryGame);
 
-    renderer::Texture2D* materialAttachment = m_GBufferRenderTarget->getColorTexture<renderer::Texture2D>(2);
+    renderer::Texture2D* materialAttachment = renderTarget->getColorTexture<renderer::Texture2D>(2);
     V3D_DELETE(materialAttachment, memory::MemoryLabel::MemoryGame);
 
-    renderer::Texture2D* velocityAttachment = m_GBufferRenderTarget->getColorTexture<renderer::Texture2D>(3);
+    renderer::Texture2D* velocityAttachment = renderTarget->getColorTexture<renderer::Texture2D>(3);
     V3D_DELETE(velocityAttachment, memory::MemoryLabel::MemoryGame);
 
-    V3D_DELETE(m_GBufferRenderTarget, memory::MemoryLabel::MemoryGame);
-    m_GBufferRenderTarget = nullptr;
+    for (auto& target : m_GBufferRenderTargets)
+    {
+        V3D_DELETE(target, memory::MemoryLabel::MemoryGame);
+        target = nullptr;
+    }
+}
+
+void RenderPipelineGBufferStage::prepareBindlessModels(renderer::Device* device, BindlessModels& models, u32 count)
+{
+    if (count <= models._capacity)
+    {
+        return;
+    }
+
+    //The old buffer is released by the device after the frames which read it
+    const u32 capacity = std::max<u32>(count, models._capacity * 2);
+    destroyBindlessModels(device, models);
+
+    models._buffer = V3D_NEW(renderer::UnorderedAccessBuffer, memory::MemoryLabel::MemoryGame)(device, renderer::BufferUsage::Buffer_GPUWriteCocherent, capacity * sizeof(ModelBuffer), "gbuffer_models");
+    models._models = models._buffer->map<ModelBuffer>();
+    models._capacity = capacity;
+    models._index = device->registerBindlessBuffer(models._buffer);
+    ASSERT(models._index != renderer::k_invalidBindlessIndex, "the descriptor heap is full");
+}
+
+void RenderPipelineGBufferStage::destroyBindlessModels(renderer::Device* device, BindlessModels& models)
+{
+    if (models._buffer)
+    {
+        if (models._index != renderer::k_invalidBindlessIndex)
+        {
+            device->unregisterBindlessBuffer(models._index);
+        }
+        models._buffer->unmap();
+        V3D_DELETE(models._buffer, memory::MemoryLabel::MemoryGame);
+    }
+    models = BindlessModels();
+}
+
+void RenderPipelineGBufferStage::writeModelBuffer(ModelBuffer& model, const scene::DrawNodeEntry& itemMesh, const scene::Material& material)
+{
+    model.modelMatrix = itemMesh.object->getTransform().getMatrix();
+    model.prevModelMatrix = itemMesh.object->getPrevTransform().getMatrix();
+    model.normalMatrix = model.modelMatrix.getInversed();
+    model.normalMatrix.makeTransposed();
+    model.tintColour = material.getParameters()._colors[scene::MaterialParameters::DiffuseColor];
+    model.objectID = itemMesh.object->ID();
+    model._pad = 0;
+}
+
+u32 RenderPipelineGBufferStage::getBindlessIndex(const renderer::Texture* texture, u32 defaultIndex)
+{
+    if (!texture || texture->getBindlessIndex() == renderer::k_invalidBindlessIndex)
+    {
+        return defaultIndex;
+    }
+
+    return texture->getBindlessIndex();
 }
 
 } //namespace scene
@@ -11,12 +11,20 @@ namespace renderer
     class CmdListRender;
     class RenderTargetState;
     class GraphicsPipelineState;
+    class Texture;
+    class UnorderedAccessBuffer;
 } // namespace renderer
+namespace resource
+{
+    struct ShaderPermutation;
+} // namespace resource
 namespace scene
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     class ModelHandler;
+    class Material;
+    struct DrawNodeEntry;
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -33,6 +41,8 @@ namespace scene
         void prepare(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
         void execute(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
 
+        static std::vector<resource::ShaderPermutation> getShaderPermutations(const scene::SceneData& scene, bool bindless = false);
+
     private:
 
         struct MaterialParameters
@@ -48,14 +58,69 @@ namespace scene
             SHADER_PARAMETER(t_TextureHeight);
         };
 
+        /**
+        * @brief ModelBuffer struct. Per draw data, ModelBuffer of global.hlsli
+        */
+        struct ModelBuffer
+        {
+            math::Matrix4D modelMatrix;
+            math::Matrix4D prevModelMatrix;
+            math::Matrix4D normalMatrix;
+            math::float4   tintColour;
+            u64            objectID;
+            u64           _pad = 0;
+        };
+
+        /**
+        * @brief BindlessMaterial struct. Push constant of the BINDLESS shaders, indices in the descriptor heap and the model of the draw
+        */
+        struct BindlessMaterial
+        {
+            u32 modelBuffer;
+            u32 model;
+            u32 albedo;
+            u32 normal;
+            u32 material;
+            u32 metalness;
+            u32 height;
+            u32 mask;
+        };
+
+        /**
+        * @brief BindlessModels struct. Storage buffer of the frame in the descriptor heap, the draws write their models to it
+        */
+        struct BindlessModels
+        {
+            renderer::UnorderedAccessBuffer* _buffer = nullptr;
+            ModelBuffer*                     _models = nullptr;
+            u32                              _capacity = 0;
+            u32                              _index = renderer::k_invalidBindlessIndex;
+        };
+
+        static constexpr u32 k_opaqueJobGrain = 256;
+
+        /**
+        * @brief createPipeline. Adds the pipeline of the permutation to m_pipelines, the masked pipelines write the depth
+        */
+        void createPipeline(renderer::Device* device, bool separateMaterials, bool masked);
         void createRenderTarget(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame);
         void destroyRenderTarget(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame);
 
+        void prepareBindlessModels(renderer::Device* device, BindlessModels& models, u32 count);
+        void destroyBindlessModels(renderer::Device* device, BindlessModels& models);
+        static void writeModelBuffer(ModelBuffer& model, const scene::DrawNodeEntry& itemMesh, const scene::Material& material);
+        static u32 getBindlessIndex(const renderer::Texture* texture, u32 defaultIndex);
+
         scene::ModelHandler* const                         m_modelHandler;
 
-        renderer::RenderTargetState*                       m_GBufferRenderTarget;
+        std::array<renderer::RenderTargetState*, toEnumType(RenderTargetPart::Count)> m_GBufferRenderTargets; //Attachments are owned by the Whole target
         std::vector<v3d::renderer::GraphicsPipelineState*> m_pipelines;
         std::vector<MaterialParameters>                    m_parameters;
+
+        //The textures are registered by themselves, the draws pass only the indices
+        bool                                               m_bindless;
+        std::vector<BindlessModels>                        m_bindlessModels; //One per frame in flight and the recorded frame
+        u32                                                m_bindlessFrame;
     };
 
 
@@ -34,6 +34,22 @@ RenderPipelineLightAccumulationStage::~RenderPipelineLightAccumulationStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineLightAccumulationStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    const renderer::Shader::DefineList defines =
+    {
+        { "DEBUG_PUNCTUAL_SHADOWMAPS", std::to_string(scene.m_settings._shadowsParams._debugPunctualLightShadows) },
+    };
+
+    //Same variants as create loads
+    return
+    {
+        { "light.hlsl", "main_vs", renderer::ShaderType::Vertex },
+        { "light.hlsl", "light_stencil_ps", renderer::ShaderType::Fragment },
+        { "light.hlsl", "light_accumulation_ps", renderer::ShaderType::Fragment, defines },
+    };
+}
+
 void RenderPipelineLightAccumulationStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     if (m_created)
@@ -352,6 +368,8 @@ void RenderPipelineLightAccumulationStage::createPipelines(renderer::Device* dev
 #else
         m_pipeline[0]->setDepthCompareOp(renderer::CompareOperation::LessOrEqual);
 #endif
+
+        device->compilePipeline(*m_pipeline[0]);
     }
 
     //Light pass
@@ -392,6 +410,8 @@ void RenderPipelineLightAccumulationStage::createPipelines(renderer::Device* dev
         m_pipeline[1]->setColorBlendFactor(0, renderer::BlendFactor::BlendFactor_One, renderer::BlendFactor::BlendFactor_One);
         m_pipeline[1]->setColorBlendOp(0, renderer::BlendOperation::BlendOp_Add);
 
+        device->compilePipeline(*m_pipeline[1]);
+
         BIND_SHADER_PARAMETER(m_pipeline[1], m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(m_pipeline[1], m_parameters, cb_Model);
         BIND_SHADER_PARAMETER(m_pipeline[1], m_parameters, cb_Light);
@@ -15,6 +15,10 @@ namespace renderer
     class RenderTargetState;
     class GraphicsPipelineState;
 } // namespace renderer
+namespace resource
+{
+    struct ShaderPermutation;
+} // namespace resource
 namespace scene
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -36,6 +40,8 @@ namespace scene
         void prepare(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
         void execute(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
 
+        static std::vector<resource::ShaderPermutation> getShaderPermutations(const scene::SceneData& scene);
+
         void onChanged(renderer::Device* device, scene::SceneData& scene, const event::GameEvent* event) override;
 
     private:
@@ -29,6 +29,19 @@ RenderPipelineMBOITStage::~RenderPipelineMBOITStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineMBOITStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "gbuffer.hlsl", "gbuffer_standard_vs", renderer::ShaderType::Vertex },
+        { "transparency_mboit.hlsl", "mboit_pass1_ps", renderer::ShaderType::Fragment },
+        { "transparency_mboit.hlsl", "mboit_pass2_ps", renderer::ShaderType::Fragment },
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex },
+        { "transparency_mboit.hlsl", "mboit_resolve_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineMBOITStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     createRenderTarget(device, scene, frame);
@@ -68,6 +81,8 @@ void RenderPipelineMBOITStage::create(renderer::Device* device, scene::SceneData
          //pipeline->setAlphaBlendFactor(1, renderer::BlendFactor::BlendFactor_One, renderer::BlendFactor::BlendFactor_One);
          //pipeline->setAlphaBlendOp(1, renderer::BlendOperation::BlendOp_Add);
 
+        device->compilePipeline(*pipeline);
+
         m_pipeline[Pass::MBOIT_Pass1] = pipeline;
     }
 
@@ -99,6 +114,8 @@ void RenderPipelineMBOITStage::create(renderer::Device* device, scene::SceneData
         pipeline->setAlphaBlendFactor(0, renderer::BlendFactor::BlendFactor_One, renderer::BlendFactor::BlendFactor_One);
         pipeline->setAlphaBlendOp(0, renderer::BlendOperation::BlendOp_Add);
 
+        device->compilePipeline(*pipeline);
+
         m_pipeline[Pass::MBOIT_Pass2] = pipeline;
     }
 
@@ -124,6 +141,8 @@ void RenderPipelineMBOITStage::create(renderer::Device* device, scene::SceneData
         pipeline->setBlendEnable(0, false);
         pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*pipeline);
+
         m_pipeline[Pass::CompositionPass] = pipeline;
     }
 }
@@ -204,11 +223,11 @@ void RenderPipelineMBOITStage::execute(renderer::Device* device, scene::SceneDat
                     } materialState;
 
                     materialState.sampler = sampler;
-                    materialState.baseColor = material.getProperty<ObjectHandle>("BaseColor").as<renderer::Texture2D>();
-                    materialState.normals = material.getProperty<ObjectHandle>("Normals").as<renderer::Texture2D>();
-                    materialState.roughness = material.getProperty<ObjectHandle>("Roughness").as<renderer::Texture2D>();
-                    materialState.metalness = material.getProperty<ObjectHandle>("Metalness").as<renderer::Texture2D>();
-                    materialState.tint = material.getProperty<math::float4>("Color");
+                    materialState.baseColor = material.getParameters()._textures[scene::MaterialParameters::BaseColor].as<renderer::Texture2D>();
+                    materialState.normals = material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>();
+                    materialState.roughness = material.getParameters()._textures[scene::MaterialParameters::Roughness].as<renderer::Texture2D>();
+                    materialState.metalness = material.getParameters()._textures[scene::MaterialParameters::Metalness].as<renderer::Texture2D>();
+                    materialState.tint = material.getParameters()._colors[scene::MaterialParameters::Tint];
 
                     struct ModelBuffer
                     {
@@ -276,11 +295,11 @@ void RenderPipelineMBOITStage::execute(renderer::Device* device, scene::SceneDat
                     } materialState;
 
                     materialState.sampler = sampler;
-                    materialState.baseColor = material.getProperty<ObjectHandle>("BaseColor").as<renderer::Texture2D>();
-                    materialState.normals = material.getProperty<ObjectHandle>("Normals").as<renderer::Texture2D>();
-                    materialState.roughness = material.getProperty<ObjectHandle>("Roughness").as<renderer::Texture2D>();
-                    materialState.metalness = material.getProperty<ObjectHandle>("Metalness").as<renderer::Texture2D>();
-                    materialState.tint = material.getProperty<math::float4>("Color");
+                    materialState.baseColor = material.getParameters()._textures[scene::MaterialParameters::BaseColor].as<renderer::Texture2D>();
+                    materialState.normals = material.getParameters()._textures[scene::MaterialParameters::Normals].as<renderer::Texture2D>();
+                    materialState.roughness = material.getParameters()._textures[scene::MaterialParameters::Roughness].as<renderer::Texture2D>();
+                    materialState.metalness = material.getParameters()._textures[scene::MaterialParameters::Metalness].as<renderer::Texture2D>();
+                    materialState.tint = material.getParameters()._colors[scene::MaterialParameters::Tint];
 
                     struct ModelBuffer
                     {
@@ -11,6 +11,10 @@ namespace renderer
     class RenderTargetState;
     class GraphicsPipelineState;
 } // namespace renderer
+namespace resource
+{
+    struct ShaderPermutation;
+} // namespace resource
 namespace scene
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +32,8 @@ namespace scene
         void prepare(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
         void execute(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
 
+        static std::vector<resource::ShaderPermutation> getShaderPermutations(const scene::SceneData& scene);
+
     private:
 
         void createRenderTarget(renderer::Device* device, scene::SceneData& data, scene::FrameData& frame);
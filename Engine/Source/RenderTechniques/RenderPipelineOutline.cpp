@@ -32,6 +32,16 @@ RenderPipelineOutlineStage::~RenderPipelineOutlineStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineOutlineStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex },
+        { "outline.hlsl", "main_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineOutlineStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     createRenderTarget(device, scene, frame);
@@ -52,6 +62,8 @@ void RenderPipelineOutlineStage::create(renderer::Device* device, scene::SceneDa
     m_pipeline->setDepthTest(false);
     m_pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+    device->compilePipeline(*m_pipeline);
+
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Viewport);
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Outline);
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, s_SamplerState);
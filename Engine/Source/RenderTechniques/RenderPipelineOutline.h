@@ -12,6 +12,10 @@ namespace renderer
     class GraphicsPipelineState;
     class UnorderedAccessBuffer;
 } // namespace renderer
+namespace resource
+{
+    struct ShaderPermutation;
+} // namespace resource
 namespace scene
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -34,6 +38,8 @@ namespace scene
         void prepare(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
         void execute(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
 
+        static std::vector<resource::ShaderPermutation> getShaderPermutations(const scene::SceneData& scene);
+
     private:
 
         struct MaterialParameters
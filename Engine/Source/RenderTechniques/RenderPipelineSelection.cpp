@@ -34,6 +34,19 @@ RenderPipelineSelectionStage::~RenderPipelineSelectionStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineSelectionStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "gbuffer.hlsl", "gbuffer_standard_vs", renderer::ShaderType::Vertex },
+        { "gbuffer.hlsl", "gbuffer_selection_ps", renderer::ShaderType::Fragment },
+        { "simple.hlsl", "simple_vs", renderer::ShaderType::Vertex },
+        { "simple.hlsl", "billboard_vs", renderer::ShaderType::Vertex },
+        { "simple.hlsl", "simple_selection_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineSelectionStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     if (m_created)
@@ -65,6 +78,8 @@ void RenderPipelineSelectionStage::create(renderer::Device* device, scene::Scene
         pipeline->setDepthTest(false);
         pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*pipeline);
+
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Model);
 
@@ -93,6 +108,8 @@ void RenderPipelineSelectionStage::create(renderer::Device* device, scene::Scene
         pipeline->setDepthTest(false);
         pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*pipeline);
+
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Model);
 
@@ -122,6 +139,8 @@ void RenderPipelineSelectionStage::create(renderer::Device* device, scene::Scene
         pipeline->setDepthTest(false);
         pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*pipeline);
+
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Model);
 
@@ -231,7 +250,7 @@ void RenderPipelineSelectionStage::execute(renderer::Device* device, scene::Scen
                 constantBuffer.modelMatrix = itemMesh.object->getTransform().getMatrix();
                 constantBuffer.prevModelMatrix = itemMesh.object->getPrevTransform().getMatrix();
                 constantBuffer.normalMatrix = constantBuffer.modelMatrix.getTransposed();
-                constantBuffer.tintColour = material.getProperty<math::float4>("ColorDiffuse");
+                constantBuffer.tintColour = material.getParameters()._colors[scene::MaterialParameters::ColorDiffuse];
                 constantBuffer.objectID = itemMesh.object->ID();
 
                 cmdList->bindDescriptorSet(m_pipelines[pipelineID]->getShaderProgram(), 1,
@@ -49,13 +49,13 @@ RenderPipelineShadowStage::RenderPipelineShadowStage(RenderTechnique* technique,
     , m_shadowSamplerState(nullptr)
 
     , m_cascadeTextureArray(nullptr)
-    , m_cascadeRenderTarget(nullptr)
 
     , m_punctualShadowTextureArray(nullptr)
-    , m_punctualShadowRenderTarget(nullptr)
 
     , m_SSShadowsRenderTarget(nullptr)
 {
+    m_cascadeRenderTargets.fill(nullptr);
+    m_punctualShadowRenderTargets.fill(nullptr);
 }
 
 RenderPipelineShadowStage::~RenderPipelineShadowStage()
@@ -100,11 +100,11 @@ void RenderPipelineShadowStage::prepare(renderer::Device* device, SceneData& sce
 {
     ASSERT(m_created, "must be created");
 
-    if (!m_cascadeRenderTarget || !m_punctualShadowRenderTarget || !m_SSShadowsRenderTarget )
+    if (!m_cascadeRenderTargets[toEnumType(RenderTargetPart::Whole)] || !m_punctualShadowRenderTargets[0] || !m_SSShadowsRenderTarget)
     {
         createRenderTarget(device, scene);
     }
-    else if (m_cascadeRenderTarget->getRenderArea() != scene.m_settings._shadowsParams._size || m_SSShadowsRenderTarget->getRenderArea() != scene.m_viewportSize)
+    else if (m_cascadeRenderTargets[toEnumType(RenderTargetPart::Whole)]->getRenderArea() != scene.m_settings._shadowsParams._size || m_SSShadowsRenderTarget->getRenderArea() != scene.m_viewportSize)
     {
         destroyRenderTarget(device, scene);
         createRenderTarget(device, scene);
@@ -133,59 +133,33 @@ void RenderPipelineShadowStage::execute(renderer::Device* device, SceneData& sce
     if (!scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)].empty())
     {
         //Support only 1 direction light at this moment
+        ASSERT(scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)].size() == 1, "supported only one light at the moment");
         scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)][0]);
         const scene::DirectionalLight& dirLight = *static_cast<const scene::DirectionalLight*>(itemLight.light);
 
         ASSERT(scene.m_settings._shadowsParams._cascadeCount <= k_maxShadowmapCascadeCount, "size is out range");
         calculateShadowCascades(scene, itemLight.object->getDirection(), scene.m_settings._shadowsParams._cascadeCount, pipelineData->_directionLightSpaceMatrix.data(), pipelineData->_directionLightCascadeSplits.data());
-    }
-
-    for (u32 i = 0; i < std::min<u32>(scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)].size(), k_maxPunctualShadowmapCount); ++i)
-    {
-        //Now draw one light
-        scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)][i]);
-        const scene::Light& light = *static_cast<const scene::Light*>(itemLight.light);
-
-        std::array<math::Matrix4D, 6> pointLightSpaceMatrix;
-        math::Vector3D lightPosition = itemLight.object->getTransform().getPosition();
-        f32 lightRadius = light.getAttenuation()._w;
-        f32 distanceToCamera = (lightPosition - scene.m_camera->getPosition()).length();
-        f32 nearPlane = 0.1f;
-        f32 farPlane = std::max(lightRadius, nearPlane + 0.1f);
-        u32 viewsMask = 0b00111111; //TODO get from the light
-        calculateShadowViews(lightPosition, nearPlane, farPlane, viewsMask, pointLightSpaceMatrix);
-        pipelineData->_punctualLightsData[i] = { pointLightSpaceMatrix, lightPosition, math::float2{ nearPlane, farPlane }, viewsMask };
-        pipelineData->_punctualLightsFlags[i] = light.isCastShadows();
-    }
 
-    auto renderJob = [this](renderer::Device* device, renderer::CmdListRender* cmdList, const SceneData& scene, const scene::FrameData& frame) -> void
+        if (dirLight.isCastShadows())
         {
-            ObjectHandle viewportState_handle = frame.m_frameResources.get("viewport_state");
-            ASSERT(viewportState_handle.isValid(), "must be valid");
-            scene::ViewportState* viewportState = viewportState_handle.as<scene::ViewportState>();
-
-            ObjectHandle pipelineData_handle = frame.m_frameResources.get("shadow_data");
-            const RenderPipelineShadowStage::PipelineData* pipelineData = pipelineData_handle.as<scene::RenderPipelineShadowStage::PipelineData>();
-
-            ASSERT(scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)].size() == 1, "supported only one light at the moment");
-            if (!scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)].empty())
-            {
-                TRACE_PROFILER_SCOPE("CascadeShadowmaps", color::rgba8::GREEN);
-                DEBUG_MARKER_SCOPE(cmdList, "CascadeShadowmaps", color::rgbaf::GREEN);
+            //Shadow casters are split between the parts, only the first part clears the cascades
+            auto cascadeJob = [this](renderer::Device* device, renderer::CmdListRender* cmdList, const SceneData& scene, const scene::FrameData& frame, const RenderJobRange& range) -> void
+                {
+                    TRACE_PROFILER_SCOPE("CascadeShadowmaps", color::rgba8::GREEN);
+                    DEBUG_MARKER_SCOPE(cmdList, "CascadeShadowmaps", color::rgbaf::GREEN);
 
-                scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)][0]);
-                const scene::DirectionalLight& dirLight = *static_cast<const scene::DirectionalLight*>(itemLight.light);
+                    ObjectHandle pipelineData_handle = frame.m_frameResources.get("shadow_data");
+                    const RenderPipelineShadowStage::PipelineData* pipelineData = pipelineData_handle.as<scene::RenderPipelineShadowStage::PipelineData>();
 
-                if (dirLight.isCastShadows())
-                {
-                    cmdList->beginRenderTarget(*m_cascadeRenderTarget);
+                    cmdList->beginRenderTarget(*m_cascadeRenderTargets[toEnumType(range.getPart())]);
                     cmdList->setViewport({ 0.f, 0.f, (f32)pipelineData->_shadowSize._width, (f32)pipelineData->_shadowSize._height });
                     cmdList->setScissor({ 0.f, 0.f, (f32)pipelineData->_shadowSize._width, (f32)pipelineData->_shadowSize._height });
                     cmdList->setPipelineState(*m_cascadeShadowPipeline);
 
-                    for (auto& entry : scene.m_renderLists[toEnumType(scene::ScenePass::Shadowmap)])
+                    const std::vector<NodeEntry*>& shadowList = scene.m_renderLists[toEnumType(scene::ScenePass::Shadowmap)];
+                    for (u32 index = range._begin; index < range._end; ++index)
                     {
-                        const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(entry);
+                        const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(shadowList[index]);
 
                         struct ShadowBuffer
                         {
@@ -214,154 +188,176 @@ void RenderPipelineShadowStage::execute(renderer::Device* device, SceneData& sce
                     }
 
                     cmdList->endRenderTarget();
-                }
-                else
+                };
+
+            addParallelRenderJob("Cascade Shadowmap Job", static_cast<u32>(scene.m_renderLists[toEnumType(scene::ScenePass::Shadowmap)].size()), k_shadowJobGrain, cascadeJob, device, scene);
+        }
+        else
+        {
+            auto clearJob = [this](renderer::Device* device, renderer::CmdListRender* cmdList, const SceneData& scene, const scene::FrameData& frame) -> void
                 {
                     cmdList->clear(m_cascadeTextureArray, 0.f, 0u);
-                }
-            }
+                };
 
-            if (!scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)].empty())
+            addRenderJob("Cascade Shadowmap Job", clearJob, device, scene);
+        }
+    }
+
+    for (u32 i = 0; i < std::min<u32>(scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)].size(), k_maxPunctualShadowmapCount); ++i)
+    {
+        //Now draw one light
+        scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)][i]);
+        const scene::Light& light = *static_cast<const scene::Light*>(itemLight.light);
+
+        std::array<math::Matrix4D, 6> pointLightSpaceMatrix;
+        math::Vector3D lightPosition = itemLight.object->getTransform().getPosition();
+        f32 lightRadius = light.getAttenuation()._w;
+        f32 distanceToCamera = (lightPosition - scene.m_camera->getPosition()).length();
+        f32 nearPlane = 0.1f;
+        f32 farPlane = std::max(lightRadius, nearPlane + 0.1f);
+        u32 viewsMask = 0b00111111; //TODO get from the light
+        calculateShadowViews(lightPosition, nearPlane, farPlane, viewsMask, pointLightSpaceMatrix);
+        pipelineData->_punctualLightsData[i] = { pointLightSpaceMatrix, lightPosition, math::float2{ nearPlane, farPlane }, viewsMask };
+        pipelineData->_punctualLightsFlags[i] = light.isCastShadows();
+
+        if (!pipelineData->_punctualLightsFlags[i])
+        {
+            continue;
+        }
+
+        //Every light has own render target, so the lights are recorded concurrently
+        m_punctualShadowRenderTargets[i]->setViewsMask(viewsMask);
+
+        auto punctualJob = [this, i](renderer::Device* device, renderer::CmdListRender* cmdList, const SceneData& scene, const scene::FrameData& frame) -> void
             {
-                TRACE_PROFILER_SCOPE("PunctualShadowmaps", color::rgba8::GREEN);
-                DEBUG_MARKER_SCOPE(cmdList, "PunctualShadowmaps", color::rgbaf::GREEN);
+                scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)][i]);
 
-                for (u32 i = 0; i < std::min<u32>(scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)].size(), k_maxPunctualShadowmapCount); ++i)
-                {
-                    scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::PunctualLights)][i]);
-                    const scene::Light& light = *static_cast<const scene::Light*>(itemLight.light);
-                    auto& [pointLightSpaceMatrix, lightPosition, plane, viewsMask] = pipelineData->_punctualLightsData[i];
-                    if (!pipelineData->_punctualLightsFlags[i])
-                    {
-                        return;
-                    }
+                TRACE_PROFILER_SCOPE(std::format("PunctualLight [{}]", itemLight.object->m_name), color::rgbaf::GREEN);
+                DEBUG_MARKER_SCOPE(cmdList, std::format("PunctualLight [{}]", itemLight.object->m_name), color::rgbaf::GREEN);
 
-                    TRACE_PROFILER_SCOPE(std::format("PunctualLight [{}]", itemLight.object->m_name), color::rgbaf::GREEN);
-                    DEBUG_MARKER_SCOPE(cmdList, std::format("PunctualLight [{}]", itemLight.object->m_name), color::rgbaf::GREEN);
+                ObjectHandle pipelineData_handle = frame.m_frameResources.get("shadow_data");
+                const RenderPipelineShadowStage::PipelineData* pipelineData = pipelineData_handle.as<scene::RenderPipelineShadowStage::PipelineData>();
 
-                    m_punctualShadowRenderTarget->setViewsMask(viewsMask);
-                    m_punctualShadowRenderTarget->setDepthStencilTexture(renderer::TextureView(m_punctualShadowTextureArray, i * 6, 6, 0, 1),
-                            {
-                                renderer::RenderTargetLoadOp::LoadOp_Clear, renderer::RenderTargetStoreOp::StoreOp_Store, 0.0f,
-                            },
-                            {
-                                 renderer::RenderTargetLoadOp::LoadOp_DontCare, renderer::RenderTargetStoreOp::StoreOp_DontCare, 0U,
-                            },
-                            {
-                                renderer::TransitionOp::TransitionOp_DepthStencilAttachment, renderer::TransitionOp::TransitionOp_DepthStencilReadOnly
-                            });
+                cmdList->beginRenderTarget(*m_punctualShadowRenderTargets[i]);
+                cmdList->setViewport({ 0.f, 0.f, (f32)scene.m_settings._shadowsParams._size._width, (f32)scene.m_settings._shadowsParams._size._height });
+                cmdList->setScissor({ 0.f, 0.f, (f32)scene.m_settings._shadowsParams._size._width, (f32)scene.m_settings._shadowsParams._size._height });
+                cmdList->setPipelineState(*m_punctualShadowPipeline);
 
-                    cmdList->beginRenderTarget(*m_punctualShadowRenderTarget);
-                    cmdList->setViewport({ 0.f, 0.f, (f32)scene.m_settings._shadowsParams._size._width, (f32)scene.m_settings._shadowsParams._size._height });
-                    cmdList->setScissor({ 0.f, 0.f, (f32)scene.m_settings._shadowsParams._size._width, (f32)scene.m_settings._shadowsParams._size._height });
-                    cmdList->setPipelineState(*m_punctualShadowPipeline);
+                for (auto& entry : scene.m_renderLists[toEnumType(scene::ScenePass::FirstPunctualShadowmap) + i])
+                {
+                    const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(entry);
 
-                    for (auto& entry : scene.m_renderLists[toEnumType(scene::ScenePass::FirstPunctualShadowmap) + i])
+                    struct ShadowBuffer
                     {
-                        const scene::DrawNodeEntry& itemMesh = *static_cast<scene::DrawNodeEntry*>(entry);
+                        math::Matrix4D lightSpaceMatrix[6];
+                        math::Matrix4D modelMatrix;
+                        f32            bias;
+                        f32           _pas[3];
+                    } shadowViewBuffer;
 
-                        struct ShadowBuffer
+                    memcpy(shadowViewBuffer.lightSpaceMatrix, std::get<0>(pipelineData->_punctualLightsData[i]).data(), sizeof(math::Matrix4D) * 6);
+                    shadowViewBuffer.modelMatrix = itemMesh.object->getTransform().getMatrix();
+                    shadowViewBuffer.bias = 0.f;
+
+                    cmdList->bindDescriptorSet(m_cascadeShadowPipeline->getShaderProgram(), 0,
                         {
-                            math::Matrix4D lightSpaceMatrix[6];
-                            math::Matrix4D modelMatrix;
-                            f32            bias;
-                            f32           _pas[3];
-                        } shadowViewBuffer;
+                            renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &shadowViewBuffer, 0, sizeof(shadowViewBuffer) }, m_punctualShadowParameters.cb_PunctualShadowBuffer)
+                        });
 
-                        memcpy(shadowViewBuffer.lightSpaceMatrix, pointLightSpaceMatrix.data(), sizeof(math::Matrix4D) * 6);
-                        shadowViewBuffer.modelMatrix = itemMesh.object->getTransform().getMatrix();
-                        shadowViewBuffer.bias = 0.f;
+                    DEBUG_MARKER_SCOPE(cmdList, std::format("Object [{}], pipeline [{}]", itemMesh.object->m_name, m_punctualShadowPipeline->getName()), color::rgbaf::LTGREY);
 
-                        cmdList->bindDescriptorSet(m_cascadeShadowPipeline->getShaderProgram(), 0,
-                            {
-                                renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &shadowViewBuffer, 0, sizeof(shadowViewBuffer) }, m_punctualShadowParameters.cb_PunctualShadowBuffer)
-                            });
+                    const scene::Mesh& mesh = *static_cast<scene::Mesh*>(itemMesh.geometry);
+                    ASSERT(mesh.getVertexAttribDesc()._inputBindings[0]._stride == sizeof(scene::VertexFormatStandard), "must be same");
+                    renderer::GeometryBufferDesc desc(mesh.getIndexBuffer(), 0, mesh.getVertexBuffer(0), sizeof(scene::VertexFormatStandard), 0);
+                    cmdList->drawIndexed(desc, 0, mesh.getIndexBuffer()->getIndicesCount(), 0, 0, 1);
+                }
 
-                        DEBUG_MARKER_SCOPE(cmdList, std::format("Object [{}], pipeline [{}]", itemMesh.object->m_name, m_punctualShadowPipeline->getName()), color::rgbaf::LTGREY);
+                cmdList->endRenderTarget();
+            };
 
-                        const scene::Mesh& mesh = *static_cast<scene::Mesh*>(itemMesh.geometry);
-                        ASSERT(mesh.getVertexAttribDesc()._inputBindings[0]._stride == sizeof(scene::VertexFormatStandard), "must be same");
-                        renderer::GeometryBufferDesc desc(mesh.getIndexBuffer(), 0, mesh.getVertexBuffer(0), sizeof(scene::VertexFormatStandard), 0);
-                        cmdList->drawIndexed(desc, 0, mesh.getIndexBuffer()->getIndicesCount(), 0, 0, 1);
-                    }
+        addRenderJob("Punctual Shadowmap Job", punctualJob, device, scene);
+    }
 
-                    cmdList->endRenderTarget();
-                }
-            }
+    auto screenSpaceJob = [this](renderer::Device* device, renderer::CmdListRender* cmdList, const SceneData& scene, const scene::FrameData& frame) -> void
+        {
+            TRACE_PROFILER_SCOPE("ScreenSpaceShadows", color::rgba8::GREEN);
+            DEBUG_MARKER_SCOPE(cmdList, "ScreenSpaceShadows", color::rgbaf::GREEN);
 
-            {
-                TRACE_PROFILER_SCOPE("ScreenSpaceShadows", color::rgba8::GREEN);
-                DEBUG_MARKER_SCOPE(cmdList, "ScreenSpaceShadows", color::rgbaf::GREEN);
-
-                cmdList->beginRenderTarget(*m_SSShadowsRenderTarget);
-                cmdList->setViewport({ 0.f, 0.f, (f32)viewportState->viewportSize._x, (f32)viewportState->viewportSize._y });
-                cmdList->setScissor({ 0.f, 0.f, (f32)viewportState->viewportSize._x, (f32)viewportState->viewportSize._y });
-                cmdList->setPipelineState(*m_SSShadowsPipeline);
-                cmdList->bindDescriptorSet(m_SSShadowsPipeline->getShaderProgram(), 0,
-                    {
-                        renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ viewportState, 0, sizeof(scene::ViewportState) }, m_SSCascadeShadowParameters.cb_Viewport)
-                    });
+            ObjectHandle viewportState_handle = frame.m_frameResources.get("viewport_state");
+            ASSERT(viewportState_handle.isValid(), "must be valid");
+            scene::ViewportState* viewportState = viewportState_handle.as<scene::ViewportState>();
 
-                scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)][0]);
+            ObjectHandle pipelineData_handle = frame.m_frameResources.get("shadow_data");
+            const RenderPipelineShadowStage::PipelineData* pipelineData = pipelineData_handle.as<scene::RenderPipelineShadowStage::PipelineData>();
 
-                struct DirectionLightShadowmapCascade
+            cmdList->beginRenderTarget(*m_SSShadowsRenderTarget);
+            cmdList->setViewport({ 0.f, 0.f, (f32)viewportState->viewportSize._x, (f32)viewportState->viewportSize._y });
+            cmdList->setScissor({ 0.f, 0.f, (f32)viewportState->viewportSize._x, (f32)viewportState->viewportSize._y });
+            cmdList->setPipelineState(*m_SSShadowsPipeline);
+            cmdList->bindDescriptorSet(m_SSShadowsPipeline->getShaderProgram(), 0,
                 {
-                    math::Matrix4D  lightSpaceMatrix;
-                    f32             cascadeSplit;
-                    f32             baseBias;
-                    f32             slopeBias;
-                    f32            _pad[1];
-                };
+                    renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ viewportState, 0, sizeof(scene::ViewportState) }, m_SSCascadeShadowParameters.cb_Viewport)
+                });
 
-                struct ShadowmapBuffer
-                {
-                    DirectionLightShadowmapCascade  cascade[k_maxShadowmapCascadeCount];
-                    math::Vector3D                  directionLight;
-                    math::float2                    shadowMapResolution;
-                    f32                             PCFMode;
-                    f32                             texelScale;
-                } cascadeShadowBuffer;
-
-                for (u32 id = 0; id < pipelineData->_directionLightSpaceMatrix.size(); ++id)
-                {
-                    cascadeShadowBuffer.cascade[id].lightSpaceMatrix = pipelineData->_directionLightSpaceMatrix[id];
-                    cascadeShadowBuffer.cascade[id].cascadeSplit = pipelineData->_directionLightCascadeSplits[id];
-                    cascadeShadowBuffer.cascade[id].baseBias = scene.m_settings._shadowsParams._cascadeBaseBias[id];
-                    cascadeShadowBuffer.cascade[id].slopeBias = scene.m_settings._shadowsParams._cascadeSlopeBias[id];
-                }
-                cascadeShadowBuffer.shadowMapResolution = { (f32)scene.m_settings._shadowsParams._size._width, (f32)scene.m_settings._shadowsParams._size._height };
-                cascadeShadowBuffer.directionLight = itemLight.object->getDirection();
-                cascadeShadowBuffer.PCFMode = scene.m_settings._shadowsParams._PCF;
-                cascadeShadowBuffer.texelScale = scene.m_settings._shadowsParams._textelScale;
+            scene::LightNodeEntry& itemLight = *static_cast<scene::LightNodeEntry*>(scene.m_renderLists[toEnumType(scene::ScenePass::DirectionLight)][0]);
 
-                ObjectHandle depth_stencil_h = scene.m_globalResources.get("depth_stencil");
-                ASSERT(depth_stencil_h.isValid(), "must be valid");
-                renderer::Texture2D* depthStencilTexture = objectFromHandle<renderer::Texture2D>(depth_stencil_h);
+            struct DirectionLightShadowmapCascade
+            {
+                math::Matrix4D  lightSpaceMatrix;
+                f32             cascadeSplit;
+                f32             baseBias;
+                f32             slopeBias;
+                f32            _pad[1];
+            };
+
+            struct ShadowmapBuffer
+            {
+                DirectionLightShadowmapCascade  cascade[k_maxShadowmapCascadeCount];
+                math::Vector3D                  directionLight;
+                math::float2                    shadowMapResolution;
+                f32                             PCFMode;
+                f32                             texelScale;
+            } cascadeShadowBuffer;
+
+            for (u32 id = 0; id < pipelineData->_directionLightSpaceMatrix.size(); ++id)
+            {
+                cascadeShadowBuffer.cascade[id].lightSpaceMatrix = pipelineData->_directionLightSpaceMatrix[id];
+                cascadeShadowBuffer.cascade[id].cascadeSplit = pipelineData->_directionLightCascadeSplits[id];
+                cascadeShadowBuffer.cascade[id].baseBias = scene.m_settings._shadowsParams._cascadeBaseBias[id];
+                cascadeShadowBuffer.cascade[id].slopeBias = scene.m_settings._shadowsParams._cascadeSlopeBias[id];
+            }
+            cascadeShadowBuffer.shadowMapResolution = { (f32)scene.m_settings._shadowsParams._size._width, (f32)scene.m_settings._shadowsParams._size._height };
+            cascadeShadowBuffer.directionLight = itemLight.object->getDirection();
+            cascadeShadowBuffer.PCFMode = scene.m_settings._shadowsParams._PCF;
+            cascadeShadowBuffer.texelScale = scene.m_settings._shadowsParams._textelScale;
 
-                ObjectHandle gbuffer_normals_h = scene.m_globalResources.get("gbuffer_normals");
-                ASSERT(gbuffer_normals_h.isValid(), "must be valid");
-                renderer::Texture2D* gbufferNormalsTexture = objectFromHandle<renderer::Texture2D>(gbuffer_normals_h);
+            ObjectHandle depth_stencil_h = scene.m_globalResources.get("depth_stencil");
+            ASSERT(depth_stencil_h.isValid(), "must be valid");
+            renderer::Texture2D* depthStencilTexture = objectFromHandle<renderer::Texture2D>(depth_stencil_h);
 
-                ObjectHandle sampler_state_h = scene.m_globalResources.get("point_sampler_clamp_edge");
-                ASSERT(sampler_state_h.isValid(), "must be valid");
-                renderer::SamplerState* sampler_state = objectFromHandle<renderer::SamplerState>(sampler_state_h);
+            ObjectHandle gbuffer_normals_h = scene.m_globalResources.get("gbuffer_normals");
+            ASSERT(gbuffer_normals_h.isValid(), "must be valid");
+            renderer::Texture2D* gbufferNormalsTexture = objectFromHandle<renderer::Texture2D>(gbuffer_normals_h);
 
-                cmdList->bindDescriptorSet(m_SSShadowsPipeline->getShaderProgram(), 1,
-                    {
-                        renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &cascadeShadowBuffer, 0, sizeof(cascadeShadowBuffer) }, m_SSCascadeShadowParameters.cb_ShadowmapBuffer),
-                        renderer::Descriptor(sampler_state, m_SSCascadeShadowParameters.s_SamplerState),
-                        renderer::Descriptor(m_shadowSamplerState, m_SSCascadeShadowParameters.s_ShadowSamplerState),
-                        renderer::Descriptor(renderer::TextureView(depthStencilTexture), m_SSCascadeShadowParameters.t_TextureDepth),
-                        renderer::Descriptor(renderer::TextureView(gbufferNormalsTexture, 0, 0), m_SSCascadeShadowParameters.t_TextureNormals),
-                        renderer::Descriptor(renderer::TextureView(m_cascadeTextureArray), m_SSCascadeShadowParameters.t_DirectionCascadeShadows),
-                    });
-
-                cmdList->draw(renderer::GeometryBufferDesc(), 0, 3, 0, 1);
-                cmdList->endRenderTarget();
-            }
+            ObjectHandle sampler_state_h = scene.m_globalResources.get("point_sampler_clamp_edge");
+            ASSERT(sampler_state_h.isValid(), "must be valid");
+            renderer::SamplerState* sampler_state = objectFromHandle<renderer::SamplerState>(sampler_state_h);
+
+            cmdList->bindDescriptorSet(m_SSShadowsPipeline->getShaderProgram(), 1,
+                {
+                    renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &cascadeShadowBuffer, 0, sizeof(cascadeShadowBuffer) }, m_SSCascadeShadowParameters.cb_ShadowmapBuffer),
+                    renderer::Descriptor(sampler_state, m_SSCascadeShadowParameters.s_SamplerState),
+                    renderer::Descriptor(m_shadowSamplerState, m_SSCascadeShadowParameters.s_ShadowSamplerState),
+                    renderer::Descriptor(renderer::TextureView(depthStencilTexture), m_SSCascadeShadowParameters.t_TextureDepth),
+                    renderer::Descriptor(renderer::TextureView(gbufferNormalsTexture, 0, 0), m_SSCascadeShadowParameters.t_TextureNormals),
+                    renderer::Descriptor(renderer::TextureView(m_cascadeTextureArray), m_SSCascadeShadowParameters.t_DirectionCascadeShadows),
+                });
+
+            cmdList->draw(renderer::GeometryBufferDesc(), 0, 3, 0, 1);
+            cmdList->endRenderTarget();
         };
 
-    addRenderJob("Shadowmap Job", renderJob, device, scene);
+    addRenderJob("ScreenSpaceShadows Job", screenSpaceJob, device, scene);
 }
 
 void RenderPipelineShadowStage::onChanged(renderer::Device* device, scene::SceneData& scene, const event::GameEvent* event)
@@ -380,18 +376,25 @@ void RenderPipelineShadowStage::createRenderTarget(renderer::Device* device, Sce
         m_cascadeTextureArray = V3D_NEW(renderer::Texture2D, memory::MemoryLabel::MemoryGame)(device, renderer::TextureUsage::TextureUsage_Attachment | renderer::TextureUsage::TextureUsage_Sampled | renderer::TextureUsage::TextureUsage_Write,
             renderer::Format::Format_D32_SFloat, scene.m_settings._shadowsParams._size, scene.m_settings._shadowsParams._cascadeCount, 1, "shadowmap");
 
-        ASSERT(m_cascadeRenderTarget == nullptr, "must be nullptr");
-        m_cascadeRenderTarget = V3D_NEW(renderer::RenderTargetState, memory::MemoryLabel::MemoryGame)(device, scene.m_settings._shadowsParams._size, 0, (1u << k_maxShadowmapCascadeCount) - 1u);
-        m_cascadeRenderTarget->setDepthStencilTexture(renderer::TextureView(m_cascadeTextureArray),
-            {
-                renderer::RenderTargetLoadOp::LoadOp_Clear, renderer::RenderTargetStoreOp::StoreOp_Store, 0.0f,
-            },
-            {
-                 renderer::RenderTargetLoadOp::LoadOp_DontCare, renderer::RenderTargetStoreOp::StoreOp_DontCare, 0U,
-            },
-            {
-                renderer::TransitionOp::TransitionOp_DepthStencilAttachment, renderer::TransitionOp::TransitionOp_DepthStencilReadOnly
-            });
+        //Only the first part clears the cascades and only the last one transitions them to read
+        for (u32 part = 0; part < toEnumType(RenderTargetPart::Count); ++part)
+        {
+            const bool first = part == toEnumType(RenderTargetPart::Whole) || part == toEnumType(RenderTargetPart::First);
+            const bool last = part == toEnumType(RenderTargetPart::Whole) || part == toEnumType(RenderTargetPart::Last);
+
+            ASSERT(m_cascadeRenderTargets[part] == nullptr, "must be nullptr");
+            m_cascadeRenderTargets[part] = V3D_NEW(renderer::RenderTargetState, memory::MemoryLabel::MemoryGame)(device, scene.m_settings._shadowsParams._size, 0, (1u << k_maxShadowmapCascadeCount) - 1u);
+            m_cascadeRenderTargets[part]->setDepthStencilTexture(renderer::TextureView(m_cascadeTextureArray),
+                {
+                    first ? renderer::RenderTargetLoadOp::LoadOp_Clear : renderer::RenderTargetLoadOp::LoadOp_Load, renderer::RenderTargetStoreOp::StoreOp_Store, 0.0f,
+                },
+                {
+                     renderer::RenderTargetLoadOp::LoadOp_DontCare, renderer::RenderTargetStoreOp::StoreOp_DontCare, 0U,
+                },
+                {
+                    renderer::TransitionOp::TransitionOp_DepthStencilAttachment, last ? renderer::TransitionOp::TransitionOp_DepthStencilReadOnly : renderer::TransitionOp::TransitionOp_DepthStencilAttachment
+                });
+        }
     }
 
     {
@@ -400,8 +403,21 @@ void RenderPipelineShadowStage::createRenderTarget(renderer::Device* device, Sce
             renderer::Format::Format_D32_SFloat, scene.m_settings._shadowsParams._size, 6 * k_maxPunctualShadowmapCount, 1, "view_shadow");
         scene.m_globalResources.bind("shadowmaps_array", m_punctualShadowTextureArray);
 
-        ASSERT(m_punctualShadowRenderTarget == nullptr, "must be nullptr");
-        m_punctualShadowRenderTarget = V3D_NEW(renderer::RenderTargetState, memory::MemoryLabel::MemoryGame)(device, scene.m_settings._shadowsParams._size, 0);
+        for (u32 i = 0; i < k_maxPunctualShadowmapCount; ++i)
+        {
+            ASSERT(m_punctualShadowRenderTargets[i] == nullptr, "must be nullptr");
+            m_punctualShadowRenderTargets[i] = V3D_NEW(renderer::RenderTargetState, memory::MemoryLabel::MemoryGame)(device, scene.m_settings._shadowsParams._size, 0);
+            m_punctualShadowRenderTargets[i]->setDepthStencilTexture(renderer::TextureView(m_punctualShadowTextureArray, i * 6, 6, 0, 1),
+                {
+                    renderer::RenderTargetLoadOp::LoadOp_Clear, renderer::RenderTargetStoreOp::StoreOp_Store, 0.0f,
+                },
+                {
+                     renderer::RenderTargetLoadOp::LoadOp_DontCare, renderer::RenderTargetStoreOp::StoreOp_DontCare, 0U,
+                },
+                {
+                    renderer::TransitionOp::TransitionOp_DepthStencilAttachment, renderer::TransitionOp::TransitionOp_DepthStencilReadOnly
+                });
+        }
     }
 
     {
@@ -425,9 +441,12 @@ void RenderPipelineShadowStage::createRenderTarget(renderer::Device* device, Sce
 void RenderPipelineShadowStage::destroyRenderTarget(renderer::Device* device, SceneData& scene)
 {
     {
-        ASSERT(m_cascadeRenderTarget != nullptr, "must be valid");
-        V3D_DELETE(m_cascadeRenderTarget, memory::MemoryLabel::MemoryGame);
-        m_cascadeRenderTarget = nullptr;
+        for (auto& renderTarget : m_cascadeRenderTargets)
+        {
+            ASSERT(renderTarget != nullptr, "must be valid");
+            V3D_DELETE(renderTarget, memory::MemoryLabel::MemoryGame);
+            renderTarget = nullptr;
+        }
 
         ASSERT(m_cascadeTextureArray != nullptr, "must be valid");
         V3D_DELETE(m_cascadeTextureArray, memory::MemoryLabel::MemoryGame);
@@ -435,9 +454,12 @@ void RenderPipelineShadowStage::destroyRenderTarget(renderer::Device* device, Sc
     }
 
     {
-        ASSERT(m_punctualShadowRenderTarget != nullptr, "must be valid");
-        V3D_DELETE(m_punctualShadowRenderTarget, memory::MemoryLabel::MemoryGame);
-        m_punctualShadowRenderTarget = nullptr;
+        for (auto& renderTarget : m_punctualShadowRenderTargets)
+        {
+            ASSERT(renderTarget != nullptr, "must be valid");
+            V3D_DELETE(renderTarget, memory::MemoryLabel::MemoryGame);
+            renderTarget = nullptr;
+        }
 
         ASSERT(m_punctualShadowTextureArray != nullptr, "must be valid");
         V3D_DELETE(m_punctualShadowTextureArray, memory::MemoryLabel::MemoryGame);
@@ -454,8 +476,36 @@ void RenderPipelineShadowStage::destroyRenderTarget(renderer::Device* device, Sc
     }
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineShadowStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    const renderer::Shader::DefineList cascadeDefines =
+    {
+        { "SHADOWMAP_CASCADE_COUNT", std::to_string(scene.m_settings._shadowsParams._cascadeCount) },
+    };
+
+    const renderer::Shader::DefineList screenSpaceDefines =
+    {
+        { "SHADOWMAP_CASCADE_COUNT", std::to_string(scene.m_settings._shadowsParams._cascadeCount) },
+        { "SHADOWMAP_CASCADE_BLEND", "1" },
+        { "SHADOWMAP_FAST_COMPUTATION", "0" },
+    };
+
+    return
+    {
+        { "light_directional_shadows.hlsl", "shadows_vs", renderer::ShaderType::Vertex, cascadeDefines },
+        { "light_directional_shadows.hlsl", "shadows_ps", renderer::ShaderType::Fragment, cascadeDefines },
+        { "light_point_shadows.hlsl", "point_shadows_vs", renderer::ShaderType::Vertex },
+        { "light_point_shadows.hlsl", "shadows_ps", renderer::ShaderType::Fragment },
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex },
+        { "screen_space_shadow.hlsl", "screen_space_shadow_ps", renderer::ShaderType::Fragment, screenSpaceDefines },
+    };
+}
+
 void RenderPipelineShadowStage::createPipelines(renderer::Device* device, scene::SceneData& scene)
 {
+    //Reloads all variants at once, loadShader below finds them registered
+    resource::ResourceManager::getInstance()->compileShaders(RenderPipelineShadowStage::getShaderPermutations(scene), resource::ShaderCompileFlag::ShaderCompile_ForceReload);
+
     {
         renderer::Shader::DefineList defines =
         {
@@ -463,9 +513,9 @@ void RenderPipelineShadowStage::createPipelines(renderer::Device* device, scene:
         };
 
         const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>(
-            "light_directional_shadows.hlsl", "shadows_vs", defines, {}, resource::ShaderCompileFlag::ShaderCompile_ForceReload);
+            "light_directional_shadows.hlsl", "shadows_vs", defines, {});
         const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>(
-            "light_directional_shadows.hlsl", "shadows_ps", defines, {}, resource::ShaderCompileFlag::ShaderCompile_ForceReload);
+            "light_directional_shadows.hlsl", "shadows_ps", defines, {});
 
         renderer::RenderPassDesc desc{};
         desc._countColorAttachment = 0;
@@ -489,14 +539,16 @@ void RenderPipelineShadowStage::createPipelines(renderer::Device* device, scene:
         m_cascadeShadowPipeline->setColorMask(0, renderer::ColorMask::ColorMask_None);
         //m_cascadeShadowPipeline->setDepthBias(0.0f, 0.0f, -2.5f); Apply inside the shader
 
+        device->compilePipeline(*m_cascadeShadowPipeline);
+
         BIND_SHADER_PARAMETER(m_cascadeShadowPipeline, m_cascadeShadowParameters, cb_DirectionShadowBuffer);
     }
 
     {
         const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>(
-            "light_point_shadows.hlsl", "point_shadows_vs", {}, {}, resource::ShaderCompileFlag::ShaderCompile_ForceReload);
+            "light_point_shadows.hlsl", "point_shadows_vs", {}, {});
         const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>(
-            "light_point_shadows.hlsl", "shadows_ps", {}, {}, resource::ShaderCompileFlag::ShaderCompile_ForceReload);
+            "light_point_shadows.hlsl", "shadows_ps", {}, {});
 
         renderer::RenderPassDesc desc{};
         desc._countColorAttachment = 0;
@@ -520,6 +572,8 @@ void RenderPipelineShadowStage::createPipelines(renderer::Device* device, scene:
         m_punctualShadowPipeline->setColorMask(0, renderer::ColorMask::ColorMask_None);
         m_punctualShadowPipeline->setDepthBias(0.0f, 0.0f, -5.0f);
 
+        device->compilePipeline(*m_punctualShadowPipeline);
+
         BIND_SHADER_PARAMETER(m_punctualShadowPipeline, m_punctualShadowParameters, cb_PunctualShadowBuffer);
     }
 
@@ -534,7 +588,7 @@ void RenderPipelineShadowStage::createPipelines(renderer::Device* device, scene:
         const renderer::VertexShader* vertShader = resource::ResourceManager::getInstance()->loadShader<renderer::VertexShader, resource::ShaderSourceFileLoader>(
             "offscreen.hlsl", "offscreen_vs", {}, {});
         const renderer::FragmentShader* fragShader = resource::ResourceManager::getInstance()->loadShader<renderer::FragmentShader, resource::ShaderSourceFileLoader>(
-            "screen_space_shadow.hlsl", "screen_space_shadow_ps", defines, {}, resource::ShaderCompileFlag::ShaderCompile_ForceReload);
+            "screen_space_shadow.hlsl", "screen_space_shadow_ps", defines, {});
 
         m_SSShadowsPipeline = V3D_NEW(renderer::GraphicsPipelineState, memory::MemoryLabel::MemoryGame)(device, renderer::VertexInputAttributeDesc(), m_SSShadowsRenderTarget->getRenderPassDesc(),
             V3D_NEW(renderer::ShaderProgram, memory::MemoryLabel::MemoryGame)(device, vertShader, fragShader), "screen_space_shadows_pipeline");
@@ -551,6 +605,8 @@ void RenderPipelineShadowStage::createPipelines(renderer::Device* device, scene:
         //m_SSShadowsPipeline->setStencilBackFaceCompareOp(renderer::CompareOperation::NotEqual, 0x0);
         //m_SSShadowsPipeline->setStencilBackFaceOp(renderer::StencilOperation::Keep, renderer::StencilOperation::Keep, renderer::StencilOperation::Keep);
 
+        device->compilePipeline(*m_SSShadowsPipeline);
+
         BIND_SHADER_PARAMETER(m_SSShadowsPipeline, m_SSCascadeShadowParameters, cb_Viewport);
         BIND_SHADER_PARAMETER(m_SSShadowsPipeline, m_SSCascadeShadowParameters, cb_ShadowmapBuffer);
         BIND_SHADER_PARAMETER(m_SSShadowsPipeline, m_SSCascadeShadowParameters, s_SamplerState);
@@ -13,6 +13,10 @@ namespace renderer
     class RenderTargetState;
     class GraphicsPipelineState;
 } // namespace renderer
+namespace resource
+{
+    struct ShaderPermutation;
+} // namespace resource
 namespace scene
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -34,6 +38,8 @@ namespace scene
         void prepare(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
         void execute(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame) override;
 
+        static std::vector<resource::ShaderPermutation> getShaderPermutations(const scene::SceneData& scene);
+
         void onChanged(renderer::Device* device, scene::SceneData& scene, const event::GameEvent* event) override;
 
         struct PipelineData
@@ -51,6 +57,8 @@ namespace scene
 
     private:
 
+        static constexpr u32 k_shadowJobGrain = 256;
+
         void createRenderTarget(renderer::Device* device, SceneData& scene);
         void destroyRenderTarget(renderer::Device* device, SceneData& scene);
 
@@ -68,7 +76,7 @@ namespace scene
             SHADER_PARAMETER(cb_DirectionShadowBuffer);
         };
 
-        renderer::RenderTargetState*              m_cascadeRenderTarget;
+        std::array<renderer::RenderTargetState*, toEnumType(RenderTargetPart::Count)> m_cascadeRenderTargets;
         renderer::Texture2D*                      m_cascadeTextureArray;
         renderer::GraphicsPipelineState*          m_cascadeShadowPipeline;
         MaterialCascadeShadowsParameters          m_cascadeShadowParameters;
@@ -78,7 +86,7 @@ namespace scene
             SHADER_PARAMETER(cb_PunctualShadowBuffer);
         };
 
-        renderer::RenderTargetState*              m_punctualShadowRenderTarget;
+        std::array<renderer::RenderTargetState*, k_maxPunctualShadowmapCount> m_punctualShadowRenderTargets; //One per light, recorded concurrently
         renderer::Texture2D*                      m_punctualShadowTextureArray;
         renderer::GraphicsPipelineState*          m_punctualShadowPipeline;
         MaterialPointShadowsParameters            m_punctualShadowParameters;
@@ -33,6 +33,16 @@ RenderPipelineSkyboxStage::~RenderPipelineSkyboxStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineSkyboxStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "skybox.hlsl", "skybox_vs", renderer::ShaderType::Vertex },
+        { "skybox.hlsl", "skybox_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineSkyboxStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     createRenderTarget(device, scene, frame);
@@ -66,6 +76,8 @@ void RenderPipelineSkyboxStage::create(renderer::Device* device, scene::SceneDat
         pipeline->setDepthWrite(false);
         pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*pipeline);
+
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(pipeline, m_parameters, s_SamplerState);
         BIND_SHADER_PARAMETER(pipeline, m_parameters, t_SkyboxTexture);
@@ -103,6 +115,8 @@ void RenderPipelineSkyboxStage::create(renderer::Device* device, scene::SceneDat
         pipeline->setDepthWrite(false);
         pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*pipeline);
+
         BIND_SHADER_PARAMETER(pipeline, m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(pipeline, m_parameters, s_SamplerState);
         BIND_SHADER_PARAMETER(pipeline, m_parameters, t_SkyboxTexture);
@@ -206,7 +220,7 @@ void RenderPipelineSkyboxStage::execute(renderer::Device* device, scene::SceneDa
                 cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
                     {
                         renderer::Descriptor(sampler_state, m_parameters.s_SamplerState),
-                        renderer::Descriptor(renderer::TextureView(material.getProperty<ObjectHandle>("BaseColor").as<renderer::Texture2D>()), m_parameters.t_SkyboxTexture),
+                        renderer::Descriptor(renderer::TextureView(material.getParameters()._textures[scene::MaterialParameters::BaseColor].as<renderer::Texture2D>()), m_parameters.t_SkyboxTexture),
                     });
 
                 DEBUG_MARKER_SCOPE(cmdList, std::format("Skybox {}", skybox.getName()), color::rgbaf::LTGREY);
@@ -1,5 +1,6 @@
 #include "RenderPipelineStage.h"
 #include "Renderer/Device.h"
+#include "FrameProfiler.h"
 
 namespace v3d
 {
@@ -61,6 +62,7 @@ void RenderTechnique::prepare(renderer::Device* device, scene::SceneData& scene,
     {
         if (stage->isEnabled())
         {
+            TRACE_PROFILER_ZONE(id.c_str());
             stage->prepare(device, scene, frame);
         }
     }
@@ -72,6 +74,7 @@ void RenderTechnique::execute(renderer::Device* device, scene::SceneData& scene,
     {
         if (stage->isEnabled())
         {
+            TRACE_PROFILER_ZONE(id.c_str());
             stage->execute(device, scene, frame);
         }
     }
@@ -85,17 +88,27 @@ void RenderTechnique::submit(renderer::Device* device, scene::SceneData& scene,
         m_batchJobs.clear();
     }
        
-    for (auto& [cmd, renderTask] : m_dependencyList)
+    if (m_renderJobs.empty())
     {
-        renderTask->waitCompetition();
-        device->submit(cmd);
+        return;
+    }
 
-        m_freeCmdList.push(cmd);
+    //The submit tasks run on the main thread while it waits, every one as soon as its job and the previous submit are completed
+    for (RenderJob& job : m_renderJobs)
+    {
+        scene.m_taskWorker.executeTask(job._submitTask, task::TaskPriority::Normal, task::TaskMask::MainThread);
+    }
+    scene.m_taskWorker.waitTask(m_renderJobs.back()._submitTask);
 
-        delete renderTask;
+    for (RenderJob& job : m_renderJobs)
+    {
+        m_freeCmdList.push(job._cmdList);
+
+        m_taskPool.releaseTask(job._renderTask);
+        m_taskPool.releaseTask(job._submitTask);
     }
 
-    m_dependencyList.clear();
+    m_renderJobs.clear();
 }
 
 void RenderTechnique::onChanged(renderer::Device* device, scene::SceneData& scene, const event::GameEvent* event)
@@ -129,6 +142,25 @@ void RenderTechnique::addStage(const std::string& id, RenderPipelineStage* stage
     m_stages.emplace_back(id, stage);
 }
 
+void RenderTechnique::scheduleRenderJob(renderer::Device* device, const scene::SceneData& scene, renderer::CmdListRender* cmdList, task::Task* renderTask)
+{
+    task::Task* submitTask = m_taskPool.acquireTask();
+    submitTask->init("Submit Job", [](renderer::Device* device, renderer::CmdListRender* cmdList) -> void
+        {
+            device->submit(cmdList);
+        }, device, cmdList);
+
+    //Scheduled by RenderTechnique::submit, the chain keeps the order of the command lists
+    submitTask->addDependency(renderTask);
+    if (!m_renderJobs.empty())
+    {
+        submitTask->addDependency(m_renderJobs.back()._submitTask);
+    }
+    m_renderJobs.push_back({ cmdList, renderTask, submitTask });
+
+    scene.m_taskWorker.executeTask(renderTask, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+}
+
 renderer::CmdListRender* RenderTechnique::acquireCmdList(renderer::Device* device)
 {
     if (!m_freeCmdList.empty())
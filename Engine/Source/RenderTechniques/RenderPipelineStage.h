@@ -5,6 +5,7 @@
 #include "Events/Game/GameEvent.h"
 #include "Task/Task.h"
 #include "Task/TaskScheduler.h"
+#include "Task/TaskPool.h"
 #include "Thread/ThreadSafeAllocator.h"
 #include "Scene/Scene.h"
 
@@ -25,6 +26,48 @@ namespace scene
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    /**
+    * @brief RenderTargetPart enum. Render target variant used by one part of a parallel render job.
+    * Only the first part clears the attachments and only the last one makes the final transition
+    */
+    enum class RenderTargetPart : u32
+    {
+        Whole,
+        First,
+        Middle,
+        Last,
+
+        Count
+    };
+
+    /**
+    * @brief RenderJobRange struct. Range of a render list recorded by one part of a parallel render job
+    */
+    struct RenderJobRange
+    {
+        u32 _begin;
+        u32 _end;
+        u32 _index;
+        u32 _count;
+
+        RenderTargetPart getPart() const
+        {
+            if (_count == 1)
+            {
+                return RenderTargetPart::Whole;
+            }
+
+            if (_index == 0)
+            {
+                return RenderTargetPart::First;
+            }
+
+            return (_index + 1 == _count) ? RenderTargetPart::Last : RenderTargetPart::Middle;
+        }
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
     class RenderTechnique
     {
     public:
@@ -51,7 +94,10 @@ namespace scene
     private:
 
         template<typename Func>
-        void addRenderJob(const std::string& name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch = false);
+        void addRenderJob(const c8* name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch = false);
+
+        template<typename Func>
+        void addParallelRenderJob(const c8* name, u32 count, u32 grain, Func&& func, renderer::Device* device, const scene::SceneData& scene);
 
         struct Stage
         {
@@ -59,22 +105,34 @@ namespace scene
             RenderPipelineStage* _stage;
         };
 
+        /**
+        * @brief RenderJob struct. The submit task depends on the render task and on the submit task of the previous job
+        */
+        struct RenderJob
+        {
+            renderer::CmdListRender* _cmdList;
+            task::Task*              _renderTask;
+            task::Task*              _submitTask;
+        };
+
         std::vector<Stage> m_stages;
-        std::vector<std::tuple<renderer::CmdListRender*, task::Task*>> m_dependencyList;
+        std::vector<RenderJob> m_renderJobs;
         std::queue<renderer::CmdListRender*> m_freeCmdList;
+        task::TaskPool m_taskPool;
 
         using RenderJobFunc = std::function<void(renderer::Device*, renderer::CmdListRender*, const scene::SceneData&, const scene::FrameData&)>;
         std::vector<RenderJobFunc> m_batchJobs;
         std::vector<std::tuple<Object*, memory::MemoryLabel>> m_delayedDeleteList;
 
         void flushRenderJobs(renderer::Device* device, std::vector<RenderTechnique::RenderJobFunc>& jobs, const scene::SceneData& scene);
+        void scheduleRenderJob(renderer::Device* device, const scene::SceneData& scene, renderer::CmdListRender* cmdList, task::Task* renderTask);
         [[nodiscard]] renderer::CmdListRender* acquireCmdList(renderer::Device* device);
 
         friend RenderPipelineStage;
     };
 
     template<typename Func>
-    inline void RenderTechnique::addRenderJob(const std::string& name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch)
+    inline void RenderTechnique::addRenderJob(const c8* name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch)
     {
         if (batch)
         {
@@ -87,11 +145,10 @@ namespace scene
             renderer::CmdListRender* cmdList = acquireCmdList(device);
             scene::FrameData& frameData = scene.renderFrameData();
 
-            task::Task* renderTask = new task::Task;
+            task::Task* renderTask = m_taskPool.acquireTask();
             renderTask->init(name, std::forward<Func>(func), device, cmdList, std::reference_wrapper<const scene::SceneData>(scene), std::reference_wrapper<const scene::FrameData>(frameData));
 
-            m_dependencyList.emplace_back(cmdList, renderTask);
-            scene.m_taskWorker.executeTask(renderTask, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+            scheduleRenderJob(device, scene, cmdList, renderTask);
         }
         else
         {
@@ -104,6 +161,37 @@ namespace scene
         }
     }
 
+    template<typename Func>
+    inline void RenderTechnique::addParallelRenderJob(const c8* name, u32 count, u32 grain, Func&& func, renderer::Device* device, const scene::SceneData& scene)
+    {
+        ASSERT(grain > 0, "must be greater than 0");
+        if (!m_batchJobs.empty()) //keep the submission order
+        {
+            std::vector<RenderTechnique::RenderJobFunc> tempBatchJobs;
+            std::swap(tempBatchJobs, m_batchJobs);
+
+            flushRenderJobs(device, tempBatchJobs, scene);
+        }
+
+        scene::FrameData& frameData = scene.renderFrameData();
+        const u32 partCount = std::clamp<u32>((count + grain - 1) / grain, 1, scene.m_taskWorker.getNumberOfCoreThreads());
+        const u32 partSize = (count + partCount - 1) / partCount;
+
+        //Every part records into own command list, the lists are submitted in the order of the parts
+        for (u32 part = 0; part < partCount; ++part)
+        {
+            const u32 begin = std::min(part * partSize, count);
+            const RenderJobRange range{ begin, std::min(begin + partSize, count), part, partCount };
+
+            renderer::CmdListRender* cmdList = acquireCmdList(device);
+
+            task::Task* renderTask = m_taskPool.acquireTask();
+            renderTask->init(name, func, device, cmdList, std::reference_wrapper<const scene::SceneData>(scene), std::reference_wrapper<const scene::FrameData>(frameData), range);
+
+            scheduleRenderJob(device, scene, cmdList, renderTask);
+        }
+    }
+
     inline void RenderTechnique::flushRenderJobs(renderer::Device* device, std::vector<RenderTechnique::RenderJobFunc>& jobs, const scene::SceneData& scene)
     {
         renderer::CmdListRender* cmdList = acquireCmdList(device);
@@ -117,11 +205,10 @@ namespace scene
                 }
             };
 
-        task::Task* renderTask = new task::Task;
-        renderTask->init(batchFunc, jobs, device, cmdList, std::reference_wrapper<const scene::SceneData>(scene), std::reference_wrapper<const scene::FrameData>(frameData));
+        task::Task* renderTask = m_taskPool.acquireTask();
+        renderTask->init("Batch Job", batchFunc, std::move(jobs), device, cmdList, std::reference_wrapper<const scene::SceneData>(scene), std::reference_wrapper<const scene::FrameData>(frameData));
 
-        m_dependencyList.emplace_back(cmdList, renderTask);
-        scene.m_taskWorker.executeTask(renderTask, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+        scheduleRenderJob(device, scene, cmdList, renderTask);
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -153,7 +240,14 @@ namespace scene
     protected:
 
         template<typename Func>
-        void addRenderJob(const std::string& name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch = false);
+        void addRenderJob(const c8* name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch = false);
+
+        /**
+        * @brief addParallelRenderJob. Splits count items into parts recorded concurrently,
+        * func(device, cmdList, scene, frame, const RenderJobRange& range) is called once per part
+        */
+        template<typename Func>
+        void addParallelRenderJob(const c8* name, u32 count, u32 grain, Func&& func, renderer::Device* device, const scene::SceneData& scene);
 
         bool                 m_created;
     };
@@ -171,11 +265,17 @@ namespace scene
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     template<typename Func>
-    inline void RenderPipelineStage::addRenderJob(const std::string& name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch)
+    inline void RenderPipelineStage::addRenderJob(const c8* name, Func&& func, renderer::Device* device, const scene::SceneData& scene, bool batch)
     {
         m_renderTechnique.addRenderJob(name, std::forward<Func>(func), device, std::reference_wrapper<const scene::SceneData>(scene), batch);
     }
 
+    template<typename Func>
+    inline void RenderPipelineStage::addParallelRenderJob(const c8* name, u32 count, u32 grain, Func&& func, renderer::Device* device, const scene::SceneData& scene)
+    {
+        m_renderTechnique.addParallelRenderJob(name, count, grain, std::forward<Func>(func), device, scene);
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } //namespace scene
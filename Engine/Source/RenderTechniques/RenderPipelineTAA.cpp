@@ -29,6 +29,16 @@ RenderPipelineTAAStage::~RenderPipelineTAAStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineTAAStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex },
+        { "taa.hlsl", "main_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineTAAStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     if (m_created)
@@ -60,6 +70,8 @@ void RenderPipelineTAAStage::create(renderer::Device* device, scene::SceneData&
         m_pipeline->setDepthTest(false);
         m_pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*m_pipeline);
+
         BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(m_pipeline, m_parameters, s_SamplerLinear);
         BIND_SHADER_PARAMETER(m_pipeline, m_parameters, s_SamplerPoint);
@@ -27,6 +27,16 @@ RenderPipelineTonemapStage::~RenderPipelineTonemapStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineTonemapStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "offscreen.hlsl", "offscreen_vs", renderer::ShaderType::Vertex },
+        { "tonemapping.hlsl", "tonemapping_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineTonemapStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     createRenderTarget(device, scene, frame);
@@ -47,6 +57,8 @@ void RenderPipelineTonemapStage::create(renderer::Device* device, scene::SceneDa
     m_pipeline->setDepthTest(false);
     m_pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+    device->compilePipeline(*m_pipeline);
+
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Viewport);
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, cb_Tonemapper);
     BIND_SHADER_PARAMETER(m_pipeline, m_parameters, s_PointSamplerState);
@@ -31,6 +31,16 @@ RenderPipelineUnlitStage::~RenderPipelineUnlitStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineUnlitStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "simple.hlsl", "billboard_vs", renderer::ShaderType::Vertex },
+        { "simple.hlsl", "unlit_selectable_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineUnlitStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     //Material 0
@@ -63,6 +73,8 @@ void RenderPipelineUnlitStage::create(renderer::Device* device, scene::SceneData
         pipeline->setDepthWrite(true);
         pipeline->setColorMask(0, renderer::ColorMask::ColorMask_All);
 
+        device->compilePipeline(*pipeline);
+
         MaterialParameters parameters;
         BIND_SHADER_PARAMETER(pipeline, parameters, cb_Viewport);
         BIND_SHADER_PARAMETER(pipeline, parameters, cb_Model);
@@ -192,14 +204,14 @@ void RenderPipelineUnlitStage::execute(renderer::Device* device, scene::SceneDat
                 constantBuffer.prevModelMatrix = itemMesh.object->getPrevTransform().getMatrix();
                 constantBuffer.normalMatrix = constantBuffer.modelMatrix.getInversed();
                 constantBuffer.normalMatrix.makeTransposed();
-                constantBuffer.tintColour = material.getProperty<math::float4>("Color");
+                constantBuffer.tintColour = material.getParameters()._colors[scene::MaterialParameters::Tint];
                 constantBuffer.objectID = itemMesh.object->ID();
 
                 cmdList->bindDescriptorSet(m_pipelines[itemMesh.pipelineID]->getShaderProgram(), 1,
                     {
                         renderer::Descriptor(renderer::Descriptor::ConstantBuffer{ &constantBuffer, 0, sizeof(constantBuffer)}, m_parameters[itemMesh.pipelineID].cb_Model),
                         renderer::Descriptor(sampler, m_parameters[itemMesh.pipelineID].s_SamplerState),
-                        renderer::Descriptor(renderer::TextureView(objectFromHandle<renderer::Texture2D>(material.getProperty<ObjectHandle>("BaseColor"))), m_parameters[itemMesh.pipelineID].t_TextureBaseColor)
+                        renderer::Descriptor(renderer::TextureView(objectFromHandle<renderer::Texture2D>(material.getParameters()._textures[scene::MaterialParameters::BaseColor])), m_parameters[itemMesh.pipelineID].t_TextureBaseColor)
                     });
 
                 DEBUG_MARKER_SCOPE(cmdList, std::format("Object {}, pipeline {}", itemMesh.object->ID(), m_pipelines[itemMesh.pipelineID]->getName()), color::rgbaf::LTGREY);
@@ -39,6 +39,16 @@ RenderPipelineZPrepassStage::~RenderPipelineZPrepassStage()
 {
 }
 
+std::vector<resource::ShaderPermutation> RenderPipelineZPrepassStage::getShaderPermutations(const scene::SceneData& scene)
+{
+    //Same variants as create loads
+    return
+    {
+        { "gbuffer.hlsl", "gbuffer_standard_vs", renderer::ShaderType::Vertex },
+        { "gbuffer.hlsl", "gbuffer_depth_ps", renderer::ShaderType::Fragment },
+    };
+}
+
 void RenderPipelineZPrepassStage::create(renderer::Device* device, scene::SceneData& scene, scene::FrameData& frame)
 {
     if (m_created)
@@ -73,6 +83,8 @@ void RenderPipelineZPrepassStage::create(renderer::Device* device, scene::SceneD
     //m_depthPipeline->setStencilBackFaceCompareOp(renderer::CompareOperation::Always, 0xFF);
     //m_depthPipeline->setStencilBackFaceOp(renderer::StencilOperation::Replace, renderer::StencilOperation::Keep, renderer::StencilOperation::Keep);
 
+    device->compilePipeline(*m_depthPipeline);
+
     BIND_SHADER_PARAMETER(m_depthPipeline, m_depthParameters, cb_Viewport);
     BIND_SHADER_PARAMETER(m_depthPipeline, m_depthParameters, cb_Model);
 
@@ -1,6 +1,8 @@
 #include "Device.h"
 #include "Utils/Logger.h"
 
+#include "Null/NullDevice.h"
+
 #ifdef VULKAN_RENDER
 #   include "Vulkan/VulkanDevice.h"
 #endif //VULKAN_RENDER
@@ -24,6 +26,7 @@ Device* Device::createDevice(RenderType type, DeviceMaskFlags mask)
     switch (type)
     {
     case RenderType::Empty:
+        render = V3D_NEW(null::NullDevice, memory::MemoryLabel::MemoryRenderCore)(mask);
         break;
 
 #ifdef VULKAN_RENDER
@@ -310,6 +310,12 @@ namespace renderer
         */
         virtual void destroySwapchain(Swapchain* swapchain) = 0;
 
+        /**
+        * @brief getFramesInFlight. The frames the GPU could still execute while the next one is recorded, the image count of the swapchains
+        * @return u32 count
+        */
+        virtual u32 getFramesInFlight() const = 0;
+
         /**
         * @brief createSyncPoint
         */
@@ -320,6 +326,42 @@ namespace renderer
         */
         virtual void destroySyncPoint(CmdList* cmd, SyncPoint* sync) = 0;
 
+        /**
+        * @brief compilePipeline. Starts the pipeline creation in the background, creates it in place if the background threads can't be used.
+        * setPipelineState waits only if the pipeline is not ready yet. Call it after all the setters of the state.
+        * Returns false if the pipeline can't be created, the failure in the background is reported by setPipelineState
+        */
+        virtual bool compilePipeline(GraphicsPipelineState& state) = 0;
+
+        /**
+        * @brief compilePipeline. Starts the pipeline creation in the background
+        */
+        virtual bool compilePipeline(ComputePipelineState& state) = 0;
+
+        /**
+        * @brief registerBindlessTexture. Writes the texture to the descriptor heap, the shaders read it from k_bindlessDescriptorSet by the index.
+        * Supported if DeviceCaps::_supportBindless. The texture isn't transitioned per draw, it must be in the shader read state while it's drawn
+        * @return u32 index or k_invalidBindlessIndex if the heap is full
+        */
+        [[nodiscard]] virtual u32 registerBindlessTexture(const TextureView& texture) = 0;
+
+        /**
+        * @brief unregisterBindlessTexture. The index is reused after the GPU has finished the frames which could read it.
+        * Must be called before the texture is destroyed
+        */
+        virtual void unregisterBindlessTexture(u32 index) = 0;
+
+        /**
+        * @brief registerBindlessBuffer. Writes the storage buffer to the descriptor heap
+        * @return u32 index or k_invalidBindlessIndex if the heap is full
+        */
+        [[nodiscard]] virtual u32 registerBindlessBuffer(Buffer* buffer) = 0;
+
+        /**
+        * @brief unregisterBindlessBuffer. Must be called before the buffer is destroyed
+        */
+        virtual void unregisterBindlessBuffer(u32 index) = 0;
+
     public:
 
         [[nodiscard]] virtual TextureHandle createTexture(TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, u32 mipmapLevel, TextureUsageFlags flags, const std::string& name = "") = 0;
@@ -79,6 +79,10 @@ namespace renderer
         bool _supportMultiview = false;
         bool _supportBlitImage = false;
 
+        bool _supportBindless = false;
+        u32 _maxBindlessTextures = 0;
+        u32 _maxBindlessBuffers = 0;
+
         struct ImageFormatSupport
         {
             bool _supportAttachment;
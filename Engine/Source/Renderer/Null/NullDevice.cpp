@@ -0,0 +1,1360 @@
+#include "NullDevice.h"
+#include "Renderer/ShaderProgram.h"
+#include "Utils/Logger.h"
+
+namespace v3d
+{
+namespace renderer
+{
+namespace null
+{
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class StreamReader
+{
+public:
+
+    explicit StreamReader(const std::vector<u8>& stream) noexcept
+        : m_stream(stream)
+        , m_offset(0)
+    {
+    }
+
+    bool isEnd() const
+    {
+        return m_offset >= m_stream.size();
+    }
+
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_standard_layout<T>(), "must be plain data");
+        ASSERT(m_offset + sizeof(T) <= m_stream.size(), "out of range");
+
+        T value;
+        memcpy(&value, m_stream.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return value;
+    }
+
+    const void* readData(u32& size)
+    {
+        size = read<u32>();
+        ASSERT(m_offset + size <= m_stream.size(), "out of range");
+
+        const void* data = m_stream.data() + m_offset;
+        m_offset += size;
+        return data;
+    }
+
+    std::string readString()
+    {
+        u32 size = 0;
+        const c8* data = reinterpret_cast<const c8*>(readData(size));
+        return std::string(data, size);
+    }
+
+    template<typename T>
+    T* readObject(const std::vector<void*>& objects)
+    {
+        u32 index = read<u32>();
+        [[maybe_unused]] u32 key = read<u32>();
+        ASSERT(index < objects.size(), "out of range");
+        return reinterpret_cast<T*>(objects[index]);
+    }
+
+    BufferHandle readBufferHandle(const std::vector<void*>& objects)
+    {
+        u32 index = read<u32>();
+        [[maybe_unused]] u32 key = read<u32>();
+        if (index == ~0U)
+        {
+            return BufferHandle();
+        }
+
+        ASSERT(index < objects.size(), "out of range");
+        return BufferHandle(reinterpret_cast<RenderBuffer*>(objects[index]));
+    }
+
+    TextureView readTextureView(const std::vector<void*>& objects)
+    {
+        const Texture* texture = readObject<const Texture>(objects);
+        TextureView view(texture);
+        view._subresource = read<RenderTexture::Subresource>();
+        return view;
+    }
+
+    GeometryBufferDesc readGeometry(const std::vector<void*>& objects)
+    {
+        GeometryBufferDesc desc;
+        desc._indexBuffer = readBufferHandle(objects);
+        desc._indexOffset = read<u64>();
+        desc._indexType = read<IndexBufferType>();
+        desc._vertexBufferCount = read<u32>();
+        for (u32 i = 0; i < desc._vertexBufferCount; ++i)
+        {
+            desc._vertexBuffers[i] = readBufferHandle(objects);
+            desc._vertexOffsets[i] = read<u64>();
+            desc._vertexStrides[i] = read<u64>();
+        }
+
+        return desc;
+    }
+
+private:
+
+    const std::vector<u8>& m_stream;
+    u64                    m_offset;
+};
+
+static u32 hashPipelineState(const GraphicsPipelineState& state)
+{
+    u32 hash = crc32c::Crc32c(reinterpret_cast<const u8*>(&state.getPipelineStateDesc()), sizeof(GraphicsPipelineStateDesc));
+    return crc32c::Extend(hash, reinterpret_cast<const u8*>(&state.getRenderPassDesc()), sizeof(RenderPassDesc));
+}
+
+//Keys are made of the name and the description only, so they don't depend on the creation order and the loading threads
+template<typename T>
+static u32 extendKey(u32 key, const T& value)
+{
+    static_assert(std::is_standard_layout<T>(), "must be plain data");
+    return crc32c::Extend(key, reinterpret_cast<const u8*>(&value), sizeof(T));
+}
+
+static u32 makeKey(const std::string& name)
+{
+    return crc32c::Crc32c(reinterpret_cast<const u8*>(name.data()), name.size());
+}
+
+static u32 makeTextureKey(const std::string& name, TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, TextureUsageFlags flags)
+{
+    u32 key = makeKey(name);
+    key = extendKey(key, target);
+    key = extendKey(key, format);
+    key = extendKey(key, dimension);
+    key = extendKey(key, layers);
+    return extendKey(key, flags);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullDeviceCaps::NullDeviceCaps() noexcept
+{
+    for (u32 format = 0; format < Format::Format_Count; ++format)
+    {
+        for (u32 tiling = 0; tiling < TilingType::TilingType_Count; ++tiling)
+        {
+            _imageFormatSupport[format][tiling] = { true, true, true, true, true };
+        }
+    }
+
+    _supportMultiview = true;
+    _supportBlitImage = true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullTexture::NullTexture(u32 key, TextureUsageFlags flags) noexcept
+    : m_key(key)
+    , m_usageFlags(flags)
+{
+}
+
+NullTexture::~NullTexture()
+{
+}
+
+bool NullTexture::hasUsageFlag(TextureUsage usage) const
+{
+    return m_usageFlags & usage;
+}
+
+bool NullTexture::create()
+{
+    return true;
+}
+
+void NullTexture::destroy()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullBuffer::NullBuffer(u32 key, RenderBuffer::Type type, u16 usageFlag, u64 size) noexcept
+    : m_key(key)
+    , m_type(type)
+    , m_usageFlags(usageFlag)
+    , m_size(size)
+{
+}
+
+NullBuffer::~NullBuffer()
+{
+}
+
+bool NullBuffer::hasUsageFlag(BufferUsage usage) const
+{
+    return m_usageFlags & usage;
+}
+
+void* NullBuffer::map(u32 offset, u32 size)
+{
+    if (m_data.empty())
+    {
+        m_data.resize(m_size, 0);
+    }
+
+    u32 mapOffset = (offset == ~1) ? 0 : offset;
+    ASSERT(mapOffset < m_size, "out of range");
+    return m_data.data() + mapOffset;
+}
+
+void NullBuffer::unmap(u32 offset, u32 size)
+{
+}
+
+bool NullBuffer::create()
+{
+    return true;
+}
+
+void NullBuffer::destroy()
+{
+    m_data.clear();
+    m_data.shrink_to_fit();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullPipeline::NullPipeline(PipelineType type, u32 key, const void* state) noexcept
+    : RenderPipeline(type)
+    , m_key(key)
+    , m_state(state)
+{
+}
+
+NullPipeline::~NullPipeline()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullSampler::NullSampler(u32 key, const void* state) noexcept
+    : m_key(key)
+    , m_state(state)
+{
+}
+
+NullSampler::~NullSampler()
+{
+}
+
+bool NullSampler::create(const SamplerDesc& desc)
+{
+    return true;
+}
+
+void NullSampler::destroy()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullSwapchain::NullSwapchain(NullDevice* device, u32 key) noexcept
+    : m_device(*device)
+    , m_key(key)
+{
+}
+
+NullSwapchain::~NullSwapchain()
+{
+}
+
+bool NullSwapchain::create(const SwapchainParams& params)
+{
+    Format format = (params._format == Format::Format_Undefined) ? Format::Format_R8G8B8A8_UNorm : params._format;
+    TextureUsageFlags flags = TextureUsage::TextureUsage_Backbuffer | TextureUsage::TextureUsage_Attachment | TextureUsage::TextureUsage_Sampled | TextureUsage::TextureUsage_Read;
+    return Swapchain::setup(&m_device, format, params._size, flags);
+}
+
+void NullSwapchain::destroy()
+{
+    Swapchain::cleanup();
+}
+
+void NullSwapchain::beginFrame()
+{
+}
+
+void NullSwapchain::endFrame()
+{
+}
+
+void NullSwapchain::presentFrame(SyncPoint* sync)
+{
+    m_device.presentFrame();
+    ++m_frameCounter;
+}
+
+void NullSwapchain::resize(const math::Dimension2D& size)
+{
+    Swapchain::setup(&m_device, getBackbufferFormat(), size, getUsageFlags());
+}
+
+SyncPoint* NullSwapchain::getSyncPoint()
+{
+    return &m_syncPoint;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullCmdList::Statistics& NullCmdList::Statistics::operator+=(const Statistics& other)
+{
+    _commands += other._commands;
+    _draws += other._draws;
+    _pipelineSwitches += other._pipelineSwitches;
+    _descriptorBinds += other._descriptorBinds;
+    _renderTargets += other._renderTargets;
+    _uploads += other._uploads;
+    _uploadBytes += other._uploadBytes;
+
+    return *this;
+}
+
+u32 NullCmdList::Recording::hash() const
+{
+    return crc32c::Crc32c(_stream.data(), _stream.size());
+}
+
+void NullCmdList::Recording::clear()
+{
+    //Keeps the capacity, no allocations after the first frames
+    _stream.clear();
+    _objects.clear();
+    _statistics = {};
+}
+
+NullCmdList::NullCmdList(NullDevice& device) noexcept
+    : m_device(device)
+    , m_currentPipeline(nullptr)
+    , m_currentPipelineHash(0)
+{
+}
+
+NullCmdList::~NullCmdList()
+{
+}
+
+void NullCmdList::submit()
+{
+    std::swap(m_recording, m_submitted);
+    m_recording.clear();
+    m_objectIndices.clear();
+
+    m_currentPipeline = nullptr;
+    m_currentPipelineHash = 0;
+}
+
+void NullCmdList::writeCommand(Command command)
+{
+    m_recording._stream.push_back(toEnumType(command));
+    ++m_recording._statistics._commands;
+}
+
+template<typename T>
+void NullCmdList::write(const T& value)
+{
+    static_assert(std::is_standard_layout<T>(), "must be plain data");
+    const u8* bytes = reinterpret_cast<const u8*>(&value);
+    m_recording._stream.insert(m_recording._stream.end(), bytes, bytes + sizeof(T));
+}
+
+void NullCmdList::writeData(u32 size, const void* data)
+{
+    write<u32>(size);
+    const u8* bytes = reinterpret_cast<const u8*>(data);
+    m_recording._stream.insert(m_recording._stream.end(), bytes, bytes + size);
+}
+
+void NullCmdList::writeString(const std::string& string)
+{
+    writeData(static_cast<u32>(string.size()), string.data());
+}
+
+void NullCmdList::writeObject(const void* object, u32 key)
+{
+    auto found = m_objectIndices.emplace(object, static_cast<u32>(m_recording._objects.size()));
+    if (found.second)
+    {
+        m_recording._objects.push_back(const_cast<void*>(object));
+    }
+
+    write<u32>(found.first->second);
+    write<u32>(key);
+}
+
+void NullCmdList::writeTexture(const Texture* texture)
+{
+    ASSERT(texture, "nullptr");
+    u32 key = 0;
+    if (texture->hasUsageFlag(TextureUsage::TextureUsage_Backbuffer))
+    {
+        key = static_cast<NullSwapchain*>(texture->getTextureHandle().as<Swapchain>())->getKey();
+    }
+    else
+    {
+        key = static_cast<NullTexture*>(texture->getTextureHandle().as<RenderTexture>())->getKey();
+    }
+
+    writeObject(texture, key);
+}
+
+void NullCmdList::writeBuffer(const Buffer* buffer)
+{
+    ASSERT(buffer, "nullptr");
+    writeObject(buffer, static_cast<NullBuffer*>(buffer->getBufferHandle().as<RenderBuffer>())->getKey());
+}
+
+void NullCmdList::writeBufferHandle(const BufferHandle& handle)
+{
+    if (!handle.isValid())
+    {
+        write<u32>(~0U);
+        write<u32>(~0U);
+        return;
+    }
+
+    NullBuffer* buffer = static_cast<NullBuffer*>(handle.as<RenderBuffer>());
+    writeObject(static_cast<RenderBuffer*>(buffer), buffer->getKey());
+}
+
+void NullCmdList::writeTextureView(const TextureView& view)
+{
+    writeTexture(view._texture);
+    write(view._subresource);
+}
+
+void NullCmdList::transition(const TextureView& textureView, TransitionOp state)
+{
+    writeCommand(Command::Transition);
+    writeTextureView(textureView);
+    write(state);
+}
+
+void NullCmdList::bindDescriptorSet(const ShaderProgram* program, u32 set, const std::vector<Descriptor>& descriptors)
+{
+    ASSERT(set < m_device.getDeviceCaps()._maxDescriptorSets, "set out of range");
+    for (const Descriptor& desc : descriptors)
+    {
+        if (desc._binding == k_invalidBinding)
+        {
+            writeCommand(Command::InvalidateDescriptorSet);
+            writeObject(program, 0);
+            write<u32>(set);
+            continue;
+        }
+
+        switch (desc._type)
+        {
+        case Descriptor::Type::Descriptor_ConstantBuffer:
+        {
+            const Descriptor::ConstantBuffer& CBO = std::get<Descriptor::Type::Descriptor_ConstantBuffer>(desc._resource);
+            NullCmdList::bindConstantBuffer(program, set, desc._binding, CBO._size, CBO._data);
+            break;
+        }
+
+        case Descriptor::Type::Descriptor_TextureSampled:
+        {
+            const TextureView& view = std::get<Descriptor::Type::Descriptor_TextureSampled>(desc._resource);
+            NullCmdList::bindTexture(program, set, desc._binding, view);
+            break;
+        }
+
+        case Descriptor::Type::Descriptor_RWTexture:
+        {
+            Texture* texture = std::get<Descriptor::Type::Descriptor_RWTexture>(desc._resource);
+            NullCmdList::bindUAV(program, set, desc._binding, texture);
+            break;
+        }
+
+        case Descriptor::Type::Descriptor_RWBuffer:
+        {
+            Buffer* buffer = std::get<Descriptor::Type::Descriptor_RWBuffer>(desc._resource);
+            NullCmdList::bindUAV(program, set, desc._binding, buffer);
+            break;
+        }
+
+        case Descriptor::Type::Descriptor_Sampler:
+        {
+            SamplerState* sampler = std::get<Descriptor::Type::Descriptor_Sampler>(desc._resource);
+            NullCmdList::bindSampler(program, set, desc._binding, *sampler);
+            break;
+        }
+
+        default:
+            ASSERT(false, "unknow type");
+        }
+    }
+}
+
+void NullCmdList::bindTexture(const ShaderProgram* program, u32 set, u32 binding, const TextureView& textureView)
+{
+    writeCommand(Command::BindTexture);
+    writeObject(program, 0);
+    write<u32>(set);
+    write<u32>(binding);
+    writeTextureView(textureView);
+    ++m_recording._statistics._descriptorBinds;
+}
+
+void NullCmdList::bindSampler(const ShaderProgram* program, u32 set, u32 binding, const SamplerState& sampler)
+{
+    NullSampler* nullSampler = m_device.acquireSampler(sampler);
+    const_cast<SamplerState&>(sampler).m_tracker.attach(nullSampler);
+
+    writeCommand(Command::BindSampler);
+    writeObject(program, 0);
+    write<u32>(set);
+    write<u32>(binding);
+    writeObject(&sampler, nullSampler->getKey());
+    write(sampler.getSamplerDesc());
+    ++m_recording._statistics._descriptorBinds;
+}
+
+void NullCmdList::bindUAV(const ShaderProgram* program, u32 set, u32 binding, Buffer* buffer)
+{
+    writeCommand(Command::BindUAVBuffer);
+    writeObject(program, 0);
+    write<u32>(set);
+    write<u32>(binding);
+    writeBuffer(buffer);
+    ++m_recording._statistics._descriptorBinds;
+}
+
+void NullCmdList::bindUAV(const ShaderProgram* program, u32 set, u32 binding, Texture* texture)
+{
+    writeCommand(Command::BindUAVTexture);
+    writeObject(program, 0);
+    write<u32>(set);
+    write<u32>(binding);
+    writeTexture(texture);
+    ++m_recording._statistics._descriptorBinds;
+}
+
+void NullCmdList::bindConstantBuffer(const ShaderProgram* program, u32 set, u32 binding, u32 size, const void* data)
+{
+    writeCommand(Command::BindConstantBuffer);
+    writeObject(program, 0);
+    write<u32>(set);
+    write<u32>(binding);
+    writeData(size, data);
+    ++m_recording._statistics._descriptorBinds;
+}
+
+void NullCmdList::bindPushConstant(ShaderType type, u32 size, const void* data)
+{
+    writeCommand(Command::BindPushConstant);
+    write(type);
+    writeData(size, data);
+    ++m_recording._statistics._descriptorBinds;
+}
+
+void NullCmdList::insertDebugMarker(const std::string& marker, const color::Color& color)
+{
+    writeCommand(Command::InsertDebugMarker);
+    writeString(marker);
+    write(color);
+}
+
+void NullCmdList::beginDebugMarker(const std::string& marker, const color::Color& color)
+{
+    writeCommand(Command::BeginDebugMarker);
+    writeString(marker);
+    write(color);
+}
+
+void NullCmdList::endDebugMarker(const std::string& marker)
+{
+    writeCommand(Command::EndDebugMarker);
+    writeString(marker);
+}
+
+void NullCmdList::copy(Texture* src, Texture* dst, const math::Dimension3D& size)
+{
+    writeCommand(Command::CopyTexture);
+    writeTexture(src);
+    writeTexture(dst);
+    write(size);
+}
+
+void NullCmdList::copy(const TextureView& src, const TextureView& dst, const math::Dimension3D& size)
+{
+    writeCommand(Command::CopyTextureView);
+    writeTextureView(src);
+    writeTextureView(dst);
+    write(size);
+}
+
+void NullCmdList::copy(Buffer* src, u32 srcOffset, Buffer* dst, u32 dstOffset, u32 size)
+{
+    writeCommand(Command::CopyBuffer);
+    writeBuffer(src);
+    write<u32>(srcOffset);
+    writeBuffer(dst);
+    write<u32>(dstOffset);
+    write<u32>(size);
+}
+
+void NullCmdList::setPipelineState(ComputePipelineState& pipeline)
+{
+    NullPipeline* nullPipeline = m_device.acquirePipeline(&pipeline, RenderPipeline::PipelineType::PipelineType_Compute, pipeline.getName());
+    pipeline.m_tracker.attach(nullPipeline);
+
+    writeCommand(Command::SetComputePipeline);
+    writeObject(&pipeline, nullPipeline->getKey());
+
+    if (m_currentPipeline != &pipeline)
+    {
+        m_currentPipeline = &pipeline;
+        m_currentPipelineHash = 0;
+        ++m_recording._statistics._pipelineSwitches;
+    }
+}
+
+void NullCmdList::setViewport(const math::Rect& viewport, const math::float2& depth)
+{
+    writeCommand(Command::SetViewport);
+    write(viewport);
+    write(depth);
+}
+
+void NullCmdList::setScissor(const math::Rect& scissor)
+{
+    writeCommand(Command::SetScissor);
+    write(scissor);
+}
+
+void NullCmdList::setStencilRef(u32 mask)
+{
+    writeCommand(Command::SetStencilRef);
+    write<u32>(mask);
+}
+
+void NullCmdList::beginRenderTarget(RenderTargetState& rendertarget)
+{
+    const RenderPassDesc& renderpassDesc = rendertarget.getRenderPassDesc();
+    const FramebufferDesc& framebufferDesc = rendertarget.getFramebufferDesc();
+
+    writeCommand(Command::BeginRenderTarget);
+    writeObject(&rendertarget, 0);
+    write(renderpassDesc);
+    for (u32 index = 0; index < rendertarget.getColorTextureCount(); ++index)
+    {
+        writeTextureView(framebufferDesc._imageViews[index]);
+        write(framebufferDesc._clearColorValues[index]);
+    }
+
+    if (rendertarget.hasDepthStencilTexture())
+    {
+        writeTextureView(framebufferDesc._imageViews.back());
+        write(framebufferDesc._clearDepthValue);
+        write(framebufferDesc._clearStencilValue);
+    }
+    write(framebufferDesc._renderArea);
+
+    ++m_recording._statistics._renderTargets;
+}
+
+void NullCmdList::endRenderTarget()
+{
+    writeCommand(Command::EndRenderTarget);
+}
+
+void NullCmdList::setPipelineState(GraphicsPipelineState& pipeline)
+{
+    NullPipeline* nullPipeline = m_device.acquirePipeline(&pipeline, RenderPipeline::PipelineType::PipelineType_Graphic, pipeline.getName());
+    pipeline.m_tracker.attach(nullPipeline);
+
+    u32 descHash = hashPipelineState(pipeline);
+    writeCommand(Command::SetGraphicsPipeline);
+    writeObject(&pipeline, nullPipeline->getKey());
+    write<u32>(descHash);
+
+    if (m_currentPipeline != &pipeline || m_currentPipelineHash != descHash)
+    {
+        m_currentPipeline = &pipeline;
+        m_currentPipelineHash = descHash;
+        ++m_recording._statistics._pipelineSwitches;
+    }
+}
+
+void NullCmdList::draw(const GeometryBufferDesc& desc, u32 firstVertex, u32 vertexCount, u32 firstInstance, u32 instanceCount)
+{
+    writeCommand(Command::Draw);
+    writeBufferHandle(desc._indexBuffer);
+    write<u64>(desc._indexOffset);
+    write(desc._indexType);
+    write<u32>(desc._vertexBufferCount);
+    for (u32 i = 0; i < desc._vertexBufferCount; ++i)
+    {
+        writeBufferHandle(desc._vertexBuffers[i]);
+        write<u64>(desc._vertexOffsets[i]);
+        write<u64>(desc._vertexStrides[i]);
+    }
+    write<u32>(firstVertex);
+    write<u32>(vertexCount);
+    write<u32>(firstInstance);
+    write<u32>(instanceCount);
+
+    ++m_recording._statistics._draws;
+}
+
+void NullCmdList::drawIndexed(const GeometryBufferDesc& desc, u32 firstIndex, u32 indexCount, u32 vertexOffest, u32 firstInstance, u32 instanceCount)
+{
+    writeCommand(Command::DrawIndexed);
+    writeBufferHandle(desc._indexBuffer);
+    write<u64>(desc._indexOffset);
+    write(desc._indexType);
+    write<u32>(desc._vertexBufferCount);
+    for (u32 i = 0; i < desc._vertexBufferCount; ++i)
+    {
+        writeBufferHandle(desc._vertexBuffers[i]);
+        write<u64>(desc._vertexOffsets[i]);
+        write<u64>(desc._vertexStrides[i]);
+    }
+    write<u32>(firstIndex);
+    write<u32>(indexCount);
+    write<u32>(vertexOffest);
+    write<u32>(firstInstance);
+    write<u32>(instanceCount);
+
+    ++m_recording._statistics._draws;
+}
+
+void NullCmdList::clear(Texture* texture, const color::Color& color)
+{
+    writeCommand(Command::ClearColor);
+    writeTexture(texture);
+    write(color);
+}
+
+void NullCmdList::clear(Texture* texture, f32 depth, u32 stencil)
+{
+    writeCommand(Command::ClearDepthStencil);
+    writeTexture(texture);
+    write<f32>(depth);
+    write<u32>(stencil);
+}
+
+void NullCmdList::clear(Buffer* buffer, u32 value)
+{
+    writeCommand(Command::ClearBuffer);
+    writeBuffer(buffer);
+    write<u32>(value);
+}
+
+bool NullCmdList::upload(Texture* texture, u32 sizeInBytes, const void* data)
+{
+    writeCommand(Command::UploadTexture);
+    writeTexture(texture);
+    writeData(sizeInBytes, data);
+
+    ++m_recording._statistics._uploads;
+    m_recording._statistics._uploadBytes += sizeInBytes;
+    return true;
+}
+
+bool NullCmdList::upload(Buffer* buffer, u32 offset, u32 sizeInBytes, const void* data)
+{
+    writeCommand(Command::UploadBuffer);
+    writeBuffer(buffer);
+    write<u32>(offset);
+    writeData(sizeInBytes, data);
+
+    ++m_recording._statistics._uploads;
+    m_recording._statistics._uploadBytes += sizeInBytes;
+    return true;
+}
+
+void NullCmdList::replay(const Recording& recording, CmdListRender* cmdList)
+{
+    ASSERT(cmdList, "nullptr");
+    const std::vector<void*>& objects = recording._objects;
+
+    StreamReader reader(recording._stream);
+    while (!reader.isEnd())
+    {
+        Command command = reader.read<Command>();
+        switch (command)
+        {
+        case Command::Transition:
+        {
+            TextureView view = reader.readTextureView(objects);
+            TransitionOp state = reader.read<TransitionOp>();
+            cmdList->transition(view, state);
+            break;
+        }
+
+        case Command::BindTexture:
+        {
+            const ShaderProgram* program = reader.readObject<const ShaderProgram>(objects);
+            u32 set = reader.read<u32>();
+            u32 binding = reader.read<u32>();
+            TextureView view = reader.readTextureView(objects);
+            cmdList->bindTexture(program, set, binding, view);
+            break;
+        }
+
+        case Command::BindSampler:
+        {
+            const ShaderProgram* program = reader.readObject<const ShaderProgram>(objects);
+            u32 set = reader.read<u32>();
+            u32 binding = reader.read<u32>();
+            const SamplerState* sampler = reader.readObject<const SamplerState>(objects);
+            reader.read<SamplerDesc>();
+            cmdList->bindSampler(program, set, binding, *sampler);
+            break;
+        }
+
+        case Command::BindUAVBuffer:
+        {
+            const ShaderProgram* program = reader.readObject<const ShaderProgram>(objects);
+            u32 set = reader.read<u32>();
+            u32 binding = reader.read<u32>();
+            Buffer* buffer = reader.readObject<Buffer>(objects);
+            cmdList->bindUAV(program, set, binding, buffer);
+            break;
+        }
+
+        case Command::BindUAVTexture:
+        {
+            const ShaderProgram* program = reader.readObject<const ShaderProgram>(objects);
+            u32 set = reader.read<u32>();
+            u32 binding = reader.read<u32>();
+            Texture* texture = reader.readObject<Texture>(objects);
+            cmdList->bindUAV(program, set, binding, texture);
+            break;
+        }
+
+        case Command::BindConstantBuffer:
+        {
+            const ShaderProgram* program = reader.readObject<const ShaderProgram>(objects);
+            u32 set = reader.read<u32>();
+            u32 binding = reader.read<u32>();
+            u32 size = 0;
+            const void* data = reader.readData(size);
+            cmdList->bindConstantBuffer(program, set, binding, size, data);
+            break;
+        }
+
+        case Command::BindPushConstant:
+        {
+            ShaderType type = reader.read<ShaderType>();
+            u32 size = 0;
+            const void* data = reader.readData(size);
+            cmdList->bindPushConstant(type, size, data);
+            break;
+        }
+
+        case Command::InvalidateDescriptorSet:
+        {
+            const ShaderProgram* program = reader.readObject<const ShaderProgram>(objects);
+            u32 set = reader.read<u32>();
+            Descriptor invalid(Descriptor::Type::Descriptor_ConstantBuffer);
+            invalid._binding = k_invalidBinding;
+            cmdList->bindDescriptorSet(program, set, { invalid });
+            break;
+        }
+
+        case Command::InsertDebugMarker:
+        {
+            std::string marker = reader.readString();
+            color::Color color = reader.read<color::Color>();
+            cmdList->insertDebugMarker(marker, color);
+            break;
+        }
+
+        case Command::BeginDebugMarker:
+        {
+            std::string marker = reader.readString();
+            color::Color color = reader.read<color::Color>();
+            cmdList->beginDebugMarker(marker, color);
+            break;
+        }
+
+        case Command::EndDebugMarker:
+        {
+            cmdList->endDebugMarker(reader.readString());
+            break;
+        }
+
+        case Command::CopyTexture:
+        {
+            Texture* src = reader.readObject<Texture>(objects);
+            Texture* dst = reader.readObject<Texture>(objects);
+            math::Dimension3D size = reader.read<math::Dimension3D>();
+            cmdList->copy(src, dst, size);
+            break;
+        }
+
+        case Command::CopyTextureView:
+        {
+            TextureView src = reader.readTextureView(objects);
+            TextureView dst = reader.readTextureView(objects);
+            math::Dimension3D size = reader.read<math::Dimension3D>();
+            cmdList->copy(src, dst, size);
+            break;
+        }
+
+        case Command::CopyBuffer:
+        {
+            Buffer* src = reader.readObject<Buffer>(objects);
+            u32 srcOffset = reader.read<u32>();
+            Buffer* dst = reader.readObject<Buffer>(objects);
+            u32 dstOffset = reader.read<u32>();
+            u32 size = reader.read<u32>();
+            cmdList->copy(src, srcOffset, dst, dstOffset, size);
+            break;
+        }
+
+        case Command::SetComputePipeline:
+        {
+            ComputePipelineState* pipeline = reader.readObject<ComputePipelineState>(objects);
+            static_cast<CmdListCompute*>(cmdList)->setPipelineState(*pipeline);
+            break;
+        }
+
+        case Command::SetViewport:
+        {
+            math::Rect viewport = reader.read<math::Rect>();
+            math::float2 depth = reader.read<math::float2>();
+            cmdList->setViewport(viewport, depth);
+            break;
+        }
+
+        case Command::SetScissor:
+        {
+            cmdList->setScissor(reader.read<math::Rect>());
+            break;
+        }
+
+        case Command::SetStencilRef:
+        {
+            cmdList->setStencilRef(reader.read<u32>());
+            break;
+        }
+
+        case Command::BeginRenderTarget:
+        {
+            RenderTargetState* rendertarget = reader.readObject<RenderTargetState>(objects);
+            RenderPassDesc renderpassDesc = reader.read<RenderPassDesc>();
+            for (u32 index = 0; index < renderpassDesc._countColorAttachment; ++index)
+            {
+                reader.readTextureView(objects);
+                reader.read<color::Color>();
+            }
+
+            if (renderpassDesc._hasDepthStencilAttachment)
+            {
+                reader.readTextureView(objects);
+                reader.read<f32>();
+                reader.read<u32>();
+            }
+            reader.read<math::Dimension2D>();
+
+            cmdList->beginRenderTarget(*rendertarget);
+            break;
+        }
+
+        case Command::EndRenderTarget:
+        {
+            cmdList->endRenderTarget();
+            break;
+        }
+
+        case Command::SetGraphicsPipeline:
+        {
+            GraphicsPipelineState* pipeline = reader.readObject<GraphicsPipelineState>(objects);
+            reader.read<u32>();
+            cmdList->setPipelineState(*pipeline);
+            break;
+        }
+
+        case Command::Draw:
+        {
+            GeometryBufferDesc desc = reader.readGeometry(objects);
+            u32 firstVertex = reader.read<u32>();
+            u32 vertexCount = reader.read<u32>();
+            u32 firstInstance = reader.read<u32>();
+            u32 instanceCount = reader.read<u32>();
+            cmdList->draw(desc, firstVertex, vertexCount, firstInstance, instanceCount);
+            break;
+        }
+
+        case Command::DrawIndexed:
+        {
+            GeometryBufferDesc desc = reader.readGeometry(objects);
+            u32 firstIndex = reader.read<u32>();
+            u32 indexCount = reader.read<u32>();
+            u32 vertexOffset = reader.read<u32>();
+            u32 firstInstance = reader.read<u32>();
+            u32 instanceCount = reader.read<u32>();
+            cmdList->drawIndexed(desc, firstIndex, indexCount, vertexOffset, firstInstance, instanceCount);
+            break;
+        }
+
+        case Command::ClearColor:
+        {
+            Texture* texture = reader.readObject<Texture>(objects);
+            color::Color color = reader.read<color::Color>();
+            cmdList->clear(texture, color);
+            break;
+        }
+
+        case Command::ClearDepthStencil:
+        {
+            Texture* texture = reader.readObject<Texture>(objects);
+            f32 depth = reader.read<f32>();
+            u32 stencil = reader.read<u32>();
+            cmdList->clear(texture, depth, stencil);
+            break;
+        }
+
+        case Command::ClearBuffer:
+        {
+            Buffer* buffer = reader.readObject<Buffer>(objects);
+            u32 value = reader.read<u32>();
+            cmdList->clear(buffer, value);
+            break;
+        }
+
+        case Command::UploadTexture:
+        {
+            Texture* texture = reader.readObject<Texture>(objects);
+            u32 size = 0;
+            const void* data = reader.readData(size);
+            cmdList->upload(texture, size, data);
+            break;
+        }
+
+        case Command::UploadBuffer:
+        {
+            Buffer* buffer = reader.readObject<Buffer>(objects);
+            u32 offset = reader.read<u32>();
+            u32 size = 0;
+            const void* data = reader.readData(size);
+            cmdList->upload(buffer, offset, size, data);
+            break;
+        }
+
+        default:
+            ASSERT(false, "unknown command");
+            return;
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NullDevice::NullDevice(DeviceMaskFlags mask) noexcept
+    : m_deviceMask(mask)
+    , m_pendingHash(0)
+    , m_frameHash(0)
+    , m_frameCount(0)
+    , m_capturing(false)
+{
+    LOG_DEBUG("NullDevice::NullDevice constructor %llx", this);
+    m_renderType = RenderType::Empty;
+}
+
+NullDevice::~NullDevice()
+{
+    LOG_DEBUG("NullDevice::~NullDevice destructor %llx", this);
+    ASSERT(m_cmdLists.empty(), "must be empty");
+    ASSERT(m_pipelines.empty() && m_samplers.empty(), "must be empty");
+}
+
+const DeviceCaps& NullDevice::getDeviceCaps() const
+{
+    return m_deviceCaps;
+}
+
+bool NullDevice::initialize()
+{
+    LOG_INFO("NullDevice::initialize: commands are recorded only, nothing is executed");
+    return true;
+}
+
+void NullDevice::destroy()
+{
+    for (NullCmdList* cmdList : m_cmdLists)
+    {
+        V3D_DELETE(cmdList, memory::MemoryLabel::MemoryRenderCore);
+    }
+    m_cmdLists.clear();
+}
+
+void NullDevice::submit(CmdList* cmd, bool wait)
+{
+    NullDevice::submit(cmd, nullptr, wait);
+}
+
+void NullDevice::submit(CmdList* cmd, SyncPoint* sync, bool wait)
+{
+    ASSERT(cmd, "nullptr");
+    NullCmdList* cmdList = static_cast<NullCmdList*>(cmd);
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        u32 hash = cmdList->getRecording().hash();
+        m_pendingHash = crc32c::Extend(m_pendingHash, reinterpret_cast<const u8*>(&hash), sizeof(u32));
+        m_pendingStatistics += cmdList->getRecording()._statistics;
+
+        if (m_capturing)
+        {
+            m_pendingCapture.push_back(cmdList->getRecording());
+        }
+    }
+
+    cmdList->submit();
+}
+
+void NullDevice::waitGPUCompletion(CmdList* cmd)
+{
+}
+
+CmdList* NullDevice::createCommandList_Impl(DeviceMask queueType)
+{
+    ASSERT(m_deviceMask & queueType, "queue is not supported");
+    NullCmdList* cmdList = V3D_NEW(NullCmdList, memory::MemoryLabel::MemoryRenderCore)(*this);
+
+    std::lock_guard lock(m_mutex);
+    m_cmdLists.push_back(cmdList);
+    return cmdList;
+}
+
+void NullDevice::destroyCommandList(CmdList* cmd)
+{
+    NullCmdList* cmdList = static_cast<NullCmdList*>(cmd);
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto found = std::find(m_cmdLists.begin(), m_cmdLists.end(), cmdList);
+        ASSERT(found != m_cmdLists.end(), "not found");
+        m_cmdLists.erase(found);
+    }
+
+    V3D_DELETE(cmdList, memory::MemoryLabel::MemoryRenderCore);
+}
+
+Swapchain* NullDevice::createSwapchain(platform::Window* window, const Swapchain::SwapchainParams& params)
+{
+    u32 key = makeKey("swapchain");
+    key = extendKey(key, params._size);
+    key = extendKey(key, params._format);
+    key = extendKey(key, params._countSwapchainImages);
+    NullSwapchain* swapchain = V3D_NEW(NullSwapchain, memory::MemoryLabel::MemoryRenderCore)(this, key);
+    if (!swapchain->create(params))
+    {
+        swapchain->destroy();
+        V3D_DELETE(swapchain, memory::MemoryLabel::MemoryRenderCore);
+
+        return nullptr;
+    }
+
+    return swapchain;
+}
+
+void NullDevice::destroySwapchain(Swapchain* swapchain)
+{
+    NullSwapchain* nullSwapchain = static_cast<NullSwapchain*>(swapchain);
+    nullSwapchain->destroy();
+    V3D_DELETE(nullSwapchain, memory::MemoryLabel::MemoryRenderCore);
+}
+
+u32 NullDevice::getFramesInFlight() const
+{
+    return Swapchain::SwapchainParams()._countSwapchainImages;
+}
+
+SyncPoint* NullDevice::createSyncPoint(CmdList* cmd)
+{
+    return V3D_NEW(NullSyncPoint, memory::MemoryLabel::MemoryRenderCore)();
+}
+
+void NullDevice::destroySyncPoint(CmdList* cmd, SyncPoint* sync)
+{
+    NullSyncPoint* syncPoint = static_cast<NullSyncPoint*>(sync);
+    V3D_DELETE(syncPoint, memory::MemoryLabel::MemoryRenderCore);
+}
+
+bool NullDevice::compilePipeline(GraphicsPipelineState& state)
+{
+    NullPipeline* nullPipeline = NullDevice::acquirePipeline(&state, RenderPipeline::PipelineType::PipelineType_Graphic, state.getName());
+    state.m_tracker.attach(nullPipeline);
+    return true;
+}
+
+bool NullDevice::compilePipeline(ComputePipelineState& state)
+{
+    NullPipeline* nullPipeline = NullDevice::acquirePipeline(&state, RenderPipeline::PipelineType::PipelineType_Compute, state.getName());
+    state.m_tracker.attach(nullPipeline);
+    return true;
+}
+
+u32 NullDevice::registerBindlessTexture(const TextureView& texture)
+{
+    //Bindless isn't reported by the caps
+    return k_invalidBindlessIndex;
+}
+
+void NullDevice::unregisterBindlessTexture(u32 index)
+{
+}
+
+u32 NullDevice::registerBindlessBuffer(Buffer* buffer)
+{
+    return k_invalidBindlessIndex;
+}
+
+void NullDevice::unregisterBindlessBuffer(u32 index)
+{
+}
+
+TextureHandle NullDevice::createTexture(TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, u32 mipmapLevel, TextureUsageFlags flags, const std::string& name)
+{
+    u32 key = makeTextureKey(name, target, format, dimension, layers, flags);
+    key = extendKey(key, mipmapLevel);
+    NullTexture* texture = V3D_NEW(NullTexture, memory::MemoryLabel::MemoryRenderCore)(key, flags);
+    return TextureHandle((RenderTexture*)texture);
+}
+
+TextureHandle NullDevice::createTexture(TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, TextureSamples samples, TextureUsageFlags flags, const std::string& name)
+{
+    u32 key = makeTextureKey(name, target, format, dimension, layers, flags);
+    key = extendKey(key, samples);
+    NullTexture* texture = V3D_NEW(NullTexture, memory::MemoryLabel::MemoryRenderCore)(key, flags);
+    return TextureHandle((RenderTexture*)texture);
+}
+
+void NullDevice::destroyTexture(TextureHandle texture)
+{
+    ASSERT(texture.isValid(), "nullptr");
+    NullTexture* nullTexture = static_cast<NullTexture*>(texture.as<RenderTexture>());
+    nullTexture->destroy();
+    V3D_DELETE(nullTexture, memory::MemoryLabel::MemoryRenderCore);
+}
+
+BufferHandle NullDevice::createBuffer(RenderBuffer::Type type, u16 usageFlag, u64 size, const std::string& name)
+{
+    u32 key = makeKey(name);
+    key = extendKey(key, type);
+    key = extendKey(key, usageFlag);
+    key = extendKey(key, size);
+    NullBuffer* buffer = V3D_NEW(NullBuffer, memory::MemoryLabel::MemoryRenderCore)(key, type, usageFlag, size);
+    return BufferHandle((RenderBuffer*)buffer);
+}
+
+void NullDevice::destroyBuffer(BufferHandle buffer)
+{
+    ASSERT(buffer.isValid(), "nullptr");
+    NullBuffer* nullBuffer = static_cast<NullBuffer*>(buffer.as<RenderBuffer>());
+    nullBuffer->destroy();
+    V3D_DELETE(nullBuffer, memory::MemoryLabel::MemoryRenderCore);
+}
+
+void NullDevice::destroyFramebuffer(Framebuffer* framebuffer)
+{
+    //Render targets are recorded by the attachments, framebuffers are never created
+    ASSERT(false, "not used");
+}
+
+void NullDevice::destroyRenderpass(RenderPass* renderpass)
+{
+    //Render targets are recorded by the attachments, renderpasses are never created
+    ASSERT(false, "not used");
+}
+
+NullPipeline* NullDevice::acquirePipeline(const void* state, RenderPipeline::PipelineType type, const std::string& name)
+{
+    std::lock_guard lock(m_mutex);
+
+    auto found = m_pipelines.emplace(state, nullptr);
+    if (found.second)
+    {
+        //The description can be changed after the compilation, it's hashed on every bind
+        found.first->second = V3D_NEW(NullPipeline, memory::MemoryLabel::MemoryRenderCore)(type, extendKey(makeKey(name), type), state);
+    }
+
+    return found.first->second;
+}
+
+void NullDevice::destroyPipeline(RenderPipeline* pipeline)
+{
+    NullPipeline* nullPipeline = static_cast<NullPipeline*>(pipeline);
+    {
+        std::lock_guard lock(m_mutex);
+        m_pipelines.erase(nullPipeline->m_state);
+    }
+
+    V3D_DELETE(nullPipeline, memory::MemoryLabel::MemoryRenderCore);
+}
+
+NullSampler* NullDevice::acquireSampler(const SamplerState& state)
+{
+    std::lock_guard lock(m_mutex);
+
+    auto found = m_samplers.emplace(&state, nullptr);
+    if (found.second)
+    {
+        found.first->second = V3D_NEW(NullSampler, memory::MemoryLabel::MemoryRenderCore)(extendKey(makeKey("sampler"), state.getSamplerDesc()), &state);
+        found.first->second->create(state.getSamplerDesc());
+    }
+
+    return found.first->second;
+}
+
+void NullDevice::destroySampler(Sampler* sampler)
+{
+    NullSampler* nullSampler = static_cast<NullSampler*>(sampler);
+    {
+        std::lock_guard lock(m_mutex);
+        m_samplers.erase(nullSampler->m_state);
+    }
+
+    nullSampler->destroy();
+    V3D_DELETE(nullSampler, memory::MemoryLabel::MemoryRenderCore);
+}
+
+void NullDevice::presentFrame()
+{
+    std::lock_guard lock(m_mutex);
+
+    m_frameStatistics = m_pendingStatistics;
+    m_frameHash = m_pendingHash;
+    ++m_frameCount;
+
+    m_pendingStatistics = {};
+    m_pendingHash = 0;
+
+    if (m_capturing)
+    {
+        m_capturedFrame = std::move(m_pendingCapture);
+        m_pendingCapture.clear();
+        m_capturing = false;
+    }
+}
+
+void NullDevice::captureFrame()
+{
+    std::lock_guard lock(m_mutex);
+
+    m_pendingCapture.clear();
+    m_capturing = true;
+}
+
+} //namespace null
+} //namespace renderer
+} //namespace v3d
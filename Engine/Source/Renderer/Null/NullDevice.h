@@ -0,0 +1,517 @@
+#pragma once
+
+#include "Renderer/Device.h"
+#include "Renderer/Pipeline.h"
+#include "Thread/Spinlock.h"
+
+namespace v3d
+{
+namespace renderer
+{
+namespace null
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    class NullDevice;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullDeviceCaps struct. Every format is supported
+    */
+    struct NullDeviceCaps final : DeviceCaps
+    {
+        NullDeviceCaps() noexcept;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullTexture class. Render side.
+    * Has no memory, only the description and the key
+    */
+    class NullTexture final : public RenderTexture
+    {
+    public:
+
+        explicit NullTexture(u32 key, TextureUsageFlags flags) noexcept;
+        ~NullTexture();
+
+        bool hasUsageFlag(TextureUsage usage) const override;
+
+        /**
+        * @brief getKey. Hash of the name and the description, stays the same between runs regardless of the creation order.
+        * Objects with the same description share the key, the recording tells them apart by the object index
+        */
+        u32 getKey() const;
+
+    private:
+
+        bool create() override;
+        void destroy() override;
+
+        const u32               m_key;
+        const TextureUsageFlags m_usageFlags;
+
+        friend NullDevice;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullBuffer class. Render side.
+    * CPU memory is allocated on the first map only
+    */
+    class NullBuffer final : public RenderBuffer
+    {
+    public:
+
+        explicit NullBuffer(u32 key, RenderBuffer::Type type, u16 usageFlag, u64 size) noexcept;
+        ~NullBuffer();
+
+        bool hasUsageFlag(BufferUsage usage) const override;
+
+        void* map(u32 offset = ~1, u32 size = ~1) override;
+        void unmap(u32 offset = ~1, u32 size = ~1) override;
+
+        u32 getKey() const;
+
+    private:
+
+        bool create() override;
+        void destroy() override;
+
+        const u32                m_key;
+        const RenderBuffer::Type m_type;
+        const u16                m_usageFlags;
+        const u64                m_size;
+        std::vector<u8>          m_data;
+
+        friend NullDevice;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullPipeline class. Render side.
+    * One per pipeline state, lives while the state is alive. The description is hashed on every bind, the state can be changed
+    */
+    class NullPipeline final : public RenderPipeline
+    {
+    public:
+
+        explicit NullPipeline(PipelineType type, u32 key, const void* state) noexcept;
+        ~NullPipeline();
+
+        u32 getKey() const;
+
+    private:
+
+        const u32   m_key;
+        const void* m_state;
+
+        friend NullDevice;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullSampler class. Render side.
+    * One per sampler state, lives while the state is alive
+    */
+    class NullSampler final : public Sampler
+    {
+    public:
+
+        explicit NullSampler(u32 key, const void* state) noexcept;
+        ~NullSampler();
+
+        u32 getKey() const;
+
+    private:
+
+        bool create(const SamplerDesc& desc) override;
+        void destroy() override;
+
+        const u32   m_key;
+        const void* m_state;
+
+        friend NullDevice;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullSyncPoint class
+    */
+    class NullSyncPoint final : public SyncPoint
+    {
+    public:
+
+        NullSyncPoint() = default;
+        ~NullSyncPoint() = default;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullSwapchain class. Presenting closes the frame statistics of the device
+    */
+    class NullSwapchain final : public Swapchain
+    {
+    public:
+
+        explicit NullSwapchain(NullDevice* device, u32 key) noexcept;
+        ~NullSwapchain();
+
+        bool create(const SwapchainParams& params);
+        void destroy();
+
+        void beginFrame() override;
+        void endFrame() override;
+        void presentFrame(SyncPoint* sync = nullptr) override;
+        void resize(const math::Dimension2D& size) override;
+        SyncPoint* getSyncPoint() override;
+
+        u32 getKey() const;
+
+    private:
+
+        NullDevice&     m_device;
+        const u32       m_key;
+        NullSyncPoint   m_syncPoint;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullCmdList class. Executes nothing.
+    * Records the commands to a compact byte stream: the command id and a plain payload.
+    * Objects are written as the index in the objects table of the recording plus the device key, inline data is copied.
+    * The stream doesn't contain pointers, so the hash of the same frame is the same between runs and engine versions
+    */
+    class NullCmdList final : public CmdListRender
+    {
+    public:
+
+        /**
+        * @brief Command enum
+        */
+        enum class Command : u8
+        {
+            Transition,
+            BindTexture,
+            BindSampler,
+            BindUAVBuffer,
+            BindUAVTexture,
+            BindConstantBuffer,
+            BindPushConstant,
+            InvalidateDescriptorSet,
+            InsertDebugMarker,
+            BeginDebugMarker,
+            EndDebugMarker,
+            CopyTexture,
+            CopyTextureView,
+            CopyBuffer,
+            SetComputePipeline,
+            SetViewport,
+            SetScissor,
+            SetStencilRef,
+            BeginRenderTarget,
+            EndRenderTarget,
+            SetGraphicsPipeline,
+            Draw,
+            DrawIndexed,
+            ClearColor,
+            ClearDepthStencil,
+            ClearBuffer,
+            UploadTexture,
+            UploadBuffer,
+
+            Count
+        };
+
+        /**
+        * @brief Statistics struct
+        */
+        struct Statistics
+        {
+            u32 _commands = 0;
+            u32 _draws = 0;
+            u32 _pipelineSwitches = 0;
+            u32 _descriptorBinds = 0;
+            u32 _renderTargets = 0;
+            u32 _uploads = 0;
+            u64 _uploadBytes = 0;
+
+            Statistics& operator+=(const Statistics& other);
+        };
+
+        /**
+        * @brief Recording struct. Command stream and the objects it refers to
+        */
+        struct Recording
+        {
+            std::vector<u8>     _stream;
+            std::vector<void*>  _objects;
+            Statistics          _statistics;
+
+            /**
+            * @brief hash. CRC32 of the stream
+            */
+            u32 hash() const;
+            void clear();
+        };
+
+        explicit NullCmdList(NullDevice& device) noexcept;
+        ~NullCmdList();
+
+        void transition(const TextureView& textureView, TransitionOp state) override;
+
+        void bindDescriptorSet(const ShaderProgram* program, u32 set, const std::vector<Descriptor>& descriptors) override;
+        void bindTexture(const ShaderProgram* program, u32 set, u32 binding, const TextureView& textureView) override;
+        void bindSampler(const ShaderProgram* program, u32 set, u32 binding, const SamplerState& sampler) override;
+        void bindUAV(const ShaderProgram* program, u32 set, u32 binding, Buffer* buffer) override;
+        void bindUAV(const ShaderProgram* program, u32 set, u32 binding, Texture* texture) override;
+        void bindConstantBuffer(const ShaderProgram* program, u32 set, u32 binding, u32 size, const void* data) override;
+        void bindPushConstant(ShaderType type, u32 size, const void* data) override;
+
+        void insertDebugMarker(const std::string& marker, const color::Color& color) override;
+        void beginDebugMarker(const std::string& marker, const color::Color& color) override;
+        void endDebugMarker(const std::string& marker) override;
+
+        void copy(Texture* src, Texture* dst, const math::Dimension3D& size) override;
+        void copy(const TextureView& src, const TextureView& dst, const math::Dimension3D& size) override;
+        void copy(Buffer* src, u32 srcOffset, Buffer* dst, u32 dstOffset, u32 size) override;
+
+        void setPipelineState(ComputePipelineState& pipeline) override;
+
+        void setViewport(const math::Rect& viewport, const math::float2& depth = { 0.0f, 1.0f }) override;
+        void setScissor(const math::Rect& scissor) override;
+        void setStencilRef(u32 mask) override;
+
+        void beginRenderTarget(RenderTargetState& rendertarget) override;
+        void endRenderTarget() override;
+
+        void setPipelineState(GraphicsPipelineState& pipeline) override;
+
+        void draw(const GeometryBufferDesc& desc, u32 firstVertex, u32 vertexCount, u32 firstInstance, u32 instanceCount) override;
+        void drawIndexed(const GeometryBufferDesc& desc, u32 firstIndex, u32 indexCount, u32 vertexOffest, u32 firstInstance, u32 instanceCount) override;
+
+        void clear(Texture* texture, const color::Color& color) override;
+        void clear(Texture* texture, f32 depth, u32 stencil) override;
+        void clear(Buffer* buffer, u32 value) override;
+
+        bool upload(Texture* texture, u32 sizeInBytes, const void* data) override;
+        bool upload(Buffer* buffer, u32 offset, u32 sizeInBytes, const void* data) override;
+
+        /**
+        * @brief getRecording. Commands recorded after the last submit
+        */
+        const Recording& getRecording() const;
+
+        /**
+        * @brief getSubmitted. Commands of the last submit, valid until the next one
+        */
+        const Recording& getSubmitted() const;
+
+        /**
+        * @brief replay. Issues the recorded commands to another command list of the same device.
+        * The objects of the recording must be alive
+        * @param const Recording& recording [required]
+        * @param CmdListRender* cmdList [required]
+        */
+        static void replay(const Recording& recording, CmdListRender* cmdList);
+
+    private:
+
+        friend NullDevice;
+
+        void submit();
+
+        void writeCommand(Command command);
+        template<typename T>
+        void write(const T& value);
+        void writeData(u32 size, const void* data);
+        void writeString(const std::string& string);
+        void writeObject(const void* object, u32 key);
+        void writeTexture(const Texture* texture);
+        void writeBuffer(const Buffer* buffer);
+        void writeBufferHandle(const BufferHandle& handle);
+        void writeTextureView(const TextureView& view);
+
+        NullDevice&                             m_device;
+        Recording                               m_recording;
+        Recording                               m_submitted;
+        std::unordered_map<const void*, u32>    m_objectIndices;
+        const void*                             m_currentPipeline;
+        u32                                     m_currentPipelineHash;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NullDevice class. Render side.
+    * Device without GPU, command lists record the commands only. Used to measure the CPU cost of the render code and compare command streams.
+    * Created by Device::createDevice(RenderType::Empty)
+    */
+    class NullDevice final : public Device
+    {
+    public:
+
+        explicit NullDevice(DeviceMaskFlags mask) noexcept;
+        ~NullDevice();
+
+        const DeviceCaps& getDeviceCaps() const override;
+
+        void submit(CmdList* cmd, bool wait = false) override;
+        void submit(CmdList* cmd, SyncPoint* sync, bool wait = false) override;
+        void waitGPUCompletion(CmdList* cmd) override;
+
+        void destroyCommandList(CmdList* cmd) override;
+
+        Swapchain* createSwapchain(platform::Window* window, const Swapchain::SwapchainParams& params) override;
+        void destroySwapchain(Swapchain* swapchain) override;
+        u32 getFramesInFlight() const override;
+
+        SyncPoint* createSyncPoint(CmdList* cmd) override;
+        void destroySyncPoint(CmdList* cmd, SyncPoint* sync) override;
+
+        bool compilePipeline(GraphicsPipelineState& state) override;
+        bool compilePipeline(ComputePipelineState& state) override;
+
+        u32 registerBindlessTexture(const TextureView& texture) override;
+        void unregisterBindlessTexture(u32 index) override;
+        u32 registerBindlessBuffer(Buffer* buffer) override;
+        void unregisterBindlessBuffer(u32 index) override;
+
+        TextureHandle createTexture(TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, u32 mipmapLevel, TextureUsageFlags flags, const std::string& name = "") override;
+        TextureHandle createTexture(TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, TextureSamples samples, TextureUsageFlags flags, const std::string& name = "") override;
+        void destroyTexture(TextureHandle texture) override;
+
+        BufferHandle createBuffer(RenderBuffer::Type type, u16 usageFlag, u64 size, const std::string& name = "") override;
+        void destroyBuffer(BufferHandle buffer) override;
+
+        void destroyFramebuffer(Framebuffer* framebuffer) override;
+        void destroyRenderpass(RenderPass* renderpass) override;
+        void destroyPipeline(RenderPipeline* pipeline) override;
+        void destroySampler(Sampler* sampler) override;
+
+        /**
+        * @brief getFrameStatistics. Sum of the command lists submitted during the last presented frame
+        */
+        const NullCmdList::Statistics& getFrameStatistics() const;
+
+        /**
+        * @brief getFrameHash. Hash of the command streams submitted during the last presented frame, in the submit order
+        */
+        u32 getFrameHash() const;
+
+        u64 getFrameCount() const;
+
+        /**
+        * @brief captureFrame. Copies the command streams submitted until the next present, in the submit order.
+        * The objects of the captured recordings must be alive to replay them
+        */
+        void captureFrame();
+
+        /**
+        * @brief getCapturedFrame. Recordings of the last captured frame
+        */
+        const std::vector<NullCmdList::Recording>& getCapturedFrame() const;
+
+    private:
+
+        friend NullCmdList;
+        friend NullSwapchain;
+
+        CmdList* createCommandList_Impl(DeviceMask queueType) override;
+
+        bool initialize() override;
+        void destroy() override;
+
+        NullPipeline* acquirePipeline(const void* state, RenderPipeline::PipelineType type, const std::string& name);
+        NullSampler* acquireSampler(const SamplerState& state);
+        void presentFrame();
+
+        NullDeviceCaps                                      m_deviceCaps;
+        DeviceMaskFlags                                     m_deviceMask;
+
+        thread::Spinlock                                    m_mutex;
+        std::vector<NullCmdList*>                           m_cmdLists;
+        std::unordered_map<const void*, NullPipeline*>      m_pipelines;
+        std::unordered_map<const void*, NullSampler*>       m_samplers;
+
+        NullCmdList::Statistics                             m_pendingStatistics;
+        u32                                                 m_pendingHash;
+        NullCmdList::Statistics                             m_frameStatistics;
+        u32                                                 m_frameHash;
+        u64                                                 m_frameCount;
+
+        bool                                                m_capturing;
+        std::vector<NullCmdList::Recording>                 m_pendingCapture;
+        std::vector<NullCmdList::Recording>                 m_capturedFrame;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    inline u32 NullTexture::getKey() const
+    {
+        return m_key;
+    }
+
+    inline u32 NullBuffer::getKey() const
+    {
+        return m_key;
+    }
+
+    inline u32 NullPipeline::getKey() const
+    {
+        return m_key;
+    }
+
+    inline u32 NullSampler::getKey() const
+    {
+        return m_key;
+    }
+
+    inline u32 NullSwapchain::getKey() const
+    {
+        return m_key;
+    }
+
+    inline const NullCmdList::Recording& NullCmdList::getRecording() const
+    {
+        return m_recording;
+    }
+
+    inline const NullCmdList::Recording& NullCmdList::getSubmitted() const
+    {
+        return m_submitted;
+    }
+
+    inline const NullCmdList::Statistics& NullDevice::getFrameStatistics() const
+    {
+        return m_frameStatistics;
+    }
+
+    inline u32 NullDevice::getFrameHash() const
+    {
+        return m_frameHash;
+    }
+
+    inline u64 NullDevice::getFrameCount() const
+    {
+        return m_frameCount;
+    }
+
+    inline const std::vector<NullCmdList::Recording>& NullDevice::getCapturedFrame() const
+    {
+        return m_capturedFrame;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace null
+} //namespace renderer
+} //namespace v3d
@@ -37,6 +37,27 @@ namespace renderer
     */
     constexpr u32 k_maxDescriptorSlotsCount = 8;
 
+    /**
+    * @brief k_bindlessDescriptorSet. The set is reserved for the global descriptor heap if the device supports bindless.
+    * Binding 0 is the array of the sampled textures, binding 1 is the array of the storage buffers
+    */
+    constexpr u32 k_bindlessDescriptorSet = k_maxDescriptorSetCount - 1;
+
+    /**
+    * @brief k_maxBindlessTextures. Upper limit of the textures in the descriptor heap
+    */
+    constexpr u32 k_maxBindlessTextures = 4096;
+
+    /**
+    * @brief k_maxBindlessBuffers. Upper limit of the buffers in the descriptor heap
+    */
+    constexpr u32 k_maxBindlessBuffers = 1024;
+
+    /**
+    * @brief k_invalidBindlessIndex
+    */
+    constexpr u32 k_invalidBindlessIndex = ~0U;
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
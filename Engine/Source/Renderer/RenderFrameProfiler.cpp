@@ -13,6 +13,7 @@ const std::string RenderFrameProfiler::s_frameCounterNames[] =
     "DrawCalls",
     "ComputerCalls",
     "Submit",
+    "GPUWait",
     "Present",
     "SetRenderTarget",
     "SetPipeline",
@@ -23,6 +24,11 @@ const std::string RenderFrameProfiler::s_frameCounterNames[] =
     "CreateResources",
     "RemoveResources",
     "Query",
+    "PipelineCacheHit",
+    "PipelineCacheMiss",
+    "PipelineCompileStall",
+    "PipelineBinds",
+    "DescriptorSetBinds",
     "Custom"
 };
 
@@ -115,6 +121,15 @@ void RenderFrameProfiler::stop(u32 slot, FrameCounter counter)
     }
 }
 
+void RenderFrameProfiler::add(u32 slot, FrameCounter counter, u64 calls)
+{
+    Metric& metric = m_metrics[slot][toEnumType(counter)];
+    if (metric._collectFlags & 0x1)
+    {
+        metric._calls += calls;
+    }
+}
+
 void RenderFrameProfiler::update(f32 dt)
 {
     m_frameTime += dt;
@@ -55,6 +55,11 @@ namespace renderer
             CreateResources,
             RemoveResources,
             QueryCommands,
+            PipelineCacheHit,
+            PipelineCacheMiss,
+            PipelineCompileStall,
+            PipelineBinds,      //Recorded to the command buffers, SetPipeline without the repeated pipelines
+            DescriptorSetBinds, //Recorded to the command buffers, BindResources without the repeated sets
             Custom,
 
             MaxValue
@@ -80,6 +85,11 @@ namespace renderer
         void start(u32 slot, FrameCounter counter);
         void stop(u32 slot, FrameCounter counter);
 
+        /**
+        * @brief add. Adds the calls counted outside of the profiler
+        */
+        void add(u32 slot, FrameCounter counter, u64 calls);
+
     private:
 
         void update(f32 dt) override;
@@ -31,11 +31,16 @@ namespace renderer
             u32                 _countSwapchainImages;
             bool                _vSync;
 
+            //Offscreen swapchain only (window without a native handle). Writes every N-th presented frame as PNG, 0 disables
+            std::string         _dumpDirectory;
+            u32                 _dumpInterval;
+
             SwapchainParams() noexcept
                 : _size({ 1024U, 768U })
                 , _format(Format::Format_Undefined)
                 , _countSwapchainImages(3U)
                 , _vSync(true)
+                , _dumpInterval(0U)
             {
             }
         };
@@ -2,6 +2,7 @@
 #include "Device.h"
 #include "Utils/Logger.h"
 #include "Stream/Stream.h"
+#include "Resource/ResourceManager.h"
 
 namespace v3d
 {
@@ -19,11 +20,13 @@ Texture::Texture(Device* const device, TextureTarget target, Format format, cons
     , m_layers(layers)
     , m_mipmaps(mipmaps)
     , m_usage(usage)
+    , m_bindlessIndex(k_invalidBindlessIndex)
 {
 }
 
 Texture::~Texture()
 {
+    ASSERT(m_bindlessIndex == k_invalidBindlessIndex, "must be unregistered");
 }
 
 bool Texture::load(const stream::Stream* stream, u32 offset)
@@ -46,22 +49,32 @@ bool Texture::load(const stream::Stream* stream, u32 offset)
     stream->read<u32>(m_mipmaps);
     stream->read<u32>(m_usage);
 
-    m_texture = m_device->createTexture(m_target, m_format, m_dimension, m_layers, m_mipmaps, m_usage, std::string(m_header.getName()));
-    ASSERT(m_texture.isValid(), "nullptr");
-
     u32 size = 0;
     stream->read<u32>(size);
-    if (size > 0)
-    {
-        void* ptr = stream->map(size);
-        renderer::CmdListRender* cmdList = m_device->createCommandList<renderer::CmdListRender>(renderer::Device::GraphicMask);
 
-        cmdList->upload(this, size, ptr);
-        m_device->submit(cmdList, true);
-
-        m_device->destroyCommandList(cmdList);
-        stream->unmap();
-    }
+    //The device is used by the main thread only, the async loading calls it from the loading threads
+    resource::ResourceManager::getLazyInstance()->executeOnUploadThread([this, stream, size]() -> void
+        {
+            m_texture = m_device->createTexture(m_target, m_format, m_dimension, m_layers, m_mipmaps, m_usage, std::string(m_header.getName()));
+            ASSERT(m_texture.isValid(), "nullptr");
+
+            if (size > 0)
+            {
+                void* ptr = stream->map(size);
+                renderer::CmdListRender* cmdList = m_device->createCommandList<renderer::CmdListRender>(renderer::Device::GraphicMask);
+
+                cmdList->upload(this, size, ptr);
+                m_device->submit(cmdList, true);
+
+                m_device->destroyCommandList(cmdList);
+                stream->unmap();
+            }
+
+            if (m_target == TextureTarget::Texture2D)
+            {
+                Texture::registerBindless();
+            }
+        });
     LOG_DEBUG("Texture::load: The stream has been read %d from %d bytes", stream->tell() - m_header._offset, m_header._size);
 
     m_loaded = true;
@@ -75,6 +88,37 @@ bool Texture::save(stream::Stream* stream, u32 offset) const
     return false;
 }
 
+void Texture::registerBindless()
+{
+    ASSERT(m_bindlessIndex == k_invalidBindlessIndex, "already registered");
+    if (!m_device->getDeviceCaps()._supportBindless)
+    {
+        return;
+    }
+
+    //Only the read only single layer textures match Texture2D t_Textures[] of the shaders
+    if (!hasUsageFlag(TextureUsage::TextureUsage_Sampled) || hasUsageFlag(TextureUsage::TextureUsage_Attachment) || hasUsageFlag(TextureUsage::TextureUsage_Storage)
+        || m_layers != 1 || m_samples != TextureSamples::TextureSamples_x1)
+    {
+        return;
+    }
+
+    m_bindlessIndex = m_device->registerBindlessTexture(TextureView(this));
+    if (m_bindlessIndex == k_invalidBindlessIndex)
+    {
+        LOG_WARNING("Texture::registerBindless: the descriptor heap is full, texture %llx is not registered", this);
+    }
+}
+
+void Texture::unregisterBindless()
+{
+    if (m_bindlessIndex != k_invalidBindlessIndex)
+    {
+        m_device->unregisterBindlessTexture(m_bindlessIndex);
+        m_bindlessIndex = k_invalidBindlessIndex;
+    }
+}
+
 Texture1D::Texture1D(Device* device, const TextureHeader& header) noexcept
     : Texture(device, TextureTarget::Texture1D, Format::Format_Undefined, {}, TextureSamples::TextureSamples_x1, 0, 0, 0)
 {
@@ -104,6 +148,8 @@ Texture2D::Texture2D(Device* device, TextureUsageFlags usage, Format format, con
 {
     m_texture = m_device->createTexture(TextureTarget::Texture2D, format, math::Dimension3D(dimension._width, dimension._height, 1), array, mipmaps, usage, name);
     ASSERT(m_texture.isValid(), "nullptr");
+
+    Texture::registerBindless();
 }
 
 Texture2D::Texture2D(Device* device, TextureUsageFlags usage, Format format, const math::Dimension2D& dimension, TextureSamples samples, const std::string& name) noexcept
@@ -111,11 +157,15 @@ Texture2D::Texture2D(Device* device, TextureUsageFlags usage, Format format, con
 {
     m_texture = m_device->createTexture(TextureTarget::Texture2D, format, math::Dimension3D(dimension._width, dimension._height, 1), 1, samples, usage, name);
     ASSERT(m_texture.isValid(), "nullptr");
+
+    Texture::registerBindless();
 }
 
 Texture2D::~Texture2D()
 {
     ASSERT(m_texture.isValid(), "nullptr");
+    //The index is reused after the GPU has finished the frames which could read the texture
+    Texture::unregisterBindless();
     m_device->destroyTexture(m_texture);
 }
 
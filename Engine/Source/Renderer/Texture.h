@@ -35,6 +35,7 @@ namespace renderer
             bool                        generateMipmaps = false;
             bool                        srgb = false;
             bool                        flipY = false;
+            resource::MipmapFilter      mipmapFilter = resource::MipmapFilter::Box;
         };
 
         /**
@@ -112,6 +113,12 @@ namespace renderer
         */
         bool hasUsageFlag(TextureUsage usage) const;
 
+        /**
+        * @brief getBindlessIndex method. The sampled 2D textures are written to the descriptor heap when they are created
+        * @return index in the descriptor heap or k_invalidBindlessIndex
+        */
+        u32 getBindlessIndex() const;
+
         /**
         * @brief Texture destructor
         */
@@ -127,6 +134,9 @@ namespace renderer
         bool load(const stream::Stream* stream, u32 offset = 0) override;
         bool save(stream::Stream* stream, u32 offset = 0) const override;
 
+        void registerBindless();
+        void unregisterBindless();
+
         TextureHeader           m_header;
         Device* const           m_device;
         TextureHandle           m_texture;
@@ -137,6 +147,7 @@ namespace renderer
         u32                     m_layers;
         u32                     m_mipmaps;
         TextureUsageFlags       m_usage;
+        u32                     m_bindlessIndex;
         SharedData              m_sharedData;
 
         friend RenderTargetState;
@@ -193,6 +204,11 @@ namespace renderer
         return m_usage & usage;
     }
 
+    inline u32 Texture::getBindlessIndex() const
+    {
+        return m_bindlessIndex;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
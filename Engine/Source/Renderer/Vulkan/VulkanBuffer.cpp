@@ -122,6 +122,11 @@ bool VulkanBuffer::create()
     {
         usageBuffer |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         memoryFlags |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        if (VulkanBuffer::hasUsageFlag(BufferUsage::Buffer_GPURead)) //readback
+        {
+            usageBuffer |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            memoryFlags |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        }
 
         break;
     }
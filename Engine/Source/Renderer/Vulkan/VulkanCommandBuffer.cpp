@@ -560,7 +560,7 @@ void VulkanCommandBuffer::cmdEndRendering(const RenderPassDesc& passDesc, const
         ASSERT(vkImage, "nullptr");
 
         VkImageLayout oldLayout = m_resourceStates.getLayout(vkImage, subresource);
-        VkImageLayout newLayout = VulkanTransitionState::convertTransitionStateToImageLayout(description._finalTransition);
+        VkImageLayout newLayout = VulkanSwapchain::selectPresentLayout(vkImage, VulkanTransitionState::convertTransitionStateToImageLayout(description._finalTransition));
         VulkanCommandBuffer::cmdPipelineBarrier(vkImage, subresource, oldLayout, newLayout);
     }
 
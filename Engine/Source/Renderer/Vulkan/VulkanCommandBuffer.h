@@ -91,6 +91,7 @@ namespace vk
         void cmdBindPipeline(VulkanGraphicPipeline* pipeline);
         void cmdBindPipeline(VulkanComputePipeline* pipeline);
         void cmdBindDescriptorSets(VulkanGraphicPipeline* pipeline, u32 first, const std::vector<VkDescriptorSet>& sets, const std::vector<u32>& offsets);
+        void cmdBindDescriptorSets(VulkanGraphicPipeline* pipeline, u32 first, u32 count, const VkDescriptorSet* sets, const std::vector<u32>& offsets);
         void cmdBindDescriptorSets(VulkanComputePipeline* pipeline, u32 first, const std::vector<VkDescriptorSet>& sets);
         void cmdBindPushConstant(VulkanGraphicPipeline* pipeline, VkShaderStageFlags stageFlags, u32 size, const void* data);
         void cmdBindPushConstant(VulkanComputePipeline* pipeline, VkShaderStageFlags stageFlags, u32 size, const void* data);
@@ -110,6 +111,7 @@ namespace vk
         void cmdCopyBufferToImage(VulkanBuffer* src, VulkanImage* dst, VkImageLayout layout, const std::vector<VkBufferImageCopy>& regions);
         void cmdCopyBufferToBuffer(VulkanBuffer* src, VulkanBuffer* dst, const std::vector<VkBufferCopy>& regions);
         void cmdCopyImageToImage(VulkanImage* src, VkImageLayout srcLayout, VulkanImage* dst, VkImageLayout dstLayout, const std::vector<VkImageCopy>& regions);
+        void cmdCopyImageToBuffer(VulkanImage* src, VkImageLayout layout, VulkanBuffer* dst, const std::vector<VkBufferImageCopy>& regions);
 
         //sync
         void cmdPipelineBarrier(VulkanImage* image, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkImageLayout layout);
@@ -98,11 +98,16 @@ inline void VulkanCommandBuffer::cmdBindPipeline(VulkanComputePipeline* pipeline
 }
 
 inline void VulkanCommandBuffer::cmdBindDescriptorSets(VulkanGraphicPipeline* pipeline, u32 first, const std::vector<VkDescriptorSet>& sets, const std::vector<u32>& offsets)
+{
+    VulkanCommandBuffer::cmdBindDescriptorSets(pipeline, first, static_cast<u32>(sets.size()), sets.data(), offsets);
+}
+
+inline void VulkanCommandBuffer::cmdBindDescriptorSets(VulkanGraphicPipeline* pipeline, u32 first, u32 count, const VkDescriptorSet* sets, const std::vector<u32>& offsets)
 {
     ASSERT(m_status == CommandBufferStatus::Begin, "not started");
 
     VulkanCommandBuffer::captureResource(pipeline);
-    VulkanWrapper::CmdBindDescriptorSets(m_commands, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->getPipelineLayoutHandle(), first, static_cast<u32>(sets.size()), sets.data(), static_cast<u32>(offsets.size()), offsets.data());
+    VulkanWrapper::CmdBindDescriptorSets(m_commands, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->getPipelineLayoutHandle(), first, count, sets, static_cast<u32>(offsets.size()), offsets.data());
 }
 
 inline void VulkanCommandBuffer::cmdBindDescriptorSets(VulkanComputePipeline* pipeline, u32 first, const std::vector<VkDescriptorSet>& sets)
@@ -256,6 +261,16 @@ inline void VulkanCommandBuffer::cmdCopyImageToImage(VulkanImage* src, VkImageLa
     VulkanWrapper::CmdCopyImage(m_commands, src->getHandle(), srcLayout, dst->getHandle(), dstLayout, static_cast<u32>(regions.size()), regions.data());
 }
 
+inline void VulkanCommandBuffer::cmdCopyImageToBuffer(VulkanImage* src, VkImageLayout layout, VulkanBuffer* dst, const std::vector<VkBufferImageCopy>& regions)
+{
+    ASSERT(m_status == CommandBufferStatus::Begin, "not started");
+    ASSERT(!isInsideRenderPass(), "outside render pass");
+
+    VulkanCommandBuffer::captureResource(src);
+    VulkanCommandBuffer::captureResource(dst);
+    VulkanWrapper::CmdCopyImageToBuffer(m_commands, src->getHandle(), layout, dst->getHandle(), static_cast<u32>(regions.size()), regions.data());
+}
+
 inline void VulkanCommandBuffer::cmdPipelineBarrier(VulkanImage* image, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkImageLayout layout)
 {
     VulkanCommandBuffer::cmdPipelineBarrier(image, VulkanImage::makeVulkanImageSubresource(image), srcStageMask, dstStageMask, layout);
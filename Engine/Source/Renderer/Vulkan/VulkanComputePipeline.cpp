@@ -3,12 +3,15 @@
 #include "Utils/Logger.h"
 #include "Renderer/Shader.h"
 #include "Renderer/ShaderProgram.h"
+#include "Task/TaskScheduler.h"
+#include "Resource/ResourceManager.h"
 
 #ifdef VULKAN_RENDER
 #   include "VulkanDebug.h"
 #   include "VulkanDeviceCaps.h"
 #   include "VulkanDevice.h"
 #   include "VulkanGraphicPipeline.h"
+#   include "VulkanPipelineCache.h"
 
 namespace v3d
 {
@@ -25,6 +28,8 @@ VulkanComputePipeline::VulkanComputePipeline(VulkanDevice* device, VulkanPipelin
     , m_pipeline(VK_NULL_HANDLE)
     , m_module(VK_NULL_HANDLE)
 
+    , m_compileTask(nullptr)
+    , m_compiled(true)
 {
     LOG_DEBUG("VulkanComputePipeline::VulkanComputePipeline constructor %llx", this);
 
@@ -77,13 +82,29 @@ void VulkanComputePipeline::deleteShaderModules()
     }
 }
 
-bool VulkanComputePipeline::create(const ComputePipelineState& state)
+bool VulkanComputePipeline::create(const ComputePipelineState& state, VkPipelineCache pipelineCache)
 {
     ASSERT(getType() == PipelineType::PipelineType_Compute, "invalid type");
+    void* vkExtentions = nullptr;
+
+#ifdef VK_EXT_pipeline_creation_feedback
+    VkPipelineCreationFeedbackEXT pipelineCreationFeedback = {};
+    VkPipelineCreationFeedbackCreateInfoEXT pipelineCreationFeedbackCreateInfo = {};
+    if (m_device.getVulkanDeviceCaps()._supportPipelineCreationFeedback)
+    {
+        pipelineCreationFeedbackCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+        pipelineCreationFeedbackCreateInfo.pNext = nullptr;
+        pipelineCreationFeedbackCreateInfo.pPipelineCreationFeedback = &pipelineCreationFeedback;
+        pipelineCreationFeedbackCreateInfo.pipelineStageCreationFeedbackCount = 0;
+        pipelineCreationFeedbackCreateInfo.pPipelineStageCreationFeedbacks = nullptr;
+
+        vkExtentions = &pipelineCreationFeedbackCreateInfo;
+    }
+#endif //VK_EXT_pipeline_creation_feedback
 
     VkComputePipelineCreateInfo computePipelineCreateInfo = {};
     computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    computePipelineCreateInfo.pNext = nullptr; //VkPipelineCreationFeedbackCreateInfoEXT
+    computePipelineCreateInfo.pNext = vkExtentions;
     computePipelineCreateInfo.flags = 0;
 #if VULKAN_DEBUG
     if (m_device.getVulkanDeviceCaps()._pipelineExecutablePropertiesEnabled)
@@ -121,8 +142,6 @@ bool VulkanComputePipeline::create(const ComputePipelineState& state)
     computePipelineCreateInfo.basePipelineIndex = 0;
     computePipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
-
     VkResult result = VulkanWrapper::CreateComputePipelines(m_device.getDeviceInfo()._device, pipelineCache, 1, &computePipelineCreateInfo, VULKAN_ALLOCATOR, &m_pipeline);
     if (result != VK_SUCCESS)
     {
@@ -130,6 +149,13 @@ bool VulkanComputePipeline::create(const ComputePipelineState& state)
         return false;
     }
 
+#ifdef VK_EXT_pipeline_creation_feedback
+    if (m_device.getVulkanDeviceCaps()._supportPipelineCreationFeedback)
+    {
+        m_device.getPipelineCache()->addFeedback(pipelineCreationFeedback);
+    }
+#endif //VK_EXT_pipeline_creation_feedback
+
 #if VULKAN_DEBUG_MARKERS
     if (m_device.getVulkanDeviceCaps()._debugUtilsObjectNameEnabled)
     {
@@ -167,6 +193,25 @@ void VulkanComputePipeline::destroy()
     }
 }
 
+bool VulkanComputePipeline::isCompiled() const
+{
+    return m_compiled.load(std::memory_order_acquire);
+}
+
+void VulkanComputePipeline::waitCompilation() const
+{
+    if (!VulkanComputePipeline::isCompiled())
+    {
+        ASSERT(m_compileTask, "nullptr");
+        m_compileTask->waitCompetition();
+    }
+}
+
+bool VulkanComputePipeline::isCompilationFailed() const
+{
+    return VulkanComputePipeline::isCompiled() && m_pipeline == VK_NULL_HANDLE;
+}
+
 bool VulkanComputePipeline::pipelineStatistic() const
 {
     if (m_device.getVulkanDeviceCaps()._pipelineExecutablePropertiesEnabled)
@@ -243,11 +288,18 @@ VulkanComputePipeline* VulkanComputePipelineManager::acquireGraphicPipeline(cons
     auto found = m_pipelineComputeList.find(desc);
     if (found != m_pipelineComputeList.cend())
     {
-        return found->second;
+        VulkanComputePipeline* pipeline = found->second;
+        if (!pipeline->isCompilationFailed())
+        {
+            return pipeline;
+        }
+
+        m_pipelineComputeList.erase(found);
+        m_failedPipelines.push_back(pipeline);
     }
 
     VulkanComputePipeline* pipeline = V3D_NEW(VulkanComputePipeline, memory::MemoryLabel::MemoryRenderCore)(&m_device, m_device.getPipelineLayoutManager(), state.getName());
-    if (!pipeline->create(state))
+    if (!pipeline->create(state, m_device.getPipelineCache()->getHandle()))
     {
         ASSERT(false, "can't create pipeline");
         pipeline->destroy();
@@ -260,23 +312,99 @@ VulkanComputePipeline* VulkanComputePipelineManager::acquireGraphicPipeline(cons
     return pipeline;
 }
 
-bool VulkanComputePipelineManager::removePipeline(VulkanComputePipeline* pipeline, VulkanResourceDeleter& deleter)
+VulkanComputePipeline* VulkanComputePipelineManager::compileComputePipeline(const ComputePipelineState& state)
 {
-    ASSERT(pipeline->getType() == RenderPipeline::PipelineType::PipelineType_Compute, "wrong type");
-    std::lock_guard lock(m_mutex);
+    resource::ResourceManager* resourceManager = resource::ResourceManager::getLazyInstance();
+    task::TaskScheduler* workers = resourceManager->acquireScheduler();
+    if (!workers)
+    {
+        return VulkanComputePipelineManager::acquireGraphicPipeline(state);
+    }
 
-    auto found = std::find_if(m_pipelineComputeList.begin(), m_pipelineComputeList.end(), [pipeline](auto& elem) -> bool
+    VulkanPipelineDesc desc(state.getShaderProgram());
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto found = m_pipelineComputeList.find(desc);
+        if (found != m_pipelineComputeList.cend() && !found->second->isCompilationFailed())
         {
-            return elem.second == pipeline;
+            resourceManager->releaseScheduler();
+            return found->second;
+        }
+    }
+
+    const ComputeShader* computeShader = static_cast<const ComputeShader*>(state.getShaderProgram()->getShader(ShaderType::Compute));
+    ShaderProgram* compileProgram = V3D_NEW(ShaderProgram, memory::MemoryLabel::MemoryRenderCore)(&m_device, computeShader);
+    ComputePipelineState* compileState = V3D_NEW(ComputePipelineState, memory::MemoryLabel::MemoryRenderCore)(&m_device, compileProgram, state.getName());
+
+    VulkanComputePipeline* pipeline = V3D_NEW(VulkanComputePipeline, memory::MemoryLabel::MemoryRenderCore)(&m_device, m_device.getPipelineLayoutManager(), state.getName());
+    pipeline->m_compiled.store(false, std::memory_order_relaxed);
+    pipeline->m_compileTask = m_taskPool.acquireTask();
+    pipeline->m_compileTask->init("CompileComputePipeline", [this, pipeline, compileState, compileProgram]() -> void
+        {
+            //Thread ids of the loading threads start from 1
+            VkPipelineCache pipelineCache = m_device.getPipelineCache()->getThreadHandle(task::TaskDispatcher::currentWorkerThreadID());
+            if (!pipeline->create(*compileState, pipelineCache))
+            {
+                //setPipelineState creates it again in place and reports the error
+                LOG_ERROR("VulkanComputePipelineManager::compileComputePipeline: can't create pipeline %s", compileState->getName().c_str());
+                pipeline->destroy();
+            }
+
+            V3D_DELETE(compileState, memory::MemoryLabel::MemoryRenderCore);
+            V3D_DELETE(compileProgram, memory::MemoryLabel::MemoryRenderCore);
+
+            pipeline->m_compiled.store(true, std::memory_order_release);
+            resource::ResourceManager::getLazyInstance()->releaseScheduler();
         });
 
-    if (found == m_pipelineComputeList.cend())
     {
-        LOG_DEBUG("VulkanComputePipelineManager pipeline is not found");
-        ASSERT(false, "pipeline");
-        return false;
+        std::lock_guard lock(m_mutex);
+
+        auto found = m_pipelineComputeList.find(desc);
+        if (found != m_pipelineComputeList.cend())
+        {
+            if (!found->second->isCompilationFailed())
+            {
+                //The other thread has added it meanwhile
+                m_taskPool.releaseTask(pipeline->m_compileTask);
+                pipeline->m_compileTask = nullptr;
+                V3D_DELETE(pipeline, memory::MemoryLabel::MemoryRenderCore);
+                V3D_DELETE(compileState, memory::MemoryLabel::MemoryRenderCore);
+                V3D_DELETE(compileProgram, memory::MemoryLabel::MemoryRenderCore);
+
+                resourceManager->releaseScheduler();
+                return found->second;
+            }
+
+            m_failedPipelines.push_back(found->second);
+            m_pipelineComputeList.erase(found);
+        }
+
+        m_pipelineComputeList.emplace(desc, pipeline);
     }
 
+    workers->executeTask(pipeline->m_compileTask, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+
+    return pipeline;
+}
+
+void VulkanComputePipelineManager::releaseCompileTask(VulkanComputePipeline* pipeline)
+{
+    if (pipeline->m_compileTask)
+    {
+        //The pipeline is ready a bit earlier than the task is completed
+        pipeline->m_compileTask->waitCompetition();
+        m_taskPool.releaseTask(pipeline->m_compileTask);
+        pipeline->m_compileTask = nullptr;
+    }
+}
+
+bool VulkanComputePipelineManager::removePipeline(VulkanComputePipeline* pipeline, VulkanResourceDeleter& deleter)
+{
+    ASSERT(pipeline->getType() == RenderPipeline::PipelineType::PipelineType_Compute, "wrong type");
+    std::lock_guard lock(m_mutex);
+
     if (pipeline->linked())
     {
         LOG_WARNING("VulkanComputePipelineManager::removePipeline pipleline still linked, but reqested to delete");
@@ -284,7 +412,29 @@ bool VulkanComputePipelineManager::removePipeline(VulkanComputePipeline* pipelin
         return false;
     }
 
-    m_pipelineComputeList.erase(found);
+    auto found = std::find_if(m_pipelineComputeList.begin(), m_pipelineComputeList.end(), [pipeline](auto& elem) -> bool
+        {
+            return elem.second == pipeline;
+        });
+
+    if (found != m_pipelineComputeList.cend())
+    {
+        m_pipelineComputeList.erase(found);
+    }
+    else
+    {
+        auto failed = std::find(m_failedPipelines.begin(), m_failedPipelines.end(), pipeline);
+        if (failed == m_failedPipelines.end())
+        {
+            LOG_DEBUG("VulkanComputePipelineManager pipeline is not found");
+            ASSERT(false, "pipeline");
+            return false;
+        }
+
+        m_failedPipelines.erase(failed);
+    }
+
+    releaseCompileTask(pipeline);
     deleter.addResourceToDelete(pipeline, [](VulkanResource* resource) -> void
         {
             VulkanComputePipeline* vkPipeline = static_cast<VulkanComputePipeline*>(resource);
@@ -308,10 +458,19 @@ void VulkanComputePipelineManager::clear()
             ASSERT(false, "pipeline");
         }
 
+        releaseCompileTask(pipeline);
         pipeline->destroy();
         V3D_DELETE(pipeline, memory::MemoryLabel::MemoryRenderCore);
     }
     m_pipelineComputeList.clear();
+
+    for (VulkanComputePipeline* pipeline : m_failedPipelines)
+    {
+        releaseCompileTask(pipeline);
+        pipeline->destroy();
+        V3D_DELETE(pipeline, memory::MemoryLabel::MemoryRenderCore);
+    }
+    m_failedPipelines.clear();
 }
 
 } //namespace vk
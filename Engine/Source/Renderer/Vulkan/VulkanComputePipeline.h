@@ -2,6 +2,7 @@
 
 #include "Renderer/Render.h"
 #include "Renderer/Pipeline.h"
+#include "Task/TaskPool.h"
 
 #ifdef VULKAN_RENDER
 #   include "VulkanWrapper.h"
@@ -41,9 +42,20 @@ namespace vk
         const VulkanPipelineLayout& getDescriptorSetLayouts() const;
         const VulkanPipelineLayoutDescription& getPipelineLayoutDescription() const;
 
-        bool create(const ComputePipelineState& state);
+        bool create(const ComputePipelineState& state, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
         void destroy();
 
+        /**
+        * @brief isCompiled. False while the pipeline is created in the background
+        */
+        bool isCompiled() const;
+        void waitCompilation() const;
+
+        /**
+        * @brief isCompilationFailed. The creation in the background is failed, the manager creates the pipeline again in place
+        */
+        bool isCompilationFailed() const;
+
     private:
 
         VulkanComputePipeline() = delete;
@@ -61,11 +73,16 @@ namespace vk
         VulkanPipelineLayoutDescription     m_pipelineLayoutDescription;
         VulkanPipelineLayout                m_pipelineLayout;
 
+        task::Task*                         m_compileTask;
+        std::atomic<bool>                   m_compiled;
+
         bool pipelineStatistic() const;
 
 #if VULKAN_DEBUG_MARKERS
         std::string m_debugName;
 #endif //VULKAN_DEBUG_MARKERS
+
+        friend class VulkanComputePipelineManager;
     };
 
     inline const VulkanPipelineLayout& VulkanComputePipeline::getDescriptorSetLayouts() const
@@ -115,8 +132,18 @@ namespace vk
         explicit VulkanComputePipelineManager(VulkanDevice* device) noexcept;
         ~VulkanComputePipelineManager();
 
+        /**
+        * @brief acquireGraphicPipeline. Creates the pipeline in place if it isn't found or its compilation is failed. nullptr if it can't be created
+        */
         [[nodiscard]] VulkanComputePipeline* acquireGraphicPipeline(const ComputePipelineState& state);
 
+        /**
+        * @brief compileComputePipeline. Creates the pipeline on the loading threads, returns it immediately.
+        * The job works on a copy of the state, the state and the program can be deleted before it's finished.
+        * Without the loading threads, or called from other threads, it's the same as acquireGraphicPipeline
+        */
+        [[nodiscard]] VulkanComputePipeline* compileComputePipeline(const ComputePipelineState& state);
+
         bool removePipeline(VulkanComputePipeline* pipeline, VulkanResourceDeleter& deleter);
         void clear();
 
@@ -125,9 +152,13 @@ namespace vk
         VulkanComputePipelineManager(const VulkanComputePipelineManager&) = delete;
         VulkanComputePipelineManager& operator=(const VulkanComputePipelineManager&) = delete;
 
+        void releaseCompileTask(VulkanComputePipeline* pipeline);
+
         VulkanDevice&    m_device;
         thread::Spinlock m_mutex;
+        task::TaskPool   m_taskPool;
         std::unordered_map<DescInfo<VulkanPipelineDesc>, VulkanComputePipeline*, DescInfo<VulkanPipelineDesc>::Hash, DescInfo<VulkanPipelineDesc>::Compare> m_pipelineComputeList;
+        std::vector<VulkanComputePipeline*> m_failedPipelines; //Replaced in the list, they live until the states release them
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
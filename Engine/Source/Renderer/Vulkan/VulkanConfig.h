@@ -34,6 +34,16 @@
 
 #define VULKAN_STATISTICS 0
 
+//Surface. Windows and Android present to a surface. Other platforms render to the offscreen swapchain, the WSI extensions aren't enabled
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_ANDROID)
+#   define VULKAN_SURFACE 1
+#else
+#   define VULKAN_SURFACE 0
+#endif
+
+//Pipeline cache. The file is written at the device destroy, the empty name disables it
+#define VULKAN_PIPELINE_CACHE_FILE "VulkanPipelineCache.bin"
+
 #define VULKAN_DUMP 0
 #if VULKAN_DUMP
 #    define VULKAN_DUMP_FILE "VulkanCommandsDump.log"
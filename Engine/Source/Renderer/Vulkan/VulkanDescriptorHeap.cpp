@@ -0,0 +1,323 @@
+#include "VulkanDescriptorHeap.h"
+
+#include "Utils/Logger.h"
+
+#ifdef VULKAN_RENDER
+#   include "VulkanDebug.h"
+#   include "VulkanDevice.h"
+#   include "VulkanDescriptorSet.h"
+#   include "VulkanCommandBuffer.h"
+#   include "VulkanImage.h"
+#   include "VulkanBuffer.h"
+
+namespace v3d
+{
+namespace renderer
+{
+namespace vk
+{
+
+VulkanDescriptorHeap::VulkanDescriptorHeap(VulkanDevice* device) noexcept
+    : m_device(*device)
+    , m_pool(VK_NULL_HANDLE)
+    , m_layout(VK_NULL_HANDLE)
+    , m_set(VK_NULL_HANDLE)
+    , m_emptyLayout(VK_NULL_HANDLE)
+    , m_emptySet(VK_NULL_HANDLE)
+{
+    LOG_DEBUG("VulkanDescriptorHeap::VulkanDescriptorHeap constructor %llx", this);
+}
+
+VulkanDescriptorHeap::~VulkanDescriptorHeap()
+{
+    LOG_DEBUG("VulkanDescriptorHeap::~VulkanDescriptorHeap destructor %llx", this);
+    ASSERT(m_pool == VK_NULL_HANDLE && m_layout == VK_NULL_HANDLE && m_emptyLayout == VK_NULL_HANDLE, "not destroyed");
+}
+
+bool VulkanDescriptorHeap::create(u32 maxTextures, u32 maxBuffers)
+{
+    ASSERT(m_pool == VK_NULL_HANDLE, "already created");
+    ASSERT(maxTextures > 0 && maxBuffers > 0, "must be greater than 0");
+
+    m_layoutBindings.resize(Binding_Count);
+    {
+        VkDescriptorSetLayoutBinding& textures = m_layoutBindings[Binding_Textures];
+        textures.binding = Binding_Textures;
+        textures.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        textures.descriptorCount = maxTextures;
+        textures.stageFlags = VK_SHADER_STAGE_ALL;
+        textures.pImmutableSamplers = nullptr;
+
+        VkDescriptorSetLayoutBinding& buffers = m_layoutBindings[Binding_Buffers];
+        buffers.binding = Binding_Buffers;
+        buffers.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        buffers.descriptorCount = maxBuffers;
+        buffers.stageFlags = VK_SHADER_STAGE_ALL;
+        buffers.pImmutableSamplers = nullptr;
+    }
+
+    //The unused entries are never read, the registered ones are written while the set is bound
+    std::array<VkDescriptorBindingFlagsEXT, Binding_Count> descriptorBindingFlags;
+    descriptorBindingFlags.fill(VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT);
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT descriptorSetLayoutBindingFlagsCreateInfo = {};
+    descriptorSetLayoutBindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    descriptorSetLayoutBindingFlagsCreateInfo.pNext = nullptr;
+    descriptorSetLayoutBindingFlagsCreateInfo.bindingCount = static_cast<u32>(descriptorBindingFlags.size());
+    descriptorSetLayoutBindingFlagsCreateInfo.pBindingFlags = descriptorBindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {};
+    descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptorSetLayoutCreateInfo.pNext = &descriptorSetLayoutBindingFlagsCreateInfo;
+    descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    descriptorSetLayoutCreateInfo.bindingCount = static_cast<u32>(m_layoutBindings.size());
+    descriptorSetLayoutCreateInfo.pBindings = m_layoutBindings.data();
+
+    VkResult result = VulkanWrapper::CreateDescriptorSetLayout(m_device.getDeviceInfo()._device, &descriptorSetLayoutCreateInfo, VULKAN_ALLOCATOR, &m_layout);
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("VulkanDescriptorHeap::create vkCreateDescriptorSetLayout is failed. Error: %s", ErrorString(result).c_str());
+        VulkanDescriptorHeap::destroy();
+        return false;
+    }
+
+    VkDescriptorSetLayoutCreateInfo emptyDescriptorSetLayoutCreateInfo = {};
+    emptyDescriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    emptyDescriptorSetLayoutCreateInfo.pNext = nullptr;
+    emptyDescriptorSetLayoutCreateInfo.flags = 0;
+    emptyDescriptorSetLayoutCreateInfo.bindingCount = 0;
+    emptyDescriptorSetLayoutCreateInfo.pBindings = nullptr;
+
+    result = VulkanWrapper::CreateDescriptorSetLayout(m_device.getDeviceInfo()._device, &emptyDescriptorSetLayoutCreateInfo, VULKAN_ALLOCATOR, &m_emptyLayout);
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("VulkanDescriptorHeap::create vkCreateDescriptorSetLayout is failed. Error: %s", ErrorString(result).c_str());
+        VulkanDescriptorHeap::destroy();
+        return false;
+    }
+
+    std::array<VkDescriptorPoolSize, Binding_Count> descriptorPoolSizes;
+    descriptorPoolSizes[Binding_Textures] = { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxTextures };
+    descriptorPoolSizes[Binding_Buffers] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxBuffers };
+
+    VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
+    descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptorPoolCreateInfo.pNext = nullptr;
+    descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    descriptorPoolCreateInfo.maxSets = 2;
+    descriptorPoolCreateInfo.poolSizeCount = static_cast<u32>(descriptorPoolSizes.size());
+    descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes.data();
+
+    result = VulkanWrapper::CreateDescriptorPool(m_device.getDeviceInfo()._device, &descriptorPoolCreateInfo, VULKAN_ALLOCATOR, &m_pool);
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("VulkanDescriptorHeap::create vkCreateDescriptorPool is failed. Error: %s", ErrorString(result).c_str());
+        VulkanDescriptorHeap::destroy();
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
+    descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptorSetAllocateInfo.pNext = nullptr;
+    descriptorSetAllocateInfo.descriptorPool = m_pool;
+    descriptorSetAllocateInfo.descriptorSetCount = 2;
+
+    std::array<VkDescriptorSetLayout, 2> layouts = { m_layout, m_emptyLayout };
+    descriptorSetAllocateInfo.pSetLayouts = layouts.data();
+
+    std::array<VkDescriptorSet, 2> sets = {};
+    result = VulkanWrapper::AllocateDescriptorSets(m_device.getDeviceInfo()._device, &descriptorSetAllocateInfo, sets.data());
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("VulkanDescriptorHeap::create vkAllocateDescriptorSets is failed. Error: %s", ErrorString(result).c_str());
+        VulkanDescriptorHeap::destroy();
+        return false;
+    }
+    m_set = sets[0];
+    m_emptySet = sets[1];
+
+    //The free lists are reversed to give the indices from 0
+    std::lock_guard lock(m_mutex);
+    for (u32 binding = 0; binding < Binding_Count; ++binding)
+    {
+        Table& table = m_tables[binding];
+        u32 count = m_layoutBindings[binding].descriptorCount;
+
+        table._resources.assign(count, nullptr);
+        table._freeList.resize(count);
+        for (u32 i = 0; i < count; ++i)
+        {
+            table._freeList[i] = count - 1 - i;
+        }
+    }
+
+    LOG_INFO("VulkanDescriptorHeap::create: textures %u, buffers %u", maxTextures, maxBuffers);
+    return true;
+}
+
+void VulkanDescriptorHeap::destroy()
+{
+    if (m_pool != VK_NULL_HANDLE)
+    {
+        //The sets are freed with the pool
+        VulkanWrapper::DestroyDescriptorPool(m_device.getDeviceInfo()._device, m_pool, VULKAN_ALLOCATOR);
+        m_pool = VK_NULL_HANDLE;
+        m_set = VK_NULL_HANDLE;
+        m_emptySet = VK_NULL_HANDLE;
+    }
+
+    if (m_emptyLayout != VK_NULL_HANDLE)
+    {
+        VulkanWrapper::DestroyDescriptorSetLayout(m_device.getDeviceInfo()._device, m_emptyLayout, VULKAN_ALLOCATOR);
+        m_emptyLayout = VK_NULL_HANDLE;
+    }
+
+    if (m_layout != VK_NULL_HANDLE)
+    {
+        VulkanWrapper::DestroyDescriptorSetLayout(m_device.getDeviceInfo()._device, m_layout, VULKAN_ALLOCATOR);
+        m_layout = VK_NULL_HANDLE;
+    }
+
+    std::lock_guard lock(m_mutex);
+    for (Table& table : m_tables)
+    {
+        table._resources.clear();
+        table._freeList.clear();
+    }
+}
+
+u32 VulkanDescriptorHeap::registerTexture(VulkanImage* image, const RenderTexture::Subresource& subresource)
+{
+    ASSERT(image, "nullptr");
+    ASSERT(m_set != VK_NULL_HANDLE, "not created");
+
+    u32 index = VulkanDescriptorHeap::allocateIndex(Binding_Textures, image);
+    if (index == k_invalidBindlessIndex)
+    {
+        LOG_WARNING("VulkanDescriptorHeap::registerTexture: heap is full");
+        return k_invalidBindlessIndex;
+    }
+
+    VkImageLayout layout = VulkanImage::isDepthStencilFormat(image->getFormat()) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkDescriptorImageInfo descriptorImageInfo = makeVkDescriptorImageInfo(image, nullptr, layout, subresource);
+
+    VkWriteDescriptorSet writeDescriptorSet = {};
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSet.pNext = nullptr;
+    writeDescriptorSet.dstSet = m_set;
+    writeDescriptorSet.dstBinding = Binding_Textures;
+    writeDescriptorSet.dstArrayElement = index;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    writeDescriptorSet.pImageInfo = &descriptorImageInfo;
+
+    {
+        //The writes to the same set must be synchronized
+        std::lock_guard lock(m_mutex);
+        VulkanWrapper::UpdateDescriptorSets(m_device.getDeviceInfo()._device, 1, &writeDescriptorSet, 0, nullptr);
+    }
+
+    return index;
+}
+
+u32 VulkanDescriptorHeap::registerBuffer(VulkanBuffer* buffer)
+{
+    ASSERT(buffer, "nullptr");
+    ASSERT(m_set != VK_NULL_HANDLE, "not created");
+
+    u32 index = VulkanDescriptorHeap::allocateIndex(Binding_Buffers, buffer);
+    if (index == k_invalidBindlessIndex)
+    {
+        LOG_WARNING("VulkanDescriptorHeap::registerBuffer: heap is full");
+        return k_invalidBindlessIndex;
+    }
+
+    VkDescriptorBufferInfo descriptorBufferInfo = makeVkDescriptorBufferInfo(buffer, 0, VK_WHOLE_SIZE);
+
+    VkWriteDescriptorSet writeDescriptorSet = {};
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSet.pNext = nullptr;
+    writeDescriptorSet.dstSet = m_set;
+    writeDescriptorSet.dstBinding = Binding_Buffers;
+    writeDescriptorSet.dstArrayElement = index;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    writeDescriptorSet.pBufferInfo = &descriptorBufferInfo;
+
+    {
+        std::lock_guard lock(m_mutex);
+        VulkanWrapper::UpdateDescriptorSets(m_device.getDeviceInfo()._device, 1, &writeDescriptorSet, 0, nullptr);
+    }
+
+    return index;
+}
+
+void VulkanDescriptorHeap::unregisterTexture(u32 index, VulkanResourceDeleter& deleter)
+{
+    VulkanDescriptorHeap::unregisterIndex(Binding_Textures, index, deleter);
+}
+
+void VulkanDescriptorHeap::unregisterBuffer(u32 index, VulkanResourceDeleter& deleter)
+{
+    VulkanDescriptorHeap::unregisterIndex(Binding_Buffers, index, deleter);
+}
+
+u32 VulkanDescriptorHeap::allocateIndex(Binding binding, VulkanResource* resource)
+{
+    std::lock_guard lock(m_mutex);
+
+    Table& table = m_tables[binding];
+    if (table._freeList.empty())
+    {
+        return k_invalidBindlessIndex;
+    }
+
+    u32 index = table._freeList.back();
+    table._freeList.pop_back();
+
+    ASSERT(!table._resources[index], "must be free");
+    table._resources[index] = resource;
+
+    return index;
+}
+
+void VulkanDescriptorHeap::unregisterIndex(Binding binding, u32 index, VulkanResourceDeleter& deleter)
+{
+    VulkanResource* resource = nullptr;
+    {
+        std::lock_guard lock(m_mutex);
+
+        Table& table = m_tables[binding];
+        ASSERT(index < table._resources.size(), "range out");
+        resource = table._resources[index];
+        ASSERT(resource, "not registered");
+        table._resources[index] = nullptr;
+    }
+
+    //The command buffers which captured the heap until now could read the descriptor.
+    //The resource and the index are released when they are completed, the later command buffers don't keep them
+    resource->inheritUsage(*this);
+    deleter.addResourceToDelete(resource, [this, binding, index](VulkanResource* resource) -> void
+        {
+            VulkanDescriptorHeap::releaseIndex(binding, index);
+        });
+}
+
+void VulkanDescriptorHeap::releaseIndex(Binding binding, u32 index)
+{
+    std::lock_guard lock(m_mutex);
+
+    Table& table = m_tables[binding];
+    if (table._resources.empty()) //destroyed
+    {
+        return;
+    }
+
+    ASSERT(!table._resources[index], "must be unregistered");
+    table._freeList.push_back(index);
+}
+
+} //namespace vk
+} //namespace renderer
+} //namespace v3d
+#endif //VULKAN_RENDER
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Common.h"
+#include "Renderer/Render.h"
+#include "Thread/Spinlock.h"
+
+#ifdef VULKAN_RENDER
+#   include "VulkanWrapper.h"
+#   include "VulkanResource.h"
+
+namespace v3d
+{
+namespace renderer
+{
+namespace vk
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    class VulkanDevice;
+    class VulkanImage;
+    class VulkanBuffer;
+    class VulkanCommandBuffer;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief VulkanDescriptorHeap class. Vulkan Render side.
+    * The single update-after-bind descriptor set which is bound to k_bindlessDescriptorSet for the whole frame.
+    * The resources are written once on register and the shaders index them, so the draws don't allocate or update the sets.
+    * The command buffers capture the heap once, an unregistered resource inherits the usage of the heap.
+    * Multithreaded
+    */
+    class VulkanDescriptorHeap final : public VulkanResource
+    {
+    public:
+
+        enum Binding : u32
+        {
+            Binding_Textures = 0,
+            Binding_Buffers = 1,
+
+            Binding_Count
+        };
+
+        explicit VulkanDescriptorHeap(VulkanDevice* device) noexcept;
+        ~VulkanDescriptorHeap();
+
+        bool create(u32 maxTextures, u32 maxBuffers);
+        void destroy();
+
+        u32 registerTexture(VulkanImage* image, const RenderTexture::Subresource& subresource);
+        u32 registerBuffer(VulkanBuffer* buffer);
+
+        /**
+        * @brief unregister. The index is released by the deleter, when the command buffers which captured the heap before are completed
+        */
+        void unregisterTexture(u32 index, VulkanResourceDeleter& deleter);
+        void unregisterBuffer(u32 index, VulkanResourceDeleter& deleter);
+
+        VkDescriptorSetLayout getDescriptorSetLayout() const;
+        VkDescriptorSet getDescriptorSet() const;
+
+        /**
+        * @brief getEmptyDescriptorSet. Fills the unused sets in front of k_bindlessDescriptorSet, the sets are bound in one range
+        */
+        VkDescriptorSet getEmptyDescriptorSet() const;
+
+        const std::vector<VkDescriptorSetLayoutBinding>& getLayoutBindings() const;
+
+    private:
+
+        VulkanDescriptorHeap(const VulkanDescriptorHeap&) = delete;
+        VulkanDescriptorHeap& operator=(const VulkanDescriptorHeap&) = delete;
+
+        struct Table
+        {
+            std::vector<VulkanResource*>    _resources;
+            std::vector<u32>                _freeList;
+        };
+
+        u32 allocateIndex(Binding binding, VulkanResource* resource);
+        void unregisterIndex(Binding binding, u32 index, VulkanResourceDeleter& deleter);
+        void releaseIndex(Binding binding, u32 index);
+
+        VulkanDevice&                               m_device;
+
+        VkDescriptorPool                            m_pool;
+        VkDescriptorSetLayout                       m_layout;
+        VkDescriptorSet                             m_set;
+        VkDescriptorSetLayout                       m_emptyLayout;
+        VkDescriptorSet                             m_emptySet;
+        std::vector<VkDescriptorSetLayoutBinding>   m_layoutBindings;
+
+        mutable thread::Spinlock                    m_mutex;
+        Table                                       m_tables[Binding_Count];
+    };
+
+    inline VkDescriptorSetLayout VulkanDescriptorHeap::getDescriptorSetLayout() const
+    {
+        return m_layout;
+    }
+
+    inline VkDescriptorSet VulkanDescriptorHeap::getDescriptorSet() const
+    {
+        return m_set;
+    }
+
+    inline VkDescriptorSet VulkanDescriptorHeap::getEmptyDescriptorSet() const
+    {
+        return m_emptySet;
+    }
+
+    inline const std::vector<VkDescriptorSetLayoutBinding>& VulkanDescriptorHeap::getLayoutBindings() const
+    {
+        return m_layoutBindings;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace vk
+} //namespace renderer
+} //namespace v3d
+#endif //VULKAN_RENDER
@@ -3,6 +3,7 @@
 #include "Utils/Logger.h"
 
 #include "Renderer/ShaderProgram.h"
+#include "Utils/Timer.h"
 #ifdef VULKAN_RENDER
 #   include "VulkanDebug.h"
 #   include "VulkanImage.h"
@@ -19,6 +20,8 @@
 #   include "VulkanStagingBuffer.h"
 #   include "VulkanDescriptorPool.h"
 #   include "VulkanSampler.h"
+#   include "VulkanPipelineCache.h"
+#   include "VulkanDescriptorHeap.h"
 
 #ifdef PLATFORM_ANDROID
 #   include "Platform/Android/HWCPProfiler.h"
@@ -36,17 +39,17 @@ namespace vk
 
 const std::vector<const c8*> k_instanceExtensionsList = 
 {
+#if VULKAN_SURFACE
     VK_KHR_SURFACE_EXTENSION_NAME,
     VK_KHR_DISPLAY_EXTENSION_NAME,
-#ifdef VK_KHR_win32_surface
+    VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME,
+#   ifdef VK_KHR_win32_surface
     VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
-#endif
-#ifdef VK_KHR_android_surface
+#   endif
+#   ifdef VK_KHR_android_surface
     VK_KHR_ANDROID_SURFACE_EXTENSION_NAME,
-#endif
-#ifdef VK_KHR_xlib_surface
-    VK_KHR_XLIB_SURFACE_EXTENSION_NAME,
-#endif
+#   endif
+#endif //VULKAN_SURFACE
 
 #if VULKAN_LAYERS_CALLBACKS
     VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
@@ -56,12 +59,13 @@ const std::vector<const c8*> k_instanceExtensionsList =
 #endif //VULKAN_LAYERS_CALLBACKS
 
     VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME,
-    VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME,
 };
 
 const std::vector<const c8*> k_deviceExtensionsList =
 {
+#if VULKAN_SURFACE
     VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+#endif //VULKAN_SURFACE
 
     VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,
     VK_KHR_DRIVER_PROPERTIES_EXTENSION_NAME,
@@ -100,6 +104,9 @@ const std::vector<const c8*> k_deviceExtensionsList =
 #ifdef VK_EXT_calibrated_timestamps
     VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME,
 #endif
+#ifdef VK_EXT_pipeline_creation_feedback
+    VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME,
+#endif
 };
 
 std::vector<VkDynamicState> VulkanDevice::s_requiredDynamicStates =
@@ -145,6 +152,12 @@ VulkanDevice::VulkanDevice(DeviceMaskFlags mask) noexcept
     , m_graphicPipelineManager(nullptr)
     , m_computePipelineManager(nullptr)
     , m_samplerManager(nullptr)
+    , m_pipelineCache(nullptr)
+    , m_descriptorHeap(nullptr)
+    , m_compileStalls(0)
+    , m_compileStallTime(0)
+    , m_pipelineBinds(0)
+    , m_descriptorSetBinds(0)
     , m_internalCmdBufferManager(nullptr)
 
 
@@ -177,6 +190,8 @@ VulkanDevice::~VulkanDevice()
     ASSERT(!m_computePipelineManager, "m_computePipelineManager is not nullptr");
     ASSERT(!m_graphicPipelineManager, "m_graphicPipelineManager is not nullptr");
     ASSERT(!m_pipelineLayoutManager, "m_pipelineLayoutManager is not nullptr");
+    ASSERT(!m_pipelineCache, "m_pipelineCache is not nullptr");
+    ASSERT(!m_descriptorHeap, "m_descriptorHeap is not nullptr");
     ASSERT(!m_renderpassManager, "m_renderpassManager is not nullptr");
     ASSERT(!m_framebufferManager, "m_framebufferManager not nullptr");
     ASSERT(!m_semaphoreManager, "m_semaphoreManager is not nullptr");
@@ -308,7 +323,8 @@ void VulkanDevice::submit(CmdList* cmd, SyncPoint* sync, bool wait)
                     drawBuffer->addSemaphores(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, syncPoint->m_waitSubmitSemaphores);
                 }
 
-                if (!wait)
+                //The offscreen frames aren't presented, nobody would wait the signal semaphores
+                if (!wait && !(swapchain && swapchain->isOffscreen()))
                 {
                     for (auto& sync : cmdList.m_syncPoints)
                     {
@@ -330,6 +346,19 @@ void VulkanDevice::submit(CmdList* cmd, SyncPoint* sync, bool wait)
     g_CPUProfiler->stop(0, RenderFrameProfiler::FrameCounter::Submit);
 #endif //FRAME_PROFILER_INTERNAL
 
+    u64 pipelineCacheHits = 0;
+    u64 pipelineCacheMisses = 0;
+    m_pipelineCache->collectStatistic(pipelineCacheHits, pipelineCacheMisses);
+#if FRAME_PROFILER_INTERNAL
+    g_CPUProfiler->add(0, RenderFrameProfiler::FrameCounter::PipelineCacheHit, pipelineCacheHits);
+    g_CPUProfiler->add(0, RenderFrameProfiler::FrameCounter::PipelineCacheMiss, pipelineCacheMisses);
+#endif //FRAME_PROFILER_INTERNAL
+
+    m_pipelineBinds.fetch_add(cmdList.m_pipelineBinds, std::memory_order_relaxed);
+    m_descriptorSetBinds.fetch_add(cmdList.m_descriptorSetBinds, std::memory_order_relaxed);
+    cmdList.m_pipelineBinds = 0;
+    cmdList.m_descriptorSetBinds = 0;
+
     cmdList.postSubmit();
 
     m_internalCmdBufferManager->updateStatus();
@@ -454,6 +483,27 @@ bool VulkanDevice::initialize()
         m_renderpassManager = V3D_NEW(VulkanRenderpassManager, memory::MemoryLabel::MemoryRenderCore)(this);
     }
 
+    //The pipelines are compiled on the loading threads, they are created later and get ids from 1, but never more than the hardware threads.
+    //The cache of the slot 0 is unused
+    m_pipelineCache = V3D_NEW(VulkanPipelineCache, memory::MemoryLabel::MemoryRenderCore)(this);
+    if (!m_pipelineCache->create(VULKAN_PIPELINE_CACHE_FILE, std::max(std::thread::hardware_concurrency(), 1U) + 1))
+    {
+        LOG_WARNING("VulkanDevice::initialize: pipeline cache is not created, pipelines are created without it");
+    }
+
+    //Must be created before the pipeline layouts, they take the heap layout for the bindless set
+    if (m_deviceCaps._supportBindless)
+    {
+        m_descriptorHeap = V3D_NEW(VulkanDescriptorHeap, memory::MemoryLabel::MemoryRenderCore)(this);
+        if (!m_descriptorHeap->create(m_deviceCaps._maxBindlessTextures, m_deviceCaps._maxBindlessBuffers))
+        {
+            LOG_WARNING("VulkanDevice::initialize: descriptor heap is not created, bindless is disabled");
+            V3D_DELETE(m_descriptorHeap, memory::MemoryLabel::MemoryRenderCore);
+            m_descriptorHeap = nullptr;
+            m_deviceCaps._supportBindless = false;
+        }
+    }
+
     m_pipelineLayoutManager = V3D_NEW(VulkanPipelineLayoutManager, memory::MemoryLabel::MemoryRenderCore)(this);
     m_graphicPipelineManager = V3D_NEW(VulkanGraphicPipelineManager, memory::MemoryLabel::MemoryRenderCore)(this);
     m_computePipelineManager = V3D_NEW(VulkanComputePipelineManager, memory::MemoryLabel::MemoryRenderCore)(this);
@@ -474,9 +524,17 @@ bool VulkanDevice::initialize()
             RenderFrameProfiler::FrameCounter::Submit,
             RenderFrameProfiler::FrameCounter::Present,
             RenderFrameProfiler::FrameCounter::UpdateSubmitResorces,
+            RenderFrameProfiler::FrameCounter::PipelineCompileStall,
         },
         {
             RenderFrameProfiler::FrameCounter::DrawCalls,
+            RenderFrameProfiler::FrameCounter::SetPipeline,
+            RenderFrameProfiler::FrameCounter::PipelineBinds,
+            RenderFrameProfiler::FrameCounter::BindResources,
+            RenderFrameProfiler::FrameCounter::DescriptorSetBinds,
+            RenderFrameProfiler::FrameCounter::PipelineCacheHit,
+            RenderFrameProfiler::FrameCounter::PipelineCacheMiss,
+            RenderFrameProfiler::FrameCounter::PipelineCompileStall,
         });
         m_frameProfiler.attach(g_CPUProfiler);
 #   if defined(PLATFORM_ANDROID)
@@ -995,6 +1053,21 @@ void VulkanDevice::destroy()
         m_graphicPipelineManager = nullptr;
     }
 
+    //The managers have waited for the compile jobs
+    if (m_pipelineCache)
+    {
+        const u64 compileStalls = m_compileStalls.load(std::memory_order_relaxed);
+        if (compileStalls > 0)
+        {
+            LOG_INFO("VulkanDevice::destroy: pipeline compile stalls %llu, %.2f ms", compileStalls, static_cast<f32>(m_compileStallTime.load(std::memory_order_relaxed)) / 1'000.f);
+        }
+        LOG_INFO("VulkanDevice::destroy: pipeline binds %llu, descriptor set binds %llu", m_pipelineBinds.load(std::memory_order_relaxed), m_descriptorSetBinds.load(std::memory_order_relaxed));
+
+        m_pipelineCache->destroy();
+        V3D_DELETE(m_pipelineCache, memory::MemoryLabel::MemoryRenderCore);
+        m_pipelineCache = nullptr;
+    }
+
     if (m_pipelineLayoutManager)
     {
         m_pipelineLayoutManager->clear();
@@ -1002,6 +1075,14 @@ void VulkanDevice::destroy()
         m_pipelineLayoutManager = nullptr;
     }
 
+    //The deleter has released the unregistered indices already
+    if (m_descriptorHeap)
+    {
+        m_descriptorHeap->destroy();
+        V3D_DELETE(m_descriptorHeap, memory::MemoryLabel::MemoryRenderCore);
+        m_descriptorHeap = nullptr;
+    }
+
     if (m_renderpassManager)
     {
         V3D_DELETE(m_renderpassManager, memory::MemoryLabel::MemoryRenderCore);
@@ -1104,7 +1185,8 @@ Swapchain* VulkanDevice::createSwapchain(platform::Window* window, const Swapcha
 #if SWAPCHAIN_ON_ADVANCE
     VulkanCommandBuffer* cmdBuffer = m_internalCmdBufferManager->acquireNewCmdBuffer(Device::DeviceMask::GraphicMask, CommandBufferLevel::PrimaryBuffer);
     cmdBuffer->beginCommandBuffer();
-    cmdBuffer->cmdPipelineBarrier(swapchain->getCurrentSwapchainImage(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, RenderTexture::makeSubresource(0, 1, 0, 1));
+    cmdBuffer->cmdPipelineBarrier(swapchain->getCurrentSwapchainImage(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VulkanSwapchain::selectPresentLayout(swapchain->getCurrentSwapchainImage(), VK_IMAGE_LAYOUT_PRESENT_SRC_KHR), RenderTexture::makeSubresource(0, 1, 0, 1));
     cmdBuffer->endCommandBuffer();
     std::vector<VulkanSemaphore*> emptySemaphores;
     m_internalCmdBufferManager->submit(cmdBuffer, emptySemaphores);
@@ -1130,6 +1212,18 @@ void VulkanDevice::destroySwapchain(Swapchain* swapchain)
     V3D_DELETE(vkSwapchain, memory::MemoryLabel::MemoryRenderCore);
 }
 
+u32 VulkanDevice::getFramesInFlight() const
+{
+    //The command buffers are waited by the frame index of the swapchain, see VulkanCommandBuffer::isSafeFrame
+    u32 framesInFlight = 0;
+    for (const VulkanSwapchain* swapchain : m_swapchainList)
+    {
+        framesInFlight = std::max(framesInFlight, swapchain->getSwapchainImageCount());
+    }
+
+    return framesInFlight > 0 ? framesInFlight : Swapchain::SwapchainParams()._countSwapchainImages;
+}
+
 SyncPoint* VulkanDevice::createSyncPoint(CmdList* cmd)
 {
 #if FRAME_PROFILER_INTERNAL
@@ -1153,6 +1247,87 @@ SyncPoint* VulkanDevice::createSyncPoint(CmdList* cmd)
     return syncPoint;
 }
 
+bool VulkanDevice::compilePipeline(GraphicsPipelineState& state)
+{
+#if FRAME_PROFILER_INTERNAL
+    RenderFrameProfiler::StackProfiler stackFrameProfiler(g_CPUProfiler, 0, RenderFrameProfiler::FrameCounter::FrameTime);
+    RenderFrameProfiler::StackProfiler stackFuncProfiler(g_CPUProfiler, 0, RenderFrameProfiler::FrameCounter::CreateResources);
+#endif //FRAME_PROFILER_INTERNAL
+    VulkanGraphicPipeline* pipeline = m_graphicPipelineManager->compileGraphicPipeline(state);
+    if (!pipeline)
+    {
+        LOG_ERROR("VulkanDevice::compilePipeline: can't create pipeline %s", state.getName().c_str());
+        return false;
+    }
+
+    state.m_tracker.attach(pipeline);
+    return true;
+}
+
+bool VulkanDevice::compilePipeline(ComputePipelineState& state)
+{
+#if FRAME_PROFILER_INTERNAL
+    RenderFrameProfiler::StackProfiler stackFrameProfiler(g_CPUProfiler, 0, RenderFrameProfiler::FrameCounter::FrameTime);
+    RenderFrameProfiler::StackProfiler stackFuncProfiler(g_CPUProfiler, 0, RenderFrameProfiler::FrameCounter::CreateResources);
+#endif //FRAME_PROFILER_INTERNAL
+    VulkanComputePipeline* pipeline = m_computePipelineManager->compileComputePipeline(state);
+    if (!pipeline)
+    {
+        LOG_ERROR("VulkanDevice::compilePipeline: can't create pipeline %s", state.getName().c_str());
+        return false;
+    }
+
+    state.m_tracker.attach(pipeline);
+    return true;
+}
+
+VulkanDevice::PipelineStatistics VulkanDevice::getPipelineStatistics() const
+{
+    PipelineStatistics statistics;
+    if (m_pipelineCache)
+    {
+        statistics._cacheHits = m_pipelineCache->getTotalHits();
+        statistics._cacheMisses = m_pipelineCache->getTotalMisses();
+    }
+    statistics._compileStalls = m_compileStalls.load(std::memory_order_relaxed);
+    statistics._compileStallTime = m_compileStallTime.load(std::memory_order_relaxed);
+    statistics._pipelineBinds = m_pipelineBinds.load(std::memory_order_relaxed);
+    statistics._descriptorSetBinds = m_descriptorSetBinds.load(std::memory_order_relaxed);
+
+    return statistics;
+}
+
+u32 VulkanDevice::registerBindlessTexture(const TextureView& texture)
+{
+    ASSERT(m_descriptorHeap, "bindless is not supported");
+    ASSERT(texture._texture, "nullptr");
+    ASSERT(!texture._texture->hasUsageFlag(TextureUsage::TextureUsage_Backbuffer), "the swapchain images can't be registered");
+
+    VulkanImage* image = static_cast<VulkanImage*>(texture._texture->getTextureHandle().as<RenderTexture>());
+    return m_descriptorHeap->registerTexture(image, texture._subresource);
+}
+
+void VulkanDevice::unregisterBindlessTexture(u32 index)
+{
+    ASSERT(m_descriptorHeap, "bindless is not supported");
+    m_descriptorHeap->unregisterTexture(index, m_resourceDeleter);
+}
+
+u32 VulkanDevice::registerBindlessBuffer(Buffer* buffer)
+{
+    ASSERT(m_descriptorHeap, "bindless is not supported");
+    ASSERT(buffer, "nullptr");
+
+    VulkanBuffer* vkBuffer = static_cast<VulkanBuffer*>(buffer->getBufferHandle().as<RenderBuffer>());
+    return m_descriptorHeap->registerBuffer(vkBuffer);
+}
+
+void VulkanDevice::unregisterBindlessBuffer(u32 index)
+{
+    ASSERT(m_descriptorHeap, "bindless is not supported");
+    m_descriptorHeap->unregisterBuffer(index, m_resourceDeleter);
+}
+
 void VulkanDevice::destroySyncPoint(CmdList* cmd, SyncPoint* sync)
 {
 #if FRAME_PROFILER_INTERNAL
@@ -1416,6 +1591,11 @@ VulkanCmdList::VulkanCmdList(VulkanDevice* device) noexcept
     , m_concurrencySlot(~0U)
 
     , m_CBOManager(nullptr)
+    , m_heapCapturedCmdBuffer(nullptr)
+    , m_boundSetsCmdBuffer(nullptr)
+    , m_boundSetsLayout(VK_NULL_HANDLE)
+    , m_pipelineBinds(0)
+    , m_descriptorSetBinds(0)
 {
 #if VULKAN_DEBUG
     LOG_DEBUG("VulkanCmdList constructor this %llx", this);
@@ -1609,10 +1789,44 @@ void VulkanCmdList::setPipelineState(GraphicsPipelineState& state)
     TRACE_PROFILER_RENDER_SCOPE("setPipelineState", color::rgba8::MAGENTA);
 
     VulkanGraphicPipeline* pipeline = m_device.m_graphicPipelineManager->acquireGraphicPipeline(state);
+    if (pipeline && !pipeline->isCompiled())
+    {
+#if FRAME_PROFILER_INTERNAL
+        RenderFrameProfiler::StackProfiler stackStallProfiler(g_CPUProfiler, m_concurrencySlot, RenderFrameProfiler::FrameCounter::PipelineCompileStall);
+#endif //FRAME_PROFILER_INTERNAL
+        utils::Timer timer;
+        timer.start();
+        pipeline->waitCompilation();
+        timer.stop();
+
+        m_device.m_compileStalls.fetch_add(1, std::memory_order_relaxed);
+        m_device.m_compileStallTime.fetch_add(timer.getTime<utils::Timer::Duration_MicroSeconds>(), std::memory_order_relaxed);
+
+        if (pipeline->isCompilationFailed())
+        {
+            //The manager replaces it by the synchronous creation
+            pipeline = m_device.m_graphicPipelineManager->acquireGraphicPipeline(state);
+        }
+    }
+
+    if (!pipeline)
+    {
+        LOG_ERROR("VulkanCmdList::setPipelineState: can't create pipeline %s", state.m_name.c_str());
+        return;
+    }
     state.m_tracker.attach(pipeline);
 
     if (m_pendingRenderState._graphicPipeline != pipeline)
     {
+        //The sets allocated for the other layout can't be reused, the same bindings are skipped by the render state
+        if (!m_pendingRenderState._graphicPipeline || m_pendingRenderState._graphicPipeline->getPipelineLayoutHandle() != pipeline->getPipelineLayoutHandle())
+        {
+            for (u32 set = 0; set < k_maxDescriptorSetCount; ++set)
+            {
+                m_pendingRenderState.setDirty(DirtyStateMask(DirtyState_DescriptorSet + set));
+            }
+        }
+
         m_pendingRenderState._graphicPipeline = pipeline;
         m_pendingRenderState.setDirty(DirtyStateMask::DirtyState_Pipeline);
     }
@@ -1631,6 +1845,31 @@ void VulkanCmdList::setPipelineState(ComputePipelineState& state)
     TRACE_PROFILER_RENDER_SCOPE("setPipelineState", color::rgba8::MAGENTA);
 
     VulkanComputePipeline* pipeline = m_device.m_computePipelineManager->acquireGraphicPipeline(state);
+    if (pipeline && !pipeline->isCompiled())
+    {
+#if FRAME_PROFILER_INTERNAL
+        RenderFrameProfiler::StackProfiler stackStallProfiler(g_CPUProfiler, m_concurrencySlot, RenderFrameProfiler::FrameCounter::PipelineCompileStall);
+#endif //FRAME_PROFILER_INTERNAL
+        utils::Timer timer;
+        timer.start();
+        pipeline->waitCompilation();
+        timer.stop();
+
+        m_device.m_compileStalls.fetch_add(1, std::memory_order_relaxed);
+        m_device.m_compileStallTime.fetch_add(timer.getTime<utils::Timer::Duration_MicroSeconds>(), std::memory_order_relaxed);
+
+        if (pipeline->isCompilationFailed())
+        {
+            //The manager replaces it by the synchronous creation
+            pipeline = m_device.m_computePipelineManager->acquireGraphicPipeline(state);
+        }
+    }
+
+    if (!pipeline)
+    {
+        LOG_ERROR("VulkanCmdList::setPipelineState: can't create pipeline %s", state.m_name.c_str());
+        return;
+    }
     state.m_tracker.attach(pipeline);
 
     if (m_pendingRenderState._computePipeline != pipeline)
@@ -1654,7 +1893,7 @@ void VulkanCmdList::transition(const TextureView& textureView, TransitionOp stat
         image = static_cast<VulkanImage*>(textureView._texture->getTextureHandle().as<RenderTexture>());
     }
 
-    VkImageLayout newLayout = VulkanTransitionState::convertTransitionStateToImageLayout(state);
+    VkImageLayout newLayout = VulkanSwapchain::selectPresentLayout(image, VulkanTransitionState::convertTransitionStateToImageLayout(state));
     m_pendingRenderState.addImageBarrier(image, textureView._subresource, newLayout);
 }
 
@@ -1714,13 +1953,28 @@ void VulkanCmdList::bindConstantBuffer(const ShaderProgram* program, u32 set, u3
 {
     TRACE_PROFILER_RENDER_SCOPE("bindConstantBuffer", color::rgba8::GREEN);
 
+    u32 slot = program->getResourceSlot(set, binding);
+    BindingType type = (m_device.getVulkanDeviceCaps()._useDynamicUniforms) ? BindingType::DynamicUniform : BindingType::Uniform;
+
+    //The repeated data, e.g. the viewport of the previous draw, is read from the bound range
+    BoundConstantBuffer& bound = m_boundConstantBuffers[set][slot];
+    if (type == BindingType::Uniform && bound._buffer && m_pendingRenderState.isBound(set, slot, binding, bound._buffer, bound._offset)
+        && bound._data.size() == size && memcmp(bound._data.data(), data, size) == 0)
+    {
+        return;
+    }
+
     u32 alignmentSize = math::alignUp<u32>(size, m_device.getVulkanDeviceCaps().getPhysicalDeviceLimits().minMemoryMapAlignment);
     ConstantBufferRange range = m_CBOManager->acquireConstantBuffer(alignmentSize);
     [[maybe_unused]] bool updated = VulkanConstantBufferManager::update(range._buffer, range._offset, size, data);
 
-    u32 slot = program->getResourceSlot(set, binding);
-    BindingType type = (m_device.getVulkanDeviceCaps()._useDynamicUniforms) ? BindingType::DynamicUniform : BindingType::Uniform;
     m_pendingRenderState.bind(type, slot, set, binding, range._buffer, range._offset, alignmentSize);
+    if (type == BindingType::Uniform)
+    {
+        bound._buffer = range._buffer;
+        bound._offset = range._offset;
+        bound._data.assign(static_cast<const u8*>(data), static_cast<const u8*>(data) + size);
+    }
 }
 
 void VulkanCmdList::bindPushConstant(ShaderType type, u32 size, const void* data)
@@ -1733,6 +1987,10 @@ void VulkanCmdList::bindPushConstant(ShaderType type, u32 size, const void* data
 
 void VulkanCmdList::bindDescriptorSet(const ShaderProgram* program, u32 set, const std::vector<Descriptor>& descriptors)
 {
+#if FRAME_PROFILER_INTERNAL
+    RenderFrameProfiler::StackProfiler stackFrameProfiler(g_CPUProfiler, m_concurrencySlot, RenderFrameProfiler::FrameCounter::FrameTime);
+    RenderFrameProfiler::StackProfiler stackProfiler(g_CPUProfiler, m_concurrencySlot, RenderFrameProfiler::FrameCounter::BindResources);
+#endif //FRAME_PROFILER_INTERNAL
     TRACE_PROFILER_RENDER_SCOPE("bindDescriptorSet", color::rgba8::GREEN);
 
     ASSERT(set < m_device.getVulkanDeviceCaps()._maxDescriptorSets, "set out of range");
@@ -1862,6 +2120,10 @@ bool VulkanCmdList::prepareDraw(VulkanCommandBuffer* drawBuffer)
 
     if (m_pendingRenderState.isDirty(DirtyStateMask::DirtyState_Pipeline))
     {
+#if FRAME_PROFILER_INTERNAL
+        g_CPUProfiler->add(m_concurrencySlot, RenderFrameProfiler::FrameCounter::PipelineBinds, 1);
+#endif //FRAME_PROFILER_INTERNAL
+        ++m_pipelineBinds;
         drawBuffer->cmdBindPipeline(m_pendingRenderState._graphicPipeline);
         m_currentRenderState._graphicPipeline = m_pendingRenderState._graphicPipeline;
         m_pendingRenderState.unsetDirty(DirtyStateMask::DirtyState_Pipeline);
@@ -1881,7 +2143,36 @@ bool VulkanCmdList::prepareDraw(VulkanCommandBuffer* drawBuffer)
     //DS
     if (VulkanCmdList::prepareDescriptorSets(drawBuffer))
     {
-        drawBuffer->cmdBindDescriptorSets(m_pendingRenderState._graphicPipeline, 0, m_pendingRenderState._descriptorSets, m_pendingRenderState._dynamicOffsets);
+        const std::vector<VkDescriptorSet>& pendingSets = m_pendingRenderState._descriptorSets;
+        const std::vector<VkDescriptorSet>& currentSets = m_currentRenderState._descriptorSets;
+        u32 firstSet = 0;
+        u32 lastSet = static_cast<u32>(pendingSets.size());
+
+        //The bound sets aren't disturbed by the pipelines with the same layout, the dynamic offsets are always rebound
+        VkPipelineLayout layout = m_pendingRenderState._graphicPipeline->getPipelineLayoutHandle();
+        if (m_boundSetsCmdBuffer == drawBuffer && m_boundSetsLayout == layout && currentSets.size() == pendingSets.size() && m_pendingRenderState._dynamicOffsets.empty())
+        {
+            while (firstSet < lastSet && pendingSets[firstSet] == currentSets[firstSet])
+            {
+                ++firstSet;
+            }
+
+            while (lastSet > firstSet && pendingSets[lastSet - 1] == currentSets[lastSet - 1])
+            {
+                --lastSet;
+            }
+        }
+
+        if (firstSet < lastSet)
+        {
+#if FRAME_PROFILER_INTERNAL
+            g_CPUProfiler->add(m_concurrencySlot, RenderFrameProfiler::FrameCounter::DescriptorSetBinds, 1);
+#endif //FRAME_PROFILER_INTERNAL
+            ++m_descriptorSetBinds;
+            drawBuffer->cmdBindDescriptorSets(m_pendingRenderState._graphicPipeline, firstSet, lastSet - firstSet, pendingSets.data() + firstSet, m_pendingRenderState._dynamicOffsets);
+            m_boundSetsCmdBuffer = drawBuffer;
+            m_boundSetsLayout = layout;
+        }
 
         std::swap(m_currentRenderState._descriptorSets, m_pendingRenderState._descriptorSets);
         std::swap(m_currentRenderState._dynamicOffsets, m_pendingRenderState._dynamicOffsets);
@@ -1906,7 +2197,24 @@ bool VulkanCmdList::prepareDescriptorSets(VulkanCommandBuffer* drawBuffer)
             continue;
         }
 
-        if (m_pendingRenderState.isDirty(DirtyStateMask(DirtyState_DescriptorSet + indexSet)))
+        if (indexSet == k_bindlessDescriptorSet && m_device.getDescriptorHeap())
+        {
+            //The heap is never dirty, it's updated after bind
+            VulkanDescriptorHeap* heap = m_device.getDescriptorHeap();
+            ASSERT(m_pendingRenderState._graphicPipeline->getDescriptorSetLayouts()._setLayouts[indexSet] == heap->getDescriptorSetLayout(), "must be the heap layout");
+            m_pendingRenderState._descriptorSets.push_back(heap->getDescriptorSet());
+
+            if (m_heapCapturedCmdBuffer != drawBuffer)
+            {
+                drawBuffer->captureResource(heap);
+                m_heapCapturedCmdBuffer = drawBuffer;
+            }
+        }
+        else if (layoutDesc._bindingsSet[indexSet].empty() && m_device.getDescriptorHeap())
+        {
+            m_pendingRenderState._descriptorSets.push_back(m_device.getDescriptorHeap()->getEmptyDescriptorSet());
+        }
+        else if (m_pendingRenderState.isDirty(DirtyStateMask(DirtyState_DescriptorSet + indexSet)))
         {
             auto& layoutSet = m_pendingRenderState._graphicPipeline->getDescriptorSetLayouts()._setLayouts[indexSet];
 
@@ -2296,6 +2604,18 @@ void VulkanCmdList::postSubmit()
 
     m_CBOManager->updateStatus();
     m_descriptorSetManager->updateStatus();
+
+    m_heapCapturedCmdBuffer = nullptr;
+
+    m_boundSetsCmdBuffer = nullptr;
+    m_boundSetsLayout = VK_NULL_HANDLE;
+    for (auto& set : m_boundConstantBuffers)
+    {
+        for (BoundConstantBuffer& bound : set)
+        {
+            bound._buffer = nullptr;
+        }
+    }
 }
 
 } //namespace vk
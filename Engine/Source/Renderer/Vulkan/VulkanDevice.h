@@ -32,6 +32,8 @@ namespace vk
     class VulkanGraphicPipelineManager;
     class VulkanComputePipelineManager;
     class VulkanPipelineLayoutManager;
+    class VulkanPipelineCache;
+    class VulkanDescriptorHeap;
     class VulkanConstantBufferManager;
     class VulkanDescriptorSetManager;
     class VulkanSamplerManager;
@@ -112,6 +114,27 @@ namespace vk
         VulkanConstantBufferManager*    m_CBOManager;
         VulkanDescriptorSetManager*     m_descriptorSetManager;
 
+        //The heap is captured once per command buffer, the unregistered resources inherit its usage
+        VulkanCommandBuffer*            m_heapCapturedCmdBuffer;
+
+        //The sets stay bound between the draws with the same pipeline layout, only the changed range is rebound
+        VulkanCommandBuffer*            m_boundSetsCmdBuffer;
+        VkPipelineLayout                m_boundSetsLayout;
+
+        //Counted without atomics while recording, submit adds them to the totals of the device
+        u64                             m_pipelineBinds;
+        u64                             m_descriptorSetBinds;
+
+        struct BoundConstantBuffer
+        {
+            VulkanBuffer*               _buffer = nullptr;
+            u64                         _offset = 0;
+            std::vector<u8>             _data;
+        };
+
+        //Last data per slot, the same data keeps the bound range and the set isn't updated
+        std::array<std::array<BoundConstantBuffer, k_maxDescriptorSlotsCount>, k_maxDescriptorSetCount> m_boundConstantBuffers;
+
         VulkanRenderState               m_pendingRenderState;
         VulkanRenderState               m_currentRenderState;
 
@@ -175,10 +198,19 @@ namespace vk
 
         [[nodiscard]] Swapchain* createSwapchain(platform::Window* window, const Swapchain::SwapchainParams& params) override;
         void destroySwapchain(Swapchain* swapchain) override;
+        u32 getFramesInFlight() const override;
 
         [[nodiscard]] virtual SyncPoint* createSyncPoint(CmdList* cmd) override;
         void destroySyncPoint(CmdList* cmd, SyncPoint* sync) override;
 
+        bool compilePipeline(GraphicsPipelineState& state) override;
+        bool compilePipeline(ComputePipelineState& state) override;
+
+        [[nodiscard]] u32 registerBindlessTexture(const TextureView& texture) override;
+        void unregisterBindlessTexture(u32 index) override;
+        [[nodiscard]] u32 registerBindlessBuffer(Buffer* buffer) override;
+        void unregisterBindlessBuffer(u32 index) override;
+
         [[nodiscard]] TextureHandle createTexture(TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, u32 mipmapLevel, TextureUsageFlags flags, const std::string& name = "") override;
         [[nodiscard]] TextureHandle createTexture(TextureTarget target, Format format, const math::Dimension3D& dimension, u32 layers, TextureSamples samples, TextureUsageFlags flags, const std::string& name = "") override;
         void destroyTexture(TextureHandle texture) override;
@@ -205,6 +237,26 @@ namespace vk
         VulkanStagingBufferManager* getStaginBufferManager() const;
         VulkanPipelineLayoutManager* getPipelineLayoutManager() const;
         VulkanRenderpassManager* getRenderpassManager() const;
+        VulkanPipelineCache* getPipelineCache() const;
+        VulkanDescriptorHeap* getDescriptorHeap() const;
+
+        /**
+        * @brief PipelineStatistics struct. Collected always, the frame profiler gets the same values when it's enabled
+        */
+        struct PipelineStatistics
+        {
+            u64 _cacheHits = 0;
+            u64 _cacheMisses = 0;
+            u64 _compileStalls = 0;
+            u64 _compileStallTime = 0; //microseconds
+            u64 _pipelineBinds = 0;
+            u64 _descriptorSetBinds = 0;
+        };
+
+        /**
+        * @brief getPipelineStatistics. Totals since the initialization, the cache hits are collected by submit
+        */
+        PipelineStatistics getPipelineStatistics() const;
 
     private:
 
@@ -245,6 +297,14 @@ namespace vk
         VulkanComputePipelineManager*           m_computePipelineManager;
         VulkanSamplerManager*                   m_samplerManager;
 
+        VulkanPipelineCache*                    m_pipelineCache;
+        VulkanDescriptorHeap*                   m_descriptorHeap;
+
+        std::atomic<u64>                        m_compileStalls;
+        std::atomic<u64>                        m_compileStallTime;
+        std::atomic<u64>                        m_pipelineBinds;
+        std::atomic<u64>                        m_descriptorSetBinds;
+
         VulkanResourceDeleter                   m_resourceDeleter;
 
         struct Concurrency
@@ -323,6 +383,18 @@ namespace vk
         return m_renderpassManager;
     }
 
+    inline VulkanPipelineCache* VulkanDevice::getPipelineCache() const
+    {
+        ASSERT(m_pipelineCache, "nullptr");
+        return m_pipelineCache;
+    }
+
+    inline VulkanDescriptorHeap* VulkanDevice::getDescriptorHeap() const
+    {
+        //nullptr if bindless isn't supported
+        return m_descriptorHeap;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } //namespace vk
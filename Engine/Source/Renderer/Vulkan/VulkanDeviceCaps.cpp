@@ -183,6 +183,9 @@ void VulkanDeviceCaps::fillCapabilitiesList(const DeviceInfo* info)
     _supportDepthAutoResolve = isEnabledExtension(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME);
     _supportDedicatedAllocation = isEnabledExtension(VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME);
     _supportPipelineExecutableProperties = isEnabledExtension(VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+#ifdef VK_EXT_pipeline_creation_feedback
+    _supportPipelineCreationFeedback = isEnabledExtension(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+#endif
 
     _supportBlitImage = true;
 
@@ -255,6 +258,9 @@ void VulkanDeviceCaps::fillCapabilitiesList(const DeviceInfo* info)
 
 #ifdef VK_EXT_descriptor_indexing
             _supportDescriptorIndexing = _physicalDeviceDescriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+            _supportBindless = _physicalDeviceDescriptorIndexingFeatures.runtimeDescriptorArray && _physicalDeviceDescriptorIndexingFeatures.descriptorBindingPartiallyBound
+                && _physicalDeviceDescriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending && _physicalDeviceDescriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind
+                && _physicalDeviceDescriptorIndexingFeatures.descriptorBindingStorageBufferUpdateAfterBind && _physicalDeviceDescriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing;
 #endif
 #ifdef VK_EXT_custom_border_color
             _supportSamplerBorderColor = _physicalDeviceCustomBorderColorFeatures.customBorderColors && _physicalDeviceCustomBorderColorFeatures.customBorderColorWithoutFormat;
@@ -279,12 +285,11 @@ void VulkanDeviceCaps::fillCapabilitiesList(const DeviceInfo* info)
             vkExtensions = &_physicalDeviceMaintenance3Properties;
 
 #ifdef VK_EXT_descriptor_indexing
-            VkPhysicalDeviceDescriptorIndexingProperties physicalDeviceDescriptorIndexingProperties = {};
             if (isEnabledExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
             {
-                physicalDeviceDescriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
-                physicalDeviceDescriptorIndexingProperties.pNext = vkExtensions;
-                vkExtensions = &physicalDeviceDescriptorIndexingProperties;
+                _physicalDeviceDescriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+                _physicalDeviceDescriptorIndexingProperties.pNext = vkExtensions;
+                vkExtensions = &_physicalDeviceDescriptorIndexingProperties;
             }
 #endif
 
@@ -523,6 +528,28 @@ void VulkanDeviceCaps::initialize()
     LOG_INFO("VulkanDeviceCaps::initialize:  useDynamicUniforms is %s", _useDynamicUniforms ? "enable" : "disable");
     LOG_INFO("VulkanDeviceCaps::initialize:  useGlobalDescriptorPool is %s", _useGlobalDescriptorPool ? "enable" : "disable");
 
+#ifdef VK_EXT_descriptor_indexing
+    if (_supportBindless)
+    {
+        //The heap takes the last set, the other sets keep the room for the regular bindings of the stage
+        const VkPhysicalDeviceDescriptorIndexingPropertiesEXT& properties = _physicalDeviceDescriptorIndexingProperties;
+        const u32 reserved = k_maxDescriptorSlotsCount * k_bindlessDescriptorSet;
+        auto available = [reserved](u32 limit) -> u32
+            {
+                return (limit > reserved) ? limit - reserved : 0;
+            };
+
+        const u32 resources = available(properties.maxPerStageUpdateAfterBindResources);
+        _maxBindlessTextures = std::min({ k_maxBindlessTextures, resources, available(properties.maxDescriptorSetUpdateAfterBindSampledImages), available(properties.maxPerStageDescriptorUpdateAfterBindSampledImages) });
+        _maxBindlessBuffers = std::min({ k_maxBindlessBuffers, resources - _maxBindlessTextures, available(properties.maxDescriptorSetUpdateAfterBindStorageBuffers), available(properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers) });
+
+        _supportBindless = _maxDescriptorSets > k_bindlessDescriptorSet && _maxBindlessTextures > 0 && _maxBindlessBuffers > 0;
+    }
+#else
+    _supportBindless = false;
+#endif
+    LOG_INFO("VulkanDeviceCaps::initialize:  supportBindless is %s, textures %u, buffers %u", _supportBindless ? "enable" : "disable", _maxBindlessTextures, _maxBindlessBuffers);
+
     //check !!!!
     _immediateResourceSubmit = 0;
 
@@ -44,6 +44,7 @@ namespace vk
         bool _supportDedicatedAllocation = false;
 
         bool _supportPipelineExecutableProperties = false;
+        bool _supportPipelineCreationFeedback = false;
 
         bool _supportDescriptorIndexing = false;
 
@@ -70,6 +71,7 @@ namespace vk
 
         std::tuple<u32, u32> getQueueFamiliyIndex(VkQueueFlags queueFlags);
 
+        const VkPhysicalDeviceProperties& getPhysicalDeviceProperties() const;
         const VkPhysicalDeviceLimits& getPhysicalDeviceLimits() const;
         const VkPhysicalDeviceMemoryProperties&  getDeviceMemoryProperties() const;
         const VkPhysicalDeviceFeatures& getPhysicalDeviceFeatures() const;
@@ -104,6 +106,7 @@ namespace vk
         VkPhysicalDeviceMaintenance3Properties _physicalDeviceMaintenance3Properties = {};
 #ifdef VK_EXT_descriptor_indexing
         VkPhysicalDeviceDescriptorIndexingFeaturesEXT _physicalDeviceDescriptorIndexingFeatures = {};
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT _physicalDeviceDescriptorIndexingProperties = {};
 #endif
 #ifdef VK_EXT_custom_border_color
         VkPhysicalDeviceCustomBorderColorFeaturesEXT _physicalDeviceCustomBorderColorFeatures = {};
@@ -118,6 +121,11 @@ namespace vk
     };
 
 
+    inline const VkPhysicalDeviceProperties& VulkanDeviceCaps::getPhysicalDeviceProperties() const
+    {
+        return _deviceProperties;
+    }
+
     inline const VkPhysicalDeviceLimits& VulkanDeviceCaps::getPhysicalDeviceLimits() const
     {
         return _deviceProperties.limits;
@@ -9,8 +9,6 @@
 
 #if defined(PLATFORM_WINDOWS)
 #   define VK_USE_PLATFORM_WIN32_KHR
-#elif defined(PLATFORM_LINUX)
-#   define VK_USE_PLATFORM_XLIB_KHR
 #elif defined(PLATFORM_ANDROID)
 #   define VK_NO_PROTOTYPES
 #   define VK_USE_PLATFORM_ANDROID_KHR
@@ -3,6 +3,8 @@
 #include "Utils/Logger.h"
 #include "Renderer/ShaderProgram.h"
 #include "Thread/Thread.h"
+#include "Task/TaskScheduler.h"
+#include "Resource/ResourceManager.h"
 
 #ifdef VULKAN_RENDER
 #   include "VulkanDebug.h"
@@ -10,6 +12,7 @@
 #   include "VulkanSwapchain.h"
 #   include "VulkanImage.h"
 #   include "VulkanRenderpass.h"
+#   include "VulkanPipelineCache.h"
 //#include "VulkanDescriptorSet.h"
 
 #if defined(USE_SPIRV)
@@ -406,6 +409,8 @@ VulkanGraphicPipeline::VulkanGraphicPipeline(VulkanDevice* device, const std::st
 
     , m_compatibilityRenderPass(nullptr)
     , m_trackerRenderPass(nullptr, [](const std::vector<renderer::RenderPass*>&) {})
+    , m_compileTask(nullptr)
+    , m_compiled(true)
 {
 #if VULKAN_DEBUG
     LOG_DEBUG("VulkanGraphicPipeline::VulkanGraphicPipeline constructor %llx", this);
@@ -426,13 +431,12 @@ VulkanGraphicPipeline::~VulkanGraphicPipeline()
     ASSERT(!m_pipeline, "not nullptr");
 }
 
-bool VulkanGraphicPipeline::create(const GraphicsPipelineState& state)
+bool VulkanGraphicPipeline::create(const GraphicsPipelineState& state, VkPipelineCache pipelineCache)
 {
     ASSERT(getType() == PipelineType::PipelineType_Graphic, "invalid type");
 
     const GraphicsPipelineStateDesc& pipelineDesc = state.getPipelineStateDesc();
 
-    VkPipelineCache pipelineCache = VK_NULL_HANDLE; //TODO
     VkRenderPass compatibilityRenderPass = VK_NULL_HANDLE;
     void* vkExtentions = nullptr;
 
@@ -477,6 +481,21 @@ bool VulkanGraphicPipeline::create(const GraphicsPipelineState& state)
         compatibilityRenderPass = static_cast<VulkanRenderPass*>(m_compatibilityRenderPass)->getHandle();
     }
 
+#ifdef VK_EXT_pipeline_creation_feedback
+    VkPipelineCreationFeedbackEXT pipelineCreationFeedback = {};
+    VkPipelineCreationFeedbackCreateInfoEXT pipelineCreationFeedbackCreateInfo = {};
+    if (m_device.getVulkanDeviceCaps()._supportPipelineCreationFeedback)
+    {
+        pipelineCreationFeedbackCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+        pipelineCreationFeedbackCreateInfo.pNext = vkExtentions;
+        pipelineCreationFeedbackCreateInfo.pPipelineCreationFeedback = &pipelineCreationFeedback;
+        pipelineCreationFeedbackCreateInfo.pipelineStageCreationFeedbackCount = 0;
+        pipelineCreationFeedbackCreateInfo.pPipelineStageCreationFeedbacks = nullptr;
+
+        vkExtentions = &pipelineCreationFeedbackCreateInfo;
+    }
+#endif //VK_EXT_pipeline_creation_feedback
+
     VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo = {};
     graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     graphicsPipelineCreateInfo.pNext = vkExtentions;
@@ -813,6 +832,13 @@ bool VulkanGraphicPipeline::create(const GraphicsPipelineState& state)
         return false;
     }
 
+#ifdef VK_EXT_pipeline_creation_feedback
+    if (m_device.getVulkanDeviceCaps()._supportPipelineCreationFeedback)
+    {
+        m_device.getPipelineCache()->addFeedback(pipelineCreationFeedback);
+    }
+#endif //VK_EXT_pipeline_creation_feedback
+
 #if VULKAN_DEBUG_MARKERS
     if (m_device.getVulkanDeviceCaps()._debugUtilsObjectNameEnabled)
     {
@@ -860,6 +886,25 @@ void VulkanGraphicPipeline::destroy()
     }
 }
 
+bool VulkanGraphicPipeline::isCompiled() const
+{
+    return m_compiled.load(std::memory_order_acquire);
+}
+
+void VulkanGraphicPipeline::waitCompilation() const
+{
+    if (!VulkanGraphicPipeline::isCompiled())
+    {
+        ASSERT(m_compileTask, "nullptr");
+        m_compileTask->waitCompetition();
+    }
+}
+
+bool VulkanGraphicPipeline::isCompilationFailed() const
+{
+    return VulkanGraphicPipeline::isCompiled() && m_pipeline == VK_NULL_HANDLE;
+}
+
 bool VulkanGraphicPipeline::createShaderModules(const renderer::ShaderProgram* program)
 {
 #if RUNTIME_PATCH_SPIRV_REMOVE_UNUSED_LOCATIONS
@@ -1053,11 +1098,18 @@ VulkanGraphicPipeline* VulkanGraphicPipelineManager::acquireGraphicPipeline(cons
     auto found = m_pipelineGraphicList.find(desc);
     if (found != m_pipelineGraphicList.cend())
     {
-        return found->second;
+        VulkanGraphicPipeline* pipeline = found->second;
+        if (!pipeline->isCompilationFailed())
+        {
+            return pipeline;
+        }
+
+        m_pipelineGraphicList.erase(found);
+        m_failedPipelines.push_back(pipeline);
     }
 
     VulkanGraphicPipeline* pipeline = V3D_NEW(VulkanGraphicPipeline, memory::MemoryLabel::MemoryRenderCore)(&m_device, state.getName());
-    if (!pipeline->create(state))
+    if (!pipeline->create(state, m_device.getPipelineCache()->getHandle()))
     {
         ASSERT(false, "can't create pipeline");
         pipeline->destroy();
@@ -1071,22 +1123,104 @@ VulkanGraphicPipeline* VulkanGraphicPipelineManager::acquireGraphicPipeline(cons
     return pipeline;
 }
 
-bool VulkanGraphicPipelineManager::removePipeline(VulkanGraphicPipeline* pipeline, VulkanResourceDeleter& deleter)
+VulkanGraphicPipeline* VulkanGraphicPipelineManager::compileGraphicPipeline(const GraphicsPipelineState& state)
 {
-    ASSERT(pipeline->getType() == RenderPipeline::PipelineType::PipelineType_Graphic, "wrong type");
-    std::lock_guard lock(m_mutex);
+    resource::ResourceManager* resourceManager = resource::ResourceManager::getLazyInstance();
+    task::TaskScheduler* workers = resourceManager->acquireScheduler();
+    if (!workers)
+    {
+        return VulkanGraphicPipelineManager::acquireGraphicPipeline(state);
+    }
 
-    auto found = std::find_if(m_pipelineGraphicList.begin(), m_pipelineGraphicList.end(), [pipeline](auto& elem) -> bool
+    VulkanPipelineDesc desc(state.getPipelineStateDesc(), state.getRenderPassDesc(), state.getShaderProgram());
+    DescInfo<VulkanPipelineDesc> key(desc);
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto found = m_pipelineGraphicList.find(desc);
+        if (found != m_pipelineGraphicList.cend() && !found->second->isCompilationFailed())
         {
-            return elem.second == pipeline;
+            resourceManager->releaseScheduler();
+            return found->second;
+        }
+    }
+
+    const ShaderProgram* program = state.getShaderProgram();
+    const VertexShader* vertexShader = static_cast<const VertexShader*>(program->getShader(ShaderType::Vertex));
+    const FragmentShader* fragmentShader = static_cast<const FragmentShader*>(program->getShader(ShaderType::Fragment));
+    ShaderProgram* compileProgram = fragmentShader
+        ? V3D_NEW(ShaderProgram, memory::MemoryLabel::MemoryRenderCore)(&m_device, vertexShader, fragmentShader)
+        : V3D_NEW(ShaderProgram, memory::MemoryLabel::MemoryRenderCore)(&m_device, vertexShader);
+    GraphicsPipelineState* compileState = V3D_NEW(GraphicsPipelineState, memory::MemoryLabel::MemoryRenderCore)(&m_device, state.getPipelineStateDesc(), state.getRenderPassDesc(), compileProgram, state.getName());
+
+    VulkanGraphicPipeline* pipeline = V3D_NEW(VulkanGraphicPipeline, memory::MemoryLabel::MemoryRenderCore)(&m_device, state.getName());
+    pipeline->m_compiled.store(false, std::memory_order_relaxed);
+    pipeline->m_compileTask = m_taskPool.acquireTask();
+    pipeline->m_compileTask->init("CompileGraphicPipeline", [this, pipeline, compileState, compileProgram]() -> void
+        {
+            //Thread ids of the loading threads start from 1
+            VkPipelineCache pipelineCache = m_device.getPipelineCache()->getThreadHandle(task::TaskDispatcher::currentWorkerThreadID());
+            if (!pipeline->create(*compileState, pipelineCache))
+            {
+                //setPipelineState creates it again in place and reports the error
+                LOG_ERROR("VulkanGraphicPipelineManager::compileGraphicPipeline: can't create pipeline %s", compileState->getName().c_str());
+                pipeline->destroy();
+            }
+
+            V3D_DELETE(compileState, memory::MemoryLabel::MemoryRenderCore);
+            V3D_DELETE(compileProgram, memory::MemoryLabel::MemoryRenderCore);
+
+            pipeline->m_compiled.store(true, std::memory_order_release);
+            resource::ResourceManager::getLazyInstance()->releaseScheduler();
         });
 
-    if (found == m_pipelineGraphicList.cend())
     {
-        LOG_DEBUG("VulkanGraphicPipelineManager pipeline is not found");
-        ASSERT(false, "pipeline");
-        return false;
+        std::lock_guard lock(m_mutex);
+
+        auto found = m_pipelineGraphicList.find(desc);
+        if (found != m_pipelineGraphicList.cend())
+        {
+            if (!found->second->isCompilationFailed())
+            {
+                //The other thread has added it meanwhile
+                m_taskPool.releaseTask(pipeline->m_compileTask);
+                pipeline->m_compileTask = nullptr;
+                V3D_DELETE(pipeline, memory::MemoryLabel::MemoryRenderCore);
+                V3D_DELETE(compileState, memory::MemoryLabel::MemoryRenderCore);
+                V3D_DELETE(compileProgram, memory::MemoryLabel::MemoryRenderCore);
+
+                resourceManager->releaseScheduler();
+                return found->second;
+            }
+
+            m_failedPipelines.push_back(found->second);
+            m_pipelineGraphicList.erase(found);
+        }
+
+        [[maybe_unused]] auto inserted = m_pipelineGraphicList.emplace(key, pipeline);
+        ASSERT(inserted.second, "must be valid insertion");
+    }
+
+    workers->executeTask(pipeline->m_compileTask, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+
+    return pipeline;
+}
+
+void VulkanGraphicPipelineManager::releaseCompileTask(VulkanGraphicPipeline* pipeline)
+{
+    if (pipeline->m_compileTask)
+    {
+        //The pipeline is ready a bit earlier than the task is completed
+        pipeline->m_compileTask->waitCompetition();
+        m_taskPool.releaseTask(pipeline->m_compileTask);
+        pipeline->m_compileTask = nullptr;
     }
+}
+
+bool VulkanGraphicPipelineManager::removePipeline(VulkanGraphicPipeline* pipeline, VulkanResourceDeleter& deleter)
+{
+    ASSERT(pipeline->getType() == RenderPipeline::PipelineType::PipelineType_Graphic, "wrong type");
+    std::lock_guard lock(m_mutex);
 
     if (pipeline->linked())
     {
@@ -1095,7 +1229,29 @@ bool VulkanGraphicPipelineManager::removePipeline(VulkanGraphicPipeline* pipelin
         return false;
     }
 
-    m_pipelineGraphicList.erase(found);
+    auto found = std::find_if(m_pipelineGraphicList.begin(), m_pipelineGraphicList.end(), [pipeline](auto& elem) -> bool
+        {
+            return elem.second == pipeline;
+        });
+
+    if (found != m_pipelineGraphicList.cend())
+    {
+        m_pipelineGraphicList.erase(found);
+    }
+    else
+    {
+        auto failed = std::find(m_failedPipelines.begin(), m_failedPipelines.end(), pipeline);
+        if (failed == m_failedPipelines.end())
+        {
+            LOG_DEBUG("VulkanGraphicPipelineManager pipeline is not found");
+            ASSERT(false, "pipeline");
+            return false;
+        }
+
+        m_failedPipelines.erase(failed);
+    }
+
+    releaseCompileTask(pipeline);
     deleter.addResourceToDelete(pipeline, [](VulkanResource* resource) -> void
         {
             VulkanGraphicPipeline* vkPipeline = static_cast<VulkanGraphicPipeline*>(resource);
@@ -1119,10 +1275,19 @@ void VulkanGraphicPipelineManager::clear()
             ASSERT(false, "pipeline");
         }
 
+        releaseCompileTask(pipeline);
         pipeline->destroy();
         V3D_DELETE(pipeline, memory::MemoryLabel::MemoryRenderCore);
     }
     m_pipelineGraphicList.clear();
+
+    for (VulkanGraphicPipeline* pipeline : m_failedPipelines)
+    {
+        releaseCompileTask(pipeline);
+        pipeline->destroy();
+        V3D_DELETE(pipeline, memory::MemoryLabel::MemoryRenderCore);
+    }
+    m_failedPipelines.clear();
 }
 
 } //namespace vk
@@ -3,6 +3,7 @@
 #include "Renderer/Render.h"
 #include "Renderer/RenderTargetState.h"
 #include "Renderer/Pipeline.h"
+#include "Task/TaskPool.h"
 
 #ifdef VULKAN_RENDER
 #   include "VulkanWrapper.h"
@@ -56,9 +57,20 @@ namespace vk
         const VulkanPipelineLayout& getDescriptorSetLayouts() const;
         const VulkanPipelineLayoutDescription& getPipelineLayoutDescription() const;
 
-        bool create(const GraphicsPipelineState& state);
+        bool create(const GraphicsPipelineState& state, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
         void destroy();
 
+        /**
+        * @brief isCompiled. False while the pipeline is created in the background
+        */
+        bool isCompiled() const;
+        void waitCompilation() const;
+
+        /**
+        * @brief isCompilationFailed. The creation in the background is failed, the manager creates the pipeline again in place
+        */
+        bool isCompilationFailed() const;
+
     private:
 
         bool createShaderModules(const renderer::ShaderProgram* program);
@@ -78,12 +90,15 @@ namespace vk
         VulkanPipelineLayoutDescription                             m_pipelineLayoutDescription;
         VulkanPipelineLayout                                        m_pipelineLayout;
 
+        task::Task*                                                 m_compileTask;
+        std::atomic<bool>                                           m_compiled;
 
 #if VULKAN_DEBUG_MARKERS
         std::string m_debugName;
 #endif //VULKAN_DEBUG_MARKERS
 
         friend VulkanCommandBuffer;
+        friend class VulkanGraphicPipelineManager;
     };
 
     inline const VulkanPipelineLayout& VulkanGraphicPipeline::getDescriptorSetLayouts() const
@@ -160,8 +175,18 @@ namespace vk
         explicit VulkanGraphicPipelineManager(VulkanDevice* device) noexcept;
         ~VulkanGraphicPipelineManager();
 
+        /**
+        * @brief acquireGraphicPipeline. Creates the pipeline in place if it isn't found or its compilation is failed. nullptr if it can't be created
+        */
         [[nodiscard]] VulkanGraphicPipeline* acquireGraphicPipeline(const GraphicsPipelineState& state);
 
+        /**
+        * @brief compileGraphicPipeline. Creates the pipeline on the loading threads, returns it immediately.
+        * The job works on a copy of the state, the state and the program can be deleted before it's finished.
+        * Without the loading threads, or called from other threads, it's the same as acquireGraphicPipeline
+        */
+        [[nodiscard]] VulkanGraphicPipeline* compileGraphicPipeline(const GraphicsPipelineState& state);
+
         bool removePipeline(VulkanGraphicPipeline* pipeline, VulkanResourceDeleter& deleter);
         void clear();
 
@@ -170,9 +195,13 @@ namespace vk
         VulkanGraphicPipelineManager(const VulkanGraphicPipelineManager&) = delete;
         VulkanGraphicPipelineManager& operator=(const VulkanGraphicPipelineManager&) = delete;
 
+        void releaseCompileTask(VulkanGraphicPipeline* pipeline);
+
         VulkanDevice&    m_device;
         thread::Spinlock m_mutex;
+        task::TaskPool   m_taskPool;
         std::unordered_map<DescInfo<VulkanPipelineDesc>, VulkanGraphicPipeline*, DescInfo<VulkanPipelineDesc>::Hash, DescInfo<VulkanPipelineDesc>::Compare> m_pipelineGraphicList;
+        std::vector<VulkanGraphicPipeline*> m_failedPipelines; //Replaced in the list, they live until the states release them
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #   include "VulkanCommandBufferManager.h"
 #   include "VulkanStagingBuffer.h"
 #   include "VulkanCommandBuffer.h"
+#   include "VulkanSwapchain.h"
 
 namespace v3d
 {
@@ -1291,7 +1292,7 @@ void VulkanImage::clear(VulkanCommandBuffer* cmdBuffer, const color::Color& colo
         {
             if (VulkanImage::hasUsageFlag(TextureUsage::TextureUsage_Backbuffer))
             {
-                layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+                layout = VulkanSwapchain::selectPresentLayout(this, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
             }
             else if (VulkanImage::hasUsageFlag(TextureUsage::TextureUsage_Attachment))
             {
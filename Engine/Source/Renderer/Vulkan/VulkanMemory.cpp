@@ -43,6 +43,7 @@ VulkanMemory::VulkanAllocation VulkanMemory::s_invalidMemory =
     nullptr,
     nullptr,
     0,
+    0,
     0
 };
 
@@ -101,8 +102,6 @@ VulkanMemory::VulkanAllocation VulkanMemory::allocateImageMemory(VulkanMemoryAll
     }
 
     {
-        std::lock_guard<std::recursive_mutex> lock(s_mutex);
-
         s32 memoryTypeIndex = -1;
         VulkanAllocation memory = {};
         if (allocator.m_device.getVulkanDeviceCaps()._supportDedicatedAllocation)
@@ -221,8 +220,6 @@ VulkanMemory::VulkanAllocation VulkanMemory::allocateBufferMemory(VulkanMemoryAl
     }
 
     {
-        std::lock_guard<std::recursive_mutex> lock(s_mutex);
-
         VkMemoryRequirements memoryRequirements = {};
         VulkanWrapper::GetBufferMemoryRequirements(allocator.m_device.getDeviceInfo()._device, buffer, &memoryRequirements);
 
@@ -261,8 +258,6 @@ VulkanMemory::VulkanAllocation VulkanMemory::allocateBufferMemory(VulkanMemoryAl
 
 void VulkanMemory::freeMemory(VulkanMemoryAllocator& allocator, VulkanAllocation& memory)
 {
-    std::lock_guard lock(s_mutex);
-
     if (memory._property & MemoryProperty::dedicatedMemory)
     {
         SimpleVulkanMemoryAllocator simpleAllocator(&allocator.m_device);
@@ -392,259 +387,114 @@ PoolVulkanMemoryAllocator::~PoolVulkanMemoryAllocator()
 {
     for (u32 i = 0; i < VK_MAX_MEMORY_TYPES; ++i)
     {
-        ASSERT(m_heaps[i].empty(), "not empty");
-        m_heaps[i].clear();
+        ASSERT(m_heaps[i]._pools.empty(), "not empty");
+        m_heaps[i]._pools.clear();
     }
 }
 
-PoolVulkanMemoryAllocator::Pool::Pool() noexcept
-    : _memory(0)
-    , _size(0)
-    , _chunkSize(0)
+PoolVulkanMemoryAllocator::Pool::Pool(VkDeviceSize size) noexcept
+    : _allocator(size)
+    , _memory(VK_NULL_HANDLE)
+    , _size(size)
     , _mapped(nullptr)
+    , _flag(0)
     , _memoryTypeIndex(-1)
 {
 }
 
 VulkanMemory::VulkanAllocation PoolVulkanMemoryAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment, u32 memoryTypeIndex, const void* extensions)
 {
-    std::lock_guard lock(VulkanMemory::s_mutex);
-
     //The Vulkan spec states : memoryOffset must be an integer multiple of the alignment member of the VkMemoryRequirements structure returned from a call to vkGetImageMemoryRequirements with image
     //(https ://vulkan.lunarg.com/doc/view/1.3.296.0/windows/1.3-extensions/vkspec.html#VUID-vkBindImageMemory-memoryOffset-01048)
     VkDeviceSize alignedSize = math::alignUp<VkDeviceSize>(size, alignment);
 
     ASSERT(memoryTypeIndex < VK_MAX_MEMORY_TYPES, "out of range");
-    auto& heaps = m_heaps[memoryTypeIndex];
-    
+    Heap& heap = m_heaps[memoryTypeIndex];
+    std::lock_guard lock(heap._mutex);
+
     //find in heap
-    if (VulkanMemory::VulkanAllocation memory = {}; PoolVulkanMemoryAllocator::findAllocationFromPool(heaps, alignedSize, alignment, memory))
+    for (Pool* pool : heap._pools)
     {
-        return memory;
+        if (memory::OffsetAllocator::Allocation allocation = pool->_allocator.allocate(alignedSize, alignment); allocation.isValid())
+        {
+            return makeAllocation(pool, allocation, alignedSize, alignment);
+        }
     }
 
     //create new pool
-    u32 alignedAllocationSize = math::alignUp<VkDeviceSize>(m_allocationSize, alignment);
+    VkDeviceSize alignedAllocationSize = math::alignUp<VkDeviceSize>(m_allocationSize, alignment);
     ASSERT(alignedAllocationSize > alignedSize, "Too small size of pool. Set bigger");
-    Pool* newPool = createPool(alignedAllocationSize, alignedSize, memoryTypeIndex);
+    Pool* newPool = createPool(alignedAllocationSize, memoryTypeIndex);
     if (!newPool)
     {
         return VulkanMemory::s_invalidMemory;
     }
+    heap._pools.push_back(newPool);
 
-    MemoryChunck reqestedChunk = {};
-    reqestedChunk._size = alignedSize;
-    reqestedChunk._offset = 0;
-    newPool->_chunks.insert(reqestedChunk);
-
-    heaps.emplace(newPool->_chunkSize, newPool);
-
-    const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties = m_device.getVulkanDeviceCaps().getDeviceMemoryProperties();
-    VkMemoryPropertyFlags flag = physicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
-
-    return {
-        newPool->_memory,
-        alignedSize,
-        0,
-        alignment,
-        newPool->_mapped,
-        newPool,
-        flag,
-        0
-    };
+    memory::OffsetAllocator::Allocation allocation = newPool->_allocator.allocate(alignedSize, alignment);
+    ASSERT(allocation.isValid(), "must be valid");
 
-    return VulkanMemory::s_invalidMemory;
+    return makeAllocation(newPool, allocation, alignedSize, alignment);
 }
 
 void PoolVulkanMemoryAllocator::deallocate(VulkanMemory::VulkanAllocation& memory)
 {
-    std::lock_guard lock(VulkanMemory::s_mutex);
-
     Pool* pool = reinterpret_cast<Pool*>(memory._metadata);
     ASSERT(pool, "pool nullptr");
 
-    auto usedChunkIter = pool->_chunks.find({ memory._size, memory._offset });
-    ASSERT(usedChunkIter != pool->_chunks.cend(), "not found");
-    MemoryChunck usedChunk = const_cast<MemoryChunck&>(*usedChunkIter);
-
-    MemoryChunck newFreeChunk = {};
-    newFreeChunk._size = usedChunk._size;
-    newFreeChunk._offset = usedChunk._offset;
-
-
-    //left border
-    if (usedChunkIter != pool->_chunks.begin())
-    {
-        auto chunkPrevIter = std::next(usedChunkIter, -1);
-        auto freeChunkPrevIter = pool->_freeChunks.find(*chunkPrevIter);
-        if (freeChunkPrevIter != pool->_freeChunks.end())
-        {
-            ASSERT(usedChunk._offset >= freeChunkPrevIter->_size, "wrong");
-            if (usedChunk._offset - freeChunkPrevIter->_size == freeChunkPrevIter->_offset)
-            {
-                newFreeChunk._offset = freeChunkPrevIter->_offset;
-                newFreeChunk._size += freeChunkPrevIter->_size;
-
-                pool->_freeChunks.erase(freeChunkPrevIter);
-                pool->_chunks.erase(chunkPrevIter);
-            }
-        }
-    }
-
-    auto chunkNextIter = std::next(usedChunkIter, 1);
-    if (chunkNextIter != pool->_chunks.end())
-    {
-        auto freeChunkNextIter = pool->_freeChunks.find(*chunkNextIter);
-        if (freeChunkNextIter != pool->_freeChunks.end())
-        {
-            ASSERT(freeChunkNextIter->_offset >= newFreeChunk._size, "wrong");
-            if (freeChunkNextIter->_offset - newFreeChunk._size == newFreeChunk._offset)
-            {
-                newFreeChunk._offset = newFreeChunk._offset; //same
-                newFreeChunk._size += freeChunkNextIter->_size;
-
-                pool->_freeChunks.erase(freeChunkNextIter);
-                pool->_chunks.erase(chunkNextIter);
-            }
-        }
-    }
-
-    pool->_chunks.erase(usedChunkIter);
-    
-    pool->_freeChunks.insert(newFreeChunk);
-    pool->_chunks.insert(newFreeChunk);
-
-
-    auto& heaps = m_heaps[pool->_memoryTypeIndex];
-    auto poolIters = heaps.equal_range(pool->_chunkSize);
-
-    auto poolIter = heaps.end();
-    for (auto iter = poolIters.first; iter != poolIters.second; ++iter)
-    {
-        if (iter->second == pool)
-        {
-            poolIter = iter;
-            break;
-        }
-    }
-    ASSERT(poolIter != heaps.end(), "not found");
-
+    Heap& heap = m_heaps[pool->_memoryTypeIndex];
+    std::lock_guard lock(heap._mutex);
 
-    if (pool->_size == newFreeChunk._size)
+    pool->_allocator.free({ memory._offset, static_cast<u32>(memory._chunk) });
+    if (pool->_allocator.getAllocationCount() == 0)
     {
         //empty pool
-        ASSERT(pool->_chunks.size() == pool->_freeChunks.size(), "fail");
-        auto& heaps = m_heaps[pool->_memoryTypeIndex];
-
-        if (pool->_mapped)
-        {
-            ASSERT(pool->_memory, "nullptr");
-            VulkanWrapper::UnmapMemory(m_device.getDeviceInfo()._device, pool->_memory);
-        }
-
-        if (pool->_memory != VK_NULL_HANDLE)
-        {
-            VulkanWrapper::FreeMemory(m_device.getDeviceInfo()._device, pool->_memory, VULKAN_ALLOCATOR);
-        }
-
-        V3D_FREE(pool, memory::MemoryLabel::MemoryRenderCore);
-        heaps.erase(poolIter);
-    }
-    else
-    {
-        VkDeviceSize maxChuckSize = pool->_freeChunks.empty() ? 0 : pool->_freeChunks.rbegin()->_size;
-        if (maxChuckSize != pool->_chunkSize)
-        {
-            heaps.erase(poolIter);
+        auto poolIter = std::find(heap._pools.begin(), heap._pools.end(), pool);
+        ASSERT(poolIter != heap._pools.end(), "not found");
+        heap._pools.erase(poolIter);
 
-            pool->_chunkSize = maxChuckSize;
-            heaps.emplace(pool->_chunkSize, pool);
-        }
+        destroyPool(pool);
     }
 
     memory = VulkanMemory::s_invalidMemory;
 }
 
-bool PoolVulkanMemoryAllocator::findAllocationFromPool(std::multimap<VkDeviceSize, Pool*>& heaps, VkDeviceSize size, VkDeviceSize alignment, VulkanMemory::VulkanAllocation& memory)
+memory::OffsetAllocator::StorageReport PoolVulkanMemoryAllocator::getStorageReport(u32 memoryTypeIndex) const
 {
-    auto heapIter = heaps.lower_bound(size);
-    if (heapIter == heaps.cend())
-    {
-        return false;
-    }
-    Pool* pool = heapIter->second;
-
-    auto chunkSizeIter = pool->_freeChunks.lower_bound({ size, 0 });
-    if (chunkSizeIter == pool->_freeChunks.cend())
-    {
-        return false;
-    }
-    MemoryChunck chunkSize = const_cast<MemoryChunck&>(*chunkSizeIter);
-    pool->_freeChunks.erase(chunkSizeIter);
-
-    auto chunkOffsetIter = pool->_chunks.lower_bound(chunkSize);
-    if (chunkOffsetIter == pool->_chunks.cend())
-    {
-        return false;
-    }
-    pool->_chunks.erase(chunkOffsetIter);
-
+    ASSERT(memoryTypeIndex < VK_MAX_MEMORY_TYPES, "out of range");
+    const Heap& heap = m_heaps[memoryTypeIndex];
+    std::lock_guard lock(heap._mutex);
 
-    ASSERT(chunkSize._size >= size, "fail");
-    VkDeviceSize allocatedSize = 0;
-    VkDeviceSize allocatedOffset = 0;
-    if (chunkSize._size - size >= alignment)
-    {
-        MemoryChunck reqestedChunkSize;
-        reqestedChunkSize._size = size;
-        reqestedChunkSize._offset = math::alignUp(chunkSize._offset, alignment);
-        pool->_chunks.insert(reqestedChunkSize);
-        ASSERT(math::alignUp(reqestedChunkSize._size, alignment) == reqestedChunkSize._size, "must be aligment");
-        ASSERT(math::alignUp(reqestedChunkSize._offset, alignment) == reqestedChunkSize._offset, "must be aligment");
-
-        allocatedSize = reqestedChunkSize._size;
-        allocatedOffset = reqestedChunkSize._offset;
-
-        MemoryChunck freeChunkSize;
-        freeChunkSize._size = chunkSize._size - size;
-        freeChunkSize._offset = chunkSize._offset + size;
-
-        pool->_chunks.insert(freeChunkSize);
-        pool->_freeChunks.insert(freeChunkSize);
-    }
-    else
+    memory::OffsetAllocator::StorageReport report = {};
+    for (const Pool* pool : heap._pools)
     {
-        pool->_chunks.insert(chunkSize);
-
-        allocatedSize = chunkSize._size;
-        allocatedOffset = chunkSize._offset;
+        const memory::OffsetAllocator::StorageReport poolReport = pool->_allocator.getStorageReport();
+        report._totalFreeSpace += poolReport._totalFreeSpace;
+        report._largestFreeRegion = std::max(report._largestFreeRegion, poolReport._largestFreeRegion);
+        report._freeRegionCount += poolReport._freeRegionCount;
+        report._allocationCount += poolReport._allocationCount;
     }
 
-    const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties = m_device.getVulkanDeviceCaps().getDeviceMemoryProperties();
-    VkMemoryPropertyFlags flag = physicalDeviceMemoryProperties.memoryTypes[pool->_memoryTypeIndex].propertyFlags;
-
-    memory._memory = pool->_memory;
-    memory._size = allocatedSize;
-    memory._offset = allocatedOffset;
-    memory._alignment = alignment;
-    memory._mapped = pool->_mapped;
-    memory._metadata = pool;
-    //memory._flag = flag;
-    //memory._property
-
-    VkDeviceSize maxChuckSize = pool->_freeChunks.empty() ? 0 : pool->_freeChunks.rbegin()->_size;
-    if (maxChuckSize != pool->_chunkSize)
-    {
-        heaps.erase(heapIter);
-
-        pool->_chunkSize = maxChuckSize;
-        heaps.emplace(pool->_chunkSize, pool);
-    }
+    return report;
+}
 
-    return true;
+VulkanMemory::VulkanAllocation PoolVulkanMemoryAllocator::makeAllocation(Pool* pool, const memory::OffsetAllocator::Allocation& allocation, VkDeviceSize size, VkDeviceSize alignment)
+{
+    ASSERT(math::alignUp(allocation._offset, alignment) == allocation._offset, "must be aligment");
+    return {
+        pool->_memory,
+        size,
+        allocation._offset,
+        alignment,
+        pool->_mapped,
+        pool,
+        pool->_flag,
+        0,
+        allocation._node
+    };
 }
 
-PoolVulkanMemoryAllocator::Pool* PoolVulkanMemoryAllocator::createPool(VkDeviceSize poolSize, VkDeviceSize requestedSize, u32 memoryTypeIndex)
+PoolVulkanMemoryAllocator::Pool* PoolVulkanMemoryAllocator::createPool(VkDeviceSize poolSize, u32 memoryTypeIndex)
 {
     VkMemoryAllocateInfo memoryAllocateInfo = {};
     memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -660,24 +510,15 @@ PoolVulkanMemoryAllocator::Pool* PoolVulkanMemoryAllocator::createPool(VkDeviceS
         return nullptr;
     }
 
-    MemoryChunck freeMemoryChunk;
-    freeMemoryChunk._size = poolSize - requestedSize;
-    freeMemoryChunk._offset = requestedSize;
+    const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties = m_device.getVulkanDeviceCaps().getDeviceMemoryProperties();
 
-    Pool* newPool = V3D_NEW(Pool, memory::MemoryLabel::MemoryRenderCore)();
+    Pool* newPool = V3D_NEW(Pool, memory::MemoryLabel::MemoryRenderCore)(poolSize);
     newPool->_memory = deviceMemory;
-    newPool->_size = poolSize;
-    newPool->_chunkSize = poolSize - requestedSize;
     newPool->_mapped = nullptr;
+    newPool->_flag = physicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
     newPool->_memoryTypeIndex = memoryTypeIndex;
 
-    newPool->_chunks.insert(freeMemoryChunk);
-    newPool->_freeChunks.insert(freeMemoryChunk);
-
-    const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties = m_device.getVulkanDeviceCaps().getDeviceMemoryProperties();
-    VkMemoryPropertyFlags flag = physicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
-
-    if (flag & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    if (newPool->_flag & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
     {
         VkResult result = VulkanWrapper::MapMemory(m_device.getDeviceInfo()._device, newPool->_memory, 0, VK_WHOLE_SIZE, 0, &newPool->_mapped);
         if (result != VK_SUCCESS)
@@ -694,12 +535,30 @@ PoolVulkanMemoryAllocator::Pool* PoolVulkanMemoryAllocator::createPool(VkDeviceS
     return newPool;
 }
 
+void PoolVulkanMemoryAllocator::destroyPool(Pool* pool)
+{
+    if (pool->_mapped)
+    {
+        ASSERT(pool->_memory, "nullptr");
+        VulkanWrapper::UnmapMemory(m_device.getDeviceInfo()._device, pool->_memory);
+    }
+
+    if (pool->_memory != VK_NULL_HANDLE)
+    {
+        VulkanWrapper::FreeMemory(m_device.getDeviceInfo()._device, pool->_memory, VULKAN_ALLOCATOR);
+    }
+
+    V3D_DELETE(pool, memory::MemoryLabel::MemoryRenderCore);
+}
+
 #if VULKAN_DEBUG
 void PoolVulkanMemoryAllocator::linkVulkanObject(const VulkanMemory::VulkanAllocation& allocation, const VulkanResource* object)
 {
     if (allocation._metadata)
     {
-        reinterpret_cast<Pool*>(allocation._metadata)->_objectList.insert(object);
+        Pool* pool = reinterpret_cast<Pool*>(allocation._metadata);
+        std::lock_guard lock(m_heaps[pool->_memoryTypeIndex]._mutex);
+        pool->_objectList.insert(object);
     }
 }
 
@@ -707,7 +566,9 @@ void PoolVulkanMemoryAllocator::unlinkVulkanObject(const VulkanMemory::VulkanAll
 {
     if (allocation._metadata)
     {
-        reinterpret_cast<Pool*>(allocation._metadata)->_objectList.erase(object);
+        Pool* pool = reinterpret_cast<Pool*>(allocation._metadata);
+        std::lock_guard lock(m_heaps[pool->_memoryTypeIndex]._mutex);
+        pool->_objectList.erase(object);
     }
 }
 #endif //VULKAN_DEBUG
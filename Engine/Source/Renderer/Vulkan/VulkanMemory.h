@@ -4,6 +4,7 @@
 
 #ifdef VULKAN_RENDER
 #   include "VulkanWrapper.h"
+#   include "Memory/OffsetAllocator.h"
 
 namespace v3d
 {
@@ -47,6 +48,7 @@ namespace vk
             void*                   _metadata;
             VkMemoryPropertyFlags   _flag;
             u32                     _property;
+            u64                     _chunk; //Sub-allocation handle of the pool allocator
 
             bool operator==(const VulkanAllocation& op)
             {
@@ -135,6 +137,7 @@ namespace vk
 
     /**
     * @brief PoolVulkanMemoryAllocator class. Pool management allocation.
+    * Pools are sub-allocated by memory::OffsetAllocator, every memory type has own lock.
     * Multithreaded
     */
     class PoolVulkanMemoryAllocator final : public VulkanMemory::VulkanMemoryAllocator
@@ -149,6 +152,11 @@ namespace vk
         void unlinkVulkanObject(const VulkanMemory::VulkanAllocation& allocation, const VulkanResource* object) override;
 #endif //VULKAN_DEBUG
 
+        /**
+        * @brief getStorageReport. Free space and fragmentation of all pools of the memory type
+        */
+        memory::OffsetAllocator::StorageReport getStorageReport(u32 memoryTypeIndex) const;
+
     private:
 
         PoolVulkanMemoryAllocator() = delete;
@@ -157,61 +165,34 @@ namespace vk
         [[nodiscard]] VulkanMemory::VulkanAllocation allocate(VkDeviceSize size, VkDeviceSize align, u32 memoryTypeIndex, const void* extensions = nullptr) override;
         void deallocate(VulkanMemory::VulkanAllocation& memory) override;
 
-        struct MemoryChunck
-        {
-            VkDeviceSize _size;
-            VkDeviceSize _offset;
-        };
-
         struct Pool final
         {
-            struct ChunckSizeSort
-            {
-                bool operator()(const MemoryChunck& l, const MemoryChunck& r) const
-                {
-                    if (l._size < r._size)
-                    {
-                        return true;
-                    }
-                    else if (l._size > r._size)
-                    {
-                        return false;
-                    }
-
-                    return l._offset < r._offset;
-                }
-            };
-
-            struct ChunckOffsetSort
-            {
-                bool operator()(const MemoryChunck& l, const MemoryChunck& r) const
-                {
-                    return l._offset < r._offset;
-                }
-            };
-
-            Pool() noexcept;
+            explicit Pool(VkDeviceSize size) noexcept;
             ~Pool() = default;
 
-            std::set<MemoryChunck, ChunckOffsetSort>    _chunks;
-            std::set<MemoryChunck, ChunckSizeSort>      _freeChunks;
+            memory::OffsetAllocator                     _allocator;
             VkDeviceMemory                              _memory;
             VkDeviceSize                                _size;
-            VkDeviceSize                                _chunkSize;
             void*                                       _mapped;
+            VkMemoryPropertyFlags                       _flag;
             u32                                         _memoryTypeIndex;
 #if VULKAN_DEBUG
             std::set<const VulkanResource*>             _objectList;
 #endif //VULKAN_DEBUG
         };
 
-        bool findAllocationFromPool(std::multimap<VkDeviceSize, Pool*>& heaps, VkDeviceSize size, VkDeviceSize align, VulkanMemory::VulkanAllocation& memory);
-        [[nodiscard]] Pool* createPool(VkDeviceSize poolSize, VkDeviceSize requestedSize, u32 memoryTypeIndex);
+        struct Heap final
+        {
+            std::vector<Pool*>                          _pools;
+            mutable std::mutex                          _mutex;
+        };
 
+        static VulkanMemory::VulkanAllocation makeAllocation(Pool* pool, const memory::OffsetAllocator::Allocation& allocation, VkDeviceSize size, VkDeviceSize alignment);
+        [[nodiscard]] Pool* createPool(VkDeviceSize poolSize, u32 memoryTypeIndex);
+        void destroyPool(Pool* pool);
 
         VkDeviceSize m_allocationSize;
-        std::multimap<VkDeviceSize, Pool*> m_heaps[VK_MAX_MEMORY_TYPES];
-
+        Heap m_heaps[VK_MAX_MEMORY_TYPES];
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
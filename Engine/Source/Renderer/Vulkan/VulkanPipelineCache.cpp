@@ -0,0 +1,306 @@
+#include "VulkanPipelineCache.h"
+
+#include "Utils/Logger.h"
+#include "crc32c/crc32c.h"
+
+#ifdef VULKAN_RENDER
+#   include "VulkanDebug.h"
+#   include "VulkanDevice.h"
+
+namespace v3d
+{
+namespace renderer
+{
+namespace vk
+{
+
+constexpr u32 k_pipelineCacheMagic = 0x43503356; //V3PC
+constexpr u32 k_pipelineCacheVersion = 1;
+
+VulkanPipelineCache::VulkanPipelineCache(VulkanDevice* device) noexcept
+    : m_device(*device)
+    , m_pipelineCache(VK_NULL_HANDLE)
+    , m_hits(0)
+    , m_misses(0)
+    , m_compileTime(0)
+    , m_totalHits(0)
+    , m_totalMisses(0)
+{
+    LOG_DEBUG("VulkanPipelineCache::VulkanPipelineCache constructor %llx", this);
+}
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+    LOG_DEBUG("VulkanPipelineCache::~VulkanPipelineCache destructor %llx", this);
+    ASSERT(m_pipelineCache == VK_NULL_HANDLE, "not destroyed");
+}
+
+bool VulkanPipelineCache::create(const std::string& path, u32 countThreadCaches)
+{
+    ASSERT(m_pipelineCache == VK_NULL_HANDLE, "already created");
+    m_path = path;
+    //Without the caches the pipelines are created with the null handles
+    m_threadCaches.resize(countThreadCaches, VK_NULL_HANDLE);
+
+    std::vector<u8> data;
+    if (!VulkanPipelineCache::load(data))
+    {
+        data.clear();
+    }
+
+    m_pipelineCache = VulkanPipelineCache::createCache(data);
+    if (m_pipelineCache == VK_NULL_HANDLE && !data.empty())
+    {
+        //The driver can reject the data even with the valid header
+        LOG_WARNING("VulkanPipelineCache::create: the data of %s is rejected, starts with the empty cache", m_path.c_str());
+        data.clear();
+
+        m_pipelineCache = VulkanPipelineCache::createCache(data);
+    }
+
+    if (m_pipelineCache == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+
+    //Every compile thread starts from the loaded data as well, otherwise the background compilation never hits
+    for (VkPipelineCache& cache : m_threadCaches)
+    {
+        cache = VulkanPipelineCache::createCache(data);
+    }
+
+    LOG_INFO("VulkanPipelineCache::create: %s, loaded %llu bytes, thread caches %u", m_path.c_str(), data.size(), countThreadCaches);
+    return true;
+}
+
+void VulkanPipelineCache::destroy()
+{
+    if (m_pipelineCache == VK_NULL_HANDLE)
+    {
+        m_threadCaches.clear();
+        return;
+    }
+
+    std::vector<VkPipelineCache> threadCaches;
+    threadCaches.reserve(m_threadCaches.size());
+    for (VkPipelineCache cache : m_threadCaches)
+    {
+        if (cache != VK_NULL_HANDLE)
+        {
+            threadCaches.push_back(cache);
+        }
+    }
+
+    if (!threadCaches.empty())
+    {
+        VkResult result = VulkanWrapper::MergePipelineCaches(m_device.getDeviceInfo()._device, m_pipelineCache, static_cast<u32>(threadCaches.size()), threadCaches.data());
+        if (result != VK_SUCCESS)
+        {
+            LOG_ERROR("VulkanPipelineCache::destroy: vkMergePipelineCaches is failed. Error: %s", ErrorString(result).c_str());
+        }
+    }
+
+    VulkanPipelineCache::save();
+
+    for (VkPipelineCache cache : threadCaches)
+    {
+        VulkanWrapper::DestroyPipelineCache(m_device.getDeviceInfo()._device, cache, VULKAN_ALLOCATOR);
+    }
+    m_threadCaches.clear();
+
+    VulkanWrapper::DestroyPipelineCache(m_device.getDeviceInfo()._device, m_pipelineCache, VULKAN_ALLOCATOR);
+    m_pipelineCache = VK_NULL_HANDLE;
+
+    u64 hits = 0;
+    u64 misses = 0;
+    VulkanPipelineCache::collectStatistic(hits, misses);
+
+    const u64 totalHits = VulkanPipelineCache::getTotalHits();
+    const u64 totalMisses = VulkanPipelineCache::getTotalMisses();
+    if (totalHits + totalMisses > 0)
+    {
+        LOG_INFO("VulkanPipelineCache::destroy: hits %llu, misses %llu, hit rate %.1f%%, driver compile time %.2f ms", totalHits, totalMisses,
+            100.f * static_cast<f32>(totalHits) / static_cast<f32>(totalHits + totalMisses), static_cast<f32>(m_compileTime.load(std::memory_order_relaxed)) / 1'000'000.f);
+    }
+}
+
+#ifdef VK_EXT_pipeline_creation_feedback
+void VulkanPipelineCache::addFeedback(const VkPipelineCreationFeedbackEXT& feedback)
+{
+    if (!(feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT))
+    {
+        return;
+    }
+
+    if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+    {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_compileTime.fetch_add(feedback.duration, std::memory_order_relaxed);
+}
+#endif //VK_EXT_pipeline_creation_feedback
+
+void VulkanPipelineCache::collectStatistic(u64& hits, u64& misses)
+{
+    hits = m_hits.exchange(0, std::memory_order_relaxed);
+    misses = m_misses.exchange(0, std::memory_order_relaxed);
+
+    m_totalHits.fetch_add(hits, std::memory_order_relaxed);
+    m_totalMisses.fetch_add(misses, std::memory_order_relaxed);
+}
+
+void VulkanPipelineCache::fillHeader(Header& header) const
+{
+    const VkPhysicalDeviceProperties& properties = m_device.getVulkanDeviceCaps().getPhysicalDeviceProperties();
+
+    memset(&header, 0, sizeof(Header));
+    header._magic = k_pipelineCacheMagic;
+    header._version = k_pipelineCacheVersion;
+    header._vendorID = properties.vendorID;
+    header._deviceID = properties.deviceID;
+    header._driverVersion = properties.driverVersion;
+    memcpy(header._pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+bool VulkanPipelineCache::load(std::vector<u8>& data) const
+{
+    if (m_path.empty())
+    {
+        return false;
+    }
+
+    std::ifstream file(m_path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        LOG_DEBUG("VulkanPipelineCache::load: %s is not found", m_path.c_str());
+        return false;
+    }
+
+    Header expected = {};
+    VulkanPipelineCache::fillHeader(expected);
+
+    Header header = {};
+    file.read(reinterpret_cast<c8*>(&header), sizeof(Header));
+    if (!file || header._magic != expected._magic || header._version != expected._version)
+    {
+        LOG_WARNING("VulkanPipelineCache::load: %s has unknown format", m_path.c_str());
+        return false;
+    }
+
+    if (header._vendorID != expected._vendorID || header._deviceID != expected._deviceID || header._driverVersion != expected._driverVersion
+        || memcmp(header._pipelineCacheUUID, expected._pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        LOG_INFO("VulkanPipelineCache::load: %s is written by other device or driver, skipped", m_path.c_str());
+        return false;
+    }
+
+    if (header._size == 0 || header._size > std::numeric_limits<u32>::max())
+    {
+        LOG_WARNING("VulkanPipelineCache::load: %s has invalid size", m_path.c_str());
+        return false;
+    }
+
+    data.resize(header._size);
+    file.read(reinterpret_cast<c8*>(data.data()), header._size);
+    if (!file || crc32c::Crc32c(data.data(), data.size()) != header._crc)
+    {
+        LOG_WARNING("VulkanPipelineCache::load: %s is corrupted", m_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool VulkanPipelineCache::save() const
+{
+    if (m_path.empty())
+    {
+        return false;
+    }
+
+    size_t size = 0;
+    VkResult result = VulkanWrapper::GetPipelineCacheData(m_device.getDeviceInfo()._device, m_pipelineCache, &size, nullptr);
+    if (result != VK_SUCCESS || size == 0)
+    {
+        LOG_ERROR("VulkanPipelineCache::save: vkGetPipelineCacheData is failed. Error: %s", ErrorString(result).c_str());
+        return false;
+    }
+
+    std::vector<u8> data(size);
+    result = VulkanWrapper::GetPipelineCacheData(m_device.getDeviceInfo()._device, m_pipelineCache, &size, data.data());
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("VulkanPipelineCache::save: vkGetPipelineCacheData is failed. Error: %s", ErrorString(result).c_str());
+        return false;
+    }
+
+    Header header = {};
+    VulkanPipelineCache::fillHeader(header);
+    header._size = size;
+    header._crc = crc32c::Crc32c(data.data(), size);
+
+    //The file is replaced only when it's completely written
+    const std::string tempPath = m_path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARNING("VulkanPipelineCache::save: can't create %s", tempPath.c_str());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const c8*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const c8*>(data.data()), size);
+
+        file.close();
+        if (!file)
+        {
+            LOG_WARNING("VulkanPipelineCache::save: can't write %s", tempPath.c_str());
+
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_path, error);
+    if (error)
+    {
+        LOG_WARNING("VulkanPipelineCache::save: can't rename %s, %s", tempPath.c_str(), error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    LOG_INFO("VulkanPipelineCache::save: %s, %llu bytes", m_path.c_str(), static_cast<u64>(size));
+    return true;
+}
+
+VkPipelineCache VulkanPipelineCache::createCache(const std::vector<u8>& data) const
+{
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+    pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheCreateInfo.pNext = nullptr;
+    pipelineCacheCreateInfo.flags = 0;
+    pipelineCacheCreateInfo.initialDataSize = data.size();
+    pipelineCacheCreateInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    VkResult result = VulkanWrapper::CreatePipelineCache(m_device.getDeviceInfo()._device, &pipelineCacheCreateInfo, VULKAN_ALLOCATOR, &pipelineCache);
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("VulkanPipelineCache::createCache: vkCreatePipelineCache is failed. Error: %s", ErrorString(result).c_str());
+        return VK_NULL_HANDLE;
+    }
+
+    return pipelineCache;
+}
+
+} //namespace vk
+} //namespace renderer
+} //namespace v3d
+#endif //VULKAN_RENDER
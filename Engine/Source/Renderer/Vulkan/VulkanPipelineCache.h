@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Common.h"
+
+#ifdef VULKAN_RENDER
+#   include "VulkanWrapper.h"
+
+namespace v3d
+{
+namespace renderer
+{
+namespace vk
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    class VulkanDevice;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief VulkanPipelineCache class. Vulkan Render side.
+    * Keeps the driver pipeline cache between the runs. The file is loaded only if it was written by the same device and driver.
+    * The main cache is used by the recording threads, every loading thread has own cache for the compilation, they are merged to the main one on destroy
+    */
+    class VulkanPipelineCache final
+    {
+    public:
+
+        explicit VulkanPipelineCache(VulkanDevice* device) noexcept;
+        ~VulkanPipelineCache();
+
+        /**
+        * @brief create. Loads the file, a missing or invalid file gives the empty caches
+        * @param const std::string& path [required]
+        * @param u32 countThreadCaches [required] count of the thread ids, the loading threads get ids from 1
+        */
+        bool create(const std::string& path, u32 countThreadCaches);
+
+        /**
+        * @brief destroy. Merges the thread caches and writes the file
+        */
+        void destroy();
+
+        VkPipelineCache getHandle() const;
+
+        /**
+        * @brief getThreadHandle. The main cache for the threads without own one, it's internally synchronized
+        */
+        VkPipelineCache getThreadHandle(u32 thread) const;
+
+#ifdef VK_EXT_pipeline_creation_feedback
+        /**
+        * @brief addFeedback. Called by the pipeline creation from any thread
+        */
+        void addFeedback(const VkPipelineCreationFeedbackEXT& feedback);
+#endif //VK_EXT_pipeline_creation_feedback
+
+        /**
+        * @brief collectStatistic. Returns the hits and misses since the last call, any thread
+        */
+        void collectStatistic(u64& hits, u64& misses);
+
+        /**
+        * @brief getTotalHits/getTotalMisses. Collected since the creation
+        */
+        u64 getTotalHits() const;
+        u64 getTotalMisses() const;
+
+    private:
+
+        VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+        VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+
+        /**
+        * @brief Header struct. Written in front of the driver data
+        */
+        struct Header
+        {
+            u32 _magic;
+            u32 _version;
+            u32 _vendorID;
+            u32 _deviceID;
+            u32 _driverVersion;
+            u8  _pipelineCacheUUID[VK_UUID_SIZE];
+            u64 _size;
+            u32 _crc;
+        };
+
+        bool load(std::vector<u8>& data) const;
+        bool save() const;
+        void fillHeader(Header& header) const;
+
+        VkPipelineCache createCache(const std::vector<u8>& data) const;
+
+        VulkanDevice&                   m_device;
+        std::string                     m_path;
+
+        VkPipelineCache                 m_pipelineCache;
+        std::vector<VkPipelineCache>    m_threadCaches;
+
+        std::atomic<u64>                m_hits;
+        std::atomic<u64>                m_misses;
+        std::atomic<u64>                m_compileTime;
+        std::atomic<u64>                m_totalHits;
+        std::atomic<u64>                m_totalMisses;
+    };
+
+    inline VkPipelineCache VulkanPipelineCache::getHandle() const
+    {
+        return m_pipelineCache;
+    }
+
+    inline VkPipelineCache VulkanPipelineCache::getThreadHandle(u32 thread) const
+    {
+        if (thread < m_threadCaches.size() && m_threadCaches[thread] != VK_NULL_HANDLE)
+        {
+            return m_threadCaches[thread];
+        }
+
+        return m_pipelineCache;
+    }
+
+    inline u64 VulkanPipelineCache::getTotalHits() const
+    {
+        return m_totalHits.load(std::memory_order_relaxed);
+    }
+
+    inline u64 VulkanPipelineCache::getTotalMisses() const
+    {
+        return m_totalMisses.load(std::memory_order_relaxed);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace vk
+} //namespace renderer
+} //namespace v3d
+#endif //VULKAN_RENDER
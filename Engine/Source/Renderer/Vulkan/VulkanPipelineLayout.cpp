@@ -8,6 +8,7 @@
 #   include "VulkanDebug.h"
 #   include "VulkanDevice.h"
 #   include "VulkanDeviceCaps.h"
+#   include "VulkanDescriptorHeap.h"
 
 namespace v3d
 {
@@ -112,6 +113,14 @@ VulkanPipelineLayout VulkanPipelineLayoutManager::acquirePipelineLayout(const Vu
         for (u32 setId = 0; setId < maxSets; ++setId)
         {
             auto& set = desc._bindingsSet[setId];
+            if (setId == k_bindlessDescriptorSet && m_device.getDescriptorHeap())
+            {
+                //Owned by the heap, all pipelines share the same set
+                ASSERT(VulkanDescriptorSetLayoutDescription(set) == VulkanDescriptorSetLayoutDescription(m_device.getDescriptorHeap()->getLayoutBindings()), "must be the heap bindings");
+                layout._setLayouts[setId] = m_device.getDescriptorHeap()->getDescriptorSetLayout();
+                continue;
+            }
+
             layout._setLayouts[setId] = VulkanPipelineLayoutManager::acquireDescriptorSetLayout(set);
             if (!layout._setLayouts[setId])
             {
@@ -265,7 +274,7 @@ void VulkanPipelineLayoutManager::destroyDescriptorSetLayouts(std::array<VkDescr
 {
     for (auto& set : descriptorSetLayouts)
     {
-        if (set != VK_NULL_HANDLE)
+        if (set != VK_NULL_HANDLE && !(m_device.getDescriptorHeap() && set == m_device.getDescriptorHeap()->getDescriptorSetLayout()))
         {
             VulkanWrapper::DestroyDescriptorSetLayout(m_device.getDeviceInfo()._device, set, VULKAN_ALLOCATOR);
         }
@@ -478,6 +487,16 @@ VulkanPipelineLayoutManager::DescriptorSetLayoutCreator::DescriptorSetLayoutCrea
             }
         }
 
+        if (setIndex == k_bindlessDescriptorSet && device.getDescriptorHeap() && !descriptorSetLayoutBindings.empty())
+        {
+            //The shader declares the unbounded arrays, the layout is the whole heap
+            ASSERT(std::all_of(descriptorSetLayoutBindings.cbegin(), descriptorSetLayoutBindings.cend(), [](const VkDescriptorSetLayoutBinding& binding)
+                {
+                    return binding.binding < VulkanDescriptorHeap::Binding_Count;
+                }), "unknown binding of the bindless set");
+            descriptorSetLayoutBindings = device.getDescriptorHeap()->getLayoutBindings();
+        }
+
         if (!descriptorSetLayoutBindings.empty())
         {
             maxSetIndex = std::max(maxSetIndex, setIndex);
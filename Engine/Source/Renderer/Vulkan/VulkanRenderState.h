@@ -101,6 +101,11 @@ namespace vk
         void bind(BindingType type, u32 slot, u32 set, u32 binding, VulkanSampler* sampler);
         void bindPushConstant(ShaderType type, u32 size, const void* data);
 
+        /**
+        * @brief isBound. The uniform range is in the slot of the current set
+        */
+        bool isBound(u32 set, u32 slot, u32 binding, const VulkanBuffer* buffer, u64 offset) const;
+
         void init(VulkanDevice* device);
         void invalidate();
 
@@ -190,11 +195,21 @@ namespace vk
             layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
         }
 
+        VkDescriptorImageInfo imageInfo = makeVkDescriptorImageInfo(image, nullptr, layout, subresource);
         BindingInfo& bindingInfo = _boundSetInfo[set]._bindings[slot];
+
+        //The same view is in the set already, e.g. the material of the previous draw
+        if ((_boundSetInfo[set]._activeBindingsFlags & (1 << binding)) && _boundSetInfo[set]._resource[slot] == image && bindingInfo._binding == binding && bindingInfo._type == type
+            && bindingInfo._arrayIndex == arrayIndex && bindingInfo._info._imageInfo.imageView == imageInfo.imageView && bindingInfo._info._imageInfo.imageLayout == imageInfo.imageLayout)
+        {
+            addImageBarrier(image, subresource, layout);
+            return;
+        }
+
         bindingInfo._binding = binding;
         bindingInfo._arrayIndex = arrayIndex;
         bindingInfo._type = type;
-        bindingInfo._info._imageInfo = makeVkDescriptorImageInfo(image, nullptr, layout, subresource);
+        bindingInfo._info._imageInfo = imageInfo;
 
         _boundSetInfo[set]._resource[slot] = image;
         _boundSetInfo[set]._activeBindingsFlags |= 1 << binding;
@@ -208,6 +223,11 @@ namespace vk
     {
         ASSERT(type == BindingType::Sampler, "wrong type");
         BindingInfo& bindingInfo = _boundSetInfo[set]._bindings[slot];
+        if ((_boundSetInfo[set]._activeBindingsFlags & (1 << binding)) && _boundSetInfo[set]._resource[slot] == sampler && bindingInfo._binding == binding && bindingInfo._type == type)
+        {
+            return;
+        }
+
         bindingInfo._binding = binding;
         bindingInfo._arrayIndex = 0;
         bindingInfo._type = type;
@@ -219,6 +239,13 @@ namespace vk
         setDirty(DirtyStateMask(DirtyState_DescriptorSet + set));
     }
 
+    inline bool VulkanRenderState::isBound(u32 set, u32 slot, u32 binding, const VulkanBuffer* buffer, u64 offset) const
+    {
+        const BindingInfo& bindingInfo = _boundSetInfo[set]._bindings[slot];
+        return (_boundSetInfo[set]._activeBindingsFlags & (1 << binding)) && _boundSetInfo[set]._resource[slot] == buffer && bindingInfo._binding == binding
+            && bindingInfo._type == BindingType::Uniform && bindingInfo._info._bufferInfo.offset == offset;
+    }
+
     inline void VulkanRenderState::bindPushConstant(ShaderType type, u32 size, const void* data)
     {
         ASSERT(toEnumType(type) <= toEnumType(ShaderType::Count), "out of range");
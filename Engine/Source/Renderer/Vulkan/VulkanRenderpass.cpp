@@ -7,6 +7,7 @@
 #   include "VulkanDeviceCaps.h"
 #   include "VulkanDevice.h"
 #   include "VulkanImage.h"
+#   include "VulkanSwapchain.h"
 #   include "VulkanCommandBufferManager.h"
 
 namespace v3d
@@ -78,6 +79,13 @@ VulkanRenderPass::VulkanRenderPass(VulkanDevice* device, const RenderPassDesc& r
         {
             desc._swapchainImage = framebufferDesc._imageViews[index]._texture->hasUsageFlag(TextureUsage::TextureUsage_Backbuffer) ? true : false;
             desc._autoResolve = framebufferDesc._imageViews[index]._texture->hasUsageFlag(TextureUsage::TextureUsage_Resolve) ? true : false;
+
+            //Same as VulkanSwapchain::selectPresentLayout, the pass can be created before an image is acquired
+            const VulkanSwapchain* swapchain = desc._swapchainImage ? static_cast<const VulkanSwapchain*>(framebufferDesc._imageViews[index]._texture->getTextureHandle().as<Swapchain>()) : nullptr;
+            if (swapchain && swapchain->isOffscreen() && desc._finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+            {
+                desc._finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            }
         }
         else
         {
@@ -18,6 +18,7 @@ namespace vk
     class VulkanFence;
     class VulkanImage;
     class VulkanCommandBuffer;
+    class VulkanDescriptorHeap;
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -39,6 +40,7 @@ namespace vk
         VulkanResource& operator=(const VulkanResource&) = delete;
 
         void markUsed(VulkanFence* fence, u64 value, u64 frame);
+        void inheritUsage(const VulkanResource& other);
 #if VULKAN_DEBUG_MARKERS
         virtual void fenceTracker(VulkanFence* fence, u64 value, u64 frame) {};
 #endif
@@ -49,6 +51,7 @@ namespace vk
 #endif //VULKAN_DEBUG
 
         friend VulkanCommandBuffer;
+        friend VulkanDescriptorHeap;
     };
 
     inline bool VulkanResource::isUsed() const
@@ -98,6 +101,37 @@ namespace vk
         }
     }
 
+    /**
+    * @brief inheritUsage. The resource is used by the command buffers which use the other one, the later value of the same fence is kept
+    */
+    inline void VulkanResource::inheritUsage(const VulkanResource& other)
+    {
+        TRACE_PROFILER_RENDER_SCOPE("inheritUsage", color::rgba8::BLACK);
+
+        std::unordered_map<VulkanFence*, std::tuple<u64, u64>> fanceInfo;
+        {
+            std::lock_guard lock(other.m_mutex);
+            fanceInfo = other.m_fanceInfo;
+        }
+
+        std::lock_guard lock(m_mutex);
+        for (auto& [fence, info] : fanceInfo)
+        {
+#if VULKAN_DEBUG
+            ++m_refCount;
+#endif //VULKAN_DEBUG
+            auto found = m_fanceInfo.find(fence);
+            if (found == m_fanceInfo.end())
+            {
+                m_fanceInfo.emplace(fence, info);
+            }
+            else if (std::get<0>(found->second) < std::get<0>(info))
+            {
+                found->second = info;
+            }
+        }
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
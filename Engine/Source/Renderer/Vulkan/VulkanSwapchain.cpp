@@ -9,6 +9,14 @@
 #   include "VulkanDevice.h"
 #   include "VulkanImage.h"
 #   include "VulkanSemaphore.h"
+#   include "VulkanBuffer.h"
+#   include "VulkanCommandBuffer.h"
+
+#ifdef USE_STB
+#   define STB_IMAGE_WRITE_IMPLEMENTATION
+#   define STB_IMAGE_WRITE_STATIC
+#   include <stb/stb_image_write.h>
+#endif //USE_STB
 
 #define DEBUG_FENCE_ACQUIRE 0
 
@@ -92,9 +100,11 @@ VulkanSwapchain::VulkanSwapchain(VulkanDevice* device, VulkanSemaphoreManager* c
     , m_acquireSync(V3D_NEW(VulkanSyncPoint, memory::MemoryLabel::MemoryRenderCore))
 
     , m_presentQueue(VK_NULL_HANDLE)
+    , m_readbackBuffer(nullptr)
 
     , m_insideFrame(false)
     , m_ready(false)
+    , m_offscreen(false)
 {
     LOG_DEBUG("VulkanSwapchain constructor %llx", this);
 }
@@ -111,6 +121,8 @@ VulkanSwapchain::~VulkanSwapchain()
     ASSERT(!m_swapchain, "swapchain is not nullptr");
     ASSERT(m_acquiredSemaphores.empty(), "not empty");
     ASSERT(!m_surface, "surface isn't nullptr");
+    ASSERT(m_offscreenImages.empty(), "not empty");
+    ASSERT(!m_readbackBuffer, "readback buffer isn't nullptr");
 }
 
 SyncPoint* VulkanSwapchain::getSyncPoint()
@@ -126,7 +138,10 @@ void VulkanSwapchain::beginFrame()
     [[maybe_unused]] u32 prevImageIndex = VulkanSwapchain::currentSwapchainIndex();
     [[maybe_unused]] u32 index = acquireImage();
 
-    m_acquireSync->m_waitSubmitSemaphores.push_back(VulkanSwapchain::getCurrentAcquiredSemaphore());
+    if (!m_offscreen)
+    {
+        m_acquireSync->m_waitSubmitSemaphores.push_back(VulkanSwapchain::getCurrentAcquiredSemaphore());
+    }
 
 #if VULKAN_DEBUG
     LOG_DEBUG("VulkanContext::beginFrame %llu, image index %u", m_frameCounter, index);
@@ -160,7 +175,11 @@ void VulkanSwapchain::presentFrame(SyncPoint* sync)
     LOG_DEBUG("VulkanContext::presentFrame %llu", m_frameCounter);
 #endif //VULKAN_DEBUG
 
-    if (m_presentQueue)
+    if (m_offscreen)
+    {
+        VulkanSwapchain::presentOffscreen();
+    }
+    else if (m_presentQueue)
     {
 #if SWAPCHAIN_ON_ADVANCE
         VulkanSwapchain::present(m_presentQueue, lastCmdList->m_presentedSwapchainSemaphores);
@@ -219,6 +238,11 @@ bool VulkanSwapchain::create(platform::Window* window, const SwapchainParams& pa
         return true;
     }
 
+    if (!window->getWindowHandle())
+    {
+        return VulkanSwapchain::createOffscreen(window, params);
+    }
+
     math::Dimension2D size = params._size;
     ASSERT(window->getSize() == size, "must be same");
 
@@ -488,12 +512,33 @@ bool VulkanSwapchain::createSwapchain(const SwapchainParams& params, const VkSur
 
 bool VulkanSwapchain::createSwapchainImages(const SwapchainParams& params, const VkSurfaceFormatKHR& surfaceFormat, TextureUsageFlags flags)
 {
-    u32 swapChainImageCount;
-    VkResult result = vkGetSwapchainImagesKHR(m_device.getDeviceInfo()._device, m_swapchain, &swapChainImageCount, nullptr);
-    if (result != VK_SUCCESS)
+    std::vector<VkImage> images;
+    u32 swapChainImageCount = 0;
+    if (m_offscreen)
     {
-        LOG_FATAL("VulkanSwapchain::createSwapchainImages: vkGetSwapchainImagesKHR count. Error %s", ErrorString(result).c_str());
-        return false;
+        swapChainImageCount = static_cast<u32>(m_offscreenImages.size());
+        images.reserve(swapChainImageCount);
+        for (auto& [image, memory] : m_offscreenImages)
+        {
+            images.push_back(image);
+        }
+    }
+    else
+    {
+        VkResult result = vkGetSwapchainImagesKHR(m_device.getDeviceInfo()._device, m_swapchain, &swapChainImageCount, nullptr);
+        if (result != VK_SUCCESS)
+        {
+            LOG_FATAL("VulkanSwapchain::createSwapchainImages: vkGetSwapchainImagesKHR count. Error %s", ErrorString(result).c_str());
+            return false;
+        }
+
+        images.resize(swapChainImageCount);
+        result = vkGetSwapchainImagesKHR(m_device.getDeviceInfo()._device, m_swapchain, &swapChainImageCount, images.data());
+        if (result != VK_SUCCESS)
+        {
+            LOG_FATAL("VulkanSwapchain::createSwapchainImages: vkGetSwapchainImagesKHR array. Error %s", ErrorString(result).c_str());
+            return false;
+        }
     }
 
     if (swapChainImageCount < 2)
@@ -504,14 +549,6 @@ bool VulkanSwapchain::createSwapchainImages(const SwapchainParams& params, const
 
     LOG_DEBUG("VulkanSwapchain::createSwapchainImages: Count images %d", swapChainImageCount);
 
-    std::vector<VkImage> images(swapChainImageCount);
-    result = vkGetSwapchainImagesKHR(m_device.getDeviceInfo()._device, m_swapchain, &swapChainImageCount, images.data());
-    if (result != VK_SUCCESS)
-    {
-        LOG_FATAL("VulkanSwapchain::createSwapchainImages: vkGetSwapchainImagesKHR array. Error %s", ErrorString(result).c_str());
-        return false;
-    }
-
     if (m_swapchainImages.empty())
     {
         m_swapchainImages.reserve(swapChainImageCount);
@@ -587,11 +624,20 @@ void VulkanSwapchain::destroy()
         m_surface = VK_NULL_HANDLE;
     }
 
+    VulkanSwapchain::destroyOffscreenImages();
+    if (m_readbackBuffer)
+    {
+        m_readbackBuffer->destroy();
+        V3D_DELETE(m_readbackBuffer, memory::MemoryLabel::MemoryRenderCore);
+        m_readbackBuffer = nullptr;
+    }
+
     m_swapchainResources.clear();
 
     Swapchain::cleanup();
 
     m_ready = false;
+    m_offscreen = false;
 }
 
 void VulkanSwapchain::present(VkQueue queue, const std::vector<VulkanSemaphore*>& waitSemaphores)
@@ -673,6 +719,13 @@ u32 VulkanSwapchain::acquireImage()
 #if VULKAN_DEBUG
     LOG_DEBUG("VulkanSwapchain::acquireImage semaphoreIndex: %u", m_currentSemaphoreIndex);
 #endif //VULKAN_DEBUG
+    if (m_offscreen)
+    {
+        //The images are owned, the frames are already ordered by the queue
+        m_currentImageIndex = (m_currentImageIndex + 1) % static_cast<u32>(m_swapchainImages.size());
+        return m_currentImageIndex;
+    }
+
     VulkanSemaphore* semaphore = m_acquiredSemaphores[m_currentSemaphoreIndex];
     m_semaphoreManager->markSemaphore(semaphore, VulkanSemaphore::SemaphoreStatus::AssignForSignal);
     VkFence fence = VK_NULL_HANDLE;
@@ -787,6 +840,8 @@ bool VulkanSwapchain::recteate(platform::Window* window, const SwapchainParams&
         m_surface = VK_NULL_HANDLE;
     }
 
+    VulkanSwapchain::destroyOffscreenImages();
+
     if (!VulkanSwapchain::create(window, params, VK_NULL_HANDLE/*oldSwapchain*/))
     {
         LOG_FATAL("VulkanSwapchain::recteate: is failed");
@@ -796,6 +851,212 @@ bool VulkanSwapchain::recteate(platform::Window* window, const SwapchainParams&
     return true;
 }
 
+bool VulkanSwapchain::createOffscreen(platform::Window* window, const SwapchainParams& params)
+{
+    const math::Dimension2D size = params._size;
+    VkFormat format = VulkanImage::convertImageFormatToVkFormat(params._format);
+    if (format == VK_FORMAT_UNDEFINED)
+    {
+        format = VK_FORMAT_B8G8R8A8_UNORM;
+    }
+    LOG_DEBUG("VulkanSwapchain::createOffscreen size { %d, %d }, format %s", size._width, size._height, VulkanImage::imageFormatStringVK(format).c_str());
+
+    m_offscreen = true;
+    m_surfaceCapabilities.currentTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+
+    VkImageCreateInfo imageCreateInfo = {};
+    imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageCreateInfo.pNext = nullptr;
+    imageCreateInfo.flags = 0;
+    imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.format = format;
+    imageCreateInfo.extent = { size._width, size._height, 1 };
+    imageCreateInfo.mipLevels = 1;
+    imageCreateInfo.arrayLayers = 1;
+    imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.queueFamilyIndexCount = 0;
+    imageCreateInfo.pQueueFamilyIndices = nullptr;
+    imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    const u32 imageCount = std::max(params._countSwapchainImages, 2U);
+    ASSERT(m_offscreenImages.empty(), "must be empty");
+    m_offscreenImages.reserve(imageCount);
+    for (u32 index = 0; index < imageCount; ++index)
+    {
+        VkImage image = VK_NULL_HANDLE;
+        VkResult result = VulkanWrapper::CreateImage(m_device.getDeviceInfo()._device, &imageCreateInfo, VULKAN_ALLOCATOR, &image);
+        if (result != VK_SUCCESS)
+        {
+            LOG_FATAL("VulkanSwapchain::createOffscreen: vkCreateImage. Error %s", ErrorString(result).c_str());
+            return false;
+        }
+
+        VulkanMemory::VulkanAllocation memory = VulkanMemory::allocateImageMemory(*m_device.m_imageMemoryManager, image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (memory == VulkanMemory::s_invalidMemory)
+        {
+            VulkanWrapper::DestroyImage(m_device.getDeviceInfo()._device, image, VULKAN_ALLOCATOR);
+
+            LOG_FATAL("VulkanSwapchain::createOffscreen: can't allocate memory for image");
+            return false;
+        }
+
+        m_offscreenImages.emplace_back(image, memory);
+    }
+
+    const VkSurfaceFormatKHR surfaceFormat = { format, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+    TextureUsageFlags flags = TextureUsage::TextureUsage_Backbuffer | TextureUsage::TextureUsage_Attachment | TextureUsage::TextureUsage_Sampled | TextureUsage::TextureUsage_Read;
+    if (!VulkanSwapchain::createSwapchainImages(params, surfaceFormat, flags))
+    {
+        LOG_FATAL("VulkanSwapchain::createOffscreen: cannot create swapchain images");
+        return false;
+    }
+
+    if (!params._dumpDirectory.empty() && params._dumpInterval > 0)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(params._dumpDirectory, error);
+        if (error)
+        {
+            LOG_WARNING("VulkanSwapchain::createOffscreen: can't create the dump directory %s. Error %s", params._dumpDirectory.c_str(), error.message().c_str());
+        }
+    }
+
+    m_window = window;
+    m_params = params;
+    m_params._countSwapchainImages = static_cast<u32>(m_swapchainImages.size());
+    m_params._format = VulkanImage::convertVkImageFormatToFormat(format);
+
+    Swapchain::setup(&m_device, m_params._format, size, flags);
+
+    m_ready = true;
+    return true;
+}
+
+void VulkanSwapchain::destroyOffscreenImages()
+{
+    for (auto& [image, memory] : m_offscreenImages)
+    {
+        VulkanWrapper::DestroyImage(m_device.getDeviceInfo()._device, image, VULKAN_ALLOCATOR);
+        VulkanMemory::freeMemory(*m_device.m_imageMemoryManager, memory);
+    }
+    m_offscreenImages.clear();
+}
+
+void VulkanSwapchain::presentOffscreen()
+{
+    ASSERT(m_offscreen, "must be offscreen");
+    //The submits don't signal semaphores for the offscreen frames, only the dumped frames are read back
+    const bool dump = m_params._dumpInterval > 0 && !m_params._dumpDirectory.empty() && (m_frameCounter % m_params._dumpInterval) == 0;
+    if (!dump)
+    {
+        return;
+    }
+
+    VulkanImage* image = VulkanSwapchain::getCurrentSwapchainImage();
+    const VkExtent3D extent = image->getSize();
+    const u64 size = static_cast<u64>(extent.width) * extent.height * 4;
+    if (m_readbackBuffer && m_readbackBuffer->getSize() < size)
+    {
+        m_readbackBuffer->destroy();
+        V3D_DELETE(m_readbackBuffer, memory::MemoryLabel::MemoryRenderCore);
+        m_readbackBuffer = nullptr;
+    }
+
+    if (!m_readbackBuffer)
+    {
+        m_readbackBuffer = V3D_NEW(VulkanBuffer, memory::MemoryLabel::MemoryRenderCore)(&m_device, m_device.m_bufferMemoryManager, RenderBuffer::Type::StagingBuffer, size, BufferUsage::Buffer_GPURead, "SwapchainReadbackBuffer");
+        if (!m_readbackBuffer->create())
+        {
+            LOG_ERROR("VulkanSwapchain::presentOffscreen: can't create readback buffer");
+            m_readbackBuffer->destroy();
+            V3D_DELETE(m_readbackBuffer, memory::MemoryLabel::MemoryRenderCore);
+            m_readbackBuffer = nullptr;
+
+            return;
+        }
+    }
+
+    VulkanCommandBuffer* cmdBuffer = m_device.m_internalCmdBufferManager->acquireNewCmdBuffer(Device::DeviceMask::GraphicMask, CommandBufferLevel::PrimaryBuffer);
+    cmdBuffer->beginCommandBuffer();
+
+    //The frame ends in TRANSFER_SRC_OPTIMAL, see selectPresentLayout. The image stays in it
+    cmdBuffer->cmdPipelineBarrier(image, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = extent;
+    cmdBuffer->cmdCopyImageToBuffer(image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readbackBuffer, { region });
+
+    cmdBuffer->endCommandBuffer();
+    m_device.m_internalCmdBufferManager->submit(cmdBuffer, {});
+    cmdBuffer->getResourceStateTracker().finalizeGlobalState();
+
+    cmdBuffer->waitCompletion();
+    VulkanSwapchain::writeImage(image, m_frameCounter);
+}
+
+VkImageLayout VulkanSwapchain::selectPresentLayout(const VulkanImage* image, VkImageLayout layout)
+{
+    //Without a surface the images are never presented, PRESENT_SRC_KHR needs VK_KHR_swapchain
+    if (layout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR && image->hasUsageFlag(TextureUsage::TextureUsage_Backbuffer))
+    {
+        const VulkanSwapchain* swapchain = VulkanImage::getSwapchainFromImage(image);
+        if (swapchain && swapchain->isOffscreen())
+        {
+            return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        }
+    }
+
+    return layout;
+}
+
+void VulkanSwapchain::writeImage(const VulkanImage* image, u64 frame)
+{
+#ifdef USE_STB
+    const VkFormat format = image->getFormat();
+    const bool bgra = format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB;
+    const bool rgba = format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB;
+    if (!bgra && !rgba)
+    {
+        LOG_WARNING("VulkanSwapchain::writeImage: format %s is not supported", VulkanImage::imageFormatStringVK(format).c_str());
+        return;
+    }
+
+    const VkExtent3D extent = image->getSize();
+    std::vector<u8> pixels(static_cast<u64>(extent.width) * extent.height * 4);
+
+    const u8* data = reinterpret_cast<const u8*>(m_readbackBuffer->map());
+    ASSERT(data, "nullptr");
+    for (u64 pixel = 0; pixel < pixels.size(); pixel += 4)
+    {
+        pixels[pixel + 0] = data[pixel + (bgra ? 2 : 0)];
+        pixels[pixel + 1] = data[pixel + 1];
+        pixels[pixel + 2] = data[pixel + (bgra ? 0 : 2)];
+        pixels[pixel + 3] = 255; //the swapchain alpha is undefined
+    }
+    m_readbackBuffer->unmap();
+
+    c8 filename[32];
+    std::snprintf(filename, sizeof(filename), "frame_%06llu.png", static_cast<unsigned long long>(frame));
+    const std::string path = (std::filesystem::path(m_params._dumpDirectory) / filename).string();
+    if (!stbi_write_png(path.c_str(), static_cast<s32>(extent.width), static_cast<s32>(extent.height), 4, pixels.data(), static_cast<s32>(extent.width) * 4))
+    {
+        LOG_ERROR("VulkanSwapchain::writeImage: can't write %s", path.c_str());
+        return;
+    }
+    LOG_DEBUG("VulkanSwapchain::writeImage: frame %llu is written to %s", frame, path.c_str());
+#else
+    LOG_WARNING("VulkanSwapchain::writeImage: not supported, stb is disabled");
+#endif //USE_STB
+}
+
 void VulkanSwapchain::attachResource(VulkanResource* resource, const std::function<bool(VulkanResource*)>& recreator)
 {
     m_swapchainResources.emplace_back(resource, recreator);
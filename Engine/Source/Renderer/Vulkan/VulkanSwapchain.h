@@ -4,6 +4,7 @@
 
 #ifdef VULKAN_RENDER
 #   include "VulkanWrapper.h"
+#   include "VulkanMemory.h"
 
 namespace v3d
 {
@@ -23,6 +24,7 @@ namespace vk
 #   define SWAPCHAIN_ON_ADVANCE 0
 
     class VulkanDevice;
+    class VulkanBuffer;
     class VulkanCmdList;
     class VulkanResource;
     class VulkanImage;
@@ -33,7 +35,8 @@ namespace vk
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
-    *  @brief VulkanSwapchain final class. Vulkan Render side
+    *  @brief VulkanSwapchain final class. Vulkan Render side.
+    *  Renders to own offscreen images if the window doesn't have a native handle (headless)
     */
     class VulkanSwapchain final : public Swapchain
     {
@@ -58,6 +61,13 @@ namespace vk
 
         VkSurfaceTransformFlagBitsKHR getTransformFlag() const;
 
+        bool isOffscreen() const;
+
+        /**
+        * @brief selectPresentLayout. The layout of a presented swapchain image. The offscreen images end the frame in TRANSFER_SRC_OPTIMAL instead of PRESENT_SRC_KHR
+        */
+        static VkImageLayout selectPresentLayout(const VulkanImage* image, VkImageLayout layout);
+
     public:
 
         explicit VulkanSwapchain(VulkanDevice* device, VulkanSemaphoreManager* semaphoreManager) noexcept;
@@ -81,6 +91,11 @@ namespace vk
         bool createSwapchain(const SwapchainParams& params, const VkSurfaceFormatKHR& surfaceFormat, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
         bool createSwapchainImages(const SwapchainParams& params, const VkSurfaceFormatKHR& surfaceFormat, TextureUsageFlags flags);
 
+        bool createOffscreen(platform::Window* window, const SwapchainParams& params);
+        void destroyOffscreenImages();
+        void presentOffscreen();
+        void writeImage(const VulkanImage* image, u64 frame);
+
         VulkanDevice&                       m_device;
         platform::Window*                   m_window;
         SwapchainParams                     m_params;
@@ -100,11 +115,15 @@ namespace vk
 
         VkQueue                             m_presentQueue;
 
+        std::vector<std::tuple<VkImage, VulkanMemory::VulkanAllocation>> m_offscreenImages;
+        VulkanBuffer*                       m_readbackBuffer;
+
         void recreateAttachedResources();
         std::vector<std::tuple<VulkanResource*, const std::function<bool(VulkanResource*)>>> m_swapchainResources;
 
         bool m_insideFrame;
         bool m_ready;
+        bool m_offscreen;
     };
 
     inline VulkanImage* VulkanSwapchain::getSwapchainImage(u32 index) const
@@ -146,6 +165,11 @@ namespace vk
         return m_surfaceCapabilities.currentTransform;
     }
 
+    inline bool VulkanSwapchain::isOffscreen() const
+    {
+        return m_offscreen;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } //namespace vk
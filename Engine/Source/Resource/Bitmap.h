@@ -26,6 +26,7 @@ namespace resource
             bool generateMipmaps = false;
             bool srgb = false;
             bool flipY = false;
+            MipmapFilter mipmapFilter = MipmapFilter::Box;
         };
 
         /**
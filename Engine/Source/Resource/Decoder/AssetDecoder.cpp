@@ -1,4 +1,5 @@
 #include "AssetDecoder.h"
+#include "FrameProfiler.h"
 
 #include "Utils/Logger.h"
 #include "Utils/Timer.h"
@@ -34,6 +35,8 @@ namespace resource
 
 Resource* AssetDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("AssetDecoder::decode");
+
     if (!stream || stream->size() == 0)
     {
 
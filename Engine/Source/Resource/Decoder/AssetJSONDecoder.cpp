@@ -1,4 +1,5 @@
 #include "AssetJSONDecoder.h"
+#include "FrameProfiler.h"
 
 #include "Utils/Timer.h"
 #include "Utils/Logger.h"
@@ -40,6 +41,8 @@ AssetJSONDecoder::AssetJSONDecoder(std::vector<std::string>&& supportedExtension
 
 Resource* AssetJSONDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("AssetJSONDecoder::decode");
+
     if (!stream || stream->size() == 0)
     {
 
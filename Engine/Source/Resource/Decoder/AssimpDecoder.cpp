@@ -1,4 +1,5 @@
 #include "AssimpDecoder.h"
+#include "FrameProfiler.h"
 
 #include "Renderer/Formats.h"
 #include "Stream/StreamManager.h"
@@ -57,6 +58,8 @@ AssimpDecoder::~AssimpDecoder()
 
 Resource* AssimpDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("AssimpDecoder::decode");
+
     if (stream->size() > 0)
     {
         stream->seekBeg(0);
@@ -1,4 +1,5 @@
 #include "ImageGLiDecoder.h"
+#include "FrameProfiler.h"
 
 #include "Stream/StreamManager.h"
 #include "Resource/Bitmap.h"
@@ -275,6 +276,8 @@ BitmapGLiDecoder::~BitmapGLiDecoder()
 
 Resource* BitmapGLiDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("BitmapGLiDecoder::decode");
+
     if (stream->size() > 0)
     {
         stream->seekBeg(0);
@@ -364,6 +367,8 @@ TextureGLiDecoder::~TextureGLiDecoder()
 
 Resource* TextureGLiDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("TextureGLiDecoder::decode");
+
     if (stream->size() > 0)
     {
         stream->seekBeg(0);
@@ -1,4 +1,5 @@
 #include "ImageStbDecoder.h"
+#include "FrameProfiler.h"
 
 #include "Stream/StreamManager.h"
 #include "Resource/Bitmap.h"
@@ -6,10 +7,10 @@
 #include "Utils/Logger.h"
 #include "Utils/Timer.h"
 #include "Resource/Loader/ImageFileLoader.h"
+#include "Resource/MipmapGenerator.h"
 
 #ifdef USE_STB
 #   define STB_IMAGE_IMPLEMENTATION
-#   define STB_IMAGE_RESIZE_IMPLEMENTATION
 #   define STBI_NO_STDIO
 
 #   define STBI_ONLY_JPEG
@@ -22,7 +23,6 @@
 //#    define STBI_ONLY_PIC
 
 #   include <stb/stb_image.h>
-#   include <stb/stb_image_resize.h>
 
 #define LOG_LOADIMG_TIME (DEBUG || 1)
 
@@ -31,56 +31,31 @@ namespace v3d
 namespace resource
 {
 
-static stream::Stream* generateMipMaps(void* baseMipmap, u32 width, u32 height, u32 componentsCount, u32 componentSize, u32 componentType, u32& mipmapsCount)
+static stream::Stream* generateMipMaps(void* baseMipmap, u32 width, u32 height, u32 componentsCount, MipmapGenerator::ComponentType componentType, bool srgb, MipmapFilter filter, u32& mipmapsCount)
 {
     ASSERT(baseMipmap, "nullptr");
 
-    auto calculateMipSizes = [](u32 width, u32 height, u32 componentCount, u32 sizeBytes, std::vector<std::tuple<u32, u32>>& mipmapsArray) -> u32
-        {
-            u32 currentWidth = width;
-            u32 currentHeight = height;
-            u32 countBytes = currentWidth * currentHeight * componentCount * sizeBytes;
-            mipmapsArray.push_back({ currentWidth, currentHeight });
-
-            while (currentWidth != 1U && currentHeight != 1U)
-            {
-                currentWidth = std::max(currentWidth / 2, 1U);
-                currentHeight = std::max(currentHeight / 2, 1U);
-                countBytes += currentWidth * currentHeight * componentCount * sizeBytes;
-
-                mipmapsArray.push_back({ currentWidth, currentHeight });
-            }
+    MipmapGenerator::ImageDesc desc;
+    desc._width = width;
+    desc._height = height;
+    desc._components = componentsCount;
+    desc._type = componentType;
+    desc._srgb = srgb;
 
-            return countBytes;
-        };
+    mipmapsCount = MipmapGenerator::calculateMipmapCount(width, height);
+    u64 mipMapsInBytes = MipmapGenerator::calculateMipmapChainSize(desc, mipmapsCount);
+    ASSERT(mipMapsInBytes <= std::numeric_limits<u32>::max(), "too big");
 
-    std::vector<std::tuple<u32, u32>> mipMapsSizes;
-    u32 mipMapsInBytes = calculateMipSizes(width, height, componentsCount, componentSize, mipMapsSizes);
-    stream::Stream* dataStream = stream::StreamManager::createMemoryStream(nullptr, mipMapsInBytes);
+    stream::Stream* dataStream = stream::StreamManager::createMemoryStream(nullptr, static_cast<u32>(mipMapsInBytes));
     ASSERT(dataStream, "nullptr");
 
-    u32 baseMipmapSize = width * height * componentsCount * componentSize;
-    dataStream->write(baseMipmap, baseMipmapSize); //copy a base mipmap
+    //The levels are written straight into the stream memory
+    u8* chain = reinterpret_cast<u8*>(dataStream->map(dataStream->size()));
+    u32 baseMipmapSize = static_cast<u32>(MipmapGenerator::calculateMipmapChainSize(desc, 1));
+    memcpy(chain, baseMipmap, baseMipmapSize); //copy a base mipmap
 
-    void* srcData = baseMipmap;
-    stbir_colorspace colorspace = STBIR_COLORSPACE_LINEAR;
-    for (u32 mip = 1; mip < mipMapsSizes.size(); ++mip)
-    {
-        u32 mipmapSize = std::get<0>(mipMapsSizes[mip]) * std::get<1>(mipMapsSizes[mip]) * componentsCount * componentSize;
-        void* dstData = dataStream->map(mipmapSize);
-
-        s32 result = stbir_resize(reinterpret_cast<u8*>(srcData), std::get<0>(mipMapsSizes[mip - 1]), std::get<1>(mipMapsSizes[mip - 1]), 0,
-            reinterpret_cast<u8*>(dstData), std::get<0>(mipMapsSizes[mip]), std::get<1>(mipMapsSizes[mip]), 0, (stbir_datatype)componentType, componentsCount,
-            -1, 0, STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP, STBIR_FILTER_DEFAULT, STBIR_FILTER_DEFAULT, colorspace, nullptr);
-        ASSERT(result, "mipmap generate failed");
-
-        dataStream->unmap();
-        dataStream->seekCur(mipmapSize);
-
-        srcData = dstData;
-    }
-
-    mipmapsCount = static_cast<u32>(mipMapsSizes.size());
+    MipmapGenerator::getLazyInstance()->generate(desc, filter, mipmapsCount, chain);
+    dataStream->unmap();
 
     dataStream->seekBeg(0);
     return dataStream;
@@ -133,7 +108,7 @@ static stream::Stream* readImage(u8* source, u32 sizeInBytes, const TPolicy& pol
 
         if (policy.generateMipmaps)
         {
-            dataStream = generateMipMaps(stbData, width, height, componentCount, sizeof(f32), STBIR_TYPE_FLOAT, mipmaps);
+            dataStream = generateMipMaps(stbData, width, height, componentCount, MipmapGenerator::ComponentType::Float32, false, policy.mipmapFilter, mipmaps);
         }
         else
         {
@@ -183,7 +158,7 @@ static stream::Stream* readImage(u8* source, u32 sizeInBytes, const TPolicy& pol
 
         if (policy.generateMipmaps)
         {
-            dataStream = generateMipMaps(stbData, width, height, componentCount, sizeof(u16), STBIR_TYPE_UINT16, mipmaps);
+            dataStream = generateMipMaps(stbData, width, height, componentCount, MipmapGenerator::ComponentType::UNorm16, false, policy.mipmapFilter, mipmaps);
         }
         else
         {
@@ -234,7 +209,7 @@ static stream::Stream* readImage(u8* source, u32 sizeInBytes, const TPolicy& pol
 
         if (policy.generateMipmaps)
         {
-            dataStream = generateMipMaps(stbData, width, height, componentCount, sizeof(u8), STBIR_TYPE_UINT8, mipmaps);
+            dataStream = generateMipMaps(stbData, width, height, componentCount, MipmapGenerator::ComponentType::UNorm8, policy.srgb, policy.mipmapFilter, mipmaps);
         }
         else
         {
@@ -265,6 +240,8 @@ BitmapStbDecoder::~BitmapStbDecoder()
 
 Resource* BitmapStbDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("BitmapStbDecoder::decode");
+
     if (stream->size() > 0)
     {
         stream->seekBeg(0);
@@ -352,6 +329,8 @@ TextureStbDecoder::~TextureStbDecoder()
 
 Resource* TextureStbDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("TextureStbDecoder::decode");
+
     if (stream->size() > 0)
     {
         stream->seekBeg(0);
@@ -1,5 +1,7 @@
 #include "ShaderDXCDecoder.h"
+#include "FrameProfiler.h"
 #include "Stream/StreamManager.h"
+#include "Resource/ShaderCache.h"
 #include "Stream/FileLoader.h"
 #include "Utils/Logger.h"
 #include "Utils/Timer.h"
@@ -74,6 +76,8 @@ ShaderDXCDecoder::ShaderDXCDecoder(std::vector<std::string>&& supportedExtension
 
 Resource* ShaderDXCDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("ShaderDXCDecoder::decode");
+
     if (!stream || stream->size() == 0)
     {
         LOG_ERROR("ShaderDXCDecoder::decode the stream is empty");
@@ -104,39 +108,56 @@ Resource* ShaderDXCDecoder::decode(const stream::Stream* stream, const resource:
         timer.start();
 #endif //LOG_LOADIMG_TIME
 
-        IDxcBlob* binaryShader = nullptr;
-        if (!ShaderDXCDecoder::compile(source, shaderPolicy, m_compileFlags, binaryShader, name))
+        ShaderCache* cache = ShaderCache::getLazyInstance();
+        ShaderCache::Key cacheKey;
+        stream::Stream* resourceBinary = nullptr;
+        const bool useCache = cache->isEnabled() && ShaderCache::computeKey(source, shaderPolicy, m_compileFlags, ShaderDXCDecoder::getCompilerVersion(), cacheKey);
+        if (useCache)
+        {
+            resourceBinary = cache->load(cacheKey);
+        }
+
+        if (!resourceBinary)
         {
-            if (binaryShader)
+            IDxcBlob* binaryShader = nullptr;
+            if (!ShaderDXCDecoder::compile(source, shaderPolicy, m_compileFlags, binaryShader, name))
             {
-                binaryShader->Release();
+                if (binaryShader)
+                {
+                    binaryShader->Release();
+                }
+
+                LOG_ERROR("ShaderDXCDecoder::decode: compile is failed");
+                return nullptr;
             }
 
-            LOG_ERROR("ShaderDXCDecoder::decode: compile is failed");
-            return nullptr;
-        }
+            ASSERT(binaryShader, "nullptr");
+            u32 bytecodeSize = static_cast<u32>(binaryShader->GetBufferSize());
+            resourceBinary = stream::StreamManager::createMemoryStream();
 
-        ASSERT(binaryShader, "nullptr");
-        u32 bytecodeSize = static_cast<u32>(binaryShader->GetBufferSize());
-        stream::Stream* resourceBinary = stream::StreamManager::createMemoryStream();
+            resourceBinary->write<renderer::ShaderType>(shaderPolicy.type);
+            resourceBinary->write<renderer::ShaderModel>(shaderPolicy.shaderModel);
+            resourceBinary->write(shaderPolicy.entryPoint);
+            resourceBinary->write<u32>(bytecodeSize);
+            resourceBinary->write(binaryShader->GetBufferPointer(), bytecodeSize);
+            resourceBinary->write<bool>(shaderPolicy.useReflection);
 
-        resourceBinary->write<renderer::ShaderType>(shaderPolicy.type);
-        resourceBinary->write<renderer::ShaderModel>(shaderPolicy.shaderModel);
-        resourceBinary->write(shaderPolicy.entryPoint);
-        resourceBinary->write<u32>(bytecodeSize);
-        resourceBinary->write(binaryShader->GetBufferPointer(), bytecodeSize);
-        resourceBinary->write<bool>(shaderPolicy.useReflection);
+            if (shaderPolicy.useReflection && !ShaderDXCDecoder::reflect(resourceBinary, shaderPolicy, m_compileFlags, binaryShader, name))
+            {
+                LOG_ERROR("ShaderDXCDecoder::decode: reflect is failed");
 
-        if (shaderPolicy.useReflection && !ShaderDXCDecoder::reflect(resourceBinary, shaderPolicy, m_compileFlags, binaryShader, name))
-        {
-            LOG_ERROR("ShaderDXCDecoder::decode: reflect is failed");
+                binaryShader->Release();
+                stream::StreamManager::destroyStream(resourceBinary);
 
+                return nullptr;
+            }
             binaryShader->Release();
-            stream::StreamManager::destroyStream(resourceBinary);
 
-            return nullptr;
+            if (useCache)
+            {
+                cache->store(cacheKey, resourceBinary);
+            }
         }
-        binaryShader->Release();
 
         renderer::Shader::ShaderHeader shaderHeader(shaderPolicy.type);
         resource::ResourceHeader::fill(&shaderHeader, name, resourceBinary->size(), 0);
@@ -166,6 +187,46 @@ Resource* ShaderDXCDecoder::decode(const stream::Stream* stream, const resource:
     }
 }
 
+std::string ShaderDXCDecoder::getCompilerVersion()
+{
+    //Compiled shaders are cached on disk, an update of dxcompiler must invalidate them
+    static const std::string s_version = []() -> std::string
+        {
+            u32 major = 0;
+            u32 minor = 0;
+            u32 commitCount = 0;
+            std::string commitHash;
+
+            IDxcCompiler3* DXCompiler = nullptr;
+            if (SUCCEEDED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&DXCompiler))))
+            {
+                IDxcVersionInfo* versionInfo = nullptr;
+                if (SUCCEEDED(DXCompiler->QueryInterface(IID_PPV_ARGS(&versionInfo))))
+                {
+                    versionInfo->GetVersion(&major, &minor);
+                    versionInfo->Release();
+                }
+
+                IDxcVersionInfo2* versionInfo2 = nullptr;
+                if (SUCCEEDED(DXCompiler->QueryInterface(IID_PPV_ARGS(&versionInfo2))))
+                {
+                    c8* hash = nullptr;
+                    if (SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &hash)) && hash)
+                    {
+                        commitHash = hash;
+                        CoTaskMemFree(hash);
+                    }
+                    versionInfo2->Release();
+                }
+                DXCompiler->Release();
+            }
+
+            return std::format("dxc {}.{}.{} {}", major, minor, commitCount, commitHash);
+        }();
+
+    return s_version;
+}
+
 bool ShaderDXCDecoder::compile(const std::string& source, const renderer::Shader::LoadPolicy& policy, ShaderCompileFlags flags, IDxcBlob*& shader, const std::string& name)
 {
     auto getShaderTarget = [](renderer::ShaderType type, renderer::ShaderModel model) -> std::wstring
@@ -39,6 +39,7 @@ namespace resource
 
         static bool compile(const std::string& source, const renderer::Shader::LoadPolicy& policy, ShaderCompileFlags flags, IDxcBlob*& shader, const std::string& name = "");
         static bool reflect(stream::Stream* stream, const renderer::Shader::LoadPolicy& policy, ShaderCompileFlags flags, IDxcBlob* shader, const std::string& name = "");
+        static std::string getCompilerVersion();
 
         ShaderCompileFlags m_compileFlags;
     };
@@ -1,4 +1,5 @@
 #include "ShaderHLSLDecoder.h"
+#include "FrameProfiler.h"
 #include "Stream/FileLoader.h"
 #include "Stream/StreamManager.h"
 
@@ -64,6 +65,8 @@ ShaderHLSLDecoder::ShaderHLSLDecoder(std::vector<std::string> supportedExtension
 
 Resource* ShaderHLSLDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("ShaderHLSLDecoder::decode");
+
     if (stream->size() > 0)
     {
         stream->seekBeg(0);
@@ -1131,6 +1134,8 @@ ShaderHLSLDecoder::ShaderHLSLDecoder(std::vector<std::string> supportedExtension
 
 Resource* ShaderHLSLDecoder::decode(const stream::Stream* stream, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("ShaderHLSLDecoder::decode");
+
     ASSERT(false, "is't supported");
     return nullptr;
 }
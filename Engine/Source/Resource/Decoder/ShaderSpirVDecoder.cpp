@@ -1,8 +1,10 @@
 ﻿#include "ShaderSpirVDecoder.h"
+#include "FrameProfiler.h"
 
 #include "Stream/FileLoader.h"
 #include "Stream/StreamManager.h"
 #include "Stream/FileStream.h"
+#include "Resource/ShaderCache.h"
 #include "Platform.h"
 
 #include "Utils/Logger.h"
@@ -60,8 +62,30 @@ ShaderSpirVDecoder::ShaderSpirVDecoder(std::vector<std::string>&& supportedExten
 {
 }
 
+std::string ShaderSpirVDecoder::getCompilerVersion()
+{
+    //Compiled shaders are cached on disk, an update of shaderc or the target environment must invalidate them
+    static const std::string s_version = []() -> std::string
+        {
+            u32 version = 0;
+            u32 revision = 0;
+            shaderc_get_spv_version(&version, &revision);
+
+#ifdef VULKAN_CURRENT_VERSION
+            const u32 targetVersion = VULKAN_CURRENT_VERSION;
+#else
+            const u32 targetVersion = 0;
+#endif //VULKAN_CURRENT_VERSION
+            return std::format("shaderc {}.{} vulkan {} patch {}", version, revision, targetVersion, PATCH_SYSTEM);
+        }();
+
+    return s_version;
+}
+
 Resource* ShaderSpirVDecoder::decode(const stream::Stream* stream, const resource::Resource::LoadPolicy* policy, u32 flags, const std::string& name) const
 {
+    TRACE_PROFILER_ZONE("ShaderSpirVDecoder::decode");
+
     if (!stream || stream->size() == 0)
     {
         ASSERT(false, "bad stream");
@@ -163,6 +187,36 @@ Resource* ShaderSpirVDecoder::decode(const stream::Stream* stream, const resourc
         timer.start();
 #endif //LOG_LOADIMG_TIME
 
+        ShaderCache* cache = ShaderCache::getLazyInstance();
+        ShaderCache::Key cacheKey;
+        const bool useCache = cache->isEnabled() && ShaderCache::computeKey(source, shaderPolicy, m_compileFlags, ShaderSpirVDecoder::getCompilerVersion(), cacheKey);
+        if (useCache)
+        {
+            if (stream::Stream* cachedSpirvBinary = cache->load(cacheKey))
+            {
+                renderer::Shader::ShaderHeader shaderHeader(shaderPolicy.type);
+                resource::ResourceHeader::fill(&shaderHeader, name, cachedSpirvBinary->size(), 0);
+
+                Resource* resource = V3D_NEW(renderer::Shader, memory::MemoryLabel::MemoryObject)(shaderHeader);
+                if (!resource->load(cachedSpirvBinary))
+                {
+                    LOG_ERROR("ShaderSpirVDecoder::decode: shader load is failed");
+
+                    V3D_DELETE(resource, memory::MemoryLabel::MemoryObject);
+                    resource = nullptr;
+                }
+                stream::StreamManager::destroyStream(cachedSpirvBinary);
+
+#if LOG_LOADIMG_TIME
+                timer.stop();
+                u64 time = timer.getTime<utils::Timer::Duration_MilliSeconds>();
+                LOG_DEBUG("ShaderSpirVDecoder::decode, shader %s, is loaded from cache. Time %.4f sec", name.c_str(), static_cast<f32>(time) / 1000.0f);
+#endif //LOG_LOADIMG_TIME
+
+                return resource;
+            }
+        }
+
         shaderc::CompileOptions options;
 
         if (m_compileFlags & ShaderCompileFlag::ShaderCompile_OptimizationPerformance || m_compileFlags & ShaderCompileFlag::ShaderCompile_OptimizationFull)
@@ -416,6 +470,11 @@ Resource* ShaderSpirVDecoder::decode(const stream::Stream* stream, const resourc
             }
         }
 
+        if (useCache)
+        {
+            cache->store(cacheKey, resourceSpirvBinary);
+        }
+
         renderer::Shader::ShaderHeader shaderHeader(shaderPolicy.type);
         resource::ResourceHeader::fill(&shaderHeader, name, resourceSpirvBinary->size(), 0);
 
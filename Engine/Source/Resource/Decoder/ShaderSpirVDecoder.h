@@ -29,6 +29,8 @@ namespace resource
 
     private:
 
+        static std::string getCompilerVersion();
+
         ShaderCompileFlags m_compileFlags;
     };
 
@@ -1,4 +1,5 @@
 #include "AssetSourceFileLoader.h"
+#include "FrameProfiler.h"
 
 #include "Stream/FileLoader.h"
 #include "Utils/Logger.h"
@@ -17,6 +18,8 @@ AssetSourceFileLoader::AssetSourceFileLoader() noexcept
 
 Asset* AssetSourceFileLoader::load(const std::string& name, const resource::Resource::LoadPolicy& policy, u32 flags)
 {
+    TRACE_PROFILER_ZONE("AssetSourceFileLoader::load");
+
     for (std::string& root : m_roots)
     {
         for (std::string& path : m_paths)
@@ -1,4 +1,5 @@
 #include "ImageFileLoader.h"
+#include "FrameProfiler.h"
 
 #include "Renderer/Device.h"
 #include "Stream/FileLoader.h"
@@ -33,6 +34,8 @@ BitmapFileLoader::BitmapFileLoader() noexcept
 
 resource::Bitmap* BitmapFileLoader::load(const std::string& name, const Resource::LoadPolicy& policy, u32 flags)
 {
+    TRACE_PROFILER_ZONE("BitmapFileLoader::load");
+
     for (std::string& root : m_roots)
     {
         for (std::string& path : m_paths)
@@ -86,6 +89,8 @@ TextureFileLoader::TextureFileLoader(renderer::Device* device) noexcept
 
 renderer::Texture* TextureFileLoader::load(const std::string& name, const Resource::LoadPolicy& policy, u32 flags)
 {
+    TRACE_PROFILER_ZONE("TextureFileLoader::load");
+
     for (std::string& root : m_roots)
     {
         for (std::string& path : m_paths)
@@ -1,4 +1,5 @@
 #include "ModelFileLoader.h"
+#include "FrameProfiler.h"
 
 #include "Renderer/Device.h"
 #include "Stream/FileLoader.h"
@@ -26,6 +27,8 @@ ModelFileLoader::ModelFileLoader(renderer::Device* device) noexcept
 
 scene::Model* ModelFileLoader::load(const std::string& name, const Resource::LoadPolicy& policy, ModelLoaderFlags flags)
 {
+    TRACE_PROFILER_ZONE("ModelFileLoader::load");
+
     for (std::string& root : m_roots)
     {
         for (std::string& path : m_paths)
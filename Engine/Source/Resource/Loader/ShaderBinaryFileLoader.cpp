@@ -1,4 +1,5 @@
 #include "ShaderBinaryFileLoader.h"
+#include "FrameProfiler.h"
 
 #include "Renderer/Shader.h"
 #include "Renderer/Device.h"
@@ -19,7 +20,8 @@ namespace resource
 
 ShaderBinaryFileLoader::ShaderBinaryFileLoader(const renderer::Device* device, ShaderCompileFlags compileFlags) noexcept
 {
-    if (device->getRenderType() == renderer::Device::RenderType::Vulkan)
+    //Null device uses SPIR-V reflection the same as Vulkan
+    if (device->getRenderType() == renderer::Device::RenderType::Vulkan || device->getRenderType() == renderer::Device::RenderType::Empty)
     {
 #ifdef USE_SPIRV
         ResourceDecoderRegistration::registerDecoder(V3D_NEW(ShaderSpirVDecoder, memory::MemoryLabel::MemorySystem)({ "vspv", "fspv", "cspv" }, compileFlags) );
@@ -39,6 +41,8 @@ ShaderBinaryFileLoader::ShaderBinaryFileLoader(const renderer::Device* device, S
 
 renderer::Shader* ShaderBinaryFileLoader::load(const std::string& name, const Resource::LoadPolicy& policy, ShaderCompileFlags flags)
 {
+    TRACE_PROFILER_ZONE("ShaderBinaryFileLoader::load");
+
     for (std::string& root : m_roots)
     {
         for (std::string& path : m_paths)
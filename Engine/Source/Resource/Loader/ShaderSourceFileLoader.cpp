@@ -1,4 +1,5 @@
 #include "ShaderSourceFileLoader.h"
+#include "FrameProfiler.h"
 
 #include "Stream/FileLoader.h"
 #include "Renderer/Device.h"
@@ -26,7 +27,8 @@ static std::map<std::string, renderer::ShaderModel> k_extensionList =
 
 ShaderSourceFileLoader::ShaderSourceFileLoader(renderer::Device* device, ShaderCompileFlags compileFlags) noexcept
 {
-    if (device->getRenderType() == renderer::Device::RenderType::Vulkan)
+    //Null device uses SPIR-V reflection the same as Vulkan
+    if (device->getRenderType() == renderer::Device::RenderType::Vulkan || device->getRenderType() == renderer::Device::RenderType::Empty)
     {
         if (compileFlags & ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV)
         {
@@ -57,6 +59,8 @@ ShaderSourceFileLoader::ShaderSourceFileLoader(renderer::Device* device, ShaderC
 
 renderer::Shader* ShaderSourceFileLoader::load(const std::string& name, const Resource::LoadPolicy& policy, ShaderCompileFlags flags)
 {
+    TRACE_PROFILER_ZONE("ShaderSourceFileLoader::load");
+
     for (std::string& root : m_roots)
     {
         for (std::string& path : m_paths)
@@ -1,4 +1,5 @@
 #include "ShaderSourceStreamLoader.h"
+#include "FrameProfiler.h"
 
 #include "Renderer/Device.h"
 #include "Renderer/Shader.h"
@@ -23,6 +24,7 @@ ShaderSourceStreamLoader::ShaderSourceStreamLoader(renderer::Device* device, con
     switch (device->getRenderType())
     {
 #ifdef USE_SPIRV
+    case renderer::Device::RenderType::Empty: //Null device uses SPIR-V reflection the same as Vulkan
     case renderer::Device::RenderType::Vulkan:
     {
         if (flags & ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV)
@@ -60,6 +62,8 @@ ShaderSourceStreamLoader::ShaderSourceStreamLoader(renderer::Device* device, con
 
 renderer::Shader* ShaderSourceStreamLoader::load(const std::string& name, const Resource::LoadPolicy& policy, ShaderCompileFlags flags)
 {
+    TRACE_PROFILER_ZONE("ShaderSourceStreamLoader::load");
+
     if (ShaderSourceStreamLoader::getDecoders().empty())
     {
         LOG_ERROR("ShaderSourceStreamLoader: Decoder is missing");
@@ -0,0 +1,594 @@
+#include "MipmapGenerator.h"
+#include "ResourceManager.h"
+#include "FrameProfiler.h"
+
+#include "Task/TaskScheduler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#   include <emmintrin.h>
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   endif
+#   define MIPMAP_SSE2 1
+#else
+#   define MIPMAP_SSE2 0
+#endif
+
+namespace v3d
+{
+namespace resource
+{
+
+#if MIPMAP_SSE2
+//MipmapGeneratorAVX2.cpp, return the first pixel which isn't filtered
+u32 boxRowUNorm8AVX2(const u8* row0, const u8* row1, u8* dst, u32 dstWidth);
+u32 boxRowUNorm16AVX2(const u16* row0, const u16* row1, u16* dst, u32 dstWidth);
+u32 boxRowFloat4AVX2(const f32* row0, const f32* row1, f32* dst, u32 dstWidth);
+u32 boxRowFloat1AVX2(const f32* row0, const f32* row1, f32* dst, u32 dstWidth);
+
+/**
+* @brief The CPU and the OS must both support AVX2, the OS saves the YMM registers
+*/
+static bool isAVX2Supported()
+{
+#if defined(_MSC_VER)
+    s32 info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    //Checks the OS support of the YMM registers too. The static initializers may run before the one of libgcc
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static const bool k_useAVX2 = isAVX2Supported();
+#endif //MIPMAP_SSE2
+
+constexpr u32 k_minParallelPixels = 128 * 128;
+constexpr u32 k_rowsChunkSize = 64 * 1024;
+constexpr u32 k_maxFilterTaps = 6;
+constexpr f64 k_kaiserAlpha = 4.0;
+constexpr f64 k_kaiserRadius = 1.5;
+constexpr f64 k_kaiserPi = 3.14159265358979323846;
+constexpr u32 k_srgbEncodeBuckets = 4096;
+
+struct MipmapLevel
+{
+    const u8* _src;
+    u8*       _dst;
+    u32       _srcWidth;
+    u32       _srcHeight;
+    u32       _dstWidth;
+    u32       _dstHeight;
+};
+
+/**
+* @brief MipmapKernel struct. Separable kernel of 2:1 decimation, the destination pixel x reads the source pixels from 2x + _first
+*/
+struct MipmapKernel
+{
+    s32 _first;
+    u32 _taps;
+    f32 _weights[k_maxFilterTaps];
+};
+
+static constexpr MipmapKernel k_boxKernel = { 0, 2, { 0.5f, 0.5f } };
+
+struct MipmapTables
+{
+    static const MipmapTables& get()
+    {
+        static const MipmapTables tables;
+        return tables;
+    }
+
+    f32          _unorm8ToFloat[256];
+    f32          _srgb8ToLinear[256];
+    f32          _linearToSrgb8[255]; //thresholds between the neighbouring codes
+    u8           _linearToSrgb8Bucket[k_srgbEncodeBuckets + 1]; //the first code of the bucket, at most one threshold is inside a bucket
+    MipmapKernel _kaiser;
+
+private:
+
+    static f64 srgbToLinear(f64 value)
+    {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    static f64 besselI0(f64 value)
+    {
+        f64 sum = 1.0;
+        f64 term = 1.0;
+        for (u32 k = 1; k < 32; ++k)
+        {
+            term *= (value * 0.5 / k) * (value * 0.5 / k);
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    MipmapTables() noexcept
+    {
+        for (u32 code = 0; code < 256; ++code)
+        {
+            _unorm8ToFloat[code] = static_cast<f32>(code / 255.0);
+            _srgb8ToLinear[code] = static_cast<f32>(srgbToLinear(code / 255.0));
+        }
+
+        for (u32 code = 0; code < 255; ++code)
+        {
+            _linearToSrgb8[code] = static_cast<f32>(srgbToLinear((code + 0.5) / 255.0));
+        }
+
+        for (u32 bucket = 0; bucket <= k_srgbEncodeBuckets; ++bucket)
+        {
+            const f32 value = static_cast<f32>(bucket) / k_srgbEncodeBuckets;
+            _linearToSrgb8Bucket[bucket] = static_cast<u8>(std::lower_bound(std::begin(_linearToSrgb8), std::end(_linearToSrgb8), value) - std::begin(_linearToSrgb8));
+        }
+
+        //Windowed sinc, the taps are at the distances of +-0.25, +-0.75, +-1.25 of the destination pixel
+        _kaiser._first = -2;
+        _kaiser._taps = k_maxFilterTaps;
+        f64 weights[k_maxFilterTaps];
+        f64 sum = 0.0;
+        for (u32 tap = 0; tap < k_maxFilterTaps; ++tap)
+        {
+            const f64 t = (static_cast<f64>(_kaiser._first + static_cast<s32>(tap)) - 0.5) * 0.5;
+            const f64 sinc = std::sin(k_kaiserPi * t) / (k_kaiserPi * t);
+            const f64 ratio = t / k_kaiserRadius;
+            const f64 window = besselI0(k_kaiserAlpha * std::sqrt(std::max(1.0 - ratio * ratio, 0.0))) / besselI0(k_kaiserAlpha);
+
+            weights[tap] = sinc * window;
+            sum += weights[tap];
+        }
+
+        for (u32 tap = 0; tap < k_maxFilterTaps; ++tap)
+        {
+            _kaiser._weights[tap] = static_cast<f32>(weights[tap] / sum);
+        }
+    }
+};
+
+static u32 getComponentSize(MipmapGenerator::ComponentType type)
+{
+    switch (type)
+    {
+    case MipmapGenerator::ComponentType::UNorm8:
+        return sizeof(u8);
+    case MipmapGenerator::ComponentType::UNorm16:
+        return sizeof(u16);
+    case MipmapGenerator::ComponentType::Float32:
+        return sizeof(f32);
+    }
+
+    ASSERT(false, "unknown type");
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static void boxRowScalar(const T* row0, const T* row1, T* dst, u32 srcWidth, u32 dstWidth, u32 components, u32 x)
+{
+    for (; x < dstWidth; ++x)
+    {
+        const u32 x0 = std::min(2 * x, srcWidth - 1) * components;
+        const u32 x1 = std::min(2 * x + 1, srcWidth - 1) * components;
+        for (u32 c = 0; c < components; ++c)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                dst[x * components + c] = ((row0[x0 + c] + row1[x0 + c]) + (row0[x1 + c] + row1[x1 + c])) * 0.25f;
+            }
+            else
+            {
+                dst[x * components + c] = static_cast<T>((static_cast<u32>(row0[x0 + c]) + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+            }
+        }
+    }
+}
+
+static void boxRowUNorm8(const u8* row0, const u8* row1, u8* dst, u32 srcWidth, u32 dstWidth, u32 components)
+{
+    u32 x = 0;
+    if (components == 4 && srcWidth > 1)
+    {
+#if MIPMAP_SSE2
+        if (k_useAVX2)
+        {
+            x = boxRowUNorm8AVX2(row0, row1, dst, dstWidth);
+        }
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi16(2);
+        for (; x + 2 <= dstWidth; x += 2)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+            const __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(sum, sum));
+        }
+#endif //MIPMAP_SSE2
+    }
+
+    boxRowScalar(row0, row1, dst, srcWidth, dstWidth, components, x);
+}
+
+static void boxRowUNorm16(const u16* row0, const u16* row1, u16* dst, u32 srcWidth, u32 dstWidth, u32 components)
+{
+    u32 x = 0;
+    if (components == 4 && srcWidth > 1)
+    {
+#if MIPMAP_SSE2
+        if (k_useAVX2)
+        {
+            x = boxRowUNorm16AVX2(row0, row1, dst, dstWidth);
+        }
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi32(2);
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        const __m128i bias16 = _mm_set1_epi16(static_cast<s16>(0x8000));
+        auto sumPixel = [&zero, &round](__m128i a, __m128i b) -> __m128i
+            {
+                const __m128i sum = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpackhi_epi16(a, zero)),
+                    _mm_add_epi32(_mm_unpacklo_epi16(b, zero), _mm_unpackhi_epi16(b, zero)));
+                return _mm_srli_epi32(_mm_add_epi32(sum, round), 2);
+            };
+
+        for (; x + 2 <= dstWidth; x += 2)
+        {
+            const __m128i p = sumPixel(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8)));
+            const __m128i q = sumPixel(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8 + 8)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8 + 8)));
+
+            //SSE2 has only the signed saturation of 32-bit values
+            const __m128i packed = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(p, bias32), _mm_sub_epi32(q, bias32)), bias16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), packed);
+        }
+#endif //MIPMAP_SSE2
+    }
+
+    boxRowScalar(row0, row1, dst, srcWidth, dstWidth, components, x);
+}
+
+static void boxRowFloat(const f32* row0, const f32* row1, f32* dst, u32 srcWidth, u32 dstWidth, u32 components)
+{
+    u32 x = 0;
+    if (components == 4 && srcWidth > 1)
+    {
+#if MIPMAP_SSE2
+        if (k_useAVX2)
+        {
+            x = boxRowFloat4AVX2(row0, row1, dst, dstWidth);
+        }
+
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (; x < dstWidth; ++x)
+        {
+            const __m128 even = _mm_add_ps(_mm_loadu_ps(row0 + x * 8), _mm_loadu_ps(row1 + x * 8));
+            const __m128 odd = _mm_add_ps(_mm_loadu_ps(row0 + x * 8 + 4), _mm_loadu_ps(row1 + x * 8 + 4));
+            _mm_storeu_ps(dst + x * 4, _mm_mul_ps(_mm_add_ps(even, odd), quarter));
+        }
+#endif //MIPMAP_SSE2
+    }
+    else if (components == 1 && srcWidth > 1)
+    {
+#if MIPMAP_SSE2
+        if (k_useAVX2)
+        {
+            x = boxRowFloat1AVX2(row0, row1, dst, dstWidth);
+        }
+
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (; x + 4 <= dstWidth; x += 4)
+        {
+            const __m128 s = _mm_add_ps(_mm_loadu_ps(row0 + x * 2), _mm_loadu_ps(row1 + x * 2));
+            const __m128 t = _mm_add_ps(_mm_loadu_ps(row0 + x * 2 + 4), _mm_loadu_ps(row1 + x * 2 + 4));
+            const __m128 even = _mm_shuffle_ps(s, t, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 odd = _mm_shuffle_ps(s, t, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(dst + x, _mm_mul_ps(_mm_add_ps(even, odd), quarter));
+        }
+#endif //MIPMAP_SSE2
+    }
+
+    boxRowScalar(row0, row1, dst, srcWidth, dstWidth, components, x);
+}
+
+static void boxRows(const MipmapLevel& level, const MipmapGenerator::ImageDesc& desc, u32 rowBegin, u32 rowEnd)
+{
+    const u32 pixelSize = desc._components * getComponentSize(desc._type);
+    const u64 srcRowSize = static_cast<u64>(level._srcWidth) * pixelSize;
+    const u64 dstRowSize = static_cast<u64>(level._dstWidth) * pixelSize;
+
+    for (u32 y = rowBegin; y < rowEnd; ++y)
+    {
+        const u8* row0 = level._src + 2 * y * srcRowSize;
+        const u8* row1 = level._srcHeight > 1 ? row0 + srcRowSize : row0;
+        u8* dst = level._dst + y * dstRowSize;
+
+        switch (desc._type)
+        {
+        case MipmapGenerator::ComponentType::UNorm8:
+            boxRowUNorm8(row0, row1, dst, level._srcWidth, level._dstWidth, desc._components);
+            break;
+
+        case MipmapGenerator::ComponentType::UNorm16:
+            boxRowUNorm16(reinterpret_cast<const u16*>(row0), reinterpret_cast<const u16*>(row1), reinterpret_cast<u16*>(dst), level._srcWidth, level._dstWidth, desc._components);
+            break;
+
+        case MipmapGenerator::ComponentType::Float32:
+            boxRowFloat(reinterpret_cast<const f32*>(row0), reinterpret_cast<const f32*>(row1), reinterpret_cast<f32*>(dst), level._srcWidth, level._dstWidth, desc._components);
+            break;
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void decodeRow(const u8* src, u32 width, const MipmapGenerator::ImageDesc& desc, const MipmapTables& tables, f32* dst)
+{
+    const u32 count = width * desc._components;
+    switch (desc._type)
+    {
+    case MipmapGenerator::ComponentType::UNorm8:
+        if (desc._srgb)
+        {
+            for (u32 index = 0; index < count; ++index)
+            {
+                const bool alpha = desc._components == 4 && (index & 3) == 3;
+                dst[index] = alpha ? tables._unorm8ToFloat[src[index]] : tables._srgb8ToLinear[src[index]];
+            }
+        }
+        else
+        {
+            for (u32 index = 0; index < count; ++index)
+            {
+                dst[index] = tables._unorm8ToFloat[src[index]];
+            }
+        }
+        break;
+
+    case MipmapGenerator::ComponentType::UNorm16:
+    {
+        const u16* src16 = reinterpret_cast<const u16*>(src);
+        for (u32 index = 0; index < count; ++index)
+        {
+            dst[index] = static_cast<f32>(src16[index]) * (1.0f / 65535.0f);
+        }
+        break;
+    }
+
+    case MipmapGenerator::ComponentType::Float32:
+        memcpy(dst, src, count * sizeof(f32));
+        break;
+    }
+}
+
+static void encodeRow(const f32* src, u32 width, const MipmapGenerator::ImageDesc& desc, const MipmapTables& tables, u8* dst)
+{
+    const u32 count = width * desc._components;
+    switch (desc._type)
+    {
+    case MipmapGenerator::ComponentType::UNorm8:
+        for (u32 index = 0; index < count; ++index)
+        {
+            const bool alpha = desc._components == 4 && (index & 3) == 3;
+            if (desc._srgb && !alpha)
+            {
+                const f32 value = src[index] > 0.0f ? std::min(src[index], 1.0f) : 0.0f;
+                u32 code = tables._linearToSrgb8Bucket[static_cast<u32>(value * k_srgbEncodeBuckets)];
+                while (code < 255 && value > tables._linearToSrgb8[code])
+                {
+                    ++code;
+                }
+                dst[index] = static_cast<u8>(code);
+            }
+            else
+            {
+                dst[index] = static_cast<u8>(std::clamp(src[index], 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+        break;
+
+    case MipmapGenerator::ComponentType::UNorm16:
+    {
+        u16* dst16 = reinterpret_cast<u16*>(dst);
+        for (u32 index = 0; index < count; ++index)
+        {
+            dst16[index] = static_cast<u16>(std::clamp(src[index], 0.0f, 1.0f) * 65535.0f + 0.5f);
+        }
+        break;
+    }
+
+    case MipmapGenerator::ComponentType::Float32:
+        memcpy(dst, src, count * sizeof(f32));
+        break;
+    }
+}
+
+template<u32 Taps>
+static void filterRows(const MipmapLevel& level, const MipmapGenerator::ImageDesc& desc, const MipmapKernel& kernel, u32 rowBegin, u32 rowEnd)
+{
+    ASSERT(kernel._taps == Taps, "wrong kernel");
+    const MipmapTables& tables = MipmapTables::get();
+    const u32 components = desc._components;
+    const u64 srcRowSize = static_cast<u64>(level._srcWidth) * components * getComponentSize(desc._type);
+    const u64 dstRowSize = static_cast<u64>(level._dstWidth) * components * getComponentSize(desc._type);
+    const u32 dstRowCount = level._dstWidth * components;
+
+    std::vector<u32> columns(level._dstWidth * Taps);
+    for (u32 x = 0; x < level._dstWidth; ++x)
+    {
+        for (u32 tap = 0; tap < Taps; ++tap)
+        {
+            const s32 column = static_cast<s32>(2 * x) + kernel._first + static_cast<s32>(tap);
+            columns[x * Taps + tap] = std::clamp<s32>(column, 0, level._srcWidth - 1) * components;
+        }
+    }
+
+    //The horizontally filtered rows are kept in a ring, the neighbouring destination rows share the source rows
+    std::vector<f32> source(level._srcWidth * components);
+    std::vector<f32> filtered(Taps * dstRowCount);
+    std::vector<s32> filteredRows(Taps, -1);
+    std::vector<f32> accumulator(dstRowCount);
+
+    for (u32 y = rowBegin; y < rowEnd; ++y)
+    {
+        std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+        for (u32 tap = 0; tap < Taps; ++tap)
+        {
+            const s32 sourceRow = std::clamp<s32>(static_cast<s32>(2 * y) + kernel._first + static_cast<s32>(tap), 0, level._srcHeight - 1);
+            const u32 slot = static_cast<u32>(sourceRow) % Taps;
+            f32* row = &filtered[slot * dstRowCount];
+            if (filteredRows[slot] != sourceRow)
+            {
+                decodeRow(level._src + sourceRow * srcRowSize, level._srcWidth, desc, tables, source.data());
+                for (u32 x = 0; x < level._dstWidth; ++x)
+                {
+                    const u32* taps = &columns[x * Taps];
+                    for (u32 c = 0; c < components; ++c)
+                    {
+                        f32 value = 0.0f;
+                        for (u32 index = 0; index < Taps; ++index)
+                        {
+                            value += kernel._weights[index] * source[taps[index] + c];
+                        }
+                        row[x * components + c] = value;
+                    }
+                }
+                filteredRows[slot] = sourceRow;
+            }
+
+            const f32 weight = kernel._weights[tap];
+            for (u32 index = 0; index < dstRowCount; ++index)
+            {
+                accumulator[index] += weight * row[index];
+            }
+        }
+
+        encodeRow(accumulator.data(), level._dstWidth, desc, tables, level._dst + y * dstRowSize);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+MipmapGenerator::MipmapGenerator() noexcept
+{
+}
+
+MipmapGenerator::~MipmapGenerator()
+{
+}
+
+u32 MipmapGenerator::calculateMipmapCount(u32 width, u32 height)
+{
+    u32 count = 1;
+    while (width != 1U && height != 1U)
+    {
+        width = std::max(width / 2, 1U);
+        height = std::max(height / 2, 1U);
+        ++count;
+    }
+
+    return count;
+}
+
+u64 MipmapGenerator::calculateMipmapChainSize(const ImageDesc& desc, u32 mipmapCount)
+{
+    const u64 pixelSize = desc._components * getComponentSize(desc._type);
+    u32 width = desc._width;
+    u32 height = desc._height;
+
+    u64 size = 0;
+    for (u32 mip = 0; mip < mipmapCount; ++mip)
+    {
+        size += static_cast<u64>(width) * height * pixelSize;
+        width = std::max(width / 2, 1U);
+        height = std::max(height / 2, 1U);
+    }
+
+    return size;
+}
+
+void MipmapGenerator::generate(const ImageDesc& desc, MipmapFilter filter, u32 mipmapCount, u8* chain)
+{
+    TRACE_PROFILER_ZONE("MipmapGenerator::generate");
+
+    ASSERT(chain, "nullptr");
+    ASSERT(desc._components >= 1 && desc._components <= 4, "wrong components count");
+    ASSERT(desc._width > 0 && desc._height > 0, "empty image");
+
+    //sRGB must be filtered in the linear space, it goes through the float path
+    const bool exactBox = filter == MipmapFilter::Box && !(desc._srgb && desc._type == ComponentType::UNorm8);
+    const MipmapKernel& kernel = filter == MipmapFilter::Kaiser ? MipmapTables::get()._kaiser : k_boxKernel;
+    const u64 pixelSize = desc._components * getComponentSize(desc._type);
+
+    //The decoders run on the loading threads, they are the workers of the engine. Other threads filter the rows themselves
+    task::TaskScheduler* workers = ResourceManager::getLazyInstance()->getScheduler();
+    if (workers && !workers->isOwnThread())
+    {
+        workers = nullptr;
+    }
+
+    MipmapLevel level = { chain, chain, desc._width, desc._height, desc._width, desc._height };
+    for (u32 mip = 1; mip < mipmapCount; ++mip)
+    {
+        level._src = level._dst;
+        level._srcWidth = level._dstWidth;
+        level._srcHeight = level._dstHeight;
+        level._dst = level._dst + static_cast<u64>(level._srcWidth) * level._srcHeight * pixelSize;
+        level._dstWidth = std::max(level._srcWidth / 2, 1U);
+        level._dstHeight = std::max(level._srcHeight / 2, 1U);
+
+        auto filterChunk = [&level, &desc, &kernel, exactBox](u32 rowBegin, u32 rowEnd) -> void
+            {
+                if (exactBox)
+                {
+                    boxRows(level, desc, rowBegin, rowEnd);
+                }
+                else if (kernel._taps == k_boxKernel._taps)
+                {
+                    filterRows<k_boxKernel._taps>(level, desc, kernel, rowBegin, rowEnd);
+                }
+                else
+                {
+                    filterRows<k_maxFilterTaps>(level, desc, kernel, rowBegin, rowEnd);
+                }
+            };
+
+        //Every level reads the previous one, the levels go one by one
+        if (workers && level._dstWidth * level._dstHeight >= k_minParallelPixels)
+        {
+            const u32 grain = std::max<u32>(k_rowsChunkSize / static_cast<u32>(level._dstWidth * pixelSize), 1U);
+            workers->parallelFor(0, level._dstHeight, grain, filterChunk);
+        }
+        else
+        {
+            filterChunk(0, level._dstHeight);
+        }
+    }
+}
+
+} //namespace resource
+} //namespace v3d
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Common.h"
+#include "Utils/Singleton.h"
+#include "Resource.h"
+
+namespace v3d
+{
+namespace resource
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief MipmapGenerator class. Builds the mipmap chain of an uncompressed 2D image in place, Singleton.
+    * Every level is filtered from the previous one, rows of a level are split between the loading threads of ResourceManager.
+    * The box filter has SSE2/AVX2 paths for the RGBA and single float layouts, AVX2 is chosen at runtime by CPUID.
+    * Other cases and the Kaiser filter are filtered in float.
+    * 8-bit sRGB images are filtered in the linear space, alpha stays linear. Thread safe
+    */
+    class V3D_API MipmapGenerator final : public utils::Singleton<MipmapGenerator>
+    {
+    public:
+
+        enum class ComponentType : u32
+        {
+            UNorm8,
+            UNorm16,
+            Float32
+        };
+
+        /**
+        * @brief ImageDesc struct. Description of the base level
+        */
+        struct ImageDesc
+        {
+            u32           _width = 0;
+            u32           _height = 0;
+            u32           _components = 4;
+            ComponentType _type = ComponentType::UNorm8;
+            bool          _srgb = false;
+        };
+
+        /**
+        * @brief calculateMipmapCount. Including the base level, stops when one of the sides reaches 1
+        */
+        static u32 calculateMipmapCount(u32 width, u32 height);
+        static u64 calculateMipmapChainSize(const ImageDesc& desc, u32 mipmapCount);
+
+        /**
+        * @brief generate. Fills the levels from 1 to mipmapCount - 1, levels follow each other without padding
+        * @param const ImageDesc& desc [required] the base level
+        * @param MipmapFilter filter [required]
+        * @param u32 mipmapCount [required] including the base level
+        * @param u8* chain [required] calculateMipmapChainSize bytes, starts with the base level
+        */
+        void generate(const ImageDesc& desc, MipmapFilter filter, u32 mipmapCount, u8* chain);
+
+    private:
+
+        friend utils::Singleton<MipmapGenerator>;
+        template<class T>
+        friend void memory::internal_delete(T* ptr, v3d::memory::MemoryLabel label, const v3d::c8* file, v3d::u32 line);
+
+        MipmapGenerator() noexcept;
+        ~MipmapGenerator();
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace resource
+} //namespace v3d
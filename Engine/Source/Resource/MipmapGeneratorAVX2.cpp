@@ -0,0 +1,111 @@
+#include "Common.h"
+
+//The only file built with AVX2 enabled, the kernels are called by MipmapGenerator after the CPUID check.
+//Without the compiler flag every kernel returns the first pixel, the SSE2 path takes the row
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace v3d
+{
+namespace resource
+{
+
+u32 boxRowUNorm8AVX2(const u8* row0, const u8* row1, u8* dst, u32 dstWidth)
+{
+    u32 x = 0;
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi16(2);
+    for (; x + 4 <= dstWidth; x += 4)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + x * 8));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + x * 8));
+        __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+        __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+        lo = _mm256_add_epi16(lo, _mm256_srli_si256(lo, 8));
+        hi = _mm256_add_epi16(hi, _mm256_srli_si256(hi, 8));
+
+        const __m256i sum = _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), round), 2);
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm256_castsi256_si128(packed));
+    }
+    _mm256_zeroupper();
+#endif //__AVX2__
+
+    return x;
+}
+
+u32 boxRowUNorm16AVX2(const u16* row0, const u16* row1, u16* dst, u32 dstWidth)
+{
+    u32 x = 0;
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi32(2);
+    auto sumPairs = [&zero](__m256i a, __m256i b) -> __m256i
+        {
+            return _mm256_add_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(a, zero), _mm256_unpackhi_epi16(a, zero)),
+                _mm256_add_epi32(_mm256_unpacklo_epi16(b, zero), _mm256_unpackhi_epi16(b, zero)));
+        };
+
+    for (; x + 4 <= dstWidth; x += 4)
+    {
+        const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + x * 8));
+        const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + x * 8 + 16));
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + x * 8));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + x * 8 + 16));
+
+        const __m256i p = _mm256_srli_epi32(_mm256_add_epi32(sumPairs(a0, b0), round), 2);
+        const __m256i q = _mm256_srli_epi32(_mm256_add_epi32(sumPairs(a1, b1), round), 2);
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(p, q), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), packed);
+    }
+    _mm256_zeroupper();
+#endif //__AVX2__
+
+    return x;
+}
+
+u32 boxRowFloat4AVX2(const f32* row0, const f32* row1, f32* dst, u32 dstWidth)
+{
+    u32 x = 0;
+#if defined(__AVX2__)
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    for (; x + 2 <= dstWidth; x += 2)
+    {
+        const __m256 s = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8), _mm256_loadu_ps(row1 + x * 8));
+        const __m256 t = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 8 + 8), _mm256_loadu_ps(row1 + x * 8 + 8));
+        const __m256 even = _mm256_permute2f128_ps(s, t, 0x20);
+        const __m256 odd = _mm256_permute2f128_ps(s, t, 0x31);
+        _mm256_storeu_ps(dst + x * 4, _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+    }
+    _mm256_zeroupper();
+#endif //__AVX2__
+
+    return x;
+}
+
+u32 boxRowFloat1AVX2(const f32* row0, const f32* row1, f32* dst, u32 dstWidth)
+{
+    u32 x = 0;
+#if defined(__AVX2__)
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    for (; x + 8 <= dstWidth; x += 8)
+    {
+        const __m256 s = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 2), _mm256_loadu_ps(row1 + x * 2));
+        const __m256 t = _mm256_add_ps(_mm256_loadu_ps(row0 + x * 2 + 8), _mm256_loadu_ps(row1 + x * 2 + 8));
+        const __m256 even = _mm256_shuffle_ps(s, t, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 odd = _mm256_shuffle_ps(s, t, _MM_SHUFFLE(3, 1, 3, 1));
+
+        //Shuffle works inside the 128-bit lanes, restore the order of the pairs
+        const __m256 sum = _mm256_mul_ps(_mm256_add_ps(even, odd), quarter);
+        _mm256_storeu_ps(dst + x, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    _mm256_zeroupper();
+#endif //__AVX2__
+
+    return x;
+}
+
+} //namespace resource
+} //namespace v3d
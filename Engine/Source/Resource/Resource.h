@@ -36,6 +36,15 @@ namespace resource
         Count
     };
 
+    /**
+    * @brief MipmapFilter enum. Filter of the generated mipmaps
+    */
+    enum class MipmapFilter : u8
+    {
+        Box,
+        Kaiser
+    };
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
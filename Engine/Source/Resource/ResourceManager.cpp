@@ -0,0 +1,420 @@
+#include "ResourceManager.h"
+#include "FrameProfiler.h"
+
+namespace v3d
+{
+namespace resource
+{
+
+ResourceManager::ResourceManager() noexcept
+    : m_scheduler(nullptr)
+    , m_externalWork(0)
+    , m_requestCounter(0)
+{
+}
+
+ResourceManager::~ResourceManager()
+{
+    ResourceManager::shutdownAsyncLoading();
+}
+
+void ResourceManager::initAsyncLoading(u32 numThreads)
+{
+    ASSERT(thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId(), "must be main thread");
+    ASSERT(numThreads > 0, "must be at least one thread");
+    if (m_scheduler)
+    {
+        return;
+    }
+
+    m_scheduler = V3D_NEW(task::TaskScheduler, memory::MemoryLabel::MemorySystem)(numThreads);
+    LOG_DEBUG("ResourceManager::initAsyncLoading: loading threads %u", numThreads);
+}
+
+void ResourceManager::shutdownAsyncLoading()
+{
+    if (!m_scheduler)
+    {
+        return;
+    }
+
+    //Loading threads can wait uploads, keep updating until all requests are done
+    while (!m_loadTasks.empty())
+    {
+        ResourceManager::update();
+        std::this_thread::yield();
+    }
+    ResourceManager::update();
+    ASSERT(m_inFlight.empty(), "must be empty");
+
+    //The work of other systems, the pipeline compilation for example
+    while (m_externalWork.load(std::memory_order_acquire) > 0)
+    {
+        m_scheduler->mainThreadLoop();
+        std::this_thread::yield();
+    }
+
+    V3D_DELETE(m_scheduler, memory::MemoryLabel::MemorySystem);
+    m_scheduler = nullptr;
+}
+
+task::TaskScheduler* ResourceManager::acquireScheduler()
+{
+    if (!m_scheduler || !m_scheduler->isOwnThread())
+    {
+        return nullptr;
+    }
+
+    m_externalWork.fetch_add(1, std::memory_order_relaxed);
+    return m_scheduler;
+}
+
+void ResourceManager::releaseScheduler()
+{
+    [[maybe_unused]] u32 count = m_externalWork.fetch_sub(1, std::memory_order_release);
+    ASSERT(count > 0, "must be acquired");
+}
+
+void ResourceManager::update()
+{
+    if (!m_scheduler)
+    {
+        return;
+    }
+
+    TRACE_PROFILER_ZONE("ResourceManager::update");
+    ASSERT(thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId(), "must be main thread");
+
+    //Uploads from the loading threads
+    m_scheduler->mainThreadLoop();
+
+    std::vector<AsyncLoadHandle> finished;
+    {
+        std::lock_guard lock(m_finishedMutex);
+        std::swap(finished, m_finished);
+    }
+
+    for (const AsyncLoadHandle& request : finished)
+    {
+        ResourceManager::finalizeRequest(request);
+    }
+
+    auto done = std::partition(m_loadTasks.begin(), m_loadTasks.end(), [](const task::Task* task) -> bool
+        {
+            return !task->isCompeted();
+        });
+    for (auto iter = done; iter != m_loadTasks.end(); ++iter)
+    {
+        m_taskPool.releaseTask(*iter);
+    }
+    m_loadTasks.erase(done, m_loadTasks.end());
+}
+
+void ResourceManager::wait(const AsyncLoadHandle& request)
+{
+    ASSERT(request, "nullptr");
+    while (!request->isDone())
+    {
+        ResourceManager::update();
+        if (!request->isDone())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ResourceManager::enqueueRequest(const AsyncLoadHandle& request)
+{
+    request->m_order = m_requestCounter++;
+    if (request->m_unique)
+    {
+        m_inFlight.emplace(request->m_name, request);
+    }
+
+    {
+        std::lock_guard lock(m_pendingMutex);
+        m_pending.push_back(request);
+    }
+
+    //Each task takes the most important pending request at the moment of the execution
+    task::Task* task = m_taskPool.acquireTask();
+    task->init("ResourceManager::load", [this]() -> void
+        {
+            ResourceManager::processRequest();
+        });
+
+    m_scheduler->executeTask(task, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+    m_loadTasks.push_back(task);
+}
+
+void ResourceManager::processRequest()
+{
+    AsyncLoadHandle request;
+    {
+        std::lock_guard lock(m_pendingMutex);
+        if (m_pending.empty())
+        {
+            return;
+        }
+
+        auto best = std::min_element(m_pending.begin(), m_pending.end(), [](const AsyncLoadHandle& left, const AsyncLoadHandle& right) -> bool
+            {
+                const LoadPriority leftPriority = left->m_priority.load(std::memory_order_relaxed);
+                const LoadPriority rightPriority = right->m_priority.load(std::memory_order_relaxed);
+                if (leftPriority != rightPriority)
+                {
+                    return leftPriority > rightPriority;
+                }
+
+                return left->m_order < right->m_order;
+            });
+
+        request = std::move(*best);
+        *best = std::move(m_pending.back());
+        m_pending.pop_back();
+    }
+
+    if (request->m_cancelled.load(std::memory_order_relaxed))
+    {
+        request->m_status.store(AsyncLoadRequest::Status::Cancelled, std::memory_order_release);
+    }
+    else
+    {
+        TRACE_PROFILER_ZONE(request->m_name.c_str());
+        request->m_status.store(AsyncLoadRequest::Status::Loading, std::memory_order_release);
+
+        request->m_resource = request->m_load();
+        request->m_status.store(request->m_resource ? AsyncLoadRequest::Status::Loaded : AsyncLoadRequest::Status::Failed, std::memory_order_release);
+    }
+    request->m_load = nullptr;
+
+    std::lock_guard lock(m_finishedMutex);
+    m_finished.push_back(std::move(request));
+}
+
+void ResourceManager::finalizeRequest(const AsyncLoadHandle& request)
+{
+    auto inFlight = m_inFlight.find(request->m_name);
+    if (inFlight != m_inFlight.end() && inFlight->second == request)
+    {
+        m_inFlight.erase(inFlight);
+    }
+
+    if (request->getStatus() == AsyncLoadRequest::Status::Failed)
+    {
+        LOG_WARNING("ResourceManager::loadAsync: %s is failed", request->m_name.c_str());
+        return;
+    }
+
+    if (request->getStatus() != AsyncLoadRequest::Status::Loaded)
+    {
+        return;
+    }
+
+    if (request->m_cancelled.load(std::memory_order_relaxed))
+    {
+        V3D_DELETE(request->m_resource, memory::MemoryLabel::MemoryObject);
+        request->m_resource = nullptr;
+        request->m_status.store(AsyncLoadRequest::Status::Cancelled, std::memory_order_release);
+
+        return;
+    }
+
+    ResourceManager::registerResource(request->m_name, request->m_resource);
+    request->m_status.store(AsyncLoadRequest::Status::Completed, std::memory_order_release);
+}
+
+void ResourceManager::registerResource(const std::string& name, Resource* resource)
+{
+    std::string innerName(name);
+    if (m_resources.find(innerName) != m_resources.end())
+    {
+        //Same naming as load uses for not unique copies
+        innerName = std::format("{}_copy_{}", innerName, utils::Timer::getCurrentTime());
+    }
+
+    m_resources.insert(std::make_pair(innerName, resource));
+}
+
+std::vector<ShaderPermutationResult> ResourceManager::compileShaders(const std::vector<ShaderPermutation>& permutations, u32 flags)
+{
+    TRACE_PROFILER_ZONE("ResourceManager::compileShaders");
+    ASSERT(thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId(), "must be main thread");
+
+    std::vector<ShaderPermutationResult> results(permutations.size());
+    ResourceLoader<renderer::Shader>* loader = ResourceManager::getLoader<renderer::Shader>();
+    if (!loader)
+    {
+        LOG_ERROR("ResourceManager::compileShaders: shader loader is not registered");
+        return results;
+    }
+
+    struct Job
+    {
+        std::string                     _filename;
+        std::string                     _name;
+        renderer::Shader::LoadPolicy    _policy;
+        u32                             _index;
+        renderer::Shader*               _shader;
+        u64                             _time;
+    };
+
+    //Identical permutations are compiled once
+    std::vector<Job> jobs;
+    std::vector<u32> sources(permutations.size(), ~0U);
+    std::unordered_map<std::string, u32> uniqueNames;
+    const bool forceReload = flags & ShaderCompileFlag::ShaderCompile_ForceReload;
+    for (u32 index = 0; index < permutations.size(); ++index)
+    {
+        const ShaderPermutation& permutation = permutations[index];
+
+        std::string filename(permutation._filename);
+        std::transform(filename.begin(), filename.end(), filename.begin(), ::tolower);
+        std::string name = ResourceManager::composeShaderName(filename, permutation._entrypoint, permutation._defines);
+
+        auto unique = uniqueNames.find(name);
+        if (unique != uniqueNames.end())
+        {
+            sources[index] = unique->second;
+            continue;
+        }
+
+        auto found = m_resources.find(name);
+        if (found != m_resources.end() && !forceReload)
+        {
+            results[index]._shader = static_cast<renderer::Shader*>(found->second);
+            uniqueNames.emplace(name, index);
+            continue;
+        }
+
+        uniqueNames.emplace(name, index);
+        jobs.push_back({ filename, name, ResourceManager::makeShaderPolicy(permutation._type, permutation._entrypoint, permutation._defines, permutation._includes, flags), index, nullptr, 0 });
+    }
+
+    utils::Timer timer;
+    timer.start();
+
+    auto compile = [loader, flags](Job& job) -> void
+        {
+            TRACE_PROFILER_ZONE(job._name.c_str());
+            utils::Timer jobTimer;
+            jobTimer.start();
+
+            job._shader = static_cast<renderer::Shader*>(loader->load(job._filename, job._policy, flags));
+
+            jobTimer.stop();
+            job._time = jobTimer.getTime<utils::Timer::Duration_MicroSeconds>();
+        };
+
+    if (!m_scheduler || jobs.size() < 2)
+    {
+        for (Job& job : jobs)
+        {
+            compile(job);
+        }
+    }
+    else
+    {
+        std::vector<task::Task*> tasks;
+        tasks.reserve(jobs.size());
+        for (Job& job : jobs)
+        {
+            task::Task* task = m_taskPool.acquireTask();
+            task->init("ResourceManager::compileShader", [&compile, &job]() -> void
+                {
+                    compile(job);
+                });
+
+            m_scheduler->executeTask(task, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+            tasks.push_back(task);
+        }
+
+        //Loading threads may wait uploads of the other requests, keep the main thread loop running
+        for (task::Task* task : tasks)
+        {
+            while (!task->isCompeted())
+            {
+                m_scheduler->mainThreadLoop();
+                std::this_thread::yield();
+            }
+            m_taskPool.releaseTask(task);
+        }
+    }
+
+    timer.stop();
+
+    u32 failed = 0;
+    for (const Job& job : jobs)
+    {
+        ShaderPermutationResult& result = results[job._index];
+        result._compileTime = job._time;
+        if (!job._shader)
+        {
+            LOG_ERROR("ResourceManager::compileShaders: %s is failed", job._name.c_str());
+            ++failed;
+            continue;
+        }
+        result._shader = job._shader;
+
+        auto found = m_resources.find(job._name);
+        if (found != m_resources.end())
+        {
+            ResourceManager::remove(found->second);
+        }
+        m_resources.emplace(job._name, job._shader);
+        LOG_DEBUG("ResourceManager::compileShaders: %s, time %.3f ms", job._name.c_str(), static_cast<f64>(job._time) / 1000.0);
+    }
+
+    for (u32 index = 0; index < permutations.size(); ++index)
+    {
+        if (sources[index] != ~0U)
+        {
+            results[index]._shader = results[sources[index]]._shader;
+            results[index]._duplicate = true;
+        }
+    }
+
+    LOG_INFO("ResourceManager::compileShaders: permutations %u, compiled %u, failed %u. Time %.3f ms", static_cast<u32>(permutations.size()), static_cast<u32>(jobs.size()) - failed, failed,
+        static_cast<f64>(timer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1000.0);
+
+    return results;
+}
+
+std::string ResourceManager::composeShaderName(const std::string& filename, const std::string& entrypoint, const renderer::Shader::DefineList& defines)
+{
+    renderer::Shader::DefineList innerDefines(defines);
+    std::sort(innerDefines.begin(), innerDefines.end(), [](const std::pair<std::string, std::string>& macros1, const std::pair<std::string, std::string>& macros2) -> bool
+        {
+            return macros1.first < macros2.first;
+        });
+
+    std::string outString = filename;
+    outString.append("#");
+    outString.append(entrypoint);
+
+    for (auto& define : innerDefines)
+    {
+        outString.append("#");
+        outString.append(define.first);
+        outString.append(define.second);
+    }
+
+    return outString;
+}
+
+renderer::Shader::LoadPolicy ResourceManager::makeShaderPolicy(renderer::ShaderType type, const std::string& entrypoint, const renderer::Shader::DefineList& defines,
+    const std::vector<std::string>& includes, u32 flags)
+{
+    renderer::Shader::LoadPolicy policy;
+    policy.content = renderer::ShaderContent::Source;
+    policy.shaderModel = (flags & ShaderCompileFlag::ShaderCompile_UseLegacyCompilerForHLSL) ? renderer::ShaderModel::HLSL_5_1 : renderer::ShaderModel::HLSL;
+    policy.type = type;
+    policy.defines = defines;
+    policy.includes = includes;
+    policy.entryPoint = entrypoint;
+
+    return policy;
+}
+
+} //namespace resource
+} //namespace v3d
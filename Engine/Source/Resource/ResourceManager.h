@@ -11,6 +11,10 @@
 #include "Renderer/Shader.h"
 #include "Resource/Decoder/ShaderDecoder.h"
 
+#include "Task/TaskScheduler.h"
+#include "Thread/Thread.h"
+#include "Utils/Logger.h"
+
 namespace v3d
 {
 namespace renderer
@@ -19,8 +23,137 @@ namespace renderer
 } //namespace renderer
 namespace resource
 {
+    class ResourceManager;
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
-    
+
+    /**
+    * @brief LoadPriority enum. Pending requests are taken by the highest priority first, in the order of the requests otherwise
+    */
+    enum class LoadPriority : u32
+    {
+        Low,
+        Normal,
+        High
+    };
+
+    /**
+    * @brief AsyncLoadRequest class. Shared state of the asynchronous load, see ResourceManager::loadAsync
+    */
+    class AsyncLoadRequest final
+    {
+    public:
+
+        enum class Status : u32
+        {
+            Pending,
+            Loading,
+            Loaded,     //Decoded and uploaded, waits for ResourceManager::update
+            Completed,
+            Failed,
+            Cancelled
+        };
+
+        AsyncLoadRequest(const std::string& name, LoadPriority priority) noexcept;
+        ~AsyncLoadRequest() = default;
+
+        AsyncLoadRequest(const AsyncLoadRequest&) = delete;
+        AsyncLoadRequest& operator=(const AsyncLoadRequest&) = delete;
+
+        /**
+        * @brief cancel. A pending request is skipped, a loaded resource is destroyed instead of the registration.
+        * The request is shared by all callers of the same name
+        */
+        void cancel();
+
+        Status getStatus() const;
+        bool isDone() const;
+        const std::string& getName() const;
+
+        template<class TResource>
+        TResource* getResource() const;
+
+    private:
+
+        friend ResourceManager;
+
+        std::string                 m_name;
+        std::atomic<LoadPriority>   m_priority;
+        std::atomic<Status>         m_status;
+        std::atomic<bool>           m_cancelled;
+        u64                         m_order;
+        bool                        m_unique;
+        std::function<Resource*()>  m_load;
+        Resource*                   m_resource;
+    };
+
+    using AsyncLoadHandle = std::shared_ptr<AsyncLoadRequest>;
+
+    inline AsyncLoadRequest::AsyncLoadRequest(const std::string& name, LoadPriority priority) noexcept
+        : m_name(name)
+        , m_priority(priority)
+        , m_status(Status::Pending)
+        , m_cancelled(false)
+        , m_order(0)
+        , m_unique(true)
+        , m_resource(nullptr)
+    {
+    }
+
+    inline void AsyncLoadRequest::cancel()
+    {
+        m_cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    inline AsyncLoadRequest::Status AsyncLoadRequest::getStatus() const
+    {
+        return m_status.load(std::memory_order_acquire);
+    }
+
+    inline bool AsyncLoadRequest::isDone() const
+    {
+        const Status status = getStatus();
+        return status == Status::Completed || status == Status::Failed || status == Status::Cancelled;
+    }
+
+    inline const std::string& AsyncLoadRequest::getName() const
+    {
+        return m_name;
+    }
+
+    template<class TResource>
+    inline TResource* AsyncLoadRequest::getResource() const
+    {
+        return (getStatus() == Status::Completed) ? static_cast<TResource*>(m_resource) : nullptr;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief ShaderPermutation struct. One variant of a shader for ResourceManager::compileShaders
+    */
+    struct ShaderPermutation
+    {
+        std::string                     _filename;
+        std::string                     _entrypoint = "main";
+        renderer::ShaderType            _type = renderer::ShaderType::Vertex;
+        renderer::Shader::DefineList    _defines = {};
+        std::vector<std::string>        _includes = {};
+    };
+
+    /**
+    * @brief ShaderPermutationResult struct. The shader is nullptr if the compilation is failed.
+    * Duplicates of another permutation in the batch share its shader and have zero time
+    */
+    struct ShaderPermutationResult
+    {
+        renderer::Shader*   _shader = nullptr;
+        u64                 _compileTime = 0; //microseconds
+        bool                _duplicate = false;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
     /**
     * @brief ResourceManager, Singleton
     */
@@ -43,6 +176,63 @@ namespace resource
         template<class TResource, class TResourceLoader, typename TPolicy = TResourceLoader::PolicyType>
         [[nodiscard]]  TResource* load(const std::string& filename, const TPolicy& policy, u32 flags = 0);
 
+        /**
+        * @brief loadAsync interface.
+        * Same as load, but the file reading and decoding run on the loading threads, see initAsyncLoading.
+        * GPU uploads of the resources are executed in the main thread by update, the resource is registered there too.
+        * Requests of the same unique resource share one handle. Works as load if async loading isn't initialized
+        *
+        * @param const std::string& filename [required]
+        * @param const TPolicy& policy [required]
+        * @param u32 flags [optional]
+        * @param LoadPriority priority [optional]
+        * @return handle of the request
+        */
+        template<class TResource, class TResourceLoader, typename TPolicy = TResourceLoader::PolicyType>
+        [[nodiscard]] AsyncLoadHandle loadAsync(const std::string& filename, const TPolicy& policy, u32 flags = 0, LoadPriority priority = LoadPriority::Normal);
+
+        /**
+        * @brief initAsyncLoading. Creates the loading threads. Must be called in the main thread
+        * @param u32 numThreads [required]
+        */
+        void initAsyncLoading(u32 numThreads);
+
+        /**
+        * @brief shutdownAsyncLoading. Waits all requests and destroys the loading threads
+        */
+        void shutdownAsyncLoading();
+
+        /**
+        * @brief update. Executes the uploads and registers loaded resources. Must be called in the main thread
+        */
+        void update();
+
+        /**
+        * @brief wait. Updates until the request is done. Must be called in the main thread
+        */
+        void wait(const AsyncLoadHandle& request);
+
+        /**
+        * @brief getScheduler. The loading threads are the worker threads of the engine: texture decoders and pipeline compilation share them.
+        * nullptr until initAsyncLoading. The tasks must be waited by the main thread or the loading threads, see TaskScheduler::isOwnThread
+        */
+        task::TaskScheduler* getScheduler() const;
+
+        /**
+        * @brief acquireScheduler. The loading threads for the background work of other systems, the tasks aren't tracked by the requests.
+        * nullptr if they aren't created or the calling thread can't wait their tasks, then the caller does the work itself.
+        * Every not null result must be paired with releaseScheduler when the work is finished, shutdownAsyncLoading waits it
+        */
+        task::TaskScheduler* acquireScheduler();
+        void releaseScheduler();
+
+        /**
+        * @brief executeOnUploadThread. Resources call it for the GPU work inside Resource::load.
+        * Runs in place in the main thread, otherwise the caller waits until the main thread executes it in update
+        */
+        template<typename Func>
+        void executeOnUploadThread(Func&& func);
+
         /**
         * @brief loadShader
         * Create shader from the file. Suppotrs ShaderSourceFileLoader
@@ -58,6 +248,18 @@ namespace resource
         [[nodiscard]] TResource* loadShader(const std::string& filename,
             const std::string& entrypoint = "main", const renderer::Shader::DefineList& defines = {}, const std::vector<std::string>& includes = {}, u32 flags = 0);
 
+        /**
+        * @brief compileShaders
+        * Compiles a batch of permutations concurrently on the loading threads, sequentially if initAsyncLoading was not called.
+        * The shaders are registered with the same names as loadShader uses, so the next loadShader of a permutation finds it.
+        * Must be called in the main thread. Supports ShaderSourceFileLoader
+        *
+        * @param const std::vector<ShaderPermutation>& permutations [required]
+        * @param u32 flags [optional]
+        * @return a result per permutation in the same order
+        */
+        std::vector<ShaderPermutationResult> compileShaders(const std::vector<ShaderPermutation>& permutations, u32 flags = 0);
+
         /**
         * @brief composeShader interface.
         * Create a shader from steam data. Supports: ShaderSourceStreamLoader
@@ -108,15 +310,42 @@ namespace resource
         /**
         * @brief ResourceManager constructor
         */
-        ResourceManager() noexcept = default;
+        ResourceManager() noexcept;
+        ~ResourceManager();
+
+        void enqueueRequest(const AsyncLoadHandle& request);
+        void processRequest();
+        void finalizeRequest(const AsyncLoadHandle& request);
+        void registerResource(const std::string& name, Resource* resource);
+
+        static std::string composeShaderName(const std::string& filename, const std::string& entrypoint, const renderer::Shader::DefineList& defines);
+        static renderer::Shader::LoadPolicy makeShaderPolicy(renderer::ShaderType type, const std::string& entrypoint, const renderer::Shader::DefineList& defines,
+            const std::vector<std::string>& includes, u32 flags);
 
         std::unordered_map<TypePtr, std::unique_ptr<BaseLoader>> m_registerLoaders;
         std::map<std::string, Resource*>        m_resources;
         std::vector<std::string>                m_paths;
+
+        task::TaskScheduler*                    m_scheduler;
+        task::TaskPool                          m_taskPool;
+        std::vector<task::Task*>                m_loadTasks;
+        std::atomic<u32>                        m_externalWork;
+        std::unordered_map<std::string, AsyncLoadHandle> m_inFlight;
+        u64                                     m_requestCounter;
+
+        std::mutex                              m_pendingMutex;
+        std::vector<AsyncLoadHandle>            m_pending;
+        std::mutex                              m_finishedMutex;
+        std::vector<AsyncLoadHandle>            m_finished;
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    inline task::TaskScheduler* ResourceManager::getScheduler() const
+    {
+        return m_scheduler;
+    }
+
     template<class TBaseResource>
     inline void ResourceManager::registerLoader(std::unique_ptr<ResourceLoader<TBaseResource>> loader)
     {
@@ -171,36 +400,92 @@ namespace resource
         return nullptr;
     }
 
-    template<class TResource, class TResourceLoader>
-    inline TResource* ResourceManager::loadShader(const std::string& filename, 
-        const std::string& entrypoint, const renderer::Shader::DefineList& defines, const std::vector<std::string>& includes, ShaderCompileFlags flags)
+    template<class TResource, class TResourceLoader, typename TPolicy>
+    inline AsyncLoadHandle ResourceManager::loadAsync(const std::string& filename, const TPolicy& policy, u32 flags, LoadPriority priority)
     {
-        static_assert(std::is_base_of<renderer::Shader, TResource>(), "wrong type");
+        ASSERT(thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId(), "must be main thread");
         std::string innerName(filename);
-        std::transform(filename.begin(), filename.end(), innerName.begin(), ::tolower);
+        std::transform(filename.cbegin(), filename.cend(), innerName.begin(), ::tolower);
 
-        renderer::Shader::DefineList innerDefines(defines);
-        std::sort(innerDefines.begin(), innerDefines.end(), [](const std::pair<std::string, std::string>& macros1, const std::pair<std::string, std::string>& macros2) -> bool
-            {
-                return macros1.first < macros2.first;
-            });
+        AsyncLoadHandle request = std::make_shared<AsyncLoadRequest>(innerName, priority);
+        request->m_unique = policy.unique;
+        if (!m_scheduler)
+        {
+            request->m_resource = ResourceManager::load<TResource, TResourceLoader, TPolicy>(filename, policy, flags);
+            request->m_status.store(request->m_resource ? AsyncLoadRequest::Status::Completed : AsyncLoadRequest::Status::Failed, std::memory_order_release);
+            return request;
+        }
 
-        auto composeResourceName = [](const std::string& name, const std::string& entrypoint, const std::vector<std::pair<std::string, std::string>>& defines) -> std::string
+        if (policy.unique)
+        {
+            auto found = m_resources.find(innerName);
+            if (found != m_resources.end())
             {
-                std::string outString = name;
-                outString.append("#");
-                outString.append(entrypoint);
+                request->m_resource = found->second;
+                request->m_status.store(AsyncLoadRequest::Status::Completed, std::memory_order_release);
+                return request;
+            }
 
-                for (auto& define : defines)
+            auto inFlight = m_inFlight.find(innerName);
+            if (inFlight != m_inFlight.end())
+            {
+                //The pending request takes the highest of priorities
+                AsyncLoadHandle& existing = inFlight->second;
+                if (existing->m_priority.load(std::memory_order_relaxed) < priority)
                 {
-                    outString.append("#");
-                    outString.append(define.first);
-                    outString.append(define.second);
+                    existing->m_priority.store(priority, std::memory_order_relaxed);
                 }
+                return existing;
+            }
+        }
 
-                return outString;
+        auto loader = ResourceManager::getLoader<typename TResourceLoader::ResourceType>();
+        if (!loader)
+        {
+            LOG_ERROR("ResourceManager::loadAsync: loader isn't registered, %s", filename.c_str());
+            request->m_status.store(AsyncLoadRequest::Status::Failed, std::memory_order_release);
+            return request;
+        }
+
+        //The loaders and decoders are called from several loading threads at once
+        request->m_load = [loader, filename, policy, flags]() -> Resource*
+            {
+                return loader->load(filename, policy, flags);
             };
-        const std::string resourceName = composeResourceName(innerName, entrypoint, innerDefines);
+        ResourceManager::enqueueRequest(request);
+
+        return request;
+    }
+
+    template<typename Func>
+    inline void ResourceManager::executeOnUploadThread(Func&& func)
+    {
+        if (!m_scheduler || thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId())
+        {
+            func();
+            return;
+        }
+
+        task::Task* task = m_taskPool.acquireTask();
+        task->init("ResourceManager::upload", [&func]() -> void
+            {
+                func();
+            });
+
+        m_scheduler->executeTask(task, task::TaskPriority::Normal, task::TaskMask::MainThread);
+        task->waitCompetition();
+        m_taskPool.releaseTask(task);
+    }
+
+    template<class TResource, class TResourceLoader>
+    inline TResource* ResourceManager::loadShader(const std::string& filename, 
+        const std::string& entrypoint, const renderer::Shader::DefineList& defines, const std::vector<std::string>& includes, ShaderCompileFlags flags)
+    {
+        static_assert(std::is_base_of<renderer::Shader, TResource>(), "wrong type");
+        std::string innerName(filename);
+        std::transform(filename.begin(), filename.end(), innerName.begin(), ::tolower);
+
+        const std::string resourceName = ResourceManager::composeShaderName(innerName, entrypoint, defines);
         bool forceReload = flags & ShaderCompileFlag::ShaderCompile_ForceReload;
 
         auto found = m_resources.find(resourceName);
@@ -216,13 +501,7 @@ namespace resource
                 return nullptr;
             }
 
-            renderer::Shader::LoadPolicy policy;
-            policy.content = renderer::ShaderContent::Source;
-            policy.shaderModel = (flags & ShaderCompileFlag::ShaderCompile_UseLegacyCompilerForHLSL) ? renderer::ShaderModel::HLSL_5_1 : renderer::ShaderModel::HLSL;
-            policy.type = renderer::getShaderTypeByClass<TResource>();
-            policy.defines = defines;
-            policy.includes = includes;
-            policy.entryPoint = entrypoint;
+            const renderer::Shader::LoadPolicy policy = ResourceManager::makeShaderPolicy(renderer::getShaderTypeByClass<TResource>(), entrypoint, defines, includes, flags);
 
             if (forceReload)
             {
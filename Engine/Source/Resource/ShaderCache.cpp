@@ -0,0 +1,473 @@
+#include "ShaderCache.h"
+#include "Stream/StreamManager.h"
+#include "Stream/FileLoader.h"
+#include "Utils/FNV-1a.h"
+#include "Utils/Logger.h"
+
+namespace v3d
+{
+namespace resource
+{
+
+constexpr u32 k_shaderCacheMagic = 0x43533356; //V3SC
+constexpr u32 k_shaderCacheVersion = 1;
+constexpr u64 k_shaderCacheCheckSeed = 0x9E3779B97F4A7C15;
+constexpr u32 k_maxIncludeDepth = 32;
+static const c8* k_shaderCacheExtension = ".shc";
+
+struct ShaderCacheEntryHeader
+{
+    u32 _magic;
+    u32 _version;
+    u64 _hash;
+    u64 _check;
+    u64 _size;
+};
+
+class ShaderCacheHasher
+{
+public:
+
+    ShaderCacheHasher() noexcept
+        : m_hash(utils::k_fnv1a_offset_64)
+        , m_check(k_shaderCacheCheckSeed)
+    {
+    }
+
+    void add(const void* data, u64 size)
+    {
+        //The size separates neighbouring fields
+        m_hash = utils::fnv1a_hash64_data(&size, sizeof(size), m_hash);
+        m_hash = utils::fnv1a_hash64_data(data, size, m_hash);
+        m_check = utils::fnv1a_hash64_data(data, size, m_check);
+        m_check = utils::fnv1a_hash64_data(&size, sizeof(size), m_check);
+    }
+
+    void add(const std::string& string)
+    {
+        add(string.data(), string.size());
+    }
+
+    template<typename T>
+    void addValue(T value)
+    {
+        add(&value, sizeof(T));
+    }
+
+    ShaderCache::Key getKey() const
+    {
+        return { m_hash, m_check };
+    }
+
+private:
+
+    u64 m_hash;
+    u64 m_check;
+};
+
+static bool readFile(const std::string& filename, std::string& content)
+{
+    stream::FileStream* file = stream::FileLoader::load(filename);
+    if (!file)
+    {
+        return false;
+    }
+
+    content.resize(file->size());
+    file->read(content.data(), file->size());
+    stream::FileLoader::close(file);
+
+    return true;
+}
+
+/**
+* @brief Same spelling as the includers of the decoders: "./" is dropped and the separators are '/'
+*/
+static std::string normalizeIncludePath(const std::string& path)
+{
+    std::string normalized(path);
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0)
+    {
+        normalized.erase(0, 2);
+    }
+
+    return normalized;
+}
+
+/**
+* @brief The file systems of the shader platforms don't match the case, the glslang includer lowercases the names too
+*/
+static std::string lowercaseIncludePath(const std::string& path)
+{
+    std::string lowercased(path);
+    std::transform(lowercased.begin(), lowercased.end(), lowercased.begin(), [](c8 c) -> c8
+        {
+            return static_cast<c8>(std::tolower(static_cast<u8>(c)));
+        });
+
+    return lowercased;
+}
+
+/**
+* @brief Search order of the includers: as is, policy.paths, then policy.includes. The lowercased name is tried for the glslang includer
+*/
+static bool resolveInclude(const std::string& name, const renderer::Shader::LoadPolicy& policy, std::string& resolved, std::string& content)
+{
+    const std::string names[] = { name, lowercaseIncludePath(name) };
+    for (const std::string& spelling : names)
+    {
+        resolved = spelling;
+        if (readFile(resolved, content))
+        {
+            return true;
+        }
+
+        for (const std::string& path : policy.paths)
+        {
+            resolved = normalizeIncludePath(path) + spelling;
+            if (readFile(resolved, content))
+            {
+                return true;
+            }
+        }
+
+        for (const std::string& path : policy.includes)
+        {
+            resolved = normalizeIncludePath(path) + spelling;
+            if (readFile(resolved, content))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static bool hashIncludes(ShaderCacheHasher& hasher, const std::string& source, const renderer::Shader::LoadPolicy& policy, std::set<std::string>& visited, u32 depth)
+{
+    if (depth > k_maxIncludeDepth)
+    {
+        LOG_WARNING("ShaderCache::computeKey: include depth is over %u", k_maxIncludeDepth);
+        return false;
+    }
+
+    //Conditional includes are hashed too, the key is conservative
+    for (size_t pos = source.find("#include"); pos != std::string::npos; pos = source.find("#include", pos + 1))
+    {
+        const size_t begin = source.find_first_of("\"<", pos);
+        const size_t lineEnd = source.find('\n', pos);
+        if (begin == std::string::npos || begin > lineEnd)
+        {
+            continue;
+        }
+
+        const size_t end = source.find_first_of("\">", begin + 1);
+        if (end == std::string::npos || end > lineEnd)
+        {
+            continue;
+        }
+
+        //The spelling of the name doesn't change the result, the key doesn't depend on it
+        const std::string name = normalizeIncludePath(source.substr(begin + 1, end - begin - 1));
+        hasher.add(lowercaseIncludePath(name));
+
+        //A file which isn't found can't be hashed, the key would miss its changes
+        std::string resolved;
+        std::string content;
+        if (!resolveInclude(name, policy, resolved, content))
+        {
+            LOG_WARNING("ShaderCache::computeKey: include %s isn't found, the cache is bypassed", name.c_str());
+            return false;
+        }
+
+        if (!visited.insert(lowercaseIncludePath(normalizeIncludePath(resolved))).second)
+        {
+            continue;
+        }
+
+        hasher.add(content);
+        if (!hashIncludes(hasher, content, policy, visited, depth + 1))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ShaderCache::ShaderCache() noexcept
+    : m_maxSize(k_defaultMaxSize)
+    , m_currentSize(0)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+void ShaderCache::setDirectory(const std::string& directory, u64 maxSize)
+{
+    std::lock_guard lock(m_mutex);
+
+    m_directory.clear();
+    m_maxSize = maxSize;
+    m_currentSize = 0;
+    if (directory.empty())
+    {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        LOG_ERROR("ShaderCache::setDirectory: can't create directory %s, %s", directory.c_str(), error.message().c_str());
+        return;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == k_shaderCacheExtension)
+        {
+            m_currentSize += entry.file_size();
+        }
+    }
+    m_directory = directory;
+    if (m_directory.back() != '/' && m_directory.back() != '\\')
+    {
+        m_directory.push_back('/');
+    }
+
+    if (m_currentSize > m_maxSize)
+    {
+        ShaderCache::evict();
+    }
+    LOG_DEBUG("ShaderCache::setDirectory: %s, size %llu bytes", m_directory.c_str(), m_currentSize);
+}
+
+bool ShaderCache::computeKey(const std::string& source, const renderer::Shader::LoadPolicy& policy, u32 compileFlags, const std::string& compilerVersion, Key& key)
+{
+    ShaderCacheHasher hasher;
+    hasher.addValue(k_shaderCacheVersion);
+    hasher.add(compilerVersion);
+    hasher.addValue(compileFlags);
+    hasher.addValue(policy.type);
+    hasher.addValue(policy.shaderModel);
+    hasher.addValue(policy.useReflection);
+    hasher.add(policy.entryPoint);
+
+    //Order of the defines doesn't change the result of the compilation
+    renderer::Shader::DefineList defines(policy.defines);
+    std::sort(defines.begin(), defines.end());
+    for (const auto& define : defines)
+    {
+        hasher.add(define.first);
+        hasher.add(define.second);
+    }
+
+    hasher.add(source);
+
+    std::set<std::string> visited;
+    if (!hashIncludes(hasher, source, policy, visited, 0))
+    {
+        return false;
+    }
+
+    key = hasher.getKey();
+    return true;
+}
+
+stream::Stream* ShaderCache::load(const Key& key)
+{
+    const std::string path = ShaderCache::getEntryPath(key);
+    if (path.empty())
+    {
+        return nullptr;
+    }
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    ShaderCacheEntryHeader header = {};
+    file.read(reinterpret_cast<c8*>(&header), sizeof(ShaderCacheEntryHeader));
+    if (!file || header._magic != k_shaderCacheMagic || header._version != k_shaderCacheVersion || header._hash != key._hash || header._check != key._check
+        || header._size == 0 || header._size > std::numeric_limits<u32>::max())
+    {
+        LOG_WARNING("ShaderCache::load: entry %s is invalid, removed", path.c_str());
+        file.close();
+
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+
+        return nullptr;
+    }
+
+    stream::Stream* stream = stream::StreamManager::createMemoryStream(nullptr, static_cast<u32>(header._size));
+    file.read(reinterpret_cast<c8*>(stream->map(stream->size())), header._size);
+    stream->unmap();
+    if (!file)
+    {
+        LOG_WARNING("ShaderCache::load: entry %s is truncated", path.c_str());
+        stream::StreamManager::destroyStream(stream);
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+
+        return nullptr;
+    }
+    file.close();
+
+    //The write time is the last use time for the eviction
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return stream;
+}
+
+void ShaderCache::store(const Key& key, const stream::Stream* stream)
+{
+    ASSERT(stream, "nullptr");
+    const std::string path = ShaderCache::getEntryPath(key);
+    if (path.empty() || stream->size() == 0)
+    {
+        return;
+    }
+
+    //Loaders may write the same entry from several threads, every writer has own temporary file
+    const std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARNING("ShaderCache::store: can't create %s", tempPath.c_str());
+            return;
+        }
+
+        ShaderCacheEntryHeader header = { k_shaderCacheMagic, k_shaderCacheVersion, key._hash, key._check, stream->size() };
+        file.write(reinterpret_cast<const c8*>(&header), sizeof(ShaderCacheEntryHeader));
+
+        const u32 position = stream->tell();
+        stream->seekBeg(0);
+        file.write(reinterpret_cast<const c8*>(stream->map(stream->size())), stream->size());
+        stream->unmap();
+        stream->seekBeg(position);
+
+        file.close();
+        if (!file)
+        {
+            LOG_WARNING("ShaderCache::store: can't write %s", tempPath.c_str());
+
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+
+    //The size of the replaced entry is taken under the lock, two writers of the same key must not both see it missing
+    std::lock_guard lock(m_mutex);
+
+    std::error_code error;
+    const u64 replacedSize = std::filesystem::is_regular_file(path, error) ? std::filesystem::file_size(path, error) : 0;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        LOG_WARNING("ShaderCache::store: can't rename %s, %s", tempPath.c_str(), error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return;
+    }
+
+    m_currentSize -= std::min(replacedSize, m_currentSize);
+    m_currentSize += sizeof(ShaderCacheEntryHeader) + stream->size();
+    if (m_currentSize > m_maxSize)
+    {
+        ShaderCache::evict();
+    }
+}
+
+void ShaderCache::clear()
+{
+    std::lock_guard lock(m_mutex);
+    if (m_directory.empty())
+    {
+        return;
+    }
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == k_shaderCacheExtension)
+        {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+    m_currentSize = 0;
+}
+
+std::string ShaderCache::getEntryPath(const Key& key) const
+{
+    std::lock_guard lock(m_mutex);
+    if (m_directory.empty())
+    {
+        return "";
+    }
+
+    c8 name[32];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key._hash));
+
+    return m_directory + name + k_shaderCacheExtension;
+}
+
+void ShaderCache::evict()
+{
+    struct Entry
+    {
+        std::filesystem::path           _path;
+        std::filesystem::file_time_type _time;
+        u64                             _size;
+    };
+
+    std::vector<Entry> entries;
+    u64 size = 0;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == k_shaderCacheExtension)
+        {
+            entries.push_back({ entry.path(), entry.last_write_time(error), entry.file_size(error) });
+            size += entries.back()._size;
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& left, const Entry& right) -> bool
+        {
+            return left._time < right._time;
+        });
+
+    //Evict to 3/4 of the limit, otherwise every next store evicts again
+    const u64 targetSize = m_maxSize / 4 * 3;
+    u32 removed = 0;
+    for (const Entry& entry : entries)
+    {
+        if (size <= targetSize)
+        {
+            break;
+        }
+
+        if (std::filesystem::remove(entry._path, error))
+        {
+            size -= entry._size;
+            ++removed;
+        }
+    }
+    m_currentSize = size;
+
+    LOG_DEBUG("ShaderCache::evict: removed %u entries, size %llu bytes", removed, m_currentSize);
+}
+
+} //namespace resource
+} //namespace v3d
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Common.h"
+#include "Utils/Singleton.h"
+#include "Renderer/Shader.h"
+
+namespace v3d
+{
+namespace stream
+{
+    class Stream;
+} //namespace stream
+namespace resource
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief ShaderCache class. Persistent cache of the compiled shaders, Singleton.
+    * An entry keeps the decoded shader stream: bytecode and reflection. The key is a hash of the source, the content of the included files,
+    * defines, entry point, shader type and model, compile flags and the compiler version.
+    * Entries are written to a temporary file and renamed, the last used entries are evicted when the directory grows over the limit.
+    * Disabled until setDirectory is called. Thread safe
+    */
+    class V3D_API ShaderCache final : public utils::Singleton<ShaderCache>
+    {
+    public:
+
+        static constexpr u64 k_defaultMaxSize = 256 * 1024 * 1024;
+
+        /**
+        * @brief Key struct. Two independent hashes of the same data, the second one is checked on load
+        */
+        struct Key
+        {
+            u64 _hash = 0;
+            u64 _check = 0;
+        };
+
+        /**
+        * @brief setDirectory. Enables the cache, the empty path disables it
+        * @param const std::string& directory [required]
+        * @param u64 maxSize [optional] the limit of the directory size in bytes
+        */
+        void setDirectory(const std::string& directory, u64 maxSize = k_defaultMaxSize);
+        bool isEnabled() const;
+
+        /**
+        * @brief computeKey. Include files are searched in policy.paths and policy.includes, the names are normalized as the includers do.
+        * Returns false if an include file isn't found, the shader must be compiled without the cache then
+        */
+        static bool computeKey(const std::string& source, const renderer::Shader::LoadPolicy& policy, u32 compileFlags, const std::string& compilerVersion, Key& key);
+
+        /**
+        * @brief load. Returns a memory stream with the cached data or nullptr. The stream must be destroyed by StreamManager::destroyStream
+        */
+        [[nodiscard]] stream::Stream* load(const Key& key);
+        void store(const Key& key, const stream::Stream* stream);
+
+        void clear();
+
+        u64 getHits() const;
+        u64 getMisses() const;
+
+    private:
+
+        friend utils::Singleton<ShaderCache>;
+        template<class T>
+        friend void memory::internal_delete(T* ptr, v3d::memory::MemoryLabel label, const v3d::c8* file, v3d::u32 line);
+
+        ShaderCache() noexcept;
+        ~ShaderCache() = default;
+
+        std::string getEntryPath(const Key& key) const;
+        void evict();
+
+        mutable std::mutex  m_mutex;
+        std::string         m_directory;
+        u64                 m_maxSize;
+        u64                 m_currentSize;
+
+        std::atomic<u64>    m_hits;
+        std::atomic<u64>    m_misses;
+    };
+
+    inline bool ShaderCache::isEnabled() const
+    {
+        std::lock_guard lock(m_mutex);
+        return !m_directory.empty();
+    }
+
+    inline u64 ShaderCache::getHits() const
+    {
+        return m_hits.load(std::memory_order_relaxed);
+    }
+
+    inline u64 ShaderCache::getMisses() const
+    {
+        return m_misses.load(std::memory_order_relaxed);
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace resource
+} //namespace v3d
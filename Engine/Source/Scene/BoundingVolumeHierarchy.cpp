@@ -0,0 +1,365 @@
+#include "BoundingVolumeHierarchy.h"
+
+namespace v3d
+{
+namespace scene
+{
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy() noexcept
+    : m_root(k_invalidProxy)
+    , m_freeList(k_invalidProxy)
+    , m_proxyCount(0)
+{
+}
+
+BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+{
+}
+
+u32 BoundingVolumeHierarchy::createProxy(const math::AABB& aabb, u32 userData)
+{
+    ASSERT(aabb.isValid(), "invalid aabb");
+    const u32 proxyID = allocateNode();
+
+    const math::TVector3D<f32> margin(k_aabbMargin, k_aabbMargin, k_aabbMargin);
+    Node& node = m_nodes[proxyID];
+    node._aabb = math::AABB(aabb.getMin() - margin, aabb.getMax() + margin);
+    node._userData = userData;
+    node._height = 0;
+
+    insertLeaf(proxyID);
+    ++m_proxyCount;
+
+    return proxyID;
+}
+
+void BoundingVolumeHierarchy::destroyProxy(u32 proxyID)
+{
+    ASSERT(proxyID < m_nodes.size() && m_nodes[proxyID].isLeaf(), "invalid proxy");
+    removeLeaf(proxyID);
+    freeNode(proxyID);
+    --m_proxyCount;
+}
+
+bool BoundingVolumeHierarchy::moveProxy(u32 proxyID, const math::AABB& aabb)
+{
+    ASSERT(proxyID < m_nodes.size() && m_nodes[proxyID].isLeaf(), "invalid proxy");
+    if (contains(m_nodes[proxyID]._aabb, aabb))
+    {
+        return false;
+    }
+
+    removeLeaf(proxyID);
+
+    const math::TVector3D<f32> margin(k_aabbMargin, k_aabbMargin, k_aabbMargin);
+    m_nodes[proxyID]._aabb = math::AABB(aabb.getMin() - margin, aabb.getMax() + margin);
+
+    insertLeaf(proxyID);
+
+    return true;
+}
+
+void BoundingVolumeHierarchy::clear()
+{
+    m_nodes.clear();
+    m_root = k_invalidProxy;
+    m_freeList = k_invalidProxy;
+    m_proxyCount = 0;
+}
+
+u32 BoundingVolumeHierarchy::allocateNode()
+{
+    if (m_freeList == k_invalidProxy)
+    {
+        const u32 first = static_cast<u32>(m_nodes.size());
+        const u32 count = std::max<u32>(first, 16);
+        m_nodes.resize(first + count);
+        for (u32 i = first; i < first + count; ++i)
+        {
+            m_nodes[i]._parent = (i + 1 < first + count) ? i + 1 : k_invalidProxy;
+            m_nodes[i]._height = -1;
+        }
+        m_freeList = first;
+    }
+
+    const u32 nodeID = m_freeList;
+    Node& node = m_nodes[nodeID];
+    m_freeList = node._parent;
+
+    node._parent = k_invalidProxy;
+    node._child1 = k_invalidProxy;
+    node._child2 = k_invalidProxy;
+    node._height = 0;
+    node._userData = k_invalidProxy;
+
+    return nodeID;
+}
+
+void BoundingVolumeHierarchy::freeNode(u32 nodeID)
+{
+    m_nodes[nodeID]._parent = m_freeList;
+    m_nodes[nodeID]._height = -1;
+    m_freeList = nodeID;
+}
+
+void BoundingVolumeHierarchy::insertLeaf(u32 leaf)
+{
+    if (m_root == k_invalidProxy)
+    {
+        m_root = leaf;
+        m_nodes[leaf]._parent = k_invalidProxy;
+        return;
+    }
+
+    //Find the best sibling by the surface area heuristic
+    const math::AABB leafAABB = m_nodes[leaf]._aabb;
+    u32 index = m_root;
+    while (!m_nodes[index].isLeaf())
+    {
+        const Node& node = m_nodes[index];
+        const f32 nodeArea = area(node._aabb);
+        const f32 combinedArea = area(combine(node._aabb, leafAABB));
+
+        //Cost of creating a new parent for this node and the leaf
+        const f32 cost = 2.f * combinedArea;
+        //Minimum cost of pushing the leaf further down the tree
+        const f32 inheritanceCost = 2.f * (combinedArea - nodeArea);
+
+        auto descendCost = [this, &leafAABB, inheritanceCost](u32 child) -> f32
+            {
+                const Node& childNode = m_nodes[child];
+                const f32 newArea = area(combine(leafAABB, childNode._aabb));
+                return (childNode.isLeaf() ? newArea : newArea - area(childNode._aabb)) + inheritanceCost;
+            };
+
+        const f32 cost1 = descendCost(node._child1);
+        const f32 cost2 = descendCost(node._child2);
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+
+        index = (cost1 < cost2) ? node._child1 : node._child2;
+    }
+
+    const u32 sibling = index;
+    const u32 newParent = allocateNode();
+    const u32 oldParent = m_nodes[sibling]._parent;
+
+    m_nodes[newParent]._parent = oldParent;
+    m_nodes[newParent]._aabb = combine(leafAABB, m_nodes[sibling]._aabb);
+    m_nodes[newParent]._height = m_nodes[sibling]._height + 1;
+    m_nodes[newParent]._child1 = sibling;
+    m_nodes[newParent]._child2 = leaf;
+    m_nodes[sibling]._parent = newParent;
+    m_nodes[leaf]._parent = newParent;
+
+    if (oldParent != k_invalidProxy)
+    {
+        if (m_nodes[oldParent]._child1 == sibling)
+        {
+            m_nodes[oldParent]._child1 = newParent;
+        }
+        else
+        {
+            m_nodes[oldParent]._child2 = newParent;
+        }
+    }
+    else
+    {
+        m_root = newParent;
+    }
+
+    //Refit the ancestors
+    index = m_nodes[leaf]._parent;
+    while (index != k_invalidProxy)
+    {
+        index = balance(index);
+
+        Node& node = m_nodes[index];
+        node._height = 1 + std::max(m_nodes[node._child1]._height, m_nodes[node._child2]._height);
+        node._aabb = combine(m_nodes[node._child1]._aabb, m_nodes[node._child2]._aabb);
+
+        index = node._parent;
+    }
+}
+
+void BoundingVolumeHierarchy::removeLeaf(u32 leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = k_invalidProxy;
+        return;
+    }
+
+    const u32 parent = m_nodes[leaf]._parent;
+    const u32 grandParent = m_nodes[parent]._parent;
+    const u32 sibling = (m_nodes[parent]._child1 == leaf) ? m_nodes[parent]._child2 : m_nodes[parent]._child1;
+
+    freeNode(parent);
+
+    if (grandParent == k_invalidProxy)
+    {
+        m_root = sibling;
+        m_nodes[sibling]._parent = k_invalidProxy;
+        return;
+    }
+
+    if (m_nodes[grandParent]._child1 == parent)
+    {
+        m_nodes[grandParent]._child1 = sibling;
+    }
+    else
+    {
+        m_nodes[grandParent]._child2 = sibling;
+    }
+    m_nodes[sibling]._parent = grandParent;
+
+    //Refit the ancestors
+    u32 index = grandParent;
+    while (index != k_invalidProxy)
+    {
+        index = balance(index);
+
+        Node& node = m_nodes[index];
+        node._height = 1 + std::max(m_nodes[node._child1]._height, m_nodes[node._child2]._height);
+        node._aabb = combine(m_nodes[node._child1]._aabb, m_nodes[node._child2]._aabb);
+
+        index = node._parent;
+    }
+}
+
+u32 BoundingVolumeHierarchy::balance(u32 nodeID)
+{
+    Node& A = m_nodes[nodeID];
+    if (A.isLeaf() || A._height < 2)
+    {
+        return nodeID;
+    }
+
+    const u32 iB = A._child1;
+    const u32 iC = A._child2;
+    Node& B = m_nodes[iB];
+    Node& C = m_nodes[iC];
+
+    //Promotes the higher child, the lower grandchild moves under A
+    auto rotate = [this, nodeID, &A](u32 iUp, Node& up, Node& other, u32& childSlot) -> u32
+        {
+            const u32 iF = up._child1;
+            const u32 iG = up._child2;
+            Node& F = m_nodes[iF];
+            Node& G = m_nodes[iG];
+
+            up._child1 = nodeID;
+            up._parent = A._parent;
+            A._parent = iUp;
+
+            if (up._parent != k_invalidProxy)
+            {
+                Node& parent = m_nodes[up._parent];
+                if (parent._child1 == nodeID)
+                {
+                    parent._child1 = iUp;
+                }
+                else
+                {
+                    parent._child2 = iUp;
+                }
+            }
+            else
+            {
+                m_root = iUp;
+            }
+
+            const bool keepF = F._height > G._height;
+            const u32 iKeep = keepF ? iF : iG;
+            const u32 iMove = keepF ? iG : iF;
+
+            up._child2 = iKeep;
+            childSlot = iMove;
+            m_nodes[iMove]._parent = nodeID;
+
+            A._aabb = combine(other._aabb, m_nodes[iMove]._aabb);
+            up._aabb = combine(A._aabb, m_nodes[iKeep]._aabb);
+            A._height = 1 + std::max(other._height, m_nodes[iMove]._height);
+            up._height = 1 + std::max(A._height, m_nodes[iKeep]._height);
+
+            return iUp;
+        };
+
+    const s32 heightDelta = C._height - B._height;
+    if (heightDelta > 1)
+    {
+        return rotate(iC, C, B, A._child2);
+    }
+
+    if (heightDelta < -1)
+    {
+        return rotate(iB, B, C, A._child1);
+    }
+
+    return nodeID;
+}
+
+math::AABB BoundingVolumeHierarchy::combine(const math::AABB& a, const math::AABB& b)
+{
+    return math::AABB(
+        { std::min(a.getMin()._x, b.getMin()._x), std::min(a.getMin()._y, b.getMin()._y), std::min(a.getMin()._z, b.getMin()._z) },
+        { std::max(a.getMax()._x, b.getMax()._x), std::max(a.getMax()._y, b.getMax()._y), std::max(a.getMax()._z, b.getMax()._z) });
+}
+
+bool BoundingVolumeHierarchy::contains(const math::AABB& a, const math::AABB& b)
+{
+    return a.getMin()._x <= b.getMin()._x && a.getMin()._y <= b.getMin()._y && a.getMin()._z <= b.getMin()._z &&
+        b.getMax()._x <= a.getMax()._x && b.getMax()._y <= a.getMax()._y && b.getMax()._z <= a.getMax()._z;
+}
+
+f32 BoundingVolumeHierarchy::intersectRay(const math::AABB& aabb, const math::Vector3D& origin, const math::Vector3D& direction, f32 maxDistance)
+{
+    const f32 start[3] = { origin.getX(), origin.getY(), origin.getZ() };
+    const f32 dir[3] = { direction.getX(), direction.getY(), direction.getZ() };
+    const f32* min = &aabb.getMin()._x;
+    const f32* max = &aabb.getMax()._x;
+
+    f32 tMin = 0.f;
+    f32 tMax = maxDistance;
+    for (u32 axis = 0; axis < 3; ++axis)
+    {
+        //A ray parallel to the slab never enters or leaves it, the slab is [-inf, +inf] if the origin is inside, otherwise empty.
+        //It avoids 0 * inf = NaN when the origin lies on the slab plane
+        if (dir[axis] == 0.f)
+        {
+            if (start[axis] < min[axis] || start[axis] > max[axis])
+            {
+                return -1.f;
+            }
+            continue;
+        }
+
+        const f32 invDirection = 1.f / dir[axis];
+        f32 t0 = (min[axis] - start[axis]) * invDirection;
+        f32 t1 = (max[axis] - start[axis]) * invDirection;
+        if (t0 > t1)
+        {
+            std::swap(t0, t1);
+        }
+
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax)
+        {
+            return -1.f;
+        }
+    }
+
+    return tMin;
+}
+
+f32 BoundingVolumeHierarchy::area(const math::AABB& aabb)
+{
+    const math::TVector3D<f32> size = aabb.getMax() - aabb.getMin();
+    return 2.f * (size._x * size._y + size._y * size._z + size._z * size._x);
+}
+
+} //namespace scene
+} //namespace v3d
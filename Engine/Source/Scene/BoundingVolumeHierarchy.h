@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Common.h"
+
+namespace v3d
+{
+namespace scene
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief BoundingVolumeHierarchy class.
+    * Dynamic AABB tree over scene objects. Leaves keep a fattened box, so small moves don't touch the tree.
+    * A leaf which leaves its fat box is removed and reinserted, the tree is kept balanced by rotations.
+    * Queries are read only and can be called from several threads at once
+    */
+    class BoundingVolumeHierarchy final
+    {
+    public:
+
+        static constexpr u32 k_invalidProxy = ~0U;
+
+        BoundingVolumeHierarchy() noexcept;
+        ~BoundingVolumeHierarchy();
+
+        u32 createProxy(const math::AABB& aabb, u32 userData);
+        void destroyProxy(u32 proxyID);
+        bool moveProxy(u32 proxyID, const math::AABB& aabb);
+        void clear();
+
+        void setUserData(u32 proxyID, u32 userData);
+        u32 getUserData(u32 proxyID) const;
+        const math::AABB& getFatAABB(u32 proxyID) const;
+        u32 getProxyCount() const;
+        u32 getHeight() const;
+
+        /**
+        * @brief query. Calls callback(u32 userData) -> bool for every proxy inside the frustum. Return false to stop
+        */
+        template<typename Func>
+        void query(const math::Frustum& frustum, Func&& callback) const;
+
+        /**
+        * @brief query. Calls callback(u32 userData) -> bool for every proxy overlapping the sphere. Return false to stop
+        */
+        template<typename Func>
+        void query(const math::Vector3D& center, f32 radius, Func&& callback) const;
+
+        /**
+        * @brief raycast. Calls callback(u32 userData, f32 distance) -> bool for every proxy hit by the ray.
+        * The distance is measured in units of the direction length. Return false to stop
+        */
+        template<typename Func>
+        void raycast(const math::Vector3D& origin, const math::Vector3D& direction, f32 maxDistance, Func&& callback) const;
+
+        /**
+        * @brief intersectRay. Slab test of a box, the zero components of the direction are allowed
+        * @return f32 entry distance in units of the direction length, negative if the box is missed
+        */
+        static f32 intersectRay(const math::AABB& aabb, const math::Vector3D& origin, const math::Vector3D& direction, f32 maxDistance);
+
+    private:
+
+        static constexpr f32 k_aabbMargin = 0.1f;
+        static constexpr u32 k_maxQueryDepth = 256;
+
+        struct Node
+        {
+            math::AABB _aabb;
+            u32        _parent; //Next free node if the node is unused
+            u32        _child1;
+            u32        _child2;
+            s32        _height; //-1 if the node is unused
+            u32        _userData;
+
+            bool isLeaf() const
+            {
+                return _child1 == k_invalidProxy;
+            }
+        };
+
+        template<typename Overlap, typename Func>
+        void traverse(Overlap&& overlap, Func&& callback) const;
+
+        u32 allocateNode();
+        void freeNode(u32 nodeID);
+
+        void insertLeaf(u32 leaf);
+        void removeLeaf(u32 leaf);
+        u32 balance(u32 nodeID);
+
+        static math::AABB combine(const math::AABB& a, const math::AABB& b);
+        static bool contains(const math::AABB& a, const math::AABB& b);
+        static f32 area(const math::AABB& aabb);
+
+        std::vector<Node> m_nodes;
+        u32               m_root;
+        u32               m_freeList;
+        u32               m_proxyCount;
+    };
+
+    inline void BoundingVolumeHierarchy::setUserData(u32 proxyID, u32 userData)
+    {
+        ASSERT(proxyID < m_nodes.size() && m_nodes[proxyID].isLeaf(), "invalid proxy");
+        m_nodes[proxyID]._userData = userData;
+    }
+
+    inline u32 BoundingVolumeHierarchy::getUserData(u32 proxyID) const
+    {
+        ASSERT(proxyID < m_nodes.size() && m_nodes[proxyID].isLeaf(), "invalid proxy");
+        return m_nodes[proxyID]._userData;
+    }
+
+    inline const math::AABB& BoundingVolumeHierarchy::getFatAABB(u32 proxyID) const
+    {
+        ASSERT(proxyID < m_nodes.size() && m_nodes[proxyID].isLeaf(), "invalid proxy");
+        return m_nodes[proxyID]._aabb;
+    }
+
+    inline u32 BoundingVolumeHierarchy::getProxyCount() const
+    {
+        return m_proxyCount;
+    }
+
+    inline u32 BoundingVolumeHierarchy::getHeight() const
+    {
+        return (m_root == k_invalidProxy) ? 0 : static_cast<u32>(m_nodes[m_root]._height);
+    }
+
+    template<typename Overlap, typename Func>
+    inline void BoundingVolumeHierarchy::traverse(Overlap&& overlap, Func&& callback) const
+    {
+        if (m_root == k_invalidProxy)
+        {
+            return;
+        }
+
+        u32 stack[k_maxQueryDepth];
+        u32 stackSize = 0;
+        stack[stackSize++] = m_root;
+
+        while (stackSize > 0)
+        {
+            const Node& node = m_nodes[stack[--stackSize]];
+            if (!overlap(node._aabb))
+            {
+                continue;
+            }
+
+            if (node.isLeaf())
+            {
+                if (!callback(node._userData, node._aabb))
+                {
+                    return;
+                }
+            }
+            else
+            {
+                ASSERT(stackSize + 2 <= k_maxQueryDepth, "stack overflow");
+                stack[stackSize++] = node._child1;
+                stack[stackSize++] = node._child2;
+            }
+        }
+    }
+
+    template<typename Func>
+    inline void BoundingVolumeHierarchy::query(const math::Frustum& frustum, Func&& callback) const
+    {
+        traverse([&frustum](const math::AABB& aabb) -> bool
+            {
+                return frustum.isInside(aabb);
+            },
+            [&callback](u32 userData, const math::AABB& aabb) -> bool
+            {
+                return callback(userData);
+            });
+    }
+
+    template<typename Func>
+    inline void BoundingVolumeHierarchy::query(const math::Vector3D& center, f32 radius, Func&& callback) const
+    {
+        const f32 point[3] = { center.getX(), center.getY(), center.getZ() };
+        const f32 radiusSq = radius * radius;
+
+        traverse([&point, radiusSq](const math::AABB& aabb) -> bool
+            {
+                const f32* min = &aabb.getMin()._x;
+                const f32* max = &aabb.getMax()._x;
+
+                f32 distanceSq = 0.f;
+                for (u32 axis = 0; axis < 3; ++axis)
+                {
+                    const f32 delta = std::max(min[axis] - point[axis], 0.f) + std::max(point[axis] - max[axis], 0.f);
+                    distanceSq += delta * delta;
+                }
+
+                return distanceSq <= radiusSq;
+            },
+            [&callback](u32 userData, const math::AABB& aabb) -> bool
+            {
+                return callback(userData);
+            });
+    }
+
+    template<typename Func>
+    inline void BoundingVolumeHierarchy::raycast(const math::Vector3D& origin, const math::Vector3D& direction, f32 maxDistance, Func&& callback) const
+    {
+        traverse([&origin, &direction, maxDistance](const math::AABB& aabb) -> bool
+            {
+                return intersectRay(aabb, origin, direction, maxDistance) >= 0.f;
+            },
+            [&origin, &direction, maxDistance, &callback](u32 userData, const math::AABB& aabb) -> bool
+            {
+                return callback(userData, intersectRay(aabb, origin, direction, maxDistance));
+            });
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace scene
+} //namespace v3d
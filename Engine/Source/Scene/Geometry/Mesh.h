@@ -59,6 +59,7 @@ namespace scene
         renderer::PrimitiveTopology getTopology() const;
 
         const std::string_view getName() const;
+        const math::AABB& getBoundingBox() const;
 
         void setCastShadow(bool value);
         bool isCastShadow() const;
@@ -111,6 +112,11 @@ namespace scene
         return m_header.getName();
     }
 
+    inline const math::AABB& Mesh::getBoundingBox() const
+    {
+        return m_boundingBox;
+    }
+
     inline bool Mesh::isCastShadow() const
     {
         return m_castShadow;
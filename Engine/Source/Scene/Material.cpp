@@ -13,6 +13,7 @@ namespace scene
 Material::Material(renderer::Device* device, MaterialShadingModel shadingModel) noexcept
     : m_header()
     , m_device(device)
+    , m_version(0)
     , m_shadingModel(shadingModel)
 {
 }
@@ -20,10 +21,56 @@ Material::Material(renderer::Device* device, MaterialShadingModel shadingModel)
 Material::Material(renderer::Device* device, const MaterialHeader& header) noexcept
     : m_header(header)
     , m_device(device)
+    , m_version(0)
     , m_shadingModel(MaterialShadingModel::Custom)
 {
 }
 
+void Material::compileProperty(const std::string& id, const Property& property)
+{
+    static const std::unordered_map<std::string, MaterialParameters::Texture> k_textureParameters =
+    {
+        { "BaseColor", MaterialParameters::BaseColor },
+        { "Normals", MaterialParameters::Normals },
+        { "Roughness", MaterialParameters::Roughness },
+        { "Metalness", MaterialParameters::Metalness },
+        { "Displacement", MaterialParameters::Displacement },
+        { "Diffuse", MaterialParameters::Diffuse },
+        { "Specular", MaterialParameters::Specular },
+    };
+
+    static const std::unordered_map<std::string, MaterialParameters::Color> k_colorParameters =
+    {
+        { "Color", MaterialParameters::Tint },
+        { "DiffuseColor", MaterialParameters::DiffuseColor },
+        { "ColorDiffuse", MaterialParameters::ColorDiffuse },
+    };
+
+    //Same defaults as getProperty returns for a missing or mismatched property
+    if (auto texture = k_textureParameters.find(id); texture != k_textureParameters.cend())
+    {
+        const ObjectHandle* handle = std::get_if<ObjectHandle>(&property);
+        m_parameters._textures[texture->second] = handle ? *handle : ObjectHandle{};
+    }
+    else if (auto color = k_colorParameters.find(id); color != k_colorParameters.cend())
+    {
+        const math::float4* value = std::get_if<math::float4>(&property);
+        m_parameters._colors[color->second] = value ? *value : math::float4{};
+    }
+    else if (id == "materialID")
+    {
+        const u32* value = std::get_if<u32>(&property);
+        m_parameters._materialID = value ? *value : 0;
+    }
+    else if (id == "pipelineID")
+    {
+        const u32* value = std::get_if<u32>(&property);
+        m_parameters._pipelineID = value ? *value : 0;
+    }
+
+    ++m_version;
+}
+
 bool Material::load(const stream::Stream* stream, u32 offset)
 {
     if (m_loaded)
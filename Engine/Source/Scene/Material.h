@@ -26,6 +26,42 @@ namespace scene
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    /**
+    * @brief MaterialParameters struct.
+    * Properties read by the render passes, resolved once when a property is set, so the draw recording doesn't touch the property map
+    */
+    struct MaterialParameters
+    {
+        enum Texture : u32
+        {
+            BaseColor,
+            Normals,
+            Roughness,
+            Metalness,
+            Displacement,
+            Diffuse,
+            Specular,
+
+            TextureCount
+        };
+
+        enum Color : u32
+        {
+            Tint,           //"Color"
+            DiffuseColor,
+            ColorDiffuse,
+
+            ColorCount
+        };
+
+        ObjectHandle _textures[TextureCount];
+        math::float4 _colors[ColorCount];
+        u32          _materialID = 0;
+        u32          _pipelineID = 0;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
     /**
     * @brief Material class
     */
@@ -60,6 +96,9 @@ namespace scene
 
         bool hasProperty(const std::string& id) const;
 
+        const MaterialParameters& getParameters() const;
+        u64 getVersion() const;
+
         Iterator begin();
         Iterator end();
 
@@ -69,9 +108,14 @@ namespace scene
 
         bool load(const stream::Stream* stream, u32 offset = 0) override;
         bool save(stream::Stream* stream, u32 offset = 0) const override;
+
+        void compileProperty(const std::string& id, const Property& property);
+
         MaterialHeader                                      m_header;
         renderer::Device* const                             m_device;
         std::unordered_map<std::string, Property>           m_properties;
+        MaterialParameters                                  m_parameters;
+        u64                                                 m_version; //Increased on every property change
         MaterialShadingModel                                m_shadingModel;
 
         template<class T>
@@ -86,7 +130,9 @@ namespace scene
     template<typename T>
     inline void Material::setProperty(const std::string& id, const T& property)
     {
-        m_properties[id] = Property{ property };
+        Property& value = m_properties[id];
+        value = Property{ property };
+        compileProperty(id, value);
     }
 
     template<typename T>
@@ -119,6 +165,16 @@ namespace scene
         return false;
     }
 
+    inline const MaterialParameters& Material::getParameters() const
+    {
+        return m_parameters;
+    }
+
+    inline u64 Material::getVersion() const
+    {
+        return m_version;
+    }
+
     inline Material::Iterator Material::begin()
     {
         return m_properties.begin();
@@ -0,0 +1,46 @@
+#include "NodeEntryPool.h"
+
+namespace v3d
+{
+namespace scene
+{
+
+NodeEntryPool::NodeEntryPool(u32 entriesPerBlock) noexcept
+    : m_entriesPerBlock(std::max<u32>(entriesPerBlock, 1))
+{
+}
+
+NodeEntryPool::~NodeEntryPool()
+{
+    ASSERT(m_freeEntries.size() == getAllocatedCount(), "some entries are not released");
+    for (void* block : m_blocks)
+    {
+        V3D_FREE(block, memory::MemoryLabel::MemoryObject);
+    }
+    m_blocks.clear();
+    m_freeEntries.clear();
+}
+
+void NodeEntryPool::releaseEntry(NodeEntry* entry)
+{
+    ASSERT(entry, "must be valid");
+    void* memory = dynamic_cast<void*>(entry);
+    entry->~NodeEntry();
+
+    m_freeEntries.push_back(memory);
+}
+
+void NodeEntryPool::grow()
+{
+    u8* block = reinterpret_cast<u8*>(V3D_MALLOC(static_cast<u64>(k_entryStride) * m_entriesPerBlock, memory::MemoryLabel::MemoryObject));
+    m_blocks.push_back(block);
+
+    m_freeEntries.reserve(m_freeEntries.size() + m_entriesPerBlock);
+    for (u32 index = m_entriesPerBlock; index > 0; --index)
+    {
+        m_freeEntries.push_back(block + static_cast<u64>(index - 1) * k_entryStride);
+    }
+}
+
+} //namespace scene
+} //namespace v3d
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Common.h"
+#include "SceneNode.h"
+
+namespace v3d
+{
+namespace scene
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief NodeEntryPool class. Recycles render entries of the scene.
+    * Every slot fits any NodeEntry type, memory is allocated in blocks and never returned until the pool is destroyed
+    */
+    class NodeEntryPool final
+    {
+    public:
+
+        explicit NodeEntryPool(u32 entriesPerBlock = 1024) noexcept;
+        ~NodeEntryPool();
+
+        NodeEntryPool(const NodeEntryPool&) = delete;
+        NodeEntryPool& operator=(const NodeEntryPool&) = delete;
+
+        template<class TEntry>
+        [[nodiscard]] TEntry* acquireEntry();
+        void releaseEntry(NodeEntry* entry);
+
+        u32 getAllocatedCount() const;
+
+    private:
+
+        static constexpr u32 k_entrySize = static_cast<u32>(std::max({ sizeof(DrawNodeEntry), sizeof(LightNodeEntry), sizeof(SkyboxNodeEntry) }));
+        static constexpr u32 k_entryAlignment = static_cast<u32>(std::max({ alignof(DrawNodeEntry), alignof(LightNodeEntry), alignof(SkyboxNodeEntry) }));
+        static constexpr u32 k_entryStride = (k_entrySize + k_entryAlignment - 1) & ~(k_entryAlignment - 1);
+
+        void grow();
+
+        std::vector<void*> m_blocks;
+        std::vector<void*> m_freeEntries;
+        const u32          m_entriesPerBlock;
+    };
+
+    template<class TEntry>
+    inline TEntry* NodeEntryPool::acquireEntry()
+    {
+        static_assert(std::is_base_of_v<NodeEntry, TEntry>, "must be NodeEntry");
+        static_assert(sizeof(TEntry) <= k_entrySize && alignof(TEntry) <= k_entryAlignment, "entry doesn't fit the slot");
+
+        if (m_freeEntries.empty())
+        {
+            grow();
+        }
+
+        void* memory = m_freeEntries.back();
+        m_freeEntries.pop_back();
+
+        return V3D_PLACMENT_NEW(memory, TEntry());
+    }
+
+    inline u32 NodeEntryPool::getAllocatedCount() const
+    {
+        return static_cast<u32>(m_blocks.size()) * m_entriesPerBlock;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace scene
+} //namespace v3d
@@ -0,0 +1,181 @@
+#include "RenderListSorter.h"
+#include "Scene.h"
+#include "SceneNode.h"
+#include "Task/TaskScheduler.h"
+
+namespace v3d
+{
+namespace scene
+{
+
+constexpr u32 k_sortTaskGrain = 4096;
+
+constexpr u32 k_passBits = 5;
+constexpr u32 k_pipelineBits = 11;
+constexpr u32 k_materialBits = 16;
+constexpr u32 k_meshBits = 16;
+constexpr u32 k_depthBits = 16;
+
+static_assert(k_passBits + k_pipelineBits + k_materialBits + k_meshBits + k_depthBits == 64, "must fill the key");
+static_assert(toEnumType(ScenePass::Count) <= (1 << k_passBits), "pass bits are not enough");
+
+static u64 foldPointer(const void* pointer, u32 bits)
+{
+    //fmix64 of MurmurHash3, the neighboring allocations get the distant values
+    u64 value = reinterpret_cast<u64>(pointer);
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+
+    return pointer ? (value >> (64 - bits)) : 0;
+}
+
+u64 RenderListSorter::makeKey(u32 pass, u32 pipelineID, const void* material, const void* mesh, f32 depth, DepthOrder order)
+{
+    ASSERT(pass < (1 << k_passBits), "out of range");
+    ASSERT(pipelineID < (1 << k_pipelineBits), "out of range");
+    const u64 passKey = static_cast<u64>(pass);
+    const u64 pipelineKey = static_cast<u64>(pipelineID) & ((1 << k_pipelineBits) - 1);
+    const u64 materialKey = foldPointer(material, k_materialBits);
+    const u64 meshKey = foldPointer(mesh, k_meshBits);
+    const u64 depthKey = static_cast<u64>(std::clamp(depth, 0.f, 1.f) * static_cast<f32>((1 << k_depthBits) - 1));
+
+    if (order == DepthOrder::BackToFront)
+    {
+        const u64 invertedDepthKey = ((1 << k_depthBits) - 1) - depthKey;
+        return (passKey << (64 - k_passBits))
+            | (invertedDepthKey << (k_pipelineBits + k_materialBits + k_meshBits))
+            | (pipelineKey << (k_materialBits + k_meshBits))
+            | (materialKey << k_meshBits)
+            | meshKey;
+    }
+
+    return (passKey << (64 - k_passBits))
+        | (pipelineKey << (k_materialBits + k_meshBits + k_depthBits))
+        | (materialKey << (k_meshBits + k_depthBits))
+        | (meshKey << k_depthBits)
+        | depthKey;
+}
+
+RenderListSorter::RenderListSorter() noexcept
+{
+}
+
+RenderListSorter::~RenderListSorter()
+{
+}
+
+void RenderListSorter::sort(task::TaskScheduler& scheduler, u32 pass, std::vector<NodeEntry*>& list, const math::Vector3D& viewPosition, f32 farDistance, DepthOrder order)
+{
+    const u32 count = static_cast<u32>(list.size());
+    if (count < 2)
+    {
+        return;
+    }
+
+    m_items.resize(count);
+    const f32 invFarDistance = (farDistance > 0.f) ? 1.f / farDistance : 0.f;
+    const math::TVector3D<f32> viewPoint(viewPosition.getX(), viewPosition.getY(), viewPosition.getZ());
+    scheduler.parallelFor(0, count, k_sortTaskGrain, [this, &list, pass, &viewPoint, invFarDistance, order](u32 begin, u32 end) -> void
+        {
+            for (u32 index = begin; index < end; ++index)
+            {
+                const DrawNodeEntry* entry = static_cast<const DrawNodeEntry*>(list[index]);
+                const f32 depth = entry->worldBounds.isValid() ? entry->worldBounds.getCenter().distanceFrom(viewPoint) * invFarDistance : 0.f;
+
+                m_items[index]._key = RenderListSorter::makeKey(pass, entry->pipelineID, entry->material, entry->geometry, depth, order);
+                m_items[index]._entry = list[index];
+            }
+        });
+
+    //The digits which are equal in all keys don't change the order, e.g. the pass bits
+    const u64 firstKey = m_items[0]._key;
+    const u64 differentBits = scheduler.parallelReduce<u64>(0, count, k_sortTaskGrain, 0,
+        [this, firstKey](u32 begin, u32 end, u64 bits) -> u64
+        {
+            for (u32 index = begin; index < end; ++index)
+            {
+                bits |= m_items[index]._key ^ firstKey;
+            }
+            return bits;
+        },
+        [](u64 left, u64 right) -> u64
+        {
+            return left | right;
+        });
+
+    if (differentBits == 0)
+    {
+        return;
+    }
+
+    RenderListSorter::radixSort(scheduler, differentBits);
+
+    for (u32 index = 0; index < count; ++index)
+    {
+        list[index] = m_items[index]._entry;
+    }
+}
+
+void RenderListSorter::radixSort(task::TaskScheduler& scheduler, u64 differentBits)
+{
+    const u32 count = static_cast<u32>(m_items.size());
+    const u32 chunkCount = (count + k_sortTaskGrain - 1) / k_sortTaskGrain;
+    m_buffer.resize(count);
+    m_histograms.resize(chunkCount);
+
+    Item* source = m_items.data();
+    Item* destination = m_buffer.data();
+    for (u32 shift = 0; shift < 64; shift += k_radixBits)
+    {
+        if (((differentBits >> shift) & (k_radixSize - 1)) == 0)
+        {
+            continue;
+        }
+
+        //The chunks have the fixed grain, so the chunk index is known from the range
+        scheduler.parallelFor(0, count, k_sortTaskGrain, [this, source, shift](u32 begin, u32 end) -> void
+            {
+                std::array<u32, k_radixSize>& histogram = m_histograms[begin / k_sortTaskGrain];
+                histogram.fill(0);
+                for (u32 index = begin; index < end; ++index)
+                {
+                    ++histogram[(source[index]._key >> shift) & (k_radixSize - 1)];
+                }
+            });
+
+        //Digit major prefix sum, the chunks of the same digit are written in the list order, that keeps the sort stable
+        u32 offset = 0;
+        for (u32 digit = 0; digit < k_radixSize; ++digit)
+        {
+            for (u32 chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                const u32 digitCount = m_histograms[chunk][digit];
+                m_histograms[chunk][digit] = offset;
+                offset += digitCount;
+            }
+        }
+        ASSERT(offset == count, "must be same");
+
+        scheduler.parallelFor(0, count, k_sortTaskGrain, [this, source, destination, shift](u32 begin, u32 end) -> void
+            {
+                std::array<u32, k_radixSize>& offsets = m_histograms[begin / k_sortTaskGrain];
+                for (u32 index = begin; index < end; ++index)
+                {
+                    destination[offsets[(source[index]._key >> shift) & (k_radixSize - 1)]++] = source[index];
+                }
+            });
+
+        std::swap(source, destination);
+    }
+
+    if (source != m_items.data())
+    {
+        std::swap(m_items, m_buffer);
+    }
+}
+
+} //namespace scene
+} //namespace v3d
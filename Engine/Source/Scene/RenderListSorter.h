@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Common.h"
+
+namespace v3d
+{
+namespace task
+{
+    class TaskScheduler;
+} //namespace task
+
+namespace scene
+{
+    struct NodeEntry;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief RenderListSorter class.
+    * Orders the draw entries of a pass list by 64 bit keys, the draws with the same pipeline, material and mesh become adjacent,
+    * so the command lists skip the repeated binds. Keys are sorted by the LSD radix sort, every digit pass is split between the task threads.
+    *
+    * FrontToBack: | pass 5 | pipeline 11 | material 16 | mesh 16 | depth 16 |
+    * BackToFront: | pass 5 | inverted depth 16 | pipeline 11 | material 16 | mesh 16 |
+    */
+    class RenderListSorter final
+    {
+    public:
+
+        enum class DepthOrder : u32
+        {
+            FrontToBack, //Opaque, the early depth test rejects the hidden pixels
+            BackToFront  //Transparency, the blending order is kept
+        };
+
+        /**
+        * @brief makeKey. Material and mesh are folded to 16 bits, the collisions only break the grouping.
+        * @param f32 depth [in] normalized to [0, 1]
+        */
+        static u64 makeKey(u32 pass, u32 pipelineID, const void* material, const void* mesh, f32 depth, DepthOrder order);
+
+        RenderListSorter() noexcept;
+        ~RenderListSorter();
+
+        RenderListSorter(const RenderListSorter&) = delete;
+        RenderListSorter& operator=(const RenderListSorter&) = delete;
+
+        /**
+        * @brief sort. The list must contain only DrawNodeEntry. Stable, the entries with the equal keys keep the list order
+        * @param const math::Vector3D& viewPosition [in] the depth is a distance from it, divided by farDistance
+        */
+        void sort(task::TaskScheduler& scheduler, u32 pass, std::vector<NodeEntry*>& list, const math::Vector3D& viewPosition, f32 farDistance, DepthOrder order);
+
+    private:
+
+        static constexpr u32 k_radixBits = 8;
+        static constexpr u32 k_radixSize = 1 << k_radixBits;
+
+        struct Item
+        {
+            u64        _key;
+            NodeEntry* _entry;
+        };
+
+        void radixSort(task::TaskScheduler& scheduler, u64 differentBits);
+
+        std::vector<Item>                          m_items;
+        std::vector<Item>                          m_buffer;
+        std::vector<std::array<u32, k_radixSize>>  m_histograms; //Per chunk, turned to the scatter offsets
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace scene
+} //namespace v3d
@@ -7,6 +7,8 @@
 #include "Material.h"
 #include "Billboard.h"
 #include "Skybox.h"
+#include "FrameProfiler.h"
+#include "Utils/Logger.h"
 
 namespace v3d
 {
@@ -14,17 +16,60 @@ namespace scene
 {
 
 constexpr u32 k_workerThreadCount = 4;
+constexpr u32 k_visibilityTaskGrain = 256; //Multiple of math::k_frustumBatchSize
+constexpr u32 k_punctualShadowmapMask = static_cast<u32>(((1ULL << (toEnumType(ScenePass::LastPunctualShadowmap) + 1)) - 1) & ~((1ULL << toEnumType(ScenePass::FirstPunctualShadowmap)) - 1));
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+//Passes and the pipeline which an entry takes from its material, compiled again when the material version is changed
+static void compileMaterialState(NodeEntry* entry)
+{
+    const Material* material = static_cast<const Material*>(entry->material);
+    entry->materialVersion = material->getVersion();
+
+    if (entry->passMask & (1 << toEnumType(ScenePass::Skybox)))
+    {
+        entry->pipelineID = material->getParameters()._pipelineID;
+        return;
+    }
+
+    //Billboards have the fixed pass
+    if (!static_cast<const DrawNodeEntry*>(entry)->geometry)
+    {
+        return;
+    }
+
+    entry->passMask &= 1 << toEnumType(ScenePass::Shadowmap);
+    if (material->getShadingModel() == MaterialShadingModel::Custom)
+    {
+        entry->passMask |= 1 << toEnumType((ScenePass)material->getParameters()._materialID);
+        entry->pipelineID = material->getParameters()._pipelineID;
+    }
+    else if (material->getShadingModel() == MaterialShadingModel::PBR_MetallicRoughness)
+    {
+        bool isOpaque = true;
+        entry->passMask |= isOpaque ? (1 << toEnumType(ScenePass::Opaque)) : (1 << toEnumType(ScenePass::Transparency));
+        entry->pipelineID = 0;
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 SceneData::SceneData() noexcept
-    : m_taskWorker(k_workerThreadCount, task::TaskDispatcher::WorkerThreadPerCore/* | task::TaskDispatcher::AllowToMainThreadStealTasks*/)
+    : m_camera(nullptr)
+    , m_editorMode(false)
+    , m_taskWorker(k_workerThreadCount, task::TaskDispatcher::WorkStealingScheduler/* | task::TaskDispatcher::AllowToMainThreadStealTasks*/)
     , m_stateIndex(0)
 {
 }
 
 SceneData::~SceneData()
 {
+    for (NodeEntry* entry : m_generalRenderList)
+    {
+        m_entryPool.releaseEntry(entry);
+    }
+    m_generalRenderList.clear();
 }
 
 
@@ -51,107 +96,208 @@ const std::vector<SceneNode*>& SceneData::getNodeList() const
 
 void SceneData::finalize()
 {
-    static std::function<void(scene::SceneNode* node)> processNode = [&](scene::SceneNode* node)
-        {
-            if (!node->isVisible())
-            {
-                return;
-            }
+    for (NodeEntry* entry : m_generalRenderList)
+    {
+        m_entryPool.releaseEntry(entry);
+    }
+    m_generalRenderList.clear();
+    m_nodeEntries.clear();
+    m_boundingVolumeHierarchy.clear();
 
-            if (scene::Mesh* geometry = node->getComponentByType<scene::Mesh>(); geometry)
-            {
-                scene::Material* material = node->getComponentByType<scene::Material>();
-
-                scene::DrawNodeEntry* entry = new scene::DrawNodeEntry;
-                entry->object = node;
-                entry->geometry = geometry;
-                entry->material = material;
-                entry->passMask = 0;
-                if (material)
-                {
-                    if (material->getShadingModel() == scene::MaterialShadingModel::Custom)
-                    {
-                        entry->passMask |= 1 << toEnumType((scene::ScenePass)material->getProperty<u32>("materialID"));
-                        entry->pipelineID = material->getProperty<u32>("pipelineID");
-                    }
-                    else if (material->getShadingModel() == scene::MaterialShadingModel::PBR_MetallicRoughness)
-                    {
-                        bool isOpaque = true;
-                        entry->passMask |= isOpaque ? (1 << toEnumType(scene::ScenePass::Opaque)) : (1 << toEnumType(scene::ScenePass::Transparency));
-                        entry->pipelineID = material->getShadingModel() == scene::MaterialShadingModel::PBR_MetallicRoughness ? 0 : 1;
-                    }
-                }
+    for (auto& node : m_nodes)
+    {
+        syncEntries(node, true);
+    }
+}
 
-                if (geometry->isCastShadow())
-                {
-                    entry->passMask |= 1 << toEnumType(scene::ScenePass::Shadowmap);
-                }
+void SceneData::syncEntries(SceneNode* node, bool visible)
+{
+    visible = visible && node->isVisible();
 
-                m_generalRenderList.push_back(entry);
-            }
+    NodeEntry* oldEntry = nullptr;
+    if (auto found = m_nodeEntries.find(node); found != m_nodeEntries.end())
+    {
+        oldEntry = found->second;
+        m_nodeEntries.erase(found);
+    }
 
-            if (scene::Billboard* unlit = node->getComponentByType<scene::Billboard>(); unlit)
-            {
-                scene::DrawNodeEntry* entry = new scene::DrawNodeEntry;
-                entry->object = node;
-                entry->material = node->getComponentByType<scene::Material>();
-                entry->geometry = nullptr;
-                entry->passMask = 1 << toEnumType(scene::ScenePass::Indicator);
-                entry->pipelineID = 0;
-
-                m_generalRenderList.push_back(entry);
-            }
+    NodeEntry* newEntry = visible ? createEntries(node) : nullptr;
+    if (newEntry)
+    {
+        m_nodeEntries.emplace(node, newEntry);
+    }
 
-            if (scene::DirectionalLight* light = node->getComponentByType<scene::DirectionalLight>(); light)
-            {
-                scene::LightNodeEntry* entry = new scene::LightNodeEntry;
-                entry->object = node;
-                entry->light = light;
-                entry->passMask = 1 << toEnumType(scene::ScenePass::DirectionLight);
-                entry->pipelineID = 0;
+    //New entries take the slots of the old ones, so the indices of an updated node stay stable
+    while (oldEntry && newEntry)
+    {
+        NodeEntry* nextEntry = oldEntry->nextEntry;
+        replaceEntry(oldEntry, newEntry);
 
-                m_generalRenderList.push_back(entry);
-            }
-            else if (scene::Light* light = node->getComponentByType<scene::Light>(); light)
-            {
-                scene::LightNodeEntry* entry = new scene::LightNodeEntry;
-                entry->object = node;
-                entry->light = light;
-                entry->passMask = 1 << toEnumType(scene::ScenePass::PunctualLights);
+        oldEntry = nextEntry;
+        newEntry = newEntry->nextEntry;
+    }
 
-                m_generalRenderList.push_back(entry);
-            }
-            else if (scene::Skybox* skybox = node->getComponentByType<scene::Skybox>(); skybox)
-            {
-                scene::Material* material = node->getComponentByType<scene::Material>();
+    while (oldEntry)
+    {
+        NodeEntry* nextEntry = oldEntry->nextEntry;
+        removeEntry(oldEntry);
+        oldEntry = nextEntry;
+    }
 
-                scene::SkyboxNodeEntry* entry = new scene::SkyboxNodeEntry;
-                entry->object = node;
-                entry->material = material;
-                entry->skybox = skybox;
-                entry->passMask = 1 << toEnumType(scene::ScenePass::Skybox);
-                entry->pipelineID = material->getProperty<u32>("pipelineID");
+    for (; newEntry; newEntry = newEntry->nextEntry)
+    {
+        insertEntry(newEntry);
+    }
 
-                m_generalRenderList.push_back(entry);
-            }
+    for (auto& child : node->m_children)
+    {
+        syncEntries(child, visible);
+    }
+}
 
-            for (auto& child : node->m_children)
-            {
-                processNode(child);
-            }
+NodeEntry* SceneData::createEntries(SceneNode* node)
+{
+    //Single pass over the components, the first component of each type is used
+    scene::Mesh* geometry = nullptr;
+    scene::Material* material = nullptr;
+    scene::Billboard* billboard = nullptr;
+    scene::Light* light = nullptr;
+    scene::Skybox* skybox = nullptr;
+    for (auto& [component, owner] : node->m_components)
+    {
+        if (!geometry && component->isBaseOfType<scene::Mesh>())
+        {
+            geometry = static_cast<scene::Mesh*>(component);
+        }
+        else if (!material && component->isBaseOfType<scene::Material>())
+        {
+            material = static_cast<scene::Material*>(component);
+        }
+        else if (!billboard && component->isBaseOfType<scene::Billboard>())
+        {
+            billboard = static_cast<scene::Billboard*>(component);
+        }
+        else if (!light && component->isBaseOfType<scene::Light>())
+        {
+            light = static_cast<scene::Light*>(component);
+        }
+        else if (!skybox && component->isBaseOfType<scene::Skybox>())
+        {
+            skybox = static_cast<scene::Skybox*>(component);
+        }
+    }
+
+    NodeEntry* firstEntry = nullptr;
+    NodeEntry** lastEntry = &firstEntry;
+    auto appendEntry = [&lastEntry](NodeEntry* entry) -> void
+        {
+            *lastEntry = entry;
+            lastEntry = &entry->nextEntry;
         };
 
-    //todo use custom alloc for objects
-    for (auto& entry : m_generalRenderList)
+    if (geometry)
+    {
+        scene::DrawNodeEntry* entry = m_entryPool.acquireEntry<scene::DrawNodeEntry>();
+        entry->object = node;
+        entry->geometry = geometry;
+        entry->material = material;
+        entry->localBounds = geometry->getBoundingBox();
+        entry->passMask = geometry->isCastShadow() ? 1 << toEnumType(scene::ScenePass::Shadowmap) : 0;
+        if (material)
+        {
+            compileMaterialState(entry);
+        }
+
+        appendEntry(entry);
+    }
+
+    if (billboard)
     {
-        delete entry;
+        scene::DrawNodeEntry* entry = m_entryPool.acquireEntry<scene::DrawNodeEntry>();
+        entry->object = node;
+        entry->material = material;
+        entry->geometry = nullptr;
+        entry->passMask = 1 << toEnumType(scene::ScenePass::Indicator);
+        entry->pipelineID = 0;
+        entry->materialVersion = material ? material->getVersion() : 0;
+
+        appendEntry(entry);
     }
-    m_generalRenderList.clear(); 
 
-    for (auto& node : m_nodes)
+    if (light && light->isBaseOfType(typeOf<scene::DirectionalLight>()))
     {
-        processNode(node);
+        scene::LightNodeEntry* entry = m_entryPool.acquireEntry<scene::LightNodeEntry>();
+        entry->object = node;
+        entry->light = light;
+        entry->passMask = 1 << toEnumType(scene::ScenePass::DirectionLight);
+        entry->pipelineID = 0;
+
+        appendEntry(entry);
     }
+    else if (light)
+    {
+        scene::LightNodeEntry* entry = m_entryPool.acquireEntry<scene::LightNodeEntry>();
+        entry->object = node;
+        entry->light = light;
+        entry->passMask = 1 << toEnumType(scene::ScenePass::PunctualLights);
+
+        appendEntry(entry);
+    }
+    else if (skybox)
+    {
+        scene::SkyboxNodeEntry* entry = m_entryPool.acquireEntry<scene::SkyboxNodeEntry>();
+        entry->object = node;
+        entry->material = material;
+        entry->skybox = skybox;
+        entry->passMask = 1 << toEnumType(scene::ScenePass::Skybox);
+        compileMaterialState(entry);
+
+        appendEntry(entry);
+    }
+
+    return firstEntry;
+}
+
+void SceneData::insertEntry(NodeEntry* entry)
+{
+    entry->listIndex = static_cast<u32>(m_generalRenderList.size());
+    m_generalRenderList.push_back(entry);
+}
+
+void SceneData::replaceEntry(NodeEntry* entry, NodeEntry* newEntry)
+{
+    if (entry->proxyID != BoundingVolumeHierarchy::k_invalidProxy)
+    {
+        m_boundingVolumeHierarchy.destroyProxy(entry->proxyID);
+    }
+
+    newEntry->listIndex = entry->listIndex;
+    m_generalRenderList[entry->listIndex] = newEntry;
+
+    m_entryPool.releaseEntry(entry);
+}
+
+void SceneData::removeEntry(NodeEntry* entry)
+{
+    if (entry->proxyID != BoundingVolumeHierarchy::k_invalidProxy)
+    {
+        m_boundingVolumeHierarchy.destroyProxy(entry->proxyID);
+    }
+
+    //Swap with the last one, the hierarchy refers to the list by index
+    NodeEntry* lastEntry = m_generalRenderList.back();
+    if (lastEntry != entry)
+    {
+        lastEntry->listIndex = entry->listIndex;
+        m_generalRenderList[entry->listIndex] = lastEntry;
+        if (lastEntry->proxyID != BoundingVolumeHierarchy::k_invalidProxy)
+        {
+            m_boundingVolumeHierarchy.setUserData(lastEntry->proxyID, lastEntry->listIndex);
+        }
+    }
+    m_generalRenderList.pop_back();
+
+    m_entryPool.releaseEntry(entry);
 }
 
 
@@ -204,98 +350,416 @@ void SceneHandler::destroy()
 
 void SceneHandler::updateScene(f32 dt)
 {
+    TRACE_PROFILER_ZONE("SceneHandler::updateScene");
+
     if (m_nodeGraphChanged)
     {
+        //Insertion skips the inserted nodes, only the missing ones are added
+        for (SceneNode* node : m_sceneData.m_nodes)
+        {
+            m_sceneData.m_transformHierarchy.insert(node);
+        }
+
         m_sceneData.finalize();
         m_nodeGraphChanged = false;
     }
+    else
+    {
+        for (auto& [node, event] : m_nodeEvents)
+        {
+            //Entries exist only under visible parents
+            bool visible = event != NodeEvent::Remove;
+            for (SceneNode* parent = node->m_parent; parent && visible; parent = parent->m_parent)
+            {
+                visible = parent->isVisible();
+            }
+
+            //Children could be attached by the graph directly
+            if (event == NodeEvent::Update && node->m_hierarchy)
+            {
+                m_sceneData.m_transformHierarchy.insert(node);
+            }
+
+            m_sceneData.syncEntries(node, visible);
+        }
+    }
+    m_nodeEvents.clear();
 
     for (u32 i = 0; i < toEnumType(ScenePass::Count); ++i)
     {
         m_sceneData.m_renderLists[toEnumType(ScenePass(i))].clear();
     }
 
-    static auto applyTransfrom = [](SceneNode* parent, SceneNode* node)
+    m_sceneData.m_transformHierarchy.update(m_sceneData.m_taskWorker);
+
+    updateVisibility();
+
+    partitionRenderLists();
+
+    const std::vector<NodeEntry*>& generalList = m_sceneData.m_generalRenderList;
+    auto& lightList = m_sceneData.m_renderLists[toEnumType(ScenePass::PunctualLights)];
+    std::sort(lightList.begin(), lightList.end(), [camera = m_sceneData.m_camera](const NodeEntry* a, const NodeEntry* b) -> bool
         {
-            if (parent)
-            {
-                const math::Matrix4D transform = parent->m_transform[toEnumType(TransformMode::Global)].getMatrix() * node->m_transform[toEnumType(TransformMode::Local)].getMatrix();
-                node->m_transform[toEnumType(TransformMode::Global)].setMatrix(transform);
-            }
-            else
-            {
-                node->m_transform[toEnumType(TransformMode::Global)].setMatrix(node->m_transform[toEnumType(TransformMode::Local)].getMatrix());
-            }
-        };
+            f32 dist0 = a->object->getTransform().getPosition().distanceFrom(camera->getPosition());
+            f32 dist1 = a->object->getTransform().getPosition().distanceFrom(camera->getPosition());
+            
+            //TODO sort by radius
+            return dist0 < dist1;
+        });
 
-    //group by type
-    for (auto& item : m_sceneData.m_generalRenderList)
+    for (u32 i = 0; i < std::min<u32>(lightList.size(), k_maxPunctualShadowmapCount); ++i)
     {
-        if (item->object->m_dirty)
+        const NodeEntry* light = lightList[i];
+        if (PointLight* point = light->object->getComponentByType<PointLight>(); point)
         {
-            SceneNode::forEach(item->object, applyTransfrom);
-            item->object->m_dirty = false;
+            const u32 shadowList = toEnumType(scene::ScenePass::FirstPunctualShadowmap) + i;
+            m_sceneData.m_boundingVolumeHierarchy.query(light->object->getTransform().getPosition(), point->getRadius(), [this, &generalList, shadowList](u32 index) -> bool
+                {
+                    NodeEntry* item = generalList[index];
+                    if ((item->passMask & (1 << toEnumType(ScenePass::Shadowmap))) && (m_visibility[index] & Visibility_ShadowRange))
+                    {
+                        item->passMask |= 1 << shadowList;
+                        m_sceneData.m_renderLists[shadowList].push_back(item);
+                    }
+
+                    return true;
+                });
         }
+    }
+
+    for (u32 pass = toEnumType(ScenePass::FirstPunctualShadowmap); pass <= toEnumType(ScenePass::LastPunctualShadowmap); ++pass)
+    {
+        m_sceneData.m_cullingStatistic._visible[pass] = static_cast<u32>(m_sceneData.m_renderLists[pass].size());
+        m_sceneData.m_cullingStatistic._culled[pass] = 0;
+    }
+
+    const u32 statisticInterval = m_sceneData.m_settings._vewportParams._cullingStatisticInterval;
+    if (statisticInterval > 0 && (++m_sceneData.m_cullingStatistic._frameCounter % statisticInterval) == 0)
+    {
+        logCullingStatistic();
+    }
 
-        //fructum test
-        //TODO
+    //The lists are sorted one by one, every sort is split between the task threads
+    if (m_sceneData.m_camera && m_sceneData.m_settings._vewportParams._drawSorting)
+    {
+        TRACE_PROFILER_ZONE("SceneHandler::sortRenderLists");
 
-        u32 count = std::bit_width(item->passMask);
-        for (u32 index = 0; index < count; ++index)
+        const math::Vector3D& viewPosition = m_sceneData.m_camera->getPosition();
+        const f32 farDistance = m_sceneData.m_settings._vewportParams._far;
+        auto sortList = [this, &viewPosition, farDistance](ScenePass pass, RenderListSorter::DepthOrder order) -> void
+            {
+                m_renderListSorter.sort(m_sceneData.m_taskWorker, toEnumType(pass), m_sceneData.m_renderLists[toEnumType(pass)], viewPosition, farDistance, order);
+            };
+
+        sortList(ScenePass::Opaque, RenderListSorter::DepthOrder::FrontToBack);
+        sortList(ScenePass::SkinnedOpaque, RenderListSorter::DepthOrder::FrontToBack);
+        sortList(ScenePass::MaskedOpaque, RenderListSorter::DepthOrder::FrontToBack);
+        sortList(ScenePass::Transparency, RenderListSorter::DepthOrder::BackToFront);
+        sortList(ScenePass::VFX, RenderListSorter::DepthOrder::BackToFront);
+
+        //Shadow casters are grouped by the state, the depth from the camera only breaks the ties
+        sortList(ScenePass::Shadowmap, RenderListSorter::DepthOrder::FrontToBack);
+        for (u32 pass = toEnumType(ScenePass::FirstPunctualShadowmap); pass <= toEnumType(ScenePass::LastPunctualShadowmap); ++pass)
         {
-            u32 passID = 1 << index;
-            if ((item->passMask & passID) == 0)
+            sortList(ScenePass(pass), RenderListSorter::DepthOrder::FrontToBack);
+        }
+    }
+}
+
+void SceneHandler::updateVisibility()
+{
+    TRACE_PROFILER_ZONE("SceneHandler::updateVisibility");
+
+    std::vector<NodeEntry*>& generalList = m_sceneData.m_generalRenderList;
+    m_visibility.resize(generalList.size());
+
+    //Frustums without planes keep everything
+    math::Frustum cameraFrustum;
+    math::Frustum shadowFrustum;
+    if (m_sceneData.m_camera && m_sceneData.m_settings._vewportParams._frustumCulling)
+    {
+        const Camera& camera = m_sceneData.m_camera->getCamera();
+        cameraFrustum = math::Frustum(camera.getProjectionMatrix() * camera.getViewMatrix());
+
+        auto dirLight = std::find_if(generalList.cbegin(), generalList.cend(), [](const NodeEntry* item) -> bool
             {
-                continue;
+                return item->passMask & (1 << toEnumType(ScenePass::DirectionLight));
+            });
+
+        if (dirLight != generalList.cend())
+        {
+            //Cascades cover the view up to the long range distance. Casters out of the view can throw a shadow into it,
+            //so the planes which the light crosses are removed
+            if (camera.isOrthogonal())
+            {
+                shadowFrustum = cameraFrustum;
+            }
+            else
+            {
+                f32 farPlane = std::min(camera.getFar(), m_sceneData.m_settings._shadowsParams._longRange);
+                math::Matrix4D projectionMatrix = math::SMatrix::projectionMatrixPerspective(camera.getFOV() * math::k_degToRad, camera.getAspectRatio(), camera.getNear(), farPlane);
+                shadowFrustum = math::Frustum(projectionMatrix * camera.getViewMatrix());
             }
+            shadowFrustum.extrude((*dirLight)->object->getDirection());
+        }
+    }
+
+    //Frustums without planes keep everything, the entries without bounds can't be culled
+    const u8 unculledMask = ((cameraFrustum.getPlaneCount() == 0) ? Visibility_Camera : 0) | ((shadowFrustum.getPlaneCount() == 0) ? Visibility_Shadow : 0);
+    m_sceneData.m_taskWorker.parallelFor(0, static_cast<u32>(generalList.size()), k_visibilityTaskGrain, [this, &generalList, unculledMask](u32 begin, u32 end) -> void
+        {
+            const f32 longRange = m_sceneData.m_settings._shadowsParams._longRange;
 
-            if (passID & (1 << toEnumType(ScenePass::Shadowmap)))
+            for (u32 index = begin; index < end; ++index)
             {
+                NodeEntry* item = generalList[index];
+                item->worldBounds = math::transformAABB(item->localBounds, item->object->getTransform().getMatrix());
+
+                //The punctual shadowmap bits are set again by the lights of this frame
+                item->passMask &= ~k_punctualShadowmapMask;
+
+                if (item->material && item->materialVersion != static_cast<const Material*>(item->material)->getVersion())
+                {
+                    compileMaterialState(item);
+                }
+
+                u8 visibility = item->worldBounds.isValid() ? unculledMask : Visibility_Camera | Visibility_Shadow;
+
                 //Skip geometry if an object far away from long range distance
-                f32 distance = item->object->getTransform().getPosition().distanceFrom(m_sceneData.m_camera->getPosition());
-                if (distance > m_sceneData.m_settings._shadowsParams._longRange)
+                if (!m_sceneData.m_camera || item->object->getTransform().getPosition().distanceFrom(m_sceneData.m_camera->getPosition()) <= longRange)
+                {
+                    visibility |= Visibility_ShadowRange;
+                }
+                else
                 {
-                    continue;
+                    visibility &= ~Visibility_Shadow;
                 }
+
+                m_visibility[index] = visibility;
             }
+        });
+
+    updateBoundingVolumeHierarchy();
+
+    if (cameraFrustum.getPlaneCount() > 0)
+    {
+        cullByHierarchy(cameraFrustum, Visibility_Camera);
+    }
 
-            ASSERT(index < toEnumType(ScenePass::Count), "out of range");
-            m_sceneData.m_renderLists[index].push_back(item);
+    if (shadowFrustum.getPlaneCount() > 0)
+    {
+        cullByHierarchy(shadowFrustum, Visibility_Shadow);
+    }
+}
+
+void SceneHandler::updateBoundingVolumeHierarchy()
+{
+    TRACE_PROFILER_ZONE("SceneHandler::updateBoundingVolumeHierarchy");
+
+    //Leaves are reinserted only if an entry has moved out of its fat bounds
+    BoundingVolumeHierarchy& bvh = m_sceneData.m_boundingVolumeHierarchy;
+    for (u32 index = 0; index < m_sceneData.m_generalRenderList.size(); ++index)
+    {
+        NodeEntry* item = m_sceneData.m_generalRenderList[index];
+        if (!item->worldBounds.isValid())
+        {
+            if (item->proxyID != BoundingVolumeHierarchy::k_invalidProxy)
+            {
+                bvh.destroyProxy(item->proxyID);
+                item->proxyID = BoundingVolumeHierarchy::k_invalidProxy;
+            }
+            continue;
+        }
+
+        if (item->proxyID == BoundingVolumeHierarchy::k_invalidProxy)
+        {
+            item->proxyID = bvh.createProxy(item->worldBounds, index);
+        }
+        else
+        {
+            bvh.moveProxy(item->proxyID, item->worldBounds);
         }
     }
+}
 
-    auto& lightList = m_sceneData.m_renderLists[toEnumType(ScenePass::PunctualLights)];
-    std::sort(lightList.begin(), lightList.end(), [camera = m_sceneData.m_camera](const NodeEntry* a, const NodeEntry* b) -> bool
+void SceneHandler::cullByHierarchy(const math::Frustum& frustum, VisibilityFlag flag)
+{
+    TRACE_PROFILER_ZONE("SceneHandler::cullByHierarchy");
+
+    //The tree rejects the subtrees out of the frustum by the fat bounds, the exact bounds of the rest are tested by batches
+    m_visibilityCandidates.clear();
+    m_sceneData.m_boundingVolumeHierarchy.query(frustum, [this](u32 index) -> bool
         {
-            f32 dist0 = a->object->getTransform().getPosition().distanceFrom(camera->getPosition());
-            f32 dist1 = a->object->getTransform().getPosition().distanceFrom(camera->getPosition());
-            
-            //TODO sort by radius
-            return dist0 < dist1;
+            m_visibilityCandidates.push_back(index);
+            return true;
         });
 
-    for (u32 i = 0; i < std::min<u32>(lightList.size(), k_maxPunctualShadowmapCount); ++i)
-    {
-        for (auto& item : m_sceneData.m_renderLists[toEnumType(ScenePass::Shadowmap)])
+    //Every entry is a single leaf, so the tasks write the different flags
+    const std::vector<NodeEntry*>& generalList = m_sceneData.m_generalRenderList;
+    m_sceneData.m_taskWorker.parallelFor(0, static_cast<u32>(m_visibilityCandidates.size()), k_visibilityTaskGrain, [this, &generalList, &frustum, flag](u32 begin, u32 end) -> void
         {
-            const NodeEntry* light = lightList[i];
-            f32 distance = item->object->getTransform().getPosition().distanceFrom(light->object->getTransform().getPosition());
-
-            if (PointLight* point = light->object->getComponentByType<PointLight>(); point)
+            for (u32 index = begin; index < end; index += math::k_frustumBatchSize)
             {
-                if (point->getRadius() > distance)
+                const u32 count = std::min(end - index, math::k_frustumBatchSize);
+
+                const math::AABB* bounds[math::k_frustumBatchSize];
+                for (u32 i = 0; i < count; ++i)
                 {
-                    u32 lightList = toEnumType(scene::ScenePass::FirstPunctualShadowmap) + i;
-                    item->passMask |= 1 << lightList;
-                    m_sceneData.m_renderLists[lightList].push_back(item);
+                    bounds[i] = &generalList[m_visibilityCandidates[index + i]]->worldBounds;
                 }
+
+                const u32 insideMask = frustum.isInside(bounds, count);
+                for (u32 i = 0; i < count; ++i)
+                {
+                    u8& visibility = m_visibility[m_visibilityCandidates[index + i]];
+                    if ((insideMask & (1 << i)) && (flag != Visibility_Shadow || (visibility & Visibility_ShadowRange)))
+                    {
+                        visibility |= flag;
+                    }
+                }
+            }
+        });
+}
+
+NodeEntry* SceneHandler::raycast(const math::Vector3D& origin, const math::Vector3D& direction, f32 maxDistance, u64 objectID) const
+{
+    const std::vector<NodeEntry*>& generalList = m_sceneData.m_generalRenderList;
+
+    NodeEntry* nearestEntry = nullptr;
+    f32 nearestDistance = maxDistance;
+    m_sceneData.m_boundingVolumeHierarchy.raycast(origin, direction, maxDistance, [&generalList, &origin, &direction, objectID, &nearestEntry, &nearestDistance](u32 index, f32 distance) -> bool
+        {
+            //The tree hits the fat bounds, the exact bounds decide
+            NodeEntry* item = generalList[index];
+            if (distance > nearestDistance || (objectID != k_anyObjectID && item->object->ID() != objectID))
+            {
+                return true;
             }
+
+            const f32 exactDistance = BoundingVolumeHierarchy::intersectRay(item->worldBounds, origin, direction, nearestDistance);
+            if (exactDistance >= 0.f && (!nearestEntry || exactDistance < nearestDistance))
+            {
+                nearestEntry = item;
+                nearestDistance = exactDistance;
+            }
+
+            return true;
+        });
+
+    return nearestEntry;
+}
+
+void SceneHandler::partitionRenderLists()
+{
+    TRACE_PROFILER_ZONE("SceneHandler::partitionRenderLists");
+
+    //Punctual shadowmaps are filled by the lights after the partition
+    constexpr u32 k_partitionedPassMask = static_cast<u32>(((1ULL << toEnumType(ScenePass::Count)) - 1) & ~k_punctualShadowmapMask);
+    static_assert(toEnumType(ScenePass::Count) <= 32, "pass mask is 32 bits");
+
+    const std::vector<NodeEntry*>& generalList = m_sceneData.m_generalRenderList;
+    const u32 count = static_cast<u32>(generalList.size());
+    const u32 chunkCount = (count + k_visibilityTaskGrain - 1) / k_visibilityTaskGrain;
+    m_partitionCounts.resize(chunkCount);
+
+    //Every chunk walks own entries once and visits only the passes of their masks. The chunks have the fixed grain,
+    //so the chunk index is known from the range
+    auto forEachPass = [this, &generalList](u32 index, auto&& func) -> void
+        {
+            const NodeEntry* item = generalList[index];
+            const u8 visibility = m_visibility[index];
+            for (u32 mask = item->passMask & k_partitionedPassMask; mask; mask &= mask - 1)
+            {
+                const u32 pass = std::countr_zero(mask);
+                const u8 visibilityFlag = (pass == toEnumType(ScenePass::Shadowmap)) ? Visibility_Shadow : Visibility_Camera;
+                func(pass, (visibility & visibilityFlag) != 0);
+            }
+        };
+
+    m_sceneData.m_taskWorker.parallelFor(0, count, k_visibilityTaskGrain, [this, &forEachPass](u32 begin, u32 end) -> void
+        {
+            PassCounts& counts = m_partitionCounts[begin / k_visibilityTaskGrain];
+            counts._visible.fill(0);
+            counts._culled.fill(0);
+            for (u32 index = begin; index < end; ++index)
+            {
+                forEachPass(index, [&counts](u32 pass, bool visible) -> void
+                    {
+                        ++(visible ? counts._visible[pass] : counts._culled[pass]);
+                    });
+            }
+        });
+
+    //The counts become the write offsets of the chunks, the lists keep the order of the general list
+    for (u32 pass = 0; pass < toEnumType(ScenePass::Count); ++pass)
+    {
+        if ((k_partitionedPassMask & (1 << pass)) == 0)
+        {
+            continue;
+        }
+
+        u32 visibleCount = 0;
+        u32 culledCount = 0;
+        for (PassCounts& counts : m_partitionCounts)
+        {
+            const u32 chunkVisible = counts._visible[pass];
+            counts._visible[pass] = visibleCount;
+            visibleCount += chunkVisible;
+            culledCount += counts._culled[pass];
+        }
+
+        m_sceneData.m_renderLists[pass].resize(visibleCount);
+        m_sceneData.m_cullingStatistic._visible[pass] = visibleCount;
+        m_sceneData.m_cullingStatistic._culled[pass] = culledCount;
+    }
+
+    m_sceneData.m_taskWorker.parallelFor(0, count, k_visibilityTaskGrain, [this, &generalList, &forEachPass](u32 begin, u32 end) -> void
+        {
+            PassCounts& offsets = m_partitionCounts[begin / k_visibilityTaskGrain];
+            for (u32 index = begin; index < end; ++index)
+            {
+                NodeEntry* item = generalList[index];
+                forEachPass(index, [this, &offsets, item](u32 pass, bool visible) -> void
+                    {
+                        if (visible)
+                        {
+                            m_sceneData.m_renderLists[pass][offsets._visible[pass]++] = item;
+                        }
+                    });
+            }
+        });
+}
+
+void SceneHandler::logCullingStatistic() const
+{
+    static const c8* k_passNames[toEnumType(ScenePass::Count)] =
+    {
+        "Opaque", "SkinnedOpaque", "MaskedOpaque", "Skybox", "Transparency", "VFX", "DirectionLight", "PunctualLights", "Shadowmap",
+    };
+
+    const CullingStatistic& statistic = m_sceneData.m_cullingStatistic;
+    for (u32 pass = 0; pass < toEnumType(ScenePass::Count); ++pass)
+    {
+        if (statistic._visible[pass] == 0 && statistic._culled[pass] == 0)
+        {
+            continue;
+        }
+
+        if (k_passNames[pass])
+        {
+            LOG_INFO("SceneHandler culling: %s visible %u, culled %u", k_passNames[pass], statistic._visible[pass], statistic._culled[pass]);
+        }
+        else
+        {
+            LOG_INFO("SceneHandler culling: pass %u visible %u, culled %u", pass, statistic._visible[pass], statistic._culled[pass]);
         }
     }
 }
 
 void SceneHandler::preRender(f32 dt)
 {
+    TRACE_PROFILER_ZONE("SceneHandler::preRender");
+
     for (auto& technique : m_renderTechniques)
     {
         technique->prepare(m_device, m_sceneData, m_sceneData.m_frameState[m_sceneData.m_stateIndex]);
@@ -304,6 +768,8 @@ void SceneHandler::preRender(f32 dt)
 
 void SceneHandler::postRender(f32 dt)
 {
+    TRACE_PROFILER_ZONE("SceneHandler::postRender");
+
     for (auto& technique : m_renderTechniques)
     {
         technique->execute(m_device, m_sceneData, m_sceneData.m_frameState[m_sceneData.m_stateIndex]);
@@ -312,6 +778,8 @@ void SceneHandler::postRender(f32 dt)
 
 void SceneHandler::submitRender()
 {
+    TRACE_PROFILER_ZONE("SceneHandler::submitRender");
+
     m_sceneData.m_taskWorker.mainThreadLoop();
 
     for (auto& technique : m_renderTechniques)
@@ -320,12 +788,35 @@ void SceneHandler::submitRender()
     }
 
     m_sceneData.m_stateIndex = (m_sceneData.m_stateIndex + 1) % m_sceneData.m_frameState.size();
+
+    TRACE_PROFILER_FRAME;
 }
 
 void SceneHandler::addNode(SceneNode* node)
 {
     m_sceneData.m_nodes.push_back(node);
-    nodeGraphChanged();
+    m_sceneData.m_transformHierarchy.insert(node);
+    m_nodeEvents.emplace_back(node, NodeEvent::Add);
+}
+
+void SceneHandler::removeNode(SceneNode* node)
+{
+    //A child is detached from its parent, otherwise the next walk over the graph brings it back
+    if (node->m_parent)
+    {
+        node->m_parent->removeChild(node);
+    }
+    else if (auto found = std::find(m_sceneData.m_nodes.begin(), m_sceneData.m_nodes.end(), node); found != m_sceneData.m_nodes.end())
+    {
+        m_sceneData.m_nodes.erase(found);
+        m_sceneData.m_transformHierarchy.remove(node);
+    }
+    m_nodeEvents.emplace_back(node, NodeEvent::Remove);
+}
+
+void SceneHandler::updateNode(SceneNode* node)
+{
+    m_nodeEvents.emplace_back(node, NodeEvent::Update);
 }
 
 void SceneHandler::nodeGraphChanged()
@@ -9,6 +9,10 @@
 
 #include "Scene/Camera/CameraController.h"
 #include "Scene/Light.h"
+#include "Scene/BoundingVolumeHierarchy.h"
+#include "Scene/NodeEntryPool.h"
+#include "Scene/TransformHierarchy.h"
+#include "Scene/RenderListSorter.h"
 
 #include "Renderer/Device.h"
 #include "Renderer/Buffer.h"
@@ -104,6 +108,9 @@ namespace scene
             renderer::Format _depthFormat = renderer::Format_D24_UNorm_S8_UInt;
             AntiAliasing     _antiAliasingMode = AntiAliasing::TAA;
             u32              _renderTargetID = 0;
+            bool             _frustumCulling = true;
+            bool             _drawSorting = true; //Orders the draw lists by the pipeline, material and depth
+            u32              _cullingStatisticInterval = 0; //Logs the culling statistic every N frames, 0 - disabled
 
         } _vewportParams;
 
@@ -133,6 +140,18 @@ namespace scene
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    /**
+    * @brief CullingStatistic struct. Number of entries per pass of the last updated frame
+    */
+    struct CullingStatistic
+    {
+        std::array<u32, toEnumType(ScenePass::Count)> _visible = {};
+        std::array<u32, toEnumType(ScenePass::Count)> _culled = {};
+        u64                                           _frameCounter = 0;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
     /**
     * @brief FrameData class
     */
@@ -167,6 +186,8 @@ namespace scene
 
         std::vector<NodeEntry*>             m_generalRenderList;
         std::vector<NodeEntry*>             m_renderLists[toEnumType(ScenePass::Count)];
+        CullingStatistic                    m_cullingStatistic;
+        BoundingVolumeHierarchy             m_boundingVolumeHierarchy; //Entries of the general render list with bounds, user data is the list index
 
         math::Dimension2D                   m_viewportSize;
         scene::CameraController*            m_camera;
@@ -178,11 +199,23 @@ namespace scene
         mutable task::TaskScheduler         m_taskWorker;
 
         std::vector<SceneNode*>             m_nodes;
+        TransformHierarchy                  m_transformHierarchy;
 
         mutable std::array<FrameData, 1>    m_frameState;
         u32                                 m_stateIndex;
 
         void finalize();
+        void syncEntries(SceneNode* node, bool visible);
+
+    private:
+
+        NodeEntry* createEntries(SceneNode* node);
+        void insertEntry(NodeEntry* entry);
+        void replaceEntry(NodeEntry* entry, NodeEntry* newEntry);
+        void removeEntry(NodeEntry* entry);
+
+        NodeEntryPool                                   m_entryPool;
+        std::unordered_map<const SceneNode*, NodeEntry*> m_nodeEntries; //First entry of a node, the rest are chained by NodeEntry::nextEntry
 
         friend RenderTechnique;
         friend SceneHandler;
@@ -220,19 +253,62 @@ namespace scene
         void submitRender();
 
         void addNode(SceneNode* node);
-        /*void removeNode(SceneNode* node);
-        void updateNode(SceneNode* node)*/
+        void removeNode(SceneNode* node); //The node must be alive until the next updateScene, a child is detached from its parent
+        void updateNode(SceneNode* node);
         void nodeGraphChanged();
 
         void registerTechnique(RenderTechnique* technique);
         void unregisterTechnique(RenderTechnique* technique);
 
+        static constexpr u64 k_anyObjectID = 0;
+
+        /**
+        * @brief raycast. Nearest entry of the general render list hit by the ray, the bounds are from the last updateScene
+        * @param u64 objectID [in] only the entries of this node are tested, k_anyObjectID tests all
+        * @return NodeEntry* or nullptr if nothing is hit
+        */
+        NodeEntry* raycast(const math::Vector3D& origin, const math::Vector3D& direction, f32 maxDistance, u64 objectID = k_anyObjectID) const;
+
         renderer::Device*                    m_device;
         SceneData                            m_sceneData;
 
     private:
 
+        enum class NodeEvent : u32
+        {
+            Add,
+            Remove,
+            Update
+        };
+
+        enum VisibilityFlag : u8
+        {
+            Visibility_Camera      = 1 << 0,
+            Visibility_ShadowRange = 1 << 1, //Closer than the shadow long range distance to the camera
+            Visibility_Shadow      = 1 << 2, //Can cast a shadow into the view of the camera
+        };
+
+        /**
+        * @brief PassCounts struct. Entries of a chunk of the general render list per pass
+        */
+        struct PassCounts
+        {
+            std::array<u32, toEnumType(ScenePass::Count)> _visible;
+            std::array<u32, toEnumType(ScenePass::Count)> _culled;
+        };
+
+        void updateVisibility();
+        void updateBoundingVolumeHierarchy();
+        void cullByHierarchy(const math::Frustum& frustum, VisibilityFlag flag);
+        void partitionRenderLists();
+        void logCullingStatistic() const;
+
         std::vector<scene::RenderTechnique*> m_renderTechniques;
+        std::vector<u8>                      m_visibility; //VisibilityFlag per entry of the general render list
+        std::vector<u32>                     m_visibilityCandidates; //Entries which the hierarchy hasn't culled
+        std::vector<PassCounts>              m_partitionCounts; //Per chunk, turned to the write offsets
+        std::vector<std::tuple<SceneNode*, NodeEvent>> m_nodeEvents; //Applied at the beginning of the next updateScene
+        RenderListSorter                     m_renderListSorter;
         bool                                 m_nodeGraphChanged;
     };
 
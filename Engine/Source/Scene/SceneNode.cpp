@@ -13,6 +13,7 @@ SceneNode::SceneNode() noexcept
 
 SceneNode::SceneNode(const SceneNode& node) noexcept
     : m_parent(node.m_parent)
+    , m_localTransform(node.getTransform(TransformMode::Local))
 {
 }
 
@@ -39,19 +40,53 @@ void SceneNode::addChild(SceneNode* node)
     m_children.push_back(node);
     ASSERT(node->m_parent == nullptr, "node has parend already");
     node->m_parent = this;
+
+    if (m_hierarchy)
+    {
+        m_hierarchy->insert(node);
+    }
+}
+
+void SceneNode::removeChild(SceneNode* node)
+{
+    ASSERT(node->m_parent == this, "not a child");
+    if (node->m_hierarchy)
+    {
+        node->m_hierarchy->remove(node);
+    }
+
+    m_children.remove(node);
+    node->m_parent = nullptr;
+}
+
+void SceneNode::setGlobalMatrix(const math::Matrix4D& transform)
+{
+    //World is the parent world * local
+    if (m_parent)
+    {
+        editLocalTransform().setMatrix(m_parent->getTransform().getMatrix().getInversed() * transform);
+    }
+    else
+    {
+        editLocalTransform().setMatrix(transform);
+    }
 }
 
 
 NodeEntry::NodeEntry() noexcept
     : object(nullptr)
+    , proxyID(BoundingVolumeHierarchy::k_invalidProxy)
     , passMask(1 << toEnumType(scene::ScenePass::Custom))
     , pipelineID(0)
+    , listIndex(~0U)
+    , nextEntry(nullptr)
+    , material(nullptr)
+    , materialVersion(0)
 {
 }
 
 DrawNodeEntry::DrawNodeEntry() noexcept
     : geometry(nullptr)
-    , material(nullptr)
 {
 }
 
@@ -62,7 +97,6 @@ LightNodeEntry::LightNodeEntry() noexcept
 
 SkyboxNodeEntry::SkyboxNodeEntry() noexcept
     : skybox(nullptr)
-    , material(nullptr)
 {
 }
 
@@ -8,6 +8,7 @@
 
 #include "Scene/Transform.h"
 #include "Scene/Component.h"
+#include "Scene/TransformHierarchy.h"
 
 namespace v3d
 {
@@ -38,6 +39,7 @@ namespace scene
         SceneNode() noexcept;
 
         void addChild(SceneNode* node);
+        void removeChild(SceneNode* node); //Detaches the node, the caller owns it after
         void addComponent(Component* component, bool owner = true);
 
         template<class TComponent>
@@ -71,6 +73,7 @@ namespace scene
         const Transform& getTransform() const;
         const Transform& getPrevTransform() const;
         const Transform& getTransform(TransformMode mode) const;
+        u32 getTransformHandle() const;
         bool isVisible() const;
 
     public:
@@ -82,13 +85,18 @@ namespace scene
 
     private:
 
+        Transform& editLocalTransform();
+        void setGlobalMatrix(const math::Matrix4D& transform);
+
         //Instance state
-        Transform             m_transform[2];
+        Transform             m_localTransform; //Until the node is inserted to a hierarchy, the hierarchy owns the transforms after
         Transform             m_prevTransform;
 
+        TransformHierarchy*   m_hierarchy = nullptr;
+        u32                   m_transformHandle = TransformHierarchy::k_invalidHandle;
         bool                  m_visible = true;
         bool                  m_debug = false;
-        bool                  m_dirty = true;
+        bool                  m_dirty = false; //Queued to the update of the hierarchy
 
     protected:
 
@@ -100,6 +108,7 @@ namespace scene
         friend Model;
         friend ModelHandler;
         friend SceneHandler;
+        friend TransformHierarchy;
     };
 
     inline void SceneNode::addComponent(Component* component, bool owner)
@@ -107,53 +116,87 @@ namespace scene
         m_components.emplace_back(component, owner);
     }
 
+    inline Transform& SceneNode::editLocalTransform()
+    {
+        if (m_hierarchy)
+        {
+            m_hierarchy->markDirty(this);
+            return m_hierarchy->getLocalTransform(m_transformHandle);
+        }
+
+        return m_localTransform;
+    }
+
     inline void SceneNode::setPosition(TransformMode mode, const math::Vector3D& position)
     {
-        m_transform[toEnumType(mode)].setPosition(position);
-        m_dirty = true;
+        if (mode == TransformMode::Local)
+        {
+            editLocalTransform().setPosition(position);
+            return;
+        }
+
+        Transform transform = getTransform();
+        transform.setPosition(position);
+        setGlobalMatrix(transform.getMatrix());
     }
 
     inline void SceneNode::setRotation(TransformMode mode, const math::Vector3D& rotation)
     {
-        m_transform[toEnumType(mode)].setRotation(rotation);
-        m_dirty = true;
+        if (mode == TransformMode::Local)
+        {
+            editLocalTransform().setRotation(rotation);
+            return;
+        }
+
+        Transform transform = getTransform();
+        transform.setRotation(rotation);
+        setGlobalMatrix(transform.getMatrix());
     }
 
     inline void SceneNode::setScale(TransformMode mode, const math::Vector3D& scale)
     {
-        m_transform[toEnumType(mode)].setScale(scale);
-        m_dirty = true;
+        if (mode == TransformMode::Local)
+        {
+            editLocalTransform().setScale(scale);
+            return;
+        }
+
+        Transform transform = getTransform();
+        transform.setScale(scale);
+        setGlobalMatrix(transform.getMatrix());
     }
 
     inline void SceneNode::setTransform(TransformMode mode, const math::Matrix4D& transform)
     {
-        m_transform[toEnumType(mode)].setMatrix(transform);
-        m_dirty = true;
+        if (mode == TransformMode::Local)
+        {
+            editLocalTransform().setMatrix(transform);
+            return;
+        }
+
+        setGlobalMatrix(transform);
     }
 
     inline void SceneNode::setVisible(bool visible)
     {
         m_visible = visible;
-        m_dirty = true;
     }
 
     inline void SceneNode::setDebug(bool debug)
     {
         m_debug = debug;
-        m_dirty = true;
     }
 
     inline math::Vector3D SceneNode::getDirection() const
     {
-        return math::Vector3D(
-            m_transform[toEnumType(TransformMode::Global)].getMatrix()[8],
-            m_transform[toEnumType(TransformMode::Global)].getMatrix()[9],
-            m_transform[toEnumType(TransformMode::Global)].getMatrix()[10]).normalize();
+        const math::Matrix4D& transform = getTransform().getMatrix();
+        return math::Vector3D(transform[8], transform[9], transform[10]).normalize();
     }
 
     inline const Transform& SceneNode::getTransform() const
     {
-        return m_transform[toEnumType(TransformMode::Global)];
+        //A node out of the hierarchy has no parent transform applied
+        return m_hierarchy ? m_hierarchy->getWorldTransform(m_transformHandle) : m_localTransform;
     }
 
     inline const Transform& SceneNode::getPrevTransform() const
@@ -163,7 +206,17 @@ namespace scene
 
     inline const Transform& SceneNode::getTransform(TransformMode mode) const
     {
-        return m_transform[toEnumType(mode)];
+        if (mode == TransformMode::Global)
+        {
+            return getTransform();
+        }
+
+        return m_hierarchy ? m_hierarchy->getLocalTransform(m_transformHandle) : m_localTransform;
+    }
+
+    inline u32 SceneNode::getTransformHandle() const
+    {
+        return m_transformHandle;
     }
 
     inline bool SceneNode::isVisible() const
@@ -204,8 +257,15 @@ namespace scene
         virtual ~NodeEntry() = default;
 
         SceneNode*  object;
+        math::AABB  localBounds; //Invalid if the entry has no geometry, such entries are never culled
+        math::AABB  worldBounds;
+        u32         proxyID; //Leaf in the scene BoundingVolumeHierarchy, created once the world bounds are known
         u32         passMask;
         u32         pipelineID;
+        u32         listIndex; //Position in the general render list
+        NodeEntry*  nextEntry; //Next entry created by the same node
+        Component*  material;
+        u64         materialVersion; //Version of the material which the passes and the pipeline are taken from
     };
 
     struct DrawNodeEntry final : NodeEntry
@@ -213,7 +273,6 @@ namespace scene
         DrawNodeEntry() noexcept;
 
         Component* geometry;
-        Component* material;
     };
 
     struct LightNodeEntry final : NodeEntry
@@ -228,7 +287,6 @@ namespace scene
         SkyboxNodeEntry() noexcept;
 
         Component* skybox;
-        Component* material;
     };
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -6,12 +6,41 @@ namespace v3d
 namespace scene
 {
 
+TransformTRS::TransformTRS() noexcept
+    : _translation(0.f, 0.f, 0.f)
+    , _rotation()
+    , _scale(1.f, 1.f, 1.f)
+{
+}
+
+TransformTRS::TransformTRS(const math::Vector3D& translation, const math::Quaternion& rotation, const math::Vector3D& scale) noexcept
+    : _translation(translation)
+    , _rotation(rotation)
+    , _scale(scale)
+{
+}
+
+TransformTRS::TransformTRS(const math::Matrix4D& transform) noexcept
+    : _translation(0.f, 0.f, 0.f)
+    , _rotation()
+    , _scale(1.f, 1.f, 1.f)
+{
+    [[maybe_unused]] bool result = math::SMatrix::decompose(transform, _translation, _rotation, _scale);
+    ASSERT(result, "degenerate matrix");
+}
+
+math::Matrix4D TransformTRS::getMatrix() const
+{
+    return math::SMatrix::transformMatrix(_translation, _rotation, _scale);
+}
+
 Transform::Transform() noexcept
-    : m_position(0.f, 0.f, 0.f)
+    : m_transformFlag(0/*TransformState::TransformState_All*/)
+    , m_decomposeFlag(0)
+
+    , m_position(0.f, 0.f, 0.f)
     , m_rotation(0.f, 0.f, 0.f)
     , m_scale(1.f, 1.f, 1.f)
-
-    , m_transformFlag(0/*TransformState::TransformState_All*/)
 {
 }
 
@@ -23,48 +52,84 @@ void Transform::setPosition(const math::Vector3D& position)
 {
     m_position = position;
     m_transformFlag |= TransformState::TransformState_Translation;
+    m_decomposeFlag &= ~TransformState::TransformState_Translation;
 }
 
 void Transform::setRotation(const math::Vector3D& rotation)
 {
     m_rotation = rotation;
     m_transformFlag |= TransformState::TransformState_Rotation;
+    m_decomposeFlag &= ~TransformState::TransformState_Rotation;
 }
 
 void Transform::setScale(const math::Vector3D& scale)
 {
     m_scale = scale;
     m_transformFlag |= TransformState::TransformState_Scale;
+    m_decomposeFlag &= ~TransformState::TransformState_Scale;
 }
 
 void Transform::setMatrix(const math::Matrix4D& transform)
 {
     m_modelMatrix = transform;
-
-    m_position = m_modelMatrix.getTranslation();
-    m_rotation = m_modelMatrix.getRotation();
-    m_scale = m_modelMatrix.getScale();
     m_transformFlag &= ~TransformState::TransformState_All;
+    m_decomposeFlag |= TransformState::TransformState_All;
+}
+
+TransformTRS Transform::getTRS() const
+{
+    if (m_decomposeFlag & TransformState::TransformState_Rotation)
+    {
+        //The quaternion is taken from the matrix directly, the pending components replace the stale ones
+        TransformTRS transform(m_modelMatrix);
+        if (m_transformFlag & TransformState::TransformState_Translation)
+        {
+            transform._translation = m_position;
+        }
+
+        if (m_transformFlag & TransformState::TransformState_Scale)
+        {
+            transform._scale = m_scale;
+        }
+        return transform;
+    }
+
+    return TransformTRS(Transform::getPosition(), math::SQuaternion::fromEulerAngles(m_rotation), Transform::getScale());
 }
 
 void Transform::claculateTransform() const
 {
-    if (m_transformFlag & TransformState::TransformState_Scale)
+    //The translation is the last row, other components need the whole matrix composed
+    if (m_transformFlag == TransformState::TransformState_Translation)
     {
-        m_modelMatrix.setScale(m_scale);
-        m_transformFlag &= ~TransformState::TransformState_Scale;
+        m_modelMatrix.setTranslation(m_position);
     }
+    else
+    {
+        m_modelMatrix = Transform::getTRS().getMatrix();
+    }
+    m_transformFlag = 0;
+}
 
-    if (m_transformFlag & TransformState::TransformState_Rotation)
+void Transform::decomposeTransform(TransformStateFlags flags) const
+{
+    //A stale component is never pending in m_transformFlag, so the matrix already holds its actual value
+    if (flags & TransformState::TransformState_Translation)
     {
-        m_modelMatrix.setRotation(m_rotation);
-        m_transformFlag &= ~TransformState::TransformState_Rotation;
+        m_position = m_modelMatrix.getTranslation();
+        m_decomposeFlag &= ~TransformState::TransformState_Translation;
     }
 
-    if (m_transformFlag & TransformState::TransformState_Translation)
+    if (flags & TransformState::TransformState_Rotation)
     {
-        m_modelMatrix.setTranslation(m_position);
-        m_transformFlag &= ~TransformState::TransformState_Translation;
+        m_rotation = m_modelMatrix.getRotation();
+        m_decomposeFlag &= ~TransformState::TransformState_Rotation;
+    }
+
+    if (flags & TransformState::TransformState_Scale)
+    {
+        m_scale = m_modelMatrix.getScale();
+        m_decomposeFlag &= ~TransformState::TransformState_Scale;
     }
 }
 
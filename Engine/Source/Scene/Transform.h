@@ -10,9 +10,31 @@ namespace scene
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
-    * @brief Transform class
+    * @brief TransformTRS struct. Compact transform: translation, rotation quaternion and scale
     */
-    class Transform
+    struct TransformTRS
+    {
+        TransformTRS() noexcept;
+        TransformTRS(const math::Vector3D& translation, const math::Quaternion& rotation, const math::Vector3D& scale) noexcept;
+        explicit TransformTRS(const math::Matrix4D& transform) noexcept;
+
+        [[nodiscard]] math::Matrix4D getMatrix() const;
+
+        math::Vector3D   _translation;
+        math::Quaternion _rotation;
+        math::Vector3D   _scale;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief Transform class.
+    * Keeps the matrix and its components, each side is rebuilt lazily from the other on read.
+    * setMatrix only stores the matrix, the decomposition happens when a component is requested.
+    * The matrix is composed once from TransformTRS, the matrix setters of the components would decompose it per component.
+    * Lazy getters update the cache, don't read the same transform from several threads while it's dirty
+    */
+    class Transform final
     {
     public:
 
@@ -28,7 +50,7 @@ namespace scene
 
 
         Transform() noexcept;
-        virtual ~Transform();
+        ~Transform();
 
         void setPosition(const math::Vector3D& position);
         void setRotation(const math::Vector3D& rotation);
@@ -39,37 +61,55 @@ namespace scene
         const math::Vector3D& getRotation() const;
         const math::Vector3D& getScale() const;
         const math::Matrix4D& getMatrix() const;
+        TransformTRS getTRS() const;
 
     private:
 
         void claculateTransform() const;
+        void decomposeTransform(TransformStateFlags flags) const;
 
-        mutable TransformStateFlags m_transformFlag;
+        mutable TransformStateFlags m_transformFlag;    //Components changed, the matrix is stale
+        mutable TransformStateFlags m_decomposeFlag;    //Matrix changed, the components are stale
         mutable math::Matrix4D m_modelMatrix;
 
-        math::Vector3D m_position;
-        math::Vector3D m_rotation;
-        math::Vector3D m_scale;
+        mutable math::Vector3D m_position;
+        mutable math::Vector3D m_rotation;
+        mutable math::Vector3D m_scale;
     };
 
     inline const math::Vector3D& Transform::getPosition() const
     {
+        if (m_decomposeFlag & TransformState::TransformState_Translation)
+        {
+            Transform::decomposeTransform(TransformState::TransformState_Translation);
+        }
         return m_position;
     }
 
     inline const math::Vector3D& Transform::getRotation() const
     {
+        if (m_decomposeFlag & TransformState::TransformState_Rotation)
+        {
+            Transform::decomposeTransform(TransformState::TransformState_Rotation);
+        }
         return m_rotation;
     }
 
     inline const math::Vector3D& Transform::getScale() const
     {
+        if (m_decomposeFlag & TransformState::TransformState_Scale)
+        {
+            Transform::decomposeTransform(TransformState::TransformState_Scale);
+        }
         return m_scale;
     }
 
     inline const math::Matrix4D& Transform::getMatrix() const
     {
-        Transform::claculateTransform();
+        if (m_transformFlag)
+        {
+            Transform::claculateTransform();
+        }
         return m_modelMatrix;
     }
 
@@ -0,0 +1,187 @@
+#include "TransformHierarchy.h"
+#include "SceneNode.h"
+#include "Task/TaskScheduler.h"
+
+namespace v3d
+{
+namespace scene
+{
+
+constexpr u32 k_transformTaskGrain = 512;
+
+TransformHierarchy::TransformHierarchy() noexcept
+    : m_count(0)
+{
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+}
+
+void TransformHierarchy::insert(SceneNode* node)
+{
+    if (node->m_hierarchy != this)
+    {
+        ASSERT(!node->m_hierarchy, "node is inserted to another hierarchy");
+
+        u32 levelIndex = 0;
+        u32 parent = k_invalidHandle;
+        if (node->m_parent)
+        {
+            ASSERT(node->m_parent->m_hierarchy == this, "parent must be inserted");
+            parent = node->m_parent->m_transformHandle;
+            levelIndex = getLevel(parent) + 1;
+        }
+
+        if (levelIndex >= m_levels.size())
+        {
+            m_levels.resize(levelIndex + 1);
+        }
+
+        Level& level = m_levels[levelIndex];
+        node->m_transformHandle = makeHandle(levelIndex, static_cast<u32>(level._nodes.size()));
+        node->m_hierarchy = this;
+        level._nodes.push_back(node);
+        level._parents.push_back(parent);
+        level._localTransforms.push_back(node->m_localTransform);
+        level._worldTransforms.emplace_back();
+        level._queued.push_back(0);
+        ++m_count;
+
+        markDirty(node);
+    }
+
+    for (SceneNode* child : node->m_children)
+    {
+        insert(child);
+    }
+}
+
+void TransformHierarchy::remove(SceneNode* node)
+{
+    //Children go first, so the node moved to a freed slot never has a removed parent
+    for (SceneNode* child : node->m_children)
+    {
+        remove(child);
+    }
+
+    if (node->m_hierarchy != this)
+    {
+        return;
+    }
+
+    const u32 levelIndex = getLevel(node->m_transformHandle);
+    const u32 index = getIndex(node->m_transformHandle);
+    Level& level = m_levels[levelIndex];
+    node->m_localTransform = level._localTransforms[index];
+
+    const u32 last = static_cast<u32>(level._nodes.size()) - 1;
+    if (index != last)
+    {
+        SceneNode* moved = level._nodes[last];
+        level._nodes[index] = moved;
+        level._parents[index] = level._parents[last];
+        level._localTransforms[index] = level._localTransforms[last];
+        level._worldTransforms[index] = level._worldTransforms[last];
+
+        moved->m_transformHandle = makeHandle(levelIndex, index);
+        for (SceneNode* child : moved->m_children)
+        {
+            if (child->m_hierarchy == this)
+            {
+                m_levels[levelIndex + 1]._parents[getIndex(child->m_transformHandle)] = moved->m_transformHandle;
+            }
+        }
+    }
+
+    level._nodes.pop_back();
+    level._parents.pop_back();
+    level._localTransforms.pop_back();
+    level._worldTransforms.pop_back();
+    level._queued.pop_back();
+    --m_count;
+
+    node->m_hierarchy = nullptr;
+    node->m_transformHandle = k_invalidHandle;
+}
+
+void TransformHierarchy::markDirty(SceneNode* node)
+{
+    if (!node->m_dirty)
+    {
+        node->m_dirty = true;
+        m_dirtyNodes.push_back(node);
+    }
+}
+
+void TransformHierarchy::enqueue(u32 handle)
+{
+    Level& level = m_levels[getLevel(handle)];
+    const u32 index = getIndex(handle);
+    if (!level._queued[index])
+    {
+        level._queued[index] = 1;
+        level._dirty.push_back(index);
+    }
+}
+
+void TransformHierarchy::update(task::TaskScheduler& scheduler)
+{
+    for (SceneNode* node : m_dirtyNodes)
+    {
+        node->m_dirty = false;
+        if (node->m_hierarchy == this)
+        {
+            enqueue(node->m_transformHandle);
+        }
+    }
+    m_dirtyNodes.clear();
+
+    //The parent level is finished before the next one starts, the children of the updated nodes are queued to the next level
+    for (u32 levelIndex = 0; levelIndex < m_levels.size(); ++levelIndex)
+    {
+        Level& level = m_levels[levelIndex];
+        if (level._dirty.empty())
+        {
+            continue;
+        }
+
+        const Level* parentLevel = (levelIndex > 0) ? &m_levels[levelIndex - 1] : nullptr;
+        scheduler.parallelFor(0, static_cast<u32>(level._dirty.size()), k_transformTaskGrain, [&level, parentLevel](u32 begin, u32 end) -> void
+            {
+                for (u32 i = begin; i < end; ++i)
+                {
+                    const u32 index = level._dirty[i];
+                    const math::Matrix4D& localMatrix = level._localTransforms[index].getMatrix();
+                    if (parentLevel)
+                    {
+                        level._worldTransforms[index].setMatrix(parentLevel->_worldTransforms[getIndex(level._parents[index])].getMatrix() * localMatrix);
+                    }
+                    else
+                    {
+                        level._worldTransforms[index].setMatrix(localMatrix);
+                    }
+                }
+            });
+
+        const bool hasChildren = levelIndex + 1 < m_levels.size();
+        for (u32 index : level._dirty)
+        {
+            level._queued[index] = 0;
+            if (hasChildren)
+            {
+                for (SceneNode* child : level._nodes[index]->m_children)
+                {
+                    if (child->m_hierarchy == this)
+                    {
+                        enqueue(child->m_transformHandle);
+                    }
+                }
+            }
+        }
+        level._dirty.clear();
+    }
+}
+
+} //namespace scene
+} //namespace v3d
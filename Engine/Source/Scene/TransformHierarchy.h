@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Common.h"
+#include "Transform.h"
+
+namespace v3d
+{
+namespace task
+{
+    class TaskScheduler;
+} //namespace task
+
+namespace scene
+{
+    class SceneNode;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief TransformHierarchy class.
+    * Owns the local and world transforms of the inserted nodes, SoA arrays per hierarchy depth, a parent is always on the previous level.
+    * Nodes are inserted and removed one by one, a removed slot is filled by the last node of the level.
+    * Only the queued nodes and their subtrees are updated, level by level, nodes of the same level are processed in parallel.
+    * Handles are changed by the removal of other nodes, SceneNode keeps the actual one
+    */
+    class TransformHierarchy final
+    {
+    public:
+
+        static constexpr u32 k_invalidHandle = ~0U;
+
+        TransformHierarchy() noexcept;
+        ~TransformHierarchy();
+
+        TransformHierarchy(const TransformHierarchy&) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+        /**
+        * @brief insert. Inserts the node and its children which are not inserted yet. The parent must be inserted already
+        */
+        void insert(SceneNode* node);
+
+        /**
+        * @brief remove. Removes the node and its subtree, the local transforms are moved back to the nodes
+        */
+        void remove(SceneNode* node);
+
+        /**
+        * @brief markDirty. Queues the node, its world transform and the subtree are recalculated by the next update
+        */
+        void markDirty(SceneNode* node);
+
+        void update(task::TaskScheduler& scheduler);
+
+        Transform& getLocalTransform(u32 handle);
+        const Transform& getLocalTransform(u32 handle) const;
+        const Transform& getWorldTransform(u32 handle) const;
+        u32 getParent(u32 handle) const;
+
+        u32 getCount() const;
+        u32 getLevelCount() const;
+
+    private:
+
+        static constexpr u32 k_levelShift = 22;
+        static constexpr u32 k_indexMask = (1 << k_levelShift) - 1;
+
+        struct Level
+        {
+            std::vector<SceneNode*> _nodes;
+            std::vector<u32>        _parents;
+            std::vector<Transform>  _localTransforms;
+            std::vector<Transform>  _worldTransforms;
+            std::vector<u8>         _queued;
+            std::vector<u32>        _dirty; //Indices to update
+        };
+
+        static u32 makeHandle(u32 level, u32 index);
+        static u32 getLevel(u32 handle);
+        static u32 getIndex(u32 handle);
+
+        void enqueue(u32 handle);
+
+        std::vector<Level>      m_levels;
+        std::vector<SceneNode*> m_dirtyNodes; //Nodes are kept instead of the handles, a handle can be changed by a removal
+        u32                     m_count;
+    };
+
+    inline u32 TransformHierarchy::makeHandle(u32 level, u32 index)
+    {
+        ASSERT(index <= k_indexMask && level < (1 << (32 - k_levelShift)), "out of range");
+        return (level << k_levelShift) | index;
+    }
+
+    inline u32 TransformHierarchy::getLevel(u32 handle)
+    {
+        return handle >> k_levelShift;
+    }
+
+    inline u32 TransformHierarchy::getIndex(u32 handle)
+    {
+        return handle & k_indexMask;
+    }
+
+    inline Transform& TransformHierarchy::getLocalTransform(u32 handle)
+    {
+        ASSERT(getLevel(handle) < m_levels.size() && getIndex(handle) < m_levels[getLevel(handle)]._nodes.size(), "invalid handle");
+        return m_levels[getLevel(handle)]._localTransforms[getIndex(handle)];
+    }
+
+    inline const Transform& TransformHierarchy::getLocalTransform(u32 handle) const
+    {
+        ASSERT(getLevel(handle) < m_levels.size() && getIndex(handle) < m_levels[getLevel(handle)]._nodes.size(), "invalid handle");
+        return m_levels[getLevel(handle)]._localTransforms[getIndex(handle)];
+    }
+
+    inline const Transform& TransformHierarchy::getWorldTransform(u32 handle) const
+    {
+        ASSERT(getLevel(handle) < m_levels.size() && getIndex(handle) < m_levels[getLevel(handle)]._nodes.size(), "invalid handle");
+        return m_levels[getLevel(handle)]._worldTransforms[getIndex(handle)];
+    }
+
+    inline u32 TransformHierarchy::getParent(u32 handle) const
+    {
+        ASSERT(getLevel(handle) < m_levels.size() && getIndex(handle) < m_levels[getLevel(handle)]._nodes.size(), "invalid handle");
+        return m_levels[getLevel(handle)]._parents[getIndex(handle)];
+    }
+
+    inline u32 TransformHierarchy::getCount() const
+    {
+        return m_count;
+    }
+
+    inline u32 TransformHierarchy::getLevelCount() const
+    {
+        return static_cast<u32>(m_levels.size());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace scene
+} //namespace v3d
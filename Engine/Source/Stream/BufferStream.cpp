@@ -0,0 +1,494 @@
+#include "BufferStream.h"
+#include "Thread/ThreadSafeAllocator.h"
+#include "Utils/Logger.h"
+
+namespace v3d
+{
+namespace stream
+{
+
+BufferStream::BufferStream(u64 chunkSize) noexcept
+    : m_storage(Storage::Chunked)
+    , m_allocator(nullptr)
+    , m_chunkSize(chunkSize)
+    , m_length(0)
+    , m_pos(0)
+    , m_mapMemory(nullptr)
+    , m_mapped(false)
+{
+    ASSERT(m_chunkSize > 0, "invalid chunk size");
+}
+
+BufferStream::BufferStream(void* buffer, u64 capacity, u64 size) noexcept
+    : m_storage(Storage::External)
+    , m_allocator(nullptr)
+    , m_chunkSize(capacity)
+    , m_length(size)
+    , m_pos(0)
+    , m_mapMemory(nullptr)
+    , m_mapped(false)
+{
+    ASSERT(buffer && capacity > 0 && size <= capacity, "invalid buffer");
+    m_chunks.push_back(reinterpret_cast<u8*>(buffer));
+}
+
+BufferStream::BufferStream(thread::ThreadSafeAllocator* allocator, u64 chunkSize) noexcept
+    : m_storage(Storage::Arena)
+    , m_allocator(allocator)
+    , m_chunkSize(chunkSize)
+    , m_length(0)
+    , m_pos(0)
+    , m_mapMemory(nullptr)
+    , m_mapped(false)
+{
+    ASSERT(m_allocator && m_chunkSize > 0, "invalid allocator");
+}
+
+BufferStream::BufferStream(BufferStream&& stream) noexcept
+    : m_storage(stream.m_storage)
+    , m_allocator(stream.m_allocator)
+    , m_chunks(std::move(stream.m_chunks))
+    , m_chunkSize(stream.m_chunkSize)
+    , m_length(stream.m_length)
+    , m_pos(stream.m_pos)
+    , m_mapMemory(nullptr)
+    , m_mapped(false)
+{
+    ASSERT(!stream.m_mapped, "data is mapped");
+    stream.m_chunks.clear();
+    stream.m_length = 0;
+    stream.m_pos = 0;
+}
+
+BufferStream& BufferStream::operator=(BufferStream&& stream) noexcept
+{
+    if (this == &stream)
+    {
+        return *this;
+    }
+
+    ASSERT(!m_mapped && !stream.m_mapped, "data is mapped");
+    BufferStream::release();
+
+    m_storage = stream.m_storage;
+    m_allocator = stream.m_allocator;
+    m_chunks = std::move(stream.m_chunks);
+    m_chunkSize = stream.m_chunkSize;
+    m_length = stream.m_length;
+    m_pos = stream.m_pos;
+
+    stream.m_chunks.clear();
+    stream.m_length = 0;
+    stream.m_pos = 0;
+
+    return *this;
+}
+
+BufferStream::~BufferStream() noexcept
+{
+    ASSERT(!m_mapped, "data is mapped");
+    BufferStream::release();
+}
+
+void BufferStream::close()
+{
+    //nothing
+}
+
+u64 BufferStream::read64(void* buffer, u64 size) const
+{
+    ASSERT(m_pos + size <= m_length, "Invalid memory size");
+
+    u8* dst = reinterpret_cast<u8*>(buffer);
+    u64 copied = 0;
+    while (copied < size)
+    {
+        std::span<const u8> chunk = BufferStream::view(size - copied);
+        if (chunk.empty())
+        {
+            break;
+        }
+
+        memcpy(dst + copied, chunk.data(), chunk.size());
+        copied += chunk.size();
+    }
+
+    return copied;
+}
+
+u64 BufferStream::write64(const void* buffer, u64 size)
+{
+    ASSERT(!m_mapped, "data is mapped");
+
+    const u8* src = reinterpret_cast<const u8*>(buffer);
+    u64 copied = 0;
+    while (copied < size)
+    {
+        const u64 offset = m_pos % m_chunkSize;
+        u8* chunk = BufferStream::getChunk(m_pos / m_chunkSize);
+        if (!chunk)
+        {
+            LOG_ERROR("BufferStream::write64: storage is full, written %llu from %llu", copied, size);
+            break;
+        }
+
+        const u64 bytes = std::min(size - copied, m_chunkSize - offset);
+        memcpy(chunk + offset, src + copied, bytes);
+        copied += bytes;
+        m_pos += bytes;
+    }
+    m_length = std::max(m_length, m_pos);
+
+    return copied;
+}
+
+std::span<const u8> BufferStream::view(u64 size) const
+{
+    if (m_pos >= m_length || size == 0)
+    {
+        return {};
+    }
+
+    const u64 offset = m_pos % m_chunkSize;
+    const u64 bytes = std::min({ size, m_length - m_pos, m_chunkSize - offset });
+    const u8* chunk = m_chunks[m_pos / m_chunkSize];
+    m_pos += bytes;
+
+    return { chunk + offset, static_cast<size_t>(bytes) };
+}
+
+void BufferStream::seek64(u64 offset) const
+{
+    ASSERT(offset <= m_length, "Invalid memory size");
+    m_pos = offset;
+}
+
+template<typename T>
+u32 BufferStream::writeValue(T value)
+{
+    static_assert(std::is_unsigned<T>::value, "must be unsigned");
+
+    u8 bytes[sizeof(T)];
+    for (u32 i = 0; i < sizeof(T); ++i)
+    {
+        bytes[i] = static_cast<u8>((value >> ((sizeof(T) - 1 - i) * 8)) & 0xFF);
+    }
+
+    return static_cast<u32>(BufferStream::write64(bytes, sizeof(T)));
+}
+
+template<typename T>
+u32 BufferStream::readValue(T& value) const
+{
+    static_assert(std::is_unsigned<T>::value, "must be unsigned");
+
+    u8 bytes[sizeof(T)];
+    const u32 ret = static_cast<u32>(BufferStream::read64(bytes, sizeof(T)));
+
+    value = 0;
+    for (u32 i = 0; i < sizeof(T); ++i)
+    {
+        value = static_cast<T>((value << 8) | bytes[i]);
+    }
+
+    return ret;
+}
+
+u32 BufferStream::read(void* buffer, u32 size, u32 count) const
+{
+    return static_cast<u32>(BufferStream::read64(buffer, static_cast<u64>(size) * count));
+}
+
+u32 BufferStream::read(u8& value) const
+{
+    return BufferStream::readValue(value);
+}
+
+u32 BufferStream::read(s8& value) const
+{
+    return BufferStream::readValue(reinterpret_cast<u8&>(value));
+}
+
+u32 BufferStream::read(u16& value) const
+{
+    return BufferStream::readValue(value);
+}
+
+u32 BufferStream::read(s16& value) const
+{
+    return BufferStream::readValue(reinterpret_cast<u16&>(value));
+}
+
+u32 BufferStream::read(u32& value) const
+{
+    return BufferStream::readValue(value);
+}
+
+u32 BufferStream::read(s32& value) const
+{
+    return BufferStream::readValue(reinterpret_cast<u32&>(value));
+}
+
+u32 BufferStream::read(u64& value) const
+{
+    return BufferStream::readValue(value);
+}
+
+u32 BufferStream::read(s64& value) const
+{
+    return BufferStream::readValue(reinterpret_cast<u64&>(value));
+}
+
+u32 BufferStream::read(f32& value) const
+{
+    u32 data = 0;
+    const u32 ret = BufferStream::readValue(data);
+    memcpy(&value, &data, sizeof(f32));
+
+    return ret;
+}
+
+u32 BufferStream::read(f64& value) const
+{
+    u64 data = 0;
+    const u32 ret = BufferStream::readValue(data);
+    memcpy(&value, &data, sizeof(f64));
+
+    return ret;
+}
+
+u32 BufferStream::read(f80& value) const
+{
+    //Stored as f64, same as MemoryStream
+    f64 data = 0.0;
+    const u32 ret = BufferStream::read(data);
+    value = static_cast<f80>(data);
+
+    return ret;
+}
+
+u32 BufferStream::read(bool& value) const
+{
+    u8 data = 0;
+    const u32 ret = BufferStream::readValue(data);
+    value = data != 0;
+
+    return ret;
+}
+
+u32 BufferStream::read(std::string& value) const
+{
+    u32 size = 0;
+    u32 ret = BufferStream::read(size);
+
+    value.clear();
+    value.resize(size);
+    if (size > 0)
+    {
+        ret += static_cast<u32>(BufferStream::read64(value.data(), size));
+    }
+
+    return ret;
+}
+
+u32 BufferStream::write(const void* buffer, u32 size, u32 count)
+{
+    return static_cast<u32>(BufferStream::write64(buffer, static_cast<u64>(size) * count));
+}
+
+u32 BufferStream::write(u8 value)
+{
+    return BufferStream::writeValue(value);
+}
+
+u32 BufferStream::write(s8 value)
+{
+    return BufferStream::writeValue(static_cast<u8>(value));
+}
+
+u32 BufferStream::write(u16 value)
+{
+    return BufferStream::writeValue(value);
+}
+
+u32 BufferStream::write(s16 value)
+{
+    return BufferStream::writeValue(static_cast<u16>(value));
+}
+
+u32 BufferStream::write(u32 value)
+{
+    return BufferStream::writeValue(value);
+}
+
+u32 BufferStream::write(s32 value)
+{
+    return BufferStream::writeValue(static_cast<u32>(value));
+}
+
+u32 BufferStream::write(u64 value)
+{
+    return BufferStream::writeValue(value);
+}
+
+u32 BufferStream::write(s64 value)
+{
+    return BufferStream::writeValue(static_cast<u64>(value));
+}
+
+u32 BufferStream::write(f32 value)
+{
+    u32 data = 0;
+    memcpy(&data, &value, sizeof(u32));
+
+    return BufferStream::writeValue(data);
+}
+
+u32 BufferStream::write(f64 value)
+{
+    u64 data = 0;
+    memcpy(&data, &value, sizeof(u64));
+
+    return BufferStream::writeValue(data);
+}
+
+u32 BufferStream::write(f80 value)
+{
+    //Stored as f64, same as MemoryStream
+    return BufferStream::write(static_cast<f64>(value));
+}
+
+u32 BufferStream::write(bool value)
+{
+    return BufferStream::writeValue(static_cast<u8>(value ? 1 : 0));
+}
+
+u32 BufferStream::write(const std::string& value)
+{
+    u32 ret = BufferStream::write(static_cast<u32>(value.size()));
+    if (!value.empty())
+    {
+        ret += static_cast<u32>(BufferStream::write64(value.data(), value.size()));
+    }
+
+    return ret;
+}
+
+void BufferStream::seekBeg(u32 offset) const
+{
+    BufferStream::seek64(offset);
+}
+
+void BufferStream::seekEnd(u32 offset) const
+{
+    ASSERT(offset == 0, "Invalid memory size");
+    m_pos = m_length;
+}
+
+void BufferStream::seekCur(u32 offset) const
+{
+    BufferStream::seek64(m_pos + offset);
+}
+
+u32 BufferStream::tell() const
+{
+    ASSERT(m_pos <= std::numeric_limits<u32>::max(), "position is out of u32 range, use tell64");
+    return static_cast<u32>(m_pos);
+}
+
+u32 BufferStream::size() const
+{
+    ASSERT(m_length <= std::numeric_limits<u32>::max(), "size is out of u32 range, use size64");
+    return static_cast<u32>(m_length);
+}
+
+u8* BufferStream::map(u32 size) const
+{
+    ASSERT(!m_mapped, "already mapped");
+    const u64 mapSize = (size == ~1) ? m_length - m_pos : size;
+    ASSERT(mapSize > 0 && m_pos + mapSize <= m_length, "Invalid memory size");
+
+    const u64 offset = m_pos % m_chunkSize;
+    u8* memory = nullptr;
+    if (offset + mapSize <= m_chunkSize)
+    {
+        memory = m_chunks[m_pos / m_chunkSize] + offset;
+    }
+    else
+    {
+        //The range crosses chunks
+        m_mapMemory = reinterpret_cast<u8*>(V3D_MALLOC(mapSize, memory::MemoryLabel::MemoryDynamic));
+
+        const u64 pos = m_pos;
+        BufferStream::read64(m_mapMemory, mapSize);
+        m_pos = pos;
+
+        memory = m_mapMemory;
+    }
+    m_mapped = true;
+
+    return memory;
+}
+
+void BufferStream::unmap() const
+{
+    ASSERT(m_mapped, "Memory not mapped");
+    if (m_mapMemory)
+    {
+        V3D_FREE(m_mapMemory, memory::MemoryLabel::MemoryDynamic);
+        m_mapMemory = nullptr;
+    }
+    m_mapped = false;
+}
+
+bool BufferStream::isMapped() const
+{
+    return m_mapped;
+}
+
+u8* BufferStream::getChunk(u64 index)
+{
+    if (index < m_chunks.size())
+    {
+        return m_chunks[index];
+    }
+    ASSERT(index == m_chunks.size(), "chunks must be dense");
+
+    u8* chunk = nullptr;
+    switch (m_storage)
+    {
+    case Storage::Chunked:
+        chunk = reinterpret_cast<u8*>(V3D_MALLOC(m_chunkSize, memory::MemoryLabel::MemoryDynamic));
+        break;
+
+    case Storage::Arena:
+        chunk = reinterpret_cast<u8*>(m_allocator->allocate(m_chunkSize)._ptr);
+        break;
+
+    case Storage::External:
+        return nullptr;
+    }
+
+    ASSERT(chunk, "nullptr");
+    m_chunks.push_back(chunk);
+
+    return chunk;
+}
+
+void BufferStream::release()
+{
+    if (m_storage == Storage::Chunked)
+    {
+        for (u8* chunk : m_chunks)
+        {
+            V3D_FREE(chunk, memory::MemoryLabel::MemoryDynamic);
+        }
+    }
+    m_chunks.clear();
+
+    m_length = 0;
+    m_pos = 0;
+}
+
+} //namespace stream
+} //namespace v3d
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Stream.h"
+#include <span>
+
+namespace v3d
+{
+namespace thread
+{
+    class ThreadSafeAllocator;
+} //namespace thread
+
+namespace stream
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief BufferStream class. Memory stream with 64 bit sizes and a pluggable storage.
+    * Chunked storage grows by fixed chunks, written data is never reallocated or copied.
+    * External storage writes to a caller buffer of a fixed capacity.
+    * Arena storage takes chunks from a ThreadSafeAllocator, the arena owner resets them.
+    * Values are encoded in the same byte order as MemoryStream
+    */
+    class V3D_API BufferStream final : public Stream
+    {
+    public:
+
+        /**
+        * @brief Storage enum
+        */
+        enum class Storage : u32
+        {
+            Chunked,
+            External,
+            Arena
+        };
+
+        static constexpr u64 k_defaultChunkSize = 256 * 1024;
+
+        explicit BufferStream(u64 chunkSize = k_defaultChunkSize) noexcept;
+        explicit BufferStream(void* buffer, u64 capacity, u64 size = 0) noexcept;
+        explicit BufferStream(thread::ThreadSafeAllocator* allocator, u64 chunkSize = k_defaultChunkSize) noexcept;
+        BufferStream(BufferStream&& stream) noexcept;
+        BufferStream& operator=(BufferStream&& stream) noexcept;
+        ~BufferStream() noexcept;
+
+        void close() override;
+
+        u32 read(void* buffer, u32 size, u32 count = 1) const override;
+        u32 read(u8& value) const override;
+        u32 read(s8& value) const override;
+        u32 read(u16& value) const override;
+        u32 read(s16& value) const override;
+        u32 read(u32& value) const override;
+        u32 read(s32& value) const override;
+        u32 read(u64& value) const override;
+        u32 read(s64& value) const override;
+        u32 read(f32& value) const override;
+        u32 read(f64& value) const override;
+        u32 read(f80& value) const override;
+        u32 read(bool& value) const override;
+        u32 read(std::string& value) const override;
+
+        u32 write(const void* buffer, u32 size, u32 count = 1) override;
+        u32 write(u8 value) override;
+        u32 write(s8 value) override;
+        u32 write(u16 value) override;
+        u32 write(s16 value) override;
+        u32 write(u32 value) override;
+        u32 write(s32 value) override;
+        u32 write(u64 value) override;
+        u32 write(s64 value) override;
+        u32 write(f32 value) override;
+        u32 write(f64 value) override;
+        u32 write(f80 value) override;
+        u32 write(bool value) override;
+        u32 write(const std::string& value) override;
+
+        void seekBeg(u32 offset) const override;
+        void seekEnd(u32 offset) const override;
+        void seekCur(u32 offset) const override;
+        u32 tell() const override;
+        u32 size() const override;
+
+        /**
+        * @brief map. Returns a pointer to the data without copy if the range is inside one chunk,
+        * otherwise the range is copied to a temporary buffer until unmap
+        */
+        u8* map(u32 size = ~1) const override;
+        void unmap() const override;
+        bool isMapped() const override;
+
+        u64 read64(void* buffer, u64 size) const;
+        u64 write64(const void* buffer, u64 size);
+
+        void seek64(u64 offset) const;
+        u64 tell64() const;
+        u64 size64() const;
+
+        /**
+        * @brief view. Returns the stored data from the current position without copy and moves the position.
+        * The span is shorter than requested on a chunk boundary or the end of the stream, call it again for the rest
+        */
+        std::span<const u8> view(u64 size) const;
+
+        Storage getStorage() const;
+        u64 getChunkSize() const;
+        u32 getChunkCount() const;
+
+    private:
+
+        BufferStream(const BufferStream&) = delete;
+        BufferStream& operator=(const BufferStream&) = delete;
+
+        template<typename T>
+        u32 writeValue(T value);
+
+        template<typename T>
+        u32 readValue(T& value) const;
+
+        u8* getChunk(u64 index);
+        void release();
+
+        Storage                         m_storage;
+        thread::ThreadSafeAllocator*    m_allocator;
+        std::vector<u8*>                m_chunks;
+        u64                             m_chunkSize;
+        u64                             m_length;
+        mutable u64                     m_pos;
+
+        mutable u8*                     m_mapMemory;
+        mutable bool                    m_mapped;
+    };
+
+    inline BufferStream::Storage BufferStream::getStorage() const
+    {
+        return m_storage;
+    }
+
+    inline u64 BufferStream::getChunkSize() const
+    {
+        return m_chunkSize;
+    }
+
+    inline u32 BufferStream::getChunkCount() const
+    {
+        return static_cast<u32>(m_chunks.size());
+    }
+
+    inline u64 BufferStream::tell64() const
+    {
+        return m_pos;
+    }
+
+    inline u64 BufferStream::size64() const
+    {
+        return m_length;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace stream
+} //namespace v3d
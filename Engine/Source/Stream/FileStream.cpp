@@ -15,6 +15,7 @@ FileStream::FileStream() noexcept
     , m_open(false)
     , m_memory(nullptr)
     , m_mapped(false)
+    , m_readOnly(false)
 {
 }
 
@@ -24,6 +25,7 @@ FileStream::FileStream(const std::string& file, OpenMode openMode) noexcept
     , m_open(false)
     , m_memory(nullptr)
     , m_mapped(false)
+    , m_readOnly(false)
 {
     if (!open(file, openMode))
     {
@@ -81,6 +83,7 @@ bool FileStream::open(const std::string& file, OpenMode openMode)
     m_name = file;
     m_file = fopen(m_name.c_str(), mode);
     m_open = m_file != nullptr;
+    m_readOnly = strcmp(mode, "rb") == 0;
     m_size = FileStream::size();
 
     return m_open;
@@ -98,6 +101,7 @@ void FileStream::close()
     m_size = 0;
     m_name.clear();
     m_open = false;
+    m_readOnly = false;
 }
 
 bool FileStream::isOpen() const
@@ -317,6 +321,22 @@ u8* FileStream::map(u32 size) const
         size = FileStream::size();
     }
     ASSERT(size > 0 && FileStream::tell() + size <= FileStream::size(), "Invalid file size");
+
+    if (m_readOnly)
+    {
+        //Zero copy, the pointer is into the page cache
+        const u32 offset = FileStream::tell();
+        m_memory = MappedFileStream::mapView(m_file, offset, size, m_view);
+        if (m_memory)
+        {
+            FileStream::seekBeg(offset + size);
+            m_mapped = true;
+
+            return m_memory;
+        }
+        LOG_WARNING("FileStream::map: file %s can't be mapped, read to memory", m_name.c_str());
+    }
+
     m_memory = reinterpret_cast<u8*>(V3D_MALLOC(size, memory::MemoryLabel::MemoryDynamic));
 
     FileStream::read(m_memory, size);
@@ -328,10 +348,15 @@ u8* FileStream::map(u32 size) const
 void FileStream::unmap() const
 {
     ASSERT(m_mapped, "Memory not mapped");
-    if (m_memory)
+    if (m_view._base)
+    {
+        MappedFileStream::unmapView(m_view);
+    }
+    else if (m_memory)
     {
         V3D_FREE(m_memory, memory::MemoryLabel::MemoryDynamic);
     }
+    m_memory = nullptr;
     m_mapped = false;
 }
 
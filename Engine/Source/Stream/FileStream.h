@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Stream.h"
+#include "MappedFileStream.h"
 
 namespace v3d
 {
@@ -9,7 +10,8 @@ namespace stream
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     /**
-    * @brief FileStream class
+    * @brief FileStream class.
+    * In the read only mode map() returns an OS mapped view of the file instead of a heap copy
     */
     class V3D_API FileStream final : public Stream
     {
@@ -96,6 +98,9 @@ namespace stream
 
         mutable u8*     m_memory;
         mutable bool    m_mapped;
+        bool            m_readOnly;
+
+        mutable MappedFileStream::MapView m_view;
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,416 @@
+#include "MappedFileStream.h"
+#include "Utils/Logger.h"
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_XBOX)
+#   include <io.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace v3d
+{
+namespace stream
+{
+
+constexpr u64 k_sequentialHintSize = 4 * 1024 * 1024;
+
+u8* MappedFileStream::mapView(FILE* file, u64 offset, u64 size, MapView& view)
+{
+    ASSERT(file && size > 0, "invalid region");
+    ASSERT(!view._base, "already mapped");
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_XBOX)
+    SYSTEM_INFO info = {};
+    GetSystemInfo(&info);
+    const u64 granularity = info.dwAllocationGranularity;
+    const u64 alignedOffset = offset & ~(granularity - 1);
+    const u64 viewSize = size + (offset - alignedOffset);
+
+    HANDLE fileHandle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+    HANDLE mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        LOG_ERROR("MappedFileStream::mapView: CreateFileMapping is failed. Error %u", GetLastError());
+        return nullptr;
+    }
+
+    //The view holds a reference to the mapping object
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(alignedOffset >> 32), static_cast<DWORD>(alignedOffset & 0xFFFFFFFF), static_cast<SIZE_T>(viewSize));
+    CloseHandle(mapping);
+    if (!base)
+    {
+        LOG_ERROR("MappedFileStream::mapView: MapViewOfFile is failed. Error %u", GetLastError());
+        return nullptr;
+    }
+
+    if (viewSize >= k_sequentialHintSize)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range = { base, static_cast<SIZE_T>(viewSize) };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    const u64 granularity = static_cast<u64>(sysconf(_SC_PAGESIZE));
+    const u64 alignedOffset = offset & ~(granularity - 1);
+    const u64 viewSize = size + (offset - alignedOffset);
+
+    void* base = mmap(nullptr, viewSize, PROT_READ, MAP_PRIVATE, fileno(file), static_cast<off_t>(alignedOffset));
+    if (base == MAP_FAILED)
+    {
+        LOG_ERROR("MappedFileStream::mapView: mmap is failed. Error %d", errno);
+        return nullptr;
+    }
+
+    if (viewSize >= k_sequentialHintSize)
+    {
+        madvise(base, viewSize, MADV_SEQUENTIAL);
+        madvise(base, viewSize, MADV_WILLNEED);
+    }
+#endif
+
+    view._base = reinterpret_cast<u8*>(base);
+    view._size = viewSize;
+
+    return view._base + (offset - alignedOffset);
+}
+
+void MappedFileStream::unmapView(MapView& view)
+{
+    if (!view._base)
+    {
+        return;
+    }
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_XBOX)
+    UnmapViewOfFile(view._base);
+#else
+    munmap(view._base, view._size);
+#endif
+    view._base = nullptr;
+    view._size = 0;
+}
+
+MappedFileStream::MappedFileStream() noexcept
+    : m_data(nullptr)
+    , m_size(0)
+    , m_pos(0)
+    , m_mapped(false)
+{
+}
+
+MappedFileStream::MappedFileStream(const std::string& file) noexcept
+    : m_data(nullptr)
+    , m_size(0)
+    , m_pos(0)
+    , m_mapped(false)
+{
+    if (!open(file))
+    {
+        LOG_ERROR("Can not map file: %s", file.c_str());
+    }
+}
+
+MappedFileStream::~MappedFileStream() noexcept
+{
+    MappedFileStream::close();
+}
+
+bool MappedFileStream::open(const std::string& file)
+{
+    if (m_data || !m_name.empty())
+    {
+        return true;
+    }
+
+    FILE* handle = fopen(file.c_str(), "rb");
+    if (!handle)
+    {
+        return false;
+    }
+
+    //64 bit size query, ftell returns a 32 bit long on Windows
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_XBOX)
+    const s64 length = _filelengthi64(_fileno(handle));
+#else
+    struct stat info = {};
+    const s64 length = (fstat(fileno(handle), &info) == 0) ? static_cast<s64>(info.st_size) : -1;
+#endif
+    if (length < 0)
+    {
+        LOG_ERROR("MappedFileStream::open: can not get the size of %s", file.c_str());
+        fclose(handle);
+        return false;
+    }
+
+    const u64 size = static_cast<u64>(length);
+    if (size > std::numeric_limits<u32>::max())
+    {
+        LOG_ERROR("MappedFileStream::open: %s has %llu bytes, the stream size is limited by u32", file.c_str(), size);
+        fclose(handle);
+        return false;
+    }
+
+    //The view stays valid after the descriptor is closed
+    bool result = true;
+    if (size > 0)
+    {
+        m_data = MappedFileStream::mapView(handle, 0, size, m_view);
+        result = m_data != nullptr;
+    }
+    fclose(handle);
+
+    if (!result)
+    {
+        return false;
+    }
+
+    m_name = file;
+    m_size = static_cast<u32>(size);
+    m_pos = 0;
+
+    return true;
+}
+
+void MappedFileStream::close()
+{
+    ASSERT(!m_mapped, "mapped");
+    MappedFileStream::unmapView(m_view);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_pos = 0;
+    m_name.clear();
+}
+
+bool MappedFileStream::isOpen() const
+{
+    return !m_name.empty();
+}
+
+u32 MappedFileStream::read(void* buffer, u32 size, u32 count) const
+{
+    ASSERT(MappedFileStream::isOpen(), "File is not opened");
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    //Only whole elements are read, as fread does
+    const u32 elements = std::min(count, (m_size - m_pos) / size);
+    const u32 bytes = elements * size;
+    if (bytes > 0)
+    {
+        memcpy(buffer, m_data + m_pos, bytes);
+        m_pos += bytes;
+    }
+
+    return bytes;
+}
+
+u32 MappedFileStream::read(u8& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(s8& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(u16& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(s16& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(u32& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(s32& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(u64& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(s64& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(f32& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(f64& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(f80& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(bool& value) const
+{
+    return MappedFileStream::read(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::read(std::string& value) const
+{
+    u32 size = 0;
+    u32 ret = MappedFileStream::read(size);
+
+    value.clear();
+    value.resize(size);
+
+    ret += MappedFileStream::read(reinterpret_cast<void*>(value.data()), sizeof(c8), size);
+    return ret;
+}
+
+u32 MappedFileStream::write(const void* buffer, u32 size, u32 count)
+{
+    ASSERT(false, "read only stream");
+    return 0;
+}
+
+u32 MappedFileStream::write(u8 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(s8 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(u16 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(s16 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(u32 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(s32 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(u64 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(s64 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(f32 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(f64 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(f80 value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(bool value)
+{
+    return MappedFileStream::write(&value, sizeof(value), 1);
+}
+
+u32 MappedFileStream::write(const std::string& value)
+{
+    ASSERT(false, "read only stream");
+    return 0;
+}
+
+void MappedFileStream::seekBeg(u32 offset) const
+{
+    ASSERT(offset <= m_size, "Invalid file size");
+    m_pos = offset;
+}
+
+void MappedFileStream::seekEnd(u32 offset) const
+{
+    ASSERT(offset == 0, "Invalid file size");
+    m_pos = m_size;
+}
+
+void MappedFileStream::seekCur(u32 offset) const
+{
+    ASSERT(m_pos + offset <= m_size, "Invalid file size");
+    m_pos += offset;
+}
+
+u32 MappedFileStream::tell() const
+{
+    return m_pos;
+}
+
+u32 MappedFileStream::size() const
+{
+    return m_size;
+}
+
+u8* MappedFileStream::map(u32 size) const
+{
+    ASSERT(!m_mapped, "already mapped");
+    if (size == ~1)
+    {
+        size = MappedFileStream::size();
+    }
+    ASSERT(size > 0 && m_pos + size <= m_size, "Invalid file size");
+
+    u8* memory = m_data + m_pos;
+    m_pos += size;
+    m_mapped = true;
+
+    return memory;
+}
+
+void MappedFileStream::unmap() const
+{
+    ASSERT(m_mapped, "Memory not mapped");
+    m_mapped = false;
+}
+
+bool MappedFileStream::isMapped() const
+{
+    return m_mapped;
+}
+
+const std::string& MappedFileStream::getName() const
+{
+    return m_name;
+}
+
+} //namespace stream
+} //namespace v3d
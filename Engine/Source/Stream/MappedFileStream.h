@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Stream.h"
+
+namespace v3d
+{
+namespace stream
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief MappedFileStream class. Read only file stream over a memory mapped view of the whole file.
+    * Reads copy straight from the page cache, map() returns a pointer into the view without any copy.
+    * The view stays valid until close
+    */
+    class V3D_API MappedFileStream final : public Stream
+    {
+    public:
+
+        /**
+        * @brief MapView struct. OS mapping of a file region
+        */
+        struct MapView
+        {
+            u8* _base = nullptr;
+            u64 _size = 0;
+        };
+
+        /**
+        * @brief mapView. Maps a read only region of an opened file. The offset is aligned down to the allocation granularity,
+        * the result points to the requested offset. Big regions get sequential read ahead hints
+        */
+        static u8* mapView(FILE* file, u64 offset, u64 size, MapView& view);
+        static void unmapView(MapView& view);
+
+        MappedFileStream() noexcept;
+        explicit MappedFileStream(const std::string& file) noexcept;
+        ~MappedFileStream() noexcept;
+
+        bool open(const std::string& file);
+        void close() override;
+
+        bool isOpen() const;
+
+        u32 read(void* buffer, u32 size, u32 count = 1) const override;
+        u32 read(u8& value) const override;
+        u32 read(s8& value) const override;
+        u32 read(u16& value) const override;
+        u32 read(s16& value) const override;
+        u32 read(u32& value) const override;
+        u32 read(s32& value) const override;
+        u32 read(u64& value) const override;
+        u32 read(s64& value) const override;
+        u32 read(f32& value) const override;
+        u32 read(f64& value) const override;
+        u32 read(f80& value) const override;
+        u32 read(bool& value) const override;
+        u32 read(std::string& value) const override;
+
+        u32 write(const void* buffer, u32 size, u32 count = 1) override;
+        u32 write(u8 value) override;
+        u32 write(s8 value) override;
+        u32 write(u16 value) override;
+        u32 write(s16 value) override;
+        u32 write(u32 value) override;
+        u32 write(s32 value) override;
+        u32 write(u64 value) override;
+        u32 write(s64 value) override;
+        u32 write(f32 value) override;
+        u32 write(f64 value) override;
+        u32 write(f80 value) override;
+        u32 write(bool value) override;
+        u32 write(const std::string& value) override;
+
+        void seekBeg(u32 offset) const override;
+        void seekEnd(u32 offset) const override;
+        void seekCur(u32 offset) const override;
+        u32 tell() const override;
+        u32 size() const override;
+
+        u8* map(u32 size = ~1) const override;
+        void unmap() const override;
+        bool isMapped() const override;
+
+        const std::string& getName() const;
+
+    private:
+
+        MappedFileStream(const MappedFileStream&) = delete;
+        MappedFileStream& operator=(const MappedFileStream&) = delete;
+
+        MapView         m_view;
+        u8*             m_data;
+        std::string     m_name;
+
+        u32             m_size;
+        mutable u32     m_pos;
+        mutable bool    m_mapped;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace stream
+} //namespace v3d
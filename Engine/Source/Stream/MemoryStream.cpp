@@ -30,6 +30,20 @@ MemoryStream::MemoryStream(const MemoryStream& stream) noexcept
     }
 }
 
+MemoryStream::MemoryStream(MemoryStream&& stream) noexcept
+    : m_stream(stream.m_stream)
+    , m_length(stream.m_length)
+    , m_allocated(stream.m_allocated)
+    , m_pos(stream.m_pos)
+    , m_mapped(false)
+{
+    ASSERT(!stream.m_mapped, "data is mapped");
+    stream.m_stream = nullptr;
+    stream.m_length = 0;
+    stream.m_allocated = 0;
+    stream.m_pos = 0;
+}
+
 MemoryStream::MemoryStream(const void* data, u32 size) noexcept
     : m_stream(nullptr)
     , m_length(size)
@@ -199,19 +213,13 @@ u32 MemoryStream::read(f64& value) const
 
 u32 MemoryStream::read(f80& value) const
 {
-    ASSERT(m_length - m_pos >= sizeof(f80), "Invalid memory size");
+    //Stored as f64, copied through the bits to keep the optimizer from aliasing them
+    u64 bits = 0;
+    MemoryStream::read(bits);
 
-    s64& ival = *((s64*)&value);
-
-    ival = (m_stream[m_pos++] & 0xFFLL) << 56;
-    ival |= (m_stream[m_pos++] & 0xFFLL) << 48;
-    ival |= (m_stream[m_pos++] & 0xFFLL) << 40;
-    ival |= (m_stream[m_pos++] & 0xFFLL) << 32;
-
-    ival |= (m_stream[m_pos++] & 0xFFLL) << 24;
-    ival |= (m_stream[m_pos++] & 0xFFLL) << 16;
-    ival |= (m_stream[m_pos++] & 0xFFLL) << 8;
-    ival |= (m_stream[m_pos++] & 0xFFLL);
+    f64 data = 0.0;
+    memcpy(&data, &bits, sizeof(f64));
+    value = static_cast<f80>(data);
 
     return m_pos;
 }
@@ -450,22 +458,12 @@ u32 MemoryStream::write(f64 value)
 
 u32 MemoryStream::write(f80 value)
 {
-    if (MemoryStream::checkSize(sizeof(f80)))
-    {
-        s32& ival = *((s32*)&value);
-
-        m_stream[m_pos++] = (ival >> 24) & 0xFF;
-        m_stream[m_pos++] = (ival >> 16) & 0xFF;
-        m_stream[m_pos++] = (ival >> 8) & 0xFF;
-        m_stream[m_pos++] = ival & 0xFF;
-
-        if (m_pos > m_length)
-        {
-            m_length = m_pos;
-        }
-    }
+    //Stored as f64, copied through the bits to keep the optimizer from aliasing them
+    const f64 data = static_cast<f64>(value);
+    u64 bits = 0;
+    memcpy(&bits, &data, sizeof(f64));
 
-    return m_pos;
+    return MemoryStream::write(bits);
 }
 
 u32 MemoryStream::write(bool value)
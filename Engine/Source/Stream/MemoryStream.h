@@ -17,6 +17,7 @@ namespace stream
 
         MemoryStream() noexcept;
         explicit MemoryStream(const MemoryStream& stream) noexcept;
+        MemoryStream(MemoryStream&& stream) noexcept;
         explicit MemoryStream(const void* data, u32 size) noexcept;
         ~MemoryStream() noexcept;
 
@@ -1,5 +1,8 @@
 #include "StreamManager.h"
 #include "MemoryStream.h"
+#include "MappedFileStream.h"
+#include "BufferStream.h"
+#include "Utils/Logger.h"
 
 namespace v3d
 {
@@ -19,6 +22,24 @@ const MemoryStream* StreamManager::createMemoryStream(const std::string& string)
     return memory;
 }
 
+const MappedFileStream* StreamManager::createMappedFileStream(const std::string& file)
+{
+    MappedFileStream* stream = V3D_NEW(MappedFileStream, memory::MemoryLabel::MemoryDynamic)();
+    if (!stream->open(file))
+    {
+        LOG_ERROR("StreamManager::createMappedFileStream: can't map file %s", file.c_str());
+        V3D_DELETE(stream, memory::MemoryLabel::MemoryDynamic);
+        return nullptr;
+    }
+
+    return stream;
+}
+
+BufferStream* StreamManager::createBufferStream(u64 chunkSize)
+{
+    return V3D_NEW(BufferStream, memory::MemoryLabel::MemoryDynamic)(chunkSize);
+}
+
 void StreamManager::destroyStream(const Stream* stream)
 {
     ASSERT(stream, "nullptr");
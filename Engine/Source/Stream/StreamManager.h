@@ -2,6 +2,8 @@
 
 #include "Common.h"
 #include "MemoryStream.h"
+#include "MappedFileStream.h"
+#include "BufferStream.h"
 
 namespace v3d
 {
@@ -19,6 +21,16 @@ namespace stream
         static [[nodiscard]] MemoryStream* createMemoryStream(const void* data = nullptr, const u32 size = 0);
         static [[nodiscard]] const MemoryStream* createMemoryStream(const std::string& string);
 
+        /**
+        * @brief createMappedFileStream. Read only stream over a memory mapped file. Returns nullptr if the file can't be mapped
+        */
+        static [[nodiscard]] const MappedFileStream* createMappedFileStream(const std::string& file);
+
+        /**
+        * @brief createBufferStream. Growable stream with 64 bit sizes, see BufferStream
+        */
+        static [[nodiscard]] BufferStream* createBufferStream(u64 chunkSize = BufferStream::k_defaultChunkSize);
+
         static void destroyStream(const Stream* stream);
     };
 
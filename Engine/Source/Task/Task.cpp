@@ -4,5 +4,21 @@ namespace v3d
 {
 namespace task
 {
+
+const c8* Task::internName(const std::string& name)
+{
+    static std::mutex s_mutex;
+    static std::unordered_set<std::string> s_names;
+
+    std::lock_guard lock(s_mutex);
+    auto found = s_names.find(name);
+    if (found == s_names.end())
+    {
+        found = s_names.emplace(name).first;
+    }
+
+    return found->c_str();
+}
+
 } // namespace task
 } // namespace v3d
\ No newline at end of file
@@ -10,6 +10,7 @@ namespace task
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     class TaskDispatcher;
+    class TaskScheduler;
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -36,6 +37,85 @@ namespace task
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    constexpr u32 k_taskCallableSize = 128;
+    constexpr u32 k_maxTaskSuccessors = 16;
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief TaskCallable class. Keeps a callable in the inline storage, never allocates
+    */
+    template<typename Signature, u32 Size = k_taskCallableSize>
+    class TaskCallable;
+
+    template<typename Result, u32 Size>
+    class TaskCallable<Result(), Size>
+    {
+    public:
+
+        TaskCallable() noexcept
+            : m_invoke(nullptr)
+            , m_destroy(nullptr)
+        {
+        }
+
+        ~TaskCallable()
+        {
+            reset();
+        }
+
+        TaskCallable(const TaskCallable&) = delete;
+        TaskCallable& operator=(const TaskCallable&) = delete;
+
+        template<typename Func>
+        void bind(Func&& func)
+        {
+            using FuncType = std::decay_t<Func>;
+            static_assert(sizeof(FuncType) <= Size, "captures are too big for the inline storage, increase k_taskCallableSize");
+            static_assert(alignof(FuncType) <= alignof(std::max_align_t), "unsupported alignment");
+
+            reset();
+            V3D_PLACMENT_NEW(m_storage, FuncType)(std::forward<Func>(func));
+            m_invoke = [](void* storage) -> Result
+                {
+                    return (*reinterpret_cast<FuncType*>(storage))();
+                };
+            m_destroy = [](void* storage) -> void
+                {
+                    reinterpret_cast<FuncType*>(storage)->~FuncType();
+                };
+        }
+
+        void reset()
+        {
+            if (m_destroy)
+            {
+                m_destroy(m_storage);
+            }
+            m_invoke = nullptr;
+            m_destroy = nullptr;
+        }
+
+        Result operator()()
+        {
+            ASSERT(m_invoke, "must be bound");
+            return m_invoke(m_storage);
+        }
+
+        explicit operator bool() const
+        {
+            return m_invoke != nullptr;
+        }
+
+    private:
+
+        alignas(std::max_align_t) u8 m_storage[Size];
+        Result                      (*m_invoke)(void*);
+        void                        (*m_destroy)(void*);
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
     /**
     * @brief Task struct
     */
@@ -56,55 +136,94 @@ namespace task
         Task() noexcept;
         ~Task() = default;
 
-        template<typename Func, typename ...Args>
+        template<typename Func, typename ...Args> requires (!std::is_convertible_v<Func, std::string_view>)
         void init(Func&& func, Args&& ...args)
         {
-            m_func = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
-            /*m_func = [ifn = std::move(fn)]()
+            resetDependencies();
+            m_func.bind([ifn = std::forward<Func>(func), ...iargs = std::forward<Args>(args)]() mutable -> void
                 {
-                    ifn();
-                };*/
+                    std::invoke(ifn, unwrap(iargs)...);
+                });
         }
 
+        /**
+        * @brief init. The name must be a string literal or an interned string, see Task::internName
+        */
         template<typename Func, typename ...Args>
-        void init(const std::string& name, Func&& func, Args&& ...args)
+        void init(const c8* name, Func&& func, Args&& ...args)
         {
+            init(std::forward<Func>(func), std::forward<Args>(args)...);
             m_name = name;
-            m_func = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
-            /*m_func = [ifn = std::move(fn)]()
-                {
-                    ifn();
-                };*/
+        }
+
+        template<typename Func, typename ...Args>
+        void init(const std::string& name, Func&& func, Args&& ...args)
+        {
+            init(Task::internName(name), std::forward<Func>(func), std::forward<Args>(args)...);
         }
 
         template<typename Func, typename ...Args>
         void cond(Func&& func, Args&& ...args)
         {
-            m_cond = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
-            /*m_cond = [ifn = std::move(fn)]()
+            m_cond.bind([ifn = std::forward<Func>(func), ...iargs = std::forward<Args>(args)]() mutable -> bool
                 {
-                    return ifn();
-                };*/
+                    return std::invoke(ifn, unwrap(iargs)...);
+                });
         }
 
+        /**
+        * @brief reset. Releases captured objects, the task can be reused after that
+        */
+        void reset();
+
+        /**
+        * @brief addDependency. The task is not scheduled until the predecessor is completed.
+        * Must be called before the task is passed to TaskScheduler::executeTask
+        */
+        void addDependency(Task* predecessor);
+
         bool isCompeted() const;
-        const std::string& getName() const;
+        const c8* getName() const;
 
         void waitCompetition();
 
+        /**
+        * @brief internName. Returns a string with the same content that lives until the end of the program
+        */
+        static const c8* internName(const std::string& name);
+
     private:
 
         friend TaskDispatcher;
+        friend TaskScheduler;
+
+        void resetDependencies();
+
+        template<typename T>
+        static T& unwrap(T& arg)
+        {
+            return arg;
+        }
+
+        template<typename T>
+        static T& unwrap(std::reference_wrapper<T>& arg)
+        {
+            return arg.get();
+        }
 
         TaskPriority                m_priority;
         TaskMask                    m_mask;
         std::atomic<Status>         m_result;
-        std::string                 m_name;
-        //TODO own allocator
-        std::function<void()>       m_func;
-        std::function<bool()>       m_cond;
+        const c8*                   m_name;
+        TaskCallable<void()>        m_func;
+        TaskCallable<bool()>        m_cond;
+
+        std::atomic<u32>            m_dependencies; //Unfinished predecessors + 1 for executeTask call
+        u32                         m_successorCount;
+        Task*                       m_successors[k_maxTaskSuccessors];
+        std::vector<Task*>          m_extraSuccessors; //Allocates only if fan-out is bigger than k_maxTaskSuccessors
 
-        std::condition_variable_any m_wait;
+        std::condition_variable     m_wait;
         std::mutex                  m_mutex;
     };
 
@@ -112,7 +231,48 @@ namespace task
         : m_priority(TaskPriority::Normal)
         , m_mask(TaskMask::AnyThread)
         , m_result(Empty)
+        , m_name("")
+        , m_dependencies(1)
+        , m_successorCount(0)
+    {
+    }
+
+    inline void Task::reset()
+    {
+        ASSERT(m_result.load(std::memory_order_relaxed) != Status::Scheduled && m_result.load(std::memory_order_relaxed) != Status::Executing, "must not be in flight");
+        m_func.reset();
+        m_cond.reset();
+        m_name = "";
+        resetDependencies();
+        m_result.store(Status::Empty, std::memory_order_relaxed);
+    }
+
+    inline void Task::addDependency(Task* predecessor)
+    {
+        ASSERT(predecessor && predecessor != this, "invalid predecessor");
+        ASSERT(m_result.load(std::memory_order_relaxed) < Status::Scheduled, "must be added before scheduling");
+
+        std::lock_guard<std::mutex> lock(predecessor->m_mutex);
+        if (!predecessor->isCompeted())
+        {
+            m_dependencies.fetch_add(1, std::memory_order_relaxed);
+            if (predecessor->m_successorCount < k_maxTaskSuccessors)
+            {
+                predecessor->m_successors[predecessor->m_successorCount++] = this;
+            }
+            else
+            {
+                predecessor->m_extraSuccessors.push_back(this);
+            }
+        }
+    }
+
+    inline void Task::resetDependencies()
     {
+        m_dependencies.store(1, std::memory_order_relaxed);
+        m_successorCount = 0;
+        m_extraSuccessors.clear();
+        m_result.store(Status::Created, std::memory_order_relaxed);
     }
 
     inline bool Task::isCompeted() const
@@ -120,7 +280,7 @@ namespace task
         return m_result.load(std::memory_order_relaxed) > Status::Executing;
     }
 
-    inline const std::string& Task::getName() const
+    inline const c8* Task::getName() const
     {
         return m_name;
     }
@@ -8,10 +8,18 @@ namespace v3d
 namespace task
 {
 thread_local u32 TaskDispatcher::s_threadID = 0;
+thread_local const TaskDispatcher* TaskDispatcher::s_dispatcher = nullptr;
+
+constexpr u32 k_workStealingSpinCount = 64;
+constexpr u32 k_waitTaskSpinCount = 64;
 
 TaskDispatcher::TaskDispatcher(u32 numWorkingThreads, DispatcherFlags flags) noexcept
     : m_numCreatedTasks(0)
     , m_numSleepingThreads(0)
+    , m_wakeEpoch(0)
+    , m_numWaitingThreads(0)
+    , m_waitEpoch(0)
+    , m_roundThreadCounter(0)
     , m_flags(flags)
     , m_running(true)
 {
@@ -25,6 +33,18 @@ TaskDispatcher::TaskDispatcher(u32 numWorkingThreads, DispatcherFlags flags) noe
         m_taskQueue.push_back(V3D_NEW(TaskQueue, memory::MemoryLabel::MemorySystem)());
     }
 
+    if (m_flags & WorkStealingScheduler)
+    {
+        //Main thread + workers
+        m_workerContexts.reserve(m_numWorkingThreads + 1);
+        for (u32 index = 0; index < m_numWorkingThreads + 1; ++index)
+        {
+            WorkerContext* context = V3D_NEW(WorkerContext, memory::MemoryLabel::MemorySystem)();
+            context->_randomState = 0x9E3779B9u * (index + 1);
+            m_workerContexts.push_back(context);
+        }
+    }
+
     m_workerThreads.reserve(m_numWorkingThreads);
     for (u32 index = 0; index < m_numWorkingThreads; ++index)
     {
@@ -40,6 +60,9 @@ TaskDispatcher::~TaskDispatcher()
 {
     m_running = false;
     m_waitingCondition.notify_all();
+    m_wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+    m_wakeEpoch.notify_all();
+    ASSERT(m_numWaitingThreads.load(std::memory_order_relaxed) == 0, "must not be waiting");
     for (u32 index = 0; index < m_numWorkingThreads; ++index)
     {
         thread::Thread* thread = m_workerThreads[index];
@@ -55,10 +78,23 @@ TaskDispatcher::~TaskDispatcher()
         V3D_DELETE(queue, memory::MemoryLabel::MemorySystem);
     }
     m_taskQueue.clear();
+
+    for (WorkerContext* context : m_workerContexts)
+    {
+        ASSERT(context->_deque.empty(), "must be empty");
+        V3D_DELETE(context, memory::MemoryLabel::MemorySystem);
+    }
+    m_workerContexts.clear();
 }
 
 void TaskDispatcher::workerThreadLoop()
 {
+    if (m_flags & WorkStealingScheduler)
+    {
+        workStealingThreadLoop();
+        return;
+    }
+
     while (true)
     {
         Task* task = popTask();
@@ -127,6 +163,16 @@ u32 TaskDispatcher::currentWorkerThreadID()
     return TaskDispatcher::s_threadID;
 }
 
+bool TaskDispatcher::isOwnThread() const
+{
+    if (TaskDispatcher::s_dispatcher)
+    {
+        return TaskDispatcher::s_dispatcher == this;
+    }
+
+    return thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId();
+}
+
 void TaskDispatcher::threadEntryPoint(u32 threadID)
 {
     [[maybe_unused]] std::string threadName = "WorkerThread_" + std::to_string(threadID);
@@ -136,13 +182,9 @@ void TaskDispatcher::threadEntryPoint(u32 threadID)
 #if TRACY_ENABLE
     tracy::SetThreadName(threadName.c_str());
 #endif
+    TRACE_PROFILER_THREAD_NAME(threadName);
     TaskDispatcher::s_threadID = threadID + 1;
-
-    if (m_flags & WorkerThreadPerCore)
-    {
-        u32 mask = 1 << TaskDispatcher::s_threadID;
-        m_workerThreads[threadID]->setAffinityMask(mask);
-    }
+    TaskDispatcher::s_dispatcher = this;
 
     workerThreadLoop();
 }
@@ -153,6 +195,11 @@ Task* TaskDispatcher::getTaskFromQueue(u32 id)
 
     ASSERT(id < m_taskQueue.size(), "ragen out");
     TaskQueue* queue = m_taskQueue[id];
+    if (queue->_count.load(std::memory_order_acquire) == 0)
+    {
+        return nullptr;
+    }
+
     std::lock_guard lock(queue->_mutex);
     if (!queue->_tasks.empty())
     {
@@ -171,6 +218,7 @@ Task* TaskDispatcher::getTaskFromQueue(u32 id)
             else
             {
                 task = checkedTask;
+                queue->_count.fetch_sub(1, std::memory_order_release);
                 break;
             }
         }
@@ -179,12 +227,32 @@ Task* TaskDispatcher::getTaskFromQueue(u32 id)
     return task;
 }
 
+void TaskDispatcher::submitTask(Task* task, TaskPriority priority, TaskMask mask)
+{
+    task->m_priority = priority;
+    task->m_mask = mask;
+    task->m_result.store(Task::Status::Waiting, std::memory_order_relaxed);
+
+    //Release the submit reference. The last completed predecessor pushes the task otherwise
+    if (task->m_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        pushTask(task, priority, mask);
+    }
+}
+
 void TaskDispatcher::pushTask(Task* task, TaskPriority priority, TaskMask mask)
 {
     //update task. No need to lock
     task->m_priority = priority;
     task->m_mask = mask;
 
+    //Tasks with a condition are requeued until the condition is met, they stay on the locked queues
+    if ((m_flags & WorkStealingScheduler) && !task->m_cond)
+    {
+        pushTaskToWorkStealingQueue(task);
+        return;
+    }
+
     TaskQueue* queue = nullptr;
     u32 threadID = TaskDispatcher::s_threadID;
 
@@ -209,7 +277,7 @@ void TaskDispatcher::pushTask(Task* task, TaskPriority priority, TaskMask mask)
             u32 starWorkerThread = TaskQueue::WorkerThreadQueue_0;
             if (threadID > 0) //caller thread
             {
-                queue = m_taskQueue[starWorkerThread + threadID];
+                queue = m_taskQueue[TaskQueue::MainThreadQueue + threadID]; //own queue of the worker
             }
             else
             {
@@ -228,17 +296,28 @@ void TaskDispatcher::pushTask(Task* task, TaskPriority priority, TaskMask mask)
     {
         std::lock_guard lock(queue->_mutex);
         queue->_tasks.push(task);
+        queue->_count.fetch_add(1, std::memory_order_release);
         task->m_result.store(Task::Status::Scheduled, std::memory_order_relaxed);
     }
 
-    if (m_numSleepingThreads > 0)
+    if (m_flags & WorkStealingScheduler)
+    {
+        wakeUpThread();
+    }
+    else if (m_numSleepingThreads > 0)
     {
         m_waitingCondition.notify_all();
     }
+    wakeUpWaitingThreads();
 }
 
 Task* TaskDispatcher::popTask()
 {
+    if (m_flags & WorkStealingScheduler)
+    {
+        return popTaskFromWorkStealingQueue();
+    }
+
     Task* task = nullptr;
     u32 threadID = TaskDispatcher::s_threadID;
 
@@ -282,13 +361,83 @@ Task* TaskDispatcher::popTask()
 void TaskDispatcher::run(Task* task)
 {
     task->m_result.store(Task::Status::Executing, std::memory_order_relaxed);
-    task->m_func();
+    {
+        //Names are literals or interned, the pointer outlives the zone
+        TRACE_PROFILER_ZONE(task->getName()[0] ? task->getName() : "Task");
+        task->m_func();
+    }
 
+    u32 successorCount = 0;
+    Task* successors[k_maxTaskSuccessors];
+    std::vector<Task*> extraSuccessors;
     {
         std::lock_guard<std::mutex> lock(task->m_mutex);
-        task->m_result.store(Task::Status::Completed, std::memory_order_relaxed);
+        task->m_result.store(Task::Status::Completed, std::memory_order_release);
+        successorCount = std::exchange(task->m_successorCount, 0);
+        std::copy_n(task->m_successors, successorCount, successors);
+        if (!task->m_extraSuccessors.empty())
+        {
+            std::swap(extraSuccessors, task->m_extraSuccessors);
+        }
+        task->m_wait.notify_all();
+    }
+    //The task can be released by a waiter after that, don't touch it
+    wakeUpWaitingThreads();
+
+    auto releaseSuccessor = [this](Task* successor) -> void
+        {
+            if (successor->m_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                pushTask(successor, successor->m_priority, successor->m_mask);
+            }
+        };
+
+    for (u32 index = 0; index < successorCount; ++index)
+    {
+        releaseSuccessor(successors[index]);
+    }
+
+    for (Task* successor : extraSuccessors)
+    {
+        releaseSuccessor(successor);
     }
-    task->m_wait.notify_all();
+}
+
+void TaskDispatcher::waitTask(Task* task)
+{
+    //Keep executing other tasks instead of sleeping, the waited task may depend on them.
+    //Parks when there is nothing to run, a completed or pushed task wakes it up
+    u32 threadID = TaskDispatcher::isOwnThread() ? TaskDispatcher::s_threadID : k_foreignThreadID;
+    u32 spinCount = 0;
+    while (!task->isCompeted())
+    {
+        if (Task* otherTask = popTask(); otherTask)
+        {
+            run(otherTask);
+            spinCount = 0;
+            continue;
+        }
+
+        if (spinCount < k_waitTaskSpinCount)
+        {
+            ++spinCount;
+            std::this_thread::yield();
+            continue;
+        }
+
+        //Read the epoch before the last check, same as workStealingThreadLoop
+        u32 epoch = m_waitEpoch.load(std::memory_order_seq_cst);
+        m_numWaitingThreads.fetch_add(1, std::memory_order_seq_cst);
+        if (!task->isCompeted() && !hasTasksForThread(threadID))
+        {
+            m_waitEpoch.wait(epoch, std::memory_order_seq_cst);
+        }
+        m_numWaitingThreads.fetch_sub(1, std::memory_order_seq_cst);
+        spinCount = 0;
+    }
+
+    //Sync with the executing thread, it can still hold the lock
+    std::lock_guard<std::mutex> lock(task->m_mutex);
 }
 
 bool TaskDispatcher::wait()
@@ -307,5 +456,233 @@ bool TaskDispatcher::wait()
     return true;
 }
 
+void TaskDispatcher::workStealingThreadLoop()
+{
+    u32 spinCount = 0;
+    while (true)
+    {
+        Task* task = popTaskFromWorkStealingQueue();
+        if (task)
+        {
+            run(task);
+            spinCount = 0;
+            continue;
+        }
+
+        if (!m_running) [[unlikely]]
+        {
+            return;
+        }
+
+        //Spin a little before parking, new tasks usually come in bursts
+        if (spinCount < k_workStealingSpinCount)
+        {
+            ++spinCount;
+            std::this_thread::yield();
+            continue;
+        }
+
+        //Read the epoch before the last check. Any push after it changes the epoch and wait() returns immediately
+        u32 epoch = m_wakeEpoch.load(std::memory_order_seq_cst);
+        m_numSleepingThreads.fetch_add(1, std::memory_order_seq_cst);
+        if (!hasPendingTasks() && m_running)
+        {
+            m_wakeEpoch.wait(epoch, std::memory_order_seq_cst);
+        }
+        m_numSleepingThreads.fetch_sub(1, std::memory_order_seq_cst);
+        spinCount = 0;
+    }
+}
+
+void TaskDispatcher::pushTaskToWorkStealingQueue(Task* task)
+{
+    //The thread id of a foreign thread belongs to another dispatcher, it can't own a deque here
+    const bool ownThread = TaskDispatcher::isOwnThread();
+    u32 threadID = TaskDispatcher::s_threadID;
+    task->m_result.store(Task::Status::Scheduled, std::memory_order_relaxed);
+
+    if (!ownThread || task->m_priority == TaskPriority::High || task->m_mask == TaskMask::MainThread || (task->m_mask == TaskMask::WorkerThread && threadID == 0))
+    {
+        //Foreign queues can't be pushed lock-free. Main thread tasks and the high priority queue use the locked queues,
+        //worker tasks from the main thread or a foreign thread go to the inbox of a worker
+        TaskQueue* queue = nullptr;
+        if (task->m_priority == TaskPriority::High)
+        {
+            queue = m_taskQueue[TaskQueue::HighPriorityQueue];
+        }
+        else if (task->m_mask == TaskMask::MainThread)
+        {
+            queue = m_taskQueue[TaskQueue::MainThreadQueue];
+        }
+        else
+        {
+            u32 queueID = m_roundThreadCounter.fetch_add(1, std::memory_order_relaxed) % m_numWorkingThreads;
+            queue = m_taskQueue[TaskQueue::WorkerThreadQueue_0 + queueID];
+        }
+
+        std::lock_guard lock(queue->_mutex);
+        queue->_tasks.push(task);
+        queue->_count.fetch_add(1, std::memory_order_release);
+    }
+    else
+    {
+        m_workerContexts[threadID]->_deque.push(task);
+    }
+
+    wakeUpThread();
+    wakeUpWaitingThreads();
+}
+
+Task* TaskDispatcher::popTaskFromWorkStealingQueue()
+{
+    Task* task = nullptr;
+
+    // Check priority list first
+    task = TaskDispatcher::getTaskFromQueue(TaskQueue::HighPriorityQueue);
+    if (task)
+    {
+        return task;
+    }
+
+    // A foreign thread has no deque and no inbox here, it only steals
+    if (!TaskDispatcher::isOwnThread())
+    {
+        return stealTask(k_foreignThreadID);
+    }
+    u32 threadID = TaskDispatcher::s_threadID;
+
+    // Own deque, LIFO
+    task = m_workerContexts[threadID]->_deque.pop();
+    if (task)
+    {
+        return task;
+    }
+
+    // Own locked queue. Main thread tasks or the inbox of a worker
+    task = TaskDispatcher::getTaskFromQueue(TaskQueue::MainThreadQueue + threadID);
+    if (task)
+    {
+        return task;
+    }
+
+    if (threadID == 0 && !(m_flags & DispatcherFlag::AllowToMainThreadStealTasks))
+    {
+        ASSERT(thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId(), "main thread");
+        return nullptr;
+    }
+
+    return stealTask(threadID);
+}
+
+Task* TaskDispatcher::stealTask(u32 threadID)
+{
+    u32 numThreads = m_numWorkingThreads + 1; //main thread + workers
+
+    u32 random = 0;
+    if (threadID != k_foreignThreadID)
+    {
+        //xorshift32
+        WorkerContext* context = m_workerContexts[threadID];
+        random = context->_randomState;
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        context->_randomState = random;
+    }
+    else
+    {
+        //A foreign thread has no context, the victims are spread by the shared counter
+        random = static_cast<u32>(m_roundThreadCounter.fetch_add(1, std::memory_order_relaxed));
+    }
+
+    //Start from a random victim, then walk over all of them
+    for (u32 index = 0; index < numThreads; ++index)
+    {
+        u32 victimID = (random + index) % numThreads;
+        if (victimID == threadID)
+        {
+            continue;
+        }
+
+        if (Task* task = m_workerContexts[victimID]->_deque.steal(); task)
+        {
+            return task;
+        }
+
+        //Inboxes of other workers. The main thread queue is never stolen
+        if (victimID > 0)
+        {
+            if (Task* task = TaskDispatcher::getTaskFromQueue(TaskQueue::MainThreadQueue + victimID); task)
+            {
+                return task;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+bool TaskDispatcher::hasPendingTasks() const
+{
+    for (u32 index = 0; index < m_taskQueue.size(); ++index)
+    {
+        if (index == TaskQueue::MainThreadQueue) //workers can't execute it
+        {
+            continue;
+        }
+
+        if (m_taskQueue[index]->_count.load(std::memory_order_seq_cst) > 0)
+        {
+            return true;
+        }
+    }
+
+    for (const WorkerContext* context : m_workerContexts)
+    {
+        if (!context->_deque.empty())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TaskDispatcher::hasTasksForThread(u32 threadID) const
+{
+    if (threadID > 0 || (m_flags & DispatcherFlag::AllowToMainThreadStealTasks))
+    {
+        return hasPendingTasks() || (threadID == 0 && m_taskQueue[TaskQueue::MainThreadQueue]->_count.load(std::memory_order_seq_cst) > 0);
+    }
+
+    //The main thread runs only the high priority tasks and own ones
+    if (m_taskQueue[TaskQueue::HighPriorityQueue]->_count.load(std::memory_order_seq_cst) > 0 || m_taskQueue[TaskQueue::MainThreadQueue]->_count.load(std::memory_order_seq_cst) > 0)
+    {
+        return true;
+    }
+
+    return !m_workerContexts.empty() && !m_workerContexts[0]->_deque.empty();
+}
+
+void TaskDispatcher::wakeUpWaitingThreads()
+{
+    //Pairs with the increment in waitTask, the completion or the push must be visible before the counter is read
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_numWaitingThreads.load(std::memory_order_seq_cst) > 0)
+    {
+        m_waitEpoch.fetch_add(1, std::memory_order_seq_cst);
+        m_waitEpoch.notify_all();
+    }
+}
+
+void TaskDispatcher::wakeUpThread()
+{
+    m_wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (m_numSleepingThreads.load(std::memory_order_seq_cst) > 0)
+    {
+        m_wakeEpoch.notify_one();
+    }
+}
+
 } //namespace task
-} //namespace v3d
\ No newline at end of file
+} //namespace v3d
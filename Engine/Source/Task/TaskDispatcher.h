@@ -10,6 +10,69 @@ namespace task
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    /**
+    * @brief TaskRingBuffer class. FIFO of tasks, keeps the memory between frames
+    */
+    class TaskRingBuffer
+    {
+    public:
+
+        TaskRingBuffer() noexcept
+            : m_head(0)
+            , m_size(0)
+        {
+            m_tasks.resize(64);
+        }
+
+        void push(Task* task)
+        {
+            if (m_size == m_tasks.size())
+            {
+                std::vector<Task*> tasks(m_tasks.size() * 2);
+                for (u32 index = 0; index < m_size; ++index)
+                {
+                    tasks[index] = m_tasks[(m_head + index) & (m_tasks.size() - 1)];
+                }
+                std::swap(tasks, m_tasks);
+                m_head = 0;
+            }
+
+            m_tasks[(m_head + m_size) & (m_tasks.size() - 1)] = task;
+            ++m_size;
+        }
+
+        void pop()
+        {
+            ASSERT(m_size > 0, "must be not empty");
+            m_head = (m_head + 1) & (m_tasks.size() - 1);
+            --m_size;
+        }
+
+        Task* front() const
+        {
+            ASSERT(m_size > 0, "must be not empty");
+            return m_tasks[m_head];
+        }
+
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        u32 size() const
+        {
+            return m_size;
+        }
+
+    private:
+
+        std::vector<Task*> m_tasks;
+        u32                m_head;
+        u32                m_size;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
     /**
     * @brief Dispatcher class
     */
@@ -19,8 +82,9 @@ namespace task
 
         enum DispatcherFlag
         {
-            WorkerThreadPerCore,
-            AllowToMainThreadStealTasks
+            WorkerThreadPerCore [[deprecated("has no effect, the workers are not pinned to the cores")]] = 0,
+            AllowToMainThreadStealTasks = 1 << 0,
+            WorkStealingScheduler       = 1 << 1, //Lock-free deque per thread, random victim stealing, spin-then-park idling
         };
 
         typedef u32 DispatcherFlags;
@@ -35,17 +99,26 @@ namespace task
             };
 
             std::mutex          _mutex;
-            std::queue<Task*>   _tasks;
+            TaskRingBuffer      _tasks;
+            std::atomic<u32>    _count = 0; //hint, allows to skip the lock for empty queues
+        };
+
+        struct WorkerContext
+        {
+            thread::ThreadSafeWorkStealingDeque<Task> _deque;
+            u32                                       _randomState = 0;
         };
 
         TaskDispatcher(u32 numWorkingThreads, DispatcherFlags flags) noexcept;
         ~TaskDispatcher();
 
+        void submitTask(Task* task, TaskPriority priority, TaskMask mask);
         void pushTask(Task* task, TaskPriority priority, TaskMask mask);
         Task* popTask();
 
         void run(Task* task);
         bool wait();
+        void waitTask(Task* task);
 
         void workerThreadLoop();
 
@@ -55,25 +128,47 @@ namespace task
         u32 getNumberOfWorkingThreads() const;
         static u32 currentWorkerThreadID();
 
+        /**
+        * @brief isOwnThread. The calling thread is a worker of this dispatcher or the main thread.
+        * The thread ids of the dispatchers overlap, the workers of another dispatcher must not submit or wait tasks here
+        */
+        bool isOwnThread() const;
+
     private:
 
         void threadEntryPoint(u32 threadID);
 
         Task* getTaskFromQueue(u32 id);
 
+        void workStealingThreadLoop();
+        void pushTaskToWorkStealingQueue(Task* task);
+        Task* popTaskFromWorkStealingQueue();
+        Task* stealTask(u32 threadID);
+        bool hasPendingTasks() const;
+        bool hasTasksForThread(u32 threadID) const;
+        void wakeUpThread();
+        void wakeUpWaitingThreads();
+
         u32                          m_numWorkingThreads;
 
         std::vector<TaskQueue*>      m_taskQueue;
+        std::vector<WorkerContext*>  m_workerContexts;
         std::vector<thread::Thread*> m_workerThreads;
         std::atomic<u32>             m_numCreatedTasks;
         std::atomic<u32>             m_numSleepingThreads;
         std::condition_variable_any  m_waitingCondition;
+        std::atomic<u32>             m_wakeEpoch;
+        std::atomic<u32>             m_numWaitingThreads; //Parked in waitTask
+        std::atomic<u32>             m_waitEpoch;
 
         std::atomic<u64>             m_roundThreadCounter;
         DispatcherFlags              m_flags;
-        bool                         m_running;
+        std::atomic_bool             m_running;
+
+        static constexpr u32         k_foreignThreadID = ~0U; //The caller is not a thread of this dispatcher
 
         thread_local static u32      s_threadID;
+        thread_local static const TaskDispatcher* s_dispatcher;
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,60 @@
+#include "TaskPool.h"
+
+namespace v3d
+{
+namespace task
+{
+
+TaskPool::TaskPool(u32 reserveCount) noexcept
+{
+    grow(reserveCount);
+}
+
+TaskPool::~TaskPool()
+{
+    ASSERT(m_freeTasks.size() == m_tasks.size(), "some tasks are not released");
+    for (Task* task : m_tasks)
+    {
+        V3D_DELETE(task, memory::MemoryLabel::MemorySystem);
+    }
+    m_tasks.clear();
+    m_freeTasks.clear();
+}
+
+Task* TaskPool::acquireTask()
+{
+    std::lock_guard lock(m_lock);
+    if (m_freeTasks.empty())
+    {
+        grow(std::max<u32>(static_cast<u32>(m_tasks.size()), 1));
+    }
+
+    Task* task = m_freeTasks.back();
+    m_freeTasks.pop_back();
+
+    return task;
+}
+
+void TaskPool::releaseTask(Task* task)
+{
+    ASSERT(task, "must be valid");
+    task->reset();
+
+    std::lock_guard lock(m_lock);
+    m_freeTasks.push_back(task);
+}
+
+void TaskPool::grow(u32 count)
+{
+    m_tasks.reserve(m_tasks.size() + count);
+    m_freeTasks.reserve(m_tasks.size() + count);
+    for (u32 index = 0; index < count; ++index)
+    {
+        Task* task = V3D_NEW(Task, memory::MemoryLabel::MemorySystem)();
+        m_tasks.push_back(task);
+        m_freeTasks.push_back(task);
+    }
+}
+
+} // namespace task
+} // namespace v3d
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Common.h"
+#include "Task.h"
+#include "Thread/Spinlock.h"
+
+namespace v3d
+{
+namespace task
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief TaskPool class. Recycles Task objects.
+    * Tasks are allocated once and reused, no allocations in the steady state
+    */
+    class TaskPool
+    {
+    public:
+
+        explicit TaskPool(u32 reserveCount = 64) noexcept;
+        ~TaskPool();
+
+        TaskPool(const TaskPool&) = delete;
+        TaskPool& operator=(const TaskPool&) = delete;
+
+        [[nodiscard]] Task* acquireTask();
+        void releaseTask(Task* task);
+
+        u32 getAllocatedCount() const;
+
+    private:
+
+        void grow(u32 count);
+
+        thread::Spinlock   m_lock;
+        std::vector<Task*> m_freeTasks;
+        std::vector<Task*> m_tasks;
+    };
+
+    inline u32 TaskPool::getAllocatedCount() const
+    {
+        return static_cast<u32>(m_tasks.size());
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace task
+} // namespace v3d
\ No newline at end of file
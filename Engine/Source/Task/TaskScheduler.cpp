@@ -15,6 +15,11 @@ u32 TaskScheduler::getNumberOfCoreThreads() const
     return m_dispatcher.getNumberOfWorkingThreads() + 1/*main thread*/;
 }
 
+bool TaskScheduler::isOwnThread() const
+{
+    return m_dispatcher.isOwnThread();
+}
+
 void TaskScheduler::mainThreadLoop()
 {
     ASSERT(thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId(), "must be main thread");
@@ -32,20 +37,20 @@ void TaskScheduler::mainThreadLoop()
 
 void TaskScheduler::executeTask(Task* task, TaskPriority priority, TaskMask mask)
 {
-    m_dispatcher.pushTask(task, priority, mask);
+    m_dispatcher.submitTask(task, priority, mask);
 }
 
-void TaskScheduler::executeTask(std::vector<Task*> tasks, TaskPriority priority, TaskMask mask)
+void TaskScheduler::executeTask(const std::vector<Task*>& tasks, TaskPriority priority, TaskMask mask)
 {
     for (auto& task : tasks)
     {
-        m_dispatcher.pushTask(task, priority, mask);
+        m_dispatcher.submitTask(task, priority, mask);
     }
 }
 
 void TaskScheduler::waitTask(Task* task)
 {
-    task->waitCompetition();
+    m_dispatcher.waitTask(task);
 }
 
 } //namespace task
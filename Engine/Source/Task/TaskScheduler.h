@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "Task.h"
 #include "TaskDispatcher.h"
+#include "TaskPool.h"
 
 namespace v3d
 {
@@ -22,20 +23,174 @@ namespace task
 
         u32 getNumberOfCoreThreads() const;
 
+        /**
+        * @brief isOwnThread. The calling thread is a worker of this scheduler or the main thread, only they may wait the tasks of it
+        */
+        bool isOwnThread() const;
+
         void mainThreadLoop();
 
+        /**
+        * @brief executeTask. Tasks with unfinished dependencies are scheduled by the last completed predecessor
+        */
         void executeTask(Task* task, TaskPriority priority, TaskMask mask);
-        void executeTask(std::vector<Task*> tasks, TaskPriority priority, TaskMask mask);
+        void executeTask(const std::vector<Task*>& tasks, TaskPriority priority, TaskMask mask);
 
+        /**
+        * @brief waitTask. The calling thread executes other tasks until the task is completed
+        */
         void waitTask(Task* task);
 
+        /**
+        * @brief parallelFor. Splits [begin, end) into chunks of grain elements and calls func(chunkBegin, chunkEnd) for each of them.
+        * Chunks are taken dynamically by the worker threads and the calling thread. Returns when all chunks are done.
+        * Grain 0 selects the size by the number of threads
+        */
+        template<typename Func>
+        void parallelFor(u32 begin, u32 end, u32 grain, Func&& func);
+
+        /**
+        * @brief parallelReduce. Same splitting as parallelFor, func(chunkBegin, chunkEnd, value) returns the value accumulated over the chunk.
+        * Partial values are combined by reduce(left, right), it must be associative and commutative
+        */
+        template<typename Type, typename Func, typename Reduce>
+        Type parallelReduce(u32 begin, u32 end, u32 grain, const Type& identity, Func&& func, Reduce&& reduce);
+
     private:
 
+        template<typename Func>
+        void parallelExecute(u32 begin, u32 end, u32 grain, Func&& func);
+
+        u32 computeGrain(u32 count, u32 grain) const;
+
         TaskDispatcher m_dispatcher;
+        TaskPool       m_taskPool;
     };
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    constexpr u32 k_maxParallelTasks = 64;
+    constexpr u32 k_parallelChunksPerThread = 4;
+
+    inline u32 TaskScheduler::computeGrain(u32 count, u32 grain) const
+    {
+        if (grain > 0)
+        {
+            return grain;
+        }
+
+        return std::max<u32>(count / (getNumberOfCoreThreads() * k_parallelChunksPerThread), 1);
+    }
+
+    template<typename Func>
+    inline void TaskScheduler::parallelExecute(u32 begin, u32 end, u32 grain, Func&& func)
+    {
+        struct Context
+        {
+            std::atomic<u64> _nextChunk; //Every participant takes one index past the end, u32 could wrap to 0
+            u32              _numChunks;
+        };
+
+        //u64, begin + chunk * grain and count + grain overflow u32 near the end of the range
+        const u64 count = end - begin;
+        Context context;
+        context._nextChunk.store(0, std::memory_order_relaxed);
+        context._numChunks = static_cast<u32>((count + grain - 1) / grain);
+
+        //The participant index allows to keep the state per thread without locks
+        auto body = [&context, &func, begin, end, grain](u32 participant) -> void
+            {
+                while (true)
+                {
+                    const u64 chunk = context._nextChunk.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk >= context._numChunks)
+                    {
+                        break;
+                    }
+
+                    const u64 chunkBegin = static_cast<u64>(begin) + chunk * grain;
+                    const u64 chunkEnd = std::min<u64>(chunkBegin + grain, end);
+                    func(participant, static_cast<u32>(chunkBegin), static_cast<u32>(chunkEnd));
+                }
+            };
+
+        const u32 numHelpers = std::min({ context._numChunks, getNumberOfCoreThreads(), k_maxParallelTasks }) - 1;
+
+        Task* helpers[k_maxParallelTasks];
+        for (u32 index = 0; index < numHelpers; ++index)
+        {
+            Task* task = m_taskPool.acquireTask();
+            task->init("Parallel Job", [&body, index]() -> void
+                {
+                    body(index + 1);
+                });
+
+            helpers[index] = task;
+            executeTask(task, TaskPriority::Normal, TaskMask::WorkerThread);
+        }
+
+        //The calling thread participates too
+        body(0);
+
+        for (u32 index = 0; index < numHelpers; ++index)
+        {
+            waitTask(helpers[index]);
+            m_taskPool.releaseTask(helpers[index]);
+        }
+    }
+
+    template<typename Func>
+    inline void TaskScheduler::parallelFor(u32 begin, u32 end, u32 grain, Func&& func)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        grain = computeGrain(end - begin, grain);
+        if (end - begin <= grain)
+        {
+            func(begin, end);
+            return;
+        }
+
+        parallelExecute(begin, end, grain, [&func](u32 participant, u32 chunkBegin, u32 chunkEnd) -> void
+            {
+                func(chunkBegin, chunkEnd);
+            });
+    }
+
+    template<typename Type, typename Func, typename Reduce>
+    inline Type TaskScheduler::parallelReduce(u32 begin, u32 end, u32 grain, const Type& identity, Func&& func, Reduce&& reduce)
+    {
+        if (begin >= end)
+        {
+            return identity;
+        }
+
+        grain = computeGrain(end - begin, grain);
+        if (end - begin <= grain)
+        {
+            return func(begin, end, identity);
+        }
+
+        std::vector<Type> partials(std::min(getNumberOfCoreThreads(), k_maxParallelTasks), identity);
+        parallelExecute(begin, end, grain, [&func, &partials](u32 participant, u32 chunkBegin, u32 chunkEnd) -> void
+            {
+                partials[participant] = func(chunkBegin, chunkEnd, partials[participant]);
+            });
+
+        Type result = identity;
+        for (const Type& partial : partials)
+        {
+            result = reduce(result, partial);
+        }
+
+        return result;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
 } // namesapce task
 } // namespace v3d
 
@@ -135,6 +135,272 @@ namespace thread
 
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    /**
+    * @brief ThreadSafeWorkStealingDeque class. Chase-Lev deque.
+    * push/pop are allowed only from the owner thread, steal from any thread.
+    * Grows on overflow, retired buffers are kept until destruction because thieves may still read them
+    */
+    template<class T>
+    class ThreadSafeWorkStealingDeque
+    {
+    public:
+
+        explicit ThreadSafeWorkStealingDeque(u32 capacity = 1024) noexcept
+            : m_top(0)
+            , m_bottom(0)
+        {
+            ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0, "must be power of 2");
+            Buffer* buffer = V3D_NEW(Buffer, memory::MemoryLabel::MemorySystem)(capacity);
+            m_retiredBuffers.push_back(buffer);
+            m_buffer.store(buffer, std::memory_order_relaxed);
+        }
+
+        ~ThreadSafeWorkStealingDeque()
+        {
+            for (Buffer* buffer : m_retiredBuffers)
+            {
+                V3D_DELETE(buffer, memory::MemoryLabel::MemorySystem);
+            }
+            m_retiredBuffers.clear();
+        }
+
+        ThreadSafeWorkStealingDeque(const ThreadSafeWorkStealingDeque&) = delete;
+        ThreadSafeWorkStealingDeque& operator=(const ThreadSafeWorkStealingDeque&) = delete;
+
+        void push(T* elem)
+        {
+            s64 bottom = m_bottom.load(std::memory_order_relaxed);
+            s64 top = m_top.load(std::memory_order_acquire);
+            Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+            if (bottom - top > buffer->_mask)
+            {
+                buffer = grow(buffer, top, bottom);
+            }
+
+            buffer->store(bottom, elem);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        T* pop()
+        {
+            s64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer = m_buffer.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            s64 top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom) //empty
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* elem = buffer->load(bottom);
+            if (top == bottom) //last element, race with thieves
+            {
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    elem = nullptr;
+                }
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return elem;
+        }
+
+        T* steal()
+        {
+            s64 top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            s64 bottom = m_bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+            {
+                return nullptr;
+            }
+
+            Buffer* buffer = m_buffer.load(std::memory_order_acquire);
+            T* elem = buffer->load(top);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return nullptr; //lost the race
+            }
+
+            return elem;
+        }
+
+        bool empty() const
+        {
+            s64 top = m_top.load(std::memory_order_relaxed);
+            s64 bottom = m_bottom.load(std::memory_order_relaxed);
+            return bottom <= top;
+        }
+
+    private:
+
+        struct Buffer
+        {
+            explicit Buffer(u32 capacity) noexcept
+                : _mask(static_cast<s64>(capacity) - 1)
+                , _data(capacity)
+            {
+            }
+
+            void store(s64 index, T* elem)
+            {
+                _data[index & _mask].store(elem, std::memory_order_relaxed);
+            }
+
+            T* load(s64 index) const
+            {
+                return _data[index & _mask].load(std::memory_order_relaxed);
+            }
+
+            s64                          _mask;
+            std::vector<std::atomic<T*>> _data;
+        };
+
+        Buffer* grow(Buffer* buffer, s64 top, s64 bottom)
+        {
+            Buffer* newBuffer = V3D_NEW(Buffer, memory::MemoryLabel::MemorySystem)(static_cast<u32>(buffer->_data.size()) * 2);
+            for (s64 index = top; index < bottom; ++index)
+            {
+                newBuffer->store(index, buffer->load(index));
+            }
+
+            m_retiredBuffers.push_back(newBuffer);
+            m_buffer.store(newBuffer, std::memory_order_release);
+
+            return newBuffer;
+        }
+
+        alignas(k_cachelineAlignment) std::atomic<s64>      m_top;
+        alignas(k_cachelineAlignment) std::atomic<s64>      m_bottom;
+        alignas(k_cachelineAlignment) std::atomic<Buffer*>  m_buffer;
+        std::vector<Buffer*>                                m_retiredBuffers;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief ThreadSafeRingBuffer class. Bounded MPMC queue, every cell has own sequence number.
+    * Elements are written and read in place by callbacks, nothing is allocated after construction
+    */
+    template<class T>
+    class ThreadSafeRingBuffer
+    {
+    public:
+
+        explicit ThreadSafeRingBuffer(u32 capacity) noexcept
+            : m_mask(static_cast<u64>(capacity) - 1)
+            , m_cells(capacity)
+            , m_enqueuePos(0)
+            , m_dequeuePos(0)
+        {
+            ASSERT(capacity > 1 && (capacity & (capacity - 1)) == 0, "must be power of 2");
+            for (u32 index = 0; index < capacity; ++index)
+            {
+                m_cells[index]._sequence.store(index, std::memory_order_relaxed);
+            }
+        }
+
+        ThreadSafeRingBuffer(const ThreadSafeRingBuffer&) = delete;
+        ThreadSafeRingBuffer& operator=(const ThreadSafeRingBuffer&) = delete;
+
+        /**
+        * @brief tryEnqueue. Calls write(T&) for a free cell. Returns false if the buffer is full
+        */
+        template<typename Func>
+        bool tryEnqueue(Func&& write)
+        {
+            u64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true)
+            {
+                cell = &m_cells[pos & m_mask];
+                const u64 sequence = cell->_sequence.load(std::memory_order_acquire);
+                const s64 diff = static_cast<s64>(sequence) - static_cast<s64>(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0) //full
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::invoke(write, cell->_data);
+            cell->_sequence.store(pos + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /**
+        * @brief tryDequeue. Calls read(T&) for the oldest cell. Returns false if the buffer is empty
+        */
+        template<typename Func>
+        bool tryDequeue(Func&& read)
+        {
+            u64 pos = m_dequeuePos.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true)
+            {
+                cell = &m_cells[pos & m_mask];
+                const u64 sequence = cell->_sequence.load(std::memory_order_acquire);
+                const s64 diff = static_cast<s64>(sequence) - static_cast<s64>(pos + 1);
+                if (diff == 0)
+                {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0) //empty
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::invoke(read, cell->_data);
+            cell->_sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        u32 capacity() const
+        {
+            return static_cast<u32>(m_mask + 1);
+        }
+
+    private:
+
+        struct Cell
+        {
+            std::atomic<u64> _sequence;
+            T                _data;
+        };
+
+        const u64                                       m_mask;
+        std::vector<Cell>                               m_cells;
+        alignas(k_cachelineAlignment) std::atomic<u64>  m_enqueuePos;
+        alignas(k_cachelineAlignment) std::atomic<u64>  m_dequeuePos;
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
     /**
     * @brief ThreadSafeStack class
     */
@@ -818,6 +818,8 @@ bool ImGuiWidgetHandler::createPipeline(const renderer::RenderPassDesc& renderpa
         m_UIPipeline->setAlphaBlendOp(0, renderer::BlendOperation::BlendOp_Add);
         m_UIPipeline->setDepthWrite(false);
         m_UIPipeline->setDepthTest(false);
+
+        m_device->compilePipeline(*m_UIPipeline);
     }
 
     return true;
@@ -26,6 +26,20 @@ namespace utils
         return (*str) ? fnv1a_hash64(str + 1, (hash ^ static_cast<u8>(*str)) * k_fnv1a_prime_64) : hash;
     }
 
+    /**
+    * @brief fnv1a_hash64_data. Hash of a buffer, the result can be passed as the seed of the next buffer
+    */
+    inline u64 fnv1a_hash64_data(const void* data, u64 size, u64 hash = k_fnv1a_offset_64)
+    {
+        const u8* bytes = reinterpret_cast<const u8*>(data);
+        for (u64 index = 0; index < size; ++index)
+        {
+            hash = (hash ^ bytes[index]) * k_fnv1a_prime_64;
+        }
+
+        return hash;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////
 
     template<UIntType T>
@@ -1,4 +1,6 @@
 #include "Logger.h"
+#include "Thread/Thread.h"
+#include "Thread/ThreadSafeContainers.h"
 
 #if HIGHLIGHTING_LOGS
 #   include "termcolor/include/termcolor/termcolor.hpp"
@@ -49,6 +51,16 @@ Logger::Logger() noexcept
     , m_level(LoggerType::LoggerNotify)
 #endif //defined(DEBUG)
     , m_immediateFlush(true)
+
+    , m_asyncQueue(nullptr)
+    , m_asyncThread(nullptr)
+    , m_async(false)
+    , m_asyncRunning(false)
+    , m_asyncSleeping(false)
+    , m_asyncPolicy(AsyncPolicy::Block)
+    , m_wakeEpoch(0)
+    , m_pendingRecords(0)
+    , m_droppedRecords(0)
 {
     m_fileBuffer.reserve(k_bufferSize);
 
@@ -59,6 +71,13 @@ Logger::Logger() noexcept
 
 Logger::~Logger()
 {
+    setAsyncMode(false);
+    if (m_asyncQueue)
+    {
+        V3D_DELETE(m_asyncQueue, memory::MemoryLabel::MemorySystem);
+        m_asyncQueue = nullptr;
+    }
+
     logFlushToFile();
 
     m_fileBuffer.clear();
@@ -78,14 +97,14 @@ void Logger::createLogFile(const std::string& fileName)
 
 void Logger::log(LoggerType type, u16 maskOut, const char* format, ...)
 {
-    std::lock_guard lock(m_mutex);
-
     if (m_level > type)
     {
         return;
     }
 
 #ifdef PLATFORM_ANDROID
+    std::lock_guard lock(m_mutex);
+
     va_list args;
     va_start(args, format);
     android_log_arg(type, format, args);
@@ -95,18 +114,36 @@ void Logger::log(LoggerType type, u16 maskOut, const char* format, ...)
 
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    s32 length = vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
 
+    //Formatting is done by the caller, the arguments may point to temporary data
+    if (length >= 0 && enqueueRecord(buffer, std::min<u32>(length, sizeof(buffer) - 1), type, maskOut))
+    {
+        return;
+    }
+
     std::string message;
     message.assign(buffer);
 
-    log(message, type, maskOut);
+    std::lock_guard lock(m_mutex);
+    //The long message is written after the records which are queued before it
+    drainRecords();
+    writeMessage(message, type, maskOut);
 #endif
 }
 
 void Logger::flush()
 {
+    //Help the background thread, records which are still in the queue are written here
+    while (m_pendingRecords.load(std::memory_order_acquire) > 0)
+    {
+        if (!processRecords())
+        {
+            std::this_thread::yield();
+        }
+    }
+
     std::lock_guard lock(m_mutex);
 
     logFlushToFile();
@@ -126,15 +163,65 @@ void Logger::setImmediateFlushToFile(bool immediate)
     m_immediateFlush = immediate;
 }
 
-void Logger::log(const std::string& message, LoggerType type, u16 maskOut)
+void Logger::setAsyncMode(bool async, AsyncPolicy policy)
 {
-    std::lock_guard lock(m_mutex);
+    m_asyncPolicy.store(policy, std::memory_order_relaxed);
+    if (m_async.load(std::memory_order_acquire) == async)
+    {
+        return;
+    }
+
+    if (async)
+    {
+        if (!m_asyncQueue)
+        {
+            m_asyncQueue = V3D_NEW(thread::ThreadSafeRingBuffer<LogRecord>, memory::MemoryLabel::MemorySystem)(k_asyncQueueSize);
+        }
 
+        m_asyncRunning.store(true, std::memory_order_release);
+        m_asyncThread = V3D_NEW(thread::Thread, memory::MemoryLabel::MemorySystem)();
+        m_asyncThread->run([this](void*) -> void
+            {
+                asyncEntryPoint();
+            }, nullptr);
+
+        m_async.store(true, std::memory_order_release);
+    }
+    else
+    {
+        //The mode is switched first, a caller which has seen the async mode is already counted in the pending records
+        m_async.store(false, std::memory_order_seq_cst);
+        m_asyncRunning.store(false, std::memory_order_release);
+        wakeUpAsyncThread();
+
+        m_asyncThread->terminate();
+        V3D_DELETE(m_asyncThread, memory::MemoryLabel::MemorySystem);
+        m_asyncThread = nullptr;
+
+        //Drained under the lock by processRecords, the records which are still being queued are waited for
+        flush();
+    }
+}
+
+void Logger::log(const std::string& message, LoggerType type, u16 maskOut)
+{
     if (m_level > type)
     {
         return;
     }
 
+    if (enqueueRecord(message.c_str(), static_cast<u32>(message.size()), type, maskOut))
+    {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+    drainRecords();
+    writeMessage(message, type, maskOut);
+}
+
+void Logger::writeMessage(const std::string& message, LoggerType type, u16 maskOut)
+{
     if (maskOut & LogOut::ConsoleLog)
     {
 #ifdef PLATFORM_ANDROID
@@ -215,6 +302,124 @@ void Logger::logToFile(const std::string& message, LoggerType type)
     m_file.close();
 }
 
+bool Logger::enqueueRecord(const c8* message, u32 length, LoggerType type, u16 maskOut)
+{
+    if (length >= k_asyncMessageSize)
+    {
+        return false;
+    }
+
+    //Counted before the mode check, so setAsyncMode(false) either waits for the record or this call sees the sync mode
+    m_pendingRecords.fetch_add(1, std::memory_order_seq_cst);
+    if (!m_async.load(std::memory_order_seq_cst))
+    {
+        m_pendingRecords.fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+
+    auto writeRecord = [message, length, type, maskOut](LogRecord& record) -> void
+        {
+            record._type = type;
+            record._maskOut = maskOut;
+            record._length = static_cast<u16>(length);
+            memcpy(record._message, message, length);
+        };
+
+    while (!m_asyncQueue->tryEnqueue(writeRecord))
+    {
+        if (m_asyncPolicy.load(std::memory_order_relaxed) == AsyncPolicy::Drop)
+        {
+            m_pendingRecords.fetch_sub(1, std::memory_order_acq_rel);
+            m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        wakeUpAsyncThread();
+        std::this_thread::yield();
+    }
+    wakeUpAsyncThread();
+
+    return true;
+}
+
+bool Logger::processRecords()
+{
+    if (!m_asyncQueue)
+    {
+        return false;
+    }
+
+    //Records are dequeued under the lock, so the order is kept if the queue is drained by flush()
+    std::lock_guard lock(m_mutex);
+
+    return drainRecords();
+}
+
+bool Logger::drainRecords()
+{
+    if (!m_asyncQueue)
+    {
+        return false;
+    }
+
+    u32 count = 0;
+    auto readRecord = [this](const LogRecord& record) -> void
+        {
+            writeMessage(std::string(record._message, record._length), record._type, record._maskOut);
+        };
+
+    while (m_asyncQueue->tryDequeue(readRecord))
+    {
+        ++count;
+    }
+
+    if (u32 dropped = m_droppedRecords.exchange(0, std::memory_order_relaxed); dropped > 0)
+    {
+        writeMessage("Logger: " + std::to_string(dropped) + " messages were dropped, the async queue is full", LoggerType::LoggerWarning, LogOut::ConsoleLog | LogOut::FileLog);
+    }
+
+    if (count > 0)
+    {
+        m_pendingRecords.fetch_sub(count, std::memory_order_acq_rel);
+    }
+
+    return count > 0;
+}
+
+void Logger::asyncEntryPoint()
+{
+    while (true)
+    {
+        if (processRecords())
+        {
+            continue;
+        }
+
+        if (!m_asyncRunning.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        //Read the epoch before the last check. Any push after it changes the epoch and wait() returns immediately
+        u32 epoch = m_wakeEpoch.load(std::memory_order_seq_cst);
+        m_asyncSleeping.store(true, std::memory_order_seq_cst);
+        if (m_pendingRecords.load(std::memory_order_seq_cst) == 0 && m_asyncRunning.load(std::memory_order_seq_cst))
+        {
+            m_wakeEpoch.wait(epoch, std::memory_order_seq_cst);
+        }
+        m_asyncSleeping.store(false, std::memory_order_seq_cst);
+    }
+}
+
+void Logger::wakeUpAsyncThread()
+{
+    m_wakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (m_asyncSleeping.load(std::memory_order_seq_cst))
+    {
+        m_wakeEpoch.notify_one();
+    }
+}
+
 void Logger::logFlushToFile()
 {
     if (m_fileBuffer.empty())
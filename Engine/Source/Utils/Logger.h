@@ -5,6 +5,13 @@
 
 namespace v3d
 {
+namespace thread
+{
+    class Thread;
+
+    template<class T>
+    class ThreadSafeRingBuffer;
+} //namespace thread
 namespace utils
 {
     /////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -40,8 +47,23 @@ namespace utils
             FileLog = 0x02,
         };
 
+        /**
+        * @brief AsyncPolicy enum. What a caller does if the async queue is full
+        */
+        enum class AsyncPolicy : u32
+        {
+            Block,
+            Drop
+        };
+
         void setLogLevel(LoggerType type);
 
+        /**
+        * @brief setAsyncMode. Messages are formatted by the caller and queued without locking,
+        * console and file output is done by a background thread. flush() waits for the queue
+        */
+        void setAsyncMode(bool async, AsyncPolicy policy = AsyncPolicy::Block);
+
         void log(const std::string& message, LoggerType type = LoggerType::LoggerInfo, u16 maskOut = LogOut::ConsoleLog);
         void log(LoggerType type, u16 maskOut, const char* format, ...);
         void flush();
@@ -61,14 +83,21 @@ namespace utils
 
     protected:
 
+        void writeMessage(const std::string& message, LoggerType type, u16 maskOut);
         void logToConsole(const std::string& message, LoggerType type);
         void logToFile(const std::string& message, LoggerType type);
         void logFlushToFile();
 
+        bool enqueueRecord(const c8* message, u32 length, LoggerType type, u16 maskOut);
+        bool processRecords();
+        bool drainRecords(); //m_mutex must be locked
+        void asyncEntryPoint();
+        void wakeUpAsyncThread();
+
         std::string m_logFilename;
         std::ofstream m_file;
 
-        LoggerType m_level;
+        std::atomic<LoggerType> m_level;
 
 #if defined(DEBUG) && !defined(DEVELOPMENT)
         /**
@@ -92,11 +121,39 @@ namespace utils
         const static u32 k_maxMessageSize = 1024;
 #endif
 
+        /**
+        * @brief count of records in the async queue
+        */
+        const static u32 k_asyncQueueSize = 1024;
+
+        /**
+        * @brief maximum size of an async message, longer messages are logged synchronously
+        */
+        const static u32 k_asyncMessageSize = 504;
+
+        struct LogRecord
+        {
+            LoggerType _type;
+            u16        _maskOut;
+            u16        _length;
+            c8         _message[k_asyncMessageSize];
+        };
+
         bool m_immediateFlush;
         std::vector<std::string> m_fileBuffer;
 
         std::recursive_mutex m_mutex;
 
+        thread::ThreadSafeRingBuffer<LogRecord>* m_asyncQueue;
+        thread::Thread*                          m_asyncThread;
+        std::atomic<bool>                        m_async;
+        std::atomic<bool>                        m_asyncRunning;
+        std::atomic<bool>                        m_asyncSleeping;
+        std::atomic<AsyncPolicy>                 m_asyncPolicy;
+        std::atomic<u32>                         m_wakeEpoch;
+        std::atomic<u32>                         m_pendingRecords; //Being queued, queued or being written
+        std::atomic<u32>                         m_droppedRecords;
+
         const static std::string s_loggerType[Logger::LoggerCount];
     };
 
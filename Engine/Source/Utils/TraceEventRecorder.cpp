@@ -0,0 +1,265 @@
+#include "TraceEventRecorder.h"
+#include "Logger.h"
+#include "Thread/Thread.h"
+
+namespace v3d
+{
+namespace utils
+{
+
+std::atomic<bool> TraceEventRecorder::s_capturing = false;
+thread_local TraceEventRecorder::ThreadBuffer* TraceEventRecorder::s_threadBuffer = nullptr;
+
+static void writeEscaped(std::ofstream& file, const c8* string)
+{
+    for (const c8* ch = string; *ch; ++ch)
+    {
+        if (*ch == '"' || *ch == '\\')
+        {
+            file << '\\' << *ch;
+        }
+        else if (static_cast<u8>(*ch) >= 0x20)
+        {
+            file << *ch;
+        }
+    }
+}
+
+TraceEventRecorder::TraceEventRecorder() noexcept
+    : m_generation(0)
+    , m_captureBegin(0)
+    , m_captureEnd(0)
+    , m_framesLeft(0)
+{
+}
+
+TraceEventRecorder::~TraceEventRecorder()
+{
+    s_capturing.store(false, std::memory_order_relaxed);
+
+    std::lock_guard lock(m_mutex);
+    for (ThreadBuffer* buffer : m_buffers)
+    {
+        V3D_DELETE(buffer, memory::MemoryLabel::MemorySystem);
+    }
+    m_buffers.clear();
+}
+
+void TraceEventRecorder::beginCapture(u32 frameCount, const std::string& filename)
+{
+    std::lock_guard lock(m_mutex);
+
+    //Buffers of the previous generation are reset by their owners on the next record
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+    m_frames.clear();
+    m_framesLeft = frameCount;
+    m_filename = filename;
+    m_captureBegin = TraceEventRecorder::now();
+    m_captureEnd = m_captureBegin;
+
+    s_capturing.store(true, std::memory_order_release);
+}
+
+void TraceEventRecorder::endCapture()
+{
+    std::lock_guard lock(m_mutex);
+
+    s_capturing.store(false, std::memory_order_release);
+    m_captureEnd = TraceEventRecorder::now();
+    m_framesLeft = 0;
+}
+
+void TraceEventRecorder::markFrame()
+{
+    if (!TraceEventRecorder::isCapturing())
+    {
+        return;
+    }
+
+    //The capture is stopped and copied under the same lock, a beginCapture from another thread can't reset it in between
+    std::string filename;
+    Snapshot snapshot;
+    {
+        std::lock_guard lock(m_mutex);
+        m_frames.push_back(TraceEventRecorder::now());
+
+        if (m_framesLeft == 0 || --m_framesLeft > 0)
+        {
+            return;
+        }
+
+        s_capturing.store(false, std::memory_order_release);
+        m_captureEnd = TraceEventRecorder::now();
+        filename = m_filename;
+        if (!filename.empty())
+        {
+            snapshot = TraceEventRecorder::takeSnapshot();
+        }
+    }
+
+    if (!filename.empty())
+    {
+        TraceEventRecorder::writeChromeTrace(filename, snapshot);
+    }
+}
+
+void TraceEventRecorder::setThreadName(const std::string& name)
+{
+    ThreadBuffer* buffer = TraceEventRecorder::getThreadBuffer();
+
+    std::lock_guard lock(m_mutex);
+    buffer->_name = name;
+}
+
+void TraceEventRecorder::record(const c8* name, u64 beginTime, u64 endTime)
+{
+    ThreadBuffer* buffer = TraceEventRecorder::getThreadBuffer();
+
+    const u32 generation = m_generation.load(std::memory_order_relaxed);
+    if (buffer->_generation.load(std::memory_order_relaxed) != generation)
+    {
+        if (buffer->_events.empty())
+        {
+            buffer->_events.resize(k_eventsPerThread);
+        }
+        buffer->_count.store(0, std::memory_order_relaxed);
+        buffer->_dropped = 0;
+        buffer->_generation.store(generation, std::memory_order_release);
+    }
+
+    const u32 index = buffer->_count.load(std::memory_order_relaxed);
+    if (index >= k_eventsPerThread)
+    {
+        ++buffer->_dropped;
+        return;
+    }
+
+    Event& event = buffer->_events[index];
+    event._begin = beginTime;
+    event._end = endTime;
+    strncpy(event._name, name, k_maxNameLength - 1);
+    event._name[k_maxNameLength - 1] = '\0';
+
+    buffer->_count.store(index + 1, std::memory_order_release);
+}
+
+bool TraceEventRecorder::saveChromeTrace(const std::string& filename) const
+{
+    Snapshot snapshot;
+    {
+        std::lock_guard lock(m_mutex);
+        snapshot = TraceEventRecorder::takeSnapshot();
+    }
+
+    return TraceEventRecorder::writeChromeTrace(filename, snapshot);
+}
+
+TraceEventRecorder::Snapshot TraceEventRecorder::takeSnapshot() const
+{
+    //The generation is changed only under the lock, so the owners don't reset the buffers of this capture while they are copied
+    const u32 generation = m_generation.load(std::memory_order_relaxed);
+
+    Snapshot snapshot;
+    snapshot._frames = m_frames;
+    snapshot._captureBegin = m_captureBegin;
+    snapshot._dropped = 0;
+    snapshot._threads.reserve(m_buffers.size());
+    for (const ThreadBuffer* buffer : m_buffers)
+    {
+        Snapshot::Thread& thread = snapshot._threads.emplace_back();
+        thread._index = buffer->_index;
+        thread._name = buffer->_name;
+
+        if (buffer->_generation.load(std::memory_order_acquire) != generation)
+        {
+            continue;
+        }
+
+        //Events are published by the release store of the counter
+        const u32 count = buffer->_count.load(std::memory_order_acquire);
+        thread._events.assign(buffer->_events.cbegin(), buffer->_events.cbegin() + count);
+        snapshot._dropped += buffer->_dropped;
+    }
+
+    return snapshot;
+}
+
+bool TraceEventRecorder::writeChromeTrace(const std::string& filename, const Snapshot& snapshot)
+{
+    std::ofstream file(filename, std::ofstream::out | std::ofstream::trunc);
+    if (!file.is_open())
+    {
+        LOG_ERROR("TraceEventRecorder::saveChromeTrace: can't open file %s", filename.c_str());
+        return false;
+    }
+
+    const u64 captureBegin = snapshot._captureBegin;
+    auto toMicroSeconds = [captureBegin](u64 time) -> f64
+        {
+            return static_cast<f64>(time - captureBegin) / 1000.0;
+        };
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"v3d\"}}";
+
+    for (const Snapshot::Thread& thread : snapshot._threads)
+    {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread._index << ",\"args\":{\"name\":\"";
+        writeEscaped(file, thread._name.c_str());
+        file << "\"}}";
+
+        for (const Event& event : thread._events)
+        {
+            if (event._begin < captureBegin)
+            {
+                continue;
+            }
+
+            file << ",\n{\"name\":\"";
+            writeEscaped(file, event._name);
+            file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread._index << ",\"ts\":" << toMicroSeconds(event._begin) << ",\"dur\":" << static_cast<f64>(event._end - event._begin) / 1000.0 << "}";
+        }
+    }
+
+    for (u64 frame : snapshot._frames)
+    {
+        file << ",\n{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":" << toMicroSeconds(frame) << "}";
+    }
+    file << "\n]}\n";
+    file.close();
+
+    if (snapshot._dropped > 0)
+    {
+        LOG_WARNING("TraceEventRecorder::saveChromeTrace: %u events are dropped, thread buffers are full", snapshot._dropped);
+    }
+    LOG_DEBUG("TraceEventRecorder::saveChromeTrace: %s, frames %u", filename.c_str(), static_cast<u32>(snapshot._frames.size()));
+
+    return true;
+}
+
+TraceEventRecorder::ThreadBuffer* TraceEventRecorder::getThreadBuffer()
+{
+    if (s_threadBuffer)
+    {
+        return s_threadBuffer;
+    }
+
+    ThreadBuffer* buffer = V3D_NEW(ThreadBuffer, memory::MemoryLabel::MemorySystem);
+    buffer->_count.store(0, std::memory_order_relaxed);
+    buffer->_generation.store(~0U, std::memory_order_relaxed);
+    buffer->_dropped = 0;
+
+    {
+        std::lock_guard lock(m_mutex);
+        buffer->_index = static_cast<u32>(m_buffers.size());
+        buffer->_name = (thread::Thread::getCurrentThread() == thread::Thread::getMainThreadId()) ? "MainThread" : "Thread_" + std::to_string(buffer->_index);
+        m_buffers.push_back(buffer);
+    }
+
+    s_threadBuffer = buffer;
+    return buffer;
+}
+
+} //namespace utils
+} //namespace v3d
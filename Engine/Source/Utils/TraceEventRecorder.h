@@ -0,0 +1,163 @@
+#pragma once
+
+#include "Common.h"
+#include "Singleton.h"
+
+namespace v3d
+{
+namespace utils
+{
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief TraceEventRecorder class. Collects CPU zones to per thread buffers and writes them in the Chrome trace format.
+    * Works without any viewer attached, the file can be opened in chrome://tracing or https://ui.perfetto.dev.
+    * A zone costs one atomic load while the capture is stopped. Buffers are written only by the owner thread
+    */
+    class V3D_API TraceEventRecorder final : public Singleton<TraceEventRecorder>
+    {
+    public:
+
+        static constexpr u32 k_maxNameLength = 48;
+        static constexpr u32 k_eventsPerThread = 16 * 1024;
+
+        /**
+        * @brief beginCapture. Drops the previous capture.
+        * @param u32 frameCount [optional] stops the capture after the number of frames, 0 means endCapture call
+        * @param const std::string& filename [optional] writes the trace there once frameCount frames are recorded
+        */
+        void beginCapture(u32 frameCount = 0, const std::string& filename = "");
+        void endCapture();
+
+        /**
+        * @brief saveChromeTrace. Writes the last capture as JSON. The events are copied under the lock, a new capture doesn't change the file
+        */
+        bool saveChromeTrace(const std::string& filename) const;
+
+        void markFrame();
+        void setThreadName(const std::string& name);
+
+        void record(const c8* name, u64 beginTime, u64 endTime);
+
+        static bool isCapturing();
+        static u64 now();
+
+    private:
+
+        TraceEventRecorder() noexcept;
+        ~TraceEventRecorder();
+
+        friend Singleton<TraceEventRecorder>;
+        template<class T>
+        friend void memory::internal_delete(T* ptr, v3d::memory::MemoryLabel label, const v3d::c8* file, v3d::u32 line);
+
+        struct Event
+        {
+            u64 _begin;
+            u64 _end;
+            c8  _name[k_maxNameLength];
+        };
+
+        struct ThreadBuffer
+        {
+            std::vector<Event>  _events;
+            std::atomic<u32>    _count;
+            std::atomic<u32>    _generation;
+            u32                 _dropped;
+            u32                 _index;
+            std::string         _name;
+        };
+
+        struct Snapshot
+        {
+            struct Thread
+            {
+                u32                 _index;
+                std::string         _name;
+                std::vector<Event>  _events;
+            };
+
+            std::vector<Thread> _threads;
+            std::vector<u64>    _frames;
+            u64                 _captureBegin;
+            u32                 _dropped;
+        };
+
+        ThreadBuffer* getThreadBuffer();
+
+        Snapshot takeSnapshot() const; //m_mutex must be locked
+        static bool writeChromeTrace(const std::string& filename, const Snapshot& snapshot);
+
+        mutable std::mutex          m_mutex;
+        std::vector<ThreadBuffer*>  m_buffers;
+        std::vector<u64>            m_frames;
+        std::atomic<u32>            m_generation;
+        u64                         m_captureBegin;
+        u64                         m_captureEnd;
+        u32                         m_framesLeft;
+        std::string                 m_filename;
+
+        static std::atomic<bool>            s_capturing;
+        static thread_local ThreadBuffer*   s_threadBuffer;
+    };
+
+    inline bool TraceEventRecorder::isCapturing()
+    {
+        return s_capturing.load(std::memory_order_relaxed);
+    }
+
+    inline u64 TraceEventRecorder::now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * @brief TraceEventScope class. Records a zone from the constructor to the destructor
+    */
+    class TraceEventScope final
+    {
+    public:
+
+        explicit TraceEventScope(const c8* name) noexcept
+            : m_name(name)
+            , m_begin(TraceEventRecorder::isCapturing() ? TraceEventRecorder::now() : 0)
+        {
+        }
+
+        explicit TraceEventScope(const std::string& name) noexcept
+            : m_name(m_copy)
+            , m_begin(TraceEventRecorder::isCapturing() ? TraceEventRecorder::now() : 0)
+        {
+            //The name may be a temporary
+            if (m_begin)
+            {
+                const u32 length = std::min<u32>(static_cast<u32>(name.size()), TraceEventRecorder::k_maxNameLength - 1);
+                memcpy(m_copy, name.c_str(), length);
+                m_copy[length] = '\0';
+            }
+        }
+
+        ~TraceEventScope()
+        {
+            if (m_begin)
+            {
+                TraceEventRecorder::getInstance()->record(m_name, m_begin, TraceEventRecorder::now());
+            }
+        }
+
+        TraceEventScope(const TraceEventScope&) = delete;
+        TraceEventScope& operator=(const TraceEventScope&) = delete;
+
+    private:
+
+        const c8* m_name;
+        u64       m_begin;
+        c8        m_copy[TraceEventRecorder::k_maxNameLength];
+    };
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} //namespace utils
+} //namespace v3d
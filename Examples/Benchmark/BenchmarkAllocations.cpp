@@ -0,0 +1,65 @@
+#include "BenchmarkAllocations.h"
+
+#include <new>
+#include <cstdlib>
+
+namespace
+{
+    std::atomic<v3d::u64> g_heapAllocationCount = 0;
+
+    void* allocateAligned(std::size_t size, std::size_t align)
+    {
+#if defined(PLATFORM_WINDOWS)
+        return _aligned_malloc(size, align);
+#else
+        return std::aligned_alloc(align, (size + align - 1) & ~(align - 1));
+#endif
+    }
+
+    void freeAligned(void* ptr)
+    {
+#if defined(PLATFORM_WINDOWS)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+v3d::u64 heapAllocationCount()
+{
+    return g_heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+//The array, nothrow and sized forms call these ones by default
+void* operator new(std::size_t size)
+{
+    g_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    g_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = allocateAligned(size ? size : 1, static_cast<std::size_t>(align)))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t align) noexcept
+{
+    freeAligned(ptr);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Common.h"
+
+/**
+* @brief heapAllocationCount. Count of the global operator new calls since start, all threads.
+* The benchmark executable replaces the global allocation functions to count them
+*/
+v3d::u64 heapAllocationCount();
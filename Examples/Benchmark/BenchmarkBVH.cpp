@@ -0,0 +1,227 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Scene/BoundingVolumeHierarchy.h"
+#include "Math/Frustum.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_bvhObjectCounts[] = { 10'000, 100'000, 1'000'000 };
+    constexpr f32 k_bvhObjectsPerUnit = 0.01f; //Same density for every count, the world grows with the objects
+    constexpr u32 k_bvhMovedPercent = 10;
+    constexpr u32 k_bvhQueryCount = 1'000;
+    constexpr u32 k_bvhFrustumCount = 32;
+    constexpr u32 k_bvhLinearQueryCount = 16; //The linear scan of 1M objects is slow, it runs only the first queries
+    constexpr f32 k_bvhSphereRadius = 25.f;
+    constexpr f32 k_bvhRayDistance = 500.f;
+    constexpr f32 k_bvhFrustumFar = 200.f;
+
+    struct BVHQueries
+    {
+        std::vector<math::Vector3D> _points;
+        std::vector<math::Vector3D> _directions;
+        std::vector<math::Frustum>  _frustums;
+    };
+
+    bool isInsideSphere(const math::AABB& aabb, const math::Vector3D& center, f32 radius)
+    {
+        const f32 point[3] = { center.getX(), center.getY(), center.getZ() };
+        const f32* min = &aabb.getMin()._x;
+        const f32* max = &aabb.getMax()._x;
+
+        f32 distanceSq = 0.f;
+        for (u32 axis = 0; axis < 3; ++axis)
+        {
+            const f32 delta = std::max(min[axis] - point[axis], 0.f) + std::max(point[axis] - max[axis], 0.f);
+            distanceSq += delta * delta;
+        }
+
+        return distanceSq <= radius * radius;
+    }
+
+    /**
+    * @brief Microseconds per query of the first count queries
+    */
+    template<typename Query>
+    f64 measureQueries(u32 count, Query query)
+    {
+        utils::Timer timer;
+        timer.start();
+        for (u32 index = 0; index < count; ++index)
+        {
+            query(index);
+        }
+        timer.stop();
+
+        return static_cast<f64>(timer.getTime<utils::Timer::Duration_MicroSeconds>()) / static_cast<f64>(count);
+    }
+}
+
+void MyApplication::Benchmark_BoundingVolumeHierarchy()
+{
+    LOG_INFO("Benchmark_BoundingVolumeHierarchy: %u sphere queries and raycasts, %u frustum queries, the linear scan runs %u of them",
+        k_bvhQueryCount, k_bvhFrustumCount, k_bvhLinearQueryCount);
+
+    for (u32 objectCount : k_bvhObjectCounts)
+    {
+        std::mt19937 random(42);
+        const f32 worldSize = std::cbrt(static_cast<f32>(objectCount) / k_bvhObjectsPerUnit);
+        std::uniform_real_distribution<f32> position(-worldSize * 0.5f, worldSize * 0.5f);
+        std::uniform_real_distribution<f32> extent(0.25f, 2.f);
+        std::uniform_real_distribution<f32> offset(-1.f, 1.f);
+        std::uniform_int_distribution<u32> object(0, objectCount - 1);
+
+        std::vector<math::AABB> boxes(objectCount);
+        for (math::AABB& box : boxes)
+        {
+            const math::float3 center(position(random), position(random), position(random));
+            const math::float3 halfSize(extent(random), extent(random), extent(random));
+            box = math::AABB(center - halfSize, center + halfSize);
+        }
+
+        BVHQueries queries;
+        for (u32 index = 0; index < k_bvhQueryCount; ++index)
+        {
+            queries._points.emplace_back(position(random), position(random), position(random));
+            math::Vector3D direction(offset(random), offset(random), offset(random));
+            direction.normalize();
+            queries._directions.push_back(direction);
+        }
+
+        const math::Matrix4D projection = math::SMatrix::projectionMatrixPerspective(60.f * math::k_degToRad, 16.f / 9.f, 0.1f, k_bvhFrustumFar);
+        for (u32 index = 0; index < k_bvhFrustumCount; ++index)
+        {
+            const math::Vector3D target = queries._points[index] + queries._directions[index];
+            const math::Matrix4D view = math::SMatrix::lookAtMatrix(queries._points[index], target, math::Vector3D(0.f, 1.f, 0.f));
+            queries._frustums.emplace_back(projection * view);
+        }
+
+        //Build, one insertion per object
+        scene::BoundingVolumeHierarchy bvh;
+        std::vector<u32> proxies(objectCount);
+
+        utils::Timer buildTimer;
+        buildTimer.start();
+        for (u32 index = 0; index < objectCount; ++index)
+        {
+            proxies[index] = bvh.createProxy(boxes[index], index);
+        }
+        buildTimer.stop();
+
+        //Small moves, the boxes which leave their fat box are reinserted
+        const u32 moveCount = objectCount * k_bvhMovedPercent / 100;
+        std::vector<std::pair<u32, math::AABB>> moves(moveCount);
+        for (auto& [index, box] : moves)
+        {
+            index = object(random);
+            const math::float3 delta(offset(random) * 0.2f, offset(random) * 0.2f, offset(random) * 0.2f);
+            box = math::AABB(boxes[index].getMin() + delta, boxes[index].getMax() + delta);
+        }
+
+        u32 reinserted = 0;
+        utils::Timer moveTimer;
+        moveTimer.start();
+        for (auto& [index, box] : moves)
+        {
+            reinserted += bvh.moveProxy(proxies[index], box) ? 1 : 0;
+        }
+        moveTimer.stop();
+
+        //The tree answers by the fat boxes, the linear scan uses the same boxes
+        std::vector<math::AABB> fatBoxes(objectCount);
+        for (u32 index = 0; index < objectCount; ++index)
+        {
+            fatBoxes[index] = bvh.getFatAABB(proxies[index]);
+        }
+
+        std::vector<u32> treeHits(k_bvhQueryCount);
+        std::vector<u32> linearHits(k_bvhQueryCount);
+        u32 mismatches = 0;
+
+        //Sphere queries, the punctual light case
+        const f64 sphereTree = measureQueries(k_bvhQueryCount, [&](u32 query) -> void
+            {
+                u32 hits = 0;
+                bvh.query(queries._points[query], k_bvhSphereRadius, [&hits](u32 userData) -> bool
+                    {
+                        ++hits;
+                        return true;
+                    });
+                treeHits[query] = hits;
+            });
+
+        const f64 sphereLinear = measureQueries(k_bvhLinearQueryCount, [&](u32 query) -> void
+            {
+                u32 hits = 0;
+                for (const math::AABB& box : fatBoxes)
+                {
+                    hits += isInsideSphere(box, queries._points[query], k_bvhSphereRadius) ? 1 : 0;
+                }
+                linearHits[query] = hits;
+            });
+        mismatches += std::equal(linearHits.cbegin(), linearHits.cbegin() + k_bvhLinearQueryCount, treeHits.cbegin()) ? 0 : 1;
+
+        //Frustum queries, the culling case
+        const f64 frustumTree = measureQueries(k_bvhFrustumCount, [&](u32 query) -> void
+            {
+                u32 hits = 0;
+                bvh.query(queries._frustums[query], [&hits](u32 userData) -> bool
+                    {
+                        ++hits;
+                        return true;
+                    });
+                treeHits[query] = hits;
+            });
+
+        const f64 frustumLinear = measureQueries(k_bvhLinearQueryCount, [&](u32 query) -> void
+            {
+                u32 hits = 0;
+                for (const math::AABB& box : fatBoxes)
+                {
+                    hits += queries._frustums[query].isInside(box) ? 1 : 0;
+                }
+                linearHits[query] = hits;
+            });
+        mismatches += std::equal(linearHits.cbegin(), linearHits.cbegin() + k_bvhLinearQueryCount, treeHits.cbegin()) ? 0 : 1;
+
+        //Raycasts, the picking case
+        const f64 rayTree = measureQueries(k_bvhQueryCount, [&](u32 query) -> void
+            {
+                u32 hits = 0;
+                bvh.raycast(queries._points[query], queries._directions[query], k_bvhRayDistance, [&hits](u32 userData, f32 distance) -> bool
+                    {
+                        ++hits;
+                        return true;
+                    });
+                treeHits[query] = hits;
+            });
+
+        const f64 rayLinear = measureQueries(k_bvhLinearQueryCount, [&](u32 query) -> void
+            {
+                u32 hits = 0;
+                for (const math::AABB& box : fatBoxes)
+                {
+                    hits += scene::BoundingVolumeHierarchy::intersectRay(box, queries._points[query], queries._directions[query], k_bvhRayDistance) >= 0.f ? 1 : 0;
+                }
+                linearHits[query] = hits;
+            });
+        mismatches += std::equal(linearHits.cbegin(), linearHits.cbegin() + k_bvhLinearQueryCount, treeHits.cbegin()) ? 0 : 1;
+
+        LOG_INFO("Benchmark_BoundingVolumeHierarchy %u objects: build %.3f ms, height %u, %u moves %.3f ms (%u reinserted)",
+            objectCount, static_cast<f64>(buildTimer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0, bvh.getHeight(),
+            moveCount, static_cast<f64>(moveTimer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0, reinserted);
+        LOG_INFO("Benchmark_BoundingVolumeHierarchy %u objects, us per query: sphere %.2f (linear %.2f), frustum %.2f (linear %.2f), ray %.2f (linear %.2f)",
+            objectCount, sphereTree, sphereLinear, frustumTree, frustumLinear, rayTree, rayLinear);
+
+        if (mismatches > 0)
+        {
+            LOG_ERROR("Benchmark_BoundingVolumeHierarchy %u objects: %u query kinds differ from the linear scan", objectCount, mismatches);
+            ++m_failures;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include "MyApplication.h"
+#include "BenchmarkScene.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Renderer/Device.h"
+#include "Scene/Material.h"
+#include "Scene/Geometry/Mesh.h"
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_materialCount = 10'000;
+    constexpr u32 k_materialRounds = 5;
+
+    /**
+    * @brief Best of the rounds, in nanoseconds per draw. The record function gets the material of every draw
+    */
+    template<typename Record>
+    f64 measureDrawRecording(const std::vector<scene::Material*>& materials, Record record)
+    {
+        u64 bestTime = ~0ULL;
+        for (u32 round = 0; round < k_materialRounds; ++round)
+        {
+            utils::Timer timer;
+            timer.start();
+
+            for (const scene::Material* material : materials)
+            {
+                record(*material);
+            }
+
+            timer.stop();
+            bestTime = std::min<u64>(bestTime, timer.getTime<utils::Timer::Duration_NanoSeconds>());
+        }
+
+        return static_cast<f64>(bestTime) / static_cast<f64>(materials.size());
+    }
+}
+
+void MyApplication::Benchmark_MaterialParameters()
+{
+    LOG_INFO("Benchmark_MaterialParameters: %u materials, per draw property reads, best of %u rounds", k_materialCount, k_materialRounds);
+
+    renderer::Device* device = renderer::Device::createDevice(renderer::Device::RenderType::Empty, renderer::Device::GraphicMask);
+    scene::Mesh* mesh = scene::MeshHelper::createCube(device, 1.f);
+
+    std::vector<scene::Material*> materials;
+    for (u32 index = 0; index < k_materialCount; ++index)
+    {
+        //The handles are only compared, any object fits
+        scene::Material* material = V3D_NEW(scene::Material, memory::MemoryLabel::MemoryObject)(device);
+        material->setProperty<ObjectHandle>("BaseColor", ObjectHandle(mesh));
+        material->setProperty<ObjectHandle>("Normals", ObjectHandle(mesh));
+        material->setProperty<math::float4>("DiffuseColor", { static_cast<f32>(index), 1.f, 1.f, 1.f });
+        material->setProperty<u32>("materialID", toEnumType(scene::ScenePass::Opaque));
+        materials.push_back(material);
+    }
+
+    //Same reads as the GBuffer pass records per draw, before and after the parameter block
+    f32 propertyChecksum = 0.f;
+    const f64 propertyTime = measureDrawRecording(materials, [&propertyChecksum](const scene::Material& material) -> void
+        {
+            const ObjectHandle albedo = material.getProperty<ObjectHandle>("BaseColor");
+            const ObjectHandle normals = material.getProperty<ObjectHandle>("Normals");
+            const math::float4 tint = material.getProperty<math::float4>("DiffuseColor");
+            propertyChecksum += tint._x + ((albedo._object == normals._object) ? 1.f : 0.f);
+        });
+
+    f32 parameterChecksum = 0.f;
+    const f64 parameterTime = measureDrawRecording(materials, [&parameterChecksum](const scene::Material& material) -> void
+        {
+            const scene::MaterialParameters& parameters = material.getParameters();
+            const ObjectHandle& albedo = parameters._textures[scene::MaterialParameters::BaseColor];
+            const ObjectHandle& normals = parameters._textures[scene::MaterialParameters::Normals];
+            parameterChecksum += parameters._colors[scene::MaterialParameters::DiffuseColor]._x + ((albedo._object == normals._object) ? 1.f : 0.f);
+        });
+
+    LOG_INFO("Benchmark_MaterialParameters: property map %.1f ns per draw, parameter block %.1f ns per draw, speedup %.2fx",
+        propertyTime, parameterTime, propertyTime / std::max(parameterTime, 0.001));
+
+    if (propertyChecksum != parameterChecksum)
+    {
+        LOG_ERROR("Benchmark_MaterialParameters: the parameter block differs from the properties");
+        ++m_failures;
+    }
+
+    //The render entry takes the pass and the pipeline from the material, a property change must reach it on the next update
+    {
+        BenchmarkScene scene;
+        scene::SceneNode* node = V3D_NEW(scene::SceneNode, memory::MemoryLabel::MemoryGame);
+        node->addComponent(mesh, false);
+        node->addComponent(materials.front(), false);
+        scene.addNode(node);
+        scene.updateScene(0.f);
+
+        const u32 passBefore = toEnumType(scene::ScenePass::Opaque);
+        const u32 passAfter = toEnumType(scene::ScenePass::Transparency);
+        const u32 pipelineAfter = 1;
+        ASSERT(scene.getSceneData().m_generalRenderList.size() == 1, "one entry is expected");
+        const scene::NodeEntry* entry = scene.getSceneData().m_generalRenderList.front();
+        const bool validBefore = (entry->passMask & (1 << passBefore)) != 0 && entry->pipelineID == 0;
+
+        materials.front()->setProperty<u32>("materialID", passAfter);
+        materials.front()->setProperty<u32>("pipelineID", pipelineAfter);
+        scene.updateScene(0.f);
+        const bool validAfter = (entry->passMask & (1 << passBefore)) == 0 && (entry->passMask & (1 << passAfter)) != 0 && entry->pipelineID == pipelineAfter;
+
+        if (!validBefore || !validAfter)
+        {
+            LOG_ERROR("Benchmark_MaterialParameters: the render entry isn't updated after the material change, mask %x, pipeline %u", entry->passMask, entry->pipelineID);
+            ++m_failures;
+        }
+
+        scene.removeNode(node);
+        scene.updateScene(0.f);
+        V3D_DELETE(node, memory::MemoryLabel::MemoryGame);
+    }
+
+    for (scene::Material* material : materials)
+    {
+        V3D_DELETE(material, memory::MemoryLabel::MemoryObject);
+    }
+    V3D_DELETE(mesh, memory::MemoryLabel::MemoryObject);
+    renderer::Device::destroyDevice(device);
+}
@@ -0,0 +1,200 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Resource/MipmapGenerator.h"
+#include "Resource/ResourceManager.h"
+
+#include <random>
+#include <thread>
+
+#ifdef USE_STB
+//The engine doesn't build stb_image_resize since MipmapGenerator, the previous path is built here
+#   define STB_IMAGE_RESIZE_IMPLEMENTATION
+#   include <stb/stb_image_resize.h>
+#endif //USE_STB
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_mipmapImageSize = 2048;
+    constexpr u32 k_mipmapRounds = 5;
+
+    /**
+    * @brief Best of the rounds, in milliseconds
+    */
+    template<typename Generate>
+    f64 measureMipmaps(Generate generate)
+    {
+        u64 bestTime = ~0ULL;
+        for (u32 round = 0; round < k_mipmapRounds; ++round)
+        {
+            utils::Timer timer;
+            timer.start();
+            generate();
+            timer.stop();
+            bestTime = std::min<u64>(bestTime, timer.getTime<utils::Timer::Duration_MicroSeconds>());
+        }
+
+        return static_cast<f64>(bestTime) / 1'000.0;
+    }
+
+    /**
+    * @brief Exact 2x2 box with the rounding of MipmapGenerator, the reference of the SIMD paths
+    */
+    template<typename T>
+    u32 countBoxMismatches(const resource::MipmapGenerator::ImageDesc& desc, u32 mipmapCount, const std::vector<u8>& chain)
+    {
+        const T* src = reinterpret_cast<const T*>(chain.data());
+        u32 width = desc._width;
+        u32 height = desc._height;
+        u32 mismatches = 0;
+        for (u32 mip = 1; mip < mipmapCount; ++mip)
+        {
+            const T* dst = src + static_cast<u64>(width) * height * desc._components;
+            const u32 dstWidth = std::max(width / 2, 1U);
+            const u32 dstHeight = std::max(height / 2, 1U);
+            for (u32 y = 0; y < dstHeight; ++y)
+            {
+                const u32 y0 = std::min(2 * y, height - 1);
+                const u32 y1 = std::min(2 * y + 1, height - 1);
+                for (u32 x = 0; x < dstWidth; ++x)
+                {
+                    const u32 x0 = std::min(2 * x, width - 1);
+                    const u32 x1 = std::min(2 * x + 1, width - 1);
+                    for (u32 c = 0; c < desc._components; ++c)
+                    {
+                        auto at = [&](u32 px, u32 py) -> T
+                            {
+                                return src[(static_cast<u64>(py) * width + px) * desc._components + c];
+                            };
+
+                        T expected;
+                        if constexpr (std::is_floating_point_v<T>)
+                        {
+                            expected = ((at(x0, y0) + at(x0, y1)) + (at(x1, y0) + at(x1, y1))) * 0.25f;
+                        }
+                        else
+                        {
+                            expected = static_cast<T>((static_cast<u32>(at(x0, y0)) + at(x1, y0) + at(x0, y1) + at(x1, y1) + 2) >> 2);
+                        }
+
+                        if (dst[(static_cast<u64>(y) * dstWidth + x) * desc._components + c] != expected)
+                        {
+                            ++mismatches;
+                        }
+                    }
+                }
+            }
+
+            src = dst;
+            width = dstWidth;
+            height = dstHeight;
+        }
+
+        return mismatches;
+    }
+}
+
+void MyApplication::Benchmark_Mipmap()
+{
+    const u32 numThreads = std::max(std::thread::hardware_concurrency(), 3U) - 1;
+    LOG_INFO("Benchmark_Mipmap: %ux%u RGBA8 and R32F chains, best of %u rounds", k_mipmapImageSize, k_mipmapImageSize, k_mipmapRounds);
+
+    resource::MipmapGenerator::ImageDesc rgba8;
+    rgba8._width = k_mipmapImageSize;
+    rgba8._height = k_mipmapImageSize;
+    rgba8._components = 4;
+    rgba8._type = resource::MipmapGenerator::ComponentType::UNorm8;
+
+    resource::MipmapGenerator::ImageDesc r32f;
+    r32f._width = k_mipmapImageSize;
+    r32f._height = k_mipmapImageSize;
+    r32f._components = 1;
+    r32f._type = resource::MipmapGenerator::ComponentType::Float32;
+
+    const u32 mipmapCount = resource::MipmapGenerator::calculateMipmapCount(k_mipmapImageSize, k_mipmapImageSize);
+    std::vector<u8> rgba8Chain(resource::MipmapGenerator::calculateMipmapChainSize(rgba8, mipmapCount));
+    std::vector<u8> r32fChain(resource::MipmapGenerator::calculateMipmapChainSize(r32f, mipmapCount));
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f32> value(0.f, 1.f);
+    const u64 basePixels = static_cast<u64>(k_mipmapImageSize) * k_mipmapImageSize;
+    for (u64 index = 0; index < basePixels * 4; ++index)
+    {
+        rgba8Chain[index] = static_cast<u8>(random());
+    }
+    for (u64 index = 0; index < basePixels; ++index)
+    {
+        reinterpret_cast<f32*>(r32fChain.data())[index] = value(random);
+    }
+
+    resource::MipmapGenerator* generator = resource::MipmapGenerator::getLazyInstance();
+    resource::ResourceManager* manager = resource::ResourceManager::getLazyInstance();
+
+    //Before: every level was resized by stb_image_resize from the previous one, in the loading thread
+    f64 stbTime = 0.0;
+#ifdef USE_STB
+    std::vector<u8> stbChain(rgba8Chain);
+    stbTime = measureMipmaps([&stbChain, mipmapCount]() -> void
+        {
+            u8* src = stbChain.data();
+            u32 width = k_mipmapImageSize;
+            u32 height = k_mipmapImageSize;
+            for (u32 mip = 1; mip < mipmapCount; ++mip)
+            {
+                u8* dst = src + static_cast<u64>(width) * height * 4;
+                const u32 dstWidth = std::max(width / 2, 1U);
+                const u32 dstHeight = std::max(height / 2, 1U);
+                stbir_resize(src, width, height, 0, dst, dstWidth, dstHeight, 0, STBIR_TYPE_UINT8, 4, -1, 0, STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP,
+                    STBIR_FILTER_DEFAULT, STBIR_FILTER_DEFAULT, STBIR_COLORSPACE_LINEAR, nullptr);
+
+                src = dst;
+                width = dstWidth;
+                height = dstHeight;
+            }
+        });
+#endif //USE_STB
+
+    //The generator uses the loading threads only when they exist
+    const f64 rgba8SingleTime = measureMipmaps([&]() -> void
+        {
+            generator->generate(rgba8, resource::MipmapFilter::Box, mipmapCount, rgba8Chain.data());
+        });
+    const f64 r32fSingleTime = measureMipmaps([&]() -> void
+        {
+            generator->generate(r32f, resource::MipmapFilter::Box, mipmapCount, r32fChain.data());
+        });
+
+    manager->initAsyncLoading(numThreads);
+    const f64 rgba8ParallelTime = measureMipmaps([&]() -> void
+        {
+            generator->generate(rgba8, resource::MipmapFilter::Box, mipmapCount, rgba8Chain.data());
+        });
+    const f64 r32fParallelTime = measureMipmaps([&]() -> void
+        {
+            generator->generate(r32f, resource::MipmapFilter::Box, mipmapCount, r32fChain.data());
+        });
+    manager->shutdownAsyncLoading();
+
+    if (stbTime > 0.0)
+    {
+        LOG_INFO("Benchmark_Mipmap: RGBA8 stb_image_resize %.3f ms, box %.3f ms, speedup %.2fx", stbTime, rgba8SingleTime, stbTime / std::max(rgba8SingleTime, 0.001));
+    }
+    else
+    {
+        LOG_WARNING("Benchmark_Mipmap: stb isn't built, USE_STB is off");
+    }
+    LOG_INFO("Benchmark_Mipmap: RGBA8 box %.3f ms on %u loading threads, speedup %.2fx", rgba8ParallelTime, numThreads, rgba8SingleTime / std::max(rgba8ParallelTime, 0.001));
+    LOG_INFO("Benchmark_Mipmap: R32F box %.3f ms, %.3f ms on %u loading threads, speedup %.2fx", r32fSingleTime, r32fParallelTime, numThreads, r32fSingleTime / std::max(r32fParallelTime, 0.001));
+
+    //The kernels are chosen by CPUID, the result must not depend on it
+    const u32 rgba8Mismatches = countBoxMismatches<u8>(rgba8, mipmapCount, rgba8Chain);
+    const u32 r32fMismatches = countBoxMismatches<f32>(r32f, mipmapCount, r32fChain);
+    if (rgba8Mismatches > 0 || r32fMismatches > 0)
+    {
+        LOG_ERROR("Benchmark_Mipmap: the box filter differs from the reference, RGBA8 %u, R32F %u", rgba8Mismatches, r32fMismatches);
+        ++m_failures;
+    }
+}
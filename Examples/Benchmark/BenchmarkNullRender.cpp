@@ -0,0 +1,357 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Renderer/Device.h"
+#include "Renderer/Swapchain.h"
+#include "Renderer/Texture.h"
+#include "Renderer/SamplerState.h"
+#include "Renderer/Null/NullDevice.h"
+#include "Resource/ResourceManager.h"
+#include "Resource/Loader/ShaderSourceFileLoader.h"
+#include "Task/TaskScheduler.h"
+
+#include "Scene/Scene.h"
+#include "Scene/SceneNode.h"
+#include "Scene/Material.h"
+#include "Scene/ModelHandler.h"
+#include "Scene/Geometry/Mesh.h"
+#include "Scene/Camera/Camera.h"
+#include "Scene/Camera/CameraController.h"
+#include "RenderTechniques/RenderPipelineZPrepass.h"
+#include "RenderTechniques/RenderPipelineGBuffer.h"
+
+#include <thread>
+
+using namespace v3d;
+
+namespace
+{
+    //Working directories of the examples, same layout as ShaderPrebake expects
+    const c8* k_nullRenderDataRoots[] = { "../../../../engine/data/", "../../engine/data/", "engine/data/" };
+
+    constexpr u32 k_nullRenderGridSize = 100; //10k draws per pass
+    constexpr u32 k_nullRenderMaterialCount = 64;
+    constexpr u32 k_nullRenderTexturesPerMaterial = 5;
+    constexpr u32 k_nullRenderWarmupFrames = 2;
+    constexpr u32 k_nullRenderFrames = 32;
+    const math::Dimension2D k_nullRenderViewport = { 1920, 1080 };
+
+    /**
+    * @brief NullRenderScene class. ZPrepass and GBuffer stages of the editor technique, the frame is driven as EditorScene does
+    */
+    class NullRenderScene final : public scene::SceneHandler
+    {
+    public:
+
+        class RenderPipelineScene final : public scene::RenderTechnique
+        {
+        public:
+
+            explicit RenderPipelineScene(scene::ModelHandler* modelHandler) noexcept
+            {
+                new scene::RenderPipelineZPrepassStage(this, modelHandler);
+                new scene::RenderPipelineGBufferStage(this, modelHandler);
+            }
+
+            ~RenderPipelineScene() = default;
+        };
+
+        NullRenderScene() noexcept
+            : SceneHandler(false)
+            , m_technique(&m_modelHandler)
+            , m_camera(std::make_unique<scene::Camera>())
+        {
+        }
+
+        using SceneHandler::addNode;
+        using SceneHandler::removeNode;
+        using SceneHandler::updateScene;
+
+        scene::SceneData& getSceneData()
+        {
+            return m_sceneData;
+        }
+
+        void createScene(renderer::Device* device, renderer::SamplerState* sampler)
+        {
+            setupRender(device);
+
+            m_sceneData.m_viewportSize = k_nullRenderViewport;
+            m_camera.setPerspective(m_sceneData.m_settings._vewportParams._fov, k_nullRenderViewport, m_sceneData.m_settings._vewportParams._near, m_sceneData.m_settings._vewportParams._far);
+            m_camera.setPosition({ 0.f, 0.f, -60.f });
+            m_camera.setTarget({ 0.f, 0.f, 0.f });
+            m_camera.update(0.f);
+            m_sceneData.m_camera = &m_camera;
+
+            m_sceneData.m_globalResources.bind("linear_sampler_repeat", sampler);
+
+            registerTechnique(&m_technique);
+            SceneHandler::create();
+        }
+
+        void destroyScene()
+        {
+            SceneHandler::destroy();
+            unregisterTechnique(&m_technique);
+            setupRender(nullptr);
+        }
+
+        void renderFrame()
+        {
+            //The viewport doesn't depend on the time, the same scene gives the same command stream every frame
+            scene::FrameData& frameData = m_sceneData.sceneFrameData();
+            frameData.m_allocator->reset();
+            frameData.m_frameResources.cleanup();
+
+            const scene::Camera& camera = m_camera.getCamera();
+            scene::ViewportState* viewportState = frameData.m_allocator->construct<scene::ViewportState>();
+            viewportState->projectionMatrix = camera.getProjectionMatrix();
+            viewportState->invProjectionMatrix = camera.getProjectionMatrix().getInversed();
+            viewportState->viewMatrix = camera.getViewMatrix();
+            viewportState->invViewMatrix = camera.getViewMatrix().getInversed();
+            viewportState->prevProjectionMatrix = viewportState->projectionMatrix;
+            viewportState->prevViewMatrix = viewportState->viewMatrix;
+            viewportState->cameraJitter = { 0.f, 0.f };
+            viewportState->prevCameraJitter = { 0.f, 0.f };
+            viewportState->cameraPosition = { m_camera.getPosition().getX(), m_camera.getPosition().getY(), m_camera.getPosition().getZ(), 0.f };
+            viewportState->random = { 0.f, 0.f, 0.f, 0.f };
+            viewportState->viewportSize = { (f32)k_nullRenderViewport._width, (f32)k_nullRenderViewport._height };
+            viewportState->clipNearFar = { m_camera.getNear(), m_camera.getFar() };
+            viewportState->cursorPosition = { 0.f, 0.f };
+            viewportState->time = 0;
+            frameData.m_frameResources.bind("viewport_state", viewportState);
+
+            SceneHandler::updateScene(0.016f);
+            SceneHandler::preRender(0.016f);
+            SceneHandler::postRender(0.016f);
+            SceneHandler::submitRender();
+        }
+
+    private:
+
+        scene::ModelHandler     m_modelHandler;
+        RenderPipelineScene     m_technique;
+        scene::CameraController m_camera;
+    };
+
+    /**
+    * @brief createTexture. The name and the description are the same in every run, so is the key of the Null device
+    */
+    renderer::Texture2D* createTexture(renderer::Device* device, u32 index)
+    {
+        return V3D_NEW(renderer::Texture2D, memory::MemoryLabel::MemoryObject)(device, renderer::TextureUsage::TextureUsage_Sampled | renderer::TextureUsage_Write,
+            renderer::Format::Format_R8G8B8A8_UNorm, math::Dimension2D(4, 4), 1, 1, "null_render_texture_" + std::to_string(index));
+    }
+
+    void assignTextures(const std::vector<scene::Material*>& materials, const std::vector<renderer::Texture2D*>& textures)
+    {
+        const c8* slots[k_nullRenderTexturesPerMaterial] = { "BaseColor", "Normals", "Roughness", "Metalness", "Displacement" };
+        for (u32 index = 0; index < materials.size(); ++index)
+        {
+            for (u32 slot = 0; slot < k_nullRenderTexturesPerMaterial; ++slot)
+            {
+                materials[index]->setProperty<ObjectHandle>(slots[slot], ObjectHandle(textures[index * k_nullRenderTexturesPerMaterial + slot]));
+            }
+        }
+    }
+
+    /**
+    * @brief replayCapturedFrame. Every recording is issued to a new command list, the stream must be the same. Returns the number of mismatches
+    */
+    u32 replayCapturedFrame(renderer::Device* device, const std::vector<renderer::null::NullCmdList::Recording>& recordings)
+    {
+        u32 mismatches = 0;
+        for (const renderer::null::NullCmdList::Recording& recording : recordings)
+        {
+            renderer::null::NullCmdList* cmdList = device->createCommandList<renderer::null::NullCmdList>(renderer::Device::GraphicMask);
+            renderer::null::NullCmdList::replay(recording, cmdList);
+            if (cmdList->getRecording().hash() != recording.hash() || cmdList->getRecording()._statistics._draws != recording._statistics._draws)
+            {
+                ++mismatches;
+            }
+            device->destroyCommandList(cmdList);
+        }
+
+        return mismatches;
+    }
+}
+
+void MyApplication::Benchmark_NullRender()
+{
+    const u32 drawCount = k_nullRenderGridSize * k_nullRenderGridSize;
+    LOG_INFO("Benchmark_NullRender: ZPrepass and GBuffer of %u draws on the Null device, %u frames", drawCount, k_nullRenderFrames);
+
+    renderer::Device* device = renderer::Device::createDevice(renderer::Device::RenderType::Empty, renderer::Device::GraphicMask);
+    renderer::null::NullDevice* nullDevice = static_cast<renderer::null::NullDevice*>(device);
+
+    resource::ResourceManager* manager = resource::ResourceManager::getLazyInstance();
+    {
+        auto shaderLoader = std::make_unique<resource::ShaderSourceFileLoader>(device, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
+        for (const c8* root : k_nullRenderDataRoots)
+        {
+            shaderLoader->addRoot(root);
+        }
+        shaderLoader->addPath("shaders/");
+        manager->registerLoader<resource::ShaderSourceFileLoader::ResourceType>(std::move(shaderLoader));
+    }
+
+    NullRenderScene* renderScene = V3D_NEW(NullRenderScene, memory::MemoryLabel::MemoryObject);
+
+    //The stages can't be created without the shaders, the same sets with the same flags as they load
+    u32 failedShaders = 0;
+    for (const resource::ShaderPermutationResult& result : manager->compileShaders(scene::RenderPipelineZPrepassStage::getShaderPermutations(renderScene->getSceneData())))
+    {
+        failedShaders += result._shader ? 0 : 1;
+    }
+    for (const resource::ShaderPermutationResult& result : manager->compileShaders(scene::RenderPipelineGBufferStage::getShaderPermutations(renderScene->getSceneData()),
+        resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV))
+    {
+        failedShaders += result._shader ? 0 : 1;
+    }
+
+    if (failedShaders > 0)
+    {
+        LOG_ERROR("Benchmark_NullRender: %u shaders are failed, the data root isn't found or the compiler isn't available", failedShaders);
+        ++m_failures;
+
+        V3D_DELETE(renderScene, memory::MemoryLabel::MemoryObject);
+        manager->clear();
+        renderer::Device::destroyDevice(device);
+        return;
+    }
+
+    renderer::Swapchain::SwapchainParams params;
+    params._size = k_nullRenderViewport;
+    renderer::Swapchain* swapchain = device->createSwapchain(nullptr, params);
+
+    renderer::SamplerState* sampler = V3D_NEW(renderer::SamplerState, memory::MemoryLabel::MemoryObject)(device, renderer::SamplerFilter::SamplerFilter_Trilinear, renderer::SamplerAnisotropic::SamplerAnisotropic_4x);
+    sampler->setWrap(renderer::SamplerWrap::TextureWrap_Repeat);
+
+    scene::Mesh* mesh = scene::MeshHelper::createCube(device, 1.f);
+    std::vector<renderer::Texture2D*> textures;
+    for (u32 index = 0; index < k_nullRenderMaterialCount * k_nullRenderTexturesPerMaterial; ++index)
+    {
+        textures.push_back(createTexture(device, index));
+    }
+
+    std::vector<scene::Material*> materials;
+    for (u32 index = 0; index < k_nullRenderMaterialCount; ++index)
+    {
+        scene::Material* material = V3D_NEW(scene::Material, memory::MemoryLabel::MemoryObject)(device, scene::MaterialShadingModel::PBR_MetallicRoughness);
+        material->setProperty<math::float4>("DiffuseColor", { 1.f, static_cast<f32>(index) / k_nullRenderMaterialCount, 1.f, 1.f });
+        materials.push_back(material);
+    }
+    assignTextures(materials, textures);
+
+    std::vector<scene::SceneNode*> nodes;
+    for (u32 index = 0; index < drawCount; ++index)
+    {
+        const f32 x = (static_cast<f32>(index % k_nullRenderGridSize) - k_nullRenderGridSize * 0.5f) * 0.6f;
+        const f32 y = (static_cast<f32>(index / k_nullRenderGridSize) - k_nullRenderGridSize * 0.5f) * 0.6f;
+
+        scene::SceneNode* node = V3D_NEW(scene::SceneNode, memory::MemoryLabel::MemoryGame);
+        node->setPosition(scene::TransformMode::Local, { x, y, 0.f });
+        node->addComponent(mesh, false);
+        node->addComponent(materials[index % k_nullRenderMaterialCount], false);
+        renderScene->addNode(node);
+        nodes.push_back(node);
+    }
+
+    renderScene->createScene(device, sampler);
+    for (u32 frame = 0; frame < k_nullRenderWarmupFrames; ++frame)
+    {
+        renderScene->renderFrame();
+        swapchain->presentFrame();
+    }
+
+    std::vector<f64> frameTimes;
+    for (u32 frame = 0; frame < k_nullRenderFrames; ++frame)
+    {
+        utils::Timer timer;
+        timer.start();
+        renderScene->renderFrame();
+        swapchain->presentFrame();
+        timer.stop();
+
+        frameTimes.push_back(static_cast<f64>(timer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0);
+    }
+    std::sort(frameTimes.begin(), frameTimes.end());
+    const f64 medianTime = frameTimes[frameTimes.size() / 2];
+    const renderer::null::NullCmdList::Statistics statistics = nullDevice->getFrameStatistics();
+    const u32 syncHash = nullDevice->getFrameHash();
+
+    LOG_INFO("Benchmark_NullRender: frame %.3f ms median, %.3f ms best, %u draws, %u commands, %u pipeline switches, %u descriptor binds, %.1f ns per draw",
+        medianTime, frameTimes.front(), statistics._draws, statistics._commands, statistics._pipelineSwitches, statistics._descriptorBinds,
+        medianTime * 1'000'000.0 / std::max<u32>(statistics._draws, 1));
+
+    //The replay of the captured frame must give the same streams
+    nullDevice->captureFrame();
+    renderScene->renderFrame();
+    swapchain->presentFrame();
+    const u32 replayMismatches = replayCapturedFrame(device, nullDevice->getCapturedFrame());
+    const u32 replayedLists = static_cast<u32>(nullDevice->getCapturedFrame().size());
+    if (replayedLists == 0 || replayMismatches > 0)
+    {
+        LOG_ERROR("Benchmark_NullRender: %u of %u replayed command lists differ from the recorded ones", replayMismatches, replayedLists);
+        ++m_failures;
+    }
+
+    //The textures are created again on the loading threads, in the order the tasks complete. The keys must not depend on it
+    const u32 numThreads = std::max(std::thread::hardware_concurrency(), 3U) - 1;
+    manager->initAsyncLoading(numThreads);
+    for (renderer::Texture2D* texture : textures)
+    {
+        V3D_DELETE(texture, memory::MemoryLabel::MemoryObject);
+    }
+    manager->getScheduler()->parallelFor(0, static_cast<u32>(textures.size()), 1, [device, &textures](u32 begin, u32 end) -> void
+        {
+            for (u32 index = begin; index < end; ++index)
+            {
+                textures[index] = createTexture(device, index);
+            }
+        });
+    manager->shutdownAsyncLoading();
+    assignTextures(materials, textures);
+
+    //The material versions are changed, the entries are compiled again by the first frame
+    for (u32 frame = 0; frame < k_nullRenderWarmupFrames; ++frame)
+    {
+        renderScene->renderFrame();
+        swapchain->presentFrame();
+    }
+    const u32 asyncHash = nullDevice->getFrameHash();
+
+    if (syncHash == 0 || syncHash != asyncHash)
+    {
+        LOG_ERROR("Benchmark_NullRender: the frame hash %x differs from %x after the textures are created on the loading threads", asyncHash, syncHash);
+        ++m_failures;
+    }
+
+    for (scene::SceneNode* node : nodes)
+    {
+        renderScene->removeNode(node);
+    }
+    renderScene->updateScene(0.f);
+    renderScene->destroyScene();
+    V3D_DELETE(renderScene, memory::MemoryLabel::MemoryObject);
+
+    for (scene::SceneNode* node : nodes)
+    {
+        V3D_DELETE(node, memory::MemoryLabel::MemoryGame);
+    }
+    for (scene::Material* material : materials)
+    {
+        V3D_DELETE(material, memory::MemoryLabel::MemoryObject);
+    }
+    for (renderer::Texture2D* texture : textures)
+    {
+        V3D_DELETE(texture, memory::MemoryLabel::MemoryObject);
+    }
+    V3D_DELETE(mesh, memory::MemoryLabel::MemoryObject);
+    V3D_DELETE(sampler, memory::MemoryLabel::MemoryObject);
+
+    device->destroySwapchain(swapchain);
+    manager->clear();
+    renderer::Device::destroyDevice(device);
+}
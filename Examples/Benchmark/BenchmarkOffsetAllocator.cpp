@@ -0,0 +1,264 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Memory/OffsetAllocator.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u64 k_fuzzHeapSize = 256ULL * 1024 * 1024;
+    constexpr u32 k_fuzzMaxAllocations = 4096;
+    constexpr u32 k_fuzzOperations = 1'000'000;
+
+    /**
+    * @brief Chunk sets of the previous PoolVulkanMemoryAllocator pool: all chunks by offset, free chunks by size, best fit
+    */
+    class ChunkSetAllocator final
+    {
+    public:
+
+        struct Chunk
+        {
+            u64 _size;
+            u64 _offset;
+        };
+
+        explicit ChunkSetAllocator(u64 size) noexcept
+        {
+            m_chunks.insert({ size, 0 });
+            m_freeChunks.insert({ size, 0 });
+        }
+
+        /**
+        * @brief The chunk offset is returned, the aligned offset is inside the chunk
+        */
+        bool allocate(u64 size, u64 alignment, u64& chunkOffset)
+        {
+            //The size is padded by the alignment, same as the previous pool did
+            const u64 alignedSize = math::alignUp(size, alignment) + alignment;
+            auto found = m_freeChunks.lower_bound({ alignedSize, 0 });
+            if (found == m_freeChunks.cend())
+            {
+                return false;
+            }
+
+            const Chunk freeChunk = *found;
+            m_freeChunks.erase(found);
+            m_chunks.erase(freeChunk);
+
+            chunkOffset = freeChunk._offset;
+            const Chunk usedChunk = { alignedSize, freeChunk._offset };
+            m_chunks.insert(usedChunk);
+            if (freeChunk._size > alignedSize)
+            {
+                const Chunk tail = { freeChunk._size - alignedSize, freeChunk._offset + alignedSize };
+                m_chunks.insert(tail);
+                m_freeChunks.insert(tail);
+            }
+
+            return true;
+        }
+
+        void free(u64 chunkOffset)
+        {
+            auto chunk = m_chunks.find({ 0, chunkOffset });
+            ASSERT(chunk != m_chunks.end(), "unknown chunk");
+
+            Chunk merged = *chunk;
+            chunk = m_chunks.erase(chunk);
+            if (chunk != m_chunks.end() && m_freeChunks.erase(*chunk) > 0)
+            {
+                merged._size += chunk->_size;
+                chunk = m_chunks.erase(chunk);
+            }
+
+            if (chunk != m_chunks.begin())
+            {
+                auto prev = std::prev(chunk);
+                if (m_freeChunks.erase(*prev) > 0)
+                {
+                    merged = { merged._size + prev->_size, prev->_offset };
+                    m_chunks.erase(prev);
+                }
+            }
+
+            m_chunks.insert(merged);
+            m_freeChunks.insert(merged);
+        }
+
+        f32 getFragmentation() const
+        {
+            u64 freeSpace = 0;
+            for (const Chunk& chunk : m_freeChunks)
+            {
+                freeSpace += chunk._size;
+            }
+            return (freeSpace == 0) ? 0.f : 1.f - static_cast<f32>(static_cast<f64>(m_freeChunks.rbegin()->_size) / static_cast<f64>(freeSpace));
+        }
+
+    private:
+
+        struct OffsetSort
+        {
+            bool operator()(const Chunk& left, const Chunk& right) const
+            {
+                return left._offset < right._offset;
+            }
+        };
+
+        struct SizeSort
+        {
+            bool operator()(const Chunk& left, const Chunk& right) const
+            {
+                return (left._size == right._size) ? left._offset < right._offset : left._size < right._size;
+            }
+        };
+
+        std::set<Chunk, OffsetSort> m_chunks;
+        std::set<Chunk, SizeSort>   m_freeChunks;
+    };
+
+    struct FuzzOperation
+    {
+        u64  _size;
+        u64  _alignment;
+        u32  _victim; //Index of the freed allocation, scaled to the live count
+        bool _allocate;
+    };
+
+    struct FuzzResult
+    {
+        f64 _time;
+        u32 _failed;
+        f32 _fragmentation;
+    };
+
+    /**
+    * @brief Live allocations are kept in a vector, a freed one is replaced by the last, so both allocators see the same pattern while they succeed
+    */
+    template<typename Allocate, typename Free, typename Fragmentation>
+    FuzzResult runFuzz(const std::vector<FuzzOperation>& operations, Allocate allocate, Free free, Fragmentation fragmentation)
+    {
+        std::vector<u64> live;
+        live.reserve(k_fuzzMaxAllocations);
+
+        FuzzResult result = {};
+        utils::Timer timer;
+        timer.start();
+        for (const FuzzOperation& operation : operations)
+        {
+            if (operation._allocate || live.empty())
+            {
+                u64 handle = 0;
+                if (live.size() < k_fuzzMaxAllocations && allocate(operation._size, operation._alignment, handle))
+                {
+                    live.push_back(handle);
+                }
+                else
+                {
+                    ++result._failed;
+                }
+            }
+            else
+            {
+                const u32 index = operation._victim % static_cast<u32>(live.size());
+                free(live[index]);
+                live[index] = live.back();
+                live.pop_back();
+            }
+        }
+        timer.stop();
+
+        result._time = static_cast<f64>(timer.getTime<utils::Timer::Duration_NanoSeconds>()) / static_cast<f64>(operations.size());
+        result._fragmentation = fragmentation();
+
+        for (u64 handle : live)
+        {
+            free(handle);
+        }
+        return result;
+    }
+}
+
+void MyApplication::Benchmark_OffsetAllocator()
+{
+    LOG_INFO("Benchmark_OffsetAllocator: %u random allocate/free operations on a %llu MB heap, up to %u allocations", k_fuzzOperations, k_fuzzHeapSize >> 20, k_fuzzMaxAllocations);
+
+    //Same spread as Test_OffsetAllocator: many small buffers, some textures, rarely a big attachment
+    std::mt19937 random(42);
+    std::uniform_int_distribution<u32> percent(0, 99);
+    std::uniform_int_distribution<u64> smallSize(1, 64 * 1024);
+    std::uniform_int_distribution<u64> mediumSize(64 * 1024, 4 * 1024 * 1024);
+    std::uniform_int_distribution<u64> largeSize(4 * 1024 * 1024, 32 * 1024 * 1024);
+    std::uniform_int_distribution<u32> victim;
+    const u64 alignments[] = { 1, 16, 256, 4096, 65536 };
+
+    std::vector<FuzzOperation> operations(k_fuzzOperations);
+    for (FuzzOperation& operation : operations)
+    {
+        const u32 sizeType = percent(random);
+        operation._size = (sizeType < 80) ? smallSize(random) : (sizeType < 98) ? mediumSize(random) : largeSize(random);
+        operation._alignment = alignments[percent(random) % std::size(alignments)];
+        operation._victim = victim(random);
+        operation._allocate = percent(random) < 50;
+    }
+
+    memory::OffsetAllocator offsetAllocator(k_fuzzHeapSize, k_fuzzMaxAllocations);
+    std::vector<memory::OffsetAllocator::Allocation> nodes;
+    FuzzResult offsetResult = runFuzz(operations,
+        [&offsetAllocator, &nodes](u64 size, u64 alignment, u64& handle) -> bool
+        {
+            memory::OffsetAllocator::Allocation allocation = offsetAllocator.allocate(size, alignment);
+            if (!allocation.isValid())
+            {
+                return false;
+            }
+
+            if (nodes.size() <= allocation._node)
+            {
+                nodes.resize(allocation._node + 1);
+            }
+            nodes[allocation._node] = allocation;
+            handle = allocation._node;
+            return true;
+        },
+        [&offsetAllocator, &nodes](u64 handle) -> void
+        {
+            offsetAllocator.free(nodes[handle]);
+        },
+        [&offsetAllocator]() -> f32
+        {
+            return offsetAllocator.getStorageReport().getFragmentation();
+        });
+
+    ChunkSetAllocator chunkAllocator(k_fuzzHeapSize);
+    FuzzResult chunkResult = runFuzz(operations,
+        [&chunkAllocator](u64 size, u64 alignment, u64& handle) -> bool
+        {
+            return chunkAllocator.allocate(size, alignment, handle);
+        },
+        [&chunkAllocator](u64 handle) -> void
+        {
+            chunkAllocator.free(handle);
+        },
+        [&chunkAllocator]() -> f32
+        {
+            return chunkAllocator.getFragmentation();
+        });
+
+    LOG_INFO("Benchmark_OffsetAllocator: chunk sets %.1f ns per operation, failed %u, fragmentation %.3f", chunkResult._time, chunkResult._failed, chunkResult._fragmentation);
+    LOG_INFO("Benchmark_OffsetAllocator: TLSF %.1f ns per operation, failed %u, fragmentation %.3f, speedup %.2fx",
+        offsetResult._time, offsetResult._failed, offsetResult._fragmentation, chunkResult._time / std::max(offsetResult._time, 0.001));
+
+    //Everything is freed by runFuzz, the free neighbors must be merged back to the whole heap
+    const memory::OffsetAllocator::StorageReport report = offsetAllocator.getStorageReport();
+    if (report._allocationCount != 0 || report._freeRegionCount != 1 || report._largestFreeRegion != k_fuzzHeapSize)
+    {
+        LOG_ERROR("Benchmark_OffsetAllocator: the heap isn't merged after all allocations are freed, regions %u", report._freeRegionCount);
+        ++m_failures;
+    }
+}
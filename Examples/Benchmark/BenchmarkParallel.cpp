@@ -0,0 +1,135 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Task/TaskScheduler.h"
+#include "Math/AABB.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_parallelItemCount = 1 << 20;
+    constexpr u32 k_parallelGrain = 1024;
+    constexpr u32 k_parallelRounds = 5;
+
+    struct BoundsKernel
+    {
+        std::vector<math::AABB>     _localBounds;
+        std::vector<math::Matrix4D> _transforms;
+        std::vector<math::AABB>     _worldBounds;
+
+        //Same work as the world bounds update of SceneHandler::updateScene
+        void transform(u32 begin, u32 end)
+        {
+            for (u32 index = begin; index < end; ++index)
+            {
+                _worldBounds[index] = math::transformAABB(_localBounds[index], _transforms[index]);
+            }
+        }
+
+        math::AABB merge(u32 begin, u32 end, math::AABB bounds) const
+        {
+            for (u32 index = begin; index < end; ++index)
+            {
+                bounds.expand(_worldBounds[index].getMin());
+                bounds.expand(_worldBounds[index].getMax());
+            }
+            return bounds;
+        }
+    };
+
+    /**
+    * @brief Best of the rounds, in milliseconds. 0 worker threads is the serial loop without the scheduler
+    */
+    f64 measureBoundsKernel(BoundsKernel& kernel, u32 numWorkers, math::AABB& sceneBounds)
+    {
+        std::unique_ptr<task::TaskScheduler> scheduler;
+        if (numWorkers > 0)
+        {
+            scheduler = std::make_unique<task::TaskScheduler>(numWorkers, task::TaskDispatcher::WorkStealingScheduler);
+        }
+
+        u64 bestTime = ~0ULL;
+        for (u32 round = 0; round < k_parallelRounds; ++round)
+        {
+            utils::Timer timer;
+            timer.start();
+
+            if (scheduler)
+            {
+                scheduler->parallelFor(0, k_parallelItemCount, k_parallelGrain, [&kernel](u32 begin, u32 end) -> void
+                    {
+                        kernel.transform(begin, end);
+                    });
+
+                sceneBounds = scheduler->parallelReduce<math::AABB>(0, k_parallelItemCount, k_parallelGrain, math::AABB(),
+                    [&kernel](u32 begin, u32 end, math::AABB bounds) -> math::AABB
+                    {
+                        return kernel.merge(begin, end, bounds);
+                    },
+                    [](math::AABB left, math::AABB right) -> math::AABB
+                    {
+                        if (right.isValid())
+                        {
+                            left.expand(right.getMin());
+                            left.expand(right.getMax());
+                        }
+                        return left;
+                    });
+            }
+            else
+            {
+                kernel.transform(0, k_parallelItemCount);
+                sceneBounds = kernel.merge(0, k_parallelItemCount, math::AABB());
+            }
+
+            timer.stop();
+            bestTime = std::min<u64>(bestTime, timer.getTime<utils::Timer::Duration_MicroSeconds>());
+        }
+
+        return static_cast<f64>(bestTime) / 1'000.0;
+    }
+}
+
+void MyApplication::Benchmark_ParallelFor()
+{
+    LOG_INFO("Benchmark_ParallelFor: %u AABB transforms + bounds reduce, grain %u, best of %u rounds", k_parallelItemCount, k_parallelGrain, k_parallelRounds);
+
+    BoundsKernel kernel;
+    kernel._localBounds.resize(k_parallelItemCount);
+    kernel._transforms.resize(k_parallelItemCount);
+    kernel._worldBounds.resize(k_parallelItemCount);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f32> position(-1000.f, 1000.f);
+    std::uniform_real_distribution<f32> extent(0.1f, 10.f);
+    for (u32 index = 0; index < k_parallelItemCount; ++index)
+    {
+        const math::TVector3D<f32> size(extent(random), extent(random), extent(random));
+        kernel._localBounds[index] = math::AABB(-size, size);
+        kernel._transforms[index].setTranslation({ position(random), position(random), position(random) });
+        kernel._transforms[index].setRotation({ position(random), position(random), position(random) });
+    }
+
+    math::AABB serialBounds;
+    const f64 serialTime = measureBoundsKernel(kernel, 0, serialBounds);
+    LOG_INFO("Benchmark_ParallelFor cores 1 (serial): %.3f ms", serialTime);
+
+    const u32 maxWorkers = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+    for (u32 numWorkers = 1; numWorkers <= maxWorkers; numWorkers = (numWorkers == maxWorkers) ? maxWorkers + 1 : std::min(numWorkers * 2, maxWorkers))
+    {
+        math::AABB parallelBounds;
+        const f64 parallelTime = measureBoundsKernel(kernel, numWorkers, parallelBounds);
+        LOG_INFO("Benchmark_ParallelFor cores %u: %.3f ms, speedup %.2fx", numWorkers + 1, parallelTime, serialTime / std::max(parallelTime, 0.001));
+
+        //min/max merging doesn't depend on the order, the result must be exact
+        if (parallelBounds != serialBounds)
+        {
+            LOG_ERROR("Benchmark_ParallelFor cores %u: the reduced bounds differ from the serial result", numWorkers + 1);
+            ++m_failures;
+        }
+    }
+}
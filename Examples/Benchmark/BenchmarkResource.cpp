@@ -0,0 +1,225 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Stream/FileLoader.h"
+#include "Resource/ResourceManager.h"
+#include "Resource/Loader/ResourceLoader.h"
+
+#include <filesystem>
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_startupResourceCount = 64;
+    constexpr u32 k_startupResourceSize = 1024 * 1024;
+    constexpr u32 k_startupFilterPasses = 2;
+
+    /**
+    * @brief Stand-in of a texture. The file is filtered as a decoder does, the upload goes through executeOnUploadThread as Texture::load does
+    */
+    class StartupResource final : public resource::Resource
+    {
+    public:
+
+        struct LoadPolicy : resource::Resource::LoadPolicy
+        {
+            bool unique = true;
+        };
+
+        StartupResource() noexcept
+            : m_checksum(0)
+        {
+        }
+
+        bool load(const stream::Stream* stream, u32 offset = 0) override
+        {
+            std::vector<u8> pixels(stream->size() - offset);
+            stream->seekBeg(offset);
+            stream->read(pixels.data(), static_cast<u32>(pixels.size()));
+
+            for (u32 pass = 0; pass < k_startupFilterPasses; ++pass)
+            {
+                for (size_t index = 1; index + 1 < pixels.size(); ++index)
+                {
+                    pixels[index] = static_cast<u8>((pixels[index - 1] + 2 * pixels[index] + pixels[index + 1]) >> 2);
+                }
+            }
+
+            resource::ResourceManager::getLazyInstance()->executeOnUploadThread([this, &pixels]() -> void
+                {
+                    m_uploaded = pixels;
+                });
+
+            m_checksum = 0;
+            for (u8 pixel : m_uploaded)
+            {
+                m_checksum = m_checksum * 31 + pixel;
+            }
+            m_loaded = true;
+
+            return true;
+        }
+
+        bool save(stream::Stream* stream, u32 offset = 0) const override
+        {
+            return false;
+        }
+
+        u64 getChecksum() const
+        {
+            return m_checksum;
+        }
+
+    private:
+
+        std::vector<u8> m_uploaded;
+        u64             m_checksum;
+    };
+
+    class StartupResourceLoader final : public resource::ResourceLoader<StartupResource>
+    {
+    public:
+
+        using ResourceType = StartupResource;
+        using PolicyType = StartupResource::LoadPolicy;
+
+        [[nodiscard]] StartupResource* load(const std::string& name, const resource::Resource::LoadPolicy& policy, u32 flags = 0) override
+        {
+            for (std::string& root : m_roots)
+            {
+                stream::FileStream* file = stream::FileLoader::load(root + name);
+                if (!file)
+                {
+                    continue;
+                }
+
+                StartupResource* resource = V3D_NEW(StartupResource, memory::MemoryLabel::MemoryObject);
+                resource->load(file);
+                stream::FileLoader::close(file);
+
+                return resource;
+            }
+
+            return nullptr;
+        }
+    };
+
+    std::string startupResourceName(u32 index)
+    {
+        return std::format("startup_{}.bin", index);
+    }
+}
+
+namespace v3d
+{
+    template<>
+    struct TypeOf<StartupResource>
+    {
+        static TypePtr get()
+        {
+            static TypePtr ptr = nullptr;
+            return (TypePtr)&ptr;
+        }
+    };
+} //namespace v3d
+
+void MyApplication::Benchmark_ResourceStartup()
+{
+    const u32 numThreads = std::max(std::thread::hardware_concurrency(), 3U) - 1;
+    LOG_INFO("Benchmark_ResourceStartup: %u resources of %u KB, sync load vs loadAsync on %u loading threads", k_startupResourceCount, k_startupResourceSize >> 10, numThreads);
+
+    std::error_code error;
+    const std::filesystem::path folder = std::filesystem::temp_directory_path(error) / "v3d_benchmark_startup";
+    std::filesystem::create_directories(folder, error);
+
+    std::mt19937 random(42);
+    std::vector<u8> content(k_startupResourceSize);
+    for (u32 index = 0; index < k_startupResourceCount; ++index)
+    {
+        for (u8& value : content)
+        {
+            value = static_cast<u8>(random());
+        }
+
+        stream::FileStream file((folder / startupResourceName(index)).string(), stream::FileStream::e_out);
+        if (!file.isOpen())
+        {
+            LOG_ERROR("Benchmark_ResourceStartup: can't write to %s", folder.string().c_str());
+            ++m_failures;
+            return;
+        }
+        file.write(content.data(), static_cast<u32>(content.size()));
+        file.close();
+    }
+
+    resource::ResourceManager* manager = resource::ResourceManager::getLazyInstance();
+    std::unique_ptr<StartupResourceLoader> loader = std::make_unique<StartupResourceLoader>();
+    loader->addRoot(folder.string() + "/");
+    manager->registerLoader<StartupResource>(std::move(loader));
+
+    const StartupResource::LoadPolicy policy;
+    std::vector<StartupResource*> syncResources(k_startupResourceCount, nullptr);
+
+    //Before: the startup loads the resources one by one in the main thread
+    utils::Timer syncTimer;
+    syncTimer.start();
+    for (u32 index = 0; index < k_startupResourceCount; ++index)
+    {
+        syncResources[index] = manager->load<StartupResource, StartupResourceLoader>(startupResourceName(index), policy);
+    }
+    syncTimer.stop();
+
+    //The same names are loaded again, the sync results are dropped first
+    std::vector<u64> checksums(k_startupResourceCount, 0);
+    for (u32 index = 0; index < k_startupResourceCount; ++index)
+    {
+        if (syncResources[index])
+        {
+            checksums[index] = syncResources[index]->getChecksum();
+            manager->remove(syncResources[index]);
+        }
+    }
+
+    manager->initAsyncLoading(numThreads);
+
+    utils::Timer asyncTimer;
+    asyncTimer.start();
+    std::vector<resource::AsyncLoadHandle> requests;
+    for (u32 index = 0; index < k_startupResourceCount; ++index)
+    {
+        requests.push_back(manager->loadAsync<StartupResource, StartupResourceLoader>(startupResourceName(index), policy));
+    }
+
+    for (const resource::AsyncLoadHandle& request : requests)
+    {
+        manager->wait(request);
+    }
+    asyncTimer.stop();
+
+    u32 mismatches = 0;
+    for (u32 index = 0; index < k_startupResourceCount; ++index)
+    {
+        StartupResource* resource = requests[index]->getResource<StartupResource>();
+        if (!resource || checksums[index] == 0 || resource->getChecksum() != checksums[index])
+        {
+            ++mismatches;
+        }
+        manager->remove(resource);
+    }
+    manager->shutdownAsyncLoading();
+
+    const f64 syncTime = static_cast<f64>(syncTimer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0;
+    const f64 asyncTime = static_cast<f64>(asyncTimer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0;
+    LOG_INFO("Benchmark_ResourceStartup: sync %.3f ms, async %.3f ms, speedup %.2fx", syncTime, asyncTime, syncTime / std::max(asyncTime, 0.001));
+
+    if (mismatches > 0)
+    {
+        LOG_ERROR("Benchmark_ResourceStartup: %u async resources differ from the sync load", mismatches);
+        ++m_failures;
+    }
+
+    std::filesystem::remove_all(folder, error);
+}
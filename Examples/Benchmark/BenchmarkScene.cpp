@@ -0,0 +1,236 @@
+#include "MyApplication.h"
+#include "BenchmarkScene.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Renderer/Device.h"
+#include "Scene/Geometry/Mesh.h"
+#include "Task/TaskScheduler.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_hitchSceneRootCount = 10'000;
+    constexpr u32 k_hitchChildrenPerRoot = 9; //100k nodes in the scene
+    constexpr u32 k_hitchAddedRootCount = 100; //1000 nodes are added and removed
+    constexpr u32 k_hitchBaselineFrames = 16;
+
+    scene::SceneNode* createNodeTree(scene::Mesh* mesh, u32 childCount, std::mt19937& random)
+    {
+        std::uniform_real_distribution<f32> position(-1000.f, 1000.f);
+
+        scene::SceneNode* root = V3D_NEW(scene::SceneNode, memory::MemoryLabel::MemoryGame);
+        root->setPosition(scene::TransformMode::Local, { position(random), position(random), position(random) });
+        root->addComponent(mesh, false);
+
+        for (u32 index = 0; index < childCount; ++index)
+        {
+            scene::SceneNode* child = V3D_NEW(scene::SceneNode, memory::MemoryLabel::MemoryGame);
+            child->setPosition(scene::TransformMode::Local, { position(random) * 0.01f, position(random) * 0.01f, position(random) * 0.01f });
+            child->addComponent(mesh, false);
+            root->addChild(child);
+        }
+
+        return root;
+    }
+
+    f64 measureUpdate(BenchmarkScene& scene)
+    {
+        utils::Timer timer;
+        timer.start();
+        scene.updateScene(0.016f);
+        timer.stop();
+
+        return static_cast<f64>(timer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0;
+    }
+}
+
+void MyApplication::Benchmark_SceneHitch()
+{
+    const u32 sceneNodeCount = k_hitchSceneRootCount * (k_hitchChildrenPerRoot + 1);
+    const u32 addedNodeCount = k_hitchAddedRootCount * (k_hitchChildrenPerRoot + 1);
+    LOG_INFO("Benchmark_SceneHitch: %u nodes are added to and removed from a %u node scene", addedNodeCount, sceneNodeCount);
+
+    renderer::Device* device = renderer::Device::createDevice(renderer::Device::RenderType::Empty, renderer::Device::GraphicMask);
+    scene::Mesh* mesh = scene::MeshHelper::createCube(device, 1.f);
+    std::mt19937 random(42);
+
+    {
+        BenchmarkScene scene;
+        std::vector<scene::SceneNode*> sceneRoots;
+        for (u32 index = 0; index < k_hitchSceneRootCount; ++index)
+        {
+            sceneRoots.push_back(createNodeTree(mesh, k_hitchChildrenPerRoot, random));
+            scene.addNode(sceneRoots.back());
+        }
+        const f64 buildTime = measureUpdate(scene);
+
+        std::vector<f64> frameTimes;
+        for (u32 frame = 0; frame < k_hitchBaselineFrames; ++frame)
+        {
+            frameTimes.push_back(measureUpdate(scene));
+        }
+        std::sort(frameTimes.begin(), frameTimes.end());
+        const f64 baselineTime = frameTimes[frameTimes.size() / 2];
+
+        std::vector<scene::SceneNode*> addedRoots;
+        for (u32 index = 0; index < k_hitchAddedRootCount; ++index)
+        {
+            addedRoots.push_back(createNodeTree(mesh, k_hitchChildrenPerRoot, random));
+            scene.addNode(addedRoots.back());
+        }
+        const f64 addTime = measureUpdate(scene);
+        const u32 entriesAfterAdd = static_cast<u32>(scene.getSceneData().m_generalRenderList.size());
+
+        //The children go first, they are removed from the middle of the graph
+        std::vector<scene::SceneNode*> removedNodes;
+        for (scene::SceneNode* root : addedRoots)
+        {
+            std::vector<scene::SceneNode*> children(root->m_children.cbegin(), root->m_children.cend());
+            for (scene::SceneNode* child : children)
+            {
+                scene.removeNode(child);
+                removedNodes.push_back(child);
+            }
+            scene.removeNode(root);
+            removedNodes.push_back(root);
+        }
+        const f64 removeTime = measureUpdate(scene);
+        const u32 entriesAfterRemove = static_cast<u32>(scene.getSceneData().m_generalRenderList.size());
+
+        //The full rebuild walks the graph, the removed nodes must not come back
+        scene.nodeGraphChanged();
+        const f64 rebuildTime = measureUpdate(scene);
+        const u32 entriesAfterRebuild = static_cast<u32>(scene.getSceneData().m_generalRenderList.size());
+
+        LOG_INFO("Benchmark_SceneHitch: initial build %.3f ms, frame %.3f ms, add frame %.3f ms (hitch %.3f ms), remove frame %.3f ms (hitch %.3f ms), full rebuild %.3f ms",
+            buildTime, baselineTime, addTime, addTime - baselineTime, removeTime, removeTime - baselineTime, rebuildTime);
+
+        if (entriesAfterAdd != sceneNodeCount + addedNodeCount || entriesAfterRemove != sceneNodeCount || entriesAfterRebuild != sceneNodeCount)
+        {
+            LOG_ERROR("Benchmark_SceneHitch: render entries %u/%u/%u, expected %u/%u/%u", entriesAfterAdd, entriesAfterRemove, entriesAfterRebuild,
+                sceneNodeCount + addedNodeCount, sceneNodeCount, sceneNodeCount);
+            ++m_failures;
+        }
+
+        for (scene::SceneNode* node : removedNodes)
+        {
+            V3D_DELETE(node, memory::MemoryLabel::MemoryGame);
+        }
+
+        for (scene::SceneNode* root : sceneRoots)
+        {
+            scene.removeNode(root);
+        }
+        scene.updateScene(0.f);
+
+        for (scene::SceneNode* root : sceneRoots)
+        {
+            V3D_DELETE(root, memory::MemoryLabel::MemoryGame);
+        }
+    }
+
+    V3D_DELETE(mesh, memory::MemoryLabel::MemoryObject);
+    renderer::Device::destroyDevice(device);
+}
+
+namespace
+{
+    constexpr u32 k_hierarchyNodeCount = 100'000;
+    constexpr u32 k_hierarchyDeepChainLength = 1'000;
+    constexpr u32 k_hierarchySparseStep = 100; //Every 100th node is moved in the sparse frame
+    constexpr u32 k_hierarchyRounds = 5;
+
+    /**
+    * @brief Best of the rounds, in milliseconds. Every round moves the nodes selected by the step and updates the hierarchy
+    */
+    f64 measureHierarchyUpdate(scene::TransformHierarchy& hierarchy, task::TaskScheduler& scheduler, const std::vector<scene::SceneNode*>& nodes, u32 step)
+    {
+        u64 bestTime = ~0ULL;
+        for (u32 round = 0; round < k_hierarchyRounds; ++round)
+        {
+            utils::Timer timer;
+            timer.start();
+
+            for (u32 index = 0; step > 0 && index < nodes.size(); index += step)
+            {
+                nodes[index]->setPosition(scene::TransformMode::Local, { 1.f, static_cast<f32>(round), 0.f });
+            }
+            hierarchy.update(scheduler);
+
+            timer.stop();
+            bestTime = std::min<u64>(bestTime, timer.getTime<utils::Timer::Duration_MicroSeconds>());
+        }
+
+        return static_cast<f64>(bestTime) / 1'000.0;
+    }
+}
+
+void MyApplication::Benchmark_TransformHierarchy()
+{
+    LOG_INFO("Benchmark_TransformHierarchy: %u nodes, wide (one root) and deep (chains of %u), best of %u rounds", k_hierarchyNodeCount, k_hierarchyDeepChainLength, k_hierarchyRounds);
+
+    task::TaskScheduler scheduler(std::max(std::thread::hardware_concurrency(), 2U) - 1, task::TaskDispatcher::WorkStealingScheduler);
+
+    auto runShape = [this, &scheduler](const c8* shape, u32 chainLength) -> void
+        {
+            //Every node is shifted by 1 along X from its parent, so the world X is the depth + 1
+            std::vector<scene::SceneNode*> nodes;
+            std::vector<scene::SceneNode*> roots;
+            for (u32 index = 0; index < k_hierarchyNodeCount; ++index)
+            {
+                scene::SceneNode* node = V3D_NEW(scene::SceneNode, memory::MemoryLabel::MemoryGame);
+                node->setPosition(scene::TransformMode::Local, { 1.f, 0.f, 0.f });
+
+                const bool isRoot = (chainLength > 0) ? (index % chainLength) == 0 : index == 0;
+                if (isRoot)
+                {
+                    roots.push_back(node);
+                }
+                else
+                {
+                    ((chainLength > 0) ? nodes.back() : roots.front())->addChild(node);
+                }
+                nodes.push_back(node);
+            }
+
+            scene::TransformHierarchy hierarchy;
+            utils::Timer timer;
+            timer.start();
+            for (scene::SceneNode* root : roots)
+            {
+                hierarchy.insert(root);
+            }
+            hierarchy.update(scheduler);
+            timer.stop();
+            const f64 insertTime = static_cast<f64>(timer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0;
+
+            const f64 idleTime = measureHierarchyUpdate(hierarchy, scheduler, nodes, 0);
+            const f64 sparseTime = measureHierarchyUpdate(hierarchy, scheduler, nodes, k_hierarchySparseStep);
+            const f64 fullTime = measureHierarchyUpdate(hierarchy, scheduler, roots, 1);
+
+            LOG_INFO("Benchmark_TransformHierarchy %s: levels %u, insert + first update %.3f ms, idle %.3f ms, 1%% moved %.3f ms, roots moved %.3f ms",
+                shape, hierarchy.getLevelCount(), insertTime, idleTime, sparseTime, fullTime);
+
+            const scene::SceneNode* leaf = nodes.back();
+            const f32 expectedX = (chainLength > 0) ? static_cast<f32>((k_hierarchyNodeCount - 1) % chainLength + 1) : 2.f;
+            if (hierarchy.getCount() != k_hierarchyNodeCount || std::abs(leaf->getTransform().getPosition().getX() - expectedX) > 0.01f)
+            {
+                LOG_ERROR("Benchmark_TransformHierarchy %s: count %u, leaf X %f, expected %u, %f", shape, hierarchy.getCount(),
+                    leaf->getTransform().getPosition().getX(), k_hierarchyNodeCount, expectedX);
+                ++m_failures;
+            }
+
+            for (scene::SceneNode* root : roots)
+            {
+                hierarchy.remove(root);
+                V3D_DELETE(root, memory::MemoryLabel::MemoryGame);
+            }
+        };
+
+    runShape("wide", 0);
+    runShape("deep", k_hierarchyDeepChainLength);
+}
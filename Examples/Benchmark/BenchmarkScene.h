@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Common.h"
+#include "Scene/Scene.h"
+#include "Scene/SceneNode.h"
+
+/**
+* @brief BenchmarkScene class. Scene handler without the render techniques, the benchmarks drive the update directly
+*/
+class BenchmarkScene final : public v3d::scene::SceneHandler
+{
+public:
+
+    BenchmarkScene() noexcept
+        : SceneHandler(false)
+    {
+    }
+
+    using SceneHandler::addNode;
+    using SceneHandler::removeNode;
+    using SceneHandler::updateNode;
+    using SceneHandler::nodeGraphChanged;
+    using SceneHandler::updateScene;
+
+    v3d::scene::SceneData& getSceneData()
+    {
+        return m_sceneData;
+    }
+};
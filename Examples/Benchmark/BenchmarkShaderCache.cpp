@@ -0,0 +1,143 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Renderer/Device.h"
+#include "Resource/ResourceManager.h"
+#include "Resource/ShaderCache.h"
+#include "Resource/Loader/ShaderSourceFileLoader.h"
+
+#include "Scene/Scene.h"
+#include "RenderTechniques/RenderPipelineGBuffer.h"
+
+#include <filesystem>
+
+using namespace v3d;
+
+namespace
+{
+    //Working directories of the examples, same layout as ShaderPrebake expects
+    const c8* k_shaderCacheDataRoots[] = { "../../../../engine/data/", "../../engine/data/", "engine/data/" };
+
+    struct ShaderCacheRun
+    {
+        f64                          _time;
+        u64                          _hits;
+        u64                          _misses;
+        std::vector<std::vector<u8>> _bytecodes;
+    };
+
+    ShaderCacheRun compileShaderPermutations(const std::vector<resource::ShaderPermutation>& permutations)
+    {
+        resource::ShaderCache* cache = resource::ShaderCache::getInstance();
+        const u64 hits = cache->getHits();
+        const u64 misses = cache->getMisses();
+
+        //ForceReload skips the shaders registered by the previous run, every permutation goes through the decoder and the cache
+        ShaderCacheRun run = {};
+        utils::Timer timer;
+        timer.start();
+        const std::vector<resource::ShaderPermutationResult> results = resource::ResourceManager::getInstance()->compileShaders(permutations,
+            resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV | resource::ShaderCompileFlag::ShaderCompile_ForceReload);
+        timer.stop();
+
+        run._time = static_cast<f64>(timer.getTime<utils::Timer::Duration_MicroSeconds>()) / 1'000.0;
+        run._hits = cache->getHits() - hits;
+        run._misses = cache->getMisses() - misses;
+
+        //The shaders of the cold run are replaced by the warm run, the bytecode is copied
+        for (const resource::ShaderPermutationResult& result : results)
+        {
+            std::vector<u8>& bytecode = run._bytecodes.emplace_back();
+            if (result._shader)
+            {
+                const u8* data = reinterpret_cast<const u8*>(result._shader->getBytecode());
+                bytecode.assign(data, data + result._shader->getBytecodeSize());
+            }
+        }
+
+        return run;
+    }
+}
+
+void MyApplication::Benchmark_ShaderCache()
+{
+    //Default settings of the scene, the same set ShaderPrebake bakes for the GBuffer
+    scene::SceneData sceneData;
+    const std::vector<resource::ShaderPermutation> permutations = scene::RenderPipelineGBufferStage::getShaderPermutations(sceneData);
+    LOG_INFO("Benchmark_ShaderCache: %u GBuffer permutations, cold compile vs warm cache", static_cast<u32>(permutations.size()));
+
+    renderer::Device* device = renderer::Device::createDevice(renderer::Device::RenderType::Empty, renderer::Device::GraphicMask);
+
+    std::error_code error;
+    const std::filesystem::path folder = std::filesystem::temp_directory_path(error) / "v3d_benchmark_shadercache";
+    resource::ShaderCache::getLazyInstance()->setDirectory(folder.string());
+    if (!resource::ShaderCache::getInstance()->isEnabled())
+    {
+        LOG_ERROR("Benchmark_ShaderCache: can't use %s", folder.string().c_str());
+        ++m_failures;
+
+        renderer::Device::destroyDevice(device);
+        return;
+    }
+    resource::ShaderCache::getInstance()->clear();
+
+    resource::ResourceManager* manager = resource::ResourceManager::getLazyInstance();
+    {
+        //The compile flags are a part of the cache key, must match the flags of the runs
+        auto shaderLoader = std::make_unique<resource::ShaderSourceFileLoader>(device, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
+        for (const c8* root : k_shaderCacheDataRoots)
+        {
+            shaderLoader->addRoot(root);
+        }
+        shaderLoader->addPath("shaders/");
+        manager->registerLoader<resource::ShaderSourceFileLoader::ResourceType>(std::move(shaderLoader));
+    }
+
+    //Cold: the cache is empty, every permutation is compiled and stored
+    const ShaderCacheRun cold = compileShaderPermutations(permutations);
+    //Warm: the same keys, every permutation is read from the cache
+    const ShaderCacheRun warm = compileShaderPermutations(permutations);
+
+    LOG_INFO("Benchmark_ShaderCache: cold %.3f ms (hits %llu, misses %llu), warm %.3f ms (hits %llu, misses %llu), speedup %.2fx",
+        cold._time, cold._hits, cold._misses, warm._time, warm._hits, warm._misses, cold._time / std::max(warm._time, 0.001));
+
+    u32 failed = 0;
+    u32 mismatches = 0;
+    for (u32 index = 0; index < permutations.size(); ++index)
+    {
+        if (cold._bytecodes[index].empty() || warm._bytecodes[index].empty())
+        {
+            LOG_ERROR("Benchmark_ShaderCache: %s:%s is failed", permutations[index]._filename.c_str(), permutations[index]._entrypoint.c_str());
+            ++failed;
+        }
+        else if (cold._bytecodes[index] != warm._bytecodes[index])
+        {
+            ++mismatches;
+        }
+    }
+
+    if (failed > 0)
+    {
+        LOG_ERROR("Benchmark_ShaderCache: %u permutations are failed, the data root isn't found or the compiler isn't available", failed);
+        ++m_failures;
+    }
+    else if (cold._hits != 0 || warm._misses != 0 || warm._hits != cold._misses)
+    {
+        LOG_ERROR("Benchmark_ShaderCache: the warm run isn't served by the cache, cold misses %llu, warm hits %llu", cold._misses, warm._hits);
+        ++m_failures;
+    }
+
+    if (mismatches > 0)
+    {
+        LOG_ERROR("Benchmark_ShaderCache: %u cached shaders differ from the compiled ones", mismatches);
+        ++m_failures;
+    }
+
+    manager->clear();
+    resource::ShaderCache::getInstance()->clear();
+    resource::ShaderCache::getInstance()->setDirectory("");
+    std::filesystem::remove_all(folder, error);
+
+    renderer::Device::destroyDevice(device);
+}
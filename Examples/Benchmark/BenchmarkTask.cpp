@@ -0,0 +1,177 @@
+#include "MyApplication.h"
+#include "BenchmarkAllocations.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Task/TaskScheduler.h"
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_throughputRootCount = 64;
+    constexpr u32 k_throughputTaskCount = k_throughputRootCount * 1024;
+    constexpr u32 k_throughputRounds = 5;
+
+    constexpr u32 k_allocationFrameCount = 1000;
+    constexpr u32 k_allocationWarmupFrameCount = 16;
+    constexpr u32 k_allocationTasksPerFrame = 256;
+
+    /**
+    * @brief Best of the rounds, in tasks per second.
+    * Flat: the main thread submits every task, they go through the worker inboxes.
+    * Nested: the main thread submits the roots, the roots submit the children from the workers, that is the render job pattern
+    */
+    f64 measureTaskThroughput(u32 numWorkers, task::TaskDispatcher::DispatcherFlags flags, bool nested)
+    {
+        task::TaskScheduler scheduler(numWorkers, flags);
+        std::vector<task::Task> roots(k_throughputRootCount);
+        std::vector<task::Task> tasks(k_throughputTaskCount);
+        std::atomic<u32> executed = 0;
+
+        u64 bestTime = ~0ULL;
+        for (u32 round = 0; round < k_throughputRounds; ++round)
+        {
+            executed.store(0, std::memory_order_relaxed);
+
+            utils::Timer timer;
+            timer.start();
+
+            auto submitRange = [&scheduler, &tasks, &executed](u32 begin, u32 end) -> void
+                {
+                    for (u32 index = begin; index < end; ++index)
+                    {
+                        tasks[index].init("Throughput", [&executed]() -> void
+                            {
+                                executed.fetch_add(1, std::memory_order_relaxed);
+                            });
+                        scheduler.executeTask(&tasks[index], task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+                    }
+                };
+
+            if (nested)
+            {
+                const u32 childCount = k_throughputTaskCount / k_throughputRootCount;
+                for (u32 index = 0; index < k_throughputRootCount; ++index)
+                {
+                    roots[index].init("ThroughputRoot", [&submitRange, index, childCount]() -> void
+                        {
+                            submitRange(index * childCount, (index + 1) * childCount);
+                        });
+                    scheduler.executeTask(&roots[index], task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+                }
+
+                //The children are initialized by the roots
+                for (task::Task& root : roots)
+                {
+                    scheduler.waitTask(&root);
+                }
+            }
+            else
+            {
+                submitRange(0, k_throughputTaskCount);
+            }
+
+            for (task::Task& task : tasks)
+            {
+                scheduler.waitTask(&task);
+            }
+
+            timer.stop();
+            ASSERT(executed.load(std::memory_order_relaxed) == k_throughputTaskCount, "all tasks must be executed");
+            bestTime = std::min<u64>(bestTime, timer.getTime<utils::Timer::Duration_MicroSeconds>());
+        }
+
+        return static_cast<f64>(k_throughputTaskCount) * 1'000'000.0 / static_cast<f64>(std::max<u64>(bestTime, 1));
+    }
+}
+
+void MyApplication::Benchmark_TaskThroughput()
+{
+    LOG_INFO("Benchmark_TaskThroughput: %u tasks, best of %u rounds, Mtasks/s", k_throughputTaskCount, k_throughputRounds);
+
+    const u32 maxWorkers = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+    for (u32 numWorkers = 1; numWorkers <= maxWorkers; numWorkers = (numWorkers == maxWorkers) ? maxWorkers + 1 : std::min(numWorkers * 2, maxWorkers))
+    {
+        const f64 lockedFlat = measureTaskThroughput(numWorkers, 0, false);
+        const f64 stealingFlat = measureTaskThroughput(numWorkers, task::TaskDispatcher::WorkStealingScheduler, false);
+        const f64 lockedNested = measureTaskThroughput(numWorkers, 0, true);
+        const f64 stealingNested = measureTaskThroughput(numWorkers, task::TaskDispatcher::WorkStealingScheduler, true);
+
+        LOG_INFO("Benchmark_TaskThroughput workers %u: flat locked %.3f, stealing %.3f | nested locked %.3f, stealing %.3f",
+            numWorkers, lockedFlat / 1'000'000.0, stealingFlat / 1'000'000.0, lockedNested / 1'000'000.0, stealingNested / 1'000'000.0);
+    }
+}
+
+void MyApplication::Benchmark_TaskAllocations()
+{
+    LOG_INFO("Benchmark_TaskAllocations: %u frames, %u tasks per frame", k_allocationFrameCount, k_allocationTasksPerFrame);
+
+    task::TaskScheduler scheduler(4, task::TaskDispatcher::WorkStealingScheduler);
+    task::TaskPool pool;
+    std::vector<task::Task*> frameTasks(k_allocationTasksPerFrame);
+
+    //Same shape as the render jobs: an interned name, captures close to the inline storage size, a dependency chain
+    const c8* taskName = task::Task::internName(std::string("Benchmark Job"));
+    struct Payload
+    {
+        u64 _values[8];
+    };
+    std::atomic<u64> checksum = 0;
+
+    auto runFrame = [&](u32 frame) -> void
+        {
+            for (u32 index = 0; index < k_allocationTasksPerFrame; ++index)
+            {
+                Payload payload;
+                std::fill(std::begin(payload._values), std::end(payload._values), frame + index);
+
+                task::Task* task = pool.acquireTask();
+                task->init(taskName, [&checksum, payload]() -> void
+                    {
+                        checksum.fetch_add(payload._values[0], std::memory_order_relaxed);
+                    });
+
+                if (index > 0 && (index % 4) != 0)
+                {
+                    task->addDependency(frameTasks[index - 1]);
+                }
+                frameTasks[index] = task;
+                scheduler.executeTask(task, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+            }
+
+            for (task::Task* task : frameTasks)
+            {
+                scheduler.waitTask(task);
+                pool.releaseTask(task);
+            }
+        };
+
+    for (u32 frame = 0; frame < k_allocationWarmupFrameCount; ++frame)
+    {
+        runFrame(frame);
+    }
+
+    const u32 pooledTasks = pool.getAllocatedCount();
+    const u64 allocationsBegin = heapAllocationCount();
+
+    utils::Timer timer;
+    timer.start();
+    for (u32 frame = 0; frame < k_allocationFrameCount; ++frame)
+    {
+        runFrame(frame);
+    }
+    timer.stop();
+
+    const u64 allocations = heapAllocationCount() - allocationsBegin;
+    const u64 taskCount = static_cast<u64>(k_allocationFrameCount) * k_allocationTasksPerFrame;
+    LOG_INFO("Benchmark_TaskAllocations: %.1f ns per task, heap allocations %llu (%.4f per task), pooled tasks %u -> %u",
+        static_cast<f64>(timer.getTime<utils::Timer::Duration_NanoSeconds>()) / static_cast<f64>(taskCount),
+        allocations, static_cast<f64>(allocations) / static_cast<f64>(taskCount), pooledTasks, pool.getAllocatedCount());
+
+    if (allocations != 0 || pooledTasks != pool.getAllocatedCount())
+    {
+        LOG_ERROR("Benchmark_TaskAllocations: scheduling allocates in the steady state");
+        ++m_failures;
+    }
+}
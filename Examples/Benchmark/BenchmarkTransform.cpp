@@ -0,0 +1,130 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Utils/Timer.h"
+#include "Scene/Transform.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_transformCount = 100'000;
+    constexpr u32 k_transformRounds = 5;
+
+    /**
+    * @brief Best of the rounds, in milliseconds
+    */
+    template<typename Update>
+    f64 measureTransforms(Update update)
+    {
+        u64 bestTime = ~0ULL;
+        for (u32 round = 0; round < k_transformRounds; ++round)
+        {
+            utils::Timer timer;
+            timer.start();
+
+            for (u32 index = 0; index < k_transformCount; ++index)
+            {
+                update(index);
+            }
+
+            timer.stop();
+            bestTime = std::min<u64>(bestTime, timer.getTime<utils::Timer::Duration_MicroSeconds>());
+        }
+
+        return static_cast<f64>(bestTime) / 1'000.0;
+    }
+
+    bool isEqualMatrix(const math::Matrix4D& left, const math::Matrix4D& right)
+    {
+        for (u32 index = 0; index < 16; ++index)
+        {
+            if (std::abs(left[index] - right[index]) > 1e-3f * std::max(1.f, std::abs(left[index])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void MyApplication::Benchmark_TransformUpdate()
+{
+    LOG_INFO("Benchmark_TransformUpdate: %u transforms, best of %u rounds", k_transformCount, k_transformRounds);
+
+    std::vector<math::Vector3D> positions(k_transformCount);
+    std::vector<math::Vector3D> rotations(k_transformCount);
+    std::vector<math::Vector3D> scales(k_transformCount);
+    std::vector<math::Matrix4D> worldMatrices(k_transformCount);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f32> position(-1000.f, 1000.f);
+    std::uniform_real_distribution<f32> angle(-80.f, 80.f);
+    std::uniform_real_distribution<f32> scale(0.5f, 2.f);
+    for (u32 index = 0; index < k_transformCount; ++index)
+    {
+        positions[index] = { position(random), position(random), position(random) };
+        rotations[index] = { angle(random), angle(random), angle(random) };
+        scales[index] = { scale(random), scale(random), scale(random) };
+        worldMatrices[index].setScale(scales[index]);
+        worldMatrices[index].setRotation(rotations[index]);
+        worldMatrices[index].setTranslation(positions[index]);
+    }
+
+    std::vector<scene::Transform> transforms(k_transformCount);
+
+    //World write of the hierarchy update. Before: setMatrix decomposed the components right away
+    f32 checksum = 0.f;
+    const f64 eagerWorldTime = measureTransforms([&](u32 index) -> void
+        {
+            transforms[index].setMatrix(worldMatrices[index]);
+            checksum += transforms[index].getPosition().getX() + transforms[index].getRotation().getX() + transforms[index].getScale().getX();
+        });
+
+    const f64 lazyWorldTime = measureTransforms([&](u32 index) -> void
+        {
+            transforms[index].setMatrix(worldMatrices[index]);
+        });
+
+    //Local matrix rebuild after the components are edited. Before: every matrix setter decomposed the matrix again
+    std::vector<math::Matrix4D> componentMatrices(k_transformCount);
+    const f64 componentLocalTime = measureTransforms([&](u32 index) -> void
+        {
+            math::Matrix4D& matrix = componentMatrices[index];
+            matrix = math::Matrix4D();
+            matrix.setScale(scales[index]);
+            matrix.setRotation(rotations[index]);
+            matrix.setTranslation(positions[index]);
+        });
+
+    const f64 composedLocalTime = measureTransforms([&](u32 index) -> void
+        {
+            scene::Transform& transform = transforms[index];
+            transform.setScale(scales[index]);
+            transform.setRotation(rotations[index]);
+            transform.setPosition(positions[index]);
+            checksum += transform.getMatrix()[12];
+        });
+
+    LOG_INFO("Benchmark_TransformUpdate: world write %.3f ms eager decomposition, %.3f ms lazy, speedup %.2fx (checksum %f)",
+        eagerWorldTime, lazyWorldTime, eagerWorldTime / std::max(lazyWorldTime, 0.001), checksum);
+    LOG_INFO("Benchmark_TransformUpdate: local rebuild %.3f ms per component setters, %.3f ms composed from TRS, speedup %.2fx",
+        componentLocalTime, composedLocalTime, componentLocalTime / std::max(composedLocalTime, 0.001));
+
+    u32 mismatches = 0;
+    for (u32 index = 0; index < k_transformCount; ++index)
+    {
+        if (!isEqualMatrix(componentMatrices[index], transforms[index].getMatrix()) || !isEqualMatrix(worldMatrices[index], componentMatrices[index]))
+        {
+            ++mismatches;
+        }
+    }
+
+    if (mismatches > 0)
+    {
+        LOG_ERROR("Benchmark_TransformUpdate: %u composed matrices differ from the per component result", mismatches);
+        ++m_failures;
+    }
+}
@@ -0,0 +1,12 @@
+// Main.cpp : Defines the entry point for the console application.
+// Usage: Benchmark [name ...]
+// Runs the benchmarks with the given names, all of them without arguments. Build the Profile configuration, it keeps the logger
+//
+
+#include "MyApplication.h"
+
+int main(int argc, char* argv[])
+{
+    MyApplication* application = new MyApplication(argc, argv);
+    return application->Execute();
+}
@@ -0,0 +1,98 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+
+using namespace v3d;
+
+MyApplication::MyApplication(int& argc, char** argv)
+    : m_failures(0)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        m_selected.emplace_back(argv[i]);
+    }
+}
+
+int MyApplication::Execute()
+{
+    if (isSelected("TaskThroughput"))
+    {
+        Benchmark_TaskThroughput();
+    }
+
+    if (isSelected("TaskAllocations"))
+    {
+        Benchmark_TaskAllocations();
+    }
+
+    if (isSelected("ParallelFor"))
+    {
+        Benchmark_ParallelFor();
+    }
+
+    if (isSelected("SceneHitch"))
+    {
+        Benchmark_SceneHitch();
+    }
+
+    if (isSelected("BoundingVolumeHierarchy"))
+    {
+        Benchmark_BoundingVolumeHierarchy();
+    }
+
+    if (isSelected("TransformHierarchy"))
+    {
+        Benchmark_TransformHierarchy();
+    }
+
+    if (isSelected("TransformUpdate"))
+    {
+        Benchmark_TransformUpdate();
+    }
+
+    if (isSelected("MaterialParameters"))
+    {
+        Benchmark_MaterialParameters();
+    }
+
+    if (isSelected("OffsetAllocator"))
+    {
+        Benchmark_OffsetAllocator();
+    }
+
+    if (isSelected("ResourceStartup"))
+    {
+        Benchmark_ResourceStartup();
+    }
+
+    if (isSelected("ShaderCache"))
+    {
+        Benchmark_ShaderCache();
+    }
+
+    if (isSelected("Mipmap"))
+    {
+        Benchmark_Mipmap();
+    }
+
+    if (isSelected("NullRender"))
+    {
+        Benchmark_NullRender();
+    }
+
+    //The checks of the benchmarks fail the run, ASSERT is compiled out in the Profile configuration
+    const u32 failures = m_failures;
+    LOG_INFO("Benchmarks are finished, failed checks %u", failures);
+
+    delete this;
+    return failures > 0 ? 1 : 0;
+}
+
+bool MyApplication::isSelected(const std::string& name) const
+{
+    return m_selected.empty() || std::find(m_selected.cbegin(), m_selected.cend(), name) != m_selected.cend();
+}
+
+MyApplication::~MyApplication()
+{
+}
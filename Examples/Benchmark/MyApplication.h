@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Common.h"
+
+class MyApplication
+{
+public:
+
+    MyApplication(int& argc, char** argv);
+    ~MyApplication();
+
+    int Execute();
+
+private:
+
+    bool isSelected(const std::string& name) const;
+
+    void Benchmark_TaskThroughput();
+    void Benchmark_TaskAllocations();
+    void Benchmark_ParallelFor();
+    void Benchmark_SceneHitch();
+    void Benchmark_BoundingVolumeHierarchy();
+    void Benchmark_TransformHierarchy();
+    void Benchmark_TransformUpdate();
+    void Benchmark_MaterialParameters();
+    void Benchmark_OffsetAllocator();
+    void Benchmark_ResourceStartup();
+    void Benchmark_ShaderCache();
+    void Benchmark_Mipmap();
+    void Benchmark_NullRender();
+
+    std::vector<std::string> m_selected;
+    v3d::u32                 m_failures;
+};
@@ -1,4 +1,9 @@
 // Main.cpp : Defines the entry point for the console application.
+// Usage: MultithreadedDraws [-frames count] [-dump directory] [-dumpEvery interval] [-null 1]
+// -frames exits after the count of frames and prints the frame time statistics, 0 is unlimited
+// -dump and -dumpEvery write the presented frames as PNG, only for the headless (offscreen) swapchain
+// -null 1 renders with the null device: nothing is executed, prints the command statistics and the hash of the last frame
+// -traceFrames count [-traceFile name] writes the CPU zones of the first frames as a Chrome trace, Profile configuration only (see Application)
 //
 
 #include "Common.h"
@@ -6,10 +11,12 @@
 #include "Platform/Window.h"
 #include "Renderer/Device.h"
 #include "Renderer/Swapchain.h"
+#include "Renderer/Null/NullDevice.h"
 #include "Events/Input/InputEventHandler.h"
 #include "Events/Input/InputEventReceiver.h"
 #include "Resource/ResourceManager.h"
 #include "Utils/Logger.h"
+#include "Utils/Timer.h"
 #include "Scene.h"
 
 using namespace v3d;
@@ -29,6 +36,27 @@ public:
 
         , m_Scene(nullptr)
     {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const std::string option(argv[i]);
+            if (option == "-frames")
+            {
+                m_FrameCount = std::max(std::atoi(argv[i + 1]), 0);
+            }
+            else if (option == "-dump")
+            {
+                m_DumpDirectory = argv[i + 1];
+            }
+            else if (option == "-dumpEvery")
+            {
+                m_DumpInterval = std::max(std::atoi(argv[i + 1]), 0);
+            }
+            else if (option == "-null")
+            {
+                m_NullDevice = std::atoi(argv[i + 1]) != 0;
+            }
+        }
+
         m_Window = Window::createWindow({ 1280, 720 }, { 400, 200 }, false, new v3d::event::InputEventReceiver());
         ASSERT(m_Window, "windows is nullptr");
     }
@@ -69,10 +97,23 @@ public:
                 {
                     break;
                 }
+
+                utils::Timer timer;
+                const u64 allocations = memory::memory_allocation_count();
+                timer.start();
                 Run();
+                timer.stop();
+                m_FrameTimes.push_back(timer.getTime<utils::Timer::Duration_MicroSeconds>());
+                m_FrameAllocations.push_back(memory::memory_allocation_count() - allocations);
+
+                if (m_FrameCount > 0 && m_FrameTimes.size() >= m_FrameCount)
+                {
+                    break;
+                }
             }
         }
 
+        PrintFrameStatistics();
         Exit();
         return 0;
     }
@@ -105,12 +146,14 @@ private:
         m_Window->getInputEventReceiver()->attach(InputEvent::InputEventType::KeyboardInputEvent, m_InputEventHandler);
         m_Window->getInputEventReceiver()->attach(InputEvent::InputEventType::SystemEvent, m_InputEventHandler);
 
-        m_Device = Device::createDevice(Device::RenderType::Vulkan, Device::GraphicMask);
+        m_Device = Device::createDevice(m_NullDevice ? Device::RenderType::Empty : Device::RenderType::Vulkan, Device::GraphicMask);
         ASSERT(m_Device, "render is nullptr");
 
         Swapchain::SwapchainParams params;
         params._size = m_Window->getSize();
         params._vSync = false;
+        params._dumpDirectory = m_DumpDirectory;
+        params._dumpInterval = m_DumpDirectory.empty() ? 0 : std::max(m_DumpInterval, 1U);
         m_Swapchain = m_Device->createSwapchain(m_Window, params);
 
         m_Scene = new app::Scene(m_Device, m_Swapchain);
@@ -126,6 +169,38 @@ private:
         return true;
     }
     
+    void PrintFrameStatistics()
+    {
+        if (m_FrameTimes.empty())
+        {
+            return;
+        }
+
+        std::vector<u64> frameTimes(m_FrameTimes);
+        std::sort(frameTimes.begin(), frameTimes.end());
+        auto percentile = [&frameTimes](f64 value) -> f64
+            {
+                const u64 index = std::min(static_cast<u64>(value * frameTimes.size()), static_cast<u64>(frameTimes.size() - 1));
+                return static_cast<f64>(frameTimes[index]) / 1000.0;
+            };
+
+        const f64 average = static_cast<f64>(std::accumulate(frameTimes.cbegin(), frameTimes.cend(), 0ULL)) / frameTimes.size() / 1000.0;
+        LOG_INFO("MultithreadedDraws: frames %llu, avg %.3f ms, min %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms", frameTimes.size(), average,
+            static_cast<f64>(frameTimes.front()) / 1000.0, percentile(0.5), percentile(0.95), percentile(0.99), static_cast<f64>(frameTimes.back()) / 1000.0);
+
+        const f64 allocations = static_cast<f64>(std::accumulate(m_FrameAllocations.cbegin(), m_FrameAllocations.cend(), 0ULL)) / m_FrameAllocations.size();
+        LOG_INFO("MultithreadedDraws: fps %.1f, allocations per frame avg %.1f, last %llu", 1000.0 / average, allocations, m_FrameAllocations.back());
+
+        if (m_Device && m_Device->getRenderType() == Device::RenderType::Empty)
+        {
+            const null::NullDevice* device = static_cast<const null::NullDevice*>(m_Device);
+            const null::NullCmdList::Statistics& statistics = device->getFrameStatistics();
+            LOG_INFO("MultithreadedDraws: last frame hash %08x, commands %u, draws %u, pipeline switches %u, descriptor binds %u, render targets %u, uploads %u (%llu bytes)",
+                device->getFrameHash(), statistics._commands, statistics._draws, statistics._pipelineSwitches, statistics._descriptorBinds, statistics._renderTargets,
+                statistics._uploads, statistics._uploadBytes);
+        }
+    }
+
     void Exit()
     {
         m_Window->getInputEventReceiver()->dettach(InputEvent::InputEventType::MouseInputEvent);
@@ -158,6 +233,13 @@ private:
     v3d::renderer::Swapchain* m_Swapchain = nullptr;
 
     app::Scene* m_Scene;
+
+    u32 m_FrameCount = 0;
+    std::string m_DumpDirectory;
+    u32 m_DumpInterval = 1;
+    bool m_NullDevice = false;
+    std::vector<u64> m_FrameTimes;
+    std::vector<u64> m_FrameAllocations;
 };
 
 int main(int argc, char* argv[])
@@ -272,8 +272,7 @@ void Scene::Load()
     }
     m_Pipelines.push_back(pipeline);
 
-    std::random_device rd; // obtain a random number from hardware
-    std::mt19937 gen(rd()); // seed the generator
+    std::mt19937 gen(1); // fixed seed, the same layout between the benchmark runs
     std::uniform_int_distribution<> distr(-10, 10); // define the range
 
     const u32 instanceCountPerModel = 40/*000*/; //load from json
@@ -0,0 +1,184 @@
+// Main.cpp : Offline compilation of the shader permutations used by the render techniques.
+// Usage: ShaderPrebake [-o cache_directory] [-j threads] [-r data_root]
+//
+
+#include "Common.h"
+#include "Application.h"
+
+#include "Utils/Logger.h"
+#include "Renderer/Device.h"
+
+#include "Resource/ResourceManager.h"
+#include "Resource/ShaderCache.h"
+#include "Resource/Loader/ShaderSourceFileLoader.h"
+
+#include "Scene/Scene.h"
+#include "RenderTechniques/RenderPipelineZPrepass.h"
+#include "RenderTechniques/RenderPipelineGBuffer.h"
+#include "RenderTechniques/RenderPipelineShadow.h"
+#include "RenderTechniques/RenderPipelineSkybox.h"
+#include "RenderTechniques/RenderPipelineDeferredLighting.h"
+#include "RenderTechniques/RenderPipelineLightAccumulationStage.h"
+#include "RenderTechniques/RenderPipelineMBOIT.h"
+#include "RenderTechniques/RenderPipelineUnlit.h"
+#include "RenderTechniques/RenderPipelineSelection.h"
+#include "RenderTechniques/RenderPipelineOutline.h"
+#include "RenderTechniques/RenderPipelineDebug.h"
+#include "RenderTechniques/RenderPipelineTonemapStage.h"
+#include "RenderTechniques/RenderPipelineFXAA.h"
+#include "RenderTechniques/RenderPipelineTAA.h"
+
+using namespace v3d;
+
+class ShaderPrebakeApplication : public v3d::Application
+{
+public:
+
+    ShaderPrebakeApplication(int& argc, char** argv)
+        : v3d::Application(argc, argv)
+        , m_cacheDirectory("shadercache/")
+        , m_dataRoot("../../../../engine/data/")
+        , m_threads(std::max(std::thread::hardware_concurrency(), 2U) - 1)
+    {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            const std::string option(argv[i]);
+            if (option == "-o")
+            {
+                m_cacheDirectory = argv[i + 1];
+            }
+            else if (option == "-j")
+            {
+                m_threads = std::max(std::atoi(argv[i + 1]), 1);
+            }
+            else if (option == "-r")
+            {
+                m_dataRoot = argv[i + 1];
+            }
+        }
+    }
+
+    ~ShaderPrebakeApplication()
+    {
+        utils::Logger::freeInstance();
+    }
+
+    int execute()
+    {
+        //The null device uses the same SPIR-V decoders as Vulkan, the bake runs on the build machines without a GPU
+        renderer::Device* device = renderer::Device::createDevice(renderer::Device::RenderType::Empty);
+        if (!device)
+        {
+            LOG_ERROR("ShaderPrebake: can't create device");
+            return 1;
+        }
+
+        resource::ShaderCache::getLazyInstance()->setDirectory(m_cacheDirectory);
+        if (!resource::ShaderCache::getInstance()->isEnabled())
+        {
+            renderer::Device::destroyDevice(device);
+            return 1;
+        }
+
+        resource::ResourceManager::createInstance();
+        {
+            //Must match the loader of the application, the compile flags are a part of the cache key
+            auto shaderLoader = std::make_unique<resource::ShaderSourceFileLoader>(device, resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV);
+            shaderLoader->addRoot(m_dataRoot);
+            shaderLoader->addPath("shaders/");
+            resource::ResourceManager::getInstance()->registerLoader<resource::ShaderSourceFileLoader::ResourceType>(std::move(shaderLoader));
+        }
+        resource::ResourceManager::getInstance()->initAsyncLoading(m_threads);
+
+        //Default settings of the scene
+        scene::SceneData sceneData;
+
+        //Every stage of the render techniques, with the compile flags of its create. GBuffer is baked for both bindless modes, the device caps choose at runtime
+        const u32 useDXC = resource::ShaderCompileFlag::ShaderCompile_UseDXCompilerForSpirV;
+        const std::vector<Stage> stages =
+        {
+            { "ZPrepass", scene::RenderPipelineZPrepassStage::getShaderPermutations(sceneData), 0 },
+            { "GBuffer", scene::RenderPipelineGBufferStage::getShaderPermutations(sceneData, false), useDXC },
+            { "GBuffer Bindless", scene::RenderPipelineGBufferStage::getShaderPermutations(sceneData, true), useDXC },
+            { "Shadow", scene::RenderPipelineShadowStage::getShaderPermutations(sceneData), 0 },
+            { "Skybox", scene::RenderPipelineSkyboxStage::getShaderPermutations(sceneData), useDXC },
+            { "DeferredLighting", scene::RenderPipelineDeferredLightingStage::getShaderPermutations(sceneData), 0 },
+            { "LightAccumulation", scene::RenderPipelineLightAccumulationStage::getShaderPermutations(sceneData), 0 },
+            { "MBOIT", scene::RenderPipelineMBOITStage::getShaderPermutations(sceneData), 0 },
+            { "Unlit", scene::RenderPipelineUnlitStage::getShaderPermutations(sceneData), useDXC },
+            { "Selection", scene::RenderPipelineSelectionStage::getShaderPermutations(sceneData), 0 },
+            { "Outline", scene::RenderPipelineOutlineStage::getShaderPermutations(sceneData), useDXC },
+            { "Debug", scene::RenderPipelineDebugStage::getShaderPermutations(sceneData), 0 },
+            { "Tonemap", scene::RenderPipelineTonemapStage::getShaderPermutations(sceneData), useDXC },
+            { "FXAA", scene::RenderPipelineFXAAStage::getShaderPermutations(sceneData), 0 },
+            { "TAA", scene::RenderPipelineTAAStage::getShaderPermutations(sceneData), useDXC },
+        };
+
+        u32 failed = 0;
+        for (const Stage& stage : stages)
+        {
+            failed += prebake(stage._name, stage._permutations, stage._flags);
+        }
+
+        LOG_INFO("ShaderPrebake: cache %s, compiled %llu, cached %llu, failed %u", m_cacheDirectory.c_str(),
+            resource::ShaderCache::getInstance()->getMisses(), resource::ShaderCache::getInstance()->getHits(), failed);
+
+        resource::ResourceManager::getInstance()->shutdownAsyncLoading();
+        resource::ResourceManager::getInstance()->clear();
+        resource::ResourceManager::freeInstance();
+        resource::ShaderCache::freeInstance();
+
+        renderer::Device::destroyDevice(device);
+
+        return failed > 0 ? 1 : 0;
+    }
+
+private:
+
+    struct Stage
+    {
+        std::string                                 _name;
+        std::vector<resource::ShaderPermutation>    _permutations;
+        u32                                         _flags;
+    };
+
+    u32 prebake(const std::string& stage, const std::vector<resource::ShaderPermutation>& permutations, u32 flags)
+    {
+        const std::vector<resource::ShaderPermutationResult> results = resource::ResourceManager::getInstance()->compileShaders(permutations, flags);
+
+        u32 failed = 0;
+        for (u32 index = 0; index < permutations.size(); ++index)
+        {
+            const resource::ShaderPermutation& permutation = permutations[index];
+            const resource::ShaderPermutationResult& result = results[index];
+
+            std::string defines;
+            for (auto& define : permutation._defines)
+            {
+                defines.append(" ").append(define.first).append("=").append(define.second);
+            }
+
+            if (!result._shader)
+            {
+                LOG_ERROR("ShaderPrebake: [%s] %s:%s%s is failed", stage.c_str(), permutation._filename.c_str(), permutation._entrypoint.c_str(), defines.c_str());
+                ++failed;
+                continue;
+            }
+
+            LOG_INFO("ShaderPrebake: [%s] %s:%s%s %s %.3f ms", stage.c_str(), permutation._filename.c_str(), permutation._entrypoint.c_str(), defines.c_str(),
+                result._duplicate ? "duplicate" : "compiled", static_cast<f64>(result._compileTime) / 1000.0);
+        }
+
+        return failed;
+    }
+
+    std::string m_cacheDirectory;
+    std::string m_dataRoot;
+    u32         m_threads;
+};
+
+int main(int argc, char* argv[])
+{
+    ShaderPrebakeApplication app(argc, argv);
+    return app.execute();
+}
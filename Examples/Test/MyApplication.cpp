@@ -41,6 +41,7 @@ using namespace v3d::resource;
 
 
 MyApplication::MyApplication(int& argc, char** argv)
+    : m_failures(0)
 {
 
 }
@@ -51,6 +52,18 @@ int MyApplication::Execute()
     Test_Thread();
     //Test_TaskContainters();
     Test_Task();
+    Test_TaskGraph();
+    Test_OffsetAllocator();
+    Test_BufferStream();
+    Test_MappedFileStream();
+    Test_Logger();
+    Test_ResourceManager();
+    Test_RenderListSorter();
+    Test_Frustum();
+    Test_TransformHierarchy();
+    Test_MaterialParameters();
+    Test_Mipmap();
+    Test_NullDevice();
 
     //Test_Windows();
     //std::thread test_thread([this]() -> void
@@ -63,10 +76,12 @@ int MyApplication::Execute()
     //Test_MemoryPool();
     //Test_ImageLoadStore();
 
-    LOG_DEBUG("Tests are finished");
+    //The tests which report the failures fail the run, ASSERT is compiled out in the Profile configuration
+    const u32 failures = m_failures;
+    LOG_DEBUG("Tests are finished, failed checks %u", failures);
 
     delete this;
-    return 0;
+    return failures > 0 ? 1 : 0;
 }
 
 void MyApplication::Test_ImageLoadStore()
@@ -13,9 +13,21 @@ private:
 
     void Test_Timer();
     void Test_MemoryPool();
+    void Test_OffsetAllocator();
+    void Test_BufferStream();
+    void Test_MappedFileStream();
+    void Test_Logger();
+    void Test_ResourceManager();
+    void Test_RenderListSorter();
+    void Test_Frustum();
+    void Test_MaterialParameters();
+    void Test_Mipmap();
+    void Test_TransformHierarchy();
+    void Test_NullDevice();
     void Test_Thread();
     void Test_TaskContainters();
     void Test_Task();
+    void Test_TaskGraph();
     void Test_Windows();
 
     void Test_ImageLoadStore();
@@ -24,4 +36,6 @@ private:
     void Test_CreateShaderProgram();
     void Test_ShaderParam();
     void Test_CreatePipeline();
+
+    unsigned int m_failures;
 };
@@ -0,0 +1,154 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Stream/BufferStream.h"
+#include "Stream/MemoryStream.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_bufferStreamRecords = 500;
+
+    /**
+    * @brief One record of every type the streams encode
+    */
+    struct StreamRecord
+    {
+        u8          _u8;
+        s16         _s16;
+        u32         _u32;
+        s64         _s64;
+        f32         _f32;
+        f64         _f64;
+        f80         _f80;
+        bool        _bool;
+        std::string _string;
+    };
+
+    std::vector<StreamRecord> makeRecords(u32 count, std::mt19937& random)
+    {
+        std::uniform_int_distribution<u64> integer;
+        std::uniform_real_distribution<f64> real(-1.0e6, 1.0e6);
+        std::uniform_int_distribution<u32> length(0, 40);
+
+        std::vector<StreamRecord> records(count);
+        for (StreamRecord& record : records)
+        {
+            record._u8 = static_cast<u8>(integer(random));
+            record._s16 = static_cast<s16>(integer(random));
+            record._u32 = static_cast<u32>(integer(random));
+            record._s64 = static_cast<s64>(integer(random));
+            record._f32 = static_cast<f32>(real(random));
+            record._f64 = real(random);
+            record._f80 = static_cast<f80>(real(random));
+            record._bool = (integer(random) & 1) != 0;
+            record._string.assign(length(random), static_cast<c8>('a' + integer(random) % 26));
+        }
+
+        return records;
+    }
+
+    template<class TStream>
+    void writeRecords(TStream& stream, const std::vector<StreamRecord>& records)
+    {
+        for (const StreamRecord& record : records)
+        {
+            stream.write(record._u8);
+            stream.write(record._s16);
+            stream.write(record._u32);
+            stream.write(record._s64);
+            stream.write(record._f32);
+            stream.write(record._f64);
+            stream.write(record._f80);
+            stream.write(record._bool);
+            stream.write(record._string);
+        }
+    }
+
+    template<class TStream>
+    bool readRecords(const TStream& stream, const std::vector<StreamRecord>& records)
+    {
+        for (const StreamRecord& record : records)
+        {
+            StreamRecord value = {};
+            stream.read(value._u8);
+            stream.read(value._s16);
+            stream.read(value._u32);
+            stream.read(value._s64);
+            stream.read(value._f32);
+            stream.read(value._f64);
+            stream.read(value._f80);
+            stream.read(value._bool);
+            stream.read(value._string);
+
+            //f80 is stored as f64, the source values are f64
+            if (value._u8 != record._u8 || value._s16 != record._s16 || value._u32 != record._u32 || value._s64 != record._s64 ||
+                value._f32 != record._f32 || value._f64 != record._f64 || value._f80 != record._f80 || value._bool != record._bool || value._string != record._string)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+void MyApplication::Test_BufferStream()
+{
+    LOG_DEBUG("Test_BufferStream");
+
+    std::mt19937 random(42);
+    const std::vector<StreamRecord> records = makeRecords(k_bufferStreamRecords, random);
+
+    stream::MemoryStream memory;
+    writeRecords(memory, records);
+    memory.seekBeg(0);
+    if (!readRecords(memory, records))
+    {
+        LOG_ERROR("Test_BufferStream: MemoryStream round trip failed");
+        ++m_failures;
+    }
+
+    memory.seekBeg(0);
+    const u8* memoryData = memory.map(memory.size());
+
+    //Odd chunk sizes put the values across the chunk boundaries
+    const u32 failures = m_failures;
+    for (u64 chunkSize : { 1ULL, 3ULL, 7ULL, 13ULL, 64ULL, stream::BufferStream::k_defaultChunkSize })
+    {
+        stream::BufferStream buffer(chunkSize);
+        writeRecords(buffer, records);
+
+        if (buffer.size64() != memory.size())
+        {
+            LOG_ERROR("Test_BufferStream chunk %llu: size %llu, MemoryStream size %u", chunkSize, buffer.size64(), memory.size());
+            ++m_failures;
+            continue;
+        }
+
+        std::vector<u8> bytes(buffer.size64());
+        buffer.seek64(0);
+        buffer.read64(bytes.data(), bytes.size());
+        if (memcmp(bytes.data(), memoryData, bytes.size()) != 0)
+        {
+            LOG_ERROR("Test_BufferStream chunk %llu: the encoding differs from MemoryStream", chunkSize);
+            ++m_failures;
+        }
+
+        buffer.seek64(0);
+        if (!readRecords(buffer, records) || buffer.tell64() != buffer.size64())
+        {
+            LOG_ERROR("Test_BufferStream chunk %llu: round trip failed", chunkSize);
+            ++m_failures;
+        }
+    }
+    memory.unmap();
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_BufferStream: %u records passed", k_bufferStreamRecords);
+    }
+}
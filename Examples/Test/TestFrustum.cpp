@@ -0,0 +1,162 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Math/Frustum.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_frustumViews = 64;
+    constexpr u32 k_frustumBoxes = 4'000;
+    constexpr f32 k_frustumWorldSize = 200.f;
+    constexpr f32 k_frustumTolerance = 1e-3f; //The boxes which touch a plane are skipped, the batch and the reference round differently
+
+    enum class Expected
+    {
+        Inside,
+        Outside,
+        Touching
+    };
+
+    /**
+    * @brief Reference by the 8 corners, a box is outside if all corners are behind one plane
+    */
+    Expected referenceInside(const math::Frustum& frustum, const math::AABB& aabb)
+    {
+        const math::float3& min = aabb.getMin();
+        const math::float3& max = aabb.getMax();
+
+        bool touching = false;
+        for (u32 plane = 0; plane < frustum.getPlaneCount(); ++plane)
+        {
+            const math::Vector4D& equation = frustum.getPlane(plane);
+
+            f32 distance = std::numeric_limits<f32>::lowest();
+            for (u32 corner = 0; corner < 8; ++corner)
+            {
+                const f32 x = (corner & 1) ? max._x : min._x;
+                const f32 y = (corner & 2) ? max._y : min._y;
+                const f32 z = (corner & 4) ? max._z : min._z;
+                distance = std::max(distance, equation.getX() * x + equation.getY() * y + equation.getZ() * z + equation.getW());
+            }
+
+            if (distance < -k_frustumTolerance)
+            {
+                return Expected::Outside;
+            }
+            touching |= distance < k_frustumTolerance;
+        }
+
+        return touching ? Expected::Touching : Expected::Inside;
+    }
+}
+
+void MyApplication::Test_Frustum()
+{
+    LOG_DEBUG("Test_Frustum");
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<f32> position(-k_frustumWorldSize * 0.5f, k_frustumWorldSize * 0.5f);
+    std::uniform_real_distribution<f32> extent(0.1f, 10.f);
+    std::uniform_real_distribution<f32> offset(-1.f, 1.f);
+    std::uniform_int_distribution<u32> invalid(0, 31);
+
+    std::vector<math::AABB> boxes(k_frustumBoxes);
+    for (math::AABB& box : boxes)
+    {
+        //Some boxes are invalid, they are never culled
+        if (invalid(random) == 0)
+        {
+            continue;
+        }
+
+        const math::float3 center(position(random), position(random), position(random));
+        const math::float3 halfSize(extent(random), extent(random), extent(random));
+        box = math::AABB(center - halfSize, center + halfSize);
+    }
+
+    const u32 failures = m_failures;
+    u32 tested = 0;
+    u32 inside = 0;
+    for (u32 view = 0; view < k_frustumViews; ++view)
+    {
+        const math::Vector3D eye(position(random), position(random), position(random));
+        math::Vector3D direction(offset(random), offset(random), offset(random));
+        direction.normalize();
+
+        const math::Matrix4D projection = (view % 2 == 0)
+            ? math::SMatrix::projectionMatrixPerspective(60.f * math::k_degToRad, 16.f / 9.f, 0.1f, 100.f)
+            : math::SMatrix::projectionMatrixOrtho(-50.f, 50.f, -30.f, 30.f, 0.1f, 100.f);
+        const math::Matrix4D viewMatrix = math::SMatrix::lookAtMatrix(eye, eye + direction, math::Vector3D(0.f, 1.f, 0.f));
+
+        math::Frustum frustum(projection * viewMatrix);
+        if (view % 4 == 3)
+        {
+            //The shadow volume, the planes which the light crosses are removed
+            math::Vector3D light(offset(random), -1.f, offset(random));
+            light.normalize();
+            frustum.extrude(light);
+        }
+
+        //The point in front of the camera is inside, the point behind is outside
+        const math::Vector3D front = eye + direction * 10.f;
+        const math::Vector3D back = eye - direction * 10.f;
+        const math::AABB frontBox(math::float3(front.getX() - 0.1f, front.getY() - 0.1f, front.getZ() - 0.1f), math::float3(front.getX() + 0.1f, front.getY() + 0.1f, front.getZ() + 0.1f));
+        const math::AABB backBox(math::float3(back.getX() - 0.1f, back.getY() - 0.1f, back.getZ() - 0.1f), math::float3(back.getX() + 0.1f, back.getY() + 0.1f, back.getZ() + 0.1f));
+        if (!frustum.isInside(frontBox) || (frustum.getPlaneCount() == math::Frustum::PlaneCount && frustum.isInside(backBox)))
+        {
+            LOG_ERROR("Test_Frustum view %u: the boxes in front and behind the camera are culled wrong", view);
+            ++m_failures;
+        }
+
+        //Batches of every size, the result mask has a bit per box
+        for (u32 first = 0; first < k_frustumBoxes; first += math::k_frustumBatchSize)
+        {
+            const u32 count = 1 + (first / math::k_frustumBatchSize) % math::k_frustumBatchSize;
+            const math::AABB* batch[math::k_frustumBatchSize] = {};
+            for (u32 lane = 0; lane < count; ++lane)
+            {
+                batch[lane] = &boxes[(first + lane) % k_frustumBoxes];
+            }
+
+            const u32 mask = frustum.isInside(batch, count);
+            if (mask >> count)
+            {
+                LOG_ERROR("Test_Frustum view %u: the mask %x has bits above %u boxes", view, mask, count);
+                ++m_failures;
+            }
+
+            for (u32 lane = 0; lane < count; ++lane)
+            {
+                const bool result = (mask >> lane) & 1;
+                if (result != frustum.isInside(*batch[lane]))
+                {
+                    LOG_ERROR("Test_Frustum view %u: box %u differs in the batch and alone", view, first + lane);
+                    ++m_failures;
+                }
+
+                const Expected expected = batch[lane]->isValid() ? referenceInside(frustum, *batch[lane]) : Expected::Inside;
+                if (expected == Expected::Touching)
+                {
+                    continue;
+                }
+
+                ++tested;
+                inside += result ? 1 : 0;
+                if (result != (expected == Expected::Inside))
+                {
+                    LOG_ERROR("Test_Frustum view %u: box %u is %s, the reference is %s", view, first + lane, result ? "inside" : "outside", result ? "outside" : "inside");
+                    ++m_failures;
+                }
+            }
+        }
+    }
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_Frustum: %u boxes passed, %u inside", tested, inside);
+    }
+}
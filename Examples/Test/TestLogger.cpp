@@ -0,0 +1,78 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_loggerMessages = 3'000;
+    constexpr u32 k_loggerLongEvery = 7;
+    constexpr u32 k_loggerLongSize = 600; //Above the size of an async record, written synchronously
+}
+
+void MyApplication::Test_Logger()
+{
+    LOG_DEBUG("Test_Logger");
+
+    std::error_code error;
+    const std::filesystem::path folder = std::filesystem::temp_directory_path(error) / "v3d_test_logger";
+    std::filesystem::create_directories(folder, error);
+    const std::string fileName = (folder / "logger.log").string();
+
+    //The LOG_ macros write only to the console, the file gets the messages of this test only
+    utils::Logger* logger = utils::Logger::getLazyInstance();
+    logger->createLogFile(fileName);
+    logger->setAsyncMode(true, utils::Logger::AsyncPolicy::Block);
+
+    const std::string padding(k_loggerLongSize, '-');
+    for (u32 index = 0; index < k_loggerMessages; ++index)
+    {
+        if (index % k_loggerLongEvery == 0)
+        {
+            logger->log(utils::Logger::LoggerInfo, utils::Logger::FileLog, "%u %s", index, padding.c_str());
+        }
+        else
+        {
+            logger->log(utils::Logger::LoggerInfo, utils::Logger::FileLog, "%u", index);
+        }
+    }
+
+    logger->flush();
+    logger->setAsyncMode(false);
+    logger->createLogFile("logfile.log");
+
+    //Every message is in the file once, in the order of the calls
+    const u32 failures = m_failures;
+    std::ifstream file(fileName);
+    std::string line;
+    u32 expected = 0;
+    while (std::getline(file, line))
+    {
+        u32 index = ~0U;
+        if (sscanf(line.c_str(), "%*[^:]: %u", &index) != 1 || index != expected)
+        {
+            LOG_ERROR("Test_Logger: message %u is written at the place of message %u", index, expected);
+            ++m_failures;
+            break;
+        }
+        ++expected;
+    }
+    file.close();
+
+    if (m_failures == failures && expected != k_loggerMessages)
+    {
+        LOG_ERROR("Test_Logger: %u of %u messages are written", expected, k_loggerMessages);
+        ++m_failures;
+    }
+
+    std::filesystem::remove_all(folder, error);
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_Logger: %u messages passed", k_loggerMessages);
+    }
+}
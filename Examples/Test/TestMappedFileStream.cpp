@@ -0,0 +1,150 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Stream/FileStream.h"
+#include "Stream/MappedFileStream.h"
+
+#include <filesystem>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_mappedFileMagic = 0x4D415050;
+    constexpr u32 k_mappedFilePayloadSize = 5 * 1024 * 1024 + 3; //Above the read ahead hint size, not a multiple of the page size
+
+    u8 mappedFilePattern(u32 index)
+    {
+        return static_cast<u8>(index * 31 + 7);
+    }
+}
+
+void MyApplication::Test_MappedFileStream()
+{
+    LOG_DEBUG("Test_MappedFileStream");
+
+    std::error_code error;
+    const std::filesystem::path folder = std::filesystem::temp_directory_path(error) / "v3d_test_mapped";
+    std::filesystem::create_directories(folder, error);
+    const std::string fileName = (folder / "mapped.bin").string();
+    const std::string emptyName = (folder / "empty.bin").string();
+
+    const f64 headerValue = 1234.5678;
+    const std::string headerName = "mapped file stream";
+    u32 headerSize = 0;
+    {
+        std::vector<u8> payload(k_mappedFilePayloadSize);
+        for (u32 index = 0; index < k_mappedFilePayloadSize; ++index)
+        {
+            payload[index] = mappedFilePattern(index);
+        }
+
+        stream::FileStream file(fileName, stream::FileStream::e_out);
+        stream::FileStream empty(emptyName, stream::FileStream::e_out);
+        if (!file.isOpen() || !empty.isOpen())
+        {
+            LOG_ERROR("Test_MappedFileStream: can't write to %s", folder.string().c_str());
+            ++m_failures;
+            return;
+        }
+
+        file.write(k_mappedFileMagic);
+        file.write(headerValue);
+        file.write(headerName);
+        headerSize = file.tell();
+        file.write(payload.data(), k_mappedFilePayloadSize);
+    }
+
+    const u32 failures = m_failures;
+    {
+        stream::MappedFileStream stream;
+        if (!stream.open(fileName) || !stream.isOpen() || stream.size() != headerSize + k_mappedFilePayloadSize)
+        {
+            LOG_ERROR("Test_MappedFileStream: open of %s failed or the size is wrong", fileName.c_str());
+            ++m_failures;
+            return;
+        }
+
+        //Values are read as FileStream wrote them
+        u32 magic = 0;
+        f64 value = 0.0;
+        std::string name;
+        stream.read(magic);
+        stream.read(value);
+        stream.read(name);
+        if (magic != k_mappedFileMagic || value != headerValue || name != headerName || stream.tell() != headerSize)
+        {
+            LOG_ERROR("Test_MappedFileStream: the header values differ");
+            ++m_failures;
+        }
+
+        //map returns a pointer into the view
+        const u8* payload = stream.map(k_mappedFilePayloadSize);
+        u32 mismatch = k_mappedFilePayloadSize;
+        for (u32 index = 0; index < k_mappedFilePayloadSize; ++index)
+        {
+            if (payload[index] != mappedFilePattern(index))
+            {
+                mismatch = index;
+                break;
+            }
+        }
+        stream.unmap();
+
+        if (mismatch != k_mappedFilePayloadSize || stream.tell() != stream.size())
+        {
+            LOG_ERROR("Test_MappedFileStream: the mapped payload differs at %u", mismatch);
+            ++m_failures;
+        }
+
+        //Reads past the end return only the whole elements
+        const u32 tail = 10;
+        stream.seekBeg(stream.size() - tail);
+        u32 elements[4] = {};
+        const u32 bytes = stream.read(elements, sizeof(u32), 4);
+        if (bytes != 2 * sizeof(u32) || stream.tell() != stream.size() - tail + bytes)
+        {
+            LOG_ERROR("Test_MappedFileStream: the read at the end returns %u bytes", bytes);
+            ++m_failures;
+        }
+
+        u8 middle = 0;
+        stream.seekBeg(headerSize + k_mappedFilePayloadSize / 2);
+        stream.read(middle);
+        if (middle != mappedFilePattern(k_mappedFilePayloadSize / 2))
+        {
+            LOG_ERROR("Test_MappedFileStream: the read after seek differs");
+            ++m_failures;
+        }
+
+        stream.close();
+        if (stream.isOpen())
+        {
+            LOG_ERROR("Test_MappedFileStream: the stream is open after close");
+            ++m_failures;
+        }
+    }
+
+    {
+        stream::MappedFileStream empty;
+        if (!empty.open(emptyName) || empty.size() != 0)
+        {
+            LOG_ERROR("Test_MappedFileStream: open of an empty file failed");
+            ++m_failures;
+        }
+
+        stream::MappedFileStream missing;
+        if (missing.open((folder / "missing.bin").string()) || missing.isOpen())
+        {
+            LOG_ERROR("Test_MappedFileStream: open of a missing file succeeded");
+            ++m_failures;
+        }
+    }
+
+    std::filesystem::remove_all(folder, error);
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_MappedFileStream: %u bytes passed", headerSize + k_mappedFilePayloadSize);
+    }
+}
@@ -0,0 +1,132 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Scene/Material.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_materialTestChanges = 2'000;
+
+    const c8* const k_materialTextureNames[scene::MaterialParameters::TextureCount] =
+    {
+        "BaseColor", "Normals", "Roughness", "Metalness", "Displacement", "Diffuse", "Specular"
+    };
+
+    const c8* const k_materialColorNames[scene::MaterialParameters::ColorCount] =
+    {
+        "Color", "DiffuseColor", "ColorDiffuse"
+    };
+
+    bool isSameHandle(const ObjectHandle& left, const ObjectHandle& right)
+    {
+        return left._type == right._type && left._object == right._object;
+    }
+
+    bool isSameColor(const math::float4& left, const math::float4& right)
+    {
+        return left._x == right._x && left._y == right._y && left._z == right._z && left._w == right._w;
+    }
+}
+
+void MyApplication::Test_MaterialParameters()
+{
+    LOG_DEBUG("Test_MaterialParameters");
+
+    //The handles are only compared, the materials stand for the textures
+    scene::Material* material = V3D_NEW(scene::Material, memory::MemoryLabel::MemoryObject)(nullptr);
+    scene::Material* textures[2] =
+    {
+        V3D_NEW(scene::Material, memory::MemoryLabel::MemoryObject)(nullptr),
+        V3D_NEW(scene::Material, memory::MemoryLabel::MemoryObject)(nullptr)
+    };
+
+    std::mt19937 random(5);
+    std::uniform_int_distribution<u32> kind(0, 4);
+    std::uniform_real_distribution<f32> value(-1.f, 1.f);
+
+    //Every change is a property of the block or an unrelated one, sometimes of a wrong type which resolves to the default
+    const u32 failures = m_failures;
+    for (u32 change = 0; change < k_materialTestChanges; ++change)
+    {
+        const u64 version = material->getVersion();
+        const bool wrongType = (change % 5) == 4;
+        switch (kind(random))
+        {
+        case 0:
+        {
+            const c8* name = k_materialTextureNames[change % scene::MaterialParameters::TextureCount];
+            wrongType ? material->setProperty<u32>(name, change) : material->setProperty<ObjectHandle>(name, ObjectHandle(textures[change % 2]));
+            break;
+        }
+
+        case 1:
+        {
+            const c8* name = k_materialColorNames[change % scene::MaterialParameters::ColorCount];
+            wrongType ? material->setProperty<f32>(name, value(random)) : material->setProperty<math::float4>(name, { value(random), value(random), value(random), value(random) });
+            break;
+        }
+
+        case 2:
+            wrongType ? material->setProperty<f32>("materialID", value(random)) : material->setProperty<u32>("materialID", change);
+            break;
+
+        case 3:
+            wrongType ? material->setProperty<f32>("pipelineID", value(random)) : material->setProperty<u32>("pipelineID", change);
+            break;
+
+        case 4:
+            material->setProperty<f32>("Roughness_Factor", value(random));
+            break;
+        }
+
+        if (material->getVersion() != version + 1)
+        {
+            LOG_ERROR("Test_MaterialParameters change %u: the version %llu, expected %llu", change, material->getVersion(), version + 1);
+            ++m_failures;
+        }
+
+        //The block is the same as the property map reads
+        const scene::MaterialParameters& parameters = material->getParameters();
+        for (u32 index = 0; index < scene::MaterialParameters::TextureCount; ++index)
+        {
+            if (!isSameHandle(parameters._textures[index], material->getProperty<ObjectHandle>(k_materialTextureNames[index])))
+            {
+                LOG_ERROR("Test_MaterialParameters change %u: the texture %s differs from the property", change, k_materialTextureNames[index]);
+                ++m_failures;
+            }
+        }
+
+        for (u32 index = 0; index < scene::MaterialParameters::ColorCount; ++index)
+        {
+            if (!isSameColor(parameters._colors[index], material->getProperty<math::float4>(k_materialColorNames[index])))
+            {
+                LOG_ERROR("Test_MaterialParameters change %u: the color %s differs from the property", change, k_materialColorNames[index]);
+                ++m_failures;
+            }
+        }
+
+        if (parameters._materialID != material->getProperty<u32>("materialID") || parameters._pipelineID != material->getProperty<u32>("pipelineID"))
+        {
+            LOG_ERROR("Test_MaterialParameters change %u: the IDs %u %u differ from the properties", change, parameters._materialID, parameters._pipelineID);
+            ++m_failures;
+        }
+
+        if (m_failures != failures)
+        {
+            break;
+        }
+    }
+
+    V3D_DELETE(material, memory::MemoryLabel::MemoryObject);
+    V3D_DELETE(textures[0], memory::MemoryLabel::MemoryObject);
+    V3D_DELETE(textures[1], memory::MemoryLabel::MemoryObject);
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_MaterialParameters: %u changes passed", k_materialTestChanges);
+    }
+}
@@ -0,0 +1,270 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Resource/MipmapGenerator.h"
+#include "Resource/ResourceManager.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    struct MipmapCase
+    {
+        u32                                        _width;
+        u32                                        _height;
+        u32                                        _components;
+        resource::MipmapGenerator::ComponentType   _type;
+        bool                                       _srgb;
+    };
+
+    //Odd and non square sizes take the clamped edge, the small ones don't reach the SIMD loops
+    constexpr MipmapCase k_mipmapCases[] =
+    {
+        { 256, 256, 4, resource::MipmapGenerator::ComponentType::UNorm8, false },
+        { 129, 67, 4, resource::MipmapGenerator::ComponentType::UNorm8, false },
+        { 7, 5, 3, resource::MipmapGenerator::ComponentType::UNorm8, false },
+        { 96, 40, 1, resource::MipmapGenerator::ComponentType::UNorm8, false },
+        { 130, 66, 2, resource::MipmapGenerator::ComponentType::UNorm8, false },
+        { 128, 128, 4, resource::MipmapGenerator::ComponentType::UNorm16, false },
+        { 33, 77, 1, resource::MipmapGenerator::ComponentType::UNorm16, false },
+        { 200, 100, 4, resource::MipmapGenerator::ComponentType::Float32, false },
+        { 257, 65, 1, resource::MipmapGenerator::ComponentType::Float32, false },
+        { 128, 64, 4, resource::MipmapGenerator::ComponentType::UNorm8, true },
+        { 45, 90, 3, resource::MipmapGenerator::ComponentType::UNorm8, true },
+    };
+
+    constexpr f64 k_mipmapFloatTolerance = 1e-5;
+    constexpr f64 k_mipmapSrgbTolerance = 1.0; //The generator encodes through f32 tables, a value on the edge of two codes can take either
+
+    u32 getComponentSize(resource::MipmapGenerator::ComponentType type)
+    {
+        switch (type)
+        {
+        case resource::MipmapGenerator::ComponentType::UNorm16:
+            return sizeof(u16);
+
+        case resource::MipmapGenerator::ComponentType::Float32:
+            return sizeof(f32);
+
+        default:
+            return sizeof(u8);
+        }
+    }
+
+    f64 srgbToLinear(f64 value)
+    {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    f64 linearToSrgb(f64 value)
+    {
+        return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+    }
+
+    /**
+    * @brief 2x2 box reference of the level, returns the largest difference from the generated level
+    */
+    template<typename T>
+    f64 compareBoxLevel(const MipmapCase& image, const T* src, u32 width, u32 height, const T* dst)
+    {
+        const u32 dstWidth = std::max(width / 2, 1U);
+        const u32 dstHeight = std::max(height / 2, 1U);
+
+        f64 maxDifference = 0.0;
+        for (u32 y = 0; y < dstHeight; ++y)
+        {
+            const u32 y0 = std::min(2 * y, height - 1);
+            const u32 y1 = std::min(2 * y + 1, height - 1);
+            for (u32 x = 0; x < dstWidth; ++x)
+            {
+                const u32 x0 = std::min(2 * x, width - 1);
+                const u32 x1 = std::min(2 * x + 1, width - 1);
+                for (u32 c = 0; c < image._components; ++c)
+                {
+                    auto at = [&](u32 px, u32 py) -> f64
+                        {
+                            return static_cast<f64>(src[(static_cast<u64>(py) * width + px) * image._components + c]);
+                        };
+
+                    f64 expected = 0.0;
+                    const bool alpha = image._components == 4 && c == 3;
+                    if (image._srgb && !alpha)
+                    {
+                        const f64 linear = (srgbToLinear(at(x0, y0) / 255.0) + srgbToLinear(at(x1, y0) / 255.0) + srgbToLinear(at(x0, y1) / 255.0) + srgbToLinear(at(x1, y1) / 255.0)) * 0.25;
+                        expected = std::round(linearToSrgb(linear) * 255.0);
+                    }
+                    else if constexpr (std::is_floating_point_v<T>)
+                    {
+                        expected = (at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1)) * 0.25;
+                    }
+                    else
+                    {
+                        expected = static_cast<f64>((static_cast<u32>(at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1)) + 2) >> 2);
+                    }
+
+                    const f64 result = static_cast<f64>(dst[(static_cast<u64>(y) * dstWidth + x) * image._components + c]);
+                    maxDifference = std::max(maxDifference, std::abs(result - expected));
+                }
+            }
+        }
+
+        return maxDifference;
+    }
+
+    template<typename T>
+    f64 compareBoxChain(const MipmapCase& image, u32 mipmapCount, const std::vector<u8>& chain)
+    {
+        const T* src = reinterpret_cast<const T*>(chain.data());
+        u32 width = image._width;
+        u32 height = image._height;
+
+        f64 maxDifference = 0.0;
+        for (u32 mip = 1; mip < mipmapCount; ++mip)
+        {
+            const T* dst = src + static_cast<u64>(width) * height * image._components;
+            maxDifference = std::max(maxDifference, compareBoxLevel<T>(image, src, width, height, dst));
+
+            src = dst;
+            width = std::max(width / 2, 1U);
+            height = std::max(height / 2, 1U);
+        }
+
+        return maxDifference;
+    }
+}
+
+void MyApplication::Test_Mipmap()
+{
+    LOG_DEBUG("Test_Mipmap");
+
+    resource::MipmapGenerator* generator = resource::MipmapGenerator::getLazyInstance();
+    resource::ResourceManager* manager = resource::ResourceManager::getLazyInstance();
+    std::mt19937 random(3);
+
+    const u32 failures = m_failures;
+    for (const MipmapCase& image : k_mipmapCases)
+    {
+        resource::MipmapGenerator::ImageDesc desc;
+        desc._width = image._width;
+        desc._height = image._height;
+        desc._components = image._components;
+        desc._type = image._type;
+        desc._srgb = image._srgb;
+
+        const u32 mipmapCount = resource::MipmapGenerator::calculateMipmapCount(image._width, image._height);
+        const u64 chainSize = resource::MipmapGenerator::calculateMipmapChainSize(desc, mipmapCount);
+        const u64 baseValues = static_cast<u64>(image._width) * image._height * image._components;
+
+        std::vector<u8> chain(chainSize, 0xcd);
+        for (u64 index = 0; index < baseValues; ++index)
+        {
+            switch (image._type)
+            {
+            case resource::MipmapGenerator::ComponentType::UNorm8:
+                chain[index] = static_cast<u8>(random());
+                break;
+
+            case resource::MipmapGenerator::ComponentType::UNorm16:
+                reinterpret_cast<u16*>(chain.data())[index] = static_cast<u16>(random());
+                break;
+
+            case resource::MipmapGenerator::ComponentType::Float32:
+                reinterpret_cast<f32*>(chain.data())[index] = std::uniform_real_distribution<f32>(-1.f, 1.f)(random);
+                break;
+            }
+        }
+
+        //The loading threads split the rows, the result must be the same as in the calling thread
+        std::vector<u8> threaded(chain);
+        generator->generate(desc, resource::MipmapFilter::Box, mipmapCount, chain.data());
+        manager->initAsyncLoading(3);
+        generator->generate(desc, resource::MipmapFilter::Box, mipmapCount, threaded.data());
+        manager->shutdownAsyncLoading();
+
+        if (chain != threaded)
+        {
+            LOG_ERROR("Test_Mipmap %ux%ux%u type %u: the loading threads give a different chain", image._width, image._height, image._components, image._type);
+            ++m_failures;
+        }
+
+        f64 difference = 0.0;
+        f64 tolerance = 0.0;
+        switch (image._type)
+        {
+        case resource::MipmapGenerator::ComponentType::UNorm8:
+            difference = compareBoxChain<u8>(image, mipmapCount, chain);
+            tolerance = image._srgb ? k_mipmapSrgbTolerance : 0.0;
+            break;
+
+        case resource::MipmapGenerator::ComponentType::UNorm16:
+            difference = compareBoxChain<u16>(image, mipmapCount, chain);
+            break;
+
+        case resource::MipmapGenerator::ComponentType::Float32:
+            difference = compareBoxChain<f32>(image, mipmapCount, chain);
+            tolerance = k_mipmapFloatTolerance;
+            break;
+        }
+
+        if (difference > tolerance)
+        {
+            LOG_ERROR("Test_Mipmap %ux%ux%u type %u srgb %u: the box filter differs from the reference by %f", image._width, image._height, image._components, image._type, image._srgb, difference);
+            ++m_failures;
+        }
+
+        //The Kaiser weights are normalized, a flat image stays flat
+        std::vector<u8> flat(chainSize, 0);
+        const u8 level = static_cast<u8>(random());
+        for (u64 index = 0; index < baseValues; ++index)
+        {
+            switch (image._type)
+            {
+            case resource::MipmapGenerator::ComponentType::UNorm8:
+                flat[index] = level;
+                break;
+
+            case resource::MipmapGenerator::ComponentType::UNorm16:
+                reinterpret_cast<u16*>(flat.data())[index] = static_cast<u16>(level) * 257;
+                break;
+
+            case resource::MipmapGenerator::ComponentType::Float32:
+                reinterpret_cast<f32*>(flat.data())[index] = static_cast<f32>(level) / 255.f;
+                break;
+            }
+        }
+        generator->generate(desc, resource::MipmapFilter::Kaiser, mipmapCount, flat.data());
+
+        const u64 chainValues = chainSize / getComponentSize(image._type);
+        u32 changed = 0;
+        for (u64 index = baseValues; index < chainValues; ++index)
+        {
+            switch (image._type)
+            {
+            case resource::MipmapGenerator::ComponentType::UNorm8:
+                changed += std::abs(static_cast<s32>(flat[index]) - level) > 1 ? 1 : 0;
+                break;
+
+            case resource::MipmapGenerator::ComponentType::UNorm16:
+                changed += std::abs(static_cast<s32>(reinterpret_cast<const u16*>(flat.data())[index]) - level * 257) > 1 ? 1 : 0;
+                break;
+
+            case resource::MipmapGenerator::ComponentType::Float32:
+                changed += std::abs(reinterpret_cast<const f32*>(flat.data())[index] - static_cast<f32>(level) / 255.f) > 1e-4f ? 1 : 0;
+                break;
+            }
+        }
+
+        if (changed > 0)
+        {
+            LOG_ERROR("Test_Mipmap %ux%ux%u type %u: the Kaiser filter changes %u values of a flat image", image._width, image._height, image._components, image._type, changed);
+            ++m_failures;
+        }
+    }
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_Mipmap: %u images passed", static_cast<u32>(std::size(k_mipmapCases)));
+    }
+}
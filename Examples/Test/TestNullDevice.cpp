@@ -0,0 +1,164 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Renderer/Device.h"
+#include "Renderer/Texture.h"
+#include "Renderer/Buffer.h"
+#include "Renderer/Swapchain.h"
+#include "Renderer/Shader.h"
+#include "Renderer/Null/NullDevice.h"
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_nullDeviceFrames = 4;
+    constexpr u32 k_nullDeviceCommands = 11; //Per frame
+    constexpr u32 k_nullDeviceBufferSize = 256;
+    constexpr u32 k_nullDeviceTextureSize = 4 * 4 * 4;
+
+    /**
+    * @brief NullDeviceObjects struct. The names and the descriptions are the same on every device, so are the keys
+    */
+    struct NullDeviceObjects
+    {
+        renderer::Device*                   _device = nullptr;
+        renderer::Swapchain*                _swapchain = nullptr;
+        renderer::Texture2D*                _texture = nullptr;
+        renderer::UnorderedAccessBuffer*    _buffers[2] = {};
+        renderer::null::NullCmdList*        _cmdList = nullptr;
+    };
+
+    NullDeviceObjects createObjects()
+    {
+        NullDeviceObjects objects;
+        objects._device = renderer::Device::createDevice(renderer::Device::RenderType::Empty, renderer::Device::GraphicMask);
+
+        renderer::Swapchain::SwapchainParams params;
+        params._size = { 64, 64 };
+        objects._swapchain = objects._device->createSwapchain(nullptr, params);
+        objects._texture = V3D_NEW(renderer::Texture2D, memory::MemoryLabel::MemoryObject)(objects._device, renderer::TextureUsage::TextureUsage_Sampled | renderer::TextureUsage_Write,
+            renderer::Format::Format_R8G8B8A8_UNorm, math::Dimension2D(4, 4), 1, 1, "null_device_texture");
+        for (u32 index = 0; index < 2; ++index)
+        {
+            objects._buffers[index] = V3D_NEW(renderer::UnorderedAccessBuffer, memory::MemoryLabel::MemoryObject)(objects._device, renderer::BufferUsage::Buffer_GPUOnly,
+                k_nullDeviceBufferSize, "null_device_buffer_" + std::to_string(index));
+        }
+        objects._cmdList = objects._device->createCommandList<renderer::null::NullCmdList>(renderer::Device::GraphicMask);
+
+        return objects;
+    }
+
+    void destroyObjects(NullDeviceObjects& objects)
+    {
+        objects._device->destroyCommandList(objects._cmdList);
+        V3D_DELETE(objects._texture, memory::MemoryLabel::MemoryObject);
+        V3D_DELETE(objects._buffers[0], memory::MemoryLabel::MemoryObject);
+        V3D_DELETE(objects._buffers[1], memory::MemoryLabel::MemoryObject);
+        objects._device->destroySwapchain(objects._swapchain);
+        renderer::Device::destroyDevice(objects._device);
+    }
+
+    /**
+    * @brief Every frame records the same commands, the values depend on the frame
+    */
+    void recordFrame(const NullDeviceObjects& objects, u32 frame)
+    {
+        u8 data[k_nullDeviceBufferSize];
+        for (u32 index = 0; index < k_nullDeviceBufferSize; ++index)
+        {
+            data[index] = static_cast<u8>(index * 7 + frame);
+        }
+
+        renderer::null::NullCmdList* cmdList = objects._cmdList;
+        cmdList->beginDebugMarker("null_device_frame", color::Color(1.f, 0.f, 0.f, 1.f));
+        cmdList->setViewport({ 0.f, 0.f, 64.f, 64.f });
+        cmdList->setScissor({ 0.f, 0.f, 64.f, 64.f });
+        cmdList->clear(objects._swapchain->getBackbuffer(), color::Color(static_cast<f32>(frame) / k_nullDeviceFrames, 0.f, 0.f, 1.f));
+        cmdList->upload(objects._texture, k_nullDeviceTextureSize, data);
+        cmdList->upload(objects._buffers[0], 0, k_nullDeviceBufferSize, data);
+        cmdList->copy(objects._buffers[0], 0, objects._buffers[1], 0, k_nullDeviceBufferSize);
+        cmdList->clear(objects._buffers[0], frame);
+        cmdList->bindPushConstant(renderer::ShaderType::Vertex, sizeof(u32), &frame);
+        cmdList->insertDebugMarker("null_device_marker", color::Color(0.f, 1.f, 0.f, 1.f));
+        cmdList->endDebugMarker("null_device_frame");
+    }
+}
+
+void MyApplication::Test_NullDevice()
+{
+    LOG_DEBUG("Test_NullDevice");
+
+    //Two devices record the same frames, the streams don't depend on the pointers
+    NullDeviceObjects objects[2] = { createObjects(), createObjects() };
+    renderer::null::NullDevice* devices[2] =
+    {
+        static_cast<renderer::null::NullDevice*>(objects[0]._device),
+        static_cast<renderer::null::NullDevice*>(objects[1]._device)
+    };
+
+    const u32 failures = m_failures;
+    u32 previousHash = 0;
+    for (u32 frame = 0; frame < k_nullDeviceFrames; ++frame)
+    {
+        if (frame == k_nullDeviceFrames - 1)
+        {
+            devices[0]->captureFrame();
+        }
+
+        for (u32 index = 0; index < 2; ++index)
+        {
+            recordFrame(objects[index], frame);
+
+            const u32 hash = objects[index]._cmdList->getRecording().hash();
+            devices[index]->submit(objects[index]._cmdList);
+            if (objects[index]._cmdList->getSubmitted().hash() != hash || !objects[index]._cmdList->getRecording()._stream.empty())
+            {
+                LOG_ERROR("Test_NullDevice frame %u device %u: the submitted commands differ from the recorded ones", frame, index);
+                ++m_failures;
+            }
+            objects[index]._swapchain->presentFrame();
+        }
+
+        const renderer::null::NullCmdList::Statistics& statistics = devices[0]->getFrameStatistics();
+        if (statistics._commands != k_nullDeviceCommands || statistics._uploads != 2 || statistics._uploadBytes != k_nullDeviceTextureSize + k_nullDeviceBufferSize || statistics._draws != 0)
+        {
+            LOG_ERROR("Test_NullDevice frame %u: %u commands, %u uploads of %llu bytes, %u draws", frame, statistics._commands, statistics._uploads, statistics._uploadBytes, statistics._draws);
+            ++m_failures;
+        }
+
+        if (devices[0]->getFrameHash() != devices[1]->getFrameHash() || devices[0]->getFrameHash() == previousHash)
+        {
+            LOG_ERROR("Test_NullDevice frame %u: the frame hashes %x %x, the previous frame %x", frame, devices[0]->getFrameHash(), devices[1]->getFrameHash(), previousHash);
+            ++m_failures;
+        }
+        previousHash = devices[0]->getFrameHash();
+    }
+
+    if (devices[0]->getFrameCount() != k_nullDeviceFrames || devices[0]->getCapturedFrame().size() != 1)
+    {
+        LOG_ERROR("Test_NullDevice: %llu frames, %u captured command lists", devices[0]->getFrameCount(), static_cast<u32>(devices[0]->getCapturedFrame().size()));
+        ++m_failures;
+    }
+
+    //The replay of the captured frame gives the same stream
+    for (const renderer::null::NullCmdList::Recording& recording : devices[0]->getCapturedFrame())
+    {
+        renderer::null::NullCmdList* cmdList = devices[0]->createCommandList<renderer::null::NullCmdList>(renderer::Device::GraphicMask);
+        renderer::null::NullCmdList::replay(recording, cmdList);
+        if (cmdList->getRecording()._stream != recording._stream || cmdList->getRecording()._statistics._uploadBytes != recording._statistics._uploadBytes)
+        {
+            LOG_ERROR("Test_NullDevice: the replayed stream of %u bytes differs from the captured one of %u bytes", static_cast<u32>(cmdList->getRecording()._stream.size()), static_cast<u32>(recording._stream.size()));
+            ++m_failures;
+        }
+        devices[0]->destroyCommandList(cmdList);
+    }
+
+    destroyObjects(objects[0]);
+    destroyObjects(objects[1]);
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_NullDevice: %u frames passed", k_nullDeviceFrames);
+    }
+}
@@ -0,0 +1,175 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Memory/OffsetAllocator.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u64 k_offsetAllocatorHeapSize = 256ULL * 1024 * 1024;
+    constexpr u32 k_offsetAllocatorOperations = 200'000;
+    constexpr u32 k_offsetAllocatorMaxAllocations = 4096;
+    constexpr u32 k_offsetAllocatorReportInterval = 64;
+
+    /**
+    * @brief Reference of the allocated ranges, the free gaps are the space between them
+    */
+    struct ReferenceRanges
+    {
+        std::map<u64, u64> _ranges; //offset, size
+
+        bool overlaps(u64 offset, u64 size) const
+        {
+            auto next = _ranges.lower_bound(offset);
+            if (next != _ranges.cend() && next->first < offset + size)
+            {
+                return true;
+            }
+
+            if (next != _ranges.cbegin())
+            {
+                auto prev = std::prev(next);
+                if (prev->first + prev->second > offset)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        u64 usedSpace() const
+        {
+            u64 used = 0;
+            for (auto& range : _ranges)
+            {
+                used += range.second;
+            }
+            return used;
+        }
+
+        u64 largestGap(u64 heapSize) const
+        {
+            u64 largest = 0;
+            u64 end = 0;
+            for (auto& range : _ranges)
+            {
+                largest = std::max(largest, range.first - end);
+                end = range.first + range.second;
+            }
+            return std::max(largest, heapSize - end);
+        }
+    };
+}
+
+void MyApplication::Test_OffsetAllocator()
+{
+    LOG_DEBUG("Test_OffsetAllocator");
+
+    memory::OffsetAllocator allocator(k_offsetAllocatorHeapSize, k_offsetAllocatorMaxAllocations);
+    ReferenceRanges reference;
+    std::vector<memory::OffsetAllocator::Allocation> allocations;
+
+    //Same spread as the device resources: many small buffers, some textures, rarely a big attachment
+    std::mt19937 random(42);
+    std::uniform_int_distribution<u32> operation(0, 99);
+    std::uniform_int_distribution<u32> sizeClass(0, 99);
+    std::uniform_int_distribution<u64> smallSize(1, 64 * 1024);
+    std::uniform_int_distribution<u64> mediumSize(64 * 1024, 4 * 1024 * 1024);
+    std::uniform_int_distribution<u64> largeSize(4 * 1024 * 1024, 32 * 1024 * 1024);
+    const u64 alignments[] = { 1, 16, 256, 4096, 65536 };
+    std::uniform_int_distribution<u32> alignmentIndex(0, static_cast<u32>(std::size(alignments)) - 1);
+
+    auto fail = [this](const c8* message, u32 step) -> void
+        {
+            LOG_ERROR("Test_OffsetAllocator step %u: %s", step, message);
+            ++m_failures;
+        };
+
+    for (u32 step = 0; step < k_offsetAllocatorOperations; ++step)
+    {
+        //Allocations are more frequent until the heap is populated, then the pattern is balanced
+        const bool doAllocate = allocations.empty() || operation(random) < (allocations.size() < k_offsetAllocatorMaxAllocations / 2 ? 60u : 45u);
+        if (doAllocate)
+        {
+            const u32 sizeType = sizeClass(random);
+            const u64 size = (sizeType < 80) ? smallSize(random) : (sizeType < 98) ? mediumSize(random) : largeSize(random);
+            const u64 alignment = alignments[alignmentIndex(random)];
+
+            memory::OffsetAllocator::Allocation allocation = allocator.allocate(size, alignment);
+            if (allocation.isValid())
+            {
+                if (allocation._offset % alignment != 0 || allocation._offset + size > k_offsetAllocatorHeapSize)
+                {
+                    return fail("the allocation is misaligned or out of the heap", step);
+                }
+
+                if (reference.overlaps(allocation._offset, size))
+                {
+                    return fail("the allocation overlaps a live allocation", step);
+                }
+
+                if (allocator.getAllocationSize(allocation) != size)
+                {
+                    return fail("the allocation size differs from the requested size", step);
+                }
+
+                reference._ranges.emplace(allocation._offset, size);
+                allocations.push_back(allocation);
+            }
+            else if (allocator.getAllocationCount() < k_offsetAllocatorMaxAllocations)
+            {
+                //Bins are rounded by 1/8 of the size, a gap twice as big as the request with the alignment must be found
+                if (reference.largestGap(k_offsetAllocatorHeapSize) >= 2 * (size + alignment))
+                {
+                    return fail("the allocation failed while the heap has enough free space", step);
+                }
+            }
+        }
+        else
+        {
+            std::uniform_int_distribution<size_t> victim(0, allocations.size() - 1);
+            const size_t index = victim(random);
+            memory::OffsetAllocator::Allocation allocation = allocations[index];
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+
+            reference._ranges.erase(allocation._offset);
+            allocator.free(allocation);
+        }
+
+        if (step % k_offsetAllocatorReportInterval != 0)
+        {
+            continue;
+        }
+
+        const memory::OffsetAllocator::StorageReport report = allocator.getStorageReport();
+        if (report._allocationCount != allocations.size() || report._totalFreeSpace != k_offsetAllocatorHeapSize - reference.usedSpace())
+        {
+            return fail("the storage report differs from the reference", step);
+        }
+
+        //The free neighbors are always merged, so the free regions are exactly the gaps
+        if (report._largestFreeRegion != reference.largestGap(k_offsetAllocatorHeapSize))
+        {
+            return fail("the largest free region differs from the largest gap", step);
+        }
+    }
+
+    for (const memory::OffsetAllocator::Allocation& allocation : allocations)
+    {
+        allocator.free(allocation);
+    }
+
+    //The empty heap is one region again
+    const memory::OffsetAllocator::StorageReport report = allocator.getStorageReport();
+    if (report._freeRegionCount != 1 || report._largestFreeRegion != k_offsetAllocatorHeapSize || report.getFragmentation() != 0.f)
+    {
+        return fail("the free regions aren't merged after all allocations are freed", k_offsetAllocatorOperations);
+    }
+
+    LOG_DEBUG("Test_OffsetAllocator: %u operations passed", k_offsetAllocatorOperations);
+}
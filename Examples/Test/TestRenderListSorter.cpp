@@ -0,0 +1,190 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Scene/Scene.h"
+#include "Scene/RenderListSorter.h"
+#include "Scene/SceneNode.h"
+#include "Task/TaskScheduler.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_renderListSorterPipelines = 24;
+    constexpr u32 k_renderListSorterMaterials = 300;
+    constexpr u32 k_renderListSorterMeshes = 500;
+    constexpr f32 k_renderListSorterFar = 1000.f;
+    constexpr f32 k_renderListSorterDepthStep = 1.f / 65535.f; //The depth is quantized to 16 bits
+
+    /**
+    * @brief Entries of the list, material and mesh are fake pointers, the sorter only hashes them
+    */
+    std::vector<scene::DrawNodeEntry> makeEntries(u32 count, u32 pipelines, u32 materials, u32 meshes, std::mt19937& random)
+    {
+        std::uniform_int_distribution<u32> pipeline(0, pipelines - 1);
+        std::uniform_int_distribution<u32> material(1, materials);
+        std::uniform_int_distribution<u32> mesh(1, meshes);
+        std::uniform_real_distribution<f32> position(-k_renderListSorterFar, k_renderListSorterFar);
+        std::uniform_int_distribution<u32> unbounded(0, 15);
+
+        std::vector<scene::DrawNodeEntry> entries(count);
+        for (scene::DrawNodeEntry& entry : entries)
+        {
+            entry.pipelineID = pipeline(random);
+            entry.material = reinterpret_cast<scene::Component*>(static_cast<u64>(material(random)) * 64);
+            entry.geometry = reinterpret_cast<scene::Component*>(static_cast<u64>(mesh(random)) * 256);
+
+            //Some entries have no bounds, their depth is 0
+            if (unbounded(random) != 0)
+            {
+                const math::float3 center(position(random), position(random), position(random));
+                entry.worldBounds = math::AABB(center - math::float3(1.f, 1.f, 1.f), center + math::float3(1.f, 1.f, 1.f));
+            }
+        }
+
+        return entries;
+    }
+
+    /**
+    * @brief The order of std::stable_sort by the same keys
+    */
+    std::vector<scene::NodeEntry*> referenceOrder(const std::vector<scene::NodeEntry*>& list, u32 pass, const math::Vector3D& viewPosition, scene::RenderListSorter::DepthOrder order)
+    {
+        const math::float3 viewPoint(viewPosition.getX(), viewPosition.getY(), viewPosition.getZ());
+        std::vector<std::pair<u64, scene::NodeEntry*>> items;
+        items.reserve(list.size());
+        for (scene::NodeEntry* node : list)
+        {
+            const scene::DrawNodeEntry* entry = static_cast<const scene::DrawNodeEntry*>(node);
+            const f32 depth = entry->worldBounds.isValid() ? entry->worldBounds.getCenter().distanceFrom(viewPoint) * (1.f / k_renderListSorterFar) : 0.f;
+            items.emplace_back(scene::RenderListSorter::makeKey(pass, entry->pipelineID, entry->material, entry->geometry, depth, order), node);
+        }
+
+        std::stable_sort(items.begin(), items.end(), [](const auto& left, const auto& right) -> bool
+            {
+                return left.first < right.first;
+            });
+
+        std::vector<scene::NodeEntry*> result;
+        result.reserve(items.size());
+        for (auto& item : items)
+        {
+            result.push_back(item.second);
+        }
+
+        return result;
+    }
+
+    f32 entryDepth(const scene::NodeEntry* node, const math::Vector3D& viewPosition)
+    {
+        const scene::DrawNodeEntry* entry = static_cast<const scene::DrawNodeEntry*>(node);
+        const math::float3 viewPoint(viewPosition.getX(), viewPosition.getY(), viewPosition.getZ());
+        const f32 depth = entry->worldBounds.isValid() ? entry->worldBounds.getCenter().distanceFrom(viewPoint) * (1.f / k_renderListSorterFar) : 0.f;
+        return std::min(depth, 1.f); //Beyond the far distance the keys are equal
+    }
+
+    /**
+    * @brief The layout of the keys by the entries themselves. Opaque: grouped by the pipeline, front to back inside the same state.
+    * Transparency: back to front over the whole list. Returns the index of the first entry out of the order or the list size
+    */
+    u32 findLayoutBreak(const std::vector<scene::NodeEntry*>& list, const math::Vector3D& viewPosition, scene::RenderListSorter::DepthOrder order)
+    {
+        for (u32 index = 1; index < list.size(); ++index)
+        {
+            const scene::DrawNodeEntry* previous = static_cast<const scene::DrawNodeEntry*>(list[index - 1]);
+            const scene::DrawNodeEntry* current = static_cast<const scene::DrawNodeEntry*>(list[index]);
+            const f32 previousDepth = entryDepth(previous, viewPosition);
+            const f32 currentDepth = entryDepth(current, viewPosition);
+
+            if (order == scene::RenderListSorter::DepthOrder::BackToFront)
+            {
+                if (currentDepth > previousDepth + k_renderListSorterDepthStep)
+                {
+                    return index;
+                }
+                continue;
+            }
+
+            if (current->pipelineID < previous->pipelineID)
+            {
+                return index;
+            }
+
+            const bool sameState = current->pipelineID == previous->pipelineID && current->material == previous->material && current->geometry == previous->geometry;
+            if (sameState && currentDepth + k_renderListSorterDepthStep < previousDepth)
+            {
+                return index;
+            }
+        }
+
+        return static_cast<u32>(list.size());
+    }
+}
+
+void MyApplication::Test_RenderListSorter()
+{
+    LOG_DEBUG("Test_RenderListSorter");
+
+    task::TaskScheduler scheduler(3);
+    scene::RenderListSorter sorter;
+    std::mt19937 random(42);
+
+    struct Case
+    {
+        const c8* _name;
+        u32       _count;
+        u32       _pipelines;
+        u32       _materials;
+        u32       _meshes;
+    };
+
+    //Below and above the task grain of the sorter, and the lists where the digits are skipped
+    const Case cases[] =
+    {
+        { "small", 100, k_renderListSorterPipelines, k_renderListSorterMaterials, k_renderListSorterMeshes },
+        { "large", 100'000, k_renderListSorterPipelines, k_renderListSorterMaterials, k_renderListSorterMeshes },
+        { "one state", 50'000, 1, 1, 1 },
+        { "few states", 20'000, 2, 3, 4 },
+    };
+
+    const u32 failures = m_failures;
+    const math::Vector3D viewPosition(10.f, -20.f, 30.f);
+    for (const Case& test : cases)
+    {
+        for (scene::RenderListSorter::DepthOrder order : { scene::RenderListSorter::DepthOrder::FrontToBack, scene::RenderListSorter::DepthOrder::BackToFront })
+        {
+            std::vector<scene::DrawNodeEntry> entries = makeEntries(test._count, test._pipelines, test._materials, test._meshes, random);
+            std::vector<scene::NodeEntry*> list;
+            list.reserve(entries.size());
+            for (scene::DrawNodeEntry& entry : entries)
+            {
+                list.push_back(&entry);
+            }
+
+            const u32 pass = toEnumType(order == scene::RenderListSorter::DepthOrder::FrontToBack ? scene::ScenePass::Opaque : scene::ScenePass::Transparency);
+            const std::vector<scene::NodeEntry*> expected = referenceOrder(list, pass, viewPosition, order);
+            sorter.sort(scheduler, pass, list, viewPosition, k_renderListSorterFar, order);
+
+            if (list != expected)
+            {
+                const u32 mismatch = static_cast<u32>(std::mismatch(list.cbegin(), list.cend(), expected.cbegin()).first - list.cbegin());
+                LOG_ERROR("Test_RenderListSorter %s, order %u: the order differs from std::stable_sort at %u of %u", test._name, toEnumType(order), mismatch, test._count);
+                ++m_failures;
+            }
+
+            const u32 layoutBreak = findLayoutBreak(list, viewPosition, order);
+            if (layoutBreak != list.size())
+            {
+                LOG_ERROR("Test_RenderListSorter %s, order %u: the entry %u of %u is out of the state and the depth order", test._name, toEnumType(order), layoutBreak, test._count);
+                ++m_failures;
+            }
+        }
+    }
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_RenderListSorter: %u lists passed", static_cast<u32>(std::size(cases)) * 2);
+    }
+}
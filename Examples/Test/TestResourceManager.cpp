@@ -0,0 +1,324 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Thread/Thread.h"
+#include "Resource/ResourceManager.h"
+#include "Resource/Loader/ResourceLoader.h"
+#include "Task/TaskScheduler.h"
+#include "Task/TaskPool.h"
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_resourceManagerAsyncRequests = 32;
+    constexpr u32 k_resourceManagerOrderRequests = 12;
+    constexpr u32 k_resourceManagerExternalWork = 8; //More than the loading threads, the queued tasks are waited too
+
+    //The gate request holds the loading thread until the queue of the order check is filled
+    std::atomic<bool> s_gateOpen = false;
+    std::mutex s_loadOrderMutex;
+    std::vector<std::string> s_loadOrder;
+
+    /**
+    * @brief The GPU part goes through executeOnUploadThread, same as Texture::load and StaticMesh::load
+    */
+    class UploadResource final : public resource::Resource
+    {
+    public:
+
+        struct LoadPolicy : resource::Resource::LoadPolicy
+        {
+            bool unique = true;
+        };
+
+        bool load(const stream::Stream* stream, u32 offset = 0) override
+        {
+            m_loadThread = thread::Thread::getCurrentThread();
+            resource::ResourceManager::getLazyInstance()->executeOnUploadThread([this]() -> void
+                {
+                    m_uploadThread = thread::Thread::getCurrentThread();
+                });
+            m_loaded = true;
+
+            return true;
+        }
+
+        bool save(stream::Stream* stream, u32 offset = 0) const override
+        {
+            return false;
+        }
+
+        std::thread::id m_loadThread;
+        std::thread::id m_uploadThread;
+    };
+
+    class UploadResourceLoader final : public resource::ResourceLoader<UploadResource>
+    {
+    public:
+
+        using ResourceType = UploadResource;
+        using PolicyType = UploadResource::LoadPolicy;
+
+        [[nodiscard]] UploadResource* load(const std::string& name, const resource::Resource::LoadPolicy& policy, u32 flags = 0) override
+        {
+            while (name == "gate" && !s_gateOpen.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            {
+                std::lock_guard lock(s_loadOrderMutex);
+                s_loadOrder.push_back(name);
+            }
+
+            UploadResource* resource = V3D_NEW(UploadResource, memory::MemoryLabel::MemoryObject);
+            resource->load(nullptr);
+
+            return resource;
+        }
+    };
+}
+
+namespace v3d
+{
+    template<>
+    struct TypeOf<UploadResource>
+    {
+        static TypePtr get()
+        {
+            static TypePtr ptr = nullptr;
+            return (TypePtr)&ptr;
+        }
+    };
+} //namespace v3d
+
+void MyApplication::Test_ResourceManager()
+{
+    LOG_DEBUG("Test_ResourceManager");
+
+    auto fail = [this](const c8* message) -> void
+        {
+            LOG_ERROR("Test_ResourceManager: %s", message);
+            ++m_failures;
+        };
+
+    const std::thread::id mainThread = thread::Thread::getMainThreadId();
+    const UploadResource::LoadPolicy policy;
+
+    //A loader used directly, before the manager exists. It is the path which was broken by requiring the instance in Resource::load
+    {
+        UploadResourceLoader loader;
+        UploadResource* resource = loader.load("direct", policy);
+        if (!resource || resource->m_uploadThread != mainThread)
+        {
+            return fail("the direct load isn't uploaded in place");
+        }
+        V3D_DELETE(resource, memory::MemoryLabel::MemoryObject);
+    }
+
+    resource::ResourceManager* manager = resource::ResourceManager::getLazyInstance();
+    manager->registerLoader<UploadResource>(std::make_unique<UploadResourceLoader>());
+
+    //Synchronous load without the loading threads
+    UploadResource* syncResource = manager->load<UploadResource, UploadResourceLoader>("sync", policy);
+    if (!syncResource || syncResource->m_loadThread != mainThread || syncResource->m_uploadThread != mainThread)
+    {
+        return fail("the sync load isn't done in the main thread");
+    }
+
+    if (manager->load<UploadResource, UploadResourceLoader>("sync", policy) != syncResource)
+    {
+        return fail("the unique resource is loaded twice");
+    }
+
+    //loadAsync falls back to the sync path until initAsyncLoading
+    resource::AsyncLoadHandle fallback = manager->loadAsync<UploadResource, UploadResourceLoader>("fallback", policy);
+    if (fallback->getStatus() != resource::AsyncLoadRequest::Status::Completed || !fallback->getResource<UploadResource>())
+    {
+        return fail("loadAsync without the loading threads isn't completed in place");
+    }
+
+    if (manager->acquireScheduler())
+    {
+        return fail("the loading threads are acquired before initAsyncLoading");
+    }
+
+    manager->initAsyncLoading(2);
+
+    //The sync path must still upload in place while the loading threads run, waiting for update here would block forever
+    UploadResource* syncAsyncResource = manager->load<UploadResource, UploadResourceLoader>("sync_with_threads", policy);
+    if (!syncAsyncResource || syncAsyncResource->m_uploadThread != mainThread)
+    {
+        return fail("the sync load isn't uploaded in place while the loading threads run");
+    }
+
+    std::vector<resource::AsyncLoadHandle> requests;
+    for (u32 index = 0; index < k_resourceManagerAsyncRequests; ++index)
+    {
+        requests.push_back(manager->loadAsync<UploadResource, UploadResourceLoader>(std::format("async_{}", index), policy, 0,
+            (index % 2) ? resource::LoadPriority::High : resource::LoadPriority::Low));
+    }
+
+    //A unique resource in flight shares the request
+    if (manager->loadAsync<UploadResource, UploadResourceLoader>("async_0", policy) != requests.front())
+    {
+        return fail("the request of the same unique resource isn't shared");
+    }
+
+    for (const resource::AsyncLoadHandle& request : requests)
+    {
+        manager->wait(request);
+
+        UploadResource* resource = request->getResource<UploadResource>();
+        if (!resource)
+        {
+            return fail("the async request isn't completed");
+        }
+
+        if (resource->m_loadThread == mainThread || resource->m_uploadThread != mainThread)
+        {
+            return fail("the async load isn't decoded in the loading thread or uploaded in the main thread");
+        }
+    }
+
+    //Registered by update, the sync load finds it
+    if (manager->load<UploadResource, UploadResourceLoader>("async_1", policy) != requests[1]->getResource<UploadResource>())
+    {
+        return fail("the async resource isn't registered");
+    }
+
+    manager->shutdownAsyncLoading();
+
+    //One loading thread takes the pending requests by the priority, then in the order of the requests
+    manager->initAsyncLoading(1);
+    s_gateOpen.store(false, std::memory_order_relaxed);
+    s_loadOrder.clear();
+    resource::AsyncLoadHandle gate = manager->loadAsync<UploadResource, UploadResourceLoader>("gate", policy);
+    while (gate->getStatus() == resource::AsyncLoadRequest::Status::Pending)
+    {
+        std::this_thread::yield();
+    }
+
+    const resource::LoadPriority priorities[] = { resource::LoadPriority::Low, resource::LoadPriority::Normal, resource::LoadPriority::High };
+    std::vector<resource::AsyncLoadHandle> ordered;
+    for (u32 index = 0; index < k_resourceManagerOrderRequests; ++index)
+    {
+        ordered.push_back(manager->loadAsync<UploadResource, UploadResourceLoader>(std::format("order_{}", index), policy, 0, priorities[index % 3]));
+    }
+
+    //A repeated request raises the priority, a cancelled one is never loaded
+    const bool shared = manager->loadAsync<UploadResource, UploadResourceLoader>("order_0", policy, 0, resource::LoadPriority::High) == ordered.front();
+    resource::AsyncLoadHandle cancelled = manager->loadAsync<UploadResource, UploadResourceLoader>("order_cancelled", policy, 0, resource::LoadPriority::High);
+    cancelled->cancel();
+
+    s_gateOpen.store(true, std::memory_order_release);
+    manager->wait(gate);
+    manager->wait(cancelled);
+    for (const resource::AsyncLoadHandle& request : ordered)
+    {
+        manager->wait(request);
+    }
+
+    if (!shared)
+    {
+        return fail("the repeated request isn't shared");
+    }
+
+    std::vector<std::string> expectedOrder = { "gate", "order_0" };
+    for (u32 priority = 3; priority > 0; --priority)
+    {
+        for (u32 index = priority - 1; index < k_resourceManagerOrderRequests; index += 3)
+        {
+            if (index != 0)
+            {
+                expectedOrder.push_back(std::format("order_{}", index));
+            }
+        }
+    }
+
+    if (s_loadOrder != expectedOrder)
+    {
+        return fail("the requests aren't loaded by the priority and the order of the requests");
+    }
+
+    if (cancelled->getStatus() != resource::AsyncLoadRequest::Status::Cancelled || cancelled->getResource<UploadResource>())
+    {
+        return fail("the cancelled request is loaded");
+    }
+
+    //The work of other systems on the loading threads, only the threads which can wait the tasks acquire them
+    task::TaskScheduler* foreignWorkers = nullptr;
+    std::thread([manager, &foreignWorkers]() -> void
+        {
+            foreignWorkers = manager->acquireScheduler();
+        }).join();
+
+    if (foreignWorkers)
+    {
+        return fail("the loading threads are acquired by a thread which can't wait the tasks");
+    }
+
+    //shutdownAsyncLoading waits the acquired work, as it does for the pipeline compilation
+    task::TaskPool taskPool;
+    std::atomic<u32> externalWorkFinished = 0;
+    std::vector<task::Task*> externalWork(k_resourceManagerExternalWork);
+    for (task::Task*& work : externalWork)
+    {
+        task::TaskScheduler* workers = manager->acquireScheduler();
+        if (!workers)
+        {
+            return fail("the loading threads aren't acquired");
+        }
+
+        work = taskPool.acquireTask();
+        work->init("External Work", [manager, &externalWorkFinished]() -> void
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                externalWorkFinished.fetch_add(1, std::memory_order_relaxed);
+                manager->releaseScheduler();
+            });
+        workers->executeTask(work, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+    }
+
+    //The work which is still to be submitted keeps the loading threads as well
+    if (!manager->acquireScheduler())
+    {
+        return fail("the loading threads aren't acquired");
+    }
+
+    std::atomic<bool> lateWorkReleased = false;
+    std::thread lateWork([manager, &externalWorkFinished, &lateWorkReleased]() -> void
+        {
+            while (externalWorkFinished.load(std::memory_order_relaxed) < k_resourceManagerExternalWork)
+            {
+                std::this_thread::yield();
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            lateWorkReleased.store(true, std::memory_order_relaxed);
+            manager->releaseScheduler();
+        });
+
+    manager->shutdownAsyncLoading();
+    const bool waited = externalWorkFinished.load(std::memory_order_relaxed) == k_resourceManagerExternalWork && lateWorkReleased.load(std::memory_order_relaxed);
+    lateWork.join();
+    for (task::Task* work : externalWork)
+    {
+        taskPool.releaseTask(work);
+    }
+
+    if (!waited)
+    {
+        return fail("shutdownAsyncLoading doesn't wait the acquired work");
+    }
+
+    if (manager->acquireScheduler())
+    {
+        return fail("the loading threads are acquired after shutdownAsyncLoading");
+    }
+
+    manager->clear();
+
+    LOG_DEBUG("Test_ResourceManager: %u async requests and %u ordered requests passed", k_resourceManagerAsyncRequests, k_resourceManagerOrderRequests);
+}
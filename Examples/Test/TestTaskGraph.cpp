@@ -0,0 +1,182 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Task/TaskScheduler.h"
+#include "Task/TaskPool.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_taskGraphTasks = 512;
+    constexpr u32 k_taskGraphMaxPredecessors = 4;
+    constexpr u32 k_taskGraphFanOut = 40; //Above k_maxTaskSuccessors, the extra successors are kept separately
+    constexpr u32 k_taskGraphRounds = 16;
+    constexpr u32 k_taskGraphNested = 8;
+    constexpr u32 k_taskGraphChildren = 16;
+}
+
+void MyApplication::Test_TaskGraph()
+{
+    LOG_DEBUG("Test_TaskGraph");
+
+    const u32 failures = m_failures;
+    const task::TaskDispatcher::DispatcherFlags dispatchers[] = { 0, task::TaskDispatcher::WorkStealingScheduler };
+    for (task::TaskDispatcher::DispatcherFlags flags : dispatchers)
+    {
+        task::TaskScheduler scheduler(3, flags);
+        task::TaskPool pool;
+
+        std::mt19937 random(7);
+        u32 allocatedCount = 0;
+        for (u32 round = 0; round < k_taskGraphRounds; ++round)
+        {
+            //Every task takes a stamp on execution, the stamp of a task is bigger than the stamps of its predecessors
+            std::atomic<u32> nextStamp = 1;
+            std::vector<u32> stamps(k_taskGraphTasks, 0);
+            std::vector<std::vector<u32>> predecessors(k_taskGraphTasks);
+            std::vector<task::Task*> tasks(k_taskGraphTasks);
+            for (u32 index = 0; index < k_taskGraphTasks; ++index)
+            {
+                tasks[index] = pool.acquireTask();
+                tasks[index]->init("Graph Job", [&nextStamp, &stamps, index]() -> void
+                    {
+                        stamps[index] = nextStamp.fetch_add(1, std::memory_order_relaxed);
+                    });
+
+                if (index > 0 && index <= k_taskGraphFanOut)
+                {
+                    predecessors[index].push_back(0);
+                }
+                else if (index > k_taskGraphFanOut)
+                {
+                    const u32 count = std::uniform_int_distribution<u32>(0, k_taskGraphMaxPredecessors)(random);
+                    for (u32 edge = 0; edge < count; ++edge)
+                    {
+                        predecessors[index].push_back(std::uniform_int_distribution<u32>(0, index - 1)(random));
+                    }
+                }
+
+                for (u32 predecessor : predecessors[index])
+                {
+                    tasks[index]->addDependency(tasks[predecessor]);
+                }
+            }
+
+            //The successors are submitted first, they have to wait for the predecessors
+            std::vector<task::Task*> submit(tasks.rbegin(), tasks.rend());
+            scheduler.executeTask(submit, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+            for (task::Task* task : tasks)
+            {
+                scheduler.waitTask(task);
+            }
+
+            for (u32 index = 0; index < k_taskGraphTasks; ++index)
+            {
+                if (stamps[index] == 0)
+                {
+                    LOG_ERROR("Test_TaskGraph flags %u round %u: task %u is not executed", flags, round, index);
+                    ++m_failures;
+                    continue;
+                }
+
+                for (u32 predecessor : predecessors[index])
+                {
+                    if (stamps[predecessor] >= stamps[index])
+                    {
+                        LOG_ERROR("Test_TaskGraph flags %u round %u: task %u is executed before its predecessor %u", flags, round, index, predecessor);
+                        ++m_failures;
+                    }
+                }
+            }
+
+            for (task::Task* task : tasks)
+            {
+                pool.releaseTask(task);
+            }
+
+            //The pool grows on the first round only
+            if (round == 0)
+            {
+                allocatedCount = pool.getAllocatedCount();
+            }
+            else if (pool.getAllocatedCount() != allocatedCount)
+            {
+                LOG_ERROR("Test_TaskGraph flags %u round %u: the pool has grown from %u to %u tasks", flags, round, allocatedCount, pool.getAllocatedCount());
+                ++m_failures;
+            }
+        }
+
+        //The released tasks drop the captured objects
+        {
+            std::shared_ptr<u32> captured = std::make_shared<u32>(0);
+            task::Task* task = pool.acquireTask();
+            task->init([captured]() -> void
+                {
+                    ++(*captured);
+                });
+            scheduler.executeTask(task, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+            scheduler.waitTask(task);
+            pool.releaseTask(task);
+
+            if (*captured != 1 || captured.use_count() != 1)
+            {
+                LOG_ERROR("Test_TaskGraph flags %u: the released task keeps the capture, executed %u, references %u", flags, *captured, static_cast<u32>(captured.use_count()));
+                ++m_failures;
+            }
+        }
+
+        //More waiting tasks than the workers, the waits execute the children themselves
+        {
+            std::atomic<u32> executed = 0;
+            std::vector<task::Task*> parents(k_taskGraphNested);
+            for (task::Task*& parent : parents)
+            {
+                parent = pool.acquireTask();
+                parent->init("Nested Job", [&scheduler, &pool, &executed]() -> void
+                    {
+                        task::Task* children[k_taskGraphChildren];
+                        for (task::Task*& child : children)
+                        {
+                            child = pool.acquireTask();
+                            child->init([&executed]() -> void
+                                {
+                                    executed.fetch_add(1, std::memory_order_relaxed);
+                                });
+                            scheduler.executeTask(child, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+                        }
+
+                        for (task::Task* child : children)
+                        {
+                            scheduler.waitTask(child);
+                            pool.releaseTask(child);
+                        }
+                    });
+            }
+
+            scheduler.executeTask(parents, task::TaskPriority::Normal, task::TaskMask::WorkerThread);
+            for (task::Task* parent : parents)
+            {
+                scheduler.waitTask(parent);
+            }
+
+            for (task::Task* parent : parents)
+            {
+                pool.releaseTask(parent);
+            }
+
+            if (executed.load() != k_taskGraphNested * k_taskGraphChildren)
+            {
+                LOG_ERROR("Test_TaskGraph flags %u: %u of %u nested tasks are executed", flags, executed.load(), k_taskGraphNested * k_taskGraphChildren);
+                ++m_failures;
+            }
+        }
+    }
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_TaskGraph: %u rounds of %u tasks passed", k_taskGraphRounds, k_taskGraphTasks);
+    }
+}
@@ -0,0 +1,177 @@
+#include "MyApplication.h"
+
+#include "Utils/Logger.h"
+#include "Scene/SceneNode.h"
+#include "Scene/TransformHierarchy.h"
+#include "Task/TaskScheduler.h"
+
+#include <random>
+
+using namespace v3d;
+
+namespace
+{
+    constexpr u32 k_hierarchyTestNodes = 2'000;
+    constexpr u32 k_hierarchyTestRootEvery = 64;
+    constexpr u32 k_hierarchyTestRounds = 32;
+    constexpr u32 k_hierarchyTestChanges = 64; //Per round
+    constexpr f32 k_hierarchyTestTolerance = 1e-2f;
+
+    /**
+    * @brief Reference by the chain of the local transforms, world is the parent world * local
+    */
+    math::Matrix4D referenceWorld(const scene::SceneNode* node)
+    {
+        const math::Matrix4D& local = node->getTransform(scene::TransformMode::Local).getMatrix();
+        return node->m_parent ? referenceWorld(node->m_parent) * local : local;
+    }
+
+    bool isAncestor(const scene::SceneNode* ancestor, const scene::SceneNode* node)
+    {
+        for (; node; node = node->m_parent)
+        {
+            if (node == ancestor)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+void MyApplication::Test_TransformHierarchy()
+{
+    LOG_DEBUG("Test_TransformHierarchy");
+
+    task::TaskScheduler scheduler(3, task::TaskDispatcher::WorkStealingScheduler);
+    scene::TransformHierarchy hierarchy;
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<f32> position(-10.f, 10.f);
+    std::uniform_real_distribution<f32> angle(-180.f, 180.f);
+    std::uniform_real_distribution<f32> scale(0.5f, 2.f);
+    auto randomNode = [&random](const std::vector<scene::SceneNode*>& nodes) -> scene::SceneNode*
+        {
+            return nodes[std::uniform_int_distribution<u32>(0, static_cast<u32>(nodes.size()) - 1)(random)];
+        };
+
+    //Half of the nodes are attached before the insertion, the others are attached to the inserted parents
+    std::vector<scene::SceneNode*> nodes;
+    std::vector<scene::SceneNode*> roots;
+    for (u32 index = 0; index < k_hierarchyTestNodes; ++index)
+    {
+        if (index == k_hierarchyTestNodes / 2)
+        {
+            for (scene::SceneNode* root : roots)
+            {
+                hierarchy.insert(root);
+            }
+        }
+
+        scene::SceneNode* node = V3D_NEW(scene::SceneNode, memory::MemoryLabel::MemoryGame);
+        node->setPosition(scene::TransformMode::Local, { position(random), position(random), position(random) });
+        node->setRotation(scene::TransformMode::Local, { angle(random), angle(random), angle(random) });
+        node->setScale(scene::TransformMode::Local, { scale(random), scale(random), scale(random) });
+
+        if (index % k_hierarchyTestRootEvery == 0)
+        {
+            roots.push_back(node);
+            if (index >= k_hierarchyTestNodes / 2)
+            {
+                hierarchy.insert(node);
+            }
+        }
+        else
+        {
+            randomNode(nodes)->addChild(node);
+        }
+        nodes.push_back(node);
+    }
+
+    const u32 failures = m_failures;
+    for (u32 round = 0; round < k_hierarchyTestRounds; ++round)
+    {
+        for (u32 change = 0; change < k_hierarchyTestChanges; ++change)
+        {
+            scene::SceneNode* node = randomNode(nodes);
+            switch (change % 4)
+            {
+            case 0:
+                node->setPosition(scene::TransformMode::Local, { position(random), position(random), position(random) });
+                break;
+
+            case 1:
+                node->setRotation(scene::TransformMode::Local, { angle(random), angle(random), angle(random) });
+                break;
+
+            case 2:
+                node->setScale(scene::TransformMode::Local, { scale(random), scale(random), scale(random) });
+                break;
+
+            case 3:
+            {
+                //Moves the subtree to another parent, the handles of the moved and the filling nodes are changed
+                scene::SceneNode* parent = randomNode(nodes);
+                if (node->m_parent && !isAncestor(node, parent))
+                {
+                    node->m_parent->removeChild(node);
+                    parent->addChild(node);
+                }
+                break;
+            }
+            }
+        }
+        hierarchy.update(scheduler);
+
+        //A global position is converted to local through the updated parent
+        scene::SceneNode* global = randomNode(nodes);
+        const math::Vector3D globalPosition(position(random), position(random), position(random));
+        global->setPosition(scene::TransformMode::Global, globalPosition);
+        hierarchy.update(scheduler);
+
+        if ((global->getTransform().getPosition() - globalPosition).length() > k_hierarchyTestTolerance)
+        {
+            LOG_ERROR("Test_TransformHierarchy round %u: the global position is not kept", round);
+            ++m_failures;
+        }
+
+        if (hierarchy.getCount() != k_hierarchyTestNodes)
+        {
+            LOG_ERROR("Test_TransformHierarchy round %u: %u nodes in the hierarchy, expected %u", round, hierarchy.getCount(), k_hierarchyTestNodes);
+            ++m_failures;
+        }
+
+        for (u32 index = 0; index < k_hierarchyTestNodes; ++index)
+        {
+            scene::Transform reference;
+            reference.setMatrix(referenceWorld(nodes[index]));
+
+            const math::Vector3D& worldPosition = nodes[index]->getTransform().getPosition();
+            if ((worldPosition - reference.getPosition()).length() > k_hierarchyTestTolerance * std::max(reference.getPosition().length(), 1.f))
+            {
+                LOG_ERROR("Test_TransformHierarchy round %u: node %u is at (%f, %f, %f), the reference is (%f, %f, %f)", round, index,
+                    worldPosition.getX(), worldPosition.getY(), worldPosition.getZ(), reference.getPosition().getX(), reference.getPosition().getY(), reference.getPosition().getZ());
+                ++m_failures;
+                break;
+            }
+        }
+    }
+
+    for (scene::SceneNode* root : roots)
+    {
+        hierarchy.remove(root);
+        V3D_DELETE(root, memory::MemoryLabel::MemoryGame);
+    }
+
+    if (hierarchy.getCount() != 0)
+    {
+        LOG_ERROR("Test_TransformHierarchy: %u nodes are left in the hierarchy", hierarchy.getCount());
+        ++m_failures;
+    }
+
+    if (m_failures == failures)
+    {
+        LOG_DEBUG("Test_TransformHierarchy: %u rounds of %u nodes passed", k_hierarchyTestRounds, k_hierarchyTestNodes);
+    }
+}
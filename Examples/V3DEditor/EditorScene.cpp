@@ -57,6 +57,13 @@ static auto loadTexture2D = [](const std::string& name, bool generateMips) -> re
         return resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>(name, policy);
     };
 
+template<class TResource>
+static TResource* waitResource(const resource::AsyncLoadHandle& request)
+{
+    resource::ResourceManager::getInstance()->wait(request);
+    return request->getResource<TResource>();
+}
+
 static auto randomVector = [](f32 min, f32 max) -> math::Vector3D
     {
         f32 x = math::random<f32>(min, max);
@@ -134,14 +141,17 @@ EditorScene::EditorScene() noexcept
                         m_selectedIndex = k_emptyIndex;
                         if (readback_objectIDData->_ptr)
                         {
+                            //The readback has the exact object under the cursor, the hierarchy finds its entry along the cursor ray
                             u32 id = readback_objectIDData->_ptr[0];
-                            if (auto found = std::find_if(m_sceneData.m_generalRenderList.cbegin(), m_sceneData.m_generalRenderList.cend(), [id](scene::NodeEntry* node)
-                                {
-                                    return node->object->ID() == id;
-                                }); found != m_sceneData.m_generalRenderList.cend())
+                            math::Vector3D origin;
+                            math::Vector3D direction;
+                            if (id != scene::SceneHandler::k_anyObjectID && calculateCursorRay(origin, direction))
                             {
-                                selectedNode = (*found)->object;
-                                m_selectedIndex = m_sceneData.m_generalRenderList.size() - std::distance(found, m_sceneData.m_generalRenderList.cend());
+                                if (scene::NodeEntry* entry = SceneHandler::raycast(origin, direction, m_cameraHandler->getFar(), id); entry)
+                                {
+                                    selectedNode = entry->object;
+                                    m_selectedIndex = entry->listIndex;
+                                }
                             }
                         }
                         m_gameEventRecevier->sendEvent(new EditorSelectionEvent(selectedNode));
@@ -185,7 +195,8 @@ EditorScene::EditorScene() noexcept
             }
             if (event->_eventType == event::GameEvent::GameEventType::Custom && event->_customEventID == toEnumType(EditorEventType::UpdateNodeGraph))
             {
-                nodeGraphChanged();
+                const EditorUpdateNodeGraphEvent* updateEvent = static_cast<const EditorUpdateNodeGraphEvent*>(event);
+                updateNode(updateEvent->_node);
             }
             else if (event->_eventType == event::GameEvent::GameEventType::HotReload)
             {
@@ -248,6 +259,9 @@ void EditorScene::createScene(renderer::Device* device, const math::Dimension2D&
         resource::ResourceManager::getInstance()->registerLoader<resource::ShaderSourceFileLoader::ResourceType>(std::move(shaderLoader));
 
         m_hotReload.addFolder("../../../../engine/data/shaders");
+
+        //The main thread executes the uploads, the loading threads use the rest
+        resource::ResourceManager::getInstance()->initAsyncLoading(std::max(std::thread::hardware_concurrency(), 3U) - 1);
     }
 
     registerTechnique(&m_mainPipeline);
@@ -274,6 +288,7 @@ void EditorScene::createScene(renderer::Device* device, const math::Dimension2D&
 
 void EditorScene::destroyScene()
 {
+    resource::ResourceManager::getInstance()->shutdownAsyncLoading();
     unregisterTechnique(&m_mainPipeline);
 
     SceneHandler::destroy();
@@ -290,6 +305,8 @@ void EditorScene::loadScene()
 
 void EditorScene::beginFrame()
 {
+    //Uploads and registrations of the async requests
+    resource::ResourceManager::getInstance()->update();
 }
 
 void EditorScene::endFrame()
@@ -297,6 +314,30 @@ void EditorScene::endFrame()
     ++m_frameCounter;
 }
 
+bool EditorScene::calculateCursorRay(math::Vector3D& origin, math::Vector3D& direction) const
+{
+    const scene::Camera& camera = m_cameraHandler->getCamera();
+    if (camera.isOrthogonal() || m_currentViewportRect.getWidth() <= 0.f || m_currentViewportRect.getHeight() <= 0.f)
+    {
+        return false;
+    }
+
+    const f32 cursorX = ((f32)m_inputHandler->getAbsoluteCursorPosition()._x - m_currentViewportRect.getLeftX()) / m_currentViewportRect.getWidth();
+    const f32 cursorY = ((f32)m_inputHandler->getAbsoluteCursorPosition()._y - m_currentViewportRect.getTopY()) / m_currentViewportRect.getHeight();
+
+    //Rows of the camera transform are the right, up and forward axes
+    const math::Matrix4D& cameraTransform = camera.getViewMatrixInverse();
+    const math::Vector3D right(cameraTransform[0], cameraTransform[1], cameraTransform[2]);
+    const math::Vector3D up(cameraTransform[4], cameraTransform[5], cameraTransform[6]);
+    const math::Vector3D forward(cameraTransform[8], cameraTransform[9], cameraTransform[10]);
+
+    const f32 tanHalfFOV = std::tan(camera.getFOV() * math::k_degToRad * 0.5f);
+    origin = m_cameraHandler->getPosition();
+    direction = forward + right * ((cursorX * 2.f - 1.f) * tanHalfFOV * camera.getAspectRatio()) + up * ((1.f - cursorY * 2.f) * tanHalfFOV);
+
+    return true;
+}
+
 void EditorScene::preRender(f32 dt)
 {
     TRACE_PROFILER_SCOPE("PreRender", color::rgba8::WHITE);
@@ -446,17 +487,30 @@ void EditorScene::loadResources()
     policy.usage = renderer::TextureUsage::TextureUsage_Sampled | renderer::TextureUsage_Shared | renderer::TextureUsage_Write;
     policy.generateMipmaps = false;
 
-    renderer::Texture2D* default_black = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("default_black.dds", policy);
-    renderer::Texture2D* default_white = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("default_white.dds", policy);
-    renderer::Texture2D* default_normal = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("default_normal.dds", policy);
-    renderer::Texture2D* default_material = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("default_material.dds", policy);
-    renderer::Texture2D* default_roughness = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("default_black.dds", policy);
-    renderer::Texture2D* default_metalness = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("default_black.dds", policy);
-    renderer::Texture2D* uv_grid = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("uv_grid.dds", policy);
-    renderer::Texture2D* noise_blue = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("noise_blue.dds", policy);
-    renderer::Texture2D* tiling_noise = resource::ResourceManager::getInstance()->load<renderer::Texture2D, resource::TextureFileLoader>("good64x64tilingnoisehighfreq.dds", policy);
-    renderer::Texture3D* default_lut = resource::ResourceManager::getInstance()->load<renderer::Texture3D, resource::TextureFileLoader>("default_lut.dds", policy);
-    renderer::Texture3D* greyscale_lut = resource::ResourceManager::getInstance()->load<renderer::Texture3D, resource::TextureFileLoader>("greyscale_lut.dds", policy);
+    //The files are decoded in parallel, the same names share a request
+    resource::AsyncLoadHandle default_black_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("default_black.dds", policy);
+    resource::AsyncLoadHandle default_white_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("default_white.dds", policy);
+    resource::AsyncLoadHandle default_normal_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("default_normal.dds", policy);
+    resource::AsyncLoadHandle default_material_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("default_material.dds", policy);
+    resource::AsyncLoadHandle default_roughness_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("default_black.dds", policy);
+    resource::AsyncLoadHandle default_metalness_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("default_black.dds", policy);
+    resource::AsyncLoadHandle uv_grid_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("uv_grid.dds", policy);
+    resource::AsyncLoadHandle noise_blue_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("noise_blue.dds", policy);
+    resource::AsyncLoadHandle tiling_noise_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture2D, resource::TextureFileLoader>("good64x64tilingnoisehighfreq.dds", policy);
+    resource::AsyncLoadHandle default_lut_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture3D, resource::TextureFileLoader>("default_lut.dds", policy);
+    resource::AsyncLoadHandle greyscale_lut_request = resource::ResourceManager::getInstance()->loadAsync<renderer::Texture3D, resource::TextureFileLoader>("greyscale_lut.dds", policy);
+
+    renderer::Texture2D* default_black = waitResource<renderer::Texture2D>(default_black_request);
+    renderer::Texture2D* default_white = waitResource<renderer::Texture2D>(default_white_request);
+    renderer::Texture2D* default_normal = waitResource<renderer::Texture2D>(default_normal_request);
+    renderer::Texture2D* default_material = waitResource<renderer::Texture2D>(default_material_request);
+    renderer::Texture2D* default_roughness = waitResource<renderer::Texture2D>(default_roughness_request);
+    renderer::Texture2D* default_metalness = waitResource<renderer::Texture2D>(default_metalness_request);
+    renderer::Texture2D* uv_grid = waitResource<renderer::Texture2D>(uv_grid_request);
+    renderer::Texture2D* noise_blue = waitResource<renderer::Texture2D>(noise_blue_request);
+    renderer::Texture2D* tiling_noise = waitResource<renderer::Texture2D>(tiling_noise_request);
+    renderer::Texture3D* default_lut = waitResource<renderer::Texture3D>(default_lut_request);
+    renderer::Texture3D* greyscale_lut = waitResource<renderer::Texture3D>(greyscale_lut_request);
 
     m_sceneData.m_globalResources.bind("default_black", default_black);
     m_sceneData.m_globalResources.bind("default_white", default_white);
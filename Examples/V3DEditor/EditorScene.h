@@ -148,6 +148,11 @@ private:
 
     void loadResources();
 
+    /**
+    * @brief calculateCursorRay. World space ray from the camera through the cursor, the direction isn't normalized
+    */
+    bool calculateCursorRay(math::Vector3D& origin, math::Vector3D& direction) const;
+
     scene::ModelHandler*            m_modelHandler;
     ui::WidgetHandler*              m_UIHandler;
 
@@ -0,0 +1,6 @@
+#!/bin/sh
+
+mkdir -p Project/Linux
+cd Project/Linux
+
+cmake -G "Unix Makefiles" -DCOMPILER_GCC=ON -DTARGET_LINUX=ON -DCMAKE_BUILD_TYPE=Profile ../..